@@ -780,6 +780,9 @@ uint32_t num_blackouts;
 
 uint64_t dump_size_limit;
 
+unsigned int compress_workers; /* threads compressing value changes, 0/1 is in the flushing thread */
+uint64_t compress_budget; /* max bytes of compressed value changes waiting to be written */
+
 unsigned char filetype; /* default is 0, FST_FT_VERILOG */
 
 unsigned compress_hier : 1;
@@ -1266,6 +1269,270 @@ if(xc)
  * only to be called directly by fst code...otherwise must
  * be synced up with time changes
  */
+/*
+ * encodes the value change chain of one variable starting at offs, building
+ * it backwards to the left of scratchpnt; returns the start of the encoding
+ */
+static unsigned char *fstWriterEncodeVchg(struct fstWriterContext *xc, uint32_t *vm4ip, uint32_t offs, unsigned char *scratchpnt)
+{
+unsigned char *vchg_mem = xc->vchg_mem;
+uint32_t next_offs;
+unsigned int wrlen;
+
+        if(vm4ip[1] <= 1)
+                {
+                if(vm4ip[1] == 1)
+                        {
+                        wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
+#ifndef FST_REMOVE_DUPLICATE_VC
+                        xc->curval_mem[vm4ip[0]] = vchg_mem[offs + 4 + wrlen]; /* checkpoint variable */
+#endif
+                        while(offs)
+                                {
+                                unsigned char val;
+                                uint32_t time_delta, rcv;
+                                next_offs = fstGetUint32(vchg_mem + offs);
+                                offs += 4;
+
+                                time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
+                                val = vchg_mem[offs+wrlen];
+                                offs = next_offs;
+
+                                switch(val)
+                                        {
+                                        case '0':
+                                        case '1':               rcv = ((val&1)<<1) | (time_delta<<2);
+                                                                break; /* pack more delta bits in for 0/1 vchs */
+
+                                        case 'x': case 'X':     rcv = FST_RCV_X | (time_delta<<4); break;
+                                        case 'z': case 'Z':     rcv = FST_RCV_Z | (time_delta<<4); break;
+                                        case 'h': case 'H':     rcv = FST_RCV_H | (time_delta<<4); break;
+                                        case 'u': case 'U':     rcv = FST_RCV_U | (time_delta<<4); break;
+                                        case 'w': case 'W':     rcv = FST_RCV_W | (time_delta<<4); break;
+                                        case 'l': case 'L':     rcv = FST_RCV_L | (time_delta<<4); break;
+                                        default:                rcv = FST_RCV_D | (time_delta<<4); break;
+                                        }
+
+                                scratchpnt = fstCopyVarint32ToLeft(scratchpnt, rcv);
+                                }
+                        }
+                        else
+                        {
+                        /* variable length */
+                        /* fstGetUint32 (next_offs) + fstGetVarint32 (time_delta) + fstGetVarint32 (len) + payload */
+                        unsigned char *pnt;
+                        uint32_t record_len;
+                        uint32_t time_delta;
+
+                        while(offs)
+                                {
+                                next_offs = fstGetUint32(vchg_mem + offs);
+                                offs += 4;
+                                pnt = vchg_mem + offs;
+                                offs = next_offs;
+                                time_delta = fstGetVarint32(pnt, (int *)&wrlen);
+                                pnt += wrlen;
+                                record_len = fstGetVarint32(pnt, (int *)&wrlen);
+                                pnt += wrlen;
+
+                                scratchpnt -= record_len;
+                                memcpy(scratchpnt, pnt, record_len);
+
+                                scratchpnt = fstCopyVarint32ToLeft(scratchpnt, record_len);
+                                scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1)); /* reserve | 1 case for future expansion */
+                                }
+                        }
+                }
+                else
+                {
+                wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
+#ifndef FST_REMOVE_DUPLICATE_VC
+                memcpy(xc->curval_mem + vm4ip[0], vchg_mem + offs + 4 + wrlen, vm4ip[1]); /* checkpoint variable */
+#endif
+                while(offs)
+                        {
+                        unsigned int idx;
+                        char is_binary = 1;
+                        unsigned char *pnt;
+                        uint32_t time_delta;
+
+                        next_offs = fstGetUint32(vchg_mem + offs);
+                        offs += 4;
+
+                        time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
+
+                        pnt = vchg_mem+offs+wrlen;
+                        offs = next_offs;
+
+                        for(idx=0;idx<vm4ip[1];idx++)
+                                {
+                                if((pnt[idx] == '0') || (pnt[idx] == '1'))
+                                        {
+                                        continue;
+                                        }
+                                        else
+                                        {
+                                        is_binary = 0;
+                                        break;
+                                        }
+                                }
+
+                        if(is_binary)
+                                {
+                                unsigned char acc = 0;
+                                /* new algorithm */
+                                idx = ((vm4ip[1]+7) & ~7);
+                                switch(vm4ip[1] & 7)
+                                        {
+                                        case 0: do {    acc  = (pnt[idx+7-8] & 1) << 0; /* fallthrough */
+                                        case 7:         acc |= (pnt[idx+6-8] & 1) << 1; /* fallthrough */
+                                        case 6:         acc |= (pnt[idx+5-8] & 1) << 2; /* fallthrough */
+                                        case 5:         acc |= (pnt[idx+4-8] & 1) << 3; /* fallthrough */
+                                        case 4:         acc |= (pnt[idx+3-8] & 1) << 4; /* fallthrough */
+                                        case 3:         acc |= (pnt[idx+2-8] & 1) << 5; /* fallthrough */
+                                        case 2:         acc |= (pnt[idx+1-8] & 1) << 6; /* fallthrough */
+                                        case 1:         acc |= (pnt[idx+0-8] & 1) << 7;
+                                                        *(--scratchpnt) = acc;
+                                                        idx -= 8;
+                                                } while(idx);
+                                        }
+
+                                scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1));
+                                }
+                                else
+                                {
+                                scratchpnt -= vm4ip[1];
+                                memcpy(scratchpnt, pnt, vm4ip[1]);
+
+                                scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1) | 1);
+                                }
+                        }
+                }
+
+
+return(scratchpnt);
+}
+
+
+#ifdef FST_WRITER_PARALLEL
+/*
+ * parallel value change compression: workers claim variables in handle
+ * order and encode + compress them, then the flushing thread writes them
+ * out in handle order, so the file matches a serial flush
+ */
+#define FST_COMPRESS_BUDGET_DEFAULT     (1UL << 26)
+
+struct fstWriterVchgBlock
+{
+unsigned char *mem;     /* data to write */
+uint32_t len;           /* length of mem */
+uint32_t packlen;       /* uncompressed length if mem is compressed, else 0 */
+uint32_t unclen;        /* uncompressed length */
+unsigned done : 1;
+};
+
+struct fstWriterVchgPool
+{
+struct fstWriterContext *xc;
+struct fstWriterVchgBlock *blocks; /* indexed by handle - 1 */
+pthread_mutex_t mutex;
+pthread_cond_t done_cond;       /* signaled when a block is done */
+pthread_cond_t space_cond;      /* signaled when a block is written */
+uint32_t next;                  /* next handle index to claim */
+uint64_t held;                  /* bytes of done blocks not yet written */
+uint64_t budget;
+};
+
+
+static void *fstWriterVchgWorker(void *ctx)
+{
+struct fstWriterVchgPool *pool = (struct fstWriterVchgPool *)ctx;
+struct fstWriterContext *xc = pool->xc;
+unsigned char *scratchpad = (unsigned char *)malloc(xc->vchg_siz);
+
+for(;;)
+        {
+        struct fstWriterVchgBlock *blk;
+        unsigned char *scratchpnt;
+        unsigned char *dmem = NULL;
+        uint32_t *vm4ip;
+        uint32_t i;
+        unsigned int wrlen;
+
+        pthread_mutex_lock(&pool->mutex);
+        while((pool->held > pool->budget) && (pool->next < xc->maxhandle))
+                {
+                pthread_cond_wait(&pool->space_cond, &pool->mutex);
+                }
+        while((pool->next < xc->maxhandle) && !xc->valpos_mem[4*pool->next+2])
+                {
+                pool->next++;
+                }
+        if(pool->next >= xc->maxhandle)
+                {
+                pthread_mutex_unlock(&pool->mutex);
+                break;
+                }
+        i = pool->next++;
+        pthread_mutex_unlock(&pool->mutex);
+
+        vm4ip = &(xc->valpos_mem[4*i]);
+        blk = &pool->blocks[i];
+        scratchpnt = fstWriterEncodeVchg(xc, vm4ip, vm4ip[2], scratchpad + xc->vchg_siz);
+        wrlen = scratchpad + xc->vchg_siz - scratchpnt;
+        blk->unclen = wrlen;
+        blk->packlen = 0;
+
+        /* same packing decisions as fstWriterFlushContextPrivate2 */
+        if(wrlen > 32)
+                {
+                if(!xc->fastpack)
+                        {
+                        unsigned long destlen = wrlen;
+
+                        dmem = (unsigned char *)malloc(wrlen);
+                        if(compress2(dmem, &destlen, scratchpnt, wrlen, 4) == Z_OK)
+                                {
+                                blk->len = destlen;
+                                blk->packlen = wrlen;
+                                }
+                        }
+                        else
+                        {
+                        unsigned int rc;
+
+                        dmem = (unsigned char *)malloc((wrlen * 2) + 2);
+                        rc = (xc->fourpack) ? LZ4_compress((char *)scratchpnt, (char *)dmem, wrlen) : fastlz_compress(scratchpnt, wrlen, dmem);
+                        if(rc < wrlen)
+                                {
+                                blk->len = rc;
+                                blk->packlen = wrlen;
+                                }
+                        }
+                }
+
+        if(!blk->packlen)
+                {
+                free(dmem);
+                dmem = (unsigned char *)malloc(wrlen);
+                memcpy(dmem, scratchpnt, wrlen);
+                blk->len = wrlen;
+                }
+        blk->mem = dmem;
+
+        pthread_mutex_lock(&pool->mutex);
+        blk->done = 1;
+        pool->held += blk->len;
+        pthread_cond_broadcast(&pool->done_cond);
+        pthread_mutex_unlock(&pool->mutex);
+        }
+
+free(scratchpad);
+return(NULL);
+}
+#endif
+
+
 #ifdef FST_WRITER_PARALLEL
 static void fstWriterFlushContextPrivate2(void *ctx)
 #else
@@ -1276,7 +1543,6 @@ static void fstWriterFlushContextPrivate(void *ctx)
 int cnt = 0;
 #endif
 unsigned int i;
-unsigned char *vchg_mem;
 FILE *f;
 fst_off_t fpos, indxpos, endpos;
 uint32_t prevpos;
@@ -1314,8 +1580,6 @@ xc->already_in_flush = 1; /* should really do this with a semaphore */
 xc->section_header_only = 0;
 scratchpad = (unsigned char *)malloc(xc->vchg_siz);
 
-vchg_mem = xc->vchg_mem;
-
 f = xc->handle;
 fstWriterVarint(f, xc->maxhandle);      /* emit current number of handles */
 fputc(xc->fourpack ? '4' : (xc->fastpack ? 'F' : 'Z'), f);
@@ -1324,148 +1588,99 @@ fpos = 1;
 packmemlen = 1024;                      /* maintain a running "longest" allocation to */
 packmem = (unsigned char *)malloc(packmemlen);           /* prevent continual malloc...free every loop iter */
 
-for(i=0;i<xc->maxhandle;i++)
+#ifdef FST_WRITER_PARALLEL
+if(xc->compress_workers > 1)
         {
-        vm4ip = &(xc->valpos_mem[4*i]);
+        struct fstWriterVchgPool pool;
+        pthread_t *threads = (pthread_t *)malloc(xc->compress_workers * sizeof(pthread_t));
+        unsigned int w;
 
-        if(vm4ip[2])
+        pool.xc = xc;
+        pool.blocks = (struct fstWriterVchgBlock *)calloc(xc->maxhandle ? xc->maxhandle : 1, sizeof(struct fstWriterVchgBlock));
+        pthread_mutex_init(&pool.mutex, NULL);
+        pthread_cond_init(&pool.done_cond, NULL);
+        pthread_cond_init(&pool.space_cond, NULL);
+        pool.next = 0;
+        pool.held = 0;
+        pool.budget = xc->compress_budget ? xc->compress_budget : FST_COMPRESS_BUDGET_DEFAULT;
+
+        for(w=0;w<xc->compress_workers;w++)
                 {
-                uint32_t offs = vm4ip[2];
-                uint32_t next_offs;
-                unsigned int wrlen;
+                pthread_create(&threads[w], NULL, fstWriterVchgWorker, &pool);
+                }
 
-                vm4ip[2] = fpos;
+        for(i=0;i<xc->maxhandle;i++)
+                {
+                struct fstWriterVchgBlock *blk = &pool.blocks[i];
+                vm4ip = &(xc->valpos_mem[4*i]);
 
-                scratchpnt = scratchpad + xc->vchg_siz;         /* build this buffer backwards */
-                if(vm4ip[1] <= 1)
+                if(vm4ip[2])
                         {
-                        if(vm4ip[1] == 1)
-                                {
-                                wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
-#ifndef FST_REMOVE_DUPLICATE_VC
-                                xc->curval_mem[vm4ip[0]] = vchg_mem[offs + 4 + wrlen]; /* checkpoint variable */
+#ifndef FST_DYNAMIC_ALIAS_DISABLE
+                        PPvoid_t pv;
 #endif
-                                while(offs)
-                                        {
-                                        unsigned char val;
-                                        uint32_t time_delta, rcv;
-                                        next_offs = fstGetUint32(vchg_mem + offs);
-                                        offs += 4;
-
-                                        time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
-                                        val = vchg_mem[offs+wrlen];
-                                        offs = next_offs;
-
-                                        switch(val)
-                                                {
-                                                case '0':
-                                                case '1':               rcv = ((val&1)<<1) | (time_delta<<2);
-                                                                        break; /* pack more delta bits in for 0/1 vchs */
-
-                                                case 'x': case 'X':     rcv = FST_RCV_X | (time_delta<<4); break;
-                                                case 'z': case 'Z':     rcv = FST_RCV_Z | (time_delta<<4); break;
-                                                case 'h': case 'H':     rcv = FST_RCV_H | (time_delta<<4); break;
-                                                case 'u': case 'U':     rcv = FST_RCV_U | (time_delta<<4); break;
-                                                case 'w': case 'W':     rcv = FST_RCV_W | (time_delta<<4); break;
-                                                case 'l': case 'L':     rcv = FST_RCV_L | (time_delta<<4); break;
-                                                default:                rcv = FST_RCV_D | (time_delta<<4); break;
-                                                }
+                        pthread_mutex_lock(&pool.mutex);
+                        while(!blk->done)
+                                {
+                                pthread_cond_wait(&pool.done_cond, &pool.mutex);
+                                }
+                        pthread_mutex_unlock(&pool.mutex);
 
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, rcv);
-                                        }
+                        vm4ip[2] = fpos;
+                        unc_memreq += blk->unclen;
+#ifndef FST_DYNAMIC_ALIAS_DISABLE
+                        pv = JudyHSIns(&PJHSArray, blk->mem, blk->len, NULL);
+                        if(*pv)
+                                {
+                                uint32_t pvi = (intptr_t)(*pv);
+                                vm4ip[2] = -pvi;
                                 }
                                 else
                                 {
-                                /* variable length */
-                                /* fstGetUint32 (next_offs) + fstGetVarint32 (time_delta) + fstGetVarint32 (len) + payload */
-                                unsigned char *pnt;
-                                uint32_t record_len;
-                                uint32_t time_delta;
-
-                                while(offs)
-                                        {
-                                        next_offs = fstGetUint32(vchg_mem + offs);
-                                        offs += 4;
-                                        pnt = vchg_mem + offs;
-                                        offs = next_offs;
-                                        time_delta = fstGetVarint32(pnt, (int *)&wrlen);
-                                        pnt += wrlen;
-                                        record_len = fstGetVarint32(pnt, (int *)&wrlen);
-                                        pnt += wrlen;
-
-                                        scratchpnt -= record_len;
-                                        memcpy(scratchpnt, pnt, record_len);
-
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, record_len);
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1)); /* reserve | 1 case for future expansion */
-                                        }
+                                *pv = (void *)(intptr_t)(i+1);
+#endif
+                                fpos += fstWriterVarint(f, blk->packlen);
+                                fpos += blk->len;
+                                fstFwrite(blk->mem, blk->len, 1, f);
+#ifndef FST_DYNAMIC_ALIAS_DISABLE
                                 }
-                        }
-                        else
-                        {
-                        wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
-#ifndef FST_REMOVE_DUPLICATE_VC
-                        memcpy(xc->curval_mem + vm4ip[0], vchg_mem + offs + 4 + wrlen, vm4ip[1]); /* checkpoint variable */
 #endif
-                        while(offs)
-                                {
-                                unsigned int idx;
-                                char is_binary = 1;
-                                unsigned char *pnt;
-                                uint32_t time_delta;
-
-                                next_offs = fstGetUint32(vchg_mem + offs);
-                                offs += 4;
+                        free(blk->mem);
 
-                                time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
-
-                                pnt = vchg_mem+offs+wrlen;
-                                offs = next_offs;
+                        pthread_mutex_lock(&pool.mutex);
+                        pool.held -= blk->len;
+                        pthread_cond_broadcast(&pool.space_cond);
+                        pthread_mutex_unlock(&pool.mutex);
+#ifdef FST_DEBUG
+                        cnt++;
+#endif
+                        }
+                }
 
-                                for(idx=0;idx<vm4ip[1];idx++)
-                                        {
-                                        if((pnt[idx] == '0') || (pnt[idx] == '1'))
-                                                {
-                                                continue;
-                                                }
-                                                else
-                                                {
-                                                is_binary = 0;
-                                                break;
-                                                }
-                                        }
+        for(w=0;w<xc->compress_workers;w++)
+                {
+                pthread_join(threads[w], NULL);
+                }
+        pthread_cond_destroy(&pool.space_cond);
+        pthread_cond_destroy(&pool.done_cond);
+        pthread_mutex_destroy(&pool.mutex);
+        free(pool.blocks);
+        free(threads);
+        }
+        else
+#endif
+for(i=0;i<xc->maxhandle;i++)
+        {
+        vm4ip = &(xc->valpos_mem[4*i]);
 
-                                if(is_binary)
-                                        {
-                                        unsigned char acc = 0;
-                                        /* new algorithm */
-                                        idx = ((vm4ip[1]+7) & ~7);
-                                        switch(vm4ip[1] & 7)
-                                                {
-                                                case 0: do {    acc  = (pnt[idx+7-8] & 1) << 0; /* fallthrough */
-                                                case 7:         acc |= (pnt[idx+6-8] & 1) << 1; /* fallthrough */
-                                                case 6:         acc |= (pnt[idx+5-8] & 1) << 2; /* fallthrough */
-                                                case 5:         acc |= (pnt[idx+4-8] & 1) << 3; /* fallthrough */
-                                                case 4:         acc |= (pnt[idx+3-8] & 1) << 4; /* fallthrough */
-                                                case 3:         acc |= (pnt[idx+2-8] & 1) << 5; /* fallthrough */
-                                                case 2:         acc |= (pnt[idx+1-8] & 1) << 6; /* fallthrough */
-                                                case 1:         acc |= (pnt[idx+0-8] & 1) << 7;
-                                                                *(--scratchpnt) = acc;
-                                                                idx -= 8;
-                                                        } while(idx);
-                                                }
+        if(vm4ip[2])
+                {
+                uint32_t offs = vm4ip[2];
+                unsigned int wrlen;
 
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1));
-                                        }
-                                        else
-                                        {
-                                        scratchpnt -= vm4ip[1];
-                                        memcpy(scratchpnt, pnt, vm4ip[1]);
+                vm4ip[2] = fpos;
 
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1) | 1);
-                                        }
-                                }
-                        }
+                scratchpnt = fstWriterEncodeVchg(xc, vm4ip, offs, scratchpad + xc->vchg_siz); /* build this buffer backwards */
 
                 wrlen = scratchpad + xc->vchg_siz - scratchpnt;
                 unc_memreq += wrlen;
@@ -2545,6 +2760,21 @@ if(xc)
 }
 
 
+void fstWriterSetParallelCompress(void *ctx, unsigned int workers, uint64_t budget)
+{
+struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
+if(xc)
+        {
+#ifdef FST_WRITER_PARALLEL
+        xc->compress_workers = workers;
+#else
+        xc->compress_workers = 0;
+#endif
+        xc->compress_budget = budget;
+        }
+}
+
+
 void fstWriterSetParallelMode(void *ctx, int enable)
 {
 struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
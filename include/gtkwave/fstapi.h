@@ -383,6 +383,7 @@ void            fstWriterSetDumpSizeLimit(void *ctx, uint64_t numbytes);
 void            fstWriterSetEnvVar(void *ctx, const char *envvar);
 void            fstWriterSetFileType(void *ctx, enum fstFileType filetype);
 void            fstWriterSetPackType(void *ctx, enum fstWriterPackType typ);
+void            fstWriterSetParallelCompress(void *ctx, unsigned int workers, uint64_t budget);
 void            fstWriterSetParallelMode(void *ctx, int enable);
 void            fstWriterSetRepackOnClose(void *ctx, int enable);       /* type = 0 (none), 1 (libz) */
 void            fstWriterSetScope(void *ctx, enum fstScopeType scopetype,
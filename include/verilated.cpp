@@ -55,7 +55,9 @@
 #include <algorithm>
 #include <cctype>
 #include <cerrno>
+#include <chrono>
 #include <cstdlib>
+#include <ctime>
 #include <limits>
 #include <list>
 #include <sstream>
@@ -67,6 +69,11 @@
 #if defined(_WIN32) || defined(__MINGW32__)
 # include <direct.h>  // mkdir
 #endif
+#if !defined(_WIN32) && !defined(__MINGW32__)
+# include <sys/mman.h>  // mmap
+# include <unistd.h>  // fork
+# define _VL_HAVE_MMAP
+#endif
 #ifdef __GLIBC__
 # include <execinfo.h>
 # define _VL_HAVE_STACKTRACE
@@ -194,26 +201,36 @@ void vl_warn(const char* filename, int linenum, const char* hier, const char* ms
 //===========================================================================
 // Wrapper to call certain functions via messages when multithreaded
 
+// Complete writes queued on the I/O thread, so they appear before the message
+static void _vl_io_drain() VL_MT_SAFE {
+    VerilatedContext* const contextp = Verilated::threadContextp();
+    if (VL_UNLIKELY(contextp->ioThread())) contextp->impp()->fdDrain();
+}
+
 void VL_FINISH_MT(const char* filename, int linenum, const char* hier) VL_MT_SAFE {
     VerilatedThreadMsgQueue::post(VerilatedMsg{[=]() {  //
+        _vl_io_drain();
         vl_finish(filename, linenum, hier);
     }});
 }
 
 void VL_STOP_MT(const char* filename, int linenum, const char* hier, bool maybe) VL_MT_SAFE {
     VerilatedThreadMsgQueue::post(VerilatedMsg{[=]() {  //
+        _vl_io_drain();
         vl_stop_maybe(filename, linenum, hier, maybe);
     }});
 }
 
 void VL_FATAL_MT(const char* filename, int linenum, const char* hier, const char* msg) VL_MT_SAFE {
     VerilatedThreadMsgQueue::post(VerilatedMsg{[=]() {  //
+        _vl_io_drain();
         vl_fatal(filename, linenum, hier, msg);
     }});
 }
 
 void VL_WARN_MT(const char* filename, int linenum, const char* hier, const char* msg) VL_MT_SAFE {
     VerilatedThreadMsgQueue::post(VerilatedMsg{[=]() {  //
+        _vl_io_drain();
         vl_warn(filename, linenum, hier, msg);
     }});
 }
@@ -266,14 +283,37 @@ void VL_DBG_MSGF(const char* formatp, ...) VL_MT_SAFE {
     VL_PRINTF("-V{t%u,%" PRIu64 "}%s", VL_THREAD_ID(), _vl_dbg_sequence_number(), result.c_str());
 }
 
+static void _vl_print(const char* strp, bool display) VL_MT_SAFE {
+    if (display) {
+        VerilatedContext* const contextp = Verilated::threadContextp();
+        if (VL_UNLIKELY(contextp->ioThread())) {
+            contextp->impp()->stdoutWrite(strp);
+            return;
+        }
+    }
+    VL_PRINTF("%s", strp);
+}
+
+static void _vl_print_mt(const char* strp, bool display = false) VL_MT_SAFE {
+    // Print already formatted text.  Outside any mtask this prints directly,
+    // avoiding the string copy and message object that VerilatedThreadMsgQueue needs.
+    // 'display' text goes through the I/O thread, if enabled.
+    if (Verilated::mtaskId() == 0) {
+        _vl_print(strp, display);
+    } else {
+        const std::string result{strp};
+        VerilatedThreadMsgQueue::post(VerilatedMsg{[=]() {  //
+            _vl_print(result.c_str(), display);
+        }});
+    }
+}
+
 void VL_PRINTF_MT(const char* formatp, ...) VL_MT_SAFE {
     va_list ap;
     va_start(ap, formatp);
     const std::string result = _vl_string_vprintf(formatp, ap);
     va_end(ap);
-    VerilatedThreadMsgQueue::post(VerilatedMsg{[=]() {  //
-        VL_PRINTF("%s", result.c_str());
-    }});
+    _vl_print_mt(result.c_str());
 }
 
 //===========================================================================
@@ -377,7 +417,15 @@ WDataOutP VL_RANDOM_W(int obits, WDataOutP outwp) VL_MT_SAFE {
 }
 
 WDataOutP VL_RANDOM_RNG_W(VlRNG& rngr, int obits, WDataOutP outwp) VL_MT_UNSAFE {
-    for (int i = 0; i < VL_WORDS_I(obits); ++i) outwp[i] = rngr.rand64();
+    // Use both halves of each 64-bit random number, as randomize() is often hot
+    const int words = VL_WORDS_I(obits);
+    int i = 0;
+    for (; i + 1 < words; i += 2) {
+        const uint64_t rnd = rngr.rand64();
+        outwp[i] = static_cast<EData>(rnd);
+        outwp[i + 1] = static_cast<EData>(rnd >> 32ULL);
+    }
+    if (i < words) outwp[i] = rngr.rand64();
     // Last word is unclean
     return outwp;
 }
@@ -416,6 +464,37 @@ WDataOutP VL_RAND_RESET_W(int obits, WDataOutP outwp) VL_MT_SAFE {
     outwp[VL_WORDS_I(obits) - 1] = VL_RAND_RESET_I(32) & VL_MASK_E(obits);
     return outwp;
 }
+// As VL_RAND_RESET_I/Q on each element, giving the same values, but only checking the reset
+// mode once, as large memories otherwise make model construction slow
+template <typename T_Data>
+static void vl_rand_reset_array(int obits, T_Data* datap, size_t elements) VL_MT_SAFE {
+    const int randReset = Verilated::threadContextp()->randReset();
+    const T_Data mask = static_cast<T_Data>(VL_MASK_Q(obits));
+    if (randReset == 0 || randReset == 1) {
+        std::fill_n(datap, elements, randReset ? mask : T_Data{0});
+        return;
+    }
+    VlRNG& rngr = VlRNG::vl_thread_rng();  // if 2, randomize
+    for (size_t i = 0; i < elements; ++i) datap[i] = static_cast<T_Data>(rngr.rand64()) & mask;
+}
+void VL_RAND_RESET_ARRAY_C(int obits, CData* datap, size_t elements) VL_MT_SAFE {
+    vl_rand_reset_array(obits, datap, elements);
+}
+void VL_RAND_RESET_ARRAY_S(int obits, SData* datap, size_t elements) VL_MT_SAFE {
+    vl_rand_reset_array(obits, datap, elements);
+}
+void VL_RAND_RESET_ARRAY_I(int obits, IData* datap, size_t elements) VL_MT_SAFE {
+    vl_rand_reset_array(obits, datap, elements);
+}
+void VL_RAND_RESET_ARRAY_Q(int obits, QData* datap, size_t elements) VL_MT_SAFE {
+    vl_rand_reset_array(obits, datap, elements);
+}
+void VL_RAND_RESET_ARRAY_W(int obits, EData* datap, size_t elements) VL_MT_SAFE {
+    // As VL_RAND_RESET_W on each element
+    const int words = VL_WORDS_I(obits);
+    vl_rand_reset_array(VL_EDATASIZE, datap, elements * words);
+    for (size_t i = 1; i <= elements; ++i) datap[i * words - 1] &= VL_MASK_E(obits);
+}
 WDataOutP VL_ZERO_RESET_W(int obits, WDataOutP outwp) VL_MT_SAFE {
     // Not inlined to speed up compilation of slowpath code
     return VL_ZERO_W(obits, outwp);
@@ -433,10 +512,56 @@ void _vl_debug_print_w(int lbits, const WDataInP iwp) VL_MT_SAFE {
 //===========================================================================
 // Slow expressions
 
+// Internal: Knuth Algorithm D on limbs, divisor normalized so MSB of vn[n-1]
+// is set, n >= 2. un has m+1 limbs, and is left holding the normalized
+// remainder; qp receives the m-n+1 quotient limbs.
+template <typename T_Limb, typename T_Wide>
+static void _vl_knuth_d(int m, int n, T_Limb* un, const T_Limb* vn, T_Limb* qp) VL_MT_SAFE {
+    constexpr int LIMB_BITS = sizeof(T_Limb) * 8;
+    for (int j = m - n; j >= 0; --j) {
+        // Estimate, at most one too large after this
+        const T_Wide unw = (static_cast<T_Wide>(un[j + n]) << LIMB_BITS) | un[j + n - 1];
+        T_Wide qhat = unw / vn[n - 1];
+        T_Wide rhat = unw - qhat * vn[n - 1];
+        while ((qhat >> LIMB_BITS)
+               || (qhat * vn[n - 2] > ((rhat << LIMB_BITS) | un[j + n - 2]))) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >> LIMB_BITS) break;
+        }
+        // Multiply by estimate and subtract
+        T_Limb carry = 0;
+        T_Limb borrow = 0;
+        for (int i = 0; i < n; ++i) {
+            const T_Wide p = qhat * vn[i] + carry;
+            carry = static_cast<T_Limb>(p >> LIMB_BITS);
+            const T_Limb plo = static_cast<T_Limb>(p);
+            const T_Limb u = un[i + j];
+            const T_Limb d = u - plo;
+            un[i + j] = d - borrow;
+            borrow = (u < plo) | (d < borrow);
+        }
+        const T_Wide top = static_cast<T_Wide>(carry) + borrow;
+        const bool over = un[j + n] < top;
+        un[j + n] = static_cast<T_Limb>(un[j + n] - top);
+        qp[j] = static_cast<T_Limb>(qhat);  // Save quotient digit
+        if (over) {
+            // Over subtracted; correct by adding back
+            --qp[j];
+            T_Limb k = 0;
+            for (int i = 0; i < n; ++i) {
+                const T_Wide t = static_cast<T_Wide>(un[i + j]) + vn[i] + k;
+                un[i + j] = static_cast<T_Limb>(t);
+                k = static_cast<T_Limb>(t >> LIMB_BITS);
+            }
+            un[j + n] += k;
+        }
+    }
+}
+
 WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, const WDataInP lwp, const WDataInP rwp,
                        bool is_modulus) VL_MT_SAFE {
     // See Knuth Algorithm D.  Computes u/v = q.r
-    // This isn't massively tuned, as wide division is rare
     // for debug see V3Number version
     // Requires clean input
     const int words = VL_WORDS_I(lbits);
@@ -448,6 +573,12 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, const WDataInP lwp, const WData
         || VL_UNLIKELY(umsbp1 == 0)) {  // 0/x so short circuit and return 0
         return owp;
     }
+    if (umsbp1 < vmsbp1) {  // Divisor larger, quotient 0
+        if (is_modulus) {
+            for (int i = 0; i < words; ++i) owp[i] = lwp[i];
+        }
+        return owp;
+    }
 
     const int uw = VL_WORDS_I(umsbp1);  // aka "m" in the algorithm
     const int vw = VL_WORDS_I(vmsbp1);  // aka "n" in the algorithm
@@ -466,84 +597,94 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, const WDataInP lwp, const WData
         return owp;
     }
 
-    // +1 word as we may shift during normalization
-    uint32_t un[VL_MULS_MAX_WORDS + 1];  // Fixed size, as MSVC++ doesn't allow [words] here
-    uint32_t vn[VL_MULS_MAX_WORDS + 1];  // v normalized
-
-    // Zero for ease of debugging and to save having to zero for shifts
-    // Note +1 as loop will use extra word
-    for (int i = 0; i < words + 1; ++i) { un[i] = vn[i] = 0; }
-
-    // Algorithm requires divisor MSB to be set
-    // Copy and shift to normalize divisor so MSB of vn[vw-1] is set
-    const int s = 31 - VL_BITBIT_I(vmsbp1 - 1);  // shift amount (0...31)
-    const uint32_t shift_mask = s ? 0xffffffff : 0;  // otherwise >> 32 won't mask the value
-    for (int i = vw - 1; i > 0; --i) {
-        vn[i] = (rwp[i] << s) | (shift_mask & (rwp[i - 1] >> (32 - s)));
+    // Divide in the widest limbs that have a double width product
+#ifdef VL_HAVE_INT128
+    using Limb = uint64_t;
+    using Wide = VlUint128;
+#else
+    using Limb = uint32_t;
+    using Wide = uint64_t;
+#endif
+    constexpr int LIMB_BITS = sizeof(Limb) * 8;
+    constexpr int LIMB_WORDS = LIMB_BITS / VL_EDATASIZE;
+    const int m = (uw + LIMB_WORDS - 1) / LIMB_WORDS;  // Dividend limbs
+    const int n = (vw + LIMB_WORDS - 1) / LIMB_WORDS;  // Divisor limbs
+
+    // Dividend with +1 limb as we may shift during normalization, divisor,
+    // then quotient. Fixed size, as MSVC++ doesn't allow [words] here, so
+    // larger divisions use the heap.
+    constexpr int STORE_LIMBS = 3 * (VL_MULS_MAX_WORDS + 1);
+    Limb store[STORE_LIMBS];
+    const int needLimbs = (m + 1) + n + (m - n + 1);
+    std::unique_ptr<Limb[]> heapp;
+    if (VL_UNLIKELY(needLimbs > STORE_LIMBS)) heapp.reset(new Limb[needLimbs]);
+    Limb* const un = heapp ? heapp.get() : store;
+    Limb* const vn = un + m + 1;
+    Limb* const qn = vn + n;
+    for (int i = 0; i < m; ++i) {
+        un[i] = 0;
+        for (int w = 0; w < LIMB_WORDS && i * LIMB_WORDS + w < uw; ++w) {
+            un[i] |= static_cast<Limb>(lwp[i * LIMB_WORDS + w]) << (w * VL_EDATASIZE);
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        vn[i] = 0;
+        for (int w = 0; w < LIMB_WORDS && i * LIMB_WORDS + w < vw; ++w) {
+            vn[i] |= static_cast<Limb>(rwp[i * LIMB_WORDS + w]) << (w * VL_EDATASIZE);
+        }
     }
-    vn[0] = rwp[0] << s;
 
-    // Copy and shift dividend by same amount; may set new upper word
-    if (s) {
-        un[uw] = lwp[uw - 1] >> (32 - s);
+    // Limbs to output, quotient unless changed below
+    const Limb* resultp = qn;
+    int resultLimbs = m - n + 1;
+    if (n == 1) {  // Single divisor limb breaks rest of algorithm
+        Limb k = 0;
+        for (int j = m - 1; j >= 0; --j) {
+            const Wide unw = (static_cast<Wide>(k) << LIMB_BITS) | un[j];
+            qn[j] = static_cast<Limb>(unw / vn[0]);
+            k = static_cast<Limb>(unw - static_cast<Wide>(qn[j]) * vn[0]);
+        }
+        un[0] = k;
+        resultLimbs = m;
+        if (is_modulus) {
+            resultp = un;
+            resultLimbs = 1;
+        }
     } else {
-        un[uw] = 0;
-    }
-    for (int i = uw - 1; i > 0; --i) {
-        un[i] = (lwp[i] << s) | (shift_mask & (lwp[i - 1] >> (32 - s)));
-    }
-    un[0] = lwp[0] << s;
-
-    // Main loop
-    for (int j = uw - vw; j >= 0; --j) {
-        // Estimate
-        const uint64_t unw64
-            = (static_cast<uint64_t>(un[j + vw]) << 32ULL | static_cast<uint64_t>(un[j + vw - 1]));
-        uint64_t qhat = unw64 / static_cast<uint64_t>(vn[vw - 1]);
-        uint64_t rhat = unw64 - qhat * static_cast<uint64_t>(vn[vw - 1]);
-
-    again:
-        if (qhat >= 0x100000000ULL || ((qhat * vn[vw - 2]) > ((rhat << 32ULL) + un[j + vw - 2]))) {
-            qhat = qhat - 1;
-            rhat = rhat + vn[vw - 1];
-            if (rhat < 0x100000000ULL) goto again;
+        // Algorithm requires divisor MSB to be set
+        // Shift to normalize divisor so MSB of vn[n-1] is set
+        const int s = LIMB_BITS - 1 - ((vmsbp1 - 1) % LIMB_BITS);  // shift amount
+        if (s) {
+            for (int i = n - 1; i > 0; --i) vn[i] = (vn[i] << s) | (vn[i - 1] >> (LIMB_BITS - s));
+            vn[0] <<= s;
+            // Shift dividend by same amount; may set new upper limb
+            un[m] = un[m - 1] >> (LIMB_BITS - s);
+            for (int i = m - 1; i > 0; --i) un[i] = (un[i] << s) | (un[i - 1] >> (LIMB_BITS - s));
+            un[0] <<= s;
+        } else {
+            un[m] = 0;
         }
 
-        int64_t t = 0;  // Must be signed
-        uint64_t k = 0;
-        for (int i = 0; i < vw; ++i) {
-            const uint64_t p = qhat * vn[i];  // Multiply by estimate
-            t = un[i + j] - k - (p & 0xFFFFFFFFULL);  // Subtract
-            un[i + j] = t;
-            k = (p >> 32ULL) - (t >> 32ULL);
-        }
-        t = un[j + vw] - k;
-        un[j + vw] = t;
-        owp[j] = qhat;  // Save quotient digit
+        _vl_knuth_d<Limb, Wide>(m, n, un, vn, qn);
 
-        if (t < 0) {
-            // Over subtracted; correct by adding back
-            owp[j]--;
-            k = 0;
-            for (int i = 0; i < vw; ++i) {
-                t = static_cast<uint64_t>(un[i + j]) + static_cast<uint64_t>(vn[i]) + k;
-                un[i + j] = t;
-                k = t >> 32ULL;
+        if (is_modulus) {
+            // Need to reverse normalization on copy to output
+            if (s) {
+                for (int i = 0; i < n; ++i) {
+                    un[i] = (un[i] >> s) | (un[i + 1] << (LIMB_BITS - s));
+                }
             }
-            un[j + vw] = un[j + vw] + k;
+            resultp = un;
+            resultLimbs = n;
         }
     }
 
-    if (is_modulus) {  // modulus
-        // Need to reverse normalization on copy to output
-        for (int i = 0; i < vw; ++i) {
-            owp[i] = (un[i] >> s) | (shift_mask & (un[i + 1] << (32 - s)));
+    for (int i = 0; i < resultLimbs; ++i) {
+        for (int w = 0; w < LIMB_WORDS && i * LIMB_WORDS + w < words; ++w) {
+            owp[i * LIMB_WORDS + w] = static_cast<EData>(resultp[i] >> (w * VL_EDATASIZE));
         }
-        for (int i = vw; i < words; ++i) owp[i] = 0;
-        return owp;
-    } else {  // division
-        return owp;
     }
+    return owp;
 }
 
 WDataOutP VL_POW_WWW(int obits, int, int rbits, WDataOutP owp, const WDataInP lwp,
@@ -787,6 +928,45 @@ std::string _vl_vsformat_time(char* tmp, T ld, int timeunit, bool left, size_t w
     return left ? (tmp + padding) : (padding + tmp);
 }
 
+// Append a formatted field of len characters, padded out to width.  Right justified
+// fields are padded on the left with padChar, left justified with trailing spaces.
+static inline void _vl_vsformat_pad(std::string& output, const char* strp, size_t len,
+                                    size_t width, bool left, char padChar) VL_MT_SAFE {
+    const size_t needmore = (width > len) ? (width - len) : 0;
+    if (!left && needmore) output.append(needmore, padChar);
+    output.append(strp, len);
+    if (left && needmore) output.append(needmore, ' ');
+}
+
+// Pad character for %d; zero only if the format was %0<width>d
+static inline char _vl_vsformat_decpad(const char* pctp) VL_MT_SAFE {
+    return (pctp && pctp[0] && pctp[1] == '0') ? '0' : ' ';
+}
+
+// Write decimal digits of ld ending just before endp, return pointer to the first digit.
+// This avoids the locale and format parsing overhead of snprintf for every %d.
+static inline char* _vl_vsformat_u64(char* endp, uint64_t ld) VL_MT_SAFE {
+    static const char s_pairs[]
+        = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+          "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+          "8081828384858687888990919293949596979899";
+    char* strp = endp;
+    while (ld >= 100) {
+        const unsigned pair = static_cast<unsigned>(ld % 100) * 2;
+        ld /= 100;
+        *--strp = s_pairs[pair + 1];
+        *--strp = s_pairs[pair];
+    }
+    if (ld >= 10) {
+        const unsigned pair = static_cast<unsigned>(ld) * 2;
+        *--strp = s_pairs[pair + 1];
+        *--strp = s_pairs[pair];
+    } else {
+        *--strp = static_cast<char>('0' + ld);
+    }
+    return strp;
+}
+
 // Do a va_arg returning a quad, assuming input argument is anything less than wide
 #define VL_VA_ARG_Q_(ap, bits) (((bits) <= VL_IDATASIZE) ? va_arg(ap, IData) : va_arg(ap, QData))
 
@@ -862,9 +1042,7 @@ void _vl_vsformat(std::string& output, const char* formatp, va_list ap) VL_MT_SA
             case '@': {  // Verilog/C++ string
                 va_arg(ap, int);  // # bits is ignored
                 const std::string* const cstrp = va_arg(ap, const std::string*);
-                std::string padding;
-                if (width > cstrp->size()) padding.append(width - cstrp->size(), ' ');
-                output += left ? (*cstrp + padding) : (padding + *cstrp);
+                _vl_vsformat_pad(output, cstrp->data(), cstrp->size(), width, left, ' ');
                 break;
             }
             case 'e':
@@ -911,26 +1089,27 @@ void _vl_vsformat(std::string& output, const char* formatp, va_list ap) VL_MT_SA
                     break;
                 }
                 case 's': {
-                    std::string field;
+                    char* const strp = t_tmp;
+                    size_t len = 0;
                     for (; lsb >= 0; --lsb) {
                         lsb = (lsb / 8) * 8;  // Next digit
                         const IData charval = VL_BITRSHIFT_W(lwp, lsb) & 0xff;
-                        field += (charval == 0) ? ' ' : charval;
+                        strp[len++] = (charval == 0) ? ' ' : charval;
                     }
-                    std::string padding;
-                    if (width > field.size()) padding.append(width - field.size(), ' ');
-                    output += left ? (field + padding) : (padding + field);
+                    _vl_vsformat_pad(output, strp, len, width, left, ' ');
                     break;
                 }
                 case 'd': {  // Signed decimal
-                    int digits = 0;
-                    std::string append;
                     if (lbits <= VL_QUADSIZE) {
-                        digits
-                            = VL_SNPRINTF(t_tmp, VL_VALUE_STRING_MAX_WIDTH, "%" PRId64,
-                                          static_cast<int64_t>(VL_EXTENDS_QQ(lbits, lbits, ld)));
-                        append = t_tmp;
+                        const int64_t sd = static_cast<int64_t>(VL_EXTENDS_QQ(lbits, lbits, ld));
+                        char* const endp = t_tmp + VL_VALUE_STRING_MAX_WIDTH;
+                        char* strp = _vl_vsformat_u64(
+                            endp, sd < 0 ? (0ULL - static_cast<uint64_t>(sd)) : ld);
+                        if (sd < 0) *--strp = '-';
+                        _vl_vsformat_pad(output, strp, endp - strp, width, left,
+                                         _vl_vsformat_decpad(pctp));
                     } else {
+                        std::string append;
                         if (VL_SIGN_E(lbits, lwp[VL_WORDS_I(lbits) - 1])) {
                             VlWide<VL_VALUE_STRING_MAX_WIDTH / 4 + 2> neg;
                             VL_NEGATE_W(VL_WORDS_I(lbits), neg, lwp);
@@ -938,53 +1117,21 @@ void _vl_vsformat(std::string& output, const char* formatp, va_list ap) VL_MT_SA
                         } else {
                             append = VL_DECIMAL_NW(lbits, lwp);
                         }
-                        digits = append.length();
-                    }
-                    const int needmore = width - digits;
-                    if (needmore > 0) {
-                        std::string padding;
-                        if (left) {
-                            padding.append(needmore, ' ');  // Pre-pad spaces
-                            output += append + padding;
-                        } else {
-                            if (pctp && pctp[0] && pctp[1] == '0') {  // %0
-                                padding.append(needmore, '0');  // Pre-pad zero
-                            } else {
-                                padding.append(needmore, ' ');  // Pre-pad spaces
-                            }
-                            output += padding + append;
-                        }
-                    } else {
-                        output += append;
+                        _vl_vsformat_pad(output, append.data(), append.length(), width, left,
+                                         _vl_vsformat_decpad(pctp));
                     }
                     break;
                 }
                 case '#': {  // Unsigned decimal
-                    int digits = 0;
-                    std::string append;
                     if (lbits <= VL_QUADSIZE) {
-                        digits = VL_SNPRINTF(t_tmp, VL_VALUE_STRING_MAX_WIDTH, "%" PRIu64, ld);
-                        append = t_tmp;
+                        char* const endp = t_tmp + VL_VALUE_STRING_MAX_WIDTH;
+                        const char* const strp = _vl_vsformat_u64(endp, ld);
+                        _vl_vsformat_pad(output, strp, endp - strp, width, left,
+                                         _vl_vsformat_decpad(pctp));
                     } else {
-                        append = VL_DECIMAL_NW(lbits, lwp);
-                        digits = append.length();
-                    }
-                    const int needmore = width - digits;
-                    if (needmore > 0) {
-                        std::string padding;
-                        if (left) {
-                            padding.append(needmore, ' ');  // Pre-pad spaces
-                            output += append + padding;
-                        } else {
-                            if (pctp && pctp[0] && pctp[1] == '0') {  // %0
-                                padding.append(needmore, '0');  // Pre-pad zero
-                            } else {
-                                padding.append(needmore, ' ');  // Pre-pad spaces
-                            }
-                            output += padding + append;
-                        }
-                    } else {
-                        output += append;
+                        const std::string append = VL_DECIMAL_NW(lbits, lwp);
+                        _vl_vsformat_pad(output, append.data(), append.length(), width, left,
+                                         _vl_vsformat_decpad(pctp));
                     }
                     break;
                 }
@@ -1002,22 +1149,28 @@ void _vl_vsformat(std::string& output, const char* formatp, va_list ap) VL_MT_SA
                         lsb = (lsb < 1) ? 0 : (lsb - 1);
                     }
 
-                    std::string append;
-                    int digits;
+                    // Digits are written into t_tmp; a binary digit per bit fits as
+                    // arguments are limited to VL_VALUE_STRING_MAX_WIDTH bits
+                    char* const strp = t_tmp;
+                    size_t digits = 0;
                     switch (fmt) {
                     case 'b': {
-                        digits = lsb + 1;
-                        for (; lsb >= 0; --lsb) append += (VL_BITRSHIFT_W(lwp, lsb) & 1) + '0';
+                        if (lbits <= VL_QUADSIZE) {
+                            for (; lsb >= 0; --lsb) strp[digits++] = '0' + ((ld >> lsb) & 1);
+                        } else {
+                            for (; lsb >= 0; --lsb) {
+                                strp[digits++] = '0' + (VL_BITRSHIFT_W(lwp, lsb) & 1);
+                            }
+                        }
                         break;
                     }
                     case 'o': {
-                        digits = (lsb + 1 + 2) / 3;
                         for (; lsb >= 0; --lsb) {
                             lsb = (lsb / 3) * 3;  // Next digit
                             // Octal numbers may span more than one wide word,
                             // so we need to grab each bit separately and check for overrun
                             // Octal is rare, so we'll do it a slow simple way
-                            append += static_cast<char>(
+                            strp[digits++] = static_cast<char>(
                                 '0' + ((VL_BITISSETLIMIT_W(lwp, lbits, lsb + 0)) ? 1 : 0)
                                 + ((VL_BITISSETLIMIT_W(lwp, lbits, lsb + 1)) ? 2 : 0)
                                 + ((VL_BITISSETLIMIT_W(lwp, lbits, lsb + 2)) ? 4 : 0));
@@ -1025,29 +1178,21 @@ void _vl_vsformat(std::string& output, const char* formatp, va_list ap) VL_MT_SA
                         break;
                     }
                     default: {  // 'x'
-                        digits = (lsb + 1 + 3) / 4;
-                        for (; lsb >= 0; --lsb) {
-                            lsb = (lsb / 4) * 4;  // Next digit
-                            const IData charval = VL_BITRSHIFT_W(lwp, lsb) & 0xf;
-                            append += "0123456789abcdef"[charval];
+                        if (lbits <= VL_QUADSIZE) {
+                            for (lsb = (lsb / 4) * 4; lsb >= 0; lsb -= 4) {
+                                strp[digits++] = "0123456789abcdef"[(ld >> lsb) & 0xf];
+                            }
+                        } else {
+                            for (lsb = (lsb / 4) * 4; lsb >= 0; lsb -= 4) {
+                                const IData charval = VL_BITRSHIFT_W(lwp, lsb) & 0xf;
+                                strp[digits++] = "0123456789abcdef"[charval];
+                            }
                         }
                         break;
                     }
                     }  // switch
 
-                    const int needmore = width - digits;
-                    if (needmore > 0) {
-                        std::string padding;
-                        if (left) {
-                            padding.append(needmore, ' ');  // Pre-pad spaces
-                            output += append + padding;
-                        } else {
-                            padding.append(needmore, '0');  // Pre-pad zero
-                            output += padding + append;
-                        }
-                    } else {
-                        output += append;
-                    }
+                    _vl_vsformat_pad(output, strp, digits, width, left, '0');
                     break;
                 }  // b / o / x
                 case 'u':
@@ -1582,7 +1727,12 @@ void VL_WRITEF(const char* formatp, ...) VL_MT_SAFE {
     _vl_vsformat(t_output, formatp, ap);
     va_end(ap);
 
-    VL_PRINTF_MT("%s", t_output.c_str());
+    _vl_print_mt(t_output.c_str(), true);
+}
+
+void VL_WRITES(const char* strp) VL_MT_SAFE {
+    // $display/$write with constant text, so no format processing is needed
+    _vl_print_mt(strp, true);
 }
 
 void VL_FWRITEF(IData fpi, const char* formatp, ...) VL_MT_SAFE {
@@ -1991,52 +2141,72 @@ static const char* formatBinary(int nBits, uint32_t bits) {
     return t_buf;
 }
 
+static void _vl_readmem_end_check(const std::string& filename, int linenum, QData end,
+                                  QData addr, bool anyAddr) VL_MT_SAFE {
+    if (VL_UNLIKELY(end != ~0ULL && addr <= end && !anyAddr)) {
+        VL_WARN_MT(filename.c_str(), linenum, "",
+                   "$readmem file ended before specified final address (IEEE 2017 21.4)");
+    }
+}
+
 VlReadMem::VlReadMem(bool hex, int bits, const std::string& filename, QData start, QData end)
     : m_hex{hex}
     , m_bits{bits}
     , m_filename(filename)  // Need () or GCC 4.8 false warning
     , m_end{end}
     , m_addr{start} {
-    m_fp = std::fopen(filename.c_str(), "r");
-    if (VL_UNLIKELY(!m_fp)) {
+    FILE* const fp = std::fopen(filename.c_str(), "rb");
+    if (VL_UNLIKELY(!fp)) {
         // We don't report the Verilog source filename as it slow to have to pass it down
         VL_WARN_MT(filename.c_str(), 0, "", "$readmem file not found");
-        // cppcheck-has-bug-suppress resourceLeak  // m_fp is nullptr
+        // cppcheck-has-bug-suppress resourceLeak  // fp is nullptr
         return;
     }
+    m_open = true;
+    // Parse the whole file from memory, rather than a stdio call per character
+#ifdef _VL_HAVE_MMAP
+    struct stat st;
+    if (::fstat(::fileno(fp), &st) == 0 && st.st_size > 0) {
+        void* const mapp = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                                  MAP_PRIVATE, ::fileno(fp), 0);
+        if (mapp != MAP_FAILED) {
+            m_mapp = mapp;
+            m_mapSize = static_cast<size_t>(st.st_size);
+            (void)::madvise(m_mapp, m_mapSize, MADV_SEQUENTIAL);
+            m_cp = static_cast<const char*>(m_mapp);
+            m_endp = m_cp + m_mapSize;
+        }
+    }
+#endif
+    if (!m_mapp) {
+        char chunk[65536];
+        while (const size_t got = std::fread(chunk, 1, sizeof(chunk), fp)) {
+            m_buf.insert(m_buf.end(), chunk, chunk + got);
+        }
+        m_cp = m_buf.data();
+        m_endp = m_cp + m_buf.size();
+    }
+    std::fclose(fp);
 }
 VlReadMem::~VlReadMem() {
-    if (m_fp) {
-        std::fclose(m_fp);
-        m_fp = nullptr;
-    }
+#ifdef _VL_HAVE_MMAP
+    if (m_mapp) ::munmap(m_mapp, m_mapSize);
+#endif
 }
 bool VlReadMem::get(QData& addrr, std::string& valuer) {
-    if (VL_UNLIKELY(!m_fp)) return false;
-    valuer = "";
+    if (VL_UNLIKELY(!m_open)) return false;
+    valuer.clear();
     // Prep for reading
-    bool indata = false;
     bool ignore_to_eol = false;
     bool ignore_to_cmt = false;
     bool reading_addr = false;
     int lastc = ' ';
     // Read the data
-    // We process a character at a time, as then we don't need to deal
-    // with changing buffer sizes dynamically, etc.
-    while (true) {
-        int c = std::fgetc(m_fp);
-        if (VL_UNLIKELY(c == EOF)) break;
-        // printf("%d: Got '%c' Addr%lx IN%d IgE%d IgC%d\n",
-        //        m_linenum, c, m_addr, indata, ignore_to_eol, ignore_to_cmt);
-        // See if previous data value has completed, and if so return
+    while (m_cp != m_endp) {
+        int c = static_cast<unsigned char>(*m_cp++);
+        // printf("%d: Got '%c' Addr%lx IgE%d IgC%d\n",
+        //        m_linenum, c, m_addr, ignore_to_eol, ignore_to_cmt);
         if (c == '_') continue;  // Ignore _ e.g. inside a number
-        if (indata && !std::isxdigit(c) && c != 'x' && c != 'X') {
-            // printf("Got data @%lx = %s\n", m_addr, valuer.c_str());
-            ungetc(c, m_fp);
-            addrr = m_addr;
-            ++m_addr;
-            return true;
-        }
         // Parse line
         if (c == '\n') {
             ++m_linenum;
@@ -2061,24 +2231,44 @@ bool VlReadMem::get(QData& addrr, std::string& valuer) {
                 reading_addr = true;
                 m_anyAddr = true;
                 m_addr = 0;
+            } else if (reading_addr && std::isxdigit(c)) {
+                // Decode @ addresses
+                c = std::tolower(c);
+                m_addr = (m_addr << 4) + (c >= 'a' ? (c - 'a' + 10) : (c - '0'));
             }
             // Check for hex or binary digits as file format requests
-            else if (std::isxdigit(c) || (!reading_addr && (c == 'x' || c == 'X'))) {
-                c = std::tolower(c);
-                const int value
-                    = (c >= 'a' ? (c == 'x' ? VL_RAND_RESET_I(4) : (c - 'a' + 10)) : (c - '0'));
-                if (reading_addr) {
-                    // Decode @ addresses
-                    m_addr = (m_addr << 4) + value;
-                } else {
-                    indata = true;
+            else if (!reading_addr && (std::isxdigit(c) || c == 'x' || c == 'X')) {
+                // Take the rest of the value in one pass; the value is complete
+                // at the first character that is not a digit or _
+                --m_cp;
+                const char* const startp = m_cp;
+                while (m_cp != m_endp
+                       && (std::isxdigit(static_cast<unsigned char>(*m_cp)) || *m_cp == '_'
+                           || *m_cp == 'x' || *m_cp == 'X')) {
+                    ++m_cp;
+                }
+                for (const char* cp = startp; cp != m_cp; ++cp) {
+                    if (*cp == '_') continue;
+                    c = std::tolower(static_cast<unsigned char>(*cp));
                     valuer += static_cast<char>(c);
-                    // printf(" Value width=%d  @%x = %c\n", width, m_addr, c);
-                    if (VL_UNLIKELY(value > 1 && !m_hex)) {
+                    if (c == 'x') {
+                        m_anyX = true;
+                        // As setData, if a binary file has x, it gets a random 4 bit value
+                        if (VL_UNLIKELY(VL_RAND_RESET_I(4) > 1 && !m_hex)) {
+                            VL_FATAL_MT(m_filename.c_str(), m_linenum, "",
+                                        "$readmemb (binary) file contains hex characters");
+                        }
+                    } else if (VL_UNLIKELY(c > '1' && !m_hex)) {
                         VL_FATAL_MT(m_filename.c_str(), m_linenum, "",
                                     "$readmemb (binary) file contains hex characters");
                     }
                 }
+                // A value is only complete when followed by another character
+                if (VL_UNLIKELY(m_cp == m_endp)) break;
+                // printf("Got data @%lx = %s\n", m_addr, valuer.c_str());
+                addrr = m_addr;
+                ++m_addr;
+                return true;
             } else {
                 VL_FATAL_MT(m_filename.c_str(), m_linenum, "", "$readmem file syntax error");
             }
@@ -2086,45 +2276,48 @@ bool VlReadMem::get(QData& addrr, std::string& valuer) {
         lastc = c;
     }
 
-    if (VL_UNLIKELY(m_end != ~0ULL && m_addr <= m_end && !m_anyAddr)) {
-        VL_WARN_MT(m_filename.c_str(), m_linenum, "",
-                   "$readmem file ended before specified final address (IEEE 2017 21.4)");
-    }
-
+    _vl_readmem_end_check(m_filename, m_linenum, m_end, m_addr, m_anyAddr);
     return false;  // EOF
 }
 void VlReadMem::setData(void* valuep, const std::string& rhs) {
-    const QData shift = m_hex ? 4ULL : 1ULL;
-    bool innum = false;
-    // Shift value in
-    for (const auto& i : rhs) {
-        const char c = std::tolower(i);
-        const int value
-            = (c >= 'a' ? (c == 'x' ? VL_RAND_RESET_I(4) : (c - 'a' + 10)) : (c - '0'));
+    const int shift = m_hex ? 4 : 1;
+    const auto digitValue = [](char c) -> IData {
+        return c >= 'a' ? (c == 'x' ? VL_RAND_RESET_I(4) : (c - 'a' + 10)) : (c - '0');
+    };
+    if (m_bits <= VL_QUADSIZE) {
+        // Shift value in; the high digits of an over-long value fall off the top
+        QData value = 0;
+        for (const char c : rhs) value = (value << shift) + digitValue(c);
         if (m_bits <= 8) {
-            CData* const datap = reinterpret_cast<CData*>(valuep);
-            if (!innum) *datap = 0;
-            *datap = ((*datap << shift) + value) & VL_MASK_I(m_bits);
+            *reinterpret_cast<CData*>(valuep) = value & VL_MASK_I(m_bits);
         } else if (m_bits <= 16) {
-            SData* const datap = reinterpret_cast<SData*>(valuep);
-            if (!innum) *datap = 0;
-            *datap = ((*datap << shift) + value) & VL_MASK_I(m_bits);
+            *reinterpret_cast<SData*>(valuep) = value & VL_MASK_I(m_bits);
         } else if (m_bits <= VL_IDATASIZE) {
-            IData* const datap = reinterpret_cast<IData*>(valuep);
-            if (!innum) *datap = 0;
-            *datap = ((*datap << shift) + value) & VL_MASK_I(m_bits);
-        } else if (m_bits <= VL_QUADSIZE) {
-            QData* const datap = reinterpret_cast<QData*>(valuep);
-            if (!innum) *datap = 0;
-            *datap = ((*datap << static_cast<QData>(shift)) + static_cast<QData>(value))
-                     & VL_MASK_Q(m_bits);
+            *reinterpret_cast<IData*>(valuep) = value & VL_MASK_I(m_bits);
         } else {
-            WDataOutP datap = reinterpret_cast<WDataOutP>(valuep);
-            if (!innum) VL_ZERO_W(m_bits, datap);
-            _vl_shiftl_inplace_w(m_bits, datap, static_cast<IData>(shift));
-            datap[0] |= value;
+            *reinterpret_cast<QData*>(valuep) = value & VL_MASK_Q(m_bits);
+        }
+    } else {
+        // Place each digit directly at its bit position, rather than shifting
+        // the whole value once per digit
+        WDataOutP datap = reinterpret_cast<WDataOutP>(valuep);
+        const int words = VL_WORDS_I(m_bits);
+        VL_ZERO_W(m_bits, datap);
+        int64_t lsb = static_cast<int64_t>(rhs.size() - 1) * shift;
+        for (const char c : rhs) {
+            if (lsb < m_bits) {
+                const EData value = digitValue(c);
+                const int word = VL_BITWORD_E(lsb);
+                const int bit = VL_BITBIT_E(lsb);
+                datap[word] |= value << bit;
+                // A random x in a binary file may straddle words
+                if (bit > VL_EDATASIZE - 4 && word + 1 < words) {
+                    datap[word + 1] |= value >> (VL_EDATASIZE - bit);
+                }
+            }
+            lsb -= shift;
         }
-        innum = true;
+        datap[words - 1] &= VL_MASK_E(m_bits);
     }
 }
 
@@ -2222,6 +2415,140 @@ void VlWriteMem::print(QData addr, bool addrstamp, const void* valuep) {
     }
 }
 
+//===========================================================================
+// Readmem binary image cache, see VerilatedContext::readmemCache
+
+// Value of first bytes of each cache file (must be multiple of 8 bytes)
+static const char* const VL_READMEM_CACHE_HEADER_STR = "vlrdmem1";
+
+// Cache file header, after the header string
+struct VlReadMemCacheHeader final {
+    // Key, must match the source file and $readmem call
+    uint64_t m_srcSize;  // Source file size
+    uint64_t m_srcMtime;  // Source file modification time
+    uint64_t m_bits;  // Width of each row
+    uint64_t m_hex;  // Hex format
+    uint64_t m_start;  // First row address
+    // Results of parsing
+    uint64_t m_endAddr;  // Address after last value, for end check
+    uint64_t m_anyAddr;  // File had addresses, for end check
+    uint64_t m_linenum;  // Lines in file, for end check
+    uint64_t m_runs;  // Number of runs that follow
+};
+// Then m_runs pairs of uint64_t first row index and row count, then the
+// rows of each run in memory layout
+
+static size_t _vl_readmem_row_bytes(int bits) VL_PURE {
+    if (bits <= 8) return sizeof(CData);
+    if (bits <= 16) return sizeof(SData);
+    if (bits <= VL_IDATASIZE) return sizeof(IData);
+    if (bits <= VL_QUADSIZE) return sizeof(QData);
+    return VL_WORDS_I(bits) * sizeof(EData);
+}
+
+static bool _vl_readmem_cache_stat(const std::string& filename, uint64_t& sizer,
+                                   uint64_t& mtimer) VL_MT_SAFE {
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0) return false;
+    sizer = static_cast<uint64_t>(st.st_size);
+#if defined(__linux__)
+    mtimer = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ULL + st.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    mtimer = static_cast<uint64_t>(st.st_mtimespec.tv_sec) * 1000000000ULL
+             + st.st_mtimespec.tv_nsec;
+#else
+    mtimer = static_cast<uint64_t>(st.st_mtime) * 1000000000ULL;
+#endif
+    return true;
+}
+
+static std::string _vl_readmem_cache_filename(const std::string& filename) VL_PURE {
+    return filename + ".vlcache";
+}
+
+// Load rows from the cache, returns false if there is no valid cache
+static bool _vl_readmem_cache_load(bool hex, int bits, QData depth,
+                                   const std::string& filename, void* memp, QData start,
+                                   QData end) VL_MT_SAFE {
+    VlReadMemCacheHeader key;
+    if (!_vl_readmem_cache_stat(filename, key.m_srcSize, key.m_srcMtime)) return false;
+    FILE* const fp = std::fopen(_vl_readmem_cache_filename(filename).c_str(), "rb");
+    if (!fp) return false;
+    char magic[8];
+    VlReadMemCacheHeader head;
+    std::vector<uint64_t> runs;
+    bool ok = std::fread(magic, sizeof(magic), 1, fp) == 1
+              && 0 == std::memcmp(magic, VL_READMEM_CACHE_HEADER_STR, sizeof(magic))
+              && std::fread(&head, sizeof(head), 1, fp) == 1 && head.m_srcSize == key.m_srcSize
+              && head.m_srcMtime == key.m_srcMtime && head.m_bits == static_cast<uint64_t>(bits)
+              && head.m_hex == static_cast<uint64_t>(hex) && head.m_start == start
+              && head.m_runs <= depth;
+    if (ok) {
+        runs.resize(head.m_runs * 2);
+        ok = runs.empty() || std::fread(runs.data(), sizeof(uint64_t), runs.size(), fp) == runs.size();
+    }
+    // Rows out of this array's bounds are an error; parse the file so it is reported
+    for (size_t i = 0; ok && i < runs.size(); i += 2) {
+        ok = runs[i] < depth && runs[i + 1] <= depth - runs[i];
+    }
+    const size_t rowBytes = _vl_readmem_row_bytes(bits);
+    for (size_t i = 0; ok && i < runs.size(); i += 2) {
+        char* const rowp = static_cast<char*>(memp) + runs[i] * rowBytes;
+        ok = std::fread(rowp, rowBytes, runs[i + 1], fp) == runs[i + 1];
+    }
+    std::fclose(fp);
+    if (!ok) return false;  // Rows read so far are rewritten when the file is parsed
+    _vl_readmem_end_check(filename, static_cast<int>(head.m_linenum), end, head.m_endAddr,
+                          head.m_anyAddr != 0);
+    return true;
+}
+
+// Write rows just read from the file to the cache
+static void _vl_readmem_cache_save(bool hex, int bits, const std::string& filename,
+                                   const void* memp, QData start, const VlReadMem& rmem,
+                                   uint64_t srcSize, uint64_t srcMtime,
+                                   const std::vector<uint64_t>& runs) VL_MT_SAFE {
+    VlReadMemCacheHeader head;
+    uint64_t checkSize = 0;
+    uint64_t checkMtime = 0;
+    // If the file changed while being read, what was read may match neither version
+    if (!_vl_readmem_cache_stat(filename, checkSize, checkMtime) || checkSize != srcSize
+        || checkMtime != srcMtime) {
+        return;
+    }
+    head.m_srcSize = srcSize;
+    head.m_srcMtime = srcMtime;
+    head.m_bits = bits;
+    head.m_hex = hex;
+    head.m_start = start;
+    head.m_endAddr = rmem.addr();
+    head.m_anyAddr = rmem.anyAddr();
+    head.m_linenum = rmem.linenum();
+    head.m_runs = runs.size() / 2;
+    // Write under a unique name then rename, so a concurrent reader never sees a partial file
+    const std::string cacheFilename = _vl_readmem_cache_filename(filename);
+#ifdef _VL_HAVE_MMAP
+    const std::string tmpFilename = cacheFilename + "." + std::to_string(::getpid()) + ".tmp";
+#else
+    const std::string tmpFilename = cacheFilename + ".tmp";
+#endif
+    FILE* const fp = std::fopen(tmpFilename.c_str(), "wb");
+    if (!fp) return;  // Not writable, not an error
+    bool ok = std::fwrite(VL_READMEM_CACHE_HEADER_STR, 8, 1, fp) == 1
+              && std::fwrite(&head, sizeof(head), 1, fp) == 1
+              && (runs.empty()
+                  || std::fwrite(runs.data(), sizeof(uint64_t), runs.size(), fp) == runs.size());
+    const size_t rowBytes = _vl_readmem_row_bytes(bits);
+    for (size_t i = 0; ok && i < runs.size(); i += 2) {
+        const char* const rowp = static_cast<const char*>(memp) + runs[i] * rowBytes;
+        ok = std::fwrite(rowp, rowBytes, runs[i + 1], fp) == runs[i + 1];
+    }
+    ok = (std::fclose(fp) == 0) && ok;
+    if (!ok || std::rename(tmpFilename.c_str(), cacheFilename.c_str()) != 0) {
+        std::remove(tmpFilename.c_str());
+    }
+}
+
 void VL_READMEM_N(bool hex,  // Hex format, else binary
                   int bits,  // M_Bits of each array row
                   QData depth,  // Number of rows
@@ -2234,40 +2561,46 @@ void VL_READMEM_N(bool hex,  // Hex format, else binary
                   ) VL_MT_SAFE {
     if (start < static_cast<QData>(array_lsb)) start = array_lsb;
 
+    const bool cache = Verilated::threadContextp()->readmemCache();
+    uint64_t srcSize = 0;
+    uint64_t srcMtime = 0;
+    if (cache) {
+        if (_vl_readmem_cache_load(hex, bits, depth, filename, memp, start, end)) {
+            return;
+        }
+        if (!_vl_readmem_cache_stat(filename, srcSize, srcMtime)) srcMtime = 0;
+    }
+
     VlReadMem rmem{hex, bits, filename, start, end};
     if (VL_UNLIKELY(!rmem.isOpen())) return;
-    while (true) {
-        QData addr = 0;
-        std::string value;
-        if (rmem.get(addr /*ref*/, value /*ref*/)) {
-            if (VL_UNLIKELY(addr < static_cast<QData>(array_lsb)
-                            || addr >= static_cast<QData>(array_lsb + depth))) {
-                VL_FATAL_MT(filename.c_str(), rmem.linenum(), "",
-                            "$readmem file address beyond bounds of array");
-            } else {
-                const QData entry = addr - array_lsb;
-                if (bits <= 8) {
-                    CData* const datap = &(reinterpret_cast<CData*>(memp))[entry];
-                    rmem.setData(datap, value);
-                } else if (bits <= 16) {
-                    SData* const datap = &(reinterpret_cast<SData*>(memp))[entry];
-                    rmem.setData(datap, value);
-                } else if (bits <= VL_IDATASIZE) {
-                    IData* const datap = &(reinterpret_cast<IData*>(memp))[entry];
-                    rmem.setData(datap, value);
-                } else if (bits <= VL_QUADSIZE) {
-                    QData* const datap = &(reinterpret_cast<QData*>(memp))[entry];
-                    rmem.setData(datap, value);
+    const size_t rowBytes = _vl_readmem_row_bytes(bits);
+    std::vector<uint64_t> runs;  // For cache, pairs of first row and row count
+    bool inBounds = true;
+    QData addr = 0;
+    std::string value;
+    while (rmem.get(addr /*ref*/, value /*ref*/)) {
+        if (VL_UNLIKELY(addr < static_cast<QData>(array_lsb)
+                        || addr >= static_cast<QData>(array_lsb + depth))) {
+            VL_FATAL_MT(filename.c_str(), rmem.linenum(), "",
+                        "$readmem file address beyond bounds of array");
+            inBounds = false;
+        } else {
+            const QData entry = addr - array_lsb;
+            rmem.setData(static_cast<char*>(memp) + entry * rowBytes, value);
+            if (cache) {
+                if (!runs.empty() && runs[runs.size() - 2] + runs.back() == entry) {
+                    ++runs.back();
                 } else {
-                    WDataOutP datap
-                        = &(reinterpret_cast<WDataOutP>(memp))[entry * VL_WORDS_I(bits)];
-                    rmem.setData(datap, value);
+                    runs.push_back(entry);
+                    runs.push_back(1);
                 }
             }
-        } else {
-            break;
         }
     }
+    // Values with x are random, so must be parsed each time
+    if (cache && srcMtime && inBounds && !rmem.anyX()) {
+        _vl_readmem_cache_save(hex, bits, filename, memp, start, rmem, srcSize, srcMtime, runs);
+    }
 }
 
 void VL_WRITEMEM_N(bool hex,  // Hex format, else binary
@@ -2407,6 +2740,83 @@ void VL_TIMEFORMAT_IINI(int units, int precision, const std::string& suffix, int
     contextp->impp()->timeFormatWidth(width);
 }
 
+//======================================================================
+// VerilatedIoThread:: Methods
+
+VerilatedIoThread::VerilatedIoThread()
+    : m_thread{[this]() VL_MT_SAFE { worker(); }} {}
+
+VerilatedIoThread::~VerilatedIoThread() {
+    m_shutdown.store(true, std::memory_order_release);
+    notify();
+    m_thread.join();  // Worker completes all queued writes first
+}
+
+void VerilatedIoThread::notify() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    // Pairs with fence in waitUntil, so either the waiter sees our update, or we
+    // see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (VL_UNLIKELY(m_waiters.load(std::memory_order_relaxed))) {
+        const VerilatedLockGuard lock{m_mutex};
+        m_cv.notify_all();
+    }
+}
+
+template <typename T_Func>
+void VerilatedIoThread::waitUntil(T_Func condf) VL_MT_SAFE_EXCLUDES(m_mutex) {
+    for (unsigned i = 0; i < SPINS; ++i) {
+        if (VL_LIKELY(condf())) return;
+        VL_CPU_RELAX();
+    }
+    VerilatedLockGuard lock{m_mutex};
+    // A count, not a flag, as the producer and the writer may both be waiting
+    m_waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!condf()) m_cv.wait(m_mutex);
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void VerilatedIoThread::worker() VL_MT_SAFE {
+    while (true) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            waitUntil([&]() VL_MT_SAFE {
+                return head != m_tail.load(std::memory_order_acquire)
+                       || m_shutdown.load(std::memory_order_acquire);
+            });
+            // Shutdown, once all writes are done
+            if (head == m_tail.load(std::memory_order_acquire)) return;
+        }
+        Item& item = m_items[head % QUEUE_SIZE];
+        (void)std::fwrite(item.m_text.data(), 1, item.m_text.size(), item.m_fp);
+        item.m_text.clear();
+        // Only advance when written, so drain() also waits for the write in progress
+        m_head.store(head + 1, std::memory_order_release);
+        notify();
+    }
+}
+
+void VerilatedIoThread::write(FILE* fp, const char* datap, size_t size)
+    VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (VL_UNLIKELY(tail - m_head.load(std::memory_order_acquire) == QUEUE_SIZE)) {
+        waitUntil([&]() VL_MT_SAFE {
+            return tail - m_head.load(std::memory_order_acquire) != QUEUE_SIZE;
+        });
+    }
+    Item& item = m_items[tail % QUEUE_SIZE];
+    item.m_fp = fp;
+    item.m_text.assign(datap, size);
+    m_tail.store(tail + 1, std::memory_order_release);
+    notify();
+}
+
+void VerilatedIoThread::drain() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (m_head.load(std::memory_order_acquire) == tail) return;
+    waitUntil([&]() VL_MT_SAFE { return m_head.load(std::memory_order_acquire) == tail; });
+}
+
 //======================================================================
 // VerilatedContext:: Methods
 
@@ -2416,6 +2826,7 @@ VerilatedContext::VerilatedContext()
     Verilated::threadContextp(this);
     m_ns.m_profExecFilename = "profile_exec.dat";
     m_ns.m_profVltFilename = "profile.vlt";
+    m_ns.m_profSampleFilename = "profile_sample.txt";
     m_fdps.resize(31);
     std::fill(m_fdps.begin(), m_fdps.end(), static_cast<FILE*>(nullptr));
     m_fdFreeMct.resize(30);
@@ -2425,6 +2836,9 @@ VerilatedContext::VerilatedContext()
 // Must declare here not in interface, as otherwise forward declarations not known
 VerilatedContext::~VerilatedContext() {
     checkMagic(this);
+    statsWrite();
+    ioThread(false);
+    if (m_threadPoolSharedp) VlThreadPool::sharedRelease(this);
     m_magic = 0x1;  // Arbitrary but 0x1 is what Verilator src uses for a deleted pointer
 }
 
@@ -2477,6 +2891,24 @@ void VerilatedContext::errorLimit(int val) VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     m_s.m_errorLimit = val;
 }
+void VerilatedContext::ioThread(bool flag) VL_MT_SAFE {
+    {
+        const VerilatedLockGuard lock{m_fdMutex};
+        if (flag == m_ns.m_ioThread) return;
+        m_ns.m_ioThread = flag;
+        // Destructing the old thread completes its writes
+        m_impdatap->m_ioThreadp.reset(flag ? new VerilatedIoThread : nullptr);
+    }
+    if (flag) {
+        Verilated::addFlushCb(VerilatedContextImp::fdDrainCb, this);
+    } else {
+        Verilated::removeFlushCb(VerilatedContextImp::fdDrainCb, this);
+    }
+}
+void VerilatedContext::readmemCache(bool flag) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_readmemCache = flag;
+}
 void VerilatedContext::fatalOnError(bool flag) VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     m_s.m_fatalOnError = flag;
@@ -2501,6 +2933,14 @@ void VerilatedContext::profExecWindow(uint64_t flag) VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     m_ns.m_profExecWindow = flag;
 }
+void VerilatedContext::profExecSample(uint64_t flag) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_profExecSample = flag;
+}
+void VerilatedContext::profExecCollect(bool flag) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_profExecCollect = flag;
+}
 void VerilatedContext::profExecFilename(const std::string& flag) VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     m_ns.m_profExecFilename = flag;
@@ -2509,6 +2949,14 @@ std::string VerilatedContext::profExecFilename() const VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     return m_ns.m_profExecFilename;
 }
+void VerilatedContext::profExecCounters(const std::string& flag) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_profExecCounters = flag;
+}
+std::string VerilatedContext::profExecCounters() const VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    return m_ns.m_profExecCounters;
+}
 void VerilatedContext::profVltFilename(const std::string& flag) VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     m_ns.m_profVltFilename = flag;
@@ -2517,6 +2965,14 @@ std::string VerilatedContext::profVltFilename() const VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     return m_ns.m_profVltFilename;
 }
+void VerilatedContext::profSampleFilename(const std::string& flag) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_profSampleFilename = flag;
+}
+std::string VerilatedContext::profSampleFilename() const VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    return m_ns.m_profSampleFilename;
+}
 void VerilatedContext::randReset(int val) VL_MT_SAFE {
     const VerilatedLockGuard lock{m_mutex};
     m_s.m_randReset = val;
@@ -2534,7 +2990,7 @@ const char* VerilatedContext::timeprecisionString() const VL_MT_SAFE {
 void VerilatedContext::threads(unsigned n) {
     if (n == 0) VL_FATAL_MT(__FILE__, __LINE__, "", "%Error: Simulation threads must be >= 1");
 
-    if (m_threadPool) {
+    if (m_threadPool || m_threadPoolSharedp) {
         VL_FATAL_MT(
             __FILE__, __LINE__, "",
             "%Error: Cannot set simulation threads after the thread pool has been created.");
@@ -2550,6 +3006,153 @@ void VerilatedContext::threads(unsigned n) {
     }
 }
 
+void VerilatedContext::threadsAffinity(const std::string& cpus) {
+    if (m_threadPool || m_threadPoolSharedp) {
+        VL_FATAL_MT(
+            __FILE__, __LINE__, "",
+            "%Error: Cannot set simulation thread affinity after the thread pool has been created.");
+    }
+    // Parse comma separated list of CPUs or CPU ranges
+    std::vector<unsigned> result;
+    const char* cp = cpus.c_str();
+    while (*cp) {
+        char* endp;
+        const unsigned long first = std::strtoul(cp, &endp, 10);
+        unsigned long last = first;
+        bool ok = endp != cp;
+        if (ok && *endp == '-') {
+            cp = endp + 1;
+            last = std::strtoul(cp, &endp, 10);
+            ok = endp != cp && last >= first;
+        }
+        if (!ok || (*endp && *endp != ',')) {
+            const std::string msg = "%Error: Bad thread affinity CPU list: '" + cpus + "'";
+            VL_FATAL_MT(__FILE__, __LINE__, "", msg.c_str());
+            return;
+        }
+        for (unsigned long cpu = first; cpu <= last; ++cpu) result.push_back(cpu);
+        cp = *endp ? endp + 1 : endp;
+    }
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_threadsAffinity = result;
+}
+void VerilatedContext::threadsShared(bool flag) {
+    if (m_threadPool || m_threadPoolSharedp) {
+        VL_FATAL_MT(__FILE__, __LINE__, "",
+                    "%Error: Cannot set shared simulation threads after the thread pool has been "
+                    "created.");
+    }
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_threadsShared = flag;
+}
+void VerilatedContext::threadsScheduleTrial(uint64_t val) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_threadsScheduleTrial = val;
+}
+void VerilatedContext::threadsWait(int val) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_threadsWait = val;
+}
+void VerilatedContext::threadsStatsDump() const VL_MT_SAFE {
+    const VerilatedVirtualBase* const basep
+        = m_threadPoolSharedp ? m_threadPoolSharedp : m_threadPool.get();
+    if (const VlThreadPool* const poolp = static_cast<const VlThreadPool*>(basep)) {
+        poolp->statsDump();
+    }
+}
+
+uint64_t VerilatedContext::statsThreadWaitNs() const VL_MT_SAFE {
+    const VerilatedVirtualBase* const basep
+        = m_threadPoolSharedp ? m_threadPoolSharedp : m_threadPool.get();
+    if (const VlThreadPool* const poolp = static_cast<const VlThreadPool*>(basep)) {
+        return poolp->waitNs();
+    }
+    return 0;
+}
+std::string VerilatedContext::statsJson() const VL_MT_SAFE {
+    std::ostringstream os;
+    os << "{\"time\": " << time();
+    os << ", \"wall_ns\": " << VerilatedContextStats::nowNs();
+    for (int i = 0; i < VerilatedContextStats::_ENUM_END; ++i) {
+        const auto counter = static_cast<VerilatedContextStats::Counter>(i);
+        os << ", \"" << VerilatedContextStats::name(counter) << "\": " << m_stats.get(counter);
+    }
+    os << ", \"thread_wait_ns\": " << statsThreadWaitNs();
+    os << "}";
+    return os.str();
+}
+void VerilatedContext::statsFilename(const std::string& flag) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_statsFilename = flag;
+}
+std::string VerilatedContext::statsFilename() const VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    return m_ns.m_statsFilename;
+}
+void VerilatedContext::statsInterval(uint64_t seconds) VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_mutex};
+    m_ns.m_statsInterval = seconds;
+    m_stats.m_nextWriteNs = seconds ? VerilatedContextStats::nowNs() + seconds * 1000000000ULL : 0;
+}
+void VerilatedContext::statsWrite() VL_MT_SAFE {
+    const std::string filename = statsFilename();
+    if (filename.empty()) return;
+    const std::string line = statsJson() + "\n";
+    // Opened per write, as writes are infrequent and the file may be tailed or rotated
+    FILE* const fp = std::fopen(filename.c_str(), "a");
+    if (VL_UNLIKELY(!fp)) {
+        VL_FATAL_MT(filename.c_str(), 0, "", "+verilator+stats+file+ filename not writable");
+        return;
+    }
+    std::fputs(line.c_str(), fp);
+    std::fclose(fp);
+}
+void VerilatedContext::statsPrintSummary() VL_MT_SAFE {
+    const double wallS = (VerilatedContextStats::nowNs() - m_stats.m_startNs) / 1e9;
+    const double cpuS = static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    const double simS = time() * vl_time_multiplier(timeprecision());
+    const uint64_t evals = m_stats.get(VerilatedContextStats::EVALS);
+    VL_PRINTF_MT("- Verilator: %s at %g s; walltime %.3f s; speed %.3g s/s\n",
+                 gotFinish() ? "$finish" : "end", simS, wallS, wallS > 0 ? simS / wallS : 0.0);
+    if (evals) {
+        VL_PRINTF_MT("- Verilator: cpu %.3f s; %" PRIu64 " evals; %.3g evals/s\n", cpuS, evals,
+                     wallS > 0 ? evals / wallS : 0.0);
+    } else {
+        VL_PRINTF_MT("- Verilator: cpu %.3f s\n", cpuS);
+    }
+}
+void VerilatedContext::statsWritePeriodic() VL_MT_SAFE {
+    const uint64_t nowNs = VerilatedContextStats::nowNs();
+    uint64_t nextNs = m_stats.m_nextWriteNs.load(std::memory_order_relaxed);
+    if (nowNs < nextNs) return;
+    // Only one of several models evaluating concurrently writes
+    const uint64_t newNextNs = nowNs + statsInterval() * 1000000000ULL;
+    if (!m_stats.m_nextWriteNs.compare_exchange_strong(nextNs, newNextNs)) return;
+    statsWrite();
+}
+
+const char* VerilatedContextStats::name(Counter counter) VL_PURE {
+    static const char* const names[] = {"evals",
+                                        "iterations_stl",
+                                        "iterations_ico",
+                                        "iterations_act",
+                                        "iterations_nba",
+                                        "iterations_other",
+                                        "dpi_calls",
+                                        "vpi_callbacks",
+                                        "trace_dumps",
+                                        "trace_dump_ns",
+                                        "timing_queue_depth",
+                                        "timing_queue_depth_max"};
+    static_assert(sizeof(names) / sizeof(names[0]) == _ENUM_END, "names must match Counter");
+    return names[counter];
+}
+uint64_t VerilatedContextStats::nowNs() VL_MT_SAFE {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 void VerilatedContext::commandArgs(int argc, const char** argv) VL_MT_SAFE_EXCLUDES(m_argMutex) {
     // Not locking m_argMutex here, it is done in impp()->commandArgsAddGuts
     // m_argMutex here is the same as in impp()->commandArgsAddGuts;
@@ -2596,8 +3199,42 @@ void VerilatedContext::addModel(VerilatedModel* modelp) {
     }
 }
 
+int VerilatedContext::forkChild() VL_MT_UNSAFE {
+#if defined(_WIN32) || defined(__MINGW32__)
+    VL_FATAL_MT(__FILE__, __LINE__, "", "VerilatedContext::forkChild not supported on Windows");
+    return -1;
+#else
+    // Get everything buffered out, so neither process writes it twice
+    Verilated::runFlushCallbacks();
+    std::fflush(nullptr);
+    const pid_t pid = ::fork();
+    if (pid != 0) return pid;
+    // Child
+    if (VlThreadPool* const poolp = static_cast<VlThreadPool*>(m_threadPool.get())) {
+        poolp->restartAfterFork(this);
+    }
+    if (VlThreadPool* const poolp = static_cast<VlThreadPool*>(m_threadPoolSharedp)) {
+        poolp->restartAfterFork(this);
+    }
+    if (m_ns.m_ioThread) {
+        const VerilatedLockGuard lock{m_fdMutex};
+        // The writer thread was not forked, and its queue was drained above;
+        // leak the stale object, as it cannot be joined, and start a new one
+        (void)m_impdatap->m_ioThreadp.release();
+        m_impdatap->m_ioThreadp.reset(new VerilatedIoThread);
+    }
+    Verilated::runForkCallbacks();
+    return 0;
+#endif
+}
+
 VerilatedVirtualBase* VerilatedContext::threadPoolp() {
     if (m_threads == 1) return nullptr;
+    if (m_ns.m_threadsShared && !m_threadPool && !m_threadPoolSharedp) {
+        // Falls back to a private pool if the shared pool is too small
+        m_threadPoolSharedp = VlThreadPool::sharedAcquire(m_threads - 1);
+    }
+    if (m_threadPoolSharedp) return m_threadPoolSharedp;
     if (!m_threadPool) m_threadPool.reset(new VlThreadPool{this, m_threads - 1});
     return m_threadPool.get();
 }
@@ -2694,6 +3331,8 @@ void VerilatedContextImp::commandArgVl(const std::string& arg) {
             VL_PRINTF_MT("For help, please see 'verilator --help'\n");
             VL_FATAL_MT("COMMAND_LINE", 0, "",
                         "Exiting due to command line argument (not an error)");
+        } else if (commandArgVlUint64(arg, "+verilator+io+thread+", u64, 0, 1)) {
+            ioThread(u64 != 0);
         } else if (arg == "+verilator+noassert") {
             assertOn(false);
         } else if (commandArgVlUint64(arg, "+verilator+prof+exec+start+", u64)
@@ -2702,16 +3341,37 @@ void VerilatedContextImp::commandArgVl(const std::string& arg) {
         } else if (commandArgVlUint64(arg, "+verilator+prof+exec+window+", u64, 1)
                    || commandArgVlUint64(arg, "+verilator+prof+threads+window+", u64, 1)) {
             profExecWindow(u64);
+        } else if (commandArgVlUint64(arg, "+verilator+prof+exec+sample+", u64, 1,
+                                      std::numeric_limits<uint32_t>::max())) {
+            profExecSample(u64);
+        } else if (commandArgVlString(arg, "+verilator+prof+exec+counters+", str)) {
+            profExecCounters(str);
         } else if (commandArgVlString(arg, "+verilator+prof+exec+file+", str)
                    || commandArgVlString(arg, "+verilator+prof+threads+file+", str)) {
             profExecFilename(str);
         } else if (commandArgVlString(arg, "+verilator+prof+vlt+file+", str)) {
             profVltFilename(str);
+        } else if (commandArgVlString(arg, "+verilator+prof+sample+file+", str)) {
+            profSampleFilename(str);
         } else if (commandArgVlUint64(arg, "+verilator+rand+reset+", u64, 0, 2)) {
             randReset(static_cast<int>(u64));
+        } else if (commandArgVlUint64(arg, "+verilator+readmem+cache+", u64, 0, 1)) {
+            readmemCache(u64 != 0);
         } else if (commandArgVlUint64(arg, "+verilator+seed+", u64, 1,
                                       std::numeric_limits<int>::max())) {
             randSeed(static_cast<int>(u64));
+        } else if (commandArgVlString(arg, "+verilator+stats+file+", str)) {
+            statsFilename(str);
+        } else if (commandArgVlUint64(arg, "+verilator+stats+interval+", u64)) {
+            statsInterval(u64);
+        } else if (commandArgVlString(arg, "+verilator+threads+affinity+", str)) {
+            threadsAffinity(str);
+        } else if (commandArgVlUint64(arg, "+verilator+threads+schedule+trial+", u64, 0)) {
+            threadsScheduleTrial(u64);
+        } else if (commandArgVlUint64(arg, "+verilator+threads+shared+", u64, 0, 1)) {
+            threadsShared(u64 != 0);
+        } else if (commandArgVlUint64(arg, "+verilator+threads+wait+", u64, 0, 2)) {
+            threadsWait(static_cast<int>(u64));
         } else if (arg == "+verilator+V") {
             VerilatedImp::versionDump();  // Someday more info too
             VL_FATAL_MT("COMMAND_LINE", 0, "",
@@ -2787,8 +3447,23 @@ uint64_t VerilatedContextImp::randSeedDefault64() const VL_MT_SAFE {
 //======================================================================
 // VerilatedContext:: Methods - scopes
 
+void VerilatedContextImpData::nameMapUpdate() VL_REQUIRES(m_nameMutex) {
+    if (VL_LIKELY(m_namePending.empty())) return;
+    // Sorted so each insert is at the end of the map, and stable so as when inserted one at a
+    // time, the first scope of a given name is kept
+    std::stable_sort(m_namePending.begin(), m_namePending.end(),
+                     [](const VerilatedScope* ap, const VerilatedScope* bp) {
+                         return std::strcmp(ap->name(), bp->name()) < 0;
+                     });
+    for (const VerilatedScope* const scopep : m_namePending) {
+        m_nameMap.emplace_hint(m_nameMap.end(), scopep->name(), scopep);
+    }
+    std::vector<const VerilatedScope*>{}.swap(m_namePending);
+}
+
 void VerilatedContext::scopesDump() const VL_MT_SAFE {
     const VerilatedLockGuard lock{m_impdatap->m_nameMutex};
+    m_impdatap->nameMapUpdate();
     VL_PRINTF_MT("  scopesDump:\n");
     for (const auto& i : m_impdatap->m_nameMap) {
         const VerilatedScope* const scopep = i.second;
@@ -2800,25 +3475,41 @@ void VerilatedContext::scopesDump() const VL_MT_SAFE {
 void VerilatedContextImp::scopeInsert(const VerilatedScope* scopep) VL_MT_SAFE {
     // Slow ok - called once/scope at construction
     const VerilatedLockGuard lock{m_impdatap->m_nameMutex};
-    const auto it = m_impdatap->m_nameMap.find(scopep->name());
-    if (it == m_impdatap->m_nameMap.end()) m_impdatap->m_nameMap.emplace(scopep->name(), scopep);
+    m_impdatap->m_namePending.push_back(scopep);
+    ++m_impdatap->m_nameGeneration;
 }
 void VerilatedContextImp::scopeErase(const VerilatedScope* scopep) VL_MT_SAFE {
     // Slow ok - called once/scope at destruction
     const VerilatedLockGuard lock{m_impdatap->m_nameMutex};
     VerilatedImp::userEraseScope(scopep);
+    ++m_impdatap->m_nameGeneration;
+    // Scopes are normally destroyed in reverse order of construction, so if the map was never
+    // used this avoids building it
+    std::vector<const VerilatedScope*>& pending = m_impdatap->m_namePending;
+    if (!pending.empty() && pending.back() == scopep) {
+        pending.pop_back();
+        return;
+    }
+    m_impdatap->nameMapUpdate();
     const auto it = m_impdatap->m_nameMap.find(scopep->name());
     if (it != m_impdatap->m_nameMap.end()) m_impdatap->m_nameMap.erase(it);
 }
+uint64_t VerilatedContextImp::scopeNameGeneration() const VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_impdatap->m_nameMutex};
+    return m_impdatap->m_nameGeneration;
+}
 const VerilatedScope* VerilatedContext::scopeFind(const char* namep) const VL_MT_SAFE {
     // Thread save only assuming this is called only after model construction completed
     const VerilatedLockGuard lock{m_impdatap->m_nameMutex};
+    m_impdatap->nameMapUpdate();
     // If too slow, can assume this is only VL_MT_SAFE_POSINIT
     const auto& it = m_impdatap->m_nameMap.find(namep);
     if (VL_UNLIKELY(it == m_impdatap->m_nameMap.end())) return nullptr;
     return it->second;
 }
 const VerilatedScopeNameMap* VerilatedContext::scopeNameMap() VL_MT_SAFE {
+    const VerilatedLockGuard lock{m_impdatap->m_nameMutex};
+    m_impdatap->nameMapUpdate();
     return &(impp()->m_impdatap->m_nameMap);
 }
 
@@ -2884,6 +3575,8 @@ static struct {
     VoidPCbList s_flushCbs VL_GUARDED_BY(s_flushMutex);
     VerilatedMutex s_exitMutex;
     VoidPCbList s_exitCbs VL_GUARDED_BY(s_exitMutex);
+    VerilatedMutex s_forkMutex;
+    VoidPCbList s_forkCbs VL_GUARDED_BY(s_forkMutex);
 } VlCbStatic;
 
 static void addCbFlush(Verilated::VoidPCb cb, void* datap)
@@ -2900,6 +3593,13 @@ static void addCbExit(Verilated::VoidPCb cb, void* datap)
     VlCbStatic.s_exitCbs.remove(pair);  // Just in case it's a duplicate
     VlCbStatic.s_exitCbs.push_back(pair);
 }
+static void addCbFork(Verilated::VoidPCb cb, void* datap)
+    VL_MT_SAFE_EXCLUDES(VlCbStatic.s_forkMutex) {
+    const VerilatedLockGuard lock{VlCbStatic.s_forkMutex};
+    std::pair<Verilated::VoidPCb, void*> pair(cb, datap);
+    VlCbStatic.s_forkCbs.remove(pair);  // Just in case it's a duplicate
+    VlCbStatic.s_forkCbs.push_back(pair);
+}
 static void removeCbFlush(Verilated::VoidPCb cb, void* datap)
     VL_MT_SAFE_EXCLUDES(VlCbStatic.s_flushMutex) {
     const VerilatedLockGuard lock{VlCbStatic.s_flushMutex};
@@ -2912,6 +3612,12 @@ static void removeCbExit(Verilated::VoidPCb cb, void* datap)
     std::pair<Verilated::VoidPCb, void*> pair(cb, datap);
     VlCbStatic.s_exitCbs.remove(pair);
 }
+static void removeCbFork(Verilated::VoidPCb cb, void* datap)
+    VL_MT_SAFE_EXCLUDES(VlCbStatic.s_forkMutex) {
+    const VerilatedLockGuard lock{VlCbStatic.s_forkMutex};
+    std::pair<Verilated::VoidPCb, void*> pair(cb, datap);
+    VlCbStatic.s_forkCbs.remove(pair);
+}
 static void runCallbacks(const VoidPCbList& cbs) VL_MT_SAFE {
     for (const auto& i : cbs) i.first(i.second);
 }
@@ -2945,6 +3651,18 @@ void Verilated::runExitCallbacks() VL_MT_SAFE {
     --s_recursing;
 }
 
+void Verilated::addForkCb(VoidPCb cb, void* datap) VL_MT_SAFE { addCbFork(cb, datap); }
+void Verilated::removeForkCb(VoidPCb cb, void* datap) VL_MT_SAFE { removeCbFork(cb, datap); }
+void Verilated::runForkCallbacks() VL_MT_SAFE {
+    // Callbacks may remove themselves, so run from a copy
+    VoidPCbList cbs;
+    {
+        const VerilatedLockGuard lock{VlCbStatic.s_forkMutex};
+        cbs = VlCbStatic.s_forkCbs;
+    }
+    runCallbacks(cbs);
+}
+
 const char* Verilated::productName() VL_PURE { return VERILATOR_PRODUCT; }
 const char* Verilated::productVersion() VL_PURE { return VERILATOR_VERSION; }
 
@@ -3228,18 +3946,14 @@ void VerilatedAssertOneThread::fatal_different() VL_MT_SAFE {
 //===========================================================================
 // VlDeleter:: Methods
 
-void VlDeleter::deleteAll() VL_EXCLUDES(m_mutex) VL_EXCLUDES(m_deleteMutex) VL_MT_SAFE {
-    while (true) {
-        {
-            VerilatedLockGuard lock{m_mutex};
-            if (m_newGarbage.empty()) break;
-            m_deleteMutex.lock();
-            std::swap(m_newGarbage, m_toDelete);
-            // m_mutex is unlocked here, so destructors can enqueue new objects
+void VlDeleter::deleteAll() VL_MT_SAFE {
+    // Take the whole list at once; destructors may put new objects, so repeat until empty
+    while (VlDeletable* objp = m_newGarbagep.exchange(nullptr, std::memory_order_acquire)) {
+        while (objp) {
+            VlDeletable* const nextp = objp->m_garbageNextp;
+            delete objp;
+            objp = nextp;
         }
-        for (VlDeletable* const objp : m_toDelete) delete objp;
-        m_toDelete.clear();
-        m_deleteMutex.unlock();
     }
 }
 
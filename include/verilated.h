@@ -146,7 +146,8 @@ enum VerilatedVarFlags {
     // Flags
     VLVF_PUB_RD = (1 << 8),  // Public readable
     VLVF_PUB_RW = (1 << 9),  // Public writable
-    VLVF_DPI_CLAY = (1 << 10)  // DPI compatible C standard layout
+    VLVF_DPI_CLAY = (1 << 10),  // DPI compatible C standard layout
+    VLVF_VPI_HOOK = (1 << 11)  // Writes call VerilatedVpi::valueHook (--vpi-hooks)
 };
 
 //=============================================================================
@@ -326,6 +327,65 @@ public:
     virtual ~VerilatedVirtualBase() = default;
 };
 
+//===========================================================================
+/// Verilator runtime statistics
+///
+/// Counters of simulation activity, kept per VerilatedContext and returned
+/// by VerilatedContext::stats(). Model evaluations, scheduling region
+/// iterations, DPI calls and the timing queue depth are counted by models
+/// Verilated with --runtime-stats; trace dumps and VPI callbacks are always
+/// counted. All counters are cumulative from context creation, and may be
+/// read from any thread.
+
+class VerilatedContextStats final {
+public:
+    // TYPES
+    enum Counter : uint8_t {
+        EVALS,  // Model eval() calls
+        ITER_STL,  // Iterations of the 'stl' (settle) region loop
+        ITER_ICO,  // Iterations of the 'ico' (input combinational) region loop
+        ITER_ACT,  // Iterations of the 'act' (active) region loop
+        ITER_NBA,  // Iterations of the 'nba' region loop
+        ITER_OTHER,  // Iterations of the 'obs' and 'react' region loops
+        DPI_CALLS,  // Calls to DPI imports
+        VPI_CALLBACKS,  // VPI callbacks called
+        TRACE_DUMPS,  // Trace dump() calls
+        TRACE_DUMP_NS,  // Time spent in trace dump(), nanoseconds
+        TIMING_QUEUE_DEPTH,  // Delayed processes awaiting, as of the end of the last eval()
+        TIMING_QUEUE_DEPTH_MAX,  // Maximum of TIMING_QUEUE_DEPTH
+        _ENUM_END
+    };
+
+private:
+    // MEMBERS
+    std::array<std::atomic<uint64_t>, _ENUM_END> m_counters{};
+    std::atomic<uint64_t> m_nextWriteNs{0};  // Time of next periodic write, 0 = none
+    const uint64_t m_startNs = nowNs();  // Time of context creation, for statsPrintSummary
+
+    friend class VerilatedContext;
+
+public:
+    // METHODS
+    /// Return the value of a counter
+    uint64_t get(Counter counter) const VL_MT_SAFE {
+        return m_counters[counter].load(std::memory_order_relaxed);
+    }
+    /// Return the name of a counter, as used by VerilatedContext::statsWrite
+    static const char* name(Counter counter) VL_PURE;
+
+    // Internal: Update counters
+    void add(Counter counter, uint64_t value = 1) VL_MT_SAFE {
+        m_counters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+    void timingQueueDepth(uint64_t depth) VL_MT_SAFE {
+        m_counters[TIMING_QUEUE_DEPTH].store(depth, std::memory_order_relaxed);
+        if (depth > get(TIMING_QUEUE_DEPTH_MAX)) {
+            m_counters[TIMING_QUEUE_DEPTH_MAX].store(depth, std::memory_order_relaxed);
+        }
+    }
+    static uint64_t nowNs() VL_MT_SAFE;
+};
+
 //===========================================================================
 /// Verilator simulation context
 ///
@@ -380,9 +440,21 @@ protected:
         // Fast path
         uint64_t m_profExecStart = 1;  // +prof+exec+start time
         uint32_t m_profExecWindow = 2;  // +prof+exec+window size
+        uint32_t m_profExecSample = 1;  // +prof+exec+sample eval interval
+        bool m_profExecCollect = false;  // Collect --prof-exec window, see profExecCollect()
+        int m_threadsWait = 0;  // +verilator+threads+wait policy, see threadsWait()
+        bool m_ioThread = false;  // +verilator+io+thread, file writes on a background thread
+        bool m_readmemCache = false;  // +verilator+readmem+cache, see readmemCache()
+        bool m_threadsShared = false;  // +verilator+threads+shared, see threadsShared()
+        uint64_t m_threadsScheduleTrial = 100;  // +verilator+threads+schedule+trial evals
         // Slow path
         std::string m_profExecFilename;  // +prof+exec+file filename
+        std::string m_profExecCounters;  // +prof+exec+counters hardware counter list
         std::string m_profVltFilename;  // +prof+vlt filename
+        std::string m_profSampleFilename;  // +prof+sample+file filename
+        std::string m_statsFilename;  // +verilator+stats+file filename
+        uint64_t m_statsInterval = 0;  // +verilator+stats+interval seconds
+        std::vector<unsigned> m_threadsAffinity;  // +verilator+threads+affinity CPU list
     } m_ns;
 
     mutable VerilatedMutex m_argMutex;  // Protect m_argVec, m_argVecLoaded
@@ -400,10 +472,14 @@ protected:
     unsigned m_threads = std::thread::hardware_concurrency();
     // The thread pool shared by all models added to this context
     std::unique_ptr<VerilatedVirtualBase> m_threadPool;
+    // The process-wide thread pool used instead of m_threadPool, see threadsShared()
+    VerilatedVirtualBase* m_threadPoolSharedp = nullptr;
     // The execution profiler shared by all models added to this context
     std::unique_ptr<VerilatedVirtualBase> m_executionProfiler;
     // Coverage access
     std::unique_ptr<VerilatedVirtualBase> m_coveragep;  // Pointer for coveragep()
+    // Runtime statistics
+    VerilatedContextStats m_stats;
 
     // File I/O
     // Not serialized
@@ -466,6 +542,14 @@ public:
     void errorLimit(int val) VL_MT_SAFE;
     /// Return number of errors/assertions before stop
     int errorLimit() const VL_MT_SAFE { return m_s.m_errorLimit; }
+    /// Enable writing $display and $fwrite output on a background thread, so
+    /// the evaluating threads do not wait for slow files or terminals. Writes
+    /// to each file stay in order. They are complete on $fflush, $fclose,
+    /// $finish, $stop, $fatal, and Verilated::runFlushCallbacks(). When on,
+    /// $display text is written to stdout directly, rather than via VL_PRINTF.
+    void ioThread(bool flag) VL_MT_SAFE;
+    /// Return if writing files on a background thread
+    bool ioThread() const VL_MT_SAFE { return m_ns.m_ioThread; }
     /// Set to throw fatal error on $stop/non-fatal error
     void fatalOnError(bool flag) VL_MT_SAFE;
     /// Return if to throw fatal error on $stop/non-fatal
@@ -489,6 +573,22 @@ public:
     void randReset(int val) VL_MT_SAFE;
     /// Return randReset value
     int randReset() VL_MT_SAFE { return m_s.m_randReset; }
+    /// Enable caching $readmemh/$readmemb results. After a file is parsed,
+    /// the values read are saved next to it, in <filename>.vlcache. Later
+    /// reads of the file into arrays of the same width copy the values from
+    /// the cache, while the file's size and modification time are unchanged.
+    /// Files containing x digits are not cached, as their values are random.
+    void readmemCache(bool flag) VL_MT_SAFE;
+    /// Return if caching $readmem results
+    bool readmemCache() const VL_MT_SAFE { return m_ns.m_readmemCache; }
+    /// When the model was Verilated with --prof-exec, start (true) or stop
+    /// (false) collecting the execution profile from the next eval(),
+    /// rather than at +verilator+prof+exec+start for +verilator+prof+exec+window
+    /// evals. Records are streamed to the profile file while collecting, so
+    /// the window may be arbitrarily long. Each window rewrites the file.
+    void profExecCollect(bool flag) VL_MT_SAFE;
+    /// Return if collecting the --prof-exec execution profile was requested
+    bool profExecCollect() const VL_MT_SAFE { return m_ns.m_profExecCollect; }
     /// Return default random seed
     void randSeed(int val) VL_MT_SAFE;
     /// Set default random seed, 0 = seed it automatically
@@ -541,6 +641,75 @@ public:
     /// Can only be called before the thread pool is created (before first model is added).
     void threads(unsigned n);
 
+    /// Set the CPUs simulation threads are pinned to, as a list such as "0-3,8".
+    /// The thread creating the thread pool (normally the eval thread) is
+    /// pinned to the first CPU, each thread pool worker to the following
+    /// ones, wrapping around if there are fewer CPUs than threads.
+    /// Empty string = no pinning (the default).
+    /// Can only be called before the thread pool is created (before first model is added).
+    void threadsAffinity(const std::string& cpus);
+    /// Return CPUs simulation threads are pinned to, empty if not pinned
+    const std::vector<unsigned>& threadsAffinity() const { return m_ns.m_threadsAffinity; }
+    /// Set the number of evaluations each alternative schedule is timed for
+    /// before the fastest is selected, see --threads-schedules. 0 = always
+    /// use the first schedule.
+    void threadsScheduleTrial(uint64_t val) VL_MT_SAFE;
+    /// Return threadsScheduleTrial value
+    uint64_t threadsScheduleTrial() const VL_MT_SAFE { return m_ns.m_threadsScheduleTrial; }
+    /// Select how simulation threads wait for work or for other threads.
+    /// 0 = Spin, yielding the CPU only after long spins (the default)
+    /// 1 = Spin for a fixed budget, then park until woken
+    /// 2 = Spin for an adaptive budget learned from recent waits, then park
+    void threadsWait(int val) VL_MT_SAFE;
+    /// Return threadsWait value
+    int threadsWait() const VL_MT_SAFE { return m_ns.m_threadsWait; }
+    /// Use a thread pool shared with all other contexts in the process that
+    /// also set threadsShared, rather than one per context. Each evaluation
+    /// of a multithreaded graph then waits until the workers it needs are
+    /// free, with contexts that have used the least worker time served
+    /// first. The shared pool has one worker per hardware thread, less one,
+    /// or at least threads()-1 if more. Threads of a shared pool are not
+    /// pinned, see threadsAffinity.
+    /// Can only be called before the thread pool is created (before first model is added).
+    void threadsShared(bool flag);
+    /// Return if using the shared thread pool
+    bool threadsShared() const VL_MT_SAFE { return m_ns.m_threadsShared; }
+    /// Print the time each simulation thread pool worker spent working,
+    /// spinning and parked.
+    void threadsStatsDump() const VL_MT_SAFE;
+
+    /// Return the runtime statistics counters, see VerilatedContextStats
+    const VerilatedContextStats& stats() const VL_MT_SAFE { return m_stats; }
+    /// Return the time simulation thread pool workers have spent waiting
+    /// for work or for dependencies, in nanoseconds, summed across workers
+    uint64_t statsThreadWaitNs() const VL_MT_SAFE;
+    /// Return the runtime statistics as a single line JSON object
+    std::string statsJson() const VL_MT_SAFE;
+    /// Set filename that statsWrite appends to.  When set, the statistics
+    /// are also written when the context is destroyed.
+    void statsFilename(const std::string& flag) VL_MT_SAFE;
+    /// Return filename that statsWrite appends to, empty if none
+    std::string statsFilename() const VL_MT_SAFE;
+    /// Set the interval in (wall clock) seconds to periodically append the
+    /// statistics to statsFilename from eval(), 0 = off.  Requires a model
+    /// Verilated with --runtime-stats.
+    void statsInterval(uint64_t seconds) VL_MT_SAFE;
+    /// Return the statistics write interval
+    uint64_t statsInterval() const VL_MT_SAFE { return m_ns.m_statsInterval; }
+    /// Append the statistics as a line to statsFilename
+    void statsWrite() VL_MT_SAFE;
+    /// Print the simulated and wall clock time since context creation, the
+    /// simulation speed, and the evaluation rate if counted with --runtime-stats
+    void statsPrintSummary() VL_MT_SAFE;
+
+    /// Fork a child process that continues from the current state of all
+    /// models under this context, sharing their memory copy-on-write. In the
+    /// child the thread pool is restarted, and open trace files are detached
+    /// so that only the parent writes to them. Must be called from the eval
+    /// thread between evaluations. Returns 0 in the child, the child's process
+    /// ID in the parent, or -1 if the fork failed.
+    int forkChild() VL_MT_UNSAFE;
+
     /// Allow traces to at some point be enabled (disables some optimizations)
     void traceEverOn(bool flag) VL_MT_SAFE {
         if (flag) calcUnusedSigs(true);
@@ -580,10 +749,26 @@ public:
     uint64_t profExecStart() const VL_MT_SAFE { return m_ns.m_profExecStart; }
     void profExecWindow(uint64_t flag) VL_MT_SAFE;
     uint32_t profExecWindow() const VL_MT_SAFE { return m_ns.m_profExecWindow; }
+    void profExecSample(uint64_t flag) VL_MT_SAFE;
+    uint32_t profExecSample() const VL_MT_SAFE { return m_ns.m_profExecSample; }
     void profExecFilename(const std::string& flag) VL_MT_SAFE;
     std::string profExecFilename() const VL_MT_SAFE;
+    void profExecCounters(const std::string& flag) VL_MT_SAFE;
+    std::string profExecCounters() const VL_MT_SAFE;
     void profVltFilename(const std::string& flag) VL_MT_SAFE;
     std::string profVltFilename() const VL_MT_SAFE;
+    void profSampleFilename(const std::string& flag) VL_MT_SAFE;
+    std::string profSampleFilename() const VL_MT_SAFE;
+
+    // Internal: Runtime statistics updates, --runtime-stats
+    VerilatedContextStats& stats() VL_MT_SAFE { return m_stats; }
+    void statsEvalDone() VL_MT_SAFE {
+        m_stats.add(VerilatedContextStats::EVALS);
+        if (VL_UNLIKELY(m_stats.m_nextWriteNs.load(std::memory_order_relaxed))) {
+            statsWritePeriodic();
+        }
+    }
+    void statsWritePeriodic() VL_MT_SAFE;
 
     // Internal: Find scope
     const VerilatedScope* scopeFind(const char* namep) const VL_MT_SAFE;
@@ -696,6 +881,7 @@ class Verilated final {
         // Fast path
         VerilatedContext* t_contextp = nullptr;  // Thread's context
         uint32_t t_mtaskId = 0;  // mtask# executing on this thread
+        uint32_t t_threadIndex = 0;  // Index in context's thread pool, 0 = eval thread
         // Messages maybe pending on thread, needs end-of-eval calls
         uint32_t t_endOfEvalReqd = 0;
         const VerilatedScope* t_dpiScopep = nullptr;  // DPI context scope
@@ -832,7 +1018,7 @@ public:
     }
 #endif
 
-    /// Callback typedef for addFlushCb, addExitCb
+    /// Callback typedef for addFlushCb, addExitCb, addForkCb
     using VoidPCb = void (*)(void*);
     /// Add callback to run on global flush
     static void addFlushCb(VoidPCb cb, void* datap) VL_MT_SAFE;
@@ -849,6 +1035,12 @@ public:
     static void removeExitCb(VoidPCb cb, void* datap) VL_MT_SAFE;
     /// Run exit callbacks registered with addExitCb
     static void runExitCallbacks() VL_MT_SAFE;
+    /// Add callback to run in the child process created by VerilatedContext::forkChild
+    static void addForkCb(VoidPCb cb, void* datap) VL_MT_SAFE;
+    /// Remove callback to run in a forked child process
+    static void removeForkCb(VoidPCb cb, void* datap) VL_MT_SAFE;
+    /// Run fork callbacks registered with addForkCb
+    static void runForkCallbacks() VL_MT_SAFE;
 
     /// Return product name for (at least) VPI
     static const char* productName() VL_PURE;
@@ -911,6 +1103,9 @@ public:
     // Per thread, so no need to be in VerilatedContext
     static void mtaskId(uint32_t id) VL_MT_SAFE { t_s.t_mtaskId = id; }
     static uint32_t mtaskId() VL_MT_SAFE { return t_s.t_mtaskId; }
+    // Internal: Set the thread pool's index of this thread, called when a worker starts
+    static void threadIndex(uint32_t index) VL_MT_SAFE { t_s.t_threadIndex = index; }
+    static uint32_t threadIndex() VL_MT_SAFE { return t_s.t_threadIndex; }
     static void endOfEvalReqdInc() VL_MT_SAFE { ++t_s.t_endOfEvalReqd; }
     static void endOfEvalReqdDec() VL_MT_SAFE { --t_s.t_endOfEvalReqd; }
 
@@ -31,7 +31,9 @@
 #include <deque>
 #include <fstream>
 #include <map>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 //=============================================================================
 // VerilatedCovConst
@@ -50,16 +52,11 @@ struct VerilatedCovConst VL_NOT_FINAL {
 class VerilatedCovImpItem VL_NOT_FINAL {
 public:  // But only local to this file
     // MEMBERS
-    int m_keys[VerilatedCovConst::MAX_KEYS];  // Key
-    int m_vals[VerilatedCovConst::MAX_KEYS];  // Value for specified key
+    size_t m_fieldsIndex = 0;  // Index of first key in VerilatedCovImp::m_fields
+    int m_numFields = 0;  // Number of key/value pairs
     // CONSTRUCTORS
     // Derived classes should call zero() in their constructor
-    VerilatedCovImpItem() {
-        for (int i = 0; i < VerilatedCovConst::MAX_KEYS; ++i) {
-            m_keys[i] = VerilatedCovConst::KEY_UNDEF;
-            m_vals[i] = 0;
-        }
-    }
+    VerilatedCovImpItem() = default;
     virtual ~VerilatedCovImpItem() = default;
     virtual uint64_t count() const = 0;
     virtual void zero() const = 0;
@@ -90,6 +87,65 @@ public:
     ~VerilatedCoverItemSpec() override = default;
 };
 
+//=============================================================================
+// VerilatedCoverItemShards
+// Coverage item counted in one counter per thread, so threads never write
+// the same cache line; the count is the sum of the counters.
+
+class VerilatedCoverItemShards final : public VerilatedCovImpItem {
+private:
+    // MEMBERS
+    uint32_t* m_countp;  // First thread's count value
+    size_t m_shards;  // Number of counters
+    size_t m_stride;  // Distance from one thread's counter to the next
+public:
+    // METHODS
+    uint64_t count() const override {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < m_shards; ++i) sum += m_countp[i * m_stride];
+        return sum;
+    }
+    void zero() const override {
+        for (size_t i = 0; i < m_shards; ++i) m_countp[i * m_stride] = 0;
+    }
+    // CONSTRUCTORS
+    VerilatedCoverItemShards(uint32_t* countp, size_t shards, size_t stride)
+        : m_countp{countp}
+        , m_shards{shards}
+        , m_stride{stride} {
+        zero();
+    }
+    ~VerilatedCoverItemShards() override = default;
+};
+
+//=============================================================================
+// VerilatedCoverItemDiff
+// Coverage item without a counter of its own, such as the 'else' of a branch
+// whose 'if' and enclosing block are counted; the count is the difference.
+
+class VerilatedCoverItemDiff final : public VerilatedCovImpItem {
+private:
+    // MEMBERS
+    const VerilatedCoverItemShards m_base;  // Counts to take the difference from
+    const VerilatedCoverItemShards m_sub;  // Counts to subtract
+public:
+    // METHODS
+    uint64_t count() const override {
+        const uint64_t base = m_base.count();
+        const uint64_t sub = m_sub.count();
+        return base > sub ? base - sub : 0;
+    }
+    void zero() const override {
+        m_base.zero();
+        m_sub.zero();
+    }
+    // CONSTRUCTORS
+    VerilatedCoverItemDiff(uint32_t* countp, uint32_t* subp, size_t shards, size_t stride)
+        : m_base{countp, shards, stride}
+        , m_sub{subp, shards, stride} {}
+    ~VerilatedCoverItemDiff() override = default;
+};
+
 //=============================================================================
 // VerilatedCovImp
 //
@@ -101,15 +157,18 @@ public:
 class VerilatedCovImp final : public VerilatedCovContext {
 private:
     // TYPES
-    using ValueIndexMap = std::map<const std::string, int>;
-    using IndexValueMap = std::map<int, std::string>;
+    using ValueIndexMap = std::unordered_map<std::string, int>;
+    using IndexValueMap = std::vector<std::string>;
     using ItemList = std::deque<VerilatedCovImpItem*>;
+    using FieldList = std::deque<int>;
 
     // MEMBERS
     mutable VerilatedMutex m_mutex;  // Protects all members
     ValueIndexMap m_valueIndexes VL_GUARDED_BY(m_mutex);  // Unique arbitrary value for values
     IndexValueMap m_indexValues VL_GUARDED_BY(m_mutex);  // Unique arbitrary value for keys
     ItemList m_items VL_GUARDED_BY(m_mutex);  // List of all items
+    // Key and value indexes of each item's fields, shared so items stay small
+    FieldList m_fields VL_GUARDED_BY(m_mutex);
     int m_nextIndex VL_GUARDED_BY(m_mutex)
         = (VerilatedCovConst::KEY_UNDEF + 1);  // Next insert value
 
@@ -130,12 +189,12 @@ protected:
 private:
     // PRIVATE METHODS
     int valueIndex(const std::string& value) VL_REQUIRES(m_mutex) {
-        const auto iter = m_valueIndexes.find(value);
-        if (iter != m_valueIndexes.end()) return iter->second;
+        const auto pair = m_valueIndexes.emplace(value, m_nextIndex + 1);
+        if (!pair.second) return pair.first->second;
         ++m_nextIndex;
         assert(m_nextIndex > 0);  // Didn't rollover
-        m_valueIndexes.emplace(value, m_nextIndex);
-        m_indexValues.emplace(m_nextIndex, value);
+        m_indexValues.resize(m_nextIndex + 1);
+        m_indexValues[m_nextIndex] = value;
         return m_nextIndex;
     }
     static std::string dequote(const std::string& text) VL_PURE {
@@ -216,13 +275,11 @@ private:
     }
     bool itemMatchesString(VerilatedCovImpItem* itemp, const std::string& match)
         VL_REQUIRES(m_mutex) {
-        for (int i = 0; i < VerilatedCovConst::MAX_KEYS; ++i) {
-            if (itemp->m_keys[i] != VerilatedCovConst::KEY_UNDEF) {
-                // We don't compare keys, only values
-                const std::string val = m_indexValues[itemp->m_vals[i]];
-                if (std::string::npos != val.find(match)) {  // Found
-                    return true;
-                }
+        for (int i = 0; i < itemp->m_numFields; ++i) {
+            // We don't compare keys, only values
+            const std::string& val = m_indexValues[m_fields[itemp->m_fieldsIndex + 2 * i + 1]];
+            if (std::string::npos != val.find(match)) {  // Found
+                return true;
             }
         }
         return false;
@@ -246,10 +303,58 @@ private:
     void clearGuts() VL_REQUIRES(m_mutex) {
         for (const auto& itemp : m_items) VL_DO_DANGLING(delete itemp, itemp);
         m_items.clear();
+        m_fields.clear();
         m_indexValues.clear();
         m_valueIndexes.clear();
         m_nextIndex = VerilatedCovConst::KEY_UNDEF + 1;
     }
+    using EventCounts = std::map<const std::string, std::pair<std::string, uint64_t>>;
+    EventCounts eventCounts() VL_REQUIRES(m_mutex) {
+        // Build list of events; totalize if collapsing hierarchy
+        EventCounts eventCounts;
+        for (const auto& itemp : m_items) {
+            std::string name;
+            std::string hier;
+            bool per_instance = false;
+            if (m_forcePerInstance) per_instance = true;
+
+            for (int i = 0; i < itemp->m_numFields; ++i) {
+                const size_t fieldIndex = itemp->m_fieldsIndex + 2 * i;
+                const std::string key
+                    = VerilatedCovKey::shortKey(m_indexValues[m_fields[fieldIndex]]);
+                const std::string& val = m_indexValues[m_fields[fieldIndex + 1]];
+                if (key == VL_CIK_PER_INSTANCE) {
+                    if (val != "0") per_instance = true;
+                }
+                if (key == VL_CIK_HIER) {
+                    hier = val;
+                } else {
+                    // Print it
+                    name += keyValueFormatter(key, val);
+                }
+            }
+            if (per_instance) {  // Not collapsing hierarchies
+                name += keyValueFormatter(VL_CIK_HIER, hier);
+                hier = "";
+            }
+
+            // Group versus point labels don't matter here, downstream
+            // deals with it.  Seems bad for sizing though and doesn't
+            // allow easy addition of new group codes (would be
+            // inefficient)
+
+            // Find or insert the named event
+            const auto cit = eventCounts.find(name);
+            if (cit != eventCounts.end()) {
+                const std::string& oldhier = cit->second.first;
+                cit->second.second += itemp->count();
+                cit->second.first = combineHier(oldhier, hier);
+            } else {
+                eventCounts.emplace(name, std::make_pair(hier, itemp->count()));
+            }
+        }
+        return eventCounts;
+    }
 
 public:
     // PUBLIC METHODS
@@ -315,38 +420,29 @@ public:
         ckeyps[2] = "page";
         valps[2] = page_default.c_str();
 
-        // Keys -> strings
-        std::string keys[VerilatedCovConst::MAX_KEYS];
-        for (int i = 0; i < VerilatedCovConst::MAX_KEYS; ++i) {
-            if (ckeyps[i] && ckeyps[i][0]) keys[i] = ckeyps[i];
-        }
-        // Ignore empty keys
+        // Insert the values, ignoring empty keys
+        m_insertp->m_fieldsIndex = m_fields.size();
         for (int i = 0; i < VerilatedCovConst::MAX_KEYS; ++i) {
-            if (!keys[i].empty()) {
-                for (int j = i + 1; j < VerilatedCovConst::MAX_KEYS; ++j) {
-                    if (keys[i] == keys[j]) {  // Duplicate key.  Keep the last one
-                        keys[i] = "";
-                        break;
-                    }
+            const char* const keyp = ckeyps[i];
+            if (!keyp || !keyp[0]) continue;
+            bool duplicate = false;
+            for (int j = i + 1; j < VerilatedCovConst::MAX_KEYS; ++j) {
+                if (ckeyps[j] && 0 == std::strcmp(keyp, ckeyps[j])) {
+                    duplicate = true;  // Duplicate key.  Keep the last one
+                    break;
                 }
             }
-        }
-        // Insert the values
-        int addKeynum = 0;
-        for (int i = 0; i < VerilatedCovConst::MAX_KEYS; ++i) {
-            const std::string key = keys[i];
-            if (!keys[i].empty()) {
-                const std::string val = valps[i];
-                // cout<<"   "<<__FUNCTION__<<"  "<<key<<" = "<<val<<endl;
-                m_insertp->m_keys[addKeynum] = valueIndex(key);
-                m_insertp->m_vals[addKeynum] = valueIndex(val);
-                ++addKeynum;
-                if (VL_UNCOVERABLE(!legalKey(key))) {
-                    const std::string msg
-                        = ("%Error: Coverage keys of one character, or letter+digit are illegal: "
-                           + key);  // LCOV_EXCL_LINE
-                    VL_FATAL_MT("", 0, "", msg.c_str());
-                }
+            if (duplicate) continue;
+            const std::string key = keyp;
+            // cout<<"   "<<__FUNCTION__<<"  "<<key<<" = "<<valps[i]<<endl;
+            m_fields.push_back(valueIndex(key));
+            m_fields.push_back(valueIndex(valps[i]));
+            ++m_insertp->m_numFields;
+            if (VL_UNCOVERABLE(!legalKey(key))) {
+                const std::string msg
+                    = ("%Error: Coverage keys of one character, or letter+digit are illegal: "
+                       + key);  // LCOV_EXCL_LINE
+                VL_FATAL_MT("", 0, "", msg.c_str());
             }
         }
         m_items.push_back(m_insertp);
@@ -367,53 +463,8 @@ public:
         }
         os << "# SystemC::Coverage-3\n";
 
-        // Build list of events; totalize if collapsing hierarchy
-        std::map<const std::string, std::pair<std::string, uint64_t>> eventCounts;
-        for (const auto& itemp : m_items) {
-            std::string name;
-            std::string hier;
-            bool per_instance = false;
-            if (m_forcePerInstance) per_instance = true;
-
-            for (int i = 0; i < VerilatedCovConst::MAX_KEYS; ++i) {
-                if (itemp->m_keys[i] != VerilatedCovConst::KEY_UNDEF) {
-                    const std::string key
-                        = VerilatedCovKey::shortKey(m_indexValues[itemp->m_keys[i]]);
-                    const std::string val = m_indexValues[itemp->m_vals[i]];
-                    if (key == VL_CIK_PER_INSTANCE) {
-                        if (val != "0") per_instance = true;
-                    }
-                    if (key == VL_CIK_HIER) {
-                        hier = val;
-                    } else {
-                        // Print it
-                        name += keyValueFormatter(key, val);
-                    }
-                }
-            }
-            if (per_instance) {  // Not collapsing hierarchies
-                name += keyValueFormatter(VL_CIK_HIER, hier);
-                hier = "";
-            }
-
-            // Group versus point labels don't matter here, downstream
-            // deals with it.  Seems bad for sizing though and doesn't
-            // allow easy addition of new group codes (would be
-            // inefficient)
-
-            // Find or insert the named event
-            const auto cit = eventCounts.find(name);
-            if (cit != eventCounts.end()) {
-                const std::string& oldhier = cit->second.first;
-                cit->second.second += itemp->count();
-                cit->second.first = combineHier(oldhier, hier);
-            } else {
-                eventCounts.emplace(name, std::make_pair(hier, itemp->count()));
-            }
-        }
-
         // Output body
-        for (const auto& i : eventCounts) {
+        for (const auto& i : eventCounts()) {
             os << "C '" << std::dec;
             os << i.first;
             if (!i.second.first.empty()) os << keyValueFormatter(VL_CIK_HIER, i.second.first);
@@ -421,6 +472,71 @@ public:
             os << '\n';
         }
     }
+
+    void writeBinary(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex) {
+        // Binary coverage file, integers little endian:
+        //    "VLCOVBIN", u32 version, u32 number of fields, u64 number of
+        //        points, u64 bytes in the index that follows
+        //    Index: per field: u32 length, characters; then per point:
+        //        u32 number of fields, u32 index of each field
+        //    Counts: u64 per point
+        // A field is one "\001key\002value" of the text format's point
+        // names, and a point's name is its fields concatenated. Runs of the
+        // same model have identical indexes, so readers may skip parsing them.
+        Verilated::quiesce();
+        const VerilatedLockGuard lock{m_mutex};
+        selftest();
+
+        std::ofstream os{filename, std::ios::binary};
+        if (os.fail()) {
+            const std::string msg = std::string{"%Error: Can't write '"} + filename + "'";
+            VL_FATAL_MT("", 0, "", msg.c_str());
+            return;
+        }
+
+        // Intern the fields, the points refer to them by index
+        std::unordered_map<std::string, uint32_t> fieldIndexes;
+        std::vector<const std::string*> fields;
+        std::vector<uint32_t> pointFields;  // Per point: number of fields, then indexes
+        std::vector<uint64_t> counts;
+        uint64_t indexBytes = 0;
+        for (const auto& i : eventCounts()) {
+            std::string name = i.first;
+            if (!i.second.first.empty()) name += keyValueFormatter(VL_CIK_HIER, i.second.first);
+            const size_t numPos = pointFields.size();
+            pointFields.push_back(0);
+            for (size_t pos = 0; pos < name.size();) {
+                const size_t endPos = std::min(name.find('\001', pos + 1), name.size());
+                const auto it
+                    = fieldIndexes.emplace(name.substr(pos, endPos - pos), fields.size()).first;
+                if (it->second == fields.size()) {
+                    fields.push_back(&it->first);
+                    indexBytes += sizeof(uint32_t) + it->first.size();
+                }
+                pointFields.push_back(it->second);
+                ++pointFields[numPos];
+                pos = endPos;
+            }
+            counts.push_back(i.second.second);
+        }
+        indexBytes += pointFields.size() * sizeof(uint32_t);
+
+        const auto put = [&os](const void* datap, size_t size) {
+            os.write(static_cast<const char*>(datap), size);
+        };
+        const uint32_t header[2] = {1, static_cast<uint32_t>(fields.size())};  // Version, fields
+        const uint64_t sizes[2] = {counts.size(), indexBytes};
+        put("VLCOVBIN", 8);
+        put(header, sizeof(header));
+        put(sizes, sizeof(sizes));
+        for (const std::string* fieldp : fields) {
+            const uint32_t len = fieldp->size();
+            put(&len, sizeof(len));
+            put(fieldp->data(), len);
+        }
+        put(pointFields.data(), pointFields.size() * sizeof(uint32_t));
+        put(counts.data(), counts.size() * sizeof(uint64_t));
+    }
 };
 
 //=============================================================================
@@ -435,12 +551,22 @@ void VerilatedCovContext::clearNonMatch(const char* matchp) VL_MT_SAFE {
 }
 void VerilatedCovContext::zero() VL_MT_SAFE { impp()->zero(); }
 void VerilatedCovContext::write(const char* filenamep) VL_MT_SAFE { impp()->write(filenamep); }
+void VerilatedCovContext::writeBinary(const char* filenamep) VL_MT_SAFE {
+    impp()->writeBinary(filenamep);
+}
 void VerilatedCovContext::_inserti(uint32_t* itemp) VL_MT_SAFE {
     impp()->inserti(new VerilatedCoverItemSpec<uint32_t>{itemp});
 }
 void VerilatedCovContext::_inserti(uint64_t* itemp) VL_MT_SAFE {
     impp()->inserti(new VerilatedCoverItemSpec<uint64_t>{itemp});
 }
+void VerilatedCovContext::_inserti(uint32_t* itemp, size_t shards, size_t stride) VL_MT_SAFE {
+    impp()->inserti(new VerilatedCoverItemShards{itemp, shards, stride});
+}
+void VerilatedCovContext::_inserti(uint32_t* itemp, uint32_t* subp, size_t shards,
+                                   size_t stride) VL_MT_SAFE {
+    impp()->inserti(new VerilatedCoverItemDiff{itemp, subp, shards, stride});
+}
 void VerilatedCovContext::_insertf(const char* filename, int lineno) VL_MT_SAFE {
     impp()->insertf(filename, lineno);
 }
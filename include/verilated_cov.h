@@ -73,6 +73,26 @@ class VerilatedCovImp;
         covcontextp->_insertp("hier", name(), __VA_ARGS__); \
     } while (false)
 
+/// Insert an item whose count is kept in 'shards' counters, one per
+/// thread, each 'stride' counters after the previous.  The counters are
+/// summed when the coverage is written.
+#define VL_COVER_INSERT_SHARDS(covcontextp, countp, shards, stride, ...) \
+    do { \
+        covcontextp->_inserti(countp, shards, stride); \
+        covcontextp->_insertf(__FILE__, __LINE__); \
+        covcontextp->_insertp("hier", name(), __VA_ARGS__); \
+    } while (false)
+
+/// Insert an item with no counter of its own, whose count is the count in
+/// 'countp' minus the count in 'subp' when the coverage is written.  Both
+/// counts are kept in 'shards' counters as with VL_COVER_INSERT_SHARDS.
+#define VL_COVER_INSERT_DIFF(covcontextp, countp, subp, shards, stride, ...) \
+    do { \
+        covcontextp->_inserti(countp, subp, shards, stride); \
+        covcontextp->_insertf(__FILE__, __LINE__); \
+        covcontextp->_insertp("hier", name(), __VA_ARGS__); \
+    } while (false)
+
 //=============================================================================
 // Convert VL_COVER_INSERT value arguments to strings, is \internal
 
@@ -102,6 +122,11 @@ public:
     void forcePerInstance(bool flag) VL_MT_SAFE;
     /// Write all coverage data to a file
     void write(const char* filenamep = defaultFilename()) VL_MT_SAFE;
+    /// Return default filename for writeBinary
+    static const char* defaultBinaryFilename() VL_PURE { return "coverage.vlcov"; }
+    /// Write all coverage data to a file in the indexed binary format,
+    /// which verilator_coverage reads and merges faster than the text format
+    void writeBinary(const char* filenamep = defaultBinaryFilename()) VL_MT_SAFE;
     /// Clear coverage points (and call delete on all items)
     void clear() VL_MT_SAFE;
     /// Clear items not matching the provided string
@@ -118,6 +143,8 @@ public:
     // _insert1: Remember item pointer with count.  (Not const, as may add zeroing function)
     void _inserti(uint32_t* itemp) VL_MT_SAFE;
     void _inserti(uint64_t* itemp) VL_MT_SAFE;
+    void _inserti(uint32_t* itemp, size_t shards, size_t stride) VL_MT_SAFE;
+    void _inserti(uint32_t* itemp, uint32_t* subp, size_t shards, size_t stride) VL_MT_SAFE;
     // _insert2: Set default filename and line number
     void _insertf(const char* filename, int lineno) VL_MT_SAFE;
     // _insert3: Set parameters
@@ -0,0 +1,145 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+//
+// Code available from: https://verilator.org
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU Lesser
+// General Public License Version 3 or the Perl Artistic License Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+///
+/// \file
+/// \brief Verilated batched DPI export call header
+///
+/// This file may be included by user C++ code that makes many calls to DPI
+/// exported functions, to queue the calls and then make them all under a
+/// single scope.
+///
+//*************************************************************************
+
+#ifndef VERILATOR_VERILATED_DPI_BATCH_H_
+#define VERILATOR_VERILATED_DPI_BATCH_H_
+
+#include "verilatedos.h"
+
+#include "svdpi.h"
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+//=============================================================================
+// VerilatedDpiBatchUnpack
+// Internal: Read queued arguments back, one at a time, then make the call
+
+template <typename... T_Rest>
+struct VerilatedDpiBatchUnpack;
+template <>
+struct VerilatedDpiBatchUnpack<> final {
+    template <typename T_Fn, typename... T_Done>
+    static void call(T_Fn fn, const uint8_t*, T_Done... done) {
+        fn(done...);
+    }
+};
+template <typename T_First, typename... T_Rest>
+struct VerilatedDpiBatchUnpack<T_First, T_Rest...> final {
+    template <typename T_Fn, typename... T_Done>
+    static void call(T_Fn fn, const uint8_t* argsp, T_Done... done) {
+        T_First arg;
+        std::memcpy(&arg, argsp, sizeof(T_First));
+        VerilatedDpiBatchUnpack<T_Rest...>::call(fn, argsp + sizeof(T_First), done..., arg);
+    }
+};
+
+//=============================================================================
+// VerilatedDpiBatch
+/// Queue of calls to DPI exported functions, made in order by run().
+///
+/// Each exported function called directly from C sets up its own call,
+/// which is costly when stimulus makes thousands of calls per cycle. A
+/// batch instead stores the calls in one flat buffer, without a heap
+/// allocation per call, and run() makes them all under one svSetScope.
+/// Arguments are copied when queued, however anything they point to (e.g.
+/// svBitVecVal arrays) must remain valid until run(). Return values of
+/// exported functions are discarded.
+
+class VerilatedDpiBatch final {
+    // TYPES
+    using Invoker = void (*)(const uint8_t* bufp);  // Unpacks and makes one call
+    struct Call final {
+        Invoker m_invoker;  // Function to make the call
+        size_t m_offset;  // Offset in m_buf of function pointer and arguments
+    };
+
+    // MEMBERS
+    const svScope m_scope;  // Scope the calls are made under
+    std::vector<Call> m_calls;  // Queued calls, in order
+    std::vector<uint8_t> m_buf;  // Function pointers and arguments of queued calls
+
+    // METHODS
+    template <typename T>
+    void push(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "DPI batch arguments must be trivially copyable");
+        const size_t offset = m_buf.size();
+        m_buf.resize(offset + sizeof(T));
+        std::memcpy(m_buf.data() + offset, &value, sizeof(T));
+    }
+    template <typename T_Ret, typename... T_Params>
+    static void invoke(const uint8_t* bufp) {
+        using Fn = T_Ret (*)(T_Params...);
+        Fn fn;
+        std::memcpy(&fn, bufp, sizeof(Fn));
+        VerilatedDpiBatchUnpack<T_Params...>::call(fn, bufp + sizeof(Fn));
+    }
+
+public:
+    // CONSTRUCTORS
+    /// Create a batch whose calls will be made under the given scope,
+    /// e.g. from svGetScopeFromName
+    explicit VerilatedDpiBatch(svScope scope)
+        : m_scope{scope} {}
+    ~VerilatedDpiBatch() = default;
+    VL_UNCOPYABLE(VerilatedDpiBatch);
+
+    // METHODS
+    /// Queue a call to the given exported function with the given arguments
+    template <typename T_Ret, typename... T_Params, typename... T_Args>
+    void add(T_Ret (*fn)(T_Params...), T_Args... args) {
+        static_assert(sizeof...(T_Params) == sizeof...(T_Args),
+                      "Wrong number of arguments to DPI function");
+        m_calls.push_back(Call{&invoke<T_Ret, T_Params...>, m_buf.size()});
+        push(fn);
+        // Braced list so arguments are pushed in order
+        const int unused[] = {0, (push(static_cast<T_Params>(args)), 0)...};
+        (void)unused;
+    }
+    /// Make all queued calls in order, then clear the queue
+    void run() {
+        const svScope prevScope = svSetScope(m_scope);
+        const uint8_t* const bufp = m_buf.data();
+        for (const Call& call : m_calls) call.m_invoker(bufp + call.m_offset);
+        svSetScope(prevScope);
+        clear();
+    }
+    /// Discard all queued calls
+    void clear() {
+        m_calls.clear();
+        m_buf.clear();
+    }
+    /// Reserve space for the given number of calls with the given argument bytes
+    void reserve(size_t calls, size_t bytes) {
+        m_calls.reserve(calls);
+        m_buf.reserve(bytes);
+    }
+    /// Return number of queued calls
+    size_t size() const { return m_calls.size(); }
+    /// Return true if there are no queued calls
+    bool empty() const { return m_calls.empty(); }
+    /// Return scope the calls are made under
+    svScope scope() const { return m_scope; }
+};
+
+#endif  // Guard
@@ -103,7 +103,10 @@ void VerilatedFst::open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex) {
     m_fst = fstWriterCreate(filename, 1);
     fstWriterSetPackType(m_fst, FST_WR_PT_LZ4);
     fstWriterSetTimescaleFromString(m_fst, timeResStr().c_str());  // lintok-begin-on-ref
-    if (m_useFstWriterThread) fstWriterSetParallelMode(m_fst, 1);
+    if (m_compressThreads > 1) {
+        fstWriterSetParallelCompress(m_fst, m_compressThreads, m_compressBudget);
+    }
+    if (m_useFstWriterThread || m_compressThreads > 1) fstWriterSetParallelMode(m_fst, 1);
     fullDump(true);  // First dump must be full for fst
 
     m_curScope.clear();
@@ -139,6 +142,29 @@ void VerilatedFst::flush() VL_MT_SAFE_EXCLUDES(m_mutex) {
     const VerilatedLockGuard lock{m_mutex};
     Super::flushBase();
     fstWriterFlushContext(m_fst);
+    // In parallel mode a previous context may still be being written by a
+    // separate thread. Wait for it, as fstapi itself does, so that forkChild
+    // never copies the file streams mid-write.
+    fstWriterContext* const xcp = static_cast<fstWriterContext*>(m_fst);
+    while (xcp && xcp->in_pthread) {
+        pthread_mutex_lock(&xcp->mutex);
+        pthread_mutex_unlock(&xcp->mutex);
+    }
+}
+
+void VerilatedFst::detach() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    if (!m_fst) return;
+    Super::detachBase();
+    // The writer context belongs to the parent, and its mutexes may have been
+    // copied locked, so leak it. Its streams include the parent's output and
+    // shared temporary files, make sure libc flushing them on exit is harmless.
+    fstWriterContext* const xcp = static_cast<fstWriterContext*>(m_fst);
+    for (FILE* const fp : {xcp->handle, xcp->hier_handle, xcp->geom_handle, xcp->valpos_handle,
+                           xcp->curval_handle, xcp->tchn_handle}) {
+        if (fp) detachFd(fileno(fp));
+    }
+    m_fst = nullptr;
 }
 
 void VerilatedFst::emitTimeChange(uint64_t timeui) { fstWriterEmitTimeChange(m_fst, timeui); }
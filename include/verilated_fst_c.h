@@ -56,6 +56,8 @@ private:
     char* m_strbufp = nullptr;  // String buffer long enough to hold maxBits() chars
 
     bool m_useFstWriterThread = false;  // Whether to use the separate FST writer thread
+    unsigned m_compressThreads = 0;  // Value change compression threads, 0/1 = in writer
+    uint64_t m_compressBudget = 0;  // Max compressed bytes awaiting write, 0 = default
 
     // CONSTRUCTORS
     VL_UNCOPYABLE(VerilatedFst);
@@ -88,6 +90,13 @@ public:
     explicit VerilatedFst(void* fst = nullptr);
     ~VerilatedFst();
 
+    // ACCESSORS
+    // Set number of value change compression threads, and memory budget. Call before open.
+    void compressThreads(unsigned threads, uint64_t budget) VL_MT_SAFE {
+        m_compressThreads = threads;
+        m_compressBudget = budget;
+    }
+
     // METHODS - All must be thread safe
     // Open the file; call isOpen() to see if errors
     void open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex);
@@ -95,6 +104,9 @@ public:
     void close() VL_MT_SAFE_EXCLUDES(m_mutex);
     // Flush any remaining data to this file
     void flush() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // In a child created by VerilatedContext::forkChild, stop writing to the
+    // parent's file without flushing or closing it; the trace is then closed
+    void detach() VL_MT_SAFE_EXCLUDES(m_mutex);
     // Return if file is open
     bool isOpen() const VL_MT_SAFE { return m_fst != nullptr; }
 
@@ -132,6 +144,12 @@ template <>
 void VerilatedFst::Super::set_time_resolution(const std::string& unit);
 template <>
 void VerilatedFst::Super::dumpvars(int level, const std::string& hier);
+template <>
+void VerilatedFst::Super::scopeEnable(const std::string& hier, bool flag);
+template <>
+void VerilatedFst::Super::sampleEvery(uint32_t every);
+template <>
+void VerilatedFst::Super::sampleWindow(uint64_t period, uint64_t width, uint64_t start);
 #endif
 
 //=============================================================================
@@ -195,6 +213,13 @@ public:
 
     /// Return if file is open
     bool isOpen() const VL_MT_SAFE { return m_sptrace.isOpen(); }
+    /// Compress each block of value changes using 'threads' worker threads,
+    /// which also moves writing to the FST writer thread. At most about
+    /// 'budget' bytes of compressed data are held waiting to be written
+    /// (0 = 64 MB). Must be called before open.
+    void compressThreads(unsigned threads, uint64_t budget = 0) VL_MT_SAFE {
+        m_sptrace.compressThreads(threads, budget);
+    }
     /// Open a new FST file
     void open(const char* filename) VL_MT_SAFE { m_sptrace.open(filename); }
     /// Close dump
@@ -233,6 +258,16 @@ public:
     void dumpvars(int level, const std::string& hier) VL_MT_SAFE {
         m_sptrace.dumpvars(level, hier);
     }
+    // Enable or disable tracing of a scope and everything under it, at any time
+    void scopeEnable(const std::string& hier, bool flag) VL_MT_SAFE {
+        m_sptrace.scopeEnable(hier, flag);
+    }
+    // Write only every 'every'th call to dump()
+    void sampleEvery(uint32_t every) VL_MT_SAFE { m_sptrace.sampleEvery(every); }
+    // Write dumps only within windows of 'width' time units every 'period' from 'start'
+    void sampleWindow(uint64_t period, uint64_t width, uint64_t start = 0) VL_MT_SAFE {
+        m_sptrace.sampleWindow(period, width, start);
+    }
 
     // Internal class access
     VerilatedFst* spTrace() { return &m_sptrace; }
@@ -28,6 +28,8 @@
 #error "verilated_funcs.h should only be included by verilated.h"
 #endif
 
+#include "verilated_intrinsics.h"
+
 #include <string>
 
 //=========================================================================
@@ -106,6 +108,12 @@ extern IData VL_RAND_RESET_I(int obits) VL_MT_SAFE;
 extern QData VL_RAND_RESET_Q(int obits) VL_MT_SAFE;
 /// Random reset a signal of given width (init time only)
 extern WDataOutP VL_RAND_RESET_W(int obits, WDataOutP outwp) VL_MT_SAFE;
+/// Random reset each element of an array of signals of given width (init time only)
+extern void VL_RAND_RESET_ARRAY_C(int obits, CData* datap, size_t elements) VL_MT_SAFE;
+extern void VL_RAND_RESET_ARRAY_S(int obits, SData* datap, size_t elements) VL_MT_SAFE;
+extern void VL_RAND_RESET_ARRAY_I(int obits, IData* datap, size_t elements) VL_MT_SAFE;
+extern void VL_RAND_RESET_ARRAY_Q(int obits, QData* datap, size_t elements) VL_MT_SAFE;
+extern void VL_RAND_RESET_ARRAY_W(int obits, EData* datap, size_t elements) VL_MT_SAFE;
 /// Zero reset a signal (slow - else use VL_ZERO_W)
 extern WDataOutP VL_ZERO_RESET_W(int obits, WDataOutP outwp) VL_MT_SAFE;
 
@@ -126,6 +134,7 @@ extern IData VL_FREAD_I(int width, int array_lsb, int array_size, void* memp, ID
                         IData start, IData count) VL_MT_SAFE;
 
 extern void VL_WRITEF(const char* formatp, ...) VL_MT_SAFE;
+extern void VL_WRITES(const char* strp) VL_MT_SAFE;
 extern void VL_FWRITEF(IData fpi, const char* formatp, ...) VL_MT_SAFE;
 
 extern IData VL_FSCANF_IX(IData fpi, const char* formatp, ...) VL_MT_SAFE;
@@ -586,6 +595,363 @@ static inline WDataOutP VL_EXTENDS_WW(int obits, int lbits, WDataOutP owp,
     return owp;
 }
 
+//===================================================================
+// Wide word vector helpers
+//
+// Internal: the wide operators below process as many words per instruction
+// as the target's vector unit allows (see verilated_intrinsics.h), then
+// finish any remaining words one at a time. Define VL_PORTABLE_ONLY to use
+// only the scalar loops. Generated code passes the word count as a literal,
+// so once inlined these have fixed trip counts, and the compiler unrolls
+// them and drops the loops that cannot run; no per-width templates needed.
+
+// Internal: Reduce a vector of words to one word by OR or XOR
+#ifdef VL_HAVE_SSE2
+static inline EData _vl_simd_or_e(__m128i v) VL_PURE {
+    v = _mm_or_si128(v, _mm_shuffle_epi32(v, 0x4e));
+    v = _mm_or_si128(v, _mm_shuffle_epi32(v, 0xb1));
+    return static_cast<EData>(_mm_cvtsi128_si32(v));
+}
+static inline EData _vl_simd_xor_e(__m128i v) VL_PURE {
+    v = _mm_xor_si128(v, _mm_shuffle_epi32(v, 0x4e));
+    v = _mm_xor_si128(v, _mm_shuffle_epi32(v, 0xb1));
+    return static_cast<EData>(_mm_cvtsi128_si32(v));
+}
+#endif
+#ifdef VL_HAVE_AVX2
+static inline EData _vl_simd_or_e(__m256i v) VL_PURE {
+    return _vl_simd_or_e(_mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+static inline EData _vl_simd_xor_e(__m256i v) VL_PURE {
+    return _vl_simd_xor_e(
+        _mm_xor_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+#endif
+#ifdef VL_HAVE_AVX512F
+static inline EData _vl_simd_or_e(__m512i v) VL_PURE {
+    return _vl_simd_or_e(
+        _mm256_or_si256(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1)));
+}
+static inline EData _vl_simd_xor_e(__m512i v) VL_PURE {
+    return _vl_simd_xor_e(
+        _mm256_xor_si256(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1)));
+}
+#endif
+#ifdef VL_HAVE_NEON
+static inline EData _vl_simd_or_e(uint32x4_t v) VL_PURE {
+    const uint32x2_t h = vorr_u32(vget_low_u32(v), vget_high_u32(v));
+    return vget_lane_u32(h, 0) | vget_lane_u32(h, 1);
+}
+static inline EData _vl_simd_xor_e(uint32x4_t v) VL_PURE {
+    const uint32x2_t h = veor_u32(vget_low_u32(v), vget_high_u32(v));
+    return vget_lane_u32(h, 0) ^ vget_lane_u32(h, 1);
+}
+#endif
+
+// Internal: Return OR of all words of lwp ^ rwp, zero if equal
+static inline EData _vl_diff_w(int words, WDataInP const lwp, WDataInP const rwp) VL_PURE {
+    EData r = 0;
+    int i = 0;
+#ifdef VL_HAVE_AVX512F
+    if (words >= 16) {
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 16 <= words; i += 16) {
+            acc = _mm512_or_si512(
+                acc, _mm512_xor_si512(_mm512_loadu_si512(lwp + i), _mm512_loadu_si512(rwp + i)));
+        }
+        r |= _vl_simd_or_e(acc);
+    }
+#endif
+#ifdef VL_HAVE_AVX2
+    if (i + 8 <= words) {
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= words; i += 8) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rwp + i));
+            acc = _mm256_or_si256(acc, _mm256_xor_si256(a, b));
+        }
+        r |= _vl_simd_or_e(acc);
+    }
+#endif
+#if defined(VL_HAVE_SSE2)
+    if (i + 4 <= words) {
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 4 <= words; i += 4) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rwp + i));
+            acc = _mm_or_si128(acc, _mm_xor_si128(a, b));
+        }
+        r |= _vl_simd_or_e(acc);
+    }
+#elif defined(VL_HAVE_NEON)
+    if (i + 4 <= words) {
+        uint32x4_t acc = vdupq_n_u32(0);
+        for (; i + 4 <= words; i += 4) {
+            acc = vorrq_u32(acc, veorq_u32(vld1q_u32(lwp + i), vld1q_u32(rwp + i)));
+        }
+        r |= _vl_simd_or_e(acc);
+    }
+#endif
+    for (; i < words; ++i) r |= (lwp[i] ^ rwp[i]);
+    return r;
+}
+
+// Internal: Return XOR of all words
+static inline EData _vl_xorall_w(int words, WDataInP const lwp) VL_PURE {
+    EData r = 0;
+    int i = 0;
+#ifdef VL_HAVE_AVX512F
+    if (words >= 16) {
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 16 <= words; i += 16) acc = _mm512_xor_si512(acc, _mm512_loadu_si512(lwp + i));
+        r ^= _vl_simd_xor_e(acc);
+    }
+#endif
+#ifdef VL_HAVE_AVX2
+    if (i + 8 <= words) {
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= words; i += 8) {
+            acc = _mm256_xor_si256(
+                acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i)));
+        }
+        r ^= _vl_simd_xor_e(acc);
+    }
+#endif
+#if defined(VL_HAVE_SSE2)
+    if (i + 4 <= words) {
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 4 <= words; i += 4) {
+            acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i)));
+        }
+        r ^= _vl_simd_xor_e(acc);
+    }
+#elif defined(VL_HAVE_NEON)
+    if (i + 4 <= words) {
+        uint32x4_t acc = vdupq_n_u32(0);
+        for (; i + 4 <= words; i += 4) acc = veorq_u32(acc, vld1q_u32(lwp + i));
+        r ^= _vl_simd_xor_e(acc);
+    }
+#endif
+    for (; i < words; ++i) r ^= lwp[i];
+    return r;
+}
+
+// Internal: Return number of set bits in the words that fit whole vectors,
+// and set ir to the first word not counted
+static inline IData _vl_simd_countones_w(int words, WDataInP const lwp, int& ir) VL_PURE {
+    IData r = 0;
+    int i = 0;
+#if defined(VL_HAVE_AVX512F) && defined(__AVX512VPOPCNTDQ__)
+    if (words >= 16) {
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 16 <= words; i += 16) {
+            acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(lwp + i)));
+        }
+        r += static_cast<IData>(_mm512_reduce_add_epi64(acc));
+    }
+#endif
+#ifdef VL_HAVE_AVX2
+    if (i + 8 <= words) {
+        // Count each nibble with a table lookup, then sum the bytes
+        const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  //
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= words; i += 8) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i));
+            const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+            const __m256i hi = _mm256_shuffle_epi8(
+                table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+            acc = _mm256_add_epi64(
+                acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc),  //
+                                        _mm256_extracti128_si256(acc, 1));
+        r += static_cast<IData>(_mm_cvtsi128_si32(_mm_add_epi64(s, _mm_unpackhi_epi64(s, s))));
+    }
+#endif
+#if defined(VL_HAVE_SSE2)
+    if (i + 4 <= words) {
+        // Bit-parallel count within each byte, then sum the bytes
+        const __m128i m1 = _mm_set1_epi8(0x55);
+        const __m128i m2 = _mm_set1_epi8(0x33);
+        const __m128i m4 = _mm_set1_epi8(0x0f);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 4 <= words; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i));
+            v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), m1));
+            v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi16(v, 2), m2));
+            v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi16(v, 4)), m4);
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+        }
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+        r += static_cast<IData>(_mm_cvtsi128_si32(acc));
+    }
+#elif defined(VL_HAVE_NEON)
+    if (i + 4 <= words) {
+        uint64x2_t acc = vdupq_n_u64(0);
+        for (; i + 4 <= words; i += 4) {
+            const uint8x16_t c = vcntq_u8(vreinterpretq_u8_u32(vld1q_u32(lwp + i)));
+            acc = vpadalq_u32(acc, vpaddlq_u16(vpaddlq_u8(c)));
+        }
+        r += static_cast<IData>(vaddvq_u64(acc));
+    }
+#endif
+    ir = i;
+    return r;
+}
+
+// Internal: Apply a bitwise operator to whole vectors of words, return the
+// first word not done. T_Op provides the scalar and vector forms.
+template <typename T_Op>
+static inline int _vl_simd_bitwise_w(int words, WDataOutP owp, WDataInP const lwp,
+                                     WDataInP const rwp) VL_MT_SAFE {
+    int i = 0;
+#ifdef VL_HAVE_AVX512F
+    for (; i + 16 <= words; i += 16) {
+        _mm512_storeu_si512(owp + i,
+                            T_Op::op(_mm512_loadu_si512(lwp + i), _mm512_loadu_si512(rwp + i)));
+    }
+#endif
+#ifdef VL_HAVE_AVX2
+    for (; i + 8 <= words; i += 8) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rwp + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(owp + i), T_Op::op(a, b));
+    }
+#endif
+#if defined(VL_HAVE_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rwp + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(owp + i), T_Op::op(a, b));
+    }
+#elif defined(VL_HAVE_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u32(owp + i, T_Op::op(vld1q_u32(lwp + i), vld1q_u32(rwp + i)));
+    }
+#endif
+    return i;
+}
+
+// Internal: Set owp[i] = ~lwp[i] for whole vectors of words, return the
+// first word not done.
+static inline int _vl_simd_not_w(int words, WDataOutP owp, WDataInP const lwp) VL_MT_SAFE {
+    int i = 0;
+#ifdef VL_HAVE_AVX512F
+    for (; i + 16 <= words; i += 16) {
+        const __m512i a = _mm512_loadu_si512(lwp + i);
+        _mm512_storeu_si512(owp + i, _mm512_xor_si512(a, _mm512_set1_epi32(-1)));
+    }
+#endif
+#ifdef VL_HAVE_AVX2
+    for (; i + 8 <= words; i += 8) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(owp + i),
+                            _mm256_xor_si256(a, _mm256_set1_epi32(-1)));
+    }
+#endif
+#if defined(VL_HAVE_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(owp + i),
+                         _mm_xor_si128(a, _mm_set1_epi32(-1)));
+    }
+#elif defined(VL_HAVE_NEON)
+    for (; i + 4 <= words; i += 4) vst1q_u32(owp + i, vmvnq_u32(vld1q_u32(lwp + i)));
+#endif
+    return i;
+}
+
+// Internal: Set owp[i] = (hip[i] << lshift) | (lop[i] >> rshift) for whole
+// vectors of the n words, return the first word not done. Shifts are 1..31.
+static inline int _vl_simd_funnel_w(int n, WDataOutP owp, WDataInP const hip, WDataInP const lop,
+                                    int lshift, int rshift) VL_MT_SAFE {
+    int i = 0;
+#ifdef VL_HAVE_SSE2
+    const __m128i lcount = _mm_cvtsi32_si128(lshift);
+    const __m128i rcount = _mm_cvtsi32_si128(rshift);
+#endif
+#ifdef VL_HAVE_AVX512F
+    for (; i + 16 <= n; i += 16) {
+        const __m512i h = _mm512_sll_epi32(_mm512_loadu_si512(hip + i), lcount);
+        const __m512i l = _mm512_srl_epi32(_mm512_loadu_si512(lop + i), rcount);
+        _mm512_storeu_si512(owp + i, _mm512_or_si512(h, l));
+    }
+#endif
+#ifdef VL_HAVE_AVX2
+    for (; i + 8 <= n; i += 8) {
+        const __m256i h = _mm256_sll_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hip + i)), lcount);
+        const __m256i l = _mm256_srl_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lop + i)), rcount);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(owp + i), _mm256_or_si256(h, l));
+    }
+#endif
+#if defined(VL_HAVE_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        const __m128i h
+            = _mm_sll_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hip + i)), lcount);
+        const __m128i l
+            = _mm_srl_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lop + i)), rcount);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(owp + i), _mm_or_si128(h, l));
+    }
+#elif defined(VL_HAVE_NEON)
+    const int32x4_t lcount = vdupq_n_s32(lshift);
+    const int32x4_t rcount = vdupq_n_s32(-rshift);  // Negative shifts right
+    for (; i + 4 <= n; i += 4) {
+        const uint32x4_t h = vshlq_u32(vld1q_u32(hip + i), lcount);
+        const uint32x4_t l = vshlq_u32(vld1q_u32(lop + i), rcount);
+        vst1q_u32(owp + i, vorrq_u32(h, l));
+    }
+#endif
+    return i;
+}
+
+// Internal: Vector forms of the bitwise operators for _vl_simd_bitwise_w
+struct VlSimdAndOp final {
+#ifdef VL_HAVE_SSE2
+    static __m128i op(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+#endif
+#ifdef VL_HAVE_AVX2
+    static __m256i op(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+#ifdef VL_HAVE_AVX512F
+    static __m512i op(__m512i a, __m512i b) { return _mm512_and_si512(a, b); }
+#endif
+#ifdef VL_HAVE_NEON
+    static uint32x4_t op(uint32x4_t a, uint32x4_t b) { return vandq_u32(a, b); }
+#endif
+};
+struct VlSimdOrOp final {
+#ifdef VL_HAVE_SSE2
+    static __m128i op(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+#endif
+#ifdef VL_HAVE_AVX2
+    static __m256i op(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+#ifdef VL_HAVE_AVX512F
+    static __m512i op(__m512i a, __m512i b) { return _mm512_or_si512(a, b); }
+#endif
+#ifdef VL_HAVE_NEON
+    static uint32x4_t op(uint32x4_t a, uint32x4_t b) { return vorrq_u32(a, b); }
+#endif
+};
+struct VlSimdXorOp final {
+#ifdef VL_HAVE_SSE2
+    static __m128i op(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+#endif
+#ifdef VL_HAVE_AVX2
+    static __m256i op(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+#ifdef VL_HAVE_AVX512F
+    static __m512i op(__m512i a, __m512i b) { return _mm512_xor_si512(a, b); }
+#endif
+#ifdef VL_HAVE_NEON
+    static uint32x4_t op(uint32x4_t a, uint32x4_t b) { return veorq_u32(a, b); }
+#endif
+};
+
 //===================================================================
 // REDUCTION OPERATORS
 
@@ -672,9 +1038,7 @@ static inline IData VL_REDXOR_64(QData r) VL_PURE {
 #endif
 }
 static inline IData VL_REDXOR_W(int words, WDataInP const lwp) VL_PURE {
-    EData r = lwp[0];
-    for (int i = 1; i < words; ++i) r ^= lwp[i];
-    return VL_REDXOR_32(r);
+    return VL_REDXOR_32(_vl_xorall_w(words, lwp));
 }
 
 // EMIT_RULE: VL_COUNTONES_II:  oclean = false; lhs clean
@@ -691,8 +1055,9 @@ static inline IData VL_COUNTONES_Q(QData lhs) VL_PURE {
 }
 #define VL_COUNTONES_E VL_COUNTONES_I
 static inline IData VL_COUNTONES_W(int words, WDataInP const lwp) VL_PURE {
-    EData r = 0;
-    for (int i = 0; i < words; ++i) r += VL_COUNTONES_E(lwp[i]);
+    int i;
+    EData r = _vl_simd_countones_w(words, lwp, i /*ref*/);
+    for (; i < words; ++i) r += VL_COUNTONES_E(lwp[i]);
     return r;
 }
 
@@ -808,30 +1173,34 @@ static inline IData VL_MOSTSETBITP1_W(int words, WDataInP const lwp) VL_PURE {
 // EMIT_RULE: VL_AND:  oclean=lclean||rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_AND_W(int words, WDataOutP owp, WDataInP const lwp,
                                  WDataInP const rwp) VL_MT_SAFE {
-    for (int i = 0; (i < words); ++i) owp[i] = (lwp[i] & rwp[i]);
+    for (int i = _vl_simd_bitwise_w<VlSimdAndOp>(words, owp, lwp, rwp); i < words; ++i) {
+        owp[i] = (lwp[i] & rwp[i]);
+    }
     return owp;
 }
 // EMIT_RULE: VL_OR:   oclean=lclean&&rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_OR_W(int words, WDataOutP owp, WDataInP const lwp,
                                 WDataInP const rwp) VL_MT_SAFE {
-    for (int i = 0; (i < words); ++i) owp[i] = (lwp[i] | rwp[i]);
+    for (int i = _vl_simd_bitwise_w<VlSimdOrOp>(words, owp, lwp, rwp); i < words; ++i) {
+        owp[i] = (lwp[i] | rwp[i]);
+    }
     return owp;
 }
 // EMIT_RULE: VL_CHANGEXOR:  oclean=1; obits=32; lbits==rbits;
 static inline IData VL_CHANGEXOR_W(int words, WDataInP const lwp, WDataInP const rwp) VL_PURE {
-    IData od = 0;
-    for (int i = 0; (i < words); ++i) od |= (lwp[i] ^ rwp[i]);
-    return od;
+    return _vl_diff_w(words, lwp, rwp);
 }
 // EMIT_RULE: VL_XOR:  oclean=lclean&&rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_XOR_W(int words, WDataOutP owp, WDataInP const lwp,
                                  WDataInP const rwp) VL_MT_SAFE {
-    for (int i = 0; (i < words); ++i) owp[i] = (lwp[i] ^ rwp[i]);
+    for (int i = _vl_simd_bitwise_w<VlSimdXorOp>(words, owp, lwp, rwp); i < words; ++i) {
+        owp[i] = (lwp[i] ^ rwp[i]);
+    }
     return owp;
 }
 // EMIT_RULE: VL_NOT:  oclean=dirty; obits=lbits;
 static inline WDataOutP VL_NOT_W(int words, WDataOutP owp, WDataInP const lwp) VL_MT_SAFE {
-    for (int i = 0; i < words; ++i) owp[i] = ~(lwp[i]);
+    for (int i = _vl_simd_not_w(words, owp, lwp); i < words; ++i) owp[i] = ~(lwp[i]);
     return owp;
 }
 
@@ -852,9 +1221,7 @@ static inline WDataOutP VL_NOT_W(int words, WDataOutP owp, WDataInP const lwp) V
 
 // Output clean, <lhs> AND <rhs> MUST BE CLEAN
 static inline IData VL_EQ_W(int words, WDataInP const lwp, WDataInP const rwp) VL_PURE {
-    EData nequal = 0;
-    for (int i = 0; (i < words); ++i) nequal |= (lwp[i] ^ rwp[i]);
-    return (nequal == 0);
+    return (_vl_diff_w(words, lwp, rwp) == 0);
 }
 
 // Internal usage
@@ -997,19 +1364,47 @@ static inline WDataOutP VL_SUB_W(int words, WDataOutP owp, WDataInP const lwp,
     return owp;
 }
 
+// Output words are summed a column at a time, so each partial product is
+// added once, rather than carrying each through all the upper words.
+// Owp must not overlap the inputs.
 static inline WDataOutP VL_MUL_W(int words, WDataOutP owp, WDataInP const lwp,
                                  WDataInP const rwp) VL_MT_SAFE {
-    for (int i = 0; i < words; ++i) owp[i] = 0;
-    for (int lword = 0; lword < words; ++lword) {
-        for (int rword = 0; rword < words; ++rword) {
-            QData mul = static_cast<QData>(lwp[lword]) * static_cast<QData>(rwp[rword]);
-            for (int qword = lword + rword; qword < words; ++qword) {
-                mul += static_cast<QData>(owp[qword]);
-                owp[qword] = (mul & 0xffffffffULL);
-                mul = (mul >> 32ULL) & 0xffffffffULL;
-            }
+#ifdef VL_HAVE_INT128
+    // Columns of 64-bit limbs (word pairs); column sum is acc plus accHi << 128
+    const int pairs = words / 2;
+    VlUint128 acc = 0;
+    QData accHi = 0;
+    for (int k = 0; k < pairs; ++k) {
+        for (int i = 0; i <= k; ++i) {
+            const VlUint128 p = static_cast<VlUint128>(VL_SET_QW(lwp + 2 * i))
+                                * VL_SET_QW(rwp + 2 * (k - i));
+            acc += p;
+            accHi += (acc < p);
+        }
+        VL_SET_WQ(owp + 2 * k, static_cast<QData>(acc));
+        acc = (acc >> 64) | (static_cast<VlUint128>(accHi) << 64);
+        accHi = 0;
+    }
+    if (words & 1) {  // Odd top word only needs the low word of each limb product
+        EData sum = static_cast<EData>(acc);
+        for (int i = 0; i <= pairs; ++i) sum += lwp[2 * i] * rwp[2 * (pairs - i)];
+        owp[words - 1] = sum;
+    }
+#else
+    // Columns of words; column sum is acc plus accHi << 64
+    QData acc = 0;
+    EData accHi = 0;
+    for (int k = 0; k < words; ++k) {
+        for (int i = 0; i <= k; ++i) {
+            const QData p = static_cast<QData>(lwp[i]) * static_cast<QData>(rwp[k - i]);
+            acc += p;
+            accHi += (acc < p);
         }
+        owp[k] = static_cast<EData>(acc);
+        acc = (acc >> 32ULL) | (static_cast<QData>(accHi) << 32ULL);
+        accHi = 0;
     }
+#endif
     // Last output word is dirty
     return owp;
 }
@@ -1482,6 +1877,27 @@ static inline QData VL_STREAML_FAST_QQI(int lbits, QData ld, IData rd_log2) VL_P
     return ret >> (VL_QUADSIZE - lbits);
 }
 
+// Special version for 8-bit slices of a whole 16, 32 or 64-bit value, i.e.: byte swap.
+static inline IData VL_STREAML_BSWAP_II(int lbits, IData ld) VL_PURE {
+#if defined(__GNUC__)
+    if (lbits == 16) return __builtin_bswap16(static_cast<uint16_t>(ld));
+    return __builtin_bswap32(ld);
+#else
+    const IData ret
+        = (ld >> 24) | ((ld >> 8) & 0x0000ff00U) | ((ld << 8) & 0x00ff0000U) | (ld << 24);
+    return lbits == 16 ? ret >> 16 : ret;
+#endif
+}
+
+static inline QData VL_STREAML_BSWAP_QQ(int, QData ld) VL_PURE {
+#if defined(__GNUC__)
+    return __builtin_bswap64(ld);
+#else
+    return (static_cast<QData>(VL_STREAML_BSWAP_II(32, static_cast<IData>(ld))) << 32)
+           | VL_STREAML_BSWAP_II(32, static_cast<IData>(ld >> 32));
+#endif
+}
+
 // Regular "slow" streaming operators
 static inline IData VL_STREAML_III(int lbits, IData ld, IData rd) VL_PURE {
     IData ret = 0;
@@ -1635,8 +2051,17 @@ static inline WDataOutP VL_SHIFTL_WWI(int obits, int, int, WDataOutP owp, WDataI
         for (int i = 0; i < word_shift; ++i) owp[i] = 0;
         for (int i = word_shift; i < VL_WORDS_I(obits); ++i) owp[i] = lwp[i - word_shift];
     } else {
-        for (int i = 0; i < VL_WORDS_I(obits); ++i) owp[i] = 0;
-        _vl_insert_WW(owp, lwp, obits - 1, rd);
+        const int nbitsonleft = VL_EDATASIZE - bit_shift;
+        for (int i = 0; i < word_shift; ++i) owp[i] = 0;
+        owp[word_shift] = lwp[0] << bit_shift;
+        // Remaining words each take bits from two input words
+        WDataOutP const uwp = owp + word_shift + 1;
+        const int words = VL_WORDS_I(obits) - word_shift - 1;
+        for (int i = _vl_simd_funnel_w(words, uwp, lwp + 1, lwp, bit_shift, nbitsonleft);
+             i < words; ++i) {
+            uwp[i] = (lwp[i + 1] << bit_shift) | (lwp[i] >> nbitsonleft);
+        }
+        owp[VL_WORDS_I(obits) - 1] &= VL_MASK_E(obits);
     }
     return owp;
 }
@@ -1701,7 +2126,11 @@ static inline WDataOutP VL_SHIFTR_WWI(int obits, int, int, WDataOutP owp, WDataI
         const int nbitsonright = VL_EDATASIZE - loffset;  // bits that end up in lword (know
                                                           // loffset!=0) Middle words
         const int words = VL_WORDS_I(obits - rd);
-        for (int i = 0; i < words; ++i) {
+        // Words that have an upper word can be done as vectors
+        const int upperWords = VL_WORDS_I(obits) - word_shift - 1;
+        int i = _vl_simd_funnel_w(words < upperWords ? words : upperWords, owp,
+                                  lwp + word_shift + 1, lwp + word_shift, nbitsonright, loffset);
+        for (; i < words; ++i) {
             owp[i] = lwp[i + word_shift] >> loffset;
             const int upperword = i + word_shift + 1;
             if (upperword < VL_WORDS_I(obits)) owp[i] |= lwp[upperword] << nbitsonright;
@@ -1793,7 +2222,11 @@ static inline WDataOutP VL_SHIFTRS_WWI(int obits, int lbits, int, WDataOutP owp,
             = VL_EDATASIZE - loffset;  // bits that end up in lword (know loffset!=0)
         // Middle words
         const int words = VL_WORDS_I(obits - rd);
-        for (int i = 0; i < words; ++i) {
+        // Words that have an upper word can be done as vectors
+        const int upperWords = VL_WORDS_I(obits) - word_shift - 1;
+        int i = _vl_simd_funnel_w(words < upperWords ? words : upperWords, owp,
+                                  lwp + word_shift + 1, lwp + word_shift, nbitsonright, loffset);
+        for (; i < words; ++i) {
             owp[i] = lwp[i + word_shift] >> loffset;
             const int upperword = i + word_shift + 1;
             if (upperword < VL_WORDS_I(obits)) owp[i] |= lwp[upperword] << nbitsonright;
@@ -2235,6 +2668,40 @@ extern void VL_READMEM_N(bool hex, int bits, QData depth, int array_lsb,
 extern void VL_WRITEMEM_N(bool hex, int bits, QData depth, int array_lsb,
                           const std::string& filename, const void* memp, QData start,
                           QData end) VL_MT_SAFE;
+template <class T_Value, std::size_t T_Depth>
+void VL_READMEM_N(bool hex, int bits, QData depth, int array_lsb, const std::string& filename,
+                  VlSparseArray<T_Value, T_Depth>& obj, QData start, QData end) VL_MT_SAFE {
+    // As the dense VL_READMEM_N, but pages are allocated only for addresses in the file
+    if (start < static_cast<QData>(array_lsb)) start = array_lsb;
+    VlReadMem rmem{hex, bits, filename, start, end};
+    if (VL_UNLIKELY(!rmem.isOpen())) return;
+    while (true) {
+        QData addr = 0;
+        std::string value;
+        if (!rmem.get(addr /*ref*/, value /*ref*/)) break;
+        if (VL_UNLIKELY(addr < static_cast<QData>(array_lsb)
+                        || addr >= static_cast<QData>(array_lsb + depth))) {
+            VL_FATAL_MT(filename.c_str(), rmem.linenum(), "",
+                        "$readmem file address beyond bounds of array");
+        } else {
+            rmem.setData(&obj[addr - array_lsb], value);
+        }
+    }
+}
+template <class T_Value, std::size_t T_Depth>
+void VL_WRITEMEM_N(bool hex, int bits, QData depth, int array_lsb, const std::string& filename,
+                   const VlSparseArray<T_Value, T_Depth>& obj, QData start,
+                   QData end) VL_MT_SAFE {
+    // As the dense VL_WRITEMEM_N, elements never written are written as zero
+    const QData addr_max = array_lsb + depth - 1;
+    if (start < static_cast<QData>(array_lsb)) start = array_lsb;
+    if (end > addr_max) end = addr_max;
+    VlWriteMem wmem{hex, bits, filename, start, end};
+    if (VL_UNLIKELY(!wmem.isOpen())) return;
+    for (QData addr = start; addr <= end; ++addr) {
+        wmem.print(addr, false, &obj[addr - array_lsb]);
+    }
+}
 extern IData VL_SSCANF_INX(int lbits, const std::string& ld, const char* formatp, ...) VL_MT_SAFE;
 extern void VL_SFORMAT_X(int obits_ignored, std::string& output, const char* formatp,
                          ...) VL_MT_SAFE;
@@ -33,6 +33,8 @@
 #include "verilated_syms.h"
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <deque>
 #include <limits>
 #include <map>
@@ -193,6 +195,55 @@ public:
     }
 };
 
+//======================================================================
+// VerilatedIoThread
+// Background thread doing the file writes of $display and $fwrite, see
+// VerilatedContext::ioThread. Writes are passed in a bounded ring, which the
+// producer fills lock free. As all files share one queue, the order of writes
+// to each file is kept. The producer only blocks when the ring is full, or
+// when waiting for the writes to be done, see drain().
+
+class VerilatedIoThread final {
+    // Number of writes that may be queued before the producer waits
+    static constexpr size_t QUEUE_SIZE = 1024;
+    // Number of times to retry before blocking
+    static constexpr unsigned SPINS = 1024;
+
+    struct Item final {
+        FILE* m_fp = nullptr;  // File to write
+        std::string m_text;  // Text to write, capacity is reused by later writes
+    };
+
+    // Both counters only ever increase, index m_items modulo QUEUE_SIZE
+    std::atomic<size_t> m_head{0};  // Next to write, by writer
+    std::atomic<size_t> m_tail{0};  // Next to put, by producer
+    std::atomic<unsigned> m_waiters{0};  // Threads blocked on m_cv
+    std::atomic<bool> m_shutdown{false};  // Writer should exit once queue is empty
+    VerilatedMutex m_mutex;  // Only used for blocking
+    std::condition_variable_any m_cv;
+    Item m_items[QUEUE_SIZE];
+    std::thread m_thread;  // The writer thread
+
+public:
+    // CONSTRUCTORS
+    VerilatedIoThread();
+    ~VerilatedIoThread();
+
+private:
+    VL_UNCOPYABLE(VerilatedIoThread);
+    // METHODS
+    void notify() VL_MT_SAFE_EXCLUDES(m_mutex);
+    template <typename T_Func>
+    void waitUntil(T_Func condf) VL_MT_SAFE_EXCLUDES(m_mutex);
+    void worker() VL_MT_SAFE;
+
+public:
+    // Queue a write of the given data. Calls must be serialized by the caller.
+    void write(FILE* fp, const char* datap, size_t size) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Wait until all queued writes have been passed to the files
+    void drain() VL_MT_SAFE_EXCLUDES(m_mutex);
+};
+
 //======================================================================
 // VerilatedContextImpData
 
@@ -207,6 +258,17 @@ protected:
     // Used by scopeInsert, scopeFind, scopeErase, scopeNameMap
     mutable VerilatedMutex m_nameMutex;  // Protect m_nameMap
     VerilatedScopeNameMap m_nameMap VL_GUARDED_BY(m_nameMutex);
+    // Scopes inserted but not yet in m_nameMap, which is only built when first used, as
+    // constructing models with very many scopes would otherwise spend much time building it
+    std::vector<const VerilatedScope*> m_namePending VL_GUARDED_BY(m_nameMutex);
+    uint64_t m_nameGeneration VL_GUARDED_BY(m_nameMutex) = 0;  // Count of m_nameMap changes
+
+    // File writer thread when VerilatedContext::ioThread is on, protected by m_fdMutex
+    std::unique_ptr<VerilatedIoThread> m_ioThreadp;
+
+    // METHODS
+    // Move m_namePending into m_nameMap
+    void nameMapUpdate() VL_REQUIRES(m_nameMutex);
 };
 
 //======================================================================
@@ -269,6 +331,8 @@ public:  // But only for verilated*.cpp
     // METHODS - scope name - INTERNAL only for verilated*.cpp
     void scopeInsert(const VerilatedScope* scopep) VL_MT_SAFE;
     void scopeErase(const VerilatedScope* scopep) VL_MT_SAFE;
+    // Changes when scopes are inserted or erased, for caches of scopeNameMap
+    uint64_t scopeNameGeneration() const VL_MT_SAFE;
 
     // METHODS - file IO - INTERNAL only for verilated*.cpp
 
@@ -304,11 +368,13 @@ public:  // But only for verilated*.cpp
     }
     void fdFlush(IData fdi) VL_MT_SAFE_EXCLUDES(m_fdMutex) {
         const VerilatedLockGuard lock{m_fdMutex};
+        ioThreadDrain();
         const VerilatedFpList fdlist = fdToFpList(fdi);
         for (const auto& i : fdlist) std::fflush(i);
     }
     IData fdSeek(IData fdi, IData offset, IData origin) VL_MT_SAFE_EXCLUDES(m_fdMutex) {
         const VerilatedLockGuard lock{m_fdMutex};
+        ioThreadDrain();
         const VerilatedFpList fdlist = fdToFpList(fdi);
         if (VL_UNLIKELY(fdlist.size() != 1)) return ~0U;  // -1
         return static_cast<IData>(
@@ -316,6 +382,7 @@ public:  // But only for verilated*.cpp
     }
     IData fdTell(IData fdi) VL_MT_SAFE_EXCLUDES(m_fdMutex) {
         const VerilatedLockGuard lock{m_fdMutex};
+        ioThreadDrain();
         const VerilatedFpList fdlist = fdToFpList(fdi);
         if (VL_UNLIKELY(fdlist.size() != 1)) return ~0U;  // -1
         return static_cast<IData>(std::ftell(*fdlist.begin()));
@@ -325,11 +392,26 @@ public:  // But only for verilated*.cpp
         const VerilatedFpList fdlist = fdToFpList(fdi);
         for (const auto& i : fdlist) {
             if (VL_UNLIKELY(!i)) continue;
-            (void)fwrite(output.c_str(), 1, output.size(), i);
+            fpWrite(i, output.c_str(), output.size());
         }
     }
+    // Write $display text to stdout through the I/O thread
+    void stdoutWrite(const char* strp) VL_MT_SAFE_EXCLUDES(m_fdMutex) {
+        const VerilatedLockGuard lock{m_fdMutex};
+        fpWrite(stdout, strp, std::strlen(strp));
+    }
+    // Wait for writes queued on the I/O thread
+    void fdDrain() VL_MT_SAFE_EXCLUDES(m_fdMutex) {
+        const VerilatedLockGuard lock{m_fdMutex};
+        ioThreadDrain();
+    }
+    // Verilated::addFlushCb callback when the I/O thread is on
+    static void fdDrainCb(void* datap) VL_MT_SAFE {
+        static_cast<VerilatedContext*>(datap)->impp()->fdDrain();
+    }
     void fdClose(IData fdi) VL_MT_SAFE_EXCLUDES(m_fdMutex) {
         const VerilatedLockGuard lock{m_fdMutex};
+        ioThreadDrain();
         if (VL_BITISSET_I(fdi, 31)) {
             // Non-MCD case
             const IData idx = VL_MASK_I(31) & fdi;
@@ -354,12 +436,23 @@ public:  // But only for verilated*.cpp
     }
     FILE* fdToFp(IData fdi) VL_MT_SAFE_EXCLUDES(m_fdMutex) {
         const VerilatedLockGuard lock{m_fdMutex};
+        ioThreadDrain();  // Caller may read back what was written
         const VerilatedFpList fdlist = fdToFpList(fdi);
         if (VL_UNLIKELY(fdlist.size() != 1)) return nullptr;
         return *fdlist.begin();
     }
 
 private:
+    void fpWrite(FILE* fp, const char* datap, size_t size) VL_REQUIRES(m_fdMutex) {
+        if (VerilatedIoThread* const threadp = m_impdatap->m_ioThreadp.get()) {
+            threadp->write(fp, datap, size);
+        } else {
+            (void)std::fwrite(datap, 1, size, fp);
+        }
+    }
+    void ioThreadDrain() VL_REQUIRES(m_fdMutex) {
+        if (VerilatedIoThread* const threadp = m_impdatap->m_ioThreadp.get()) threadp->drain();
+    }
     VerilatedFpList fdToFpList(IData fdi) VL_REQUIRES(m_fdMutex) {
         VerilatedFpList fp;
         // cppverilator-suppress integerOverflow shiftTooManyBitsSigned
@@ -412,13 +505,21 @@ protected:
     // TYPES
     using UserMap = std::map<std::pair<const void*, void*>, void*>;
     using ExportNameMap = std::map<const char*, int, VerilatedCStrCmp>;
+    // Part of the user data, each scope's data is all in one shard
+    struct UserMapShard final {
+        alignas(VL_CACHE_LINE_BYTES) VerilatedMutex m_mutex;  // Protect m_map
+        UserMap m_map VL_GUARDED_BY(m_mutex);  // Map of <(scope,userkey), userData>
+    };
+
+    // CONSTANTS
+    static constexpr size_t USER_MAP_SHARDS = 64;  // Number of user data shards, power of 2
 
     // MEMBERS
     // Nothing below here is save-restored; users expected to re-register appropriately
 
-    VerilatedMutex m_userMapMutex;  // Protect m_userMap
     // For userInsert, userFind.  As indexed by pointer is common across contexts.
-    UserMap m_userMap VL_GUARDED_BY(m_userMapMutex);  // Map of <(scope,userkey), userData>
+    // Sharded by scope, so models on different threads rarely contend for a lock.
+    std::array<UserMapShard, USER_MAP_SHARDS> m_userMapShards;
 
     VerilatedMutex m_hierMapMutex;  // Protect m_hierMap
     // Map that represents scope hierarchy
@@ -461,23 +562,30 @@ public:
     static void versionDump() VL_MT_SAFE;
 
     // METHODS - user scope tracking
-    // We implement this as a single large map instead of one map per scope.
+    // We implement this as a few large maps instead of one map per scope.
     // There's often many more scopes than userdata's and thus having a ~48byte
     // per map overhead * N scopes would take much more space and cache thrashing.
     // As scopep's are pointers, this implicitly handles multiple Context's
+    static VerilatedImpData::UserMapShard& userShard(const void* scopep) VL_MT_SAFE {
+        // Scopes are allocated at least pointer aligned, so skip the low bits
+        const uintptr_t bits = reinterpret_cast<uintptr_t>(scopep) >> 4;
+        return s().m_userMapShards[(bits ^ (bits >> 8)) & (VerilatedImpData::USER_MAP_SHARDS - 1)];
+    }
     static void userInsert(const void* scopep, void* userKey, void* userData) VL_MT_SAFE {
-        const VerilatedLockGuard lock{s().m_userMapMutex};
-        const auto it = s().m_userMap.find(std::make_pair(scopep, userKey));
-        if (it != s().m_userMap.end()) {
+        VerilatedImpData::UserMapShard& shard = userShard(scopep);
+        const VerilatedLockGuard lock{shard.m_mutex};
+        const auto it = shard.m_map.find(std::make_pair(scopep, userKey));
+        if (it != shard.m_map.end()) {
             it->second = userData;
         } else {
-            s().m_userMap.emplace(std::make_pair(scopep, userKey), userData);
+            shard.m_map.emplace(std::make_pair(scopep, userKey), userData);
         }
     }
     static void* userFind(const void* scopep, void* userKey) VL_MT_SAFE {
-        const VerilatedLockGuard lock{s().m_userMapMutex};
-        const auto& it = vlstd::as_const(s().m_userMap).find(std::make_pair(scopep, userKey));
-        if (VL_UNLIKELY(it == s().m_userMap.end())) return nullptr;
+        VerilatedImpData::UserMapShard& shard = userShard(scopep);
+        const VerilatedLockGuard lock{shard.m_mutex};
+        const auto& it = vlstd::as_const(shard.m_map).find(std::make_pair(scopep, userKey));
+        if (VL_UNLIKELY(it == shard.m_map.end())) return nullptr;
         return it->second;
     }
 
@@ -485,26 +593,28 @@ public:
 
     // Symbol table destruction cleans up the entries for each scope.
     static void userEraseScope(const VerilatedScope* scopep) VL_MT_SAFE {
-        // Slow ok - called once/scope on destruction, so we only iterate.
-        const VerilatedLockGuard lock{s().m_userMapMutex};
-        for (auto it = s().m_userMap.begin(); it != s().m_userMap.end();) {
-            if (it->first.first == scopep) {
-                s().m_userMap.erase(it++);
-            } else {
-                ++it;
-            }
-        }
+        // Slow ok - called once/scope on destruction
+        VerilatedImpData::UserMapShard& shard = userShard(scopep);
+        const VerilatedLockGuard lock{shard.m_mutex};
+        // Keys are ordered by scope first, so the scope's entries are contiguous
+        const void* const voidScopep = scopep;
+        const auto beginIt = shard.m_map.lower_bound(std::make_pair(voidScopep, nullptr));
+        auto endIt = beginIt;
+        while (endIt != shard.m_map.end() && endIt->first.first == scopep) ++endIt;
+        shard.m_map.erase(beginIt, endIt);
     }
     static void userDump() VL_MT_SAFE {
-        const VerilatedLockGuard lock{s().m_userMapMutex};  // Avoid it changing in middle of dump
         bool first = true;
-        for (const auto& i : s().m_userMap) {
-            if (first) {
-                VL_PRINTF_MT("  userDump:\n");
-                first = false;
+        for (VerilatedImpData::UserMapShard& shard : s().m_userMapShards) {
+            const VerilatedLockGuard lock{shard.m_mutex};  // Avoid it changing in middle of dump
+            for (const auto& i : shard.m_map) {
+                if (first) {
+                    VL_PRINTF_MT("  userDump:\n");
+                    first = false;
+                }
+                VL_PRINTF_MT("    DPI_USER_DATA scope %p key %p: %p\n", i.first.first,
+                             i.first.second, i.second);
             }
-            VL_PRINTF_MT("    DPI_USER_DATA scope %p key %p: %p\n", i.first.first, i.first.second,
-                         i.second);
         }
     }
 
@@ -521,8 +631,9 @@ public:
         VerilatedHierarchyMap& map = s().m_hierMap;
         if (map.find(fromp) == map.end()) return;
         auto& scopes = map[fromp];
-        const auto it = find(scopes.begin(), scopes.end(), top);
-        if (it != scopes.end()) scopes.erase(it);
+        // Removed in reverse order of adding, so search from the end
+        const auto it = std::find(scopes.rbegin(), scopes.rend(), top);
+        if (it != scopes.rend()) scopes.erase(std::next(it).base());
     }
     static const VerilatedHierarchyMap* hierarchyMap() VL_MT_SAFE_POSTINIT {
         // Thread save only assuming this is called only after model construction completed
@@ -38,8 +38,46 @@
 #  define VL_HAVE_AVX2 1
 #  include <immintrin.h>
 # endif
+# if defined(__AVX512F__) && defined(VL_HAVE_AVX2) && !defined(VL_DISABLE_AVX512)
+#  define VL_HAVE_AVX512F 1
+# endif
+# if defined(__ARM_NEON) && defined(__aarch64__) && !defined(VL_DISABLE_NEON)
+#  define VL_HAVE_NEON 1
+#  include <arm_neon.h>
+# endif
+# if defined(__SIZEOF_INT128__) && !defined(VL_DISABLE_INT128)
+#  define VL_HAVE_INT128 1
+# endif
+#endif
+
+// Runtime library kernels that benefit from AVX2 may also be built with
+// the target attribute, and selected at run time when the CPU supports it,
+// so a model compiled for a baseline x86-64 still uses AVX2 where available.
+#if defined(VL_HAVE_AVX2)
+# define VL_ATTR_TARGET_AVX2
+#elif defined(VL_HAVE_SSE2) && !defined(VL_DISABLE_AVX2) && !defined(VL_DISABLE_CPU_DISPATCH) \
+    && defined(__GNUC__) && defined(__x86_64__)
+# define VL_HAVE_AVX2_DISPATCH 1
+# define VL_ATTR_TARGET_AVX2 __attribute__((target("avx2")))
+# include <immintrin.h>
 #endif
 
 // clang-format on
 
+#ifdef VL_HAVE_INT128
+// 128-bit product of two 64-bit words; __extension__ as not ISO C++
+__extension__ typedef unsigned __int128 VlUint128;
+#endif
+
+#ifdef VL_HAVE_AVX2_DISPATCH
+// True if the executing CPU supports AVX2; checked once per process
+static inline bool vlCpuHasAvx2() {
+    static const bool s_hasAvx2 = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return s_hasAvx2;
+}
+#endif
+
 #endif  // Guard
@@ -22,15 +22,38 @@
 
 #include "verilated_threads.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <map>
 #include <string>
 
+// clang-format off
+#if defined(__linux)
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+#if defined(__linux) && (defined(__x86_64__) || defined(__aarch64__))
+# define VL_SAMPLE_PROFILER 1
+# include <cxxabi.h>
+# include <dlfcn.h>
+# include <signal.h>
+# include <sys/time.h>
+# include <ucontext.h>
+#endif
+// clang-format on
+
 //=============================================================================
 // Globals
 
 // Internal note: Globals may multi-construct, see verilated.cpp top.
 
 thread_local VlExecutionProfiler::ExecutionTrace VlExecutionProfiler::t_trace;
+thread_local uint32_t VlExecutionProfiler::t_threadId = 0;
+thread_local VlExecutionProfiler::ThreadCounters VlExecutionProfiler::t_counters;
 
 constexpr const char* const VlExecutionRecord::s_ascii[];
 
@@ -57,47 +80,141 @@ uint16_t VlExecutionRecord::getcpu() {
 }
 
 //=============================================================================
-// VlExecutionProfiler implementation
+// Hardware performance counters
+
+#if defined(__linux)
+static const struct {
+    const char* m_namep;  // Name in +verilator+prof+exec+counters
+    uint64_t m_config;  // perf_event_attr config of PERF_TYPE_HARDWARE counter
+} s_counterTypes[] = {
+    {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache-references", PERF_COUNT_HW_CACHE_REFERENCES},
+    {"llc-misses", PERF_COUNT_HW_CACHE_MISSES},
+    {"branches", PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch-misses", PERF_COUNT_HW_BRANCH_MISSES},
+};
+#endif
 
-template <size_t N>
-static size_t roundUptoMultipleOf(size_t value) {
-    static_assert((N & (N - 1)) == 0, "'N' must be a power of 2");
-    size_t mask = N - 1;
-    return (value + mask) & ~mask;
+VlExecutionProfiler::ThreadCounters::~ThreadCounters() {
+#if defined(__linux)
+    for (const auto& pair : m_fds) close(pair.second);
+#endif
 }
 
+void VlExecutionProfiler::openCounters() {
+    t_counters.m_opened = true;
+#if defined(__linux)
+    for (const char* const namep : m_counterNames) {
+        for (const auto& type : s_counterTypes) {
+            if (std::strcmp(type.m_namep, namep)) continue;
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = type.m_config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // Count the calling thread, on any CPU
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd < 0) {
+                VL_PRINTF_MT("%%Warning: +verilator+prof+exec+counters: cannot open counter '%s'"
+                             " (perf_event_open: %s)\n",
+                             namep, std::strerror(errno));
+            } else {
+                t_counters.m_fds.emplace_back(type.m_namep, fd);
+            }
+        }
+    }
+#endif
+}
+
+uint64_t VlExecutionProfiler::readCounter(int fd) {
+    uint64_t value = 0;
+#if defined(__linux)
+    if (VL_UNLIKELY(read(fd, &value, sizeof(value)) != sizeof(value))) value = 0;
+#endif
+    return value;
+}
+
+//=============================================================================
+// VlExecutionProfiler implementation
+
 VlExecutionProfiler::VlExecutionProfiler(VerilatedContext& context)
     : m_context{context} {
     // Setup profiling on main thread
     setupThread(0);
 }
 
-void VlExecutionProfiler::configure() {
+VlExecutionProfiler::~VlExecutionProfiler() {
+    // Complete the profile of a window still open at the end of simulation
+    if (m_collecting) stop();
+}
 
-    if (VL_UNLIKELY(m_enabled)) {
+void VlExecutionProfiler::configure() {
+    if (VL_UNLIKELY(m_context.profExecCollect() != m_manual)) {
+        // Window requested through the context API, replacing any +prof+exec+start window
+        m_manual = !m_manual;
+        if (m_collecting) stop();
+        m_warming = false;
+        m_windowCount = 0;
+        if (m_manual) {
+            VL_DEBUG_IF(VL_DBG_MSGF("+ profile start collection\n"););
+            m_lastStartReq = m_context.profExecStart() + 1;
+            start();
+        } else {
+            VL_DEBUG_IF(VL_DBG_MSGF("+ profile end\n"););
+        }
+    } else if (VL_UNLIKELY(m_windowCount)) {
         --m_windowCount;
         if (VL_UNLIKELY(m_windowCount == m_context.profExecWindow())) {
             VL_DEBUG_IF(VL_DBG_MSGF("+ profile start collection\n"););
-            clear();  // Clear the profile after the cache warm-up cycles.
-            m_tickBegin = VL_CPU_TICK();
+            m_warming = false;
+            start();  // Dropping the profile of the cache warm-up cycles.
         } else if (VL_UNLIKELY(m_windowCount == 0)) {
-            const uint64_t tickEnd = VL_CPU_TICK();
             VL_DEBUG_IF(VL_DBG_MSGF("+ profile end\n"););
-            const std::string& fileName = m_context.profExecFilename();
-            dump(fileName.c_str(), tickEnd);
-            m_enabled = false;
+            stop();
+        }
+    } else if (!m_manual) {
+        // + 1, so we can start at time 0
+        const uint64_t startReq = m_context.profExecStart() + 1;
+        if (VL_UNLIKELY(m_lastStartReq < startReq
+                        && VL_TIME_Q() >= m_context.profExecStart())) {
+            VL_DEBUG_IF(VL_DBG_MSGF("+ profile start warmup\n"););
+            m_warming = true;
+            m_evalCount = 0;
+            m_windowCount = m_context.profExecWindow() * 2;
+            m_lastStartReq = startReq;
+            if (m_counterNames.empty()) parseCounters();
         }
-        return;
     }
 
-    const uint64_t startReq = m_context.profExecStart() + 1;  // + 1, so we can start at time 0
+    // Only record every +prof+exec+sample'th eval
+    m_enabled = (m_warming || m_collecting)
+                && (m_evalCount++ % m_context.profExecSample() == 0);
+}
 
-    if (VL_UNLIKELY(m_lastStartReq < startReq && VL_TIME_Q() >= m_context.profExecStart())) {
-        VL_DEBUG_IF(VL_DBG_MSGF("+ profile start warmup\n"););
-        VL_DEBUG_IF(assert(m_windowCount == 0););
-        m_enabled = true;
-        m_windowCount = m_context.profExecWindow() * 2;
-        m_lastStartReq = startReq;
+void VlExecutionProfiler::parseCounters() {
+    const std::string counters = m_context.profExecCounters();
+    std::string::size_type pos = 0;
+    while (pos < counters.size()) {
+        std::string::size_type end = counters.find(',', pos);
+        if (end == std::string::npos) end = counters.size();
+        const std::string name = counters.substr(pos, end - pos);
+        pos = end + 1;
+        if (name.empty()) continue;
+        const char* namep = nullptr;
+#if defined(__linux)
+        for (const auto& type : s_counterTypes) {
+            if (name == type.m_namep) namep = type.m_namep;
+        }
+#endif
+        if (namep) {
+            m_counterNames.push_back(namep);
+        } else {
+            VL_PRINTF_MT("%%Warning: +verilator+prof+exec+counters: unsupported counter '%s'\n",
+                         name.c_str());
+        }
     }
 }
 
@@ -127,9 +244,10 @@ VerilatedVirtualBase* VlExecutionProfiler::construct(VerilatedContext& context)
 }
 
 void VlExecutionProfiler::setupThread(uint32_t threadId) {
-    // Reserve some space in the thread-local profiling buffer, in order to try to avoid malloc
-    // while profiling.
-    t_trace.reserve(RESERVED_TRACE_CAPACITY);
+    // Reserve space in the thread-local profiling buffer, in order to avoid malloc while
+    // profiling.
+    t_trace.reserve(TRACE_BUFFER_RECORDS);
+    t_threadId = threadId;
     // Register thread-local buffer in list of all buffers
     bool exists;
     {
@@ -143,32 +261,129 @@ void VlExecutionProfiler::setupThread(uint32_t threadId) {
 
 void VlExecutionProfiler::clear() VL_MT_SAFE_EXCLUDES(m_mutex) {
     const VerilatedLockGuard lock{m_mutex};
-    for (const auto& pair : m_traceps) {
-        ExecutionTrace* const tracep = pair.second;
-        const size_t reserve = roundUptoMultipleOf<RESERVED_TRACE_CAPACITY>(tracep->size());
-        tracep->clear();
-        tracep->reserve(reserve);
+    for (const auto& pair : m_traceps) pair.second->clear();
+}
+
+void VlExecutionProfiler::flushTrace() {
+    if (m_collecting) {
+        queueTrace(t_threadId, t_trace);
+    } else {
+        t_trace.clear();  // Warm-up records are dropped anyway
     }
 }
 
-void VlExecutionProfiler::dump(const char* filenamep, uint64_t tickEnd)
-    VL_MT_SAFE_EXCLUDES(m_mutex) {
-    const VerilatedLockGuard lock{m_mutex};
-    VL_DEBUG_IF(VL_DBG_MSGF("+prof+exec writing to '%s'\n", filenamep););
+void VlExecutionProfiler::queueTrace(uint32_t threadId, ExecutionTrace& trace)
+    VL_MT_SAFE_EXCLUDES(m_writeMutex) {
+    ExecutionTrace spare;
+    {
+        VerilatedLockGuard lock{m_writeMutex};
+        // Wait for the writer if it fell behind, rather than growing without bound
+        while (m_pending.size() >= MAX_PENDING_TRACES) m_writeCv.wait(m_writeMutex);
+        m_pending.emplace_back(threadId, std::move(trace));
+        if (!m_spares.empty()) {
+            spare = std::move(m_spares.back());
+            m_spares.pop_back();
+        }
+    }
+    m_writeCv.notify_all();
+    spare.reserve(TRACE_BUFFER_RECORDS);
+    trace = std::move(spare);
+}
+
+void VlExecutionProfiler::writerLoop() VL_MT_SAFE_EXCLUDES(m_writeMutex) {
+    while (true) {
+        PendingTrace pending;
+        {
+            VerilatedLockGuard lock{m_writeMutex};
+            while (m_pending.empty() && !m_writerStop) m_writeCv.wait(m_writeMutex);
+            if (m_pending.empty()) return;
+            pending = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        m_writeCv.notify_all();  // Wake threads waiting for space in m_pending
+        writeTrace(pending.first, pending.second);
+        pending.second.clear();
+        const VerilatedLockGuard lock{m_writeMutex};
+        m_spares.push_back(std::move(pending.second));
+    }
+}
+
+void VlExecutionProfiler::writeTrace(uint32_t threadId, const ExecutionTrace& trace) {
+    // Buffers of different threads interleave, each continuing the records of its thread
+    fprintf(m_fp, "VLPROFTHREAD %" PRIu32 "\n", threadId);
+
+    for (const VlExecutionRecord& er : trace) {
+        const char* const name = VlExecutionRecord::s_ascii[static_cast<uint8_t>(er.m_type)];
+        const uint64_t time = er.m_tick - m_tickBegin;
+        fprintf(m_fp, "VLPROFEXEC %s %" PRIu64, name, time);
 
-    FILE* const fp = std::fopen(filenamep, "w");
-    if (VL_UNLIKELY(!fp)) { VL_FATAL_MT(filenamep, 0, "", "+prof+exec+file file not writable"); }
+        switch (er.m_type) {
+        case VlExecutionRecord::Type::EVAL_BEGIN:
+        case VlExecutionRecord::Type::EVAL_END:
+        case VlExecutionRecord::Type::EVAL_LOOP_BEGIN:
+        case VlExecutionRecord::Type::EVAL_LOOP_END:
+        case VlExecutionRecord::Type::SECTION_POP:
+            // No payload
+            fprintf(m_fp, "\n");
+            break;
+        case VlExecutionRecord::Type::MTASK_BEGIN: {
+            const auto& payload = er.m_payload.mtaskBegin;
+            fprintf(m_fp, " id %u predictStart %u cpu %u\n", payload.m_id,
+                    payload.m_predictStart, payload.m_cpu);
+            break;
+        }
+        case VlExecutionRecord::Type::MTASK_END: {
+            const auto& payload = er.m_payload.mtaskEnd;
+            fprintf(m_fp, " id %u predictCost %u\n", payload.m_id, payload.m_predictCost);
+            break;
+        }
+        case VlExecutionRecord::Type::SECTION_PUSH: {
+            const auto& payload = er.m_payload.sectionPush;
+            fprintf(m_fp, " name %s\n", payload.m_namep);
+            break;
+        }
+        case VlExecutionRecord::Type::TRIGGER: {
+            const auto& payload = er.m_payload.trigger;
+            fprintf(m_fp, " region %s id %u\n", payload.m_regionp, payload.m_id);
+            break;
+        }
+        case VlExecutionRecord::Type::COUNTER: {
+            const auto& payload = er.m_payload.counter;
+            fprintf(m_fp, " name %s value %" PRIu64 "\n", payload.m_namep, payload.m_value);
+            break;
+        }
+        default: abort();  // LCOV_EXCL_LINE
+        }
+    }
+}
+
+void VlExecutionProfiler::start() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    if (m_counterNames.empty()) parseCounters();
+    clear();
+    m_evalCount = 0;
+
+    const std::string filename = m_context.profExecFilename();
+    VL_DEBUG_IF(VL_DBG_MSGF("+prof+exec writing to '%s'\n", filename.c_str()););
+    m_fp = std::fopen(filename.c_str(), "w");
+    if (VL_UNLIKELY(!m_fp)) {
+        VL_FATAL_MT(filename.c_str(), 0, "", "+prof+exec+file file not writable");
+    }
 
     // TODO Perhaps merge with verilated_coverage output format, so can
     // have a common merging and reporting tool, etc.
-    fprintf(fp, "VLPROFVERSION 2.0 # Verilator execution profile version 2.0\n");
-    fprintf(fp, "VLPROF arg +verilator+prof+exec+start+%" PRIu64 "\n",
-            Verilated::threadContextp()->profExecStart());
-    fprintf(fp, "VLPROF arg +verilator+prof+exec+window+%u\n",
-            Verilated::threadContextp()->profExecWindow());
-    const unsigned threads = static_cast<unsigned>(m_traceps.size());
-    fprintf(fp, "VLPROF stat threads %u\n", threads);
-    fprintf(fp, "VLPROF stat yields %" PRIu64 "\n", VlMTaskVertex::yields());
+    fprintf(m_fp, "VLPROFVERSION 2.0 # Verilator execution profile version 2.0\n");
+    fprintf(m_fp, "VLPROF arg +verilator+prof+exec+start+%" PRIu64 "\n",
+            m_context.profExecStart());
+    fprintf(m_fp, "VLPROF arg +verilator+prof+exec+window+%u\n", m_context.profExecWindow());
+    fprintf(m_fp, "VLPROF arg +verilator+prof+exec+sample+%u\n", m_context.profExecSample());
+    {
+        const VerilatedLockGuard lock{m_mutex};
+        const unsigned threads = static_cast<unsigned>(m_traceps.size());
+        fprintf(m_fp, "VLPROF stat threads %u\n", threads);
+        for (const auto& pair : m_mtaskDeps) {
+            fprintf(m_fp, "VLPROF mtask %" PRIu32 " deps %s\n", pair.first, pair.second);
+        }
+    }
 
     // Copy /proc/cpuinfo into this output so verilator_gantt can be run on
     // a different machine
@@ -176,44 +391,208 @@ void VlExecutionProfiler::dump(const char* filenamep, uint64_t tickEnd)
         const std::unique_ptr<std::ifstream> ifp{new std::ifstream{"/proc/cpuinfo"}};
         if (!ifp->fail()) {
             std::string line;
-            while (std::getline(*ifp, line)) { fprintf(fp, "VLPROFPROC %s\n", line.c_str()); }
-        }
-    }
-
-    for (const auto& pair : m_traceps) {
-        const uint32_t threadId = pair.first;
-        ExecutionTrace* const tracep = pair.second;
-        fprintf(fp, "VLPROFTHREAD %" PRIu32 "\n", threadId);
-
-        for (const VlExecutionRecord& er : *tracep) {
-            const char* const name = VlExecutionRecord::s_ascii[static_cast<uint8_t>(er.m_type)];
-            const uint64_t time = er.m_tick - m_tickBegin;
-            fprintf(fp, "VLPROFEXEC %s %" PRIu64, name, time);
-
-            switch (er.m_type) {
-            case VlExecutionRecord::Type::EVAL_BEGIN:
-            case VlExecutionRecord::Type::EVAL_END:
-            case VlExecutionRecord::Type::EVAL_LOOP_BEGIN:
-            case VlExecutionRecord::Type::EVAL_LOOP_END:
-                // No payload
-                fprintf(fp, "\n");
-                break;
-            case VlExecutionRecord::Type::MTASK_BEGIN: {
-                const auto& payload = er.m_payload.mtaskBegin;
-                fprintf(fp, " id %u predictStart %u cpu %u\n", payload.m_id,
-                        payload.m_predictStart, payload.m_cpu);
-                break;
-            }
-            case VlExecutionRecord::Type::MTASK_END: {
-                const auto& payload = er.m_payload.mtaskEnd;
-                fprintf(fp, " id %u predictCost %u\n", payload.m_id, payload.m_predictCost);
-                break;
-            }
-            default: abort();  // LCOV_EXCL_LINE
-            }
+            while (std::getline(*ifp, line)) { fprintf(m_fp, "VLPROFPROC %s\n", line.c_str()); }
+        }
+    }
+
+    {
+        const VerilatedLockGuard lock{m_writeMutex};
+        m_writerStop = false;
+    }
+    m_writer = std::thread{[this]() { writerLoop(); }};
+    m_collecting = true;
+    m_tickBegin = VL_CPU_TICK();
+}
+
+void VlExecutionProfiler::stop() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const uint64_t tickEnd = VL_CPU_TICK();
+    m_collecting = false;
+    m_enabled = false;
+
+    // Hand the partially filled buffers of all threads to the writer, which is called
+    // between evals, so no other thread is recording
+    {
+        const VerilatedLockGuard lock{m_mutex};
+        for (const auto& pair : m_traceps) {
+            if (!pair.second->empty()) queueTrace(pair.first, *pair.second);
+        }
+    }
+    {
+        const VerilatedLockGuard lock{m_writeMutex};
+        m_writerStop = true;
+    }
+    m_writeCv.notify_all();
+    m_writer.join();
+
+    fprintf(m_fp, "VLPROF stat yields %" PRIu64 "\n", VlMTaskVertex::yields());
+    fprintf(m_fp, "VLPROF stat ticks %" PRIu64 "\n", tickEnd - m_tickBegin);
+    std::fclose(m_fp);
+    m_fp = nullptr;
+}
+
+//=============================================================================
+// VlSampleProfiler implementation
+
+namespace {
+
+constexpr size_t SAMPLE_SLOTS = 1 << 16;  // Distinct program counters recorded
+constexpr size_t SAMPLE_PROBES = 32;  // Slots probed before a sample is dropped
+constexpr long SAMPLE_INTERVAL_US = 1000;  // Sampling interval, in microseconds of CPU time
+
+// Written from the signal handler, so lock-free
+struct SampleSlot final {
+    std::atomic<uintptr_t> m_pc{0};  // Sampled program counter, 0 if slot unused
+    std::atomic<uint64_t> m_count{0};  // Number of samples at m_pc
+};
+SampleSlot s_sampleSlots[SAMPLE_SLOTS];
+std::atomic<uint64_t> s_sampleDropped{0};  // Samples not recorded as table was full
+
+VerilatedMutex s_sampleMutex;  // Protects s_sampleUsers
+int s_sampleUsers VL_GUARDED_BY(s_sampleMutex) = 0;  // Number of models sampling
+
+#ifdef VL_SAMPLE_PROFILER
+void sampleHandler(int, siginfo_t*, void* contextp) {
+    const ucontext_t* const ucp = static_cast<const ucontext_t*>(contextp);
+#if defined(__x86_64__)
+    const uintptr_t pc = static_cast<uintptr_t>(ucp->uc_mcontext.gregs[REG_RIP]);
+#else
+    const uintptr_t pc = static_cast<uintptr_t>(ucp->uc_mcontext.pc);
+#endif
+    // Open addressing hash table, using top bits of a multiplicative hash
+    const size_t hash = static_cast<size_t>((pc * 0x9E3779B97F4A7C15ULL) >> 48);
+    for (size_t probe = 0; probe < SAMPLE_PROBES; ++probe) {
+        SampleSlot& slot = s_sampleSlots[(hash + probe) % SAMPLE_SLOTS];
+        uintptr_t slotPc = slot.m_pc.load(std::memory_order_relaxed);
+        if (slotPc == 0 && slot.m_pc.compare_exchange_strong(slotPc, pc)) slotPc = pc;
+        if (slotPc == pc) {
+            slot.m_count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    s_sampleDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void sampleTimer(long intervalUs) {
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = intervalUs;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+#endif
+
+// Return name of the function containing the given program counter
+std::string sampleFuncName(uintptr_t pc) {
+#ifdef VL_SAMPLE_PROFILER
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(pc), &info) && info.dli_sname) {
+        int status = 0;
+        char* const demangledp = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = demangledp ? demangledp : info.dli_sname;
+        std::free(demangledp);
+        // Drop the argument list, as model functions are registered without it
+        const std::string::size_type pos = name.find('(');
+        if (pos != std::string::npos) name.erase(pos);
+        return name;
+    }
+#endif
+    return "??";
+}
+
+}  // namespace
+
+VlSampleProfiler::VlSampleProfiler() {
+    const VerilatedLockGuard lock{s_sampleMutex};
+    if (s_sampleUsers++) return;
+#ifdef VL_SAMPLE_PROFILER
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = sampleHandler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+    sampleTimer(SAMPLE_INTERVAL_US);
+#else
+    VL_PRINTF_MT("%%Warning: --prof-sample is not supported on this platform\n");
+#endif
+}
+
+VlSampleProfiler::~VlSampleProfiler() {
+    const VerilatedLockGuard lock{s_sampleMutex};
+    if (--s_sampleUsers) return;
+#ifdef VL_SAMPLE_PROFILER
+    // The handler stays installed, as a signal may still be pending
+    sampleTimer(0);
+#endif
+}
+
+void VlSampleProfiler::write(const char* modelp, const std::string& filename) VL_MT_SAFE {
+    static VerilatedMutex s_mutex;
+    const VerilatedLockGuard lock{s_mutex};
+
+    // As with VlPgoProfiler, each model appends its own report
+    static bool s_firstCall = true;
+
+    VL_DEBUG_IF(VL_DBG_MSGF("+prof+sample+file writing to '%s'\n", filename.c_str()););
+
+    FILE* const fp = std::fopen(filename.c_str(), s_firstCall ? "w" : "a");
+    if (VL_UNLIKELY(!fp)) {
+        VL_FATAL_MT(filename.c_str(), 0, "", "+prof+sample+file file not writable");
+    }
+    s_firstCall = false;
+
+    // Attribute samples to functions, then to Verilog modules
+    std::map<std::string, uint64_t> funcSamples;
+    std::map<std::string, uint64_t> modSamples;
+    uint64_t total = 0;
+    for (const SampleSlot& slot : s_sampleSlots) {
+        const uintptr_t pc = slot.m_pc.load(std::memory_order_relaxed);
+        if (!pc) continue;
+        const uint64_t count = slot.m_count.load(std::memory_order_relaxed);
+        total += count;
+        funcSamples[sampleFuncName(pc)] += count;
+    }
+    for (const auto& pair : funcSamples) {
+        const auto it = m_funcs.find(pair.first);
+        modSamples[it == m_funcs.end() ? "(other)" : it->second.m_modName] += pair.second;
+    }
+    const auto sortedBySamples = [](const std::map<std::string, uint64_t>& samples) {
+        std::vector<std::pair<uint64_t, std::string>> sorted;
+        for (const auto& pair : samples) sorted.emplace_back(pair.second, pair.first);
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const std::pair<uint64_t, std::string>& a,
+                            const std::pair<uint64_t, std::string>& b) {
+                             return a.first > b.first;
+                         });
+        return sorted;
+    };
+    const double scale = total ? 100.0 / total : 0.0;
+
+    fprintf(fp, "# Verilated model sampling profile\n");
+    fprintf(fp, "# Model %s: %" PRIu64 " samples every %ld us of CPU time, %" PRIu64
+            " dropped\n", modelp, total, SAMPLE_INTERVAL_US,
+            s_sampleDropped.load(std::memory_order_relaxed));
+    fprintf(fp, "\n# By Verilog module\n");
+    fprintf(fp, "# %%time  samples  module\n");
+    for (const auto& pair : sortedBySamples(modSamples)) {
+        fprintf(fp, "%7.2f %8" PRIu64 "  %s\n", pair.first * scale, pair.first,
+                pair.second.c_str());
+    }
+    fprintf(fp, "\n# By function\n");
+    fprintf(fp, "# %%time  samples  module  location  scope  function\n");
+    for (const auto& pair : sortedBySamples(funcSamples)) {
+        const auto it = m_funcs.find(pair.second);
+        if (it == m_funcs.end()) {
+            fprintf(fp, "%7.2f %8" PRIu64 "  (other)  -  -  %s\n", pair.first * scale,
+                    pair.first, pair.second.c_str());
+        } else {
+            const Func& func = it->second;
+            fprintf(fp, "%7.2f %8" PRIu64 "  %s  %s  %s  %s\n", pair.first * scale, pair.first,
+                    func.m_modName.c_str(), func.m_location.c_str(),
+                    func.m_scopeName.empty() ? "-" : func.m_scopeName.c_str(),
+                    pair.second.c_str());
         }
     }
-    fprintf(fp, "VLPROF stat ticks %" PRIu64 "\n", tickEnd - m_tickBegin);
 
     std::fclose(fp);
 }
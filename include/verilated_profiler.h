@@ -29,8 +29,12 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 class VlExecutionProfiler;
@@ -43,6 +47,14 @@ class VlThreadPool;
     if (VL_UNLIKELY((vlSymsp)->__Vm_executionProfilerp->enabled())) \
     (vlSymsp)->__Vm_executionProfilerp->addRecord()
 
+#define VL_EXEC_TRACE_ADD_TRIGGERS(vlSymsp, regionp, triggers) \
+    if (VL_UNLIKELY((vlSymsp)->__Vm_executionProfilerp->enabled())) \
+    (vlSymsp)->__Vm_executionProfilerp->addTriggers((regionp), (triggers))
+
+#define VL_EXEC_TRACE_ADD_COUNTERS(vlSymsp) \
+    if (VL_UNLIKELY((vlSymsp)->__Vm_executionProfilerp->enabled())) \
+    (vlSymsp)->__Vm_executionProfilerp->addCounters()
+
 //=============================================================================
 // Return high-precision counter for profiling, or 0x0 if not available
 VL_ATTR_ALWINLINE QData VL_CPU_TICK() {
@@ -63,7 +75,11 @@ VL_ATTR_ALWINLINE QData VL_CPU_TICK() {
     _VL_FOREACH_APPLY(macro, EVAL_LOOP_BEGIN) \
     _VL_FOREACH_APPLY(macro, EVAL_LOOP_END) \
     _VL_FOREACH_APPLY(macro, MTASK_BEGIN) \
-    _VL_FOREACH_APPLY(macro, MTASK_END)
+    _VL_FOREACH_APPLY(macro, MTASK_END) \
+    _VL_FOREACH_APPLY(macro, SECTION_PUSH) \
+    _VL_FOREACH_APPLY(macro, SECTION_POP) \
+    _VL_FOREACH_APPLY(macro, TRIGGER) \
+    _VL_FOREACH_APPLY(macro, COUNTER)
 // clang-format on
 
 class VlExecutionRecord final {
@@ -92,6 +108,17 @@ class VlExecutionRecord final {
             uint32_t m_id;  // MTask id
             uint32_t m_predictCost;  // How long scheduler predicted would take
         } mtaskEnd;
+        struct {
+            const char* m_namep;  // Section name, e.g. scheduling region
+        } sectionPush;
+        struct {
+            const char* m_regionp;  // Scheduling region
+            uint32_t m_id;  // Trigger index within region
+        } trigger;
+        struct {
+            const char* m_namep;  // Hardware counter name
+            uint64_t m_value;  // Counter value
+        } counter;
     };
 
     // STATE
@@ -124,6 +151,21 @@ public:
         m_payload.mtaskEnd.m_predictCost = predictCost;
         m_type = Type::MTASK_END;
     }
+    void sectionPush(const char* namep) {
+        m_payload.sectionPush.m_namep = namep;
+        m_type = Type::SECTION_PUSH;
+    }
+    void sectionPop() { m_type = Type::SECTION_POP; }
+    void trigger(const char* regionp, uint32_t id) {
+        m_payload.trigger.m_regionp = regionp;
+        m_payload.trigger.m_id = id;
+        m_type = Type::TRIGGER;
+    }
+    void counter(const char* namep, uint64_t value) {
+        m_payload.counter.m_namep = namep;
+        m_payload.counter.m_value = value;
+        m_type = Type::COUNTER;
+    }
 };
 
 static_assert(std::is_trivially_destructible<VlExecutionRecord>::value,
@@ -132,58 +174,128 @@ static_assert(std::is_trivially_destructible<VlExecutionRecord>::value,
 //=============================================================================
 // VlExecutionProfiler is for collecting profiling data about model execution
 
+#ifndef VL_PROF_EXEC_BUFFER_RECORDS
+#define VL_PROF_EXEC_BUFFER_RECORDS 16384  ///< Records in each --prof-exec trace buffer
+#endif
+#ifndef VL_PROF_EXEC_MAX_PENDING
+#define VL_PROF_EXEC_MAX_PENDING 32  ///< Full --prof-exec trace buffers waiting to be written
+#endif
+
 class VlExecutionProfiler final : public VerilatedVirtualBase {
     // CONSTANTS
 
-    // In order to try to avoid dynamic memory allocations during the actual profiling phase,
-    // trace buffers are pre-allocated to be able to hold [a multiple] of this many records.
-    static constexpr size_t RESERVED_TRACE_CAPACITY = 4096;
+    // In order to avoid dynamic memory allocations during the actual profiling phase, trace
+    // buffers are pre-allocated to hold this many records. When a buffer is full, it is handed
+    // to the writer thread, and recording continues into a spare buffer.
+    static constexpr size_t TRACE_BUFFER_RECORDS = VL_PROF_EXEC_BUFFER_RECORDS;
+    // Maximum number of full buffers waiting for the writer thread, bounding memory use. A
+    // thread filling a buffer beyond this waits for the writer.
+    static constexpr size_t MAX_PENDING_TRACES = VL_PROF_EXEC_MAX_PENDING;
 
     // TYPES
 
     // Execution traces are recorded into thread local vectors. We can append records of profiling
-    // events to this vector with very low overhead, and then dump them out later. This prevents
-    // the overhead of printf/malloc/IO from corrupting the profiling data. It's super cheap to
-    // append a VlProfileRec struct on the end of a pre-allocated vector; this is the only cost we
-    // pay in real-time during a profiling cycle. Internal note: Globals may multi-construct, see
-    // verilated.cpp top.
+    // events to this vector with very low overhead, and then write them out later, on a
+    // background thread. This prevents the overhead of printf/malloc/IO from corrupting the
+    // profiling data. It's super cheap to append a VlProfileRec struct on the end of a
+    // pre-allocated vector; this is the only cost we pay in real-time during a profiling cycle.
+    // Internal note: Globals may multi-construct, see verilated.cpp top.
     using ExecutionTrace = std::vector<VlExecutionRecord>;
+    // A full trace buffer waiting for the writer thread, and the id of the thread recording it
+    using PendingTrace = std::pair<uint32_t, ExecutionTrace>;
+
+    // Hardware performance counters (perf_event_open) sampled by one thread
+    struct ThreadCounters final {
+        bool m_opened = false;  // Opening was attempted on this thread
+        std::vector<std::pair<const char*, int>> m_fds;  // Counter name and file descriptor
+        ~ThreadCounters();
+    };
 
     // STATE
     VerilatedContext& m_context;  // The context this profiler is under
     static thread_local ExecutionTrace t_trace;  // thread-local trace buffers
+    static thread_local uint32_t t_threadId;  // thread-local id of the recording thread
+    static thread_local ThreadCounters t_counters;  // thread-local hardware counters
     mutable VerilatedMutex m_mutex;
     // Map from thread id to &t_trace of given thread
     std::map<uint32_t, ExecutionTrace*> m_traceps VL_GUARDED_BY(m_mutex);
 
-    bool m_enabled = false;  // Is profiling currently enabled
+    // Writer thread, streaming full trace buffers to the profile file while collecting
+    VerilatedMutex m_writeMutex;  // Protects state below shared with the writer thread
+    std::condition_variable_any m_writeCv;  // Signals changes of m_pending or m_writerStop
+    std::deque<PendingTrace> m_pending VL_GUARDED_BY(m_writeMutex);  // Buffers to write
+    std::vector<ExecutionTrace> m_spares VL_GUARDED_BY(m_writeMutex);  // Written, for reuse
+    bool m_writerStop VL_GUARDED_BY(m_writeMutex) = false;  // Writer to exit once drained
+    std::thread m_writer;  // The writer thread
+    FILE* m_fp = nullptr;  // Profile file being written, while collecting
+
+    bool m_enabled = false;  // Is profiling currently enabled (this eval is recorded)
+    bool m_warming = false;  // In warm-up before collecting the +prof+exec+window
+    bool m_collecting = false;  // Collecting a window, streaming records into m_fp
+    bool m_manual = false;  // Collecting a window requested by profExecCollect()
 
     uint64_t m_tickBegin = 0;  // Sample time (rdtsc() on x86) at beginning of collection
     uint64_t m_lastStartReq = 0;  // Last requested profiling start (in simulation time)
+    uint64_t m_evalCount = 0;  // Evals since warm-up or collection started, for sampling
     uint32_t m_windowCount = 0;  // Track our position in the cache warmup and profile window
+    std::vector<const char*> m_counterNames;  // +prof+exec+counters hardware counters to sample
+    // Map from mtask id to space separated ids of the mtasks it depends on
+    std::map<uint32_t, const char*> m_mtaskDeps VL_GUARDED_BY(m_mutex);
+
+    // METHODS
+    void parseCounters();  // Parse +prof+exec+counters into m_counterNames
+    void openCounters();  // Open hardware counters on the current thread
+    static uint64_t readCounter(int fd);  // Read current value of given hardware counter
+    void flushTrace();  // Called when the trace buffer of the current thread is full
+    // Hand given trace buffer to the writer thread, replacing it with an empty buffer
+    void queueTrace(uint32_t threadId, ExecutionTrace& trace) VL_MT_SAFE_EXCLUDES(m_writeMutex);
+    void writerLoop() VL_MT_SAFE_EXCLUDES(m_writeMutex);  // Body of writer thread
+    void writeTrace(uint32_t threadId, const ExecutionTrace& trace);  // Write records to m_fp
+    void start() VL_MT_SAFE_EXCLUDES(m_mutex);  // Start collecting, opening the profile file
+    void stop() VL_MT_SAFE_EXCLUDES(m_mutex);  // Stop collecting, completing the profile file
 
 public:
     // CONSTRUCTOR
     explicit VlExecutionProfiler(VerilatedContext& context);
-    ~VlExecutionProfiler() override = default;
+    ~VlExecutionProfiler() override;
 
     // METHODS
 
     // Is profiling enabled
     bool enabled() const { return m_enabled; }
     // Append a trace record to the trace buffer of the current thread
-    static VlExecutionRecord& addRecord() {
+    VlExecutionRecord& addRecord() {
+        if (VL_UNLIKELY(t_trace.size() >= TRACE_BUFFER_RECORDS)) flushTrace();
         t_trace.emplace_back();
         return t_trace.back();
     }
+    // Append a TRIGGER record for each trigger set in the given trigger vector
+    template <std::size_t T_size>
+    void addTriggers(const char* regionp, const VlTriggerVec<T_size>& triggers) {
+        for (size_t i = 0; i < T_size; ++i) {
+            if ((triggers.word(i / 64) >> (i % 64)) & 1) {
+                addRecord().trigger(regionp, static_cast<uint32_t>(i));
+            }
+        }
+    }
+    // Append a COUNTER record for each hardware counter sampled by the current thread
+    void addCounters() {
+        if (VL_UNLIKELY(!t_counters.m_opened)) openCounters();
+        for (const auto& pair : t_counters.m_fds) {
+            addRecord().counter(pair.first, readCounter(pair.second));
+        }
+    }
+    // Record the predicted schedule's dependencies of an mtask (called by model constructor)
+    void addMTaskDeps(uint32_t id, const char* depsp) VL_MT_SAFE_EXCLUDES(m_mutex) {
+        const VerilatedLockGuard lock{m_mutex};
+        m_mtaskDeps[id] = depsp;
+    }
     // Configure profiler (called in beginning of 'eval')
     void configure();
     // Setup profiling on a particular thread;
     void setupThread(uint32_t threadId);
-    // Clear all profiling data
+    // Clear all profiling data not yet handed to the writer thread
     void clear() VL_MT_SAFE_EXCLUDES(m_mutex);
-    // Write profiling data into file
-    void dump(const char* filenamep, uint64_t tickEnd) VL_MT_SAFE_EXCLUDES(m_mutex);
 
     // Passed to VerilatedContext to create the VlExecutionProfiler profiler instance
     static VerilatedVirtualBase* construct(VerilatedContext& context);
@@ -198,13 +310,31 @@ class VlPgoProfiler final {
     struct Record final {
         const std::string m_name;  // Hashed name of mtask/etc
         const size_t m_counterNumber = 0;  // Which counter has data
+        const bool m_cfunc = false;  // Record is a function, with call counts
     };
 
     // Counters are stored packed, all together to reduce cache effects
     std::array<uint64_t, T_Entries> m_counters;  // Time spent on this record
+    std::array<uint64_t, T_Entries> m_calls;  // Number of calls, for function records
     std::vector<Record> m_records;  // Record information
 
 public:
+    // Times and counts one call of a function for its lifetime
+    class Scope final {
+        VlPgoProfiler& m_profiler;
+        const size_t m_counter;
+
+    public:
+        Scope(VlPgoProfiler& profiler, size_t counter)
+            : m_profiler{profiler}
+            , m_counter{counter} {
+            ++m_profiler.m_calls[m_counter];
+            m_profiler.startCounter(m_counter);
+        }
+        ~Scope() { m_profiler.stopCounter(m_counter); }
+        VL_UNCOPYABLE(Scope);
+    };
+
     // METHODS
     VlPgoProfiler() = default;
     ~VlPgoProfiler() = default;
@@ -213,6 +343,12 @@ public:
         VL_DEBUG_IF(assert(counter < T_Entries););
         m_records.emplace_back(Record{name, counter});
     }
+    void addCFuncCounter(size_t counter, const std::string& name) {
+        VL_DEBUG_IF(assert(counter < T_Entries););
+        m_counters[counter] = 0;
+        m_calls[counter] = 0;
+        m_records.emplace_back(Record{name, counter, true});
+    }
     void startCounter(size_t counter) {
         // -= so when we add end time in stopCounter, the net effect is adding the difference,
         // without needing to hold onto a temporary
@@ -248,11 +384,57 @@ void VlPgoProfiler<T_Entries>::write(const char* modelp, const std::string& file
     fprintf(fp, "`verilator_config\n");
 
     for (const Record& rec : m_records) {
-        fprintf(fp, "profile_data -model \"%s\" -mtask \"%s\" -cost 64'd%" PRIu64 "\n", modelp,
-                rec.m_name.c_str(), m_counters[rec.m_counterNumber]);
+        if (rec.m_cfunc) {
+            fprintf(fp,
+                    "profile_data -model \"%s\" -cfunc \"%s\" -cost 64'd%" PRIu64
+                    " -calls 64'd%" PRIu64 "\n",
+                    modelp, rec.m_name.c_str(), m_counters[rec.m_counterNumber],
+                    m_calls[rec.m_counterNumber]);
+        } else {
+            fprintf(fp, "profile_data -model \"%s\" -mtask \"%s\" -cost 64'd%" PRIu64 "\n",
+                    modelp, rec.m_name.c_str(), m_counters[rec.m_counterNumber]);
+        }
     }
 
     std::fclose(fp);
 }
 
+//=============================================================================
+// VlSampleProfiler is a low-overhead statistical profiler for --prof-sample
+
+// A SIGPROF interval timer samples the program counter of the running thread,
+// and the samples are attributed at dump time to the model function
+// containing them, and through the function table registered by the model to
+// the Verilog module and source line the function came from. The sampler is
+// process-wide, and shared by all models using it.
+
+class VlSampleProfiler final {
+    // TYPES
+    struct Func final {
+        const std::string m_modName;  // Verilog module
+        const std::string m_scopeName;  // Verilog scope, if known
+        const std::string m_location;  // Verilog file:line
+    };
+
+    // STATE
+    std::unordered_map<std::string, Func> m_funcs;  // C++ function name -> Verilog info
+
+public:
+    // CONSTRUCTORS
+    // Start sampling, if this is the first model using the sampler
+    VlSampleProfiler();
+    // Stop sampling, if this is the last model using the sampler
+    ~VlSampleProfiler();
+    VL_UNCOPYABLE(VlSampleProfiler);
+
+    // METHODS
+    // Register a model function, under its C++ name
+    void addFunc(const char* cnamep, const char* modNamep, const char* scopeNamep,
+                 const char* locationp) {
+        m_funcs.emplace(cnamep, Func{modNamep, scopeNamep, locationp});
+    }
+    // Write report of samples so far
+    void write(const char* modelp, const std::string& filename) VL_MT_SAFE;
+};
+
 #endif
@@ -30,13 +30,24 @@
 #include "verilated.h"
 #include "verilated_imp.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <condition_variable>
 #include <fcntl.h>
+#include <thread>
 
 // clang-format off
+// The trace format's runtime, when linked, already defines the LZ4 functions
+#if VM_TRACE_FST || VM_TRACE_VBT
+# include "gtkwave/lz4.h"
+#else
+# include "gtkwave/lz4.c"
+#endif
+
 #if defined(_WIN32) && !defined(__MINGW32__) && !defined(__CYGWIN__)
 # include <io.h>
 #else
+# include <sys/mman.h>
 # include <unistd.h>
 #endif
 
@@ -56,6 +67,154 @@
 static const char* const VLTSAVE_HEADER_STR = "verilatorsave02\n";
 // Value of last bytes of each file (must be multiple of 8 bytes)
 static const char* const VLTSAVE_TRAILER_STR = "vltsaved";
+// Value of first bytes of each incremental delta file (must be multiple of 8 bytes)
+static const char* const VLTSAVE_DELTA_HEADER_STR = "verilatordelta01";
+// Value of last bytes of each incremental delta file (must be multiple of 8 bytes)
+static const char* const VLTSAVE_DELTA_TRAILER_STR = "vltdelta";
+// Value of first bytes of each compressed file (must be multiple of 8 bytes)
+static const char* const VLTSAVE_LZ4_HEADER_STR = "verilatorsavelz4";
+// Granularity of change tracking for incremental saves
+static constexpr size_t VLTSAVE_PAGE_SIZE = 4096;
+
+//=============================================================================
+// Incremental save helpers
+
+static uint64_t vlSavePageHash(const uint8_t* datap, size_t size) VL_PURE {
+    // Length is included so a partial last page differs from the same page when full
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ size;
+    const uint8_t* const endp = datap + size;
+    for (; datap + sizeof(uint64_t) <= endp; datap += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, datap, sizeof(word));
+        hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    for (; datap < endp; ++datap) hash = (hash ^ *datap) * 0x100000001b3ULL;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+static void vlSaveReadAt(const std::string& filename, int fd, void* datap, size_t size,
+                         uint64_t offset) VL_MT_UNSAFE_ONE {
+    uint8_t* dp = static_cast<uint8_t*>(datap);
+    if (VL_UNCOVERABLE(::lseek(fd, static_cast<off_t>(offset), SEEK_SET) < 0)) size = 0;
+    while (size) {
+        errno = 0;
+        const ssize_t got = ::read(fd, dp, size);
+        if (got > 0) {
+            dp += got;
+            size -= got;
+        } else if (got < 0 && (errno == EAGAIN || errno == EINTR)) {
+        } else {
+            break;
+        }
+    }
+    if (VL_UNLIKELY(size)) {
+        const std::string msg
+            = std::string{"Can't deserialize; save file is truncated: "} + filename;
+        VL_FATAL_MT(filename.c_str(), 0, "", msg.c_str());
+    }
+}
+
+static int vlSaveWriteFd(int fd, const void* datap, size_t size) VL_MT_SAFE {
+    // Write all of datap, return errno on failure or 0
+    const uint8_t* wp = static_cast<const uint8_t*>(datap);
+    const uint8_t* const endp = wp + size;
+    while (wp < endp) {
+        errno = 0;
+        const ssize_t got = ::write(fd, wp, endp - wp);
+        if (got > 0) {
+            wp += got;
+        } else if (VL_UNCOVERABLE(got < 0 && errno != EAGAIN && errno != EINTR)) {
+            return errno;  // LCOV_EXCL_LINE // Perhaps out of disk space
+        }
+    }
+    return 0;
+}
+
+//=============================================================================
+// VerilatedSave::Writer
+// Writes one buffer in the background while the next is filled. When
+// compressing, each buffer becomes a frame of compressed size, raw size, then
+// the data; a compressed size of zero means the data is stored uncompressed.
+
+struct VerilatedSave::Writer final {
+    const int m_fd;  // File descriptor to write to
+    const bool m_compress;  // Compress into frames, else write buffers as is
+    VerilatedMutex m_mutex;  // Protects members below
+    std::condition_variable_any m_cv;  // Signalled when m_srcp or m_shutdown changes
+    const uint8_t* m_srcp VL_GUARDED_BY(m_mutex) = nullptr;  // Buffer to compress, or nullptr
+    size_t m_srcSize VL_GUARDED_BY(m_mutex) = 0;  // Bytes in m_srcp
+    int m_errno VL_GUARDED_BY(m_mutex) = 0;  // First write error, 0 = none
+    bool m_shutdown VL_GUARDED_BY(m_mutex) = false;  // Thread should exit
+    std::vector<char> m_frame;  // Frame being written, only used by thread
+    std::thread m_thread;  // Compression thread, last so other members are constructed first
+
+    Writer(int fd, bool compress)
+        : m_fd{fd}
+        , m_compress{compress}
+        , m_thread{&Writer::threadMain, this} {}
+    ~Writer() {
+        {
+            const VerilatedLockGuard lock{m_mutex};
+            m_shutdown = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+    // Hand over a buffer, which must not change until the next submit() or
+    // wait(). Returns the errno of an earlier write, or 0.
+    int submit(const uint8_t* srcp, size_t size) VL_MT_SAFE_EXCLUDES(m_mutex) {
+        VerilatedLockGuard lock{m_mutex};
+        while (m_srcp) m_cv.wait(m_mutex);
+        m_srcp = srcp;
+        m_srcSize = size;
+        m_cv.notify_all();
+        return m_errno;
+    }
+    // Wait for the last buffer to be written. Returns errno of any write, or 0.
+    int wait() VL_MT_SAFE_EXCLUDES(m_mutex) {
+        VerilatedLockGuard lock{m_mutex};
+        while (m_srcp) m_cv.wait(m_mutex);
+        return m_errno;
+    }
+    void threadMain() VL_MT_SAFE_EXCLUDES(m_mutex) {
+        while (true) {
+            const uint8_t* srcp;
+            size_t size;
+            {
+                VerilatedLockGuard lock{m_mutex};
+                while (!m_srcp && !m_shutdown) m_cv.wait(m_mutex);
+                if (!m_srcp) return;
+                srcp = m_srcp;
+                size = m_srcSize;
+            }
+            const int err = m_compress ? writeFrame(srcp, size) : vlSaveWriteFd(m_fd, srcp, size);
+            {
+                const VerilatedLockGuard lock{m_mutex};
+                if (err && !m_errno) m_errno = err;
+                m_srcp = nullptr;
+            }
+            m_cv.notify_all();
+        }
+    }
+    int writeFrame(const uint8_t* srcp, size_t size) VL_MT_SAFE {
+        // Compress and write one frame, return errno on failure or 0
+        const int bound = LZ4_compressBound(static_cast<int>(size));
+        m_frame.resize(2 * sizeof(uint32_t) + bound);
+        const int compSize = LZ4_compress_default(reinterpret_cast<const char*>(srcp),
+                                                  &m_frame[2 * sizeof(uint32_t)],
+                                                  static_cast<int>(size), bound);
+        const uint32_t sizes[2]
+            = {static_cast<uint32_t>(
+                   compSize > 0 && static_cast<size_t>(compSize) < size ? compSize : 0),
+               static_cast<uint32_t>(size)};
+        std::memcpy(&m_frame[0], sizes, sizeof(sizes));
+        int err = vlSaveWriteFd(m_fd, m_frame.data(), 2 * sizeof(uint32_t) + sizes[0]);
+        if (!sizes[0] && !err) err = vlSaveWriteFd(m_fd, srcp, size);
+        return err;
+    }
+};
 
 //=============================================================================
 //=============================================================================
@@ -84,6 +243,28 @@ VerilatedDeserialize& VerilatedDeserialize::readAssert(const void* __restrict da
     return *this;  // For function chaining
 }
 
+void VerilatedSerialize::writeAligned(const void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE {
+    // Pad so the data's offset in the stream, and so in a full save's file,
+    // is congruent to its address modulo the page size
+    VerilatedSerialize& os = *this;  // So can cut and paste standard << code below
+    const uint64_t pageOffset = reinterpret_cast<uintptr_t>(datap) % VLTSAVE_PAGE_SIZE;
+    os << pageOffset;
+    const uint64_t pos = m_bufStreamPos + (m_cp - m_bufp);
+    static const uint8_t zeros[VLTSAVE_PAGE_SIZE] = {};
+    os.write(zeros, (pageOffset + VLTSAVE_PAGE_SIZE - pos % VLTSAVE_PAGE_SIZE) % VLTSAVE_PAGE_SIZE);
+    os.write(datap, size);
+}
+
+void VerilatedDeserialize::readAligned(void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE {
+    VerilatedDeserialize& os = *this;  // So can cut and paste standard >> code below
+    uint64_t pageOffset = 0;
+    os >> pageOffset;
+    const uint64_t pos = m_bufStreamPos + (m_cp - m_bufp);
+    uint8_t pad[VLTSAVE_PAGE_SIZE];
+    os.read(pad, (pageOffset + VLTSAVE_PAGE_SIZE - pos % VLTSAVE_PAGE_SIZE) % VLTSAVE_PAGE_SIZE);
+    readLarge(datap, size);
+}
+
 void VerilatedSerialize::header() VL_MT_UNSAFE_ONE {
     VerilatedSerialize& os = *this;  // So can cut and paste standard << code below
     assert((std::strlen(VLTSAVE_HEADER_STR) & 7) == 0);  // Keep aligned
@@ -146,6 +327,33 @@ void VerilatedSave::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_isOpen = true;
     m_filename = filenamep;
     m_cp = m_bufp;
+    m_bufStreamPos = 0;
+    m_incrOpen = m_incrMaxDeltas != 0;
+    m_delta = m_incrOpen && !m_chainFilenames.empty()
+              && m_chainFilenames.size() <= m_incrMaxDeltas
+              && std::find(m_chainFilenames.begin(), m_chainFilenames.end(), m_filename)
+                     == m_chainFilenames.end();
+    m_streamSize = 0;
+    m_fileSize = 0;
+    m_deltaPages.clear();
+    if (m_incrOpen && !m_delta) {
+        m_chainFilenames.clear();
+        m_pageHashes.clear();
+    }
+    if (m_delta) {
+        // Delta header names the previous file, and is padded so pages are aligned
+        const std::string& parent = m_chainFilenames.back();
+        const uint64_t fields[3] = {VLTSAVE_PAGE_SIZE, m_chainFileSize, parent.size()};
+        std::string hdr{VLTSAVE_DELTA_HEADER_STR};
+        hdr.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+        hdr += parent;
+        hdr.resize((hdr.size() + VLTSAVE_PAGE_SIZE - 1) / VLTSAVE_PAGE_SIZE * VLTSAVE_PAGE_SIZE);
+        writeFd(hdr.data(), hdr.size());
+    } else if ((m_compress || m_async) && !m_incrOpen) {
+        if (m_compress) writeFd(VLTSAVE_LZ4_HEADER_STR, std::strlen(VLTSAVE_LZ4_HEADER_STR));
+        if (!m_spareBufp) m_spareBufp = new uint8_t[bufferSize()];
+        m_writerp = new Writer{m_fd, m_compress};
+    }
     header();
 }
 
@@ -169,15 +377,121 @@ void VerilatedRestore::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_filename = filenamep;
     m_cp = m_bufp;
     m_endp = m_bufp;
+    m_bufStreamPos = 0;
+    // Follow a chain of incremental saves back to the full save
+    std::string filename = m_filename;
+    std::string parent;
+    while (openDelta(filename, parent)) {
+        filename = parent;
+        // cppcheck-suppress duplicateExpression
+        m_fd = ::open(filename.c_str(), O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+        if (VL_UNLIKELY(m_fd < 0
+                        || static_cast<uint64_t>(::lseek(m_fd, 0, SEEK_END))
+                               != m_deltas.back().m_parentSize)) {
+            const std::string msg
+                = std::string{"Can't deserialize; incremental save file's parent is missing or "
+                              "changed: "}
+                  + filename;
+            VL_FATAL_MT(filename.c_str(), 0, "", msg.c_str());
+            return;
+        }
+        ::lseek(m_fd, 0, SEEK_SET);
+    }
+    m_streamPos = 0;
+    if (!m_deltas.empty()) m_streamSize = m_deltas.front().m_streamSize;
+    if (m_deltas.empty()) {
+        // Compressed saves have their own header, then the frames
+        const size_t hdrLen = std::strlen(VLTSAVE_LZ4_HEADER_STR);
+        char hdr[16];  // Enough for VLTSAVE_LZ4_HEADER_STR
+        if (::read(m_fd, hdr, hdrLen) == static_cast<ssize_t>(hdrLen)
+            && !std::memcmp(hdr, VLTSAVE_LZ4_HEADER_STR, hdrLen)) {
+            m_compressed = true;
+            m_filePos = hdrLen;
+            m_fileEnd = ::lseek(m_fd, 0, SEEK_END);
+            m_frameRaw.clear();
+            m_frameRawPos = 0;
+        } else {
+            ::lseek(m_fd, 0, SEEK_SET);
+        }
+    }
     header();
 }
 
+bool VerilatedRestore::openDelta(const std::string& filename,
+                                 std::string& parent) VL_MT_UNSAFE_ONE {
+    // If m_fd is a delta file, move it to m_deltas, set parent and return true
+    const size_t hdrLen = std::strlen(VLTSAVE_DELTA_HEADER_STR);
+    char hdr[16];  // Enough for VLTSAVE_DELTA_HEADER_STR
+    if (::read(m_fd, hdr, hdrLen) != static_cast<ssize_t>(hdrLen)
+        || std::memcmp(hdr, VLTSAVE_DELTA_HEADER_STR, hdrLen)) {
+        ::lseek(m_fd, 0, SEEK_SET);
+        return false;
+    }
+    Delta delta;
+    delta.m_fd = m_fd;
+    m_fd = -1;
+    m_deltas.push_back(delta);  // Before reading, so closeImp will close it
+    Delta& d = m_deltas.back();
+    uint64_t fields[3];  // Page size, parent's size, parent name length
+    vlSaveReadAt(filename, d.m_fd, fields, sizeof(fields), hdrLen);
+    d.m_parentSize = fields[1];
+    parent.resize(fields[2]);
+    vlSaveReadAt(filename, d.m_fd, &parent[0], parent.size(), hdrLen + sizeof(fields));
+    d.m_dataOffset = (hdrLen + sizeof(fields) + parent.size() + VLTSAVE_PAGE_SIZE - 1)
+                     / VLTSAVE_PAGE_SIZE * VLTSAVE_PAGE_SIZE;
+    // Footer has stream size, page count, index offset, then trailer
+    uint64_t footer[4];
+    const off_t fileSize = ::lseek(d.m_fd, 0, SEEK_END);
+    if (VL_UNLIKELY(fileSize < static_cast<off_t>(d.m_dataOffset + sizeof(footer)))) {
+        const std::string msg
+            = std::string{"Can't deserialize; incremental save file is truncated: "} + filename;
+        VL_FATAL_MT(filename.c_str(), 0, "", msg.c_str());
+        return false;
+    }
+    vlSaveReadAt(filename, d.m_fd, footer, sizeof(footer), fileSize - sizeof(footer));
+    if (VL_UNLIKELY(fields[0] != VLTSAVE_PAGE_SIZE
+                    || std::memcmp(&footer[3], VLTSAVE_DELTA_TRAILER_STR, sizeof(footer[3])))) {
+        const std::string msg
+            = std::string{"Can't deserialize; incremental save file is corrupt: "} + filename;
+        VL_FATAL_MT(filename.c_str(), 0, "", msg.c_str());
+        return false;
+    }
+    d.m_streamSize = footer[0];
+    d.m_pages.resize(footer[1]);
+    if (!d.m_pages.empty()) {
+        vlSaveReadAt(filename, d.m_fd, d.m_pages.data(), d.m_pages.size() * sizeof(uint64_t),
+                     footer[2]);
+    }
+    return true;
+}
+
 void VerilatedSave::closeImp() VL_MT_UNSAFE_ONE {
     if (!isOpen()) return;
     trailer();
-    flushImp();
+    if (m_incrOpen) {
+        flushPages(true);
+        m_pageHashes.resize((m_streamSize + VLTSAVE_PAGE_SIZE - 1) / VLTSAVE_PAGE_SIZE);
+        if (m_delta) {
+            // Index of pages in the file, then footer
+            const uint64_t footer[3] = {m_streamSize, m_deltaPages.size(), m_fileSize};
+            writeFd(m_deltaPages.data(), m_deltaPages.size() * sizeof(uint64_t));
+            writeFd(footer, sizeof(footer));
+            writeFd(VLTSAVE_DELTA_TRAILER_STR, std::strlen(VLTSAVE_DELTA_TRAILER_STR));
+        }
+        m_chainFilenames.push_back(m_filename);
+        m_chainFileSize = m_fileSize;
+        m_incrOpen = false;
+    } else {
+        flushImp();
+    }
+    int err = 0;
+    if (m_writerp) {
+        err = m_writerp->wait();
+        VL_DO_CLEAR(delete m_writerp, m_writerp = nullptr);
+    }
     m_isOpen = false;
     ::close(m_fd);  // May get error, just ignore it
+    writeError(err);
 }
 
 void VerilatedRestore::closeImp() VL_MT_UNSAFE_ONE {
@@ -186,6 +500,9 @@ void VerilatedRestore::closeImp() VL_MT_UNSAFE_ONE {
     flushImp();
     m_isOpen = false;
     ::close(m_fd);  // May get error, just ignore it
+    for (const Delta& delta : m_deltas) ::close(delta.m_fd);
+    m_deltas.clear();
+    m_compressed = false;
 }
 
 //=============================================================================
@@ -194,27 +511,81 @@ void VerilatedRestore::closeImp() VL_MT_UNSAFE_ONE {
 void VerilatedSave::flushImp() VL_MT_UNSAFE_ONE {
     m_assertOne.check();
     if (VL_UNLIKELY(!isOpen())) return;
-    const uint8_t* wp = m_bufp;
-    while (true) {
-        const ssize_t remaining = (m_cp - wp);
-        if (remaining == 0) break;
-        errno = 0;
-        const ssize_t got = ::write(m_fd, wp, remaining);
-        if (got > 0) {
-            wp += got;
-        } else if (VL_UNCOVERABLE(got < 0)) {
-            if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) {
-                // LCOV_EXCL_START
-                // write failed, presume error (perhaps out of disk space)
-                const std::string msg = std::string{__FUNCTION__} + ": " + std::strerror(errno);
-                VL_FATAL_MT("", 0, "", msg.c_str());
-                close();
-                break;
-                // LCOV_EXCL_STOP
+    if (m_incrOpen) {
+        flushPages(false);
+        return;
+    }
+    if (m_writerp) {
+        // Write this buffer in the background, and fill the other meanwhile
+        const int err = m_writerp->submit(m_bufp, m_cp - m_bufp);
+        m_bufStreamPos += m_cp - m_bufp;
+        std::swap(m_bufp, m_spareBufp);
+        m_cp = m_bufp;
+        writeError(err);
+        return;
+    }
+    writeFd(m_bufp, m_cp - m_bufp);
+    m_bufStreamPos += m_cp - m_bufp;
+    m_cp = m_bufp;  // Reset buffer
+}
+
+void VerilatedSave::flushPages(bool last) VL_MT_UNSAFE_ONE {
+    // Hash each complete page (or the final partial one), and write it out
+    // unless writing a delta and the page matches the previous save
+    const uint8_t* pagep = m_bufp;
+    const uint8_t* runp = nullptr;  // Start of pages not yet written
+    size_t pad = 0;  // Zeros to pad out a partial last page written to delta
+    while (pagep < m_cp) {
+        const size_t size = std::min<size_t>(VLTSAVE_PAGE_SIZE, m_cp - pagep);
+        if (size < VLTSAVE_PAGE_SIZE && !last) break;
+        const uint64_t hash = vlSavePageHash(pagep, size);
+        const uint64_t page = m_streamSize / VLTSAVE_PAGE_SIZE;
+        bool changed = true;
+        if (page < m_pageHashes.size()) {
+            changed = m_pageHashes[page] != hash;
+            m_pageHashes[page] = hash;
+        } else {
+            m_pageHashes.push_back(hash);
+        }
+        if (!m_delta || changed) {
+            if (m_delta) {
+                m_deltaPages.push_back(page);
+                pad = VLTSAVE_PAGE_SIZE - size;
             }
+            if (!runp) runp = pagep;
+        } else if (runp) {
+            writeFd(runp, pagep - runp);
+            runp = nullptr;
         }
+        m_streamSize += size;
+        pagep += size;
+    }
+    if (runp) writeFd(runp, pagep - runp);
+    if (pad) {
+        const std::string zeros(pad, '\0');
+        writeFd(zeros.data(), pad);
+    }
+    // Move remaining partial page down to start of buffer
+    const size_t remaining = m_cp - pagep;
+    std::memmove(m_bufp, pagep, remaining);
+    m_cp = m_bufp + remaining;
+    m_bufStreamPos = m_streamSize;
+}
+
+void VerilatedSave::writeFd(const void* datap, size_t size) VL_MT_UNSAFE_ONE {
+    m_fileSize += size;
+    writeError(vlSaveWriteFd(m_fd, datap, size));
+}
+
+void VerilatedSave::writeError(int err) VL_MT_UNSAFE_ONE {
+    if (VL_UNCOVERABLE(err)) {
+        // LCOV_EXCL_START
+        // write failed, presume error (perhaps out of disk space)
+        const std::string msg = std::string{__FUNCTION__} + ": " + std::strerror(err);
+        VL_FATAL_MT("", 0, "", msg.c_str());
+        close();
+        // LCOV_EXCL_STOP
     }
-    m_cp = m_bufp;  // Reset buffer
 }
 
 void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
@@ -224,7 +595,16 @@ void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
     uint8_t* rp = m_bufp;
     for (uint8_t* sp = m_cp; sp < m_endp; *rp++ = *sp++) {}  // Overlaps
     m_endp = m_bufp + (m_endp - m_cp);
+    m_bufStreamPos += m_cp - m_bufp;
     m_cp = m_bufp;  // Reset buffer
+    if (!m_deltas.empty()) {
+        fillDelta();
+        return;
+    }
+    if (m_compressed) {
+        fillCompressed();
+        return;
+    }
     // Read into buffer starting at m_endp
     while (true) {
         const ssize_t remaining = (m_bufp + bufferSize() - m_endp);
@@ -252,6 +632,121 @@ void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
     }
 }
 
+void VerilatedRestore::fillDelta() VL_MT_UNSAFE_ONE {
+    // Read each page of the stream from the newest file of the chain that has it
+    uint8_t* const bufEndp = m_bufp + bufferSize();
+    while (m_endp < bufEndp && m_streamPos < m_streamSize) {
+        const uint64_t page = m_streamPos / VLTSAVE_PAGE_SIZE;
+        const uint64_t offset = m_streamPos % VLTSAVE_PAGE_SIZE;
+        const size_t size = std::min<uint64_t>(
+            {VLTSAVE_PAGE_SIZE - offset, static_cast<uint64_t>(bufEndp - m_endp),
+             m_streamSize - m_streamPos});
+        int fd = m_fd;
+        uint64_t fileOffset = m_streamPos;  // The full save's file is the stream
+        for (Delta& delta : m_deltas) {
+            while (delta.m_cursor < delta.m_pages.size() && delta.m_pages[delta.m_cursor] < page) {
+                ++delta.m_cursor;
+            }
+            if (delta.m_cursor < delta.m_pages.size() && delta.m_pages[delta.m_cursor] == page) {
+                fd = delta.m_fd;
+                fileOffset = delta.m_dataOffset + delta.m_cursor * VLTSAVE_PAGE_SIZE + offset;
+                break;
+            }
+        }
+        vlSaveReadAt(m_filename, fd, m_endp, size, fileOffset);
+        m_endp += size;
+        m_streamPos += size;
+    }
+    // At end, fill buffer with NULLs so reader's don't need to check eof each character.
+    if (m_streamPos >= m_streamSize) {
+        while (m_endp < bufEndp) *m_endp++ = '\0';
+    }
+}
+
+void VerilatedRestore::fillCompressed() VL_MT_UNSAFE_ONE {
+    // Decompress frames into the buffer, a frame may span several fills
+    uint8_t* const bufEndp = m_bufp + bufferSize();
+    while (m_endp < bufEndp) {
+        if (m_frameRawPos == m_frameRaw.size()) {
+            if (m_filePos >= m_fileEnd) break;
+            uint32_t sizes[2];  // Compressed size, raw size
+            vlSaveReadAt(m_filename, m_fd, sizes, sizeof(sizes), m_filePos);
+            m_filePos += sizeof(sizes);
+            m_frameRaw.resize(sizes[1]);
+            m_frameRawPos = 0;
+            if (!sizes[0]) {  // Stored uncompressed
+                vlSaveReadAt(m_filename, m_fd, m_frameRaw.data(), sizes[1], m_filePos);
+                m_filePos += sizes[1];
+                continue;
+            }
+            m_frame.resize(sizes[0]);
+            vlSaveReadAt(m_filename, m_fd, m_frame.data(), sizes[0], m_filePos);
+            m_filePos += sizes[0];
+            const int got = LZ4_decompress_safe(m_frame.data(),
+                                                reinterpret_cast<char*>(m_frameRaw.data()),
+                                                static_cast<int>(sizes[0]),
+                                                static_cast<int>(sizes[1]));
+            if (VL_UNLIKELY(got != static_cast<int>(sizes[1]))) {
+                const std::string msg
+                    = std::string{"Can't deserialize; compressed save file is corrupt: "}
+                      + m_filename;
+                VL_FATAL_MT(m_filename.c_str(), 0, "", msg.c_str());
+                return;
+            }
+        }
+        const size_t size
+            = std::min<size_t>(m_frameRaw.size() - m_frameRawPos, bufEndp - m_endp);
+        std::memcpy(m_endp, m_frameRaw.data() + m_frameRawPos, size);
+        m_endp += size;
+        m_frameRawPos += size;
+    }
+    // At end, fill buffer with NULLs so reader's don't need to check eof each character.
+    while (m_endp < bufEndp) *m_endp++ = '\0';
+}
+
+void VerilatedRestore::readLarge(void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE {
+    uint8_t* dp = static_cast<uint8_t*>(datap);
+    // Take what is already buffered
+    const size_t buffered = std::min<size_t>(size, m_endp - m_cp);
+    std::memcpy(dp, m_cp, buffered);
+    m_cp += buffered;
+    dp += buffered;
+    size -= buffered;
+    if (!size) return;
+    if (!m_deltas.empty() || m_compressed) {  // Pages come from several files, or frames
+        read(dp, size);
+        return;
+    }
+    // Buffer is empty, so read the rest directly; a full save's file is the stream
+    uint64_t fileOffset = m_bufStreamPos + (m_cp - m_bufp);
+    m_bufStreamPos = fileOffset + size;
+    m_cp = m_endp = m_bufp;
+#if !defined(_WIN32) || defined(__MINGW32__) || defined(__CYGWIN__)
+    const uintptr_t pageSize = ::sysconf(_SC_PAGESIZE);
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(dp);
+    if (m_mmapArrays && (addr - fileOffset) % pageSize == 0) {
+        // Map whole pages copy-on-write over the array, read the partial pages
+        const uintptr_t firstPage = (addr + pageSize - 1) / pageSize * pageSize;
+        const uintptr_t lastPage = (addr + size) / pageSize * pageSize;
+        if (lastPage > firstPage
+            && ::mmap(reinterpret_cast<void*>(firstPage), lastPage - firstPage,
+                      PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, m_fd,
+                      static_cast<off_t>(fileOffset + (firstPage - addr)))
+                   != MAP_FAILED) {
+            if (firstPage > addr) {
+                vlSaveReadAt(m_filename, m_fd, dp, firstPage - addr, fileOffset);
+            }
+            const size_t head = lastPage - addr;
+            dp += head;
+            fileOffset += head;
+            size -= head;
+        }
+    }
+#endif
+    if (size) vlSaveReadAt(m_filename, m_fd, dp, size, fileOffset);
+    ::lseek(m_fd, static_cast<off_t>(m_bufStreamPos), SEEK_SET);
+}
+
 //=============================================================================
 // Serialization of types
 
@@ -27,6 +27,7 @@
 #include "verilated.h"
 
 #include <string>
+#include <vector>
 
 //=============================================================================
 // VerilatedSerialize
@@ -43,6 +44,7 @@ protected:
     // For speed, keep m_cp as the first member of this structure
     uint8_t* m_cp;  // Current pointer into m_bufp buffer
     uint8_t* m_bufp;  // Output buffer
+    uint64_t m_bufStreamPos = 0;  // Position in stream of m_bufp[0]
     bool m_isOpen = false;  // True indicates open file/stream
     std::string m_filename;  // Filename, for error messages
     VerilatedAssertOneThread m_assertOne;  // Assert only called from single thread
@@ -52,6 +54,7 @@ protected:
 
     void header() VL_MT_UNSAFE_ONE;
     void trailer() VL_MT_UNSAFE_ONE;
+    void writeAligned(const void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE;
 
     // CONSTRUCTORS
     VL_UNCOPYABLE(VerilatedSerialize);
@@ -89,6 +92,16 @@ public:
         }
         return *this;  // For function chaining
     }
+    /// Write contiguous array data to stream; large arrays are placed so
+    /// they may be memory mapped by VerilatedRestore
+    VerilatedSerialize& writeBulk(const void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE {
+        if (VL_LIKELY(size < bulkAlignSize())) return write(datap, size);
+        writeAligned(datap, size);
+        return *this;  // For function chaining
+    }
+    // Internal use:
+    // Arrays at least this large are page aligned by writeBulk
+    static constexpr size_t bulkAlignSize() { return 64 * 1024; }
 
 private:
     VerilatedSerialize& bufferCheck() VL_MT_UNSAFE_ONE {
@@ -115,6 +128,7 @@ protected:
     uint8_t* m_cp;  // Current pointer into m_bufp buffer
     uint8_t* m_bufp;  // Output buffer
     uint8_t* m_endp = nullptr;  // Last valid byte in m_bufp buffer
+    uint64_t m_bufStreamPos = 0;  // Position in stream of m_bufp[0]
     bool m_isOpen = false;  // True indicates open file/stream
     std::string m_filename;  // Filename, for error messages
     VerilatedAssertOneThread m_assertOne;  // Assert only called from single thread
@@ -123,6 +137,11 @@ protected:
     static constexpr size_t bufferInsertSize() { return 16 * 1024; }
 
     virtual void fill() = 0;
+    // Read a large page aligned array, may be overridden to avoid copying through the buffer
+    virtual void readLarge(void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE {
+        read(datap, size);
+    }
+    void readAligned(void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE;
     void header() VL_MT_UNSAFE_ONE;
     void trailer() VL_MT_UNSAFE_ONE;
 
@@ -163,6 +182,13 @@ public:
         return *this;  // For function chaining
     }
 
+    /// Read contiguous array data written by VerilatedSerialize::writeBulk
+    VerilatedDeserialize& readBulk(void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE {
+        if (VL_LIKELY(size < VerilatedSerialize::bulkAlignSize())) return read(datap, size);
+        readAligned(datap, size);
+        return *this;  // For function chaining
+    }
+
     // Internal use:
     // Read a datum and compare with expected value
     VerilatedDeserialize& readAssert(const void* __restrict datap, size_t size) VL_MT_UNSAFE_ONE;
@@ -188,18 +214,56 @@ private:
 
 class VerilatedSave final : public VerilatedSerialize {
 private:
+    struct Writer;  // Background compression and writing thread
     int m_fd = -1;  // File descriptor we're writing to
+    // Compressed or asynchronous saves
+    bool m_compress = false;  // Compress the file
+    bool m_async = false;  // Write the file from a background thread
+    Writer* m_writerp = nullptr;  // Writer thread, when open and compressing or async
+    uint8_t* m_spareBufp = nullptr;  // Buffer being written while m_bufp is filled
+    // Incremental saves
+    size_t m_incrMaxDeltas = 0;  // Deltas per chain, 0 = incremental saves off
+    std::vector<uint64_t> m_pageHashes;  // Hash of each page of previous save's stream
+    std::vector<std::string> m_chainFilenames;  // Files of current chain, full save first
+    uint64_t m_chainFileSize = 0;  // Size of last file in chain
+    bool m_incrOpen = false;  // Processing stream by pages
+    bool m_delta = false;  // Writing a delta file
+    uint64_t m_streamSize = 0;  // Bytes of stream processed so far
+    uint64_t m_fileSize = 0;  // Bytes written to file so far
+    std::vector<uint64_t> m_deltaPages;  // Pages written to delta file
 
     void closeImp() VL_MT_UNSAFE_ONE;
     void flushImp() VL_MT_UNSAFE_ONE;
+    void flushPages(bool last) VL_MT_UNSAFE_ONE;
+    void writeFd(const void* datap, size_t size) VL_MT_UNSAFE_ONE;
+    void writeError(int err) VL_MT_UNSAFE_ONE;
 
 public:
     // CONSTRUCTORS
     /// Construct new object
     VerilatedSave() = default;
     /// Flush, close and destruct
-    ~VerilatedSave() override { closeImp(); }
+    ~VerilatedSave() override {
+        closeImp();
+        if (m_spareBufp) VL_DO_CLEAR(delete[] m_spareBufp, m_spareBufp = nullptr);
+    }
     // METHODS
+    /// Enable incremental saves. Following a full save, the next 'maxDeltas'
+    /// saves made with this object each write only the pages of state that
+    /// changed since the previous save, along with the name of the previous
+    /// save's file, which must be kept. VerilatedRestore follows the chain.
+    void incremental(size_t maxDeltas) VL_MT_UNSAFE_ONE { m_incrMaxDeltas = maxDeltas; }
+    /// Make the next save a full save
+    void incrementalReset() VL_MT_UNSAFE_ONE { m_chainFilenames.clear(); }
+    /// Compress files opened after this call with LZ4. Compression and
+    /// writing are done on a background thread, while the next part of the
+    /// state is serialized. Incremental saves are not compressed.
+    void compress(bool flag) VL_MT_UNSAFE_ONE { m_compress = flag; }
+    /// Write files opened after this call from a background thread, while
+    /// the next part of the state is serialized, so the saving thread only
+    /// waits for the disk when it falls a whole buffer behind, and at close.
+    /// Incremental saves are written directly.
+    void async(bool flag) VL_MT_UNSAFE_ONE { m_async = flag; }
     /// Open the file; call isOpen() to see if errors
     void open(const char* filenamep) VL_MT_UNSAFE_ONE;
     /// Open the file; call isOpen() to see if errors
@@ -219,8 +283,32 @@ public:
 class VerilatedRestore final : public VerilatedDeserialize {
 private:
     int m_fd = -1;  // File descriptor we're writing to
+    // Restoring from an incremental save
+    struct Delta final {
+        int m_fd;  // File descriptor of delta file
+        uint64_t m_dataOffset;  // File offset of first page
+        uint64_t m_parentSize;  // Expected size of parent file
+        uint64_t m_streamSize;  // Size of stream as of this delta
+        std::vector<uint64_t> m_pages;  // Page number of each page in file, sorted
+        size_t m_cursor = 0;  // Index into m_pages of next page needed
+    };
+    std::vector<Delta> m_deltas;  // Deltas, newest first; m_fd is the full save
+    uint64_t m_streamSize = 0;  // Size of stream being restored
+    uint64_t m_streamPos = 0;  // Bytes of stream read so far
+    bool m_mmapArrays = false;  // Map large arrays from the file
+    // Restoring from a compressed save
+    bool m_compressed = false;  // File is compressed
+    uint64_t m_filePos = 0;  // File offset of next frame
+    uint64_t m_fileEnd = 0;  // File size
+    std::vector<char> m_frame;  // Compressed frame being decoded
+    std::vector<uint8_t> m_frameRaw;  // Decompressed frame
+    size_t m_frameRawPos = 0;  // Bytes of m_frameRaw already moved to m_bufp
 
     void closeImp() VL_MT_UNSAFE_ONE;
+    bool openDelta(const std::string& filename, std::string& parent) VL_MT_UNSAFE_ONE;
+    void fillDelta() VL_MT_UNSAFE_ONE;
+    void fillCompressed() VL_MT_UNSAFE_ONE;
+    void readLarge(void* __restrict datap, size_t size) override VL_MT_UNSAFE_ONE;
     void flushImp() VL_MT_UNSAFE_ONE {}
 
 public:
@@ -231,6 +319,10 @@ public:
     ~VerilatedRestore() override { closeImp(); }
 
     // METHODS
+    /// Restore large arrays by mapping them copy-on-write from the file where
+    /// possible, rather than reading them. The file must then not be modified
+    /// while the restored model is in use.
+    void mmapArrays(bool flag) VL_MT_UNSAFE_ONE { m_mmapArrays = flag; }
     /// Open the file; call isOpen() to see if errors
     void open(const char* filenamep) VL_MT_UNSAFE_ONE;
     /// Open the file; call isOpen() to see if errors
@@ -300,8 +392,47 @@ inline VerilatedDeserialize& operator>>(VerilatedDeserialize& os, std::string& r
 VerilatedSerialize& operator<<(VerilatedSerialize& os, VerilatedContext* rhsp);
 VerilatedDeserialize& operator>>(VerilatedDeserialize& os, VerilatedContext* rhsp);
 
-template <class T_Key, class T_Value>
-VerilatedSerialize& operator<<(VerilatedSerialize& os, VlAssocArray<T_Key, T_Value>& rhs) {
+template <std::size_t T_Words>
+VerilatedSerialize& operator<<(VerilatedSerialize& os, const VlWide<T_Words>& rhs) {
+    return os.write(rhs.data(), sizeof(EData) * T_Words);
+}
+template <std::size_t T_Words>
+VerilatedDeserialize& operator>>(VerilatedDeserialize& os, VlWide<T_Words>& rhs) {
+    return os.read(rhs.data(), sizeof(EData) * T_Words);
+}
+
+template <class T_Value, std::size_t T_Depth>
+VerilatedSerialize& operator<<(VerilatedSerialize& os, VlSparseArray<T_Value, T_Depth>& rhs) {
+    // Only pages that were written
+    const uint32_t len = rhs.pagesUsed();
+    os << len;
+    for (size_t p = 0; p < rhs.pageSlots(); ++p) {
+        const auto* const pagep = rhs.pageLookup(p);
+        if (!pagep) continue;
+        const uint32_t index = p;
+        os << index;
+        for (const auto& item : *pagep) {
+            T_Value value = item;  // Copy to get around const
+            os << value;
+        }
+    }
+    return os;
+}
+template <class T_Value, std::size_t T_Depth>
+VerilatedDeserialize& operator>>(VerilatedDeserialize& os, VlSparseArray<T_Value, T_Depth>& rhs) {
+    uint32_t len = 0;
+    os >> len;
+    rhs.clear();
+    for (uint32_t i = 0; i < len; ++i) {
+        uint32_t index = 0;
+        os >> index;
+        for (auto& item : rhs.page(index)) os >> item;
+    }
+    return os;
+}
+template <class T_Key, class T_Value, bool T_Ordered>
+VerilatedSerialize& operator<<(VerilatedSerialize& os,
+                               VlAssocArray<T_Key, T_Value, T_Ordered>& rhs) {
     os << rhs.atDefault();
     const uint32_t len = rhs.size();
     os << len;
@@ -312,8 +443,9 @@ VerilatedSerialize& operator<<(VerilatedSerialize& os, VlAssocArray<T_Key, T_Val
     }
     return os;
 }
-template <class T_Key, class T_Value>
-VerilatedDeserialize& operator>>(VerilatedDeserialize& os, VlAssocArray<T_Key, T_Value>& rhs) {
+template <class T_Key, class T_Value, bool T_Ordered>
+VerilatedDeserialize& operator>>(VerilatedDeserialize& os,
+                                 VlAssocArray<T_Key, T_Value, T_Ordered>& rhs) {
     os >> rhs.atDefault();
     uint32_t len = 0;
     os >> len;
@@ -42,11 +42,36 @@ public:
     static const uint32_t* sp_datap(const sc_dt::sc_bv_base& base) VL_MT_SAFE {
         return static_cast<const VlScBvExposer*>(&base)->sp_datatp();
     }
+    static uint32_t* sp_datap(sc_dt::sc_bv_base& base) VL_MT_SAFE {
+        return static_cast<VlScBvExposer*>(&base)->sp_datatp();
+    }
     const uint32_t* sp_datatp() const { return reinterpret_cast<uint32_t*>(m_data); }
+    uint32_t* sp_datatp() { return reinterpret_cast<uint32_t*>(m_data); }
     // Above reads this protected element in sc_bv_base:
     //   sc_digit* m_data; // data array
 };
 
+//=============================================================================
+// For \internal use, copy between a sc_bv port and a VlWide a whole vector
+// at once, rather than a word at a time.  Used by --sc-sync-ports.
+#define VL_SC_BV_READ(obits, owp, svar) \
+    { \
+        std::memcpy((owp).data(), VL_SC_BV_DATAP((svar).read()), \
+                    VL_WORDS_I(obits) * sizeof(EData)); \
+        (owp)[VL_WORDS_I(obits) - 1] &= VL_MASK_E(obits); \
+    }
+// Only writes the port when the value changed, as constructing the sc_bv is costly
+#define VL_SC_BV_WRITE(obits, svar, rwp) \
+    { \
+        if (std::memcmp(VL_SC_BV_DATAP((svar).read()), (rwp).data(), \
+                        VL_WORDS_I(obits) * sizeof(EData))) { \
+            sc_dt::sc_bv<(obits)> _bvtemp; \
+            std::memcpy(VlScBvExposer::sp_datap(_bvtemp), (rwp).data(), \
+                        VL_WORDS_I(obits) * sizeof(EData)); \
+            (svar).write(_bvtemp); \
+        } \
+    }
+
 //=========================================================================
 
 #endif  // Guard
@@ -145,6 +145,8 @@ public:
     bool isPublicRW() const { return ((m_vlflags & VLVF_PUB_RW) != 0); }
     // DPI compatible C standard layout
     bool isDpiCLayout() const { return ((m_vlflags & VLVF_DPI_CLAY) != 0); }
+    // Writes call VerilatedVpi::valueHook (--vpi-hooks)
+    bool isVpiHooked() const { return ((m_vlflags & VLVF_VPI_HOOK) != 0); }
     int udims() const VL_MT_SAFE { return m_udims; }
     int dims() const { return m_pdims + m_udims; }
     const VerilatedRange& packed() const VL_MT_SAFE { return m_packed; }
@@ -25,10 +25,21 @@
 
 #include "verilated_threads.h"
 
+#include <climits>
 #include <cstdio>
 #include <memory>
 #include <string>
 
+// clang-format off
+#if defined(__linux)
+# include <linux/futex.h>
+# include <linux/mempolicy.h>
+# include <pthread.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+// clang-format on
+
 //=============================================================================
 // Globals
 
@@ -36,6 +47,26 @@
 
 std::atomic<uint64_t> VlMTaskVertex::s_yields;
 
+thread_local VlMTaskDeque* VlThreadPool::t_dequep = nullptr;
+thread_local VlThreadPool::Lease VlThreadPool::t_lease;
+thread_local VlThreadWaiter* VlThreadWaiter::t_waiterp = nullptr;
+constexpr unsigned VlThreadWaiter::SPINS_MIN;
+
+//=============================================================================
+// VlThreadWaiter
+
+VlThreadWaiter& VlThreadWaiter::current() {
+    // Threads not in a thread pool (i.e. the main thread) use their thread's context
+    static thread_local VlThreadWaiter t_mainWaiter{nullptr};
+    return t_waiterp ? *t_waiterp : t_mainWaiter;
+}
+
+int VlThreadWaiter::policy() const {
+    const VerilatedContext* const contextp
+        = m_contextp ? m_contextp : Verilated::threadContextp();
+    return contextp ? contextp->threadsWait() : WAIT_SPIN;
+}
+
 //=============================================================================
 // VlMTaskVertex
 
@@ -45,12 +76,67 @@ VlMTaskVertex::VlMTaskVertex(uint32_t upstreamDepCount)
     assert(atomic_is_lock_free(&m_upstreamDepsDone));
 }
 
+void VlMTaskVertex::waitSlow(bool evenCycle) const {
+    VlThreadWaiter& waiter = VlThreadWaiter::current();
+    const uint64_t startNs = VlThreadWaiter::nowNs();
+    if (waiter.policy() == VlThreadWaiter::WAIT_SPIN) {
+        unsigned ct = 0;
+        unsigned spins = 0;  // Total, saturating
+        while (VL_UNLIKELY(!areUpstreamDepsDone(evenCycle))) {
+            VL_CPU_RELAX();
+            ++ct;
+            if (VL_LIKELY(spins != UINT_MAX)) ++spins;
+            if (VL_UNLIKELY(ct > VL_LOCK_SPINS)) {
+                ct = 0;
+                yieldThread();
+            }
+        }
+        waiter.spun(spins, VlThreadWaiter::nowNs() - startNs);
+        return;
+    }
+    // Spin, then park
+    const unsigned budget = waiter.spinBudget();
+    for (unsigned i = 0; i < budget; ++i) {
+        if (areUpstreamDepsDone(evenCycle)) {
+            waiter.spun(i, VlThreadWaiter::nowNs() - startNs);
+            return;
+        }
+        VL_CPU_RELAX();
+    }
+    const uint64_t parkStartNs = VlThreadWaiter::nowNs();
+    m_parked.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in signalUpstreamDone
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (true) {
+        const uint32_t value = m_upstreamDepsDone.load(std::memory_order_acquire);
+        if (value == (evenCycle ? m_upstreamDepCount : 0)) break;
+#if defined(__linux)
+        // Sleeps only if the value is still unchanged
+        syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&m_upstreamDepsDone),
+                FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+#else
+        yieldThread();
+#endif
+    }
+    m_parked.fetch_sub(1, std::memory_order_relaxed);
+    const uint64_t endNs = VlThreadWaiter::nowNs();
+    waiter.parked(parkStartNs - startNs, endNs - parkStartNs);
+}
+
+void VlMTaskVertex::wakeParked() const {
+#if defined(__linux)
+    syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&m_upstreamDepsDone), FUTEX_WAKE_PRIVATE,
+            INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
 //=============================================================================
 // VlWorkerThread
 
-VlWorkerThread::VlWorkerThread(VerilatedContext* contextp)
+VlWorkerThread::VlWorkerThread(VerilatedContext* contextp, unsigned index, int cpu)
     : m_ready_size{0}
-    , m_cthread{startWorker, this, contextp} {}
+    , m_waiter{contextp}
+    , m_cthread{startWorker, this, contextp, index, cpu} {}
 
 VlWorkerThread::~VlWorkerThread() {
     shutdown();
@@ -85,25 +171,353 @@ void VlWorkerThread::workerLoop() {
 
     while (true) {
         if (VL_UNLIKELY(work.m_fnp == shutdownTask)) break;
+        const uint64_t startNs = VlThreadWaiter::nowNs();
+        const uint64_t waitedNs = m_waiter.waitNs();
         work.m_fnp(work.m_selfp, work.m_evenCycle);
+        // Waits on other threads within the task are not work
+        m_waiter.worked(VlThreadWaiter::nowNs() - startNs - (m_waiter.waitNs() - waitedNs));
         // Wait for next task with spinning.
         dequeWork</* SpinWait: */ true>(&work);
     }
 }
 
-void VlWorkerThread::startWorker(VlWorkerThread* workerp, VerilatedContext* contextp) {
+int VlWorkerThread::numaNode() const {
+    while (m_numaNode.load(std::memory_order_acquire) == -2) std::this_thread::yield();
+    return m_numaNode.load(std::memory_order_relaxed);
+}
+
+void VlWorkerThread::startWorker(VlWorkerThread* workerp, VerilatedContext* contextp,
+                                 unsigned index, int cpu) {
+    workerp->m_numaNode.store(VlThreadPool::pinCurrentThread(cpu), std::memory_order_release);
     Verilated::threadContextp(contextp);
+    Verilated::threadIndex(index);
+    workerp->m_waiter.makeCurrent();
     workerp->workerLoop();
 }
 
 //=============================================================================
 // VlThreadPool
 
-VlThreadPool::VlThreadPool(VerilatedContext* contextp, unsigned nThreads) {
-    for (unsigned i = 0; i < nThreads; ++i) m_workers.push_back(new VlWorkerThread{contextp});
+VlThreadPool::VlThreadPool(VerilatedContext* contextp, unsigned nThreads)
+    : m_shared{!contextp} {
+    // A shared pool's threads are used by every context, so are not pinned
+    m_pinned = contextp && !contextp->threadsAffinity().empty();
+    m_evalNumaNode = pinCurrentThread(cpuFor(contextp, 0));
+    for (unsigned i = 0; i < nThreads; ++i) {
+        m_workers.push_back(new VlWorkerThread{contextp, i + 1, cpuFor(contextp, i + 1)});
+    }
+    for (unsigned i = 0; i <= nThreads; ++i) m_deques.push_back(new VlMTaskDeque);
+    const VerilatedLockGuard lock{m_leaseMutex};
+    m_leased.assign(nThreads, false);
+    m_nFree = nThreads;
+}
+
+int VlThreadPool::cpuFor(VerilatedContext* contextp, unsigned index) const {
+    // The calling thread takes the first CPU, the workers the following ones
+    if (!m_pinned) return -1;
+    const std::vector<unsigned>& cpus = contextp->threadsAffinity();
+    return static_cast<int>(cpus[index % cpus.size()]);
+}
+
+static VerilatedMutex& sharedPoolMutex() {
+    static VerilatedMutex s_mutex;
+    return s_mutex;
+}
+static VlThreadPool*& sharedPoolp() {
+    static VlThreadPool* s_poolp = nullptr;
+    return s_poolp;
+}
+static unsigned& sharedPoolRefs() {
+    static unsigned s_refs = 0;
+    return s_refs;
+}
+
+VlThreadPool* VlThreadPool::sharedAcquire(unsigned nThreads) {
+    const VerilatedLockGuard lock{sharedPoolMutex()};
+    VlThreadPool*& poolpr = sharedPoolp();
+    if (!poolpr) {
+        // One worker per hardware thread besides the eval thread; the eval
+        // threads of the contexts sharing the pool take turns on that CPU
+        const unsigned hardware = std::thread::hardware_concurrency();
+        poolpr = new VlThreadPool{nullptr, std::max(hardware ? hardware - 1 : 0, nThreads)};
+    }
+    if (poolpr->numThreads() < static_cast<int>(nThreads)) return nullptr;
+    ++sharedPoolRefs();
+    return poolpr;
+}
+
+void VlThreadPool::sharedRelease(const VerilatedContext* contextp) {
+    const VerilatedLockGuard lock{sharedPoolMutex()};
+    VlThreadPool*& poolpr = sharedPoolp();
+    {
+        const VerilatedLockGuard leaseLock{poolpr->m_leaseMutex};
+        poolpr->m_usageNs.erase(contextp);
+    }
+    if (--sharedPoolRefs()) return;
+    delete poolpr;
+    poolpr = nullptr;
+}
+
+bool VlThreadPool::leaseGrantable(uint64_t seq, unsigned nWorkers) const {
+    if (m_nFree < nWorkers) return false;
+    // Only the waiter that has used least may take workers, so contexts
+    // needing many workers are not starved by ones needing few
+    uint64_t bestSeq = seq;
+    uint64_t bestNs = ~0ULL;
+    for (const auto& it : m_leaseWaiters) {
+        const uint64_t ns = m_usageNs.at(it.second);
+        if (ns < bestNs) {
+            bestNs = ns;
+            bestSeq = it.first;
+        }
+    }
+    return bestSeq == seq;
+}
+
+void VlThreadPool::leaseSlow(unsigned nWorkers) {
+    Lease& lease = t_lease;
+    lease.m_contextp = Verilated::threadContextp();
+    {
+        VerilatedLockGuard lock{m_leaseMutex};
+        if (m_usageNs.find(lease.m_contextp) == m_usageNs.end()) {
+            // A new context starts level with the least used one, rather than
+            // being owed all the time used before it started
+            uint64_t leastNs = m_usageNs.empty() ? 0 : ~0ULL;
+            for (const auto& it : m_usageNs) leastNs = std::min(leastNs, it.second);
+            m_usageNs.emplace(lease.m_contextp, leastNs);
+        }
+        const uint64_t seq = m_leaseSeq++;
+        m_leaseWaiters.emplace(seq, lease.m_contextp);
+        while (!leaseGrantable(seq, nWorkers)) m_leaseCv.wait(m_leaseMutex);
+        m_leaseWaiters.erase(seq);
+        lease.m_workers.clear();
+        for (unsigned i = 0; lease.m_workers.size() < nWorkers; ++i) {
+            if (m_leased[i]) continue;
+            m_leased[i] = true;
+            lease.m_workers.push_back(i);
+        }
+        m_nFree -= nWorkers;
+        // The next waiter may fit in the workers that are left
+        if (m_nFree && !m_leaseWaiters.empty()) m_leaseCv.notify_all();
+    }
+    lease.m_startNs = VlThreadWaiter::nowNs();
+    // The graph's tasks use the context of the thread they run on
+    for (const unsigned index : lease.m_workers) {
+        m_workers[index]->addTask(setContextTask,
+                                  const_cast<VerilatedContext*>(lease.m_contextp));
+    }
+}
+
+void VlThreadPool::unleaseSlow() {
+    Lease& lease = t_lease;
+    const uint64_t usedNs = (VlThreadWaiter::nowNs() - lease.m_startNs) * lease.m_workers.size();
+    {
+        const VerilatedLockGuard lock{m_leaseMutex};
+        for (const unsigned index : lease.m_workers) m_leased[index] = false;
+        m_nFree += lease.m_workers.size();
+        m_usageNs[lease.m_contextp] += usedNs;
+    }
+    lease.m_workers.clear();
+    m_leaseCv.notify_all();
+}
+
+void VlThreadPool::setContextTask(VlSelfP contextp, bool) {
+    Verilated::threadContextp(static_cast<VerilatedContext*>(contextp));
+}
+
+void VlThreadPool::restartAfterFork(VerilatedContext* contextp) {
+    // Only the thread that called fork() exists in the child. The old worker
+    // records refer to threads that are gone, and to mutex and condition
+    // variable state copied mid-use, so they can be neither joined nor
+    // destroyed; leak them and start a fresh set of workers.
+    if (m_shared) contextp = nullptr;
+    for (unsigned i = 0; i < m_workers.size(); ++i) {
+        m_workers[i] = new VlWorkerThread{contextp, i + 1, cpuFor(contextp, i + 1)};
+    }
+}
+
+int VlThreadPool::pinCurrentThread(int cpu) {
+#if defined(__linux)
+    if (cpu >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu, &cpuset);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset)) {
+            VL_PRINTF_MT("%%Warning: Cannot set simulation thread affinity to CPU %d\n", cpu);
+        }
+    }
+    unsigned cpuNum = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpuNum, &node, nullptr) == 0) return static_cast<int>(node);
+#endif
+    return -1;
+}
+
+void VlThreadPool::placeOnThread(int threadId, const void* datap, size_t size) {
+    if (!m_pinned || !size) return;
+    if (threadId >= static_cast<int>(m_workers.size())) return;
+    const int node = threadId < 0 ? m_evalNumaNode : m_workers[threadId]->numaNode();
+    if (node < 0) return;
+#if defined(__linux)
+    static const uintptr_t s_pageSize = sysconf(_SC_PAGESIZE);
+#else
+    static const uintptr_t s_pageSize = 4096;
+#endif
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(datap) & ~(s_pageSize - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(datap) + size;
+    for (uintptr_t page = begin; page < end; page += s_pageSize) m_placePages[page] = node;
+}
+
+void VlThreadPool::placeCommit() {
+#if defined(__linux)
+    std::vector<void*> pages;
+    std::vector<int> nodes;
+    bool anyRemote = false;
+    for (const auto& it : m_placePages) {
+        pages.push_back(reinterpret_cast<void*>(it.first));
+        nodes.push_back(it.second);
+        anyRemote |= it.second != m_evalNumaNode;
+    }
+    // The model was constructed, and hence first touched, by the eval thread
+    if (anyRemote) {
+        std::vector<int> status(pages.size());
+        syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(),
+                MPOL_MF_MOVE);
+    }
+#endif
+    m_placePages.clear();
 }
 
 VlThreadPool::~VlThreadPool() {
     // Each ~WorkerThread will wait for its thread to exit.
     for (auto& i : m_workers) delete i;
+    for (auto& i : m_deques) delete i;
+}
+
+void VlThreadPool::statsDump() const {
+    VL_PRINTF_MT("Thread pool statistics (ms):\n");
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        const VlThreadWaiter& waiter = m_workers[i]->waiter();
+        VL_PRINTF_MT("  Worker %2zu: working %10.3f  spinning %10.3f  parked %10.3f\n", i,
+                     waiter.workNs() / 1e6, waiter.spinNs() / 1e6, waiter.parkNs() / 1e6);
+    }
+}
+
+uint64_t VlThreadPool::waitNs() const {
+    uint64_t ns = 0;
+    for (const VlWorkerThread* const workerp : m_workers) ns += workerp->waiter().waitNs();
+    return ns;
+}
+
+void VlThreadPool::executeDynamic(VlSelfP selfp, bool evenCycle,
+                                  const VlMTaskVertex& finalVertex,
+                                  std::initializer_list<VlExecFnp> roots) {
+    // Any worker may steal any MTask, so a shared pool is leased whole
+    lease(m_workers.size());
+    m_dynSelfp = selfp;
+    m_dynEvenCycle = evenCycle;
+    m_dynFinalp = &finalVertex;
+    m_dynClaimed.store(0, std::memory_order_relaxed);
+    m_dynActive.store(m_workers.size(), std::memory_order_relaxed);
+    // The calling thread owns the last deque; seed it with the root MTasks
+    VlMTaskDeque* const ownp = m_deques.back();
+    VlMTaskDeque* const prevp = t_dequep;
+    t_dequep = ownp;
+    for (VlExecFnp fnp : roots) pushTask(fnp);
+    // Enlist every worker, they will steal from us (and each other)
+    for (VlWorkerThread* const workerp : m_workers) workerp->addTask(stealTask, this);
+    stealLoop(ownp);
+    t_dequep = prevp;
+    // Do not return until all workers have left, as the graph state is reused by the next call
+    unsigned ct = 0;
+    while (m_dynActive.load(std::memory_order_acquire)) {
+        VL_CPU_RELAX();
+        if (VL_UNLIKELY(++ct > VL_LOCK_SPINS)) {
+            ct = 0;
+            VlMTaskVertex::yieldThread();
+        }
+    }
+    unlease();
+}
+
+void VlThreadPool::stealTask(VlSelfP poolp, bool) {
+    VlThreadPool* const selfp = static_cast<VlThreadPool*>(poolp);
+    const unsigned index = selfp->m_dynClaimed.fetch_add(1, std::memory_order_relaxed);
+    t_dequep = selfp->m_deques[index];
+    selfp->stealLoop(t_dequep);
+    t_dequep = nullptr;
+    selfp->m_dynActive.fetch_sub(1, std::memory_order_release);
+}
+
+void VlThreadPool::stealLoop(VlMTaskDeque* ownp) {
+    const size_t nDeques = m_deques.size();
+    // Start stealing just after our own deque, to spread out the thieves
+    size_t victim = 0;
+    while (m_deques[victim] != ownp) ++victim;
+    unsigned ct = 0;
+    while (!m_dynFinalp->areUpstreamDepsDone(m_dynEvenCycle)) {
+        VlExecFnp fnp = ownp->pop();
+        for (size_t n = 1; !fnp && n < nDeques; ++n) {
+            if (++victim == nDeques) victim = 0;
+            if (m_deques[victim] != ownp) fnp = m_deques[victim]->steal();
+        }
+        if (fnp) {
+            ct = 0;
+            fnp(m_dynSelfp, m_dynEvenCycle);
+            continue;
+        }
+        // Nothing ready anywhere, some other thread is still busy
+        VL_CPU_RELAX();
+        if (VL_UNLIKELY(++ct > VL_LOCK_SPINS)) {
+            ct = 0;
+            VlMTaskVertex::yieldThread();
+        }
+    }
+}
+
+//=============================================================================
+// VlScheduleSelector
+
+unsigned VlScheduleSelector::best() const {
+    return std::min_element(m_trialNs.begin(), m_trialNs.end()) - m_trialNs.begin();
+}
+
+void VlScheduleSelector::restart(uint64_t trial, unsigned nSchedules) {
+    m_trialNs.assign(nSchedules, 0);
+    // Keep the cycle flags, the MTask state of each schedule depends on them
+    m_evenCycle.resize(nSchedules, false);
+    m_current = 0;
+    m_trial = trial;
+    m_evals = 0;
+}
+
+void VlScheduleSelector::trial(unsigned nSchedules) {
+    if (m_evals < m_trial * nSchedules) {
+        // Time schedules in turn
+        m_current = m_evals / m_trial;
+        if (m_evals % m_trial == 0) m_trialNs[m_current] = 0;
+        m_startNs = VlThreadWaiter::nowNs();
+    } else {
+        // Trials done, use the fastest until the next trials
+        m_current = best();
+    }
+}
+
+//=============================================================================
+// VlMTaskGuard
+
+bool VlMTaskGuard::update(std::vector<uint8_t>& saved, std::initializer_list<Region> regions) {
+    size_t size = 0;
+    for (const Region& region : regions) size += region.m_size;
+    bool changed = saved.size() != size;
+    if (VL_UNLIKELY(changed)) saved.resize(size);
+    uint8_t* savedp = saved.data();
+    for (const Region& region : regions) {
+        if (changed || std::memcmp(savedp, region.m_datap, region.m_size)) {
+            std::memcpy(savedp, region.m_datap, region.m_size);
+            changed = true;
+        }
+        savedp += region.m_size;
+    }
+    return changed;
 }
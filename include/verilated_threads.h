@@ -27,8 +27,12 @@
 
 #include "verilated.h"  // for VerilatedMutex and clang annotations
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <initializer_list>
+#include <map>
 #include <set>
 #include <thread>
 #include <vector>
@@ -52,6 +56,74 @@ using VlSelfP = void*;
 
 using VlExecFnp = void (*)(VlSelfP, bool);
 
+//=============================================================================
+// VlThreadWaiter - per-thread wait policy state and statistics
+//
+// Implements the policy selected by VerilatedContext::threadsWait for a
+// thread waiting on another thread. With the adaptive policy, the spin
+// budget follows the recent wait lengths: waits that complete while
+// spinning make the budget track twice their average length, waits that
+// had to park halve it.
+
+class VlThreadWaiter final {
+public:
+    // CONSTANTS
+    enum : int { WAIT_SPIN = 0, WAIT_PARK = 1, WAIT_ADAPTIVE = 2 };
+    static constexpr unsigned SPINS_MIN = 64;  // Adaptive spin budget lower bound
+
+private:
+    // MEMBERS
+    VerilatedContext* const m_contextp;  // Context with the policy, nullptr = thread's context
+    unsigned m_spinBudget = VL_LOCK_SPINS;  // Current adaptive spin budget
+    unsigned m_spinAvg = VL_LOCK_SPINS / 2;  // Moving average of successful spin lengths
+    // Statistics, written by the owning thread only, read by statsDump
+    std::atomic<uint64_t> m_spinNs{0};  // Time spent spinning
+    std::atomic<uint64_t> m_parkNs{0};  // Time spent parked
+    std::atomic<uint64_t> m_workNs{0};  // Time spent executing tasks, excluding waits
+    static thread_local VlThreadWaiter* t_waiterp;  // Waiter of the current thread
+
+    VL_UNCOPYABLE(VlThreadWaiter);
+
+public:
+    // CONSTRUCTORS
+    explicit VlThreadWaiter(VerilatedContext* contextp)
+        : m_contextp{contextp} {}
+    ~VlThreadWaiter() = default;
+
+    // METHODS
+    // Return the waiter of the calling thread
+    static VlThreadWaiter& current();
+    // Make this the current thread's waiter
+    void makeCurrent() { t_waiterp = this; }
+    int policy() const;
+    // Number of spins to perform before parking
+    unsigned spinBudget() const {
+        return policy() == WAIT_ADAPTIVE ? m_spinBudget : VL_LOCK_SPINS;
+    }
+    // Record a wait that completed after 'spins' spins, without parking
+    void spun(unsigned spins, uint64_t ns) {
+        m_spinAvg = static_cast<unsigned>((static_cast<uint64_t>(m_spinAvg) * 7 + spins) / 8);
+        m_spinBudget = std::min<unsigned>(VL_LOCK_SPINS, std::max(SPINS_MIN, 2 * m_spinAvg));
+        m_spinNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+    // Record a wait that used up the spin budget, then parked
+    void parked(uint64_t spinNs, uint64_t parkNs) {
+        m_spinBudget = std::max(SPINS_MIN, m_spinBudget / 2);
+        m_spinNs.fetch_add(spinNs, std::memory_order_relaxed);
+        m_parkNs.fetch_add(parkNs, std::memory_order_relaxed);
+    }
+    void worked(uint64_t ns) { m_workNs.fetch_add(ns, std::memory_order_relaxed); }
+    uint64_t spinNs() const { return m_spinNs.load(std::memory_order_relaxed); }
+    uint64_t parkNs() const { return m_parkNs.load(std::memory_order_relaxed); }
+    uint64_t waitNs() const { return spinNs() + parkNs(); }
+    uint64_t workNs() const { return m_workNs.load(std::memory_order_relaxed); }
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+};
+
 // Track dependencies for a single MTask.
 class VlMTaskVertex final {
     // MEMBERS
@@ -75,6 +147,8 @@ class VlMTaskVertex final {
     // use 16-bit types here...)
     std::atomic<uint32_t> m_upstreamDepsDone;
     const uint32_t m_upstreamDepCount;
+    // Number of threads parked in waitUntilUpstreamDone, which must be woken
+    mutable std::atomic<uint32_t> m_parked{0};
 
 public:
     // CONSTRUCTORS
@@ -99,29 +173,216 @@ public:
             const uint32_t upstreamDepsDone
                 = 1 + m_upstreamDepsDone.fetch_add(1, std::memory_order_release);
             assert(upstreamDepsDone <= m_upstreamDepCount);
-            return (upstreamDepsDone == m_upstreamDepCount);
+            if (upstreamDepsDone != m_upstreamDepCount) return false;
         } else {
             const uint32_t upstreamDepsDone_prev
                 = m_upstreamDepsDone.fetch_sub(1, std::memory_order_release);
             assert(upstreamDepsDone_prev > 0);
-            return (upstreamDepsDone_prev == 1);
+            if (upstreamDepsDone_prev != 1) return false;
         }
+        // Pairs with the fence in waitSlow
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (VL_UNLIKELY(m_parked.load(std::memory_order_relaxed))) wakeParked();
+        return true;
     }
     bool areUpstreamDepsDone(bool evenCycle) const {
         const uint32_t target = evenCycle ? m_upstreamDepCount : 0;
         return m_upstreamDepsDone.load(std::memory_order_acquire) == target;
     }
     void waitUntilUpstreamDone(bool evenCycle) const {
-        unsigned ct = 0;
-        while (VL_UNLIKELY(!areUpstreamDepsDone(evenCycle))) {
-            VL_CPU_RELAX();
-            ++ct;
-            if (VL_UNLIKELY(ct > VL_LOCK_SPINS)) {
-                ct = 0;
-                yieldThread();
+        if (VL_UNLIKELY(!areUpstreamDepsDone(evenCycle))) waitSlow(evenCycle);
+    }
+
+private:
+    void waitSlow(bool evenCycle) const;
+    void wakeParked() const;
+};
+
+//=============================================================================
+// VlMTaskDeque - bounded work-stealing deque of ready MTasks
+//
+// Used by the dynamic (work-stealing) MTask scheduler, see --threads-dynamic.
+// This is the Chase-Lev deque: the owning thread pushes and pops at the
+// bottom, any other thread may steal from the top. The self pointer and
+// even/odd cycle flag are shared by all MTasks in a graph execution and are
+// held by the VlThreadPool, so only the function pointer is stored here.
+
+class VlMTaskDeque final {
+    // CONSTANTS
+    static constexpr int64_t CAPACITY = 1024;  // Must be power of 2
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be power of 2");
+
+    // MEMBERS
+    alignas(VL_CACHE_LINE_BYTES) std::atomic<int64_t> m_top{0};  // Steal end
+    alignas(VL_CACHE_LINE_BYTES) std::atomic<int64_t> m_bottom{0};  // Owner end
+    std::atomic<VlExecFnp> m_tasks[CAPACITY];
+
+    VL_UNCOPYABLE(VlMTaskDeque);
+
+public:
+    // CONSTRUCTORS
+    VlMTaskDeque() = default;
+    ~VlMTaskDeque() = default;
+
+    // METHODS
+    // Owner only. Returns false if full, in which case the caller should run the task itself.
+    bool push(VlExecFnp fnp) {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_acquire);
+        if (VL_UNLIKELY(b - t >= CAPACITY)) return false;
+        m_tasks[b & (CAPACITY - 1)].store(fnp, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+    // Owner only. Returns nullptr if empty.
+    VlExecFnp pop() {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        if (t > b) {  // Empty
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        VlExecFnp fnp = m_tasks[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {  // Last element, race against thieves
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+                fnp = nullptr;  // Lost race
             }
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return fnp;
+    }
+    // Any thread. Returns nullptr if empty or lost a race.
+    VlExecFnp steal() {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        VlExecFnp const fnp = m_tasks[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return fnp;
+    }
+};
+
+//=============================================================================
+// VlScheduleSelector - selects one of several alternative static schedules
+//
+// Used with --threads-schedules, where each ExecGraph has multiple static
+// MTask-to-thread assignments. Each schedule is timed in turn for
+// VerilatedContext::threadsScheduleTrial() evaluations, then the one with the
+// shortest total time is used. The trials are repeated every RETRIAL_PERIODS
+// trial lengths, to follow changes in the workload. Each schedule has its own
+// MTask state, so each also keeps its own even/odd cycle flag.
+
+class VlScheduleSelector final {
+    // CONSTANTS
+    static constexpr uint64_t RETRIAL_PERIODS = 1000;
+
+    // MEMBERS
+    std::vector<uint64_t> m_trialNs;  // Time each schedule took during its last trial
+    std::vector<bool> m_evenCycle;  // Even/odd cycle flag of each schedule
+    unsigned m_current = 0;  // Schedule in use by the current evaluation
+    uint64_t m_trial = 0;  // Trial length, in evaluations
+    uint64_t m_evals = 0;  // Evaluations since the trials were (re)started
+    uint64_t m_startNs = 0;  // Start time of current evaluation, 0 if not timed
+
+    VL_UNCOPYABLE(VlScheduleSelector);
+
+public:
+    // CONSTRUCTORS
+    VlScheduleSelector() = default;
+    ~VlScheduleSelector() = default;
+
+    // METHODS
+    // Called before evaluating the graph, return the index of the schedule to use
+    unsigned begin(const VerilatedContext* contextp, unsigned nSchedules) {
+        if (VL_UNLIKELY(m_evenCycle.size() != nSchedules
+                        || m_trial != contextp->threadsScheduleTrial())) {
+            restart(contextp->threadsScheduleTrial(), nSchedules);
+        }
+        if (VL_UNLIKELY(m_evals < m_trial * (nSchedules + 1))) trial(nSchedules);
+        if (VL_UNLIKELY(++m_evals == m_trial * (nSchedules + RETRIAL_PERIODS))) m_evals = 0;
+        m_evenCycle[m_current] = !m_evenCycle[m_current];
+        return m_current;
+    }
+    // Called after evaluating the graph
+    void end() {
+        if (VL_UNLIKELY(m_startNs)) {
+            m_trialNs[m_current] += VlThreadWaiter::nowNs() - m_startNs;
+            m_startNs = 0;
+        }
+    }
+    // Even/odd cycle flag for the schedule returned by the last begin()
+    bool evenCycle() const { return m_evenCycle[m_current]; }
+    // Schedule with the shortest time in the last trials
+    unsigned best() const;
+
+private:
+    void restart(uint64_t trial, unsigned nSchedules);
+    void trial(unsigned nSchedules);
+};
+
+//=============================================================================
+// VlMTaskGuard - skips an MTask whose state is unchanged since its last run
+//
+// Used with --threads-skip-idle. Holds the values the MTask read at the
+// start of its last run, and the values it wrote at the end. An MTask that
+// is a function of the values it reads need not run again while both are
+// unchanged, which is the common case for idle parts of a design. Only
+// called from the thread running the MTask.
+
+class VlMTaskGuard final {
+    // TYPES
+    struct Region {
+        const void* m_datap;  // Start of the object
+        size_t m_size;  // Size of the object
+    };
+
+    // MEMBERS
+    std::vector<uint8_t> m_inputs;  // Values read at the start of the last run
+    std::vector<uint8_t> m_outputs;  // Values written at the end of the last run
+    bool m_valid = false;  // MTask has run at least once
+
+    VL_UNCOPYABLE(VlMTaskGuard);
+
+public:
+    // CONSTRUCTORS
+    VlMTaskGuard() = default;
+    ~VlMTaskGuard() = default;
+
+    // METHODS
+    // Called before the MTask, return true if the given inputs differ from
+    // the last run, and record them
+    template <typename... T_Objs>
+    bool inputsChanged(const T_Objs&... objs) {
+        const bool changed = update(m_inputs, {Region{&objs, sizeof(objs)}...});
+        if (VL_UNLIKELY(!m_valid)) {
+            m_valid = true;
+            return true;
         }
+        return changed;
     }
+    // Called before the MTask, return true if the given outputs differ from
+    // the end of the last run
+    template <typename... T_Objs>
+    bool outputsChanged(const T_Objs&... objs) {
+        return update(m_outputs, {Region{&objs, sizeof(objs)}...});
+    }
+    // Called after the MTask, record the given outputs
+    template <typename... T_Objs>
+    void outputsSave(const T_Objs&... objs) {
+        update(m_outputs, {Region{&objs, sizeof(objs)}...});
+    }
+
+private:
+    // Return true if 'regions' differ from 'saved', and if so copy them to 'saved'
+    static bool update(std::vector<uint8_t>& saved, std::initializer_list<Region> regions);
 };
 
 class VlWorkerThread final {
@@ -151,29 +412,50 @@ private:
     // Store the size atomically, so we can spin wait
     std::atomic<size_t> m_ready_size;
 
+    VlThreadWaiter m_waiter;  // Wait policy state and statistics of this thread
+
+    // NUMA node this thread runs on, -1 if unknown, -2 until the thread has started
+    std::atomic<int> m_numaNode{-2};
+
     std::thread m_cthread;  // Underlying C++ thread record
 
     VL_UNCOPYABLE(VlWorkerThread);
 
 public:
     // CONSTRUCTORS
-    explicit VlWorkerThread(VerilatedContext* contextp);
+    // 'index' is the thread's place in the pool, from 1 as 0 is the eval thread.
+    // If 'cpu' is not negative, the thread is pinned to that CPU
+    VlWorkerThread(VerilatedContext* contextp, unsigned index, int cpu);
     ~VlWorkerThread();
 
     // METHODS
     template <bool SpinWait>
     void dequeWork(ExecRec* workp) VL_MT_SAFE_EXCLUDES(m_mutex) {
+        uint64_t spinNs = 0;
         // Spin for a while, waiting for new data
         if VL_CONSTEXPR_CXX17 (SpinWait) {
-            for (unsigned i = 0; i < VL_LOCK_SPINS; ++i) {
-                if (VL_LIKELY(m_ready_size.load(std::memory_order_relaxed))) break;
+            uint64_t startNs = VlThreadWaiter::nowNs();
+            const unsigned budget = m_waiter.spinBudget();
+            for (unsigned i = 0; i < budget; ++i) {
+                if (VL_LIKELY(m_ready_size.load(std::memory_order_relaxed))) {
+                    m_waiter.spun(i, VlThreadWaiter::nowNs() - startNs);
+                    startNs = 0;
+                    break;
+                }
                 VL_CPU_RELAX();
             }
+            if (startNs) spinNs = VlThreadWaiter::nowNs() - startNs;
         }
         VerilatedLockGuard lock{m_mutex};
-        while (m_ready.empty()) {
-            m_waiting = true;
-            m_cv.wait(m_mutex);
+        if (m_ready.empty()) {
+            const uint64_t parkStartNs = VlThreadWaiter::nowNs();
+            while (m_ready.empty()) {
+                m_waiting = true;
+                m_cv.wait(m_mutex);
+            }
+            if (SpinWait) m_waiter.parked(spinNs, VlThreadWaiter::nowNs() - parkStartNs);
+        } else if (spinNs) {
+            m_waiter.spun(m_waiter.spinBudget(), spinNs);
         }
         m_waiting = false;
         // As noted above this is inefficient if our ready list is ever
@@ -194,22 +476,64 @@ public:
         if (notify) m_cv.notify_one();
     }
 
+    const VlThreadWaiter& waiter() const { return m_waiter; }
+    // NUMA node of this thread, or -1 if unknown. Blocks until the thread has started.
+    int numaNode() const;
+
     void shutdown();  // Finish current tasks, then terminate thread
     void wait();  // Blocks calling thread until all tasks complete in this thread
 
     void workerLoop();
-    static void startWorker(VlWorkerThread* workerp, VerilatedContext* contextp);
+    static void startWorker(VlWorkerThread* workerp, VerilatedContext* contextp, unsigned index,
+                            int cpu);
 };
 
 class VlThreadPool final : public VerilatedVirtualBase {
     // MEMBERS
     std::vector<VlWorkerThread*> m_workers;  // our workers
+    const bool m_shared;  // Shared by all contexts, see VerilatedContext::threadsShared
+
+    // Sharing state, see lease. Each graph execution leases the workers it
+    // needs, and a lease is only granted when all of them are free, so graphs
+    // of different contexts never wait on each other's MTasks. Waiting
+    // contexts are granted leases in order of least worker time used so far.
+    VerilatedMutex m_leaseMutex;
+    std::condition_variable_any m_leaseCv;
+    std::vector<bool> m_leased VL_GUARDED_BY(m_leaseMutex);  // Worker is leased
+    unsigned m_nFree VL_GUARDED_BY(m_leaseMutex) = 0;  // Number of unleased workers
+    uint64_t m_leaseSeq VL_GUARDED_BY(m_leaseMutex) = 0;  // Arrival order of lease requests
+    // Waiting lease requests, arrival order -> context
+    std::map<uint64_t, const VerilatedContext*> m_leaseWaiters VL_GUARDED_BY(m_leaseMutex);
+    // Worker time used by each context, in nanoseconds times workers
+    std::map<const VerilatedContext*, uint64_t> m_usageNs VL_GUARDED_BY(m_leaseMutex);
+    struct Lease final {
+        std::vector<unsigned> m_workers;  // Pool workers leased, by model worker index
+        const VerilatedContext* m_contextp = nullptr;  // Context holding the lease
+        uint64_t m_startNs = 0;  // Time the lease was granted
+    };
+    static thread_local Lease t_lease;  // Lease held by the current thread
+
+    // Dynamic (work-stealing) MTask execution state, see executeDynamic
+    // One deque per worker, plus a last one for the calling (main) thread
+    std::vector<VlMTaskDeque*> m_deques;
+    VlSelfP m_dynSelfp = nullptr;  // Self pointer of graph being executed
+    bool m_dynEvenCycle = false;  // Even/odd flag of graph being executed
+    const VlMTaskVertex* m_dynFinalp = nullptr;  // Completion vertex of graph being executed
+    std::atomic<unsigned> m_dynClaimed{0};  // Number of deques claimed by workers
+    std::atomic<unsigned> m_dynActive{0};  // Number of workers still in stealLoop
+    static thread_local VlMTaskDeque* t_dequep;  // Deque owned by the current thread, or nullptr
+
+    // Variable placement state, see placeOnThread
+    bool m_pinned = false;  // Threads are pinned to CPUs
+    int m_evalNumaNode = -1;  // NUMA node of the thread that created the pool
+    std::map<uintptr_t, int> m_placePages;  // Page address -> NUMA node to place it on
 
 public:
     // CONSTRUCTORS
     // Construct a thread pool with 'nThreads' dedicated threads. The thread
     // pool will create these threads and make them available to execute tasks
-    // via this->workerp(index)->addTask(...)
+    // via this->workerp(index)->addTask(...). A null 'contextp' creates a
+    // pool shared by all contexts, see sharedAcquire.
     VlThreadPool(VerilatedContext* contextp, unsigned nThreads);
     ~VlThreadPool() override;
 
@@ -217,11 +541,68 @@ public:
     int numThreads() const { return m_workers.size(); }
     VlWorkerThread* workerp(int index) {
         assert(index >= 0);
+        if (VL_UNLIKELY(m_shared)) {
+            assert(static_cast<size_t>(index) < t_lease.m_workers.size());
+            index = t_lease.m_workers[index];
+        }
         assert(static_cast<size_t>(index) < m_workers.size());
         return m_workers[index];
     }
+    // Called by the eval thread before starting a graph on workers
+    // 0..nWorkers-1, and after it completes. With a shared pool, blocks
+    // until that many workers are free for the calling thread's context.
+    void lease(unsigned nWorkers) {
+        if (VL_UNLIKELY(m_shared)) leaseSlow(nWorkers);
+    }
+    void unlease() {
+        if (VL_UNLIKELY(m_shared)) unleaseSlow();
+    }
+
+    // Return the pool shared by all contexts, creating it if needed, or
+    // nullptr if it has fewer than 'nThreads' workers. Each successful call
+    // must be paired with a call to sharedRelease.
+    static VlThreadPool* sharedAcquire(unsigned nThreads);
+    // Release the shared pool, deleting it when no context uses it
+    static void sharedRelease(const VerilatedContext* contextp);
+    // Print wait statistics of each worker, see VerilatedContext::threadsStatsDump
+    void statsDump() const;
+    // Total time all workers spent waiting, see VerilatedContext::statsThreadWaitNs
+    uint64_t waitNs() const;
+    // In a child process created by fork(), start new worker threads, see
+    // VerilatedContext::forkChild. Must be called while the pool is idle.
+    void restartAfterFork(VerilatedContext* contextp);
+
+    // Request the memory of a variable be placed on the NUMA node of the given worker
+    // thread, or of the eval thread if 'threadId' is negative. Only has an effect if the
+    // threads are pinned to CPUs, as otherwise they may migrate between nodes.
+    void placeOnThread(int threadId, const void* datap, size_t size);
+    // Move all pages requested by placeOnThread since the last call
+    void placeCommit();
+
+    // Pin the calling thread to the given CPU, return its NUMA node or -1 if unknown
+    static int pinCurrentThread(int cpu);
+
+    // Dynamically schedule an MTask graph (--threads-dynamic). Push the
+    // 'roots' (MTasks without upstream dependencies), then the calling
+    // thread and all workers execute and steal ready MTasks until
+    // 'finalVertex' signals that every MTask has completed.
+    void executeDynamic(VlSelfP selfp, bool evenCycle, const VlMTaskVertex& finalVertex,
+                        std::initializer_list<VlExecFnp> roots);
+    // Called from an MTask within executeDynamic to make a downstream MTask ready
+    void pushTask(VlExecFnp fnp) {
+        if (VL_UNLIKELY(!t_dequep || !t_dequep->push(fnp))) fnp(m_dynSelfp, m_dynEvenCycle);
+    }
 
 private:
+    // CPU to pin thread 'index' to, 0 being the calling thread, or -1 if not pinned
+    int cpuFor(VerilatedContext* contextp, unsigned index) const;
+    void leaseSlow(unsigned nWorkers) VL_MT_SAFE_EXCLUDES(m_leaseMutex);
+    void unleaseSlow() VL_MT_SAFE_EXCLUDES(m_leaseMutex);
+    bool leaseGrantable(uint64_t seq, unsigned nWorkers) const VL_REQUIRES(m_leaseMutex);
+    static void setContextTask(VlSelfP contextp, bool);
+    void stealLoop(VlMTaskDeque* ownp);
+    static void stealTask(VlSelfP poolp, bool);
+
     VL_UNCOPYABLE(VlThreadPool);
 };
 
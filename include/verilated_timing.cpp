@@ -22,6 +22,23 @@
 
 #include "verilated_timing.h"
 
+//======================================================================
+// VlCoroutinePool:: Methods
+
+thread_local std::array<void*, VlCoroutinePool::BUCKETS> VlCoroutinePool::t_freeHeads{};
+
+void* VlCoroutinePool::refill(size_t bucket) {
+    const size_t blockSize = (bucket + 1) * BLOCK_GRAIN;
+    uint8_t* const slabp = static_cast<uint8_t*>(::operator new(SLAB_BLOCKS * blockSize));
+    // Return the first block, and put the others on the free list
+    for (size_t i = SLAB_BLOCKS - 1; i > 0; --i) {
+        void* const blockp = slabp + i * blockSize;
+        *static_cast<void**>(blockp) = t_freeHeads[bucket];
+        t_freeHeads[bucket] = blockp;
+    }
+    return slabp;
+}
+
 //======================================================================
 // VlCoroutineHandle:: Methods
 
@@ -32,6 +49,9 @@ void VlCoroutineHandle::resume() {
         VL_DEBUG_IF(VL_DBG_MSGF("             Resuming: "); dump(););
         m_coro();
         m_coro = nullptr;
+    } else if (m_fnp) {
+        VL_DEBUG_IF(VL_DBG_MSGF("             Resuming: "); dump(););
+        std::exchange(m_fnp, nullptr)(m_selfp);
     }
 }
 
@@ -54,9 +74,21 @@ void VlDelayScheduler::VlDelayedCoroutine::dump() const {
 void VlDelayScheduler::resume() {
 #ifdef VL_DEBUG
     VL_DEBUG_IF(dump(); VL_DBG_MSGF("         Resuming delayed processes\n"););
+#endif
+#ifdef VL_TIMING_WHEEL
+    // Slide the wheel up to the current time, unless that would skip a missed time slot
+    m_wheelp->m_base = m_wheelp->m_size ? std::min(wheelNextTimeSlot(), m_context.time())
+                                        : m_context.time();
 #endif
     while (awaitingCurrentTime()) {
-        if (m_queue.front().m_timestep != m_context.time()) {
+        if (periodicResume(m_context.time())) continue;
+#ifdef VL_TIMING_WHEEL
+        if (m_wheelp->m_size && wheelNextTimeSlot() == m_context.time()) {
+            wheelResume(m_context.time());
+            continue;
+        }
+#endif
+        if (nextTimeSlot() != m_context.time()) {
             VL_FATAL_MT(__FILE__, __LINE__, "",
                         "%Error: Encountered process that should've been resumed at an "
                         "earlier simulation time. Missed a time slot?");
@@ -73,16 +105,106 @@ uint64_t VlDelayScheduler::nextTimeSlot() const {
     if (empty()) {
         VL_FATAL_MT(__FILE__, __LINE__, "", "%Error: There is no next time slot scheduled");
     }
-    return m_queue.front().m_timestep;
+    uint64_t next = std::numeric_limits<uint64_t>::max();
+    for (const VlPeriodicProcess& periodic : m_periodic) {
+        next = std::min(next, periodic.m_timestep);
+    }
+#ifdef VL_TIMING_WHEEL
+    if (m_wheelp->m_size) next = std::min(next, wheelNextTimeSlot());
+#endif
+    if (!m_queue.empty()) next = std::min(next, m_queue.front().m_timestep);
+    return next;
+}
+
+bool VlDelayScheduler::periodicResume(uint64_t timestep) {
+    bool resumed = false;
+    // Indexed, as a resumed process may register further periodic processes
+    for (size_t i = 0; i < m_periodic.size(); ++i) {
+        VlPeriodicProcess& periodic = m_periodic[i];
+        if (periodic.m_timestep != timestep) continue;
+        periodic.m_timestep += periodic.m_period;
+        VL_DEBUG_IF(VL_DBG_MSGF("             Resuming periodic: ");
+                    VL_PRINTF("Process at %s:%d\n", periodic.m_fileline.filename(),
+                              periodic.m_fileline.lineno()););
+        periodic.m_fnp(periodic.m_selfp);
+        resumed = true;
+    }
+    return resumed;
 }
 
+#ifdef VL_TIMING_WHEEL
+static int vlCountTrailingZeros(uint64_t value) {
+    // Value must be non-zero
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    for (; !(value & 1); value >>= 1) ++count;
+    return count;
+#endif
+}
+
+uint64_t VlDelayScheduler::wheelNextTimeSlot() const {
+    // The wheel holds timesteps m_base .. m_base + WHEEL_SIZE - 1, so the next is the first
+    // used slot at or cyclically after m_base's slot
+    const VlDelayWheel& wheel = *m_wheelp;
+    const uint64_t start = wheel.m_base & (WHEEL_SIZE - 1);
+    uint64_t slot;
+    const uint64_t word = start / 64;
+    const uint64_t bits = wheel.m_used[word] & (~0ULL << (start % 64));
+    if (bits) {
+        slot = word * 64 + vlCountTrailingZeros(bits);
+    } else {
+        // Words after start's, else wrap around to the first used word (maybe start's again)
+        const uint64_t laterWords
+            = (word == WHEEL_SIZE / 64 - 1) ? 0 : (wheel.m_usedWords & (~0ULL << (word + 1)));
+        const uint64_t usedWord
+            = vlCountTrailingZeros(laterWords ? laterWords : wheel.m_usedWords);
+        slot = usedWord * 64 + vlCountTrailingZeros(wheel.m_used[usedWord]);
+    }
+    return wheel.m_base + ((slot - start) & (WHEEL_SIZE - 1));
+}
+
+void VlDelayScheduler::wheelPush(uint64_t timestep, VlCoroutineHandle&& handle) {
+    VlDelayWheel& wheel = *m_wheelp;
+    const uint64_t slot = timestep & (WHEEL_SIZE - 1);
+    wheel.m_slots[slot].push_back({timestep, std::move(handle)});
+    wheel.m_used[slot / 64] |= 1ULL << (slot % 64);
+    wheel.m_usedWords |= 1ULL << (slot / 64);
+    ++wheel.m_size;
+}
+
+void VlDelayScheduler::wheelResume(uint64_t timestep) {
+    VlDelayWheel& wheel = *m_wheelp;
+    const uint64_t slot = timestep & (WHEEL_SIZE - 1);
+    // Take the whole slot, as the resumed coroutines may schedule more at this time
+    wheel.m_resuming.swap(wheel.m_slots[slot]);
+    wheel.m_used[slot / 64] &= ~(1ULL << (slot % 64));
+    if (!wheel.m_used[slot / 64]) wheel.m_usedWords &= ~(1ULL << (slot / 64));
+    wheel.m_size -= wheel.m_resuming.size();
+    for (VlDelayedCoroutine& susp : wheel.m_resuming) susp.m_handle.resume();
+    wheel.m_resuming.clear();
+}
+#endif
+
 #ifdef VL_DEBUG
 void VlDelayScheduler::dump() const {
-    if (m_queue.empty()) {
+    if (empty()) {
         VL_DBG_MSGF("         No delayed processes:\n");
     } else {
         VL_DBG_MSGF("         Delayed processes:\n");
+        for (const auto& periodic : m_periodic) {
+            VL_DBG_MSGF("             Awaiting time %" PRIu64 ": Process at %s:%d every %" PRIu64
+                        "\n",
+                        periodic.m_timestep, periodic.m_fileline.filename(),
+                        periodic.m_fileline.lineno(), periodic.m_period);
+        }
         for (const auto& susp : m_queue) susp.dump();
+#ifdef VL_TIMING_WHEEL
+        for (const auto& slot : m_wheelp->m_slots) {
+            for (const auto& susp : slot) susp.dump();
+        }
+#endif
     }
 }
 #endif
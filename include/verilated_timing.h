@@ -56,6 +56,68 @@
 // Placeholder for compiling with --protect-ids
 #define VL_UNKNOWN "<unknown>"
 
+//=============================================================================
+// VlCoroutinePool is a per-thread pool of small memory blocks, in size buckets, for coroutine
+// frames and fork join state. These are allocated and freed at a high rate, so each bucket
+// keeps a free list, which is refilled a slab of blocks at a time. Larger sizes use the heap.
+// Memory in the free lists is never returned to the heap.
+
+class VlCoroutinePool final {
+    // CONSTANTS
+    static constexpr size_t BLOCK_GRAIN = 64;  // Bucket sizes are multiples of this
+    static constexpr size_t BUCKETS = 16;  // Pooled sizes up to BLOCK_GRAIN * BUCKETS
+    static constexpr size_t SLAB_BLOCKS = 32;  // Blocks allocated at once on refill
+
+    // MEMBERS
+    // Internal note: Globals may multi-construct, see verilated.cpp top.
+    static thread_local std::array<void*, BUCKETS> t_freeHeads;  // Free list per bucket
+
+    // METHODS
+    static void* refill(size_t bucket);  // Fill empty free list, return a block from it
+
+public:
+    static void* allocate(size_t size) {
+        if (VL_UNLIKELY(size == 0 || size > BLOCK_GRAIN * BUCKETS)) return ::operator new(size);
+        const size_t bucket = (size - 1) / BLOCK_GRAIN;
+        void* const blockp = t_freeHeads[bucket];
+        if (VL_UNLIKELY(!blockp)) return refill(bucket);
+        t_freeHeads[bucket] = *static_cast<void**>(blockp);
+        return blockp;
+    }
+    static void deallocate(void* blockp, size_t size) noexcept {
+        if (VL_UNLIKELY(size == 0 || size > BLOCK_GRAIN * BUCKETS)) {
+            ::operator delete(blockp);
+            return;
+        }
+        const size_t bucket = (size - 1) / BLOCK_GRAIN;
+        *static_cast<void**>(blockp) = t_freeHeads[bucket];
+        t_freeHeads[bucket] = blockp;
+    }
+};
+
+// Allocator using VlCoroutinePool, e.g. for std::allocate_shared
+template <typename T_Value>
+struct VlCoroutinePoolAllocator final {
+    using value_type = T_Value;
+    VlCoroutinePoolAllocator() = default;
+    template <typename T_Other>
+    VlCoroutinePoolAllocator(const VlCoroutinePoolAllocator<T_Other>&) {}
+    T_Value* allocate(size_t n) {
+        return static_cast<T_Value*>(VlCoroutinePool::allocate(n * sizeof(T_Value)));
+    }
+    void deallocate(T_Value* valuep, size_t n) noexcept {
+        VlCoroutinePool::deallocate(valuep, n * sizeof(T_Value));
+    }
+    template <typename T_Other>
+    bool operator==(const VlCoroutinePoolAllocator<T_Other>&) const {
+        return true;
+    }
+    template <typename T_Other>
+    bool operator!=(const VlCoroutinePoolAllocator<T_Other>&) const {
+        return false;
+    }
+};
+
 //=============================================================================
 // VlFileLineDebug stores a SystemVerilog source code location. Used in VlCoroutineHandle for
 // debugging purposes.
@@ -89,13 +151,19 @@ public:
 //=============================================================================
 // VlCoroutineHandle is a non-copyable (but movable) coroutine handle. On resume, the handle is
 // cleared, as we assume that either the coroutine has finished and deleted itself, or, if it got
-// suspended, another VlCoroutineHandle was created to manage it.
+// suspended, another VlCoroutineHandle was created to manage it. Instead of a coroutine, the
+// handle may hold a function resuming a simple process that has been lowered to a state machine.
+
+// Function resuming a process lowered to a state machine, called with its module instance
+using VlResumeFnp = void (*)(void*);
 
 class VlCoroutineHandle final {
     VL_UNCOPYABLE(VlCoroutineHandle);
 
     // MEMBERS
     std::coroutine_handle<> m_coro;  // The wrapped coroutine handle
+    VlResumeFnp m_fnp = nullptr;  // Or, the state machine to resume
+    void* m_selfp = nullptr;  // Module instance to pass to m_fnp
     VlFileLineDebug m_fileline;
 
 public:
@@ -106,9 +174,16 @@ public:
     VlCoroutineHandle(std::coroutine_handle<> coro, VlFileLineDebug fileline)
         : m_coro{coro}
         , m_fileline{fileline} {}
+    VlCoroutineHandle(VlResumeFnp fnp, void* selfp, VlFileLineDebug fileline)
+        : m_coro{nullptr}
+        , m_fnp{fnp}
+        , m_selfp{selfp}
+        , m_fileline{fileline} {}
     // Move the handle, leaving a nullptr
     VlCoroutineHandle(VlCoroutineHandle&& moved)
         : m_coro{std::exchange(moved.m_coro, nullptr)}
+        , m_fnp{std::exchange(moved.m_fnp, nullptr)}
+        , m_selfp{moved.m_selfp}
         , m_fileline{moved.m_fileline} {}
     // Destroy if the handle isn't null
     ~VlCoroutineHandle() {
@@ -120,9 +195,12 @@ public:
     // Move the handle, leaving a null handle
     auto& operator=(VlCoroutineHandle&& moved) {
         m_coro = std::exchange(moved.m_coro, nullptr);
+        m_fnp = std::exchange(moved.m_fnp, nullptr);
+        m_selfp = moved.m_selfp;
+        m_fileline = moved.m_fileline;
         return *this;
     }
-    // Resume the coroutine if the handle isn't null
+    // Resume the coroutine or state machine if the handle isn't null
     void resume();
 #ifdef VL_DEBUG
     void dump() const;
@@ -148,10 +226,42 @@ class VlDelayScheduler final {
 #endif
     };
     using VlDelayedCoroutineQueue = std::vector<VlDelayedCoroutine>;
+    // State machine resumed periodically, such as a clock generator, kept out of the queue
+    struct VlPeriodicProcess final {
+        uint64_t m_timestep;  // Simulation time when the process should be resumed next
+        uint64_t m_period;  // Time between resumptions
+        VlResumeFnp m_fnp;  // The state machine to resume
+        void* m_selfp;  // Module instance to pass to m_fnp
+        VlFileLineDebug m_fileline;
+    };
+#ifdef VL_TIMING_WHEEL
+    // Timing wheel with one slot per timestep, holding coroutines due within WHEEL_SIZE
+    // timesteps of m_base, so short delays avoid the O(log n) heap. Later ones overflow
+    // into m_queue. A two level bitmap of non-empty slots finds the next time slot.
+    static constexpr uint64_t WHEEL_SIZE = 64 * 64;  // Power of two, at most 64 * 64
+    struct VlDelayWheel final {
+        std::array<VlDelayedCoroutineQueue, WHEEL_SIZE> m_slots;  // Coroutines by timestep
+        std::array<uint64_t, WHEEL_SIZE / 64> m_used{};  // Bit per non-empty m_slots entry
+        uint64_t m_usedWords = 0;  // Bit per non-zero m_used entry
+        uint64_t m_base = 0;  // Earliest timestep in the wheel, wheel covers WHEEL_SIZE after
+        size_t m_size = 0;  // Number of coroutines in the wheel
+        VlDelayedCoroutineQueue m_resuming;  // Slot being resumed, kept to reuse its storage
+    };
+#endif
 
     // MEMBERS
     VerilatedContext& m_context;
     VlDelayedCoroutineQueue m_queue;  // Coroutines to be restored at a certain simulation time
+    std::vector<VlPeriodicProcess> m_periodic;  // Periodic processes, resumed outside m_queue
+#ifdef VL_TIMING_WHEEL
+    const std::unique_ptr<VlDelayWheel> m_wheelp{new VlDelayWheel};  // Near future coroutines
+
+    // METHODS
+    uint64_t wheelNextTimeSlot() const;  // Earliest timestep in the non-empty wheel
+    void wheelPush(uint64_t timestep, VlCoroutineHandle&& handle);
+    void wheelResume(uint64_t timestep);  // Resume coroutines in the wheel at given time
+#endif
+    bool periodicResume(uint64_t timestep);  // Resume periodic processes due, false if none
 
 public:
     // CONSTRUCTORS
@@ -164,30 +274,63 @@ public:
     // coroutines)
     uint64_t nextTimeSlot() const;
     // Are there no delayed coroutines awaiting?
-    bool empty() const { return m_queue.empty(); }
+    bool empty() const {
+#ifdef VL_TIMING_WHEEL
+        if (m_wheelp->m_size) return false;
+#endif
+        return m_queue.empty() && m_periodic.empty();
+    }
+    // Number of delayed coroutines awaiting
+    size_t size() const {
+#ifdef VL_TIMING_WHEEL
+        return m_wheelp->m_size + m_queue.size() + m_periodic.size();
+#else
+        return m_queue.size() + m_periodic.size();
+#endif
+    }
     // Are there coroutines to resume at the current simulation time?
-    bool awaitingCurrentTime() const {
-        return !empty() && m_queue.front().m_timestep <= m_context.time();
+    bool awaitingCurrentTime() const { return !empty() && nextTimeSlot() <= m_context.time(); }
+    // Schedule a suspended coroutine to be resumed at the given simulation time
+    void schedule(uint64_t timestep, VlCoroutineHandle&& handle) {
+#ifdef VL_TIMING_WHEEL
+        if (timestep - m_wheelp->m_base < WHEEL_SIZE) {  // Also false if before base
+            wheelPush(timestep, std::move(handle));
+            return;
+        }
+#endif
+        m_queue.push_back({timestep, std::move(handle)});
+        // Move last element to the proper place in the max-heap
+        std::push_heap(m_queue.begin(), m_queue.end());
     }
 #ifdef VL_DEBUG
     void dump() const;
 #endif
+    // Used by state machines to be resumed after a delay
+    void resumeAfter(uint64_t delay, VlResumeFnp fnp, void* selfp,
+                     const char* filename = VL_UNKNOWN, int lineno = 0) {
+        schedule(m_context.time() + delay,
+                 VlCoroutineHandle{fnp, selfp, VlFileLineDebug{filename, lineno}});
+    }
+    // Used by state machines to be resumed every 'period', starting one period from now
+    void resumeEvery(uint64_t period, VlResumeFnp fnp, void* selfp,
+                     const char* filename = VL_UNKNOWN, int lineno = 0) {
+        m_periodic.push_back({m_context.time() + period, period, fnp, selfp,
+                              VlFileLineDebug{filename, lineno}});
+    }
     // Used by coroutines for co_awaiting a certain simulation time
     auto delay(uint64_t delay, const char* filename = VL_UNKNOWN, int lineno = 0) {
         struct Awaitable {
-            VlDelayedCoroutineQueue& queue;
+            VlDelayScheduler& scheduler;
             uint64_t delay;
             VlFileLineDebug fileline;
 
             bool await_ready() const { return false; }  // Always suspend
             void await_suspend(std::coroutine_handle<> coro) {
-                queue.push_back({delay, VlCoroutineHandle{coro, fileline}});
-                // Move last element to the proper place in the max-heap
-                std::push_heap(queue.begin(), queue.end());
+                scheduler.schedule(delay, VlCoroutineHandle{coro, fileline});
             }
             void await_resume() const {}
         };
-        return Awaitable{m_queue, m_context.time() + delay, VlFileLineDebug{filename, lineno}};
+        return Awaitable{*this, m_context.time() + delay, VlFileLineDebug{filename, lineno}};
     }
 };
 
@@ -338,7 +481,11 @@ class VlForkSync final {
 
 public:
     // Create the join object and set the counter to the specified number
-    void init(size_t count) { m_join.reset(new VlJoin{count, {}}); }
+    void init(size_t count) {
+        // One pooled allocation for both the join and the shared_ptr control block
+        m_join = std::allocate_shared<VlJoin>(VlCoroutinePoolAllocator<VlJoin>{},
+                                              VlJoin{count, {}});
+    }
     // Called whenever any of the forked processes finishes. If the join counter reaches 0, the
     // main process gets resumed
     void done(const char* filename = VL_UNKNOWN, int lineno = 0);
@@ -372,6 +519,12 @@ private:
 
         ~VlPromise();
 
+        // Coroutine frames come from a pool, as processes start and finish at a high rate
+        static void* operator new(size_t size) { return VlCoroutinePool::allocate(size); }
+        static void operator delete(void* framep, size_t size) noexcept {
+            VlCoroutinePool::deallocate(framep, size);
+        }
+
         VlCoroutine get_return_object() { return {this}; }
 
         // Never suspend at the start of the coroutine
@@ -25,21 +25,31 @@
 // clang-format off
 
 #include "verilated.h"
+#include "verilated_intrinsics.h"
 #include "verilated_trace_defs.h"
 
+#include <atomic>
 #include <bitset>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-#include <deque>
 #include <thread>
 
 // clang-format on
 
+// Return true if any of the 8 trace activity flags starting at 'flagsp' is set.
+// Used by the change dump functions to skip sub-functions with no activity.
+static inline bool VL_TRACE_ACTIVITY8(const CData* flagsp) VL_PURE {
+    uint64_t word;
+    std::memcpy(&word, flagsp, sizeof(word));
+    return word != 0;
+}
+
 class VlThreadPool;
 template <class T_Buffer>
 class VerilatedTraceBuffer;
@@ -49,45 +59,91 @@ class VerilatedTraceOffloadBuffer;
 //=============================================================================
 // Offloaded tracing
 
-// A simple synchronized first in first out queue
-template <class T>
+// A bounded single producer, single consumer first in first out queue. Putting
+// and getting elements is lock free. Only a thread that finds the queue full
+// (on put) or empty (on get) will, after spinning for a while, block on a
+// condition variable, which the other side then signals.
+template <class T, size_t N>
 class VerilatedThreadQueue final {  // LCOV_EXCL_LINE  // lcov bug
+    static_assert(N && (N & (N - 1)) == 0, "Size must be power of 2");
+
+    // Number of times to retry before blocking. Low, as the worker is idle between dumps
+    static constexpr unsigned SPINS = 1024;
+
 private:
-    mutable VerilatedMutex m_mutex;  // Protects m_queue
+    // Both counters only ever increase, index m_elems modulo N
+    alignas(VL_CACHE_LINE_BYTES) std::atomic<size_t> m_head{0};  // Next to get, by consumer
+    alignas(VL_CACHE_LINE_BYTES) std::atomic<size_t> m_tail{0};  // Next to put, by producer
+    alignas(VL_CACHE_LINE_BYTES) std::atomic<bool> m_waiting{false};  // Thread blocked on m_cv
+    VerilatedMutex m_mutex;  // Only used for blocking
     std::condition_variable_any m_cv;
-    std::deque<T> m_queue VL_GUARDED_BY(m_mutex);
+    T m_elems[N];
 
-public:
-    // Put an element at the back of the queue
-    void put(T value) VL_MT_SAFE_EXCLUDES(m_mutex) {
-        const VerilatedLockGuard lock{m_mutex};
-        m_queue.push_back(value);
-        m_cv.notify_one();
+    bool tryPutNoNotify(T value) VL_MT_SAFE {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == N) return false;
+        m_elems[tail % N] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    bool tryGetNoNotify(T& result) VL_MT_SAFE {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        result = m_elems[head % N];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    // Wake the other side if it is blocked
+    void notify() VL_MT_SAFE_EXCLUDES(m_mutex) {
+        // Pairs with fence in waitUntil, so either the waiter sees our update, or we
+        // see it waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (VL_UNLIKELY(m_waiting.load(std::memory_order_relaxed))) {
+            const VerilatedLockGuard lock{m_mutex};
+            m_cv.notify_all();
+        }
+    }
+    // Retry 'tryf' until it succeeds, spinning for a while, then blocking
+    template <typename T_Func>
+    void waitUntil(T_Func tryf) VL_MT_SAFE_EXCLUDES(m_mutex) {
+        for (unsigned i = 0; i < SPINS; ++i) {
+            if (VL_LIKELY(tryf())) return;
+            VL_CPU_RELAX();
+        }
+        VerilatedLockGuard lock{m_mutex};
+        while (true) {
+            m_waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tryf()) break;
+            m_cv.wait(m_mutex);
+        }
+        m_waiting.store(false, std::memory_order_relaxed);
     }
 
-    // Put an element at the front of the queue
-    void put_front(T value) VL_MT_SAFE_EXCLUDES(m_mutex) {
-        const VerilatedLockGuard lock{m_mutex};
-        m_queue.push_front(value);
-        m_cv.notify_one();
+public:
+    // Put an element at the back of the queue. Blocks if full. Producer thread only.
+    void put(T value) VL_MT_SAFE_EXCLUDES(m_mutex) {
+        if (VL_UNLIKELY(!tryPutNoNotify(value))) {
+            waitUntil([&]() VL_MT_SAFE { return tryPutNoNotify(value); });
+        }
+        notify();
     }
 
-    // Get an element from the front of the queue. Blocks if none available
+    // Get an element from the front of the queue. Blocks if none available.
+    // Consumer thread only.
     T get() VL_MT_SAFE_EXCLUDES(m_mutex) {
-        VerilatedLockGuard lock{m_mutex};
-        m_cv.wait(m_mutex, [this]() VL_REQUIRES(m_mutex) { return !m_queue.empty(); });
-        assert(!m_queue.empty());
-        T value = m_queue.front();
-        m_queue.pop_front();
+        T value;
+        if (VL_UNLIKELY(!tryGetNoNotify(value))) {
+            waitUntil([&]() VL_MT_SAFE { return tryGetNoNotify(value); });
+        }
+        notify();
         return value;
     }
 
-    // Non blocking get
+    // Non blocking get. Consumer thread only.
     bool tryGet(T& result) VL_MT_SAFE_EXCLUDES(m_mutex) {
-        const VerilatedLockGuard lockGuard{m_mutex};
-        if (m_queue.empty()) return false;
-        result = m_queue.front();
-        m_queue.pop_front();
+        if (!tryGetNoNotify(result)) return false;
+        notify();
         return true;
     }
 };
@@ -205,12 +261,16 @@ private:
 
     // Passed a ParallelWorkerData*, second argument is ignored
     static void parallelWorkerTask(void*, bool);
+    // Range of offloaded callbacks run by one parallel job, filling one offload buffer
+    using OffloadJob = std::pair<const CallbackRecord*, const CallbackRecord*>;
+    // Passed a 'const OffloadJob*', runs its callbacks. Usable as a 'dumpCb_t'
+    static void offloadJobCb(void*, Buffer*);
 
 protected:
     uint32_t* m_sigs_oldvalp = nullptr;  // Previous value store
     EData* m_sigs_enabledp = nullptr;  // Bit vector of enabled codes (nullptr = all on)
 private:
-    std::vector<bool> m_sigs_enabledVec;  // Staging for m_sigs_enabledp
+    std::vector<bool> m_sigs_enabledVec;  // Codes enabled by dumpvars, empty = all
     std::vector<CallbackRecord> m_initCbs;  // Routines to initialize tracing
     std::vector<CallbackRecord> m_fullCbs;  // Routines to perform full dump
     std::vector<CallbackRecord> m_fullOffloadCbs;  // Routines to perform offloaded full dump
@@ -223,37 +283,65 @@ private:
     uint32_t m_maxBits = 0;  // Number of bits in the widest signal
     std::vector<std::string> m_namePrefixStack{""};  // Path prefixes to add to signal names
     std::vector<std::pair<int, std::string>> m_dumpvars;  // dumpvar() entries
+    // Codes declared in each scope, to apply scopeEnable() entries to
+    struct ScopeCodes final {
+        uint32_t m_scope;  // Index into m_scopeNames
+        uint32_t m_lo;  // First code
+        uint32_t m_hi;  // One past the last code
+    };
+    std::vector<std::string> m_scopeNames;  // Names of declaring scopes, space separated
+    std::vector<ScopeCodes> m_scopeCodes;  // Code ranges, in declaration order
+    std::vector<std::pair<std::string, bool>> m_scopeEnables;  // scopeEnable() entries
     char m_scopeEscape = '.';
     double m_timeRes = 1e-9;  // Time resolution (ns/ms etc)
     double m_timeUnit = 1e-0;  // Time units (ns/ms etc)
     uint64_t m_timeLastDump = 0;  // Last time we did a dump
     bool m_didSomeDump = false;  // Did at least one dump (i.e.: m_timeLastDump is valid)
+    uint32_t m_sampleEvery = 1;  // Write every Nth dump() call, see sampleEvery()
+    uint64_t m_sampleCount = 0;  // Calls to dump() counted for m_sampleEvery
+    uint64_t m_samplePeriod = 0;  // Sampling window period, 0 = none, see sampleWindow()
+    uint64_t m_sampleWidth = 0;  // Sampling window width
+    uint64_t m_sampleStart = 0;  // Start time of the first sampling window
+    uint64_t m_sampleWindow = 0;  // Number of the current sampling window + 1, 0 = none
     VerilatedContext* m_contextp = nullptr;  // The context used by the traced models
     std::unordered_set<const VerilatedModel*> m_models;  // The collection of models being traced
 
     void addCallbackRecord(std::vector<CallbackRecord>& cbVec, CallbackRecord&& cbRec)
         VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Recompute m_sigs_enabledp from dumpvars and scopeEnable() entries
+    void applyScopeEnables();
+    // Return true if a dump() at the given time is written, per the sampling settings
+    bool sampled(uint64_t timeui) VL_REQUIRES(m_mutex);
 
     // Equivalent to 'this' but is of the sub-type 'T_Trace*'. Use 'self()->'
     // to access duck-typed functions to avoid a virtual function call.
     T_Trace* self() { return static_cast<T_Trace*>(this); }
 
     void runCallbacks(const std::vector<CallbackRecord>& cbVec);
-    void runOffloadedCallbacks(const std::vector<CallbackRecord>& cbVec);
+    // Returns the offload buffer to complete, which differs from 'bufferp' if the callbacks
+    // were run in parallel, each job filling its own offload buffer
+    uint32_t* runOffloadedCallbacks(const std::vector<CallbackRecord>& cbVec, uint32_t* bufferp);
 
     // Flush any remaining data for this file
     static void onFlush(void* selfp) VL_MT_UNSAFE_ONE;
     // Close the file on termination
     static void onExit(void* selfp) VL_MT_UNSAFE_ONE;
+    // Stop writing to the parent's file in a forked child
+    static void onFork(void* selfp) VL_MT_UNSAFE_ONE;
 
+    // Maximum number of offload buffers allocated
+    static constexpr uint32_t MAX_OFFLOAD_BUFFERS = 8;
     // Number of total offload buffers that have been allocated
     uint32_t m_numOffloadBuffers = 0;
     // Size of offload buffers
     size_t m_offloadBufferSize = 0;
     // Buffers handed to worker for processing
-    VerilatedThreadQueue<uint32_t*> m_offloadBuffersToWorker;
+    VerilatedThreadQueue<uint32_t*, MAX_OFFLOAD_BUFFERS> m_offloadBuffersToWorker;
     // Buffers returned from worker after processing
-    VerilatedThreadQueue<uint32_t*> m_offloadBuffersFromWorker;
+    VerilatedThreadQueue<uint32_t*, MAX_OFFLOAD_BUFFERS> m_offloadBuffersFromWorker;
+    // Buffers received from the worker by waitForOffloadBuffer, but not yet reused
+    uint32_t* m_offloadBuffersFree[MAX_OFFLOAD_BUFFERS];
+    uint32_t m_numOffloadBuffersFree = 0;
 
 protected:
     // Write pointer into current buffer
@@ -271,7 +359,7 @@ private:
     // The function executed by the offload worker thread
     void offloadWorkerThreadMain();
 
-    // Wait until given offload buffer is placed in m_offloadBuffersFromWorker
+    // Wait until the worker has returned the given offload buffer
     void waitForOffloadBuffer(const uint32_t* bufferp);
 
     // Shut down and join worker, if it's running, otherwise do nothing
@@ -291,6 +379,8 @@ protected:
     uint32_t maxBits() const { return m_maxBits; }
     void fullDump(bool value) { m_fullDump = value; }
 
+    VerilatedContext* contextp() const { return m_contextp; }
+
     double timeRes() const { return m_timeRes; }
     double timeUnit() const { return m_timeUnit; }
     std::string timeResStr() const;
@@ -309,6 +399,8 @@ protected:
 
     void closeBase();
     void flushBase();
+    // In a forked child, abandon the offload worker of the parent
+    void detachBase();
 
     bool offload() const { return m_offload; }
     bool parallel() const { return m_parallel; }
@@ -347,6 +439,19 @@ public:
     // Set variables to dump, using $dumpvars format
     // If level = 0, dump everything and hier is then ignored
     void dumpvars(int level, const std::string& hier) VL_MT_SAFE;
+    // Enable or disable tracing of the given scope and everything under it,
+    // overriding dumpvars for them. May be called at any time; the next dump
+    // after enabling a scope is a full dump.
+    void scopeEnable(const std::string& hier, bool flag) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Decimate the trace, writing only every 'every'th call to dump(), 0 or 1
+    // to write every call. Changes in skipped calls are written by the next
+    // written dump, so the values in the trace remain exact.
+    void sampleEvery(uint32_t every) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Only write dumps within windows of 'width' time units, starting every
+    // 'period' time units from time 'start', 0 period to write at all times.
+    // The first dump written in each window is a full dump.
+    void sampleWindow(uint64_t period, uint64_t width, uint64_t start = 0)
+        VL_MT_SAFE_EXCLUDES(m_mutex);
 
     // Call
     void dump(uint64_t timeui) VL_MT_SAFE_EXCLUDES(m_mutex);
@@ -414,6 +519,19 @@ public:
     // duck-typed void emitDouble(uint32_t code, double newval) = 0;
 
     VL_ATTR_ALWINLINE uint32_t* oldp(uint32_t code) { return m_sigs_oldvalp + code; }
+    // Return false if all of codes [lo, hi) are disabled, so their dump can be skipped
+    VL_ATTR_ALWINLINE bool anyEnabled(uint32_t lo, uint32_t hi) const {
+        if (VL_LIKELY(!m_sigs_enabledp)) return true;
+        const uint32_t loWord = VL_BITWORD_I(lo);
+        const uint32_t hiWord = VL_BITWORD_I(hi - 1);
+        for (uint32_t w = loWord; w <= hiWord; ++w) {
+            EData bits = m_sigs_enabledp[w];
+            if (w == loWord) bits &= ~0U << VL_BITBIT_I(lo);
+            if (w == hiWord) bits &= ~0U >> (VL_EDATASIZE - 1 - VL_BITBIT_I(hi - 1));
+            if (bits) return true;
+        }
+        return false;
+    }
 
     // Write to previous value buffer value and emit trace entry.
     void fullBit(uint32_t* oldp, CData newval);
@@ -429,6 +547,44 @@ public:
     // and are called chg*. In offload mode, they are called by the worker
     // thread and are called chg*Impl
 
+    // Return true if any of the 'words' words differ. Wide signals are mostly
+    // unchanged, so compare as many words per instruction as available.
+    VL_ATTR_ALWINLINE static bool changedW(const uint32_t* oldp, const WData* newvalp,
+                                           int words) {
+        int i = 0;
+#ifdef VL_HAVE_AVX512F
+        for (; i + 16 <= words; i += 16) {
+            const __m512i a = _mm512_loadu_si512(oldp + i);
+            const __m512i b = _mm512_loadu_si512(newvalp + i);
+            if (VL_UNLIKELY(_mm512_cmpneq_epi32_mask(a, b))) return true;
+        }
+#endif
+#ifdef VL_HAVE_AVX2
+        for (; i + 8 <= words; i += 8) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(oldp + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(newvalp + i));
+            const __m256i d = _mm256_xor_si256(a, b);
+            if (VL_UNLIKELY(!_mm256_testz_si256(d, d))) return true;
+        }
+#endif
+#if defined(VL_HAVE_SSE2)
+        for (; i + 4 <= words; i += 4) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(oldp + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(newvalp + i));
+            if (VL_UNLIKELY(_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) != 0xffff)) return true;
+        }
+#elif defined(VL_HAVE_NEON)
+        for (; i + 4 <= words; i += 4) {
+            const uint32x4_t d = veorq_u32(vld1q_u32(oldp + i), vld1q_u32(newvalp + i));
+            if (VL_UNLIKELY(vmaxvq_u32(d))) return true;
+        }
+#endif
+        for (; i < words; ++i) {
+            if (VL_UNLIKELY(oldp[i] ^ newvalp[i])) return true;
+        }
+        return false;
+    }
+
     // Check previous dumped value of signal. If changed, then emit trace entry
     VL_ATTR_ALWINLINE void chgBit(uint32_t* oldp, CData newval) {
         const uint32_t diff = *oldp ^ newval;
@@ -451,11 +607,8 @@ public:
         if (VL_UNLIKELY(diff)) fullQData(oldp, newval, bits);
     }
     VL_ATTR_ALWINLINE void chgWData(uint32_t* oldp, const WData* newvalp, int bits) {
-        for (int i = 0; i < (bits + 31) / 32; ++i) {
-            if (VL_UNLIKELY(oldp[i] ^ newvalp[i])) {
-                fullWData(oldp, newvalp, bits);
-                return;
-            }
+        if (VL_UNLIKELY(changedW(oldp, newvalp, VL_WORDS_I(bits)))) {
+            fullWData(oldp, newvalp, bits);
         }
     }
     VL_ATTR_ALWINLINE void chgEvent(uint32_t* oldp, VlEvent newval) { fullEvent(oldp, newval); }
@@ -27,8 +27,14 @@
 #include "verilated_intrinsics.h"
 #include "verilated_trace.h"
 #include "verilated_threads.h"
+#include <algorithm>
 #include <list>
 
+#if !defined(_WIN32) && !defined(__MINGW32__)
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
 #if 0
 # include <iostream>
 # define VL_TRACE_OFFLOAD_DEBUG(msg) std::cout << "TRACE OFFLOAD THREAD: " << msg << std::endl
@@ -41,6 +47,19 @@
 //=============================================================================
 // Static utility functions
 
+// Point file descriptor 'fd' at /dev/null. Used in a forked child to make
+// sure nothing, including libc flushing a stream on exit, can append to a
+// file the parent is writing.
+static inline void detachFd(int fd) VL_MT_SAFE {
+#if !defined(_WIN32) && !defined(__MINGW32__)
+    if (fd < 0) return;
+    const int nullFd = ::open("/dev/null", O_WRONLY);
+    if (nullFd < 0) return;
+    ::dup2(nullFd, fd);
+    ::close(nullFd);
+#endif
+}
+
 static double timescaleToDouble(const char* unitp) VL_PURE {
     char* endp = nullptr;
     double value = std::strtod(unitp, &endp);
@@ -82,9 +101,11 @@ static std::string doubleToTimescale(double value) VL_PURE {
 template <>
 uint32_t* VerilatedTrace<VL_SUB_T, VL_BUF_T>::getOffloadBuffer() {
     uint32_t* bufferp;
+    // Reuse any buffer already received from the worker first
+    if (m_numOffloadBuffersFree) return m_offloadBuffersFree[--m_numOffloadBuffersFree];
     // Some jitter is expected, so some number of alternative offload buffers are
-    // required, but don't allocate more than 8 buffers.
-    if (m_numOffloadBuffers < 8) {
+    // required, but don't allocate more than MAX_OFFLOAD_BUFFERS buffers.
+    if (m_numOffloadBuffers < MAX_OFFLOAD_BUFFERS) {
         // Allocate a new buffer if none is available
         if (!m_offloadBuffersFromWorker.tryGet(bufferp)) {
             ++m_numOffloadBuffers;
@@ -102,14 +123,13 @@ uint32_t* VerilatedTrace<VL_SUB_T, VL_BUF_T>::getOffloadBuffer() {
 template <>
 void VerilatedTrace<VL_SUB_T, VL_BUF_T>::waitForOffloadBuffer(const uint32_t* buffp) {
     // Slow path code only called on flush/shutdown, so use a simple algorithm.
-    // Collect buffers from worker and stash them until we get the one we want.
-    std::deque<uint32_t*> stash;
-    do { stash.push_back(m_offloadBuffersFromWorker.get()); } while (stash.back() != buffp);
-    // Now put them back in the queue, in the original order.
-    while (!stash.empty()) {
-        m_offloadBuffersFromWorker.put_front(stash.back());
-        stash.pop_back();
-    }
+    // Collect buffers from worker and keep them for reuse until we get the one we want.
+    uint32_t* bufferp;
+    do {
+        bufferp = m_offloadBuffersFromWorker.get();
+        assert(m_numOffloadBuffersFree < MAX_OFFLOAD_BUFFERS);
+        m_offloadBuffersFree[m_numOffloadBuffersFree++] = bufferp;
+    } while (bufferp != buffp);
 }
 
 //=========================================================================
@@ -258,6 +278,10 @@ template <>
 void VerilatedTrace<VL_SUB_T, VL_BUF_T>::closeBase() {
     if (offload()) {
         shutdownOffloadWorker();
+        while (m_numOffloadBuffersFree) {
+            delete[] m_offloadBuffersFree[--m_numOffloadBuffersFree];
+            --m_numOffloadBuffers;
+        }
         while (m_numOffloadBuffers) {
             delete[] m_offloadBuffersFromWorker.get();
             --m_numOffloadBuffers;
@@ -267,7 +291,7 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::closeBase() {
 
 template <>
 void VerilatedTrace<VL_SUB_T, VL_BUF_T>::flushBase() {
-    if (offload()) {
+    if (offload() && m_workerThread) {
         // Hand an empty buffer to the worker thread
         uint32_t* const bufferp = getOffloadBuffer();
         *bufferp = VerilatedTraceOffloadCommand::END;
@@ -293,6 +317,29 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::onExit(void* selfp) {
     reinterpret_cast<VL_SUB_T*>(selfp)->close();
 }
 
+template <>
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFork(void* selfp) {
+    // This calls 'detach' on the derived class (which must then get any mutex)
+    reinterpret_cast<VL_SUB_T*>(selfp)->detach();
+}
+
+//=============================================================================
+// Fork support
+
+template <>
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::detachBase() {
+    Verilated::removeFlushCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFlush, this);
+    Verilated::removeExitCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onExit, this);
+    Verilated::removeForkCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFork, this);
+    if (offload()) {
+        // The worker thread does not exist in the child, and its std::thread
+        // record cannot be joined or destroyed, so leak it. Buffers it held
+        // are leaked too, closeBase must not wait for them.
+        (void)m_workerThread.release();
+        m_numOffloadBuffers = m_numOffloadBuffersFree;
+    }
+}
+
 //=============================================================================
 // VerilatedTrace
 
@@ -308,12 +355,46 @@ VerilatedTrace<VL_SUB_T, VL_BUF_T>::~VerilatedTrace() {
     if (m_sigs_enabledp) VL_DO_CLEAR(delete[] m_sigs_enabledp, m_sigs_enabledp = nullptr);
     Verilated::removeFlushCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFlush, this);
     Verilated::removeExitCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onExit, this);
+    Verilated::removeForkCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFork, this);
     if (offload()) closeBase();
 }
 
 //=========================================================================
 // Internals available to format specific implementations
 
+template <>
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::applyScopeEnables() {
+    if (m_scopeEnables.empty()) return;
+    // State of each scope is set by the last matching scopeEnable, else by dumpvars
+    enum : uint8_t { DUMPVARS, ON, OFF };
+    std::vector<uint8_t> states(m_scopeNames.size(), DUMPVARS);
+    for (const auto& item : m_scopeEnables) {
+        const std::string& hier = item.first;
+        for (size_t s = 0; s < m_scopeNames.size(); ++s) {
+            // e.g. "t" matches "t" and "t sub", but not "top"
+            const std::string& name = m_scopeNames[s];
+            if (name.compare(0, hier.size(), hier) == 0
+                && (name.size() == hier.size() || name[hier.size()] == ' ')) {
+                states[s] = item.second ? ON : OFF;
+            }
+        }
+    }
+    // A code is enabled if any signal declared with it is, as aliases share codes
+    const size_t words = 1 + VL_WORDS_I(nextCode());
+    if (!m_sigs_enabledp) m_sigs_enabledp = new uint32_t[words];
+    std::fill_n(m_sigs_enabledp, words, 0);
+    for (const ScopeCodes& item : m_scopeCodes) {
+        const uint8_t state = states[item.m_scope];
+        if (state == OFF) continue;
+        for (uint32_t code = item.m_lo; code < item.m_hi; ++code) {
+            if (state == ON || m_sigs_enabledVec.empty()
+                || (code < m_sigs_enabledVec.size() && m_sigs_enabledVec[code])) {
+                m_sigs_enabledp[VL_BITWORD_I(code)] |= 1U << VL_BITBIT_I(code);
+            }
+        }
+    }
+}
+
 template <>
 void VerilatedTrace<VL_SUB_T, VL_BUF_T>::traceInit() VL_MT_UNSAFE {
     // Note: It is possible to re-open a trace file (VCD in particular),
@@ -324,6 +405,8 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::traceInit() VL_MT_UNSAFE {
     m_numSignals = 0;
     m_maxBits = 0;
     m_sigs_enabledVec.clear();
+    m_scopeNames.clear();
+    m_scopeCodes.clear();
 
     // Call all initialize callbacks, which will:
     // - Call decl* for each signal (these eventually call ::declCode)
@@ -356,12 +439,14 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::traceInit() VL_MT_UNSAFE {
                 m_sigs_enabledp[VL_BITWORD_I(code)] |= 1U << VL_BITBIT_I(code);
             }
         }
-        m_sigs_enabledVec.clear();
+        // m_sigs_enabledVec is kept for applyScopeEnables
     }
+    applyScopeEnables();
 
     // Set callback so flush/abort will flush this file
     Verilated::addFlushCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFlush, this);
     Verilated::addExitCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onExit, this);
+    Verilated::addForkCb(VerilatedTrace<VL_SUB_T, VL_BUF_T>::onFork, this);
 
     if (offload()) {
         // Compute offload buffer size. we need to be able to store a new value for
@@ -414,6 +499,19 @@ bool VerilatedTrace<VL_SUB_T, VL_BUF_T>::declCode(uint32_t code, const char* nam
     // compatibility with some foreign code.
     int codesNeeded = VL_WORDS_I(bits);
     if (tri) codesNeeded *= 2;
+
+    // Record the declaring scope for scopeEnable. Signals of a scope are
+    // declared together, so only the last scope needs checking.
+    const size_t pos = declName.rfind(' ');
+    const std::string scope = pos == std::string::npos ? "" : declName.substr(0, pos);
+    if (m_scopeNames.empty() || m_scopeNames.back() != scope) m_scopeNames.push_back(scope);
+    const uint32_t scopeIdx = m_scopeNames.size() - 1;
+    if (!m_scopeCodes.empty() && m_scopeCodes.back().m_scope == scopeIdx
+        && m_scopeCodes.back().m_hi == code) {
+        m_scopeCodes.back().m_hi = code + codesNeeded;
+    } else {
+        m_scopeCodes.push_back({scopeIdx, code, code + codesNeeded});
+    }
     m_nextCode = std::max(m_nextCode, code + codesNeeded);
     ++m_numSignals;
     m_maxBits = std::max(m_maxBits, bits);
@@ -461,6 +559,66 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::dumpvars(int level, const std::string&
     }
 }
 
+template <>
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::scopeEnable(const std::string& hier,
+                                                     bool flag) VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    // Convert Verilog . separators to trace space separators
+    std::string hierSpaced = hier;
+    for (auto& i : hierSpaced) {
+        if (i == '.') i = ' ';
+    }
+    // Later entries override earlier ones, so only the latest for a scope matters
+    m_scopeEnables.erase(std::remove_if(m_scopeEnables.begin(), m_scopeEnables.end(),
+                                        [&](const std::pair<std::string, bool>& item) {
+                                            return item.first == hierSpaced;
+                                        }),
+                         m_scopeEnables.end());
+    m_scopeEnables.emplace_back(hierSpaced, flag);
+    if (!m_sigs_oldvalp) return;  // Not open yet, applied by traceInit
+    // The offload worker must not see the enables change part way through a dump
+    flushBase();
+    applyScopeEnables();
+    // Re-enabled signals were not dumped while off, so dump all values next
+    if (flag) m_fullDump = true;
+}
+
+template <>
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::sampleEvery(uint32_t every)
+    VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    m_sampleEvery = every ? every : 1;
+    m_sampleCount = 0;
+}
+
+template <>
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::sampleWindow(uint64_t period, uint64_t width,
+                                                      uint64_t start)
+    VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    m_samplePeriod = period;
+    m_sampleWidth = width;
+    m_sampleStart = start;
+    m_sampleWindow = 0;
+}
+
+template <>
+bool VerilatedTrace<VL_SUB_T, VL_BUF_T>::sampled(uint64_t timeui) VL_REQUIRES(m_mutex) {
+    if (m_samplePeriod) {
+        if (timeui < m_sampleStart) return false;
+        const uint64_t offset = timeui - m_sampleStart;
+        if (offset % m_samplePeriod >= m_sampleWidth) return false;
+        const uint64_t window = offset / m_samplePeriod + 1;
+        if (window != m_sampleWindow) {
+            // Resynchronize at the start of each window, so it reads on its own
+            m_sampleWindow = window;
+            m_sampleCount = 0;
+            m_fullDump = true;
+        }
+    }
+    return m_sampleCount++ % m_sampleEvery == 0;
+}
+
 template <>
 void VerilatedTrace<VL_SUB_T, VL_BUF_T>::parallelWorkerTask(void* datap, bool) {
     ParallelWorkerData* const wdp = reinterpret_cast<ParallelWorkerData*>(datap);
@@ -488,9 +646,11 @@ VL_ATTR_NOINLINE void VerilatedTrace<VL_SUB_T, VL_BUF_T>::ParallelWorkerData::wa
 
 template <>
 void VerilatedTrace<VL_SUB_T, VL_BUF_T>::runCallbacks(const std::vector<CallbackRecord>& cbVec) {
-    if (parallel()) {
-        // If tracing in parallel, dispatch to the thread pool
-        VlThreadPool* threadPoolp = static_cast<VlThreadPool*>(m_contextp->threadPoolp());
+    // If tracing in parallel, dispatch to the thread pool. A single threaded context
+    // has no pool, then the buffers are rendered in turn on this thread.
+    VlThreadPool* const threadPoolp
+        = parallel() ? static_cast<VlThreadPool*>(m_contextp->threadPoolp()) : nullptr;
+    if (threadPoolp) {
         // List of work items for thread (std::list, as ParallelWorkerData is not movable)
         std::list<ParallelWorkerData> workerData;
         // We use the whole pool + the main thread
@@ -537,14 +697,77 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::runCallbacks(const std::vector<Callback
 }
 
 template <>
-void VerilatedTrace<VL_SUB_T, VL_BUF_T>::runOffloadedCallbacks(
-    const std::vector<CallbackRecord>& cbVec) {
+void VerilatedTrace<VL_SUB_T, VL_BUF_T>::offloadJobCb(void* userp, Buffer* bufp) {
+    const OffloadJob* const jobp = static_cast<const OffloadJob*>(userp);
+    OffloadBuffer* const offloadBufp = static_cast<OffloadBuffer*>(bufp);
+    for (const CallbackRecord* cbrp = jobp->first; cbrp != jobp->second; ++cbrp) {
+        cbrp->m_dumpOffloadCb(cbrp->m_userp, offloadBufp);
+    }
+}
+
+template <>
+uint32_t* VerilatedTrace<VL_SUB_T, VL_BUF_T>::runOffloadedCallbacks(
+    const std::vector<CallbackRecord>& cbVec, uint32_t* bufferp) {
+    VlThreadPool* const threadPoolp
+        = bufferp ? static_cast<VlThreadPool*>(m_contextp->threadPoolp()) : nullptr;
+    if (threadPoolp && cbVec.size() > 1) {
+        // Capture the traced values in parallel on the thread pool (idle between evals),
+        // so the eval thread is not serialized on copying the whole snapshot. Each job
+        // fills its own offload buffer, which are then handed to the worker in job
+        // order, so it sees the same command stream as sequential capture. At most half
+        // the offload buffers are used at once, so getOffloadBuffer cannot deadlock.
+        const size_t nThreads = threadPoolp->numThreads() + 1;
+        const size_t nJobs = std::min<size_t>({cbVec.size(), nThreads, MAX_OFFLOAD_BUFFERS / 2});
+        std::vector<OffloadJob> jobs;
+        jobs.reserve(nJobs);  // Must not reallocate, as jobs are referenced by worker data
+        std::vector<uint32_t*> bufferps;
+        // List of work items for thread (std::list, as ParallelWorkerData is not movable)
+        std::list<ParallelWorkerData> workerData;
+        for (size_t i = 0; i < nJobs; ++i) {
+            const CallbackRecord* const cbrp = cbVec.data();
+            jobs.emplace_back(cbrp + i * cbVec.size() / nJobs,
+                              cbrp + (i + 1) * cbVec.size() / nJobs);
+            // The first job continues the current buffer, after the time change
+            if (i) {
+                bufferps.push_back(getOffloadBuffer());
+                m_offloadBufferWritep = bufferps.back();
+                m_offloadBufferEndp = bufferps.back() + m_offloadBufferSize;
+            } else {
+                bufferps.push_back(bufferp);
+            }
+            // Always get the trace buffer on the main thread
+            workerData.emplace_back(offloadJobCb, &jobs.back(), getTraceBuffer());
+        }
+        // Enqueue all but the first job to the thread pool, main thread executes the first
+        auto it = workerData.begin();
+        for (size_t i = 1; i < nJobs; ++i) {
+            threadPoolp->workerp(i - 1)->addTask(parallelWorkerTask, &*(++it));
+        }
+        parallelWorkerTask(&workerData.front(), false);
+        // Commit all trace buffers in order, and hand all but the last offload buffer
+        // to the worker thread
+        it = workerData.begin();
+        for (size_t i = 0; i < nJobs; ++i, ++it) {
+            // Wait until ready
+            it->wait();
+            // Commit the buffer, this updates m_offloadBufferWritep
+            commitTraceBuffer(it->m_bufp);
+            if (i == nJobs - 1) break;
+            *m_offloadBufferWritep++ = VerilatedTraceOffloadCommand::END;
+            assert(static_cast<size_t>(m_offloadBufferWritep - bufferps[i])
+                   <= m_offloadBufferSize);
+            m_offloadBuffersToWorker.put(bufferps[i]);
+        }
+        m_offloadBufferEndp = bufferps.back() + m_offloadBufferSize;
+        return bufferps.back();
+    }
     // Fall back on sequential execution
     for (const CallbackRecord& cbr : cbVec) {
         Buffer* traceBufferp = getTraceBuffer();
         cbr.m_dumpOffloadCb(cbr.m_userp, static_cast<OffloadBuffer*>(traceBufferp));
         commitTraceBuffer(traceBufferp);
     }
+    return bufferp;
 }
 
 template <>
@@ -562,6 +785,23 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::dump(uint64_t timeui) VL_MT_SAFE_EXCLUD
     m_timeLastDump = timeui;
     m_didSomeDump = true;
 
+    // Skip dumps not sampled. Activity flags are only cleared by dumps that are written, so
+    // the next change dump written still includes all changes since the previous one.
+    if (VL_UNLIKELY(m_sampleEvery > 1 || m_samplePeriod) && !sampled(timeui)) return;
+
+    // Runtime statistics, see VerilatedContext::stats()
+    struct DumpTimer final {
+        VerilatedContext* const m_contextp;
+        const uint64_t m_startNs = VerilatedContextStats::nowNs();
+        ~DumpTimer() {
+            if (VL_UNLIKELY(!m_contextp)) return;
+            m_contextp->stats().add(VerilatedContextStats::TRACE_DUMPS);
+            m_contextp->stats().add(VerilatedContextStats::TRACE_DUMP_NS,
+                                    VerilatedContextStats::nowNs() - m_startNs);
+        }
+    };
+    const DumpTimer timer{m_contextp};
+
     Verilated::quiesce();
 
     // Call hook for format specific behaviour
@@ -598,13 +838,13 @@ void VerilatedTrace<VL_SUB_T, VL_BUF_T>::dump(uint64_t timeui) VL_MT_SAFE_EXCLUD
     if (VL_UNLIKELY(m_fullDump)) {
         m_fullDump = false;  // No more need for next dump to be full
         if (offload()) {
-            runOffloadedCallbacks(m_fullOffloadCbs);
+            runOffloadedCallbacks(m_fullOffloadCbs, nullptr);
         } else {
             runCallbacks(m_fullCbs);
         }
     } else {
         if (offload()) {
-            runOffloadedCallbacks(m_chgOffloadCbs);
+            bufferp = runOffloadedCallbacks(m_chgOffloadCbs, bufferp);
         } else {
             runCallbacks(m_chgCbs);
         }
@@ -790,8 +1030,8 @@ static inline void cvtSDataToStr(char* dstp, SData value) {
 #endif
 }
 
-static inline void cvtIDataToStr(char* dstp, IData value) {
-#ifdef VL_HAVE_AVX2
+#if defined(VL_HAVE_AVX2) || defined(VL_HAVE_AVX2_DISPATCH)
+VL_ATTR_TARGET_AVX2 static inline void cvtIDataToStrAvx2(char* dstp, IData value) {
     // Similar to cvtSDataToStr but the bottom 16-bits are processed in the
     // top half of the YMM registers
     const __m256i a = _mm256_insert_epi32(_mm256_undefined_si256(), value, 0);
@@ -803,7 +1043,20 @@ static inline void cvtIDataToStr(char* dstp, IData value) {
     const __m256i d = _mm256_cmpeq_epi8(_mm256_and_si256(c, m), m);
     const __m256i result = _mm256_sub_epi8(_mm256_set1_epi8('0'), d);
     _mm256_storeu_si256(reinterpret_cast<__m256i*>(dstp), result);
+}
+#endif
+
+static inline void cvtIDataToStr(char* dstp, IData value) {
+#if defined(VL_HAVE_AVX2)
+    cvtIDataToStrAvx2(dstp, value);
 #else
+#ifdef VL_HAVE_AVX2_DISPATCH
+    // Not compiled for AVX2, but use it if the executing CPU has it
+    if (VL_LIKELY(vlCpuHasAvx2())) {
+        cvtIDataToStrAvx2(dstp, value);
+        return;
+    }
+#endif
     cvtSDataToStr(dstp, value >> 16);
     cvtSDataToStr(dstp + 16, value);
 #endif
@@ -32,11 +32,17 @@
 #include <array>
 #include <atomic>
 #include <deque>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <new>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 //===================================================================
 // String formatters (required by below containers)
@@ -106,9 +112,10 @@ public:
 
     // Return true iff at least one element is set
     bool any() const {
-        for (size_t i = 0; i < m_flags.size(); ++i)
-            if (m_flags[i]) return true;
-        return false;
+        // Branch free, so the compiler can vectorize it
+        uint64_t result = 0;
+        for (size_t i = 0; i < m_flags.size(); ++i) result |= m_flags[i];
+        return result != 0;
     }
 
     // Set all elements true in 'this' that are set in 'other'
@@ -193,15 +200,24 @@ class VlReadMem final {
     const int m_bits;  // Bit width of values
     const std::string& m_filename;  // Filename
     const QData m_end;  // End address (as specified by user)
-    FILE* m_fp = nullptr;  // File handle for filename
+    bool m_open = false;  // File was opened
+    const char* m_cp = nullptr;  // Next character to parse
+    const char* m_endp = nullptr;  // End of file contents
+    void* m_mapp = nullptr;  // File contents when memory mapped
+    size_t m_mapSize = 0;  // Size of m_mapp mapping
+    std::vector<char> m_buf;  // File contents when could not map
     QData m_addr = 0;  // Next address to read
     int m_linenum = 0;  // Line number last read from file
     bool m_anyAddr = false;  // Had address directive in the file
+    bool m_anyX = false;  // Had x digits, so values are random
 public:
     VlReadMem(bool hex, int bits, const std::string& filename, QData start, QData end);
     ~VlReadMem();
-    bool isOpen() const { return m_fp != nullptr; }
+    bool isOpen() const { return m_open; }
     int linenum() const { return m_linenum; }
+    QData addr() const { return m_addr; }
+    bool anyAddr() const { return m_anyAddr; }
+    bool anyX() const { return m_anyX; }
     bool get(QData& addrr, std::string& valuer);
     void setData(void* valuep, const std::string& rhs);
 };
@@ -277,6 +293,269 @@ std::string VL_TO_STRING(const VlWide<T_Words>& obj) {
     return VL_TO_STRING_W(T_Words, obj.data());
 }
 
+//===================================================================
+// Verilog queue storage
+// Ring buffer with inline storage for the first few elements, so small
+// queues (e.g. mailboxes and scoreboards holding a handful of items) need
+// no heap allocation, unlike std::deque which allocates even when empty.
+// Spills to the heap, doubling in size, when the inline storage is full.
+
+#ifndef VL_QUEUE_INLINE_BYTES
+#define VL_QUEUE_INLINE_BYTES 64  ///< Bytes of inline storage in each VlQueue
+#endif
+
+template <class T_Value>
+class VlQueueBuffer final {
+    // CONSTANTS
+    static constexpr size_t floorPow2(size_t n) { return n < 2 ? n : 2 * floorPow2(n / 2); }
+    // Capacity must be a power of two so indexes wrap with a mask
+    static constexpr size_t INLINE_SIZE = floorPow2(VL_QUEUE_INLINE_BYTES / sizeof(T_Value));
+
+public:
+    // TYPES
+    template <bool T_Const>
+    class Iterator final {
+        friend class VlQueueBuffer;
+        template <bool U_Const>
+        friend class Iterator;
+        using Buffer = typename std::conditional<T_Const, const VlQueueBuffer, VlQueueBuffer>::type;
+        Buffer* m_bufp = nullptr;  // Buffer iterated over
+        ptrdiff_t m_index = 0;  // Element index, from front
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T_Value;
+        using difference_type = ptrdiff_t;
+        using pointer = typename std::conditional<T_Const, const T_Value*, T_Value*>::type;
+        using reference = typename std::conditional<T_Const, const T_Value&, T_Value&>::type;
+
+        Iterator() = default;
+        Iterator(Buffer* bufp, ptrdiff_t index)
+            : m_bufp{bufp}
+            , m_index{index} {}
+        // Allow conversion from iterator to const_iterator
+        template <bool U_Const, typename = typename std::enable_if<T_Const && !U_Const>::type>
+        Iterator(const Iterator<U_Const>& other)
+            : m_bufp{other.m_bufp}
+            , m_index{other.m_index} {}
+
+        reference operator*() const { return (*m_bufp)[m_index]; }
+        pointer operator->() const { return &(*m_bufp)[m_index]; }
+        reference operator[](difference_type n) const { return (*m_bufp)[m_index + n]; }
+        Iterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+        Iterator operator++(int) {
+            const Iterator old = *this;
+            ++m_index;
+            return old;
+        }
+        Iterator& operator--() {
+            --m_index;
+            return *this;
+        }
+        Iterator operator--(int) {
+            const Iterator old = *this;
+            --m_index;
+            return old;
+        }
+        Iterator& operator+=(difference_type n) {
+            m_index += n;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) {
+            m_index -= n;
+            return *this;
+        }
+        Iterator operator+(difference_type n) const { return Iterator{m_bufp, m_index + n}; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+        Iterator operator-(difference_type n) const { return Iterator{m_bufp, m_index - n}; }
+        difference_type operator-(const Iterator& rhs) const { return m_index - rhs.m_index; }
+        bool operator==(const Iterator& rhs) const { return m_index == rhs.m_index; }
+        bool operator!=(const Iterator& rhs) const { return m_index != rhs.m_index; }
+        bool operator<(const Iterator& rhs) const { return m_index < rhs.m_index; }
+        bool operator>(const Iterator& rhs) const { return m_index > rhs.m_index; }
+        bool operator<=(const Iterator& rhs) const { return m_index <= rhs.m_index; }
+        bool operator>=(const Iterator& rhs) const { return m_index >= rhs.m_index; }
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    // MEMBERS
+    T_Value* m_datap;  // Storage, either m_inline or on the heap
+    size_t m_capacity;  // Size of storage, a power of two, or zero
+    size_t m_head = 0;  // Storage index of front element
+    size_t m_size = 0;  // Number of elements
+    alignas(T_Value) unsigned char m_inline[INLINE_SIZE ? INLINE_SIZE * sizeof(T_Value) : 1];
+
+    // METHODS
+    T_Value* inlinep() { return reinterpret_cast<T_Value*>(m_inline); }
+    bool isInline() const { return m_datap == reinterpret_cast<const T_Value*>(m_inline); }
+    T_Value* slotp(size_t index) const { return m_datap + ((m_head + index) & (m_capacity - 1)); }
+    void initInline() {
+        m_datap = INLINE_SIZE ? inlinep() : nullptr;
+        m_capacity = INLINE_SIZE;
+        m_head = 0;
+        m_size = 0;
+    }
+    void freeStorage() {
+        if (m_datap && !isInline()) ::operator delete(m_datap);
+    }
+    void grow(size_t minCapacity) {
+        size_t newCapacity = m_capacity ? m_capacity * 2 : 4;
+        while (newCapacity < minCapacity) newCapacity *= 2;
+        T_Value* const newp = static_cast<T_Value*>(::operator new(newCapacity * sizeof(T_Value)));
+        for (size_t i = 0; i < m_size; ++i) {
+            T_Value* const oldp = slotp(i);
+            new (newp + i) T_Value(std::move(*oldp));
+            oldp->~T_Value();
+        }
+        freeStorage();
+        m_datap = newp;
+        m_capacity = newCapacity;
+        m_head = 0;
+    }
+    void moveFrom(VlQueueBuffer&& other) {
+        if (other.m_datap && !other.isInline()) {
+            // Take over heap storage
+            m_datap = other.m_datap;
+            m_capacity = other.m_capacity;
+            m_head = other.m_head;
+            m_size = other.m_size;
+            other.initInline();
+        } else {
+            for (size_t i = 0; i < other.m_size; ++i) push_back(std::move(other[i]));
+            other.clear();
+        }
+    }
+
+public:
+    // CONSTRUCTORS
+    VlQueueBuffer() { initInline(); }
+    ~VlQueueBuffer() {
+        clear();
+        freeStorage();
+    }
+    VlQueueBuffer(const VlQueueBuffer& other) {
+        initInline();
+        *this = other;
+    }
+    VlQueueBuffer(VlQueueBuffer&& other) {
+        initInline();
+        moveFrom(std::move(other));
+    }
+    VlQueueBuffer& operator=(const VlQueueBuffer& other) {
+        if (this == &other) return *this;
+        clear();
+        reserve(other.m_size);
+        for (size_t i = 0; i < other.m_size; ++i) push_back(other[i]);
+        return *this;
+    }
+    VlQueueBuffer& operator=(VlQueueBuffer&& other) {
+        if (this == &other) return *this;
+        clear();
+        freeStorage();
+        initInline();
+        moveFrom(std::move(other));
+        return *this;
+    }
+    bool operator==(const VlQueueBuffer& rhs) const {
+        return m_size == rhs.m_size && std::equal(begin(), end(), rhs.begin());
+    }
+    bool operator!=(const VlQueueBuffer& rhs) const { return !(*this == rhs); }
+
+    // METHODS
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    void reserve(size_t n) {
+        if (n > m_capacity) grow(n);
+    }
+    void clear() {
+        for (size_t i = 0; i < m_size; ++i) slotp(i)->~T_Value();
+        m_head = 0;
+        m_size = 0;
+    }
+    T_Value& operator[](size_t index) { return *slotp(index); }
+    const T_Value& operator[](size_t index) const { return *slotp(index); }
+    T_Value& front() { return *slotp(0); }
+    const T_Value& front() const { return *slotp(0); }
+    T_Value& back() { return *slotp(m_size - 1); }
+    const T_Value& back() const { return *slotp(m_size - 1); }
+    void push_back(const T_Value& value) {
+        if (VL_UNLIKELY(m_size == m_capacity)) {
+            T_Value copy{value};  // Value may be an element, so copy before growing
+            push_back(std::move(copy));
+            return;
+        }
+        new (slotp(m_size)) T_Value(value);
+        ++m_size;
+    }
+    void push_back(T_Value&& value) {
+        if (VL_UNLIKELY(m_size == m_capacity)) {
+            T_Value moved{std::move(value)};
+            grow(m_size + 1);
+            new (slotp(m_size)) T_Value(std::move(moved));
+        } else {
+            new (slotp(m_size)) T_Value(std::move(value));
+        }
+        ++m_size;
+    }
+    void push_front(const T_Value& value) {
+        T_Value copy{value};  // Value may be an element, so copy before growing
+        if (VL_UNLIKELY(m_size == m_capacity)) grow(m_size + 1);
+        m_head = (m_head - 1) & (m_capacity - 1);
+        new (m_datap + m_head) T_Value(std::move(copy));
+        ++m_size;
+    }
+    void pop_back() {
+        --m_size;
+        slotp(m_size)->~T_Value();
+    }
+    void pop_front() {
+        slotp(0)->~T_Value();
+        m_head = (m_head + 1) & (m_capacity - 1);
+        --m_size;
+    }
+    void resize(size_t n) { resize(n, T_Value{}); }
+    void resize(size_t n, const T_Value& value) {
+        while (m_size > n) pop_back();
+        if (m_size == n) return;
+        const T_Value fill{value};
+        reserve(n);
+        while (m_size < n) push_back(fill);
+    }
+    void insert(const_iterator pos, const T_Value& value) {
+        const ptrdiff_t index = pos.m_index;
+        push_back(value);
+        std::rotate(begin() + index, end() - 1, end());
+    }
+    void erase(const_iterator pos) {
+        const ptrdiff_t index = pos.m_index;
+        // Move whichever side of the element is shorter
+        if (static_cast<size_t>(index) < m_size / 2) {
+            std::move_backward(begin(), begin() + index, begin() + index + 1);
+            pop_front();
+        } else {
+            std::move(begin() + index + 1, end(), begin() + index);
+            pop_back();
+        }
+    }
+
+    // ITERATORS
+    iterator begin() { return iterator{this, 0}; }
+    iterator end() { return iterator{this, static_cast<ptrdiff_t>(m_size)}; }
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{this, static_cast<ptrdiff_t>(m_size)}; }
+    reverse_iterator rbegin() { return reverse_iterator{end()}; }
+    reverse_iterator rend() { return reverse_iterator{begin()}; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+    const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+};
+
 //===================================================================
 // Verilog queue and dynamic array container
 // There are no multithreaded locks on this; the base variable must
@@ -288,7 +567,7 @@ template <class T_Value, size_t T_MaxSize = 0>
 class VlQueue final {
 private:
     // TYPES
-    using Deque = std::deque<T_Value>;
+    using Deque = VlQueueBuffer<T_Value>;
 
 public:
     using const_iterator = typename Deque::const_iterator;
@@ -714,11 +993,15 @@ std::string VL_TO_STRING(const VlQueue<T_Value>& obj) {
 // There are no multithreaded locks on this; the base variable must
 // be protected by other means
 //
-template <class T_Key, class T_Value>
+// When T_Ordered is false the array is a hash table, which Verilator uses
+// for arrays that are never iterated in key order; methods needing order
+// (first/next/last/prev, find and reductions) are then not available
+template <class T_Key, class T_Value, bool T_Ordered = true>
 class VlAssocArray final {
 private:
     // TYPES
-    using Map = std::map<T_Key, T_Value>;
+    using Map = typename std::conditional<T_Ordered, std::map<T_Key, T_Value>,
+                                          std::unordered_map<T_Key, T_Value>>::type;
 
 public:
     using const_iterator = typename Map::const_iterator;
@@ -816,6 +1099,17 @@ public:
     // For save/restore
     const_iterator begin() const { return m_map.begin(); }
     const_iterator end() const { return m_map.end(); }
+    // Entries in key order, for printing when unordered
+    std::vector<const typename Map::value_type*> sortedEntries() const {
+        std::vector<const typename Map::value_type*> out;
+        out.reserve(m_map.size());
+        for (const auto& i : m_map) out.push_back(&i);
+        std::sort(out.begin(), out.end(),
+                  [](const typename Map::value_type* ap, const typename Map::value_type* bp) {
+                      return ap->first < bp->first;
+                  });
+        return out;
+    }
 
     // Methods
     VlQueue<T_Value> unique() const {
@@ -986,23 +1280,31 @@ public:
         if (m_map.empty()) return "'{}";  // No trailing space
         std::string out = "'{";
         std::string comma;
-        for (const auto& i : m_map) {
-            out += comma + VL_TO_STRING(i.first) + ":" + VL_TO_STRING(i.second);
-            comma = ", ";
+        if (T_Ordered) {
+            for (const auto& i : m_map) {
+                out += comma + VL_TO_STRING(i.first) + ":" + VL_TO_STRING(i.second);
+                comma = ", ";
+            }
+        } else {
+            for (const auto* const ip : sortedEntries()) {
+                out += comma + VL_TO_STRING(ip->first) + ":" + VL_TO_STRING(ip->second);
+                comma = ", ";
+            }
         }
         // Default not printed - maybe random init data
         return out + "} ";
     }
 };
 
-template <class T_Key, class T_Value>
-std::string VL_TO_STRING(const VlAssocArray<T_Key, T_Value>& obj) {
+template <class T_Key, class T_Value, bool T_Ordered>
+std::string VL_TO_STRING(const VlAssocArray<T_Key, T_Value, T_Ordered>& obj) {
     return obj.to_string();
 }
 
-template <class T_Key, class T_Value>
+template <class T_Key, class T_Value, bool T_Ordered>
 void VL_READMEM_N(bool hex, int bits, const std::string& filename,
-                  VlAssocArray<T_Key, T_Value>& obj, QData start, QData end) VL_MT_SAFE {
+                  VlAssocArray<T_Key, T_Value, T_Ordered>& obj, QData start,
+                  QData end) VL_MT_SAFE {
     VlReadMem rmem{hex, bits, filename, start, end};
     if (VL_UNLIKELY(!rmem.isOpen())) return;
     while (true) {
@@ -1016,14 +1318,15 @@ void VL_READMEM_N(bool hex, int bits, const std::string& filename,
     }
 }
 
-template <class T_Key, class T_Value>
+template <class T_Key, class T_Value, bool T_Ordered>
 void VL_WRITEMEM_N(bool hex, int bits, const std::string& filename,
-                   const VlAssocArray<T_Key, T_Value>& obj, QData start, QData end) VL_MT_SAFE {
+                   const VlAssocArray<T_Key, T_Value, T_Ordered>& obj, QData start,
+                   QData end) VL_MT_SAFE {
     VlWriteMem wmem{hex, bits, filename, start, end};
     if (VL_UNLIKELY(!wmem.isOpen())) return;
-    for (const auto& i : obj) {
-        const QData addr = i.first;
-        if (addr >= start && addr <= end) wmem.print(addr, true, &(i.second));
+    for (const auto* const ip : obj.sortedEntries()) {
+        const QData addr = ip->first;
+        if (addr >= start && addr <= end) wmem.print(addr, true, &(ip->second));
     }
 }
 
@@ -1099,10 +1402,123 @@ std::string VL_TO_STRING(const VlUnpacked<T_Value, T_Depth>& obj) {
     return obj.to_string();
 }
 
+//===================================================================
+/// Verilog sparse unpacked array container
+/// Used instead of VlUnpacked for unpacked arrays with at least
+/// --sparse-arrays elements, e.g. to model a full DRAM address space.
+/// Elements are stored in pages, allocated on first write; reading an
+/// element of a page never written returns zero.
+
+#ifndef VL_SPARSE_PAGE_BITS
+#define VL_SPARSE_PAGE_BITS 10  ///< log2 of elements in each VlSparseArray page
+#endif
+
+template <class T_Value, std::size_t T_Depth>
+class VlSparseArray final {
+public:
+    // CONSTANTS
+    static constexpr size_t PAGE_SIZE = static_cast<size_t>(1) << VL_SPARSE_PAGE_BITS;
+    static constexpr size_t PAGES = (T_Depth + PAGE_SIZE - 1) / PAGE_SIZE;
+    // TYPES
+    using Page = std::array<T_Value, PAGE_SIZE>;
+
+private:
+    // MEMBERS
+    std::vector<std::unique_ptr<Page>> m_pages;  // Page table, empty until first write
+
+    // METHODS
+    static const T_Value& zero() {
+        static const T_Value s_zero{};
+        return s_zero;
+    }
+
+public:
+    // CONSTRUCTORS
+    VlSparseArray() = default;
+    ~VlSparseArray() = default;
+    VlSparseArray(const VlSparseArray& other) { *this = other; }
+    VlSparseArray(VlSparseArray&&) = default;
+    VlSparseArray& operator=(const VlSparseArray& other) {
+        if (this == &other) return *this;
+        clear();
+        for (size_t p = 0; p < other.m_pages.size(); ++p) {
+            if (other.m_pages[p]) page(p) = *other.m_pages[p];
+        }
+        return *this;
+    }
+    VlSparseArray& operator=(VlSparseArray&&) = default;
+
+    // METHODS
+    // Writing, allocates the page of the element if needed
+    T_Value& operator[](size_t index) {
+        return page(index / PAGE_SIZE)[index % PAGE_SIZE];
+    }
+    // Reading, never allocates
+    const T_Value& operator[](size_t index) const {
+        const Page* const pagep = pageLookup(index / PAGE_SIZE);
+        return VL_LIKELY(pagep) ? (*pagep)[index % PAGE_SIZE] : zero();
+    }
+    // Return page, or nullptr if never written
+    const Page* pageLookup(size_t p) const {
+        return p < m_pages.size() ? m_pages[p].get() : nullptr;
+    }
+    // Return page, allocating it (with zero contents) if needed
+    Page& page(size_t p) {
+        if (VL_UNLIKELY(m_pages.empty())) m_pages.resize(PAGES);
+        std::unique_ptr<Page>& pagep = m_pages[p];
+        if (VL_UNLIKELY(!pagep)) pagep.reset(new Page{});
+        return *pagep;
+    }
+    // Number of page table slots, for save/restore
+    size_t pageSlots() const { return m_pages.size(); }
+    // Number of allocated pages
+    size_t pagesUsed() const {
+        size_t n = 0;
+        for (const auto& pagep : m_pages) n += pagep ? 1 : 0;
+        return n;
+    }
+    // Release all pages, so all elements read as zero
+    void clear() { m_pages.clear(); }
+
+    // *this != that, as VlUnpacked::neq
+    bool neq(const VlSparseArray& that) const {
+        const size_t pages = std::max(m_pages.size(), that.m_pages.size());
+        for (size_t p = 0; p < pages; ++p) {
+            const Page* const ap = pageLookup(p);
+            const Page* const bp = that.pageLookup(p);
+            for (size_t i = 0; i < PAGE_SIZE; ++i) {
+                if ((ap ? (*ap)[i] : zero()) != (bp ? (*bp)[i] : zero())) return true;
+            }
+        }
+        return false;
+    }
+    // *this = that, as VlUnpacked::assign
+    void assign(const VlSparseArray& that) { *this = that; }
+
+    // Dumping. Verilog: str = $sformatf("%p", array)
+    std::string to_string() const {
+        std::string out = "'{";
+        std::string comma;
+        for (size_t i = 0; i < T_Depth; ++i) {
+            out += comma + VL_TO_STRING((*this)[i]);
+            comma = ", ";
+        }
+        return out + "} ";
+    }
+};
+
+template <class T_Value, std::size_t T_Depth>
+std::string VL_TO_STRING(const VlSparseArray<T_Value, T_Depth>& obj) {
+    return obj.to_string();
+}
+
 //===================================================================
 // Object that VlDeleter is capable of deleting
 
 class VlDeletable VL_NOT_FINAL {
+    friend class VlDeleter;
+    VlDeletable* m_garbageNextp = nullptr;  // Next object in the deleter's garbage list
+
 public:
     VlDeletable() = default;
     virtual ~VlDeletable() = default;
@@ -1114,16 +1530,17 @@ public:
 
 class VlDeleter final {
     // MEMBERS
-    // Queue of new objects that should be deleted
-    std::vector<VlDeletable*> m_newGarbage VL_GUARDED_BY(m_mutex);
-    // Queue of objects currently being deleted (only for deleteAll())
-    std::vector<VlDeletable*> m_toDelete VL_GUARDED_BY(m_deleteMutex);
-    mutable VerilatedMutex m_mutex;  // Mutex protecting the 'new garbage' queue
-    mutable VerilatedMutex m_deleteMutex;  // Mutex protecting the delete queue
+    // Lock-free list of new objects that should be deleted, linked through m_garbageNextp.
+    // Objects are only ever pushed, or the whole list taken, so there is no ABA problem.
+    std::atomic<VlDeletable*> m_newGarbagep{nullptr};
+    // Objects are only ever used by one thread at a time, so no atomic read-modify-writes needed
+    const bool m_threadConfined = false;
 
 public:
     // CONSTRUCTOR
     VlDeleter() = default;
+    explicit VlDeleter(bool threadConfined)
+        : m_threadConfined{threadConfined} {}
     ~VlDeleter() { deleteAll(); }
 
 private:
@@ -1131,14 +1548,22 @@ private:
 
 public:
     // METHODS
-    // Adds a new object to the 'new garbage' queue.
+    // Adds a new object to the 'new garbage' list.
     void put(VlDeletable* const objp) VL_MT_SAFE {
-        const VerilatedLockGuard lock{m_mutex};
-        m_newGarbage.push_back(objp);
+        objp->m_garbageNextp = m_newGarbagep.load(std::memory_order_relaxed);
+        if (m_threadConfined) {
+            m_newGarbagep.store(objp, std::memory_order_relaxed);
+            return;
+        }
+        while (!m_newGarbagep.compare_exchange_weak(objp->m_garbageNextp, objp,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed)) {}
     }
 
     // Deletes all queued garbage objects.
-    void deleteAll() VL_EXCLUDES(m_mutex) VL_EXCLUDES(m_deleteMutex) VL_MT_SAFE;
+    void deleteAll() VL_MT_SAFE;
+
+    bool threadConfined() const { return m_threadConfined; }
 };
 
 //===================================================================
@@ -1154,14 +1579,29 @@ class VlClass VL_NOT_FINAL : public VlDeletable {
     // MEMBERS
     std::atomic<size_t> m_counter{0};  // Reference count for this object
     VlDeleter* m_deleterp = nullptr;  // The deleter that will delete this object
+    bool m_threadConfined = false;  // Copy of m_deleterp->threadConfined()
 
     // METHODS
-    // Atomically increments the reference counter
-    void refCountInc() VL_MT_SAFE { ++m_counter; }
-    // Atomically decrements the reference counter. Assuming VlClassRef semantics are sound, it
-    // should never get called at m_counter == 0.
+    // Increments the reference counter, atomically unless thread confined
+    void refCountInc() VL_MT_SAFE {
+        if (m_threadConfined) {
+            m_counter.store(m_counter.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        } else {
+            ++m_counter;
+        }
+    }
+    // Decrements the reference counter, atomically unless thread confined. Assuming VlClassRef
+    // semantics are sound, it should never get called at m_counter == 0.
     void refCountDec() VL_MT_SAFE {
-        if (!--m_counter) m_deleterp->put(this);
+        size_t count;
+        if (m_threadConfined) {
+            count = m_counter.load(std::memory_order_relaxed) - 1;
+            m_counter.store(count, std::memory_order_relaxed);
+        } else {
+            count = --m_counter;
+        }
+        if (!count) m_deleterp->put(this);
     }
 
 public:
@@ -1216,6 +1656,7 @@ public:
         // when a new() has an e.g. CData type and passed a 1U.
         : m_objp{new T_Class(std::forward<T_Args>(args)...)} {
         m_objp->m_deleterp = &deleter;
+        m_objp->m_threadConfined = deleter.threadConfined();
         refCountInc();
     }
     // Explicit to avoid implicit conversion from 0
@@ -1246,9 +1687,9 @@ public:
     // METHODS
     // Copy and move assignments
     VlClassRef& operator=(const VlClassRef& copied) {
+        copied.refCountInc();  // Before decrement, in case of self assignment
         refCountDec();
         m_objp = copied.m_objp;
-        refCountInc();
         return *this;
     }
     VlClassRef& operator=(VlClassRef&& moved) {
@@ -1258,9 +1699,9 @@ public:
     }
     template <typename T_OtherClass>
     VlClassRef& operator=(const VlClassRef<T_OtherClass>& copied) {
+        copied.refCountInc();  // Before decrement, in case of self assignment
         refCountDec();
         m_objp = copied.m_objp;
-        refCountInc();
         return *this;
     }
     template <typename T_OtherClass>
@@ -1337,6 +1778,35 @@ public:
     }
 };
 
+//=============================================================================
+// VlNBACommitQueue stores the pending non-blocking writes to whole elements of an unpacked
+// array, in program order. All writes are applied when committed in the NBA region, so the cost
+// of the commit scales with the number of writes made, not the number of write statements.
+
+template <typename T_Elem>
+class VlNBACommitQueue final {
+    // TYPES
+    // Type representing a single pending write
+    struct VlPending {
+        size_t m_index;  // Index of the element written
+        T_Elem m_value;  // The value written
+    };
+
+    // MEMBERS
+    std::vector<VlPending> m_pending;  // Pending writes, in program order
+
+public:
+    // METHODS
+    // Record a write of the given value to the element at the given index
+    void enqueue(const T_Elem& value, size_t index) { m_pending.push_back({index, value}); }
+    // Apply all pending writes to the array, the last write to an element wins
+    template <typename T_Array>
+    void commit(T_Array& array) {
+        for (const VlPending& pending : m_pending) array[pending.m_index] = pending.m_value;
+        m_pending.clear();
+    }
+};
+
 //======================================================================
 
 #define VL_NEW(Class, ...) \
@@ -0,0 +1,561 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//=============================================================================
+//
+// Code available from: https://verilator.org
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//=============================================================================
+///
+/// \file
+/// \brief Verilated C++ tracing in VBT format implementation code
+///
+/// This file must be compiled and linked against all Verilated objects
+/// that use --trace-vbt.
+///
+/// Use "verilator --trace-vbt" to add this to the Makefile for the linker.
+///
+/// File layout (all integers little endian):
+///
+///   "VBTRACE1"                                    8 byte header magic
+///   u32 compSize, u32 rawSize, LZ4 block         Repeated for each chunk
+///   Footer                                        See writeFooter
+///   u64 footerOffset, "VBTINDEX"                 16 byte trailer
+///
+/// Each uncompressed chunk is columnar, all fields are LEB128 varints:
+///
+///   nTimes, then nTimes time deltas (first one from 0)
+///   nSignals, then for each signal with changes in ascending code order:
+///     code delta, nChanges, then for each change:
+///       time index delta, then per value word: word XOR previous word
+///
+//=============================================================================
+
+// clang-format off
+
+#include "verilatedos.h"
+#include "verilated.h"
+#include "verilated_vbt_c.h"
+
+// Include the LZ4 implementation directly
+#include "gtkwave/lz4.c"
+
+#include <cerrno>
+
+// clang-format on
+
+//=============================================================================
+// Specialization of the generics for this trace format
+
+#define VL_SUB_T VerilatedVbt
+#define VL_BUF_T VerilatedVbtBuffer
+#include "verilated_trace_imp.h"
+#undef VL_SUB_T
+#undef VL_BUF_T
+
+//=============================================================================
+// Encoding helpers
+
+static constexpr char VL_VBT_HEADER_MAGIC[] = "VBTRACE1";
+static constexpr char VL_VBT_TRAILER_MAGIC[] = "VBTINDEX";
+
+static void vbtPutU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((value >> (8 * i)) & 0xff);
+}
+static void vbtPutU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out += static_cast<char>((value >> (8 * i)) & 0xff);
+}
+static void vbtPutStr(std::string& out, const std::string& str) {
+    vbtPutU32(out, static_cast<uint32_t>(str.size()));
+    out += str;
+}
+static void vbtPutVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+//=============================================================================
+// VerilatedVbt::Chunk
+
+struct VerilatedVbt::Chunk final {
+    const uint64_t m_seq;  // Sequence number, chunks are written in this order
+    uint32_t* const m_bufp;  // Raw value change stream
+    const size_t m_words;  // Used words at m_bufp
+    const uint64_t m_firstTime;  // First time point in the chunk
+    const uint64_t m_lastTime;  // Last time point in the chunk
+};
+
+//=============================================================================
+// Opening/Closing
+
+VerilatedVbt::VerilatedVbt() {
+    // Not in header to avoid link issue if header is included without this .cpp file
+}
+
+VerilatedVbt::~VerilatedVbt() { close(); }
+
+void VerilatedVbt::open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    if (isOpen()) return;
+
+    m_filename = filename;
+    m_filep = std::fopen(filename, "wb");
+    // User code can check isOpen()
+    if (!m_filep) return;
+    m_isOpen = true;
+
+    m_decls.clear();
+    m_maxDumpWords = 3;
+    Super::traceInit();
+    fullDump(true);  // First dump must be full
+
+    {
+        const VerilatedLockGuard wlock{m_writeMutex};
+        m_fileOffset = 0;
+        m_nextWriteSeq = 0;
+        m_index.clear();
+        writeBytes(std::string{VL_VBT_HEADER_MAGIC, sizeof(VL_VBT_HEADER_MAGIC) - 1});
+    }
+    m_nextSeq = 0;
+    m_bufp = m_writep = newBuffer();
+
+    {
+        const VerilatedLockGuard clock{m_chunkMutex};
+        m_shutdown = false;
+    }
+    for (unsigned i = 0; i < m_nThreads; ++i) {
+        m_workers.emplace_back(&VerilatedVbt::workerMain, this);
+    }
+}
+
+void VerilatedVbt::close() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    if (!isOpen()) return;
+    Super::closeBase();
+    submitChunk();
+    waitAllWritten();
+    {
+        const VerilatedLockGuard clock{m_chunkMutex};
+        m_shutdown = true;
+        m_chunkCv.notify_all();
+    }
+    for (std::thread& thread : m_workers) thread.join();
+    m_workers.clear();
+    writeFooter();
+    std::fclose(m_filep);
+    m_filep = nullptr;
+    m_isOpen = false;
+    freeBuffers();
+}
+
+void VerilatedVbt::flush() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    Super::flushBase();
+    if (!isOpen()) return;
+    submitChunk();
+    waitAllWritten();
+    std::fflush(m_filep);
+}
+
+void VerilatedVbt::detach() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    if (!isOpen()) return;
+    Super::detachBase();
+    // The compression workers do not exist in the child, and their
+    // std::thread records cannot be joined or destroyed, so leak them.
+    (void)new std::vector<std::thread>{std::move(m_workers)};
+    m_workers.clear();
+    // Keep the stream, but make sure libc flushing it on exit is harmless
+    detachFd(fileno(m_filep));
+    m_filep = nullptr;
+    m_isOpen = false;
+}
+
+void VerilatedVbt::emitTimeChange(uint64_t timeui) {
+    // The buffer has room for one more complete dump beyond m_chunkWords, so
+    // this is the only place we need to check for a full chunk
+    if (static_cast<size_t>(m_writep - m_bufp) >= m_chunkWords) submitChunk();
+    if (m_writep == m_bufp) m_chunkFirstTime = timeui;
+    m_chunkLastTime = timeui;
+    // Code 0 is never a signal, so marks a time point
+    m_writep[0] = 0;
+    m_writep[1] = static_cast<uint32_t>(timeui);
+    m_writep[2] = static_cast<uint32_t>(timeui >> 32);
+    m_writep += 3;
+}
+
+//=============================================================================
+// Chunk hand off and compression
+
+uint32_t* VerilatedVbt::newBuffer() VL_MT_SAFE_EXCLUDES(m_chunkMutex) {
+    {
+        const VerilatedLockGuard lock{m_chunkMutex};
+        if (!m_freeBufs.empty()) {
+            uint32_t* const bufp = m_freeBufs.back();
+            m_freeBufs.pop_back();
+            return bufp;
+        }
+    }
+    return new uint32_t[bufWords()];
+}
+
+void VerilatedVbt::freeBuffers() VL_MT_SAFE_EXCLUDES(m_chunkMutex) {
+    // Buffer size depends on the chunk size, which may change before the next open
+    if (m_bufp) VL_DO_CLEAR(delete[] m_bufp, m_bufp = nullptr);
+    m_writep = nullptr;
+    const VerilatedLockGuard lock{m_chunkMutex};
+    for (uint32_t* const bufp : m_freeBufs) delete[] bufp;
+    m_freeBufs.clear();
+}
+
+void VerilatedVbt::submitChunk() VL_MT_SAFE_EXCLUDES(m_chunkMutex) {
+    const size_t words = m_writep - m_bufp;
+    if (!words) return;
+    Chunk* const chunkp
+        = new Chunk{m_nextSeq++, m_bufp, words, m_chunkFirstTime, m_chunkLastTime};
+    {
+        VerilatedLockGuard lock{m_chunkMutex};
+        // Bound the memory held by chunks not yet written, stalling the model if the
+        // workers can't keep up
+        const size_t maxInFlight = 2 * m_nThreads + 2;
+        while (m_nThreads && m_inFlight >= maxInFlight) m_doneCv.wait(m_chunkMutex);
+        ++m_inFlight;
+        if (m_nThreads) {
+            m_chunks.push_back(chunkp);
+            m_chunkCv.notify_one();
+        }
+    }
+    if (!m_nThreads) processChunk(chunkp);
+    m_bufp = m_writep = newBuffer();
+}
+
+void VerilatedVbt::waitAllWritten() VL_MT_SAFE_EXCLUDES(m_chunkMutex) {
+    VerilatedLockGuard lock{m_chunkMutex};
+    while (m_inFlight) m_doneCv.wait(m_chunkMutex);
+}
+
+void VerilatedVbt::workerMain() VL_MT_SAFE_EXCLUDES(m_chunkMutex) {
+    while (true) {
+        Chunk* chunkp;
+        {
+            VerilatedLockGuard lock{m_chunkMutex};
+            while (m_chunks.empty() && !m_shutdown) m_chunkCv.wait(m_chunkMutex);
+            if (m_chunks.empty()) return;
+            chunkp = m_chunks.front();
+            m_chunks.pop_front();
+        }
+        processChunk(chunkp);
+    }
+}
+
+void VerilatedVbt::processChunk(Chunk* chunkp) VL_MT_SAFE_EXCLUDES(m_writeMutex) {
+    std::string raw;
+    encodeChunk(chunkp, raw);
+
+    // Raw stream is no longer needed, recycle it
+    {
+        const VerilatedLockGuard lock{m_chunkMutex};
+        m_freeBufs.push_back(chunkp->m_bufp);
+    }
+
+    // Frame is compressed size, raw size, then the LZ4 block
+    const int rawSize = static_cast<int>(raw.size());
+    const int bound = LZ4_compressBound(rawSize);
+    std::string frame;
+    frame.resize(8 + bound);
+    const int compSize = LZ4_compress_default(raw.data(), &frame[8], rawSize, bound);
+    if (VL_UNCOVERABLE(compSize <= 0)) {
+        VL_FATAL_MT(__FILE__, __LINE__, "", "Internal: VBT chunk compression failed");
+    }
+    frame.resize(8 + compSize);
+    std::string sizes;
+    vbtPutU32(sizes, static_cast<uint32_t>(compSize));
+    vbtPutU32(sizes, static_cast<uint32_t>(rawSize));
+    frame.replace(0, 8, sizes);
+
+    {
+        VerilatedLockGuard lock{m_writeMutex};
+        while (m_nextWriteSeq != chunkp->m_seq) m_writeCv.wait(m_writeMutex);
+        m_index.push_back({m_fileOffset, static_cast<uint32_t>(compSize),
+                           static_cast<uint32_t>(rawSize), chunkp->m_firstTime,
+                           chunkp->m_lastTime});
+        writeBytes(frame);
+        ++m_nextWriteSeq;
+        m_writeCv.notify_all();
+    }
+    {
+        const VerilatedLockGuard lock{m_chunkMutex};
+        --m_inFlight;
+        m_doneCv.notify_all();
+    }
+    delete chunkp;
+}
+
+void VerilatedVbt::encodeChunk(const Chunk* chunkp, std::string& out) const {
+    // Transpose the row oriented raw stream into a column per signal. This is a
+    // counting sort on the code, so changes of each signal remain in time order.
+    const uint32_t* const bufp = chunkp->m_bufp;
+    const uint32_t* const endp = bufp + chunkp->m_words;
+    const size_t nCodes = m_codeWords.size();
+    std::vector<uint32_t> starts(nCodes + 1, 0);
+    uint32_t nTimes = 0;
+    size_t nChanges = 0;
+    for (const uint32_t* rp = bufp; rp < endp;) {
+        const uint32_t code = *rp++;
+        if (!code) {
+            ++nTimes;
+            rp += 2;
+        } else {
+            ++starts[code + 1];
+            ++nChanges;
+            rp += m_codeWords[code];
+        }
+    }
+    for (size_t code = 0; code < nCodes; ++code) starts[code + 1] += starts[code];
+
+    struct Change final {
+        uint32_t m_timeIndex;  // Index of the time point of the change
+        const uint32_t* m_valuep;  // Value words in the raw stream
+    };
+    std::vector<Change> changes(nChanges);
+    std::vector<uint32_t> fill{starts.begin(), starts.end() - 1};
+
+    out.reserve(chunkp->m_words * sizeof(uint32_t));
+    vbtPutVarint(out, nTimes);
+    uint64_t lastTime = 0;
+    uint32_t timeIndex = 0;
+    for (const uint32_t* rp = bufp; rp < endp;) {
+        const uint32_t code = *rp++;
+        if (!code) {
+            const uint64_t time = static_cast<uint64_t>(rp[0]) | static_cast<uint64_t>(rp[1]) << 32;
+            vbtPutVarint(out, time - lastTime);
+            lastTime = time;
+            ++timeIndex;
+            rp += 2;
+        } else {
+            changes[fill[code]++] = {timeIndex - 1, rp};
+            rp += m_codeWords[code];
+        }
+    }
+
+    uint32_t nSignals = 0;
+    for (size_t code = 1; code < nCodes; ++code) nSignals += starts[code + 1] != starts[code];
+    vbtPutVarint(out, nSignals);
+    size_t lastCode = 0;
+    for (size_t code = 1; code < nCodes; ++code) {
+        const uint32_t begin = starts[code];
+        const uint32_t end = starts[code + 1];
+        if (begin == end) continue;
+        const uint32_t words = m_codeWords[code];
+        vbtPutVarint(out, code - lastCode);
+        vbtPutVarint(out, end - begin);
+        lastCode = code;
+        uint32_t lastIndex = 0;
+        const uint32_t* prevp = nullptr;
+        for (uint32_t i = begin; i < end; ++i) {
+            const Change& change = changes[i];
+            vbtPutVarint(out, change.m_timeIndex - lastIndex);
+            lastIndex = change.m_timeIndex;
+            for (uint32_t w = 0; w < words; ++w) {
+                vbtPutVarint(out, change.m_valuep[w] ^ (prevp ? prevp[w] : 0));
+            }
+            prevp = change.m_valuep;
+        }
+    }
+}
+
+void VerilatedVbt::writeBytes(const std::string& data) VL_REQUIRES(m_writeMutex) {
+    if (VL_UNCOVERABLE(std::fwrite(data.data(), 1, data.size(), m_filep) != data.size())) {
+        // LCOV_EXCL_START
+        // write failed, presume error (perhaps out of disk space)
+        const std::string msg = std::string{"VerilatedVbt::writeBytes: "} + std::strerror(errno);
+        VL_FATAL_MT("", 0, "", msg.c_str());
+        // LCOV_EXCL_STOP
+    }
+    m_fileOffset += data.size();
+}
+
+void VerilatedVbt::writeFooter() VL_MT_SAFE_EXCLUDES(m_writeMutex) {
+    const VerilatedLockGuard lock{m_writeMutex};
+    const uint64_t footerOffset = m_fileOffset;
+    std::string out;
+    vbtPutU32(out, nextCode());
+    vbtPutStr(out, timeResStr());
+    vbtPutU32(out, static_cast<uint32_t>(m_decls.size()));
+    for (const Decl& decl : m_decls) {
+        vbtPutU32(out, decl.m_code);
+        vbtPutU32(out, decl.m_bits);
+        out += static_cast<char>(decl.m_kind);
+        out += static_cast<char>(decl.m_bussed);
+        vbtPutU32(out, static_cast<uint32_t>(decl.m_msb));
+        vbtPutU32(out, static_cast<uint32_t>(decl.m_lsb));
+        vbtPutStr(out, decl.m_type);
+        vbtPutStr(out, decl.m_hiername);
+        vbtPutStr(out, decl.m_name);
+    }
+    vbtPutU32(out, static_cast<uint32_t>(m_index.size()));
+    for (const IndexEntry& entry : m_index) {
+        vbtPutU64(out, entry.m_offset);
+        vbtPutU32(out, entry.m_compSize);
+        vbtPutU32(out, entry.m_rawSize);
+        vbtPutU64(out, entry.m_firstTime);
+        vbtPutU64(out, entry.m_lastTime);
+    }
+    vbtPutU64(out, footerOffset);
+    out.append(VL_VBT_TRAILER_MAGIC, sizeof(VL_VBT_TRAILER_MAGIC) - 1);
+    writeBytes(out);
+}
+
+//=============================================================================
+// Definitions
+
+void VerilatedVbt::declare(uint32_t code, const char* name, const char* typep, uint8_t kind,
+                           bool array, int arraynum, bool bussed, int msb, int lsb) {
+    const int bits = ((msb > lsb) ? (msb - lsb) : (lsb - msb)) + 1;
+
+    const bool enabled = Super::declCode(code, name, bits, false);
+
+    const uint32_t words = (kind == KIND_QUAD || kind == KIND_DOUBLE) ? 2
+                           : kind == KIND_WIDE                        ? VL_WORDS_I(bits)
+                                                                      : 1;
+    if (m_codeWords.size() < nextCode()) m_codeWords.resize(nextCode(), 0);
+    m_codeWords[code] = words;
+    // Keep upper bound on words a single dump can emit into the chunk buffer
+    m_maxDumpWords += 1 + words;
+
+    if (!enabled) return;
+
+    // Split name into hierarchy and basename, exactly as VerilatedVcd does, so
+    // the converter can rebuild the same scopes
+    std::string nameasstr = namePrefix() + name;
+    std::string hiername;
+    std::string basename;
+    for (const char* cp = nameasstr.c_str(); *cp; cp++) {
+        if (isScopeEscape(*cp)) {
+            // Ahh, we've just read a scope, not a basename
+            if (!hiername.empty()) hiername += " ";
+            hiername += basename;
+            basename = "";
+        } else {
+            basename += *cp;
+        }
+    }
+    if (array) {
+        constexpr size_t bufsize = 32;
+        char buf[bufsize];
+        VL_SNPRINTF(buf, bufsize, "[%d]", arraynum);
+        basename += buf;
+    }
+    hiername += "\t" + basename;
+
+    m_decls.push_back({code, static_cast<uint32_t>(bits), kind, bussed, msb, lsb, typep,
+                       hiername, basename});
+}
+
+void VerilatedVbt::declEvent(uint32_t code, const char* name, bool array, int arraynum) {
+    declare(code, name, "event", KIND_EVENT, array, arraynum, false, 0, 0);
+}
+void VerilatedVbt::declBit(uint32_t code, const char* name, bool array, int arraynum) {
+    declare(code, name, "wire", KIND_BIT, array, arraynum, false, 0, 0);
+}
+void VerilatedVbt::declBus(uint32_t code, const char* name, bool array, int arraynum, int msb,
+                           int lsb) {
+    declare(code, name, "wire", KIND_BUS, array, arraynum, true, msb, lsb);
+}
+void VerilatedVbt::declQuad(uint32_t code, const char* name, bool array, int arraynum, int msb,
+                            int lsb) {
+    declare(code, name, "wire", KIND_QUAD, array, arraynum, true, msb, lsb);
+}
+void VerilatedVbt::declArray(uint32_t code, const char* name, bool array, int arraynum, int msb,
+                             int lsb) {
+    declare(code, name, "wire", KIND_WIDE, array, arraynum, true, msb, lsb);
+}
+void VerilatedVbt::declDouble(uint32_t code, const char* name, bool array, int arraynum) {
+    declare(code, name, "real", KIND_DOUBLE, array, arraynum, false, 63, 0);
+}
+
+//=============================================================================
+// Get/commit trace buffer
+
+VerilatedVbt::Buffer* VerilatedVbt::getTraceBuffer() { return new Buffer{*this}; }
+
+void VerilatedVbt::commitTraceBuffer(VerilatedVbt::Buffer* bufp) {
+    m_writep = bufp->m_writep;
+    delete bufp;
+}
+
+//=============================================================================
+// VerilatedVbtBuffer implementation
+
+//=============================================================================
+// emit* trace routines
+
+// Note: emit* are only ever called from one place (full* in
+// verilated_trace_imp.h, which is included in this file at the top),
+// so always inline them.
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitEvent(uint32_t code, VlEvent newval) {
+    if (!newval.isTriggered()) return;
+    m_writep[0] = code;
+    m_writep[1] = 1;
+    m_writep += 2;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitBit(uint32_t code, CData newval) {
+    m_writep[0] = code;
+    m_writep[1] = newval;
+    m_writep += 2;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitCData(uint32_t code, CData newval, int /*bits*/) {
+    m_writep[0] = code;
+    m_writep[1] = newval;
+    m_writep += 2;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitSData(uint32_t code, SData newval, int /*bits*/) {
+    m_writep[0] = code;
+    m_writep[1] = newval;
+    m_writep += 2;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitIData(uint32_t code, IData newval, int /*bits*/) {
+    m_writep[0] = code;
+    m_writep[1] = newval;
+    m_writep += 2;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitQData(uint32_t code, QData newval, int /*bits*/) {
+    m_writep[0] = code;
+    m_writep[1] = static_cast<uint32_t>(newval);
+    m_writep[2] = static_cast<uint32_t>(newval >> 32);
+    m_writep += 3;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitWData(uint32_t code, const WData* newvalp, int bits) {
+    const int words = VL_WORDS_I(bits);
+    m_writep[0] = code;
+    std::memcpy(m_writep + 1, newvalp, words * sizeof(EData));
+    m_writep += 1 + words;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVbtBuffer::emitDouble(uint32_t code, double newval) {
+    m_writep[0] = code;
+    std::memcpy(m_writep + 1, &newval, sizeof(double));
+    m_writep += 3;
+}
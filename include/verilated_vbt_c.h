@@ -0,0 +1,321 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//=============================================================================
+//
+// Code available from: https://verilator.org
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//=============================================================================
+///
+/// \file
+/// \brief Verilated tracing in VBT (Verilator Binary Trace) format header
+///
+/// User wrapper code should use this header when creating VBT traces.
+///
+/// VBT is a chunked, columnar binary format. The model thread only appends
+/// raw value changes to a chunk buffer; transposing each chunk into per
+/// signal delta encoded columns, LZ4 compressing it and writing it out is
+/// done by a small pool of worker threads. An indexed footer describing the
+/// signals and the chunks is written on close. Use 'verilator_vbt2vcd' to
+/// convert a VBT file to VCD (and from there to FST) for viewing.
+///
+//=============================================================================
+
+#ifndef VERILATOR_VERILATED_VBT_C_H_
+#define VERILATOR_VERILATED_VBT_C_H_
+
+#include "verilated.h"
+#include "verilated_trace.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VerilatedVbtBuffer;
+
+//=============================================================================
+// VerilatedVbt
+// Base class to create a Verilator VBT dump
+// This is an internally used class - see VerilatedVbtC for what to call from applications
+
+class VerilatedVbt VL_NOT_FINAL : public VerilatedTrace<VerilatedVbt, VerilatedVbtBuffer> {
+public:
+    using Super = VerilatedTrace<VerilatedVbt, VerilatedVbtBuffer>;
+
+private:
+    friend VerilatedVbtBuffer;  // Give the buffer access to the private bits
+
+    //=========================================================================
+    // VBT specific internals
+
+    struct Decl final {  // A signal declaration, as recorded in the footer
+        uint32_t m_code;  // Trace code
+        uint32_t m_bits;  // Width
+        uint8_t m_kind;  // Value encoding, VerilatedVbt::Kind
+        bool m_bussed;  // Has [msb:lsb]
+        int m_msb;  // Most significant bit index
+        int m_lsb;  // Least significant bit index
+        std::string m_type;  // VCD variable type (e.g. "wire")
+        std::string m_hiername;  // Scope hierarchy, separated as in VerilatedVcd
+        std::string m_name;  // Signal base name, including any array index
+    };
+    struct Chunk;  // A chunk of the raw value change stream
+    struct IndexEntry final {  // Where a compressed chunk lives in the file
+        uint64_t m_offset;  // File offset of the chunk frame
+        uint32_t m_compSize;  // Compressed size in bytes
+        uint32_t m_rawSize;  // Uncompressed size in bytes
+        uint64_t m_firstTime;  // First time point in the chunk
+        uint64_t m_lastTime;  // Last time point in the chunk
+    };
+
+    std::FILE* m_filep = nullptr;  // File we're writing to
+    bool m_isOpen = false;  // True indicates open file
+    std::string m_filename;  // Filename we're writing to (if open)
+
+    std::vector<Decl> m_decls;  // Enabled signal declarations
+    std::vector<uint32_t> m_codeWords;  // Value words following each code in the raw stream
+    size_t m_maxDumpWords = 3;  // Upper bound on raw stream words of a single dump
+
+    // Raw value change stream of the chunk currently being filled (model thread only)
+    uint32_t* m_bufp = nullptr;  // Start of chunk buffer
+    uint32_t* m_writep = nullptr;  // Write pointer into chunk buffer
+    size_t m_chunkWords = 256 * 1024;  // Chunk is handed off once this many words are used
+    uint64_t m_chunkFirstTime = 0;  // First time point in the current chunk
+    uint64_t m_chunkLastTime = 0;  // Last time point in the current chunk
+    uint64_t m_nextSeq = 0;  // Sequence number of the next chunk handed off
+
+    // Compression workers
+    unsigned m_nThreads = 2;  // Number of worker threads, 0 to compress inline
+    std::vector<std::thread> m_workers;  // The worker threads
+    VerilatedMutex m_chunkMutex;  // Protects the members below
+    std::condition_variable_any m_chunkCv;  // Signalled when m_chunks becomes non-empty
+    std::condition_variable_any m_doneCv;  // Signalled when a chunk has been written
+    std::deque<Chunk*> m_chunks VL_GUARDED_BY(m_chunkMutex);  // Chunks awaiting compression
+    std::vector<uint32_t*> m_freeBufs VL_GUARDED_BY(m_chunkMutex);  // Recycled chunk buffers
+    size_t m_inFlight VL_GUARDED_BY(m_chunkMutex) = 0;  // Chunks handed off but not written
+    bool m_shutdown VL_GUARDED_BY(m_chunkMutex) = false;  // Workers should exit
+
+    // Output ordering, chunks are written in sequence order
+    VerilatedMutex m_writeMutex;  // Protects the members below
+    std::condition_variable_any m_writeCv;  // Signalled when m_nextWriteSeq changes
+    uint64_t m_nextWriteSeq VL_GUARDED_BY(m_writeMutex) = 0;  // Next chunk to write
+    uint64_t m_fileOffset VL_GUARDED_BY(m_writeMutex) = 0;  // Bytes written so far
+    std::vector<IndexEntry> m_index VL_GUARDED_BY(m_writeMutex);  // Written chunks
+
+    void declare(uint32_t code, const char* name, const char* typep, uint8_t kind, bool array,
+                 int arraynum, bool bussed, int msb, int lsb);
+    size_t bufWords() const { return m_chunkWords + m_maxDumpWords; }
+    uint32_t* newBuffer() VL_MT_SAFE_EXCLUDES(m_chunkMutex);
+    void freeBuffers() VL_MT_SAFE_EXCLUDES(m_chunkMutex);
+    void submitChunk() VL_MT_SAFE_EXCLUDES(m_chunkMutex);
+    void waitAllWritten() VL_MT_SAFE_EXCLUDES(m_chunkMutex);
+    void workerMain() VL_MT_SAFE_EXCLUDES(m_chunkMutex);
+    void processChunk(Chunk* chunkp) VL_MT_SAFE_EXCLUDES(m_writeMutex);
+    void encodeChunk(const Chunk* chunkp, std::string& out) const;
+    void writeBytes(const std::string& data) VL_REQUIRES(m_writeMutex);
+    void writeFooter() VL_MT_SAFE_EXCLUDES(m_writeMutex);
+
+    // CONSTRUCTORS
+    VL_UNCOPYABLE(VerilatedVbt);
+
+protected:
+    //=========================================================================
+    // Implementation of VerilatedTrace interface
+
+    // Called when the trace moves forward to a new time point
+    void emitTimeChange(uint64_t timeui) override;
+
+    // Hooks called from VerilatedTrace
+    bool preFullDump() override { return isOpen(); }
+    bool preChangeDump() override { return isOpen(); }
+
+    // Trace buffer management
+    Buffer* getTraceBuffer() override;
+    void commitTraceBuffer(Buffer*) override;
+
+    // Configure sub-class
+    void configure(const VerilatedTraceConfig&) override{};
+
+public:
+    //=========================================================================
+    // External interface to client code
+
+    // Value encodings, as stored in the footer
+    enum Kind : uint8_t { KIND_EVENT = 0, KIND_BIT, KIND_BUS, KIND_QUAD, KIND_WIDE, KIND_DOUBLE };
+
+    // CONSTRUCTOR
+    VerilatedVbt();
+    ~VerilatedVbt();
+
+    // ACCESSORS
+    // Set number of compression threads, 0 to compress in the dumping thread. Call before open
+    void threads(unsigned n) VL_MT_SAFE { m_nThreads = n; }
+    // Set size in bytes of raw value changes after which a chunk is compressed. Call before open
+    void chunkSize(size_t bytes) VL_MT_SAFE {
+        // LZ4 blocks are limited to 2GB, stay well below
+        m_chunkWords = std::min<size_t>(std::max<size_t>(bytes / sizeof(uint32_t), 1024),
+                                        64 * 1024 * 1024);
+    }
+
+    // METHODS - All must be thread safe
+    // Open the file; call isOpen() to see if errors
+    void open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Close the file
+    void close() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Flush any remaining data to this file
+    void flush() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // In a child created by VerilatedContext::forkChild, stop writing to the
+    // parent's file without flushing or closing it; the trace is then closed
+    void detach() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Return if file is open
+    bool isOpen() const VL_MT_SAFE { return m_isOpen; }
+
+    //=========================================================================
+    // Internal interface to Verilator generated code
+
+    void declEvent(uint32_t code, const char* name, bool array, int arraynum);
+    void declBit(uint32_t code, const char* name, bool array, int arraynum);
+    void declBus(uint32_t code, const char* name, bool array, int arraynum, int msb, int lsb);
+    void declQuad(uint32_t code, const char* name, bool array, int arraynum, int msb, int lsb);
+    void declArray(uint32_t code, const char* name, bool array, int arraynum, int msb, int lsb);
+    void declDouble(uint32_t code, const char* name, bool array, int arraynum);
+};
+
+#ifndef DOXYGEN
+// Declare specialization here as it's used in VerilatedVbtC just below
+template <>
+void VerilatedVbt::Super::dump(uint64_t time);
+template <>
+void VerilatedVbt::Super::set_time_unit(const char* unitp);
+template <>
+void VerilatedVbt::Super::set_time_unit(const std::string& unit);
+template <>
+void VerilatedVbt::Super::set_time_resolution(const char* unitp);
+template <>
+void VerilatedVbt::Super::set_time_resolution(const std::string& unit);
+template <>
+void VerilatedVbt::Super::dumpvars(int level, const std::string& hier);
+template <>
+void VerilatedVbt::Super::sampleEvery(uint32_t every);
+template <>
+void VerilatedVbt::Super::sampleWindow(uint64_t period, uint64_t width, uint64_t start);
+#endif  // DOXYGEN
+
+//=============================================================================
+// VerilatedVbtBuffer
+
+class VerilatedVbtBuffer VL_NOT_FINAL {
+    // Give the trace file and sub-classes access to the private bits
+    friend VerilatedVbt;
+    friend VerilatedVbt::Super;
+    friend VerilatedVbt::Buffer;
+    friend VerilatedVbt::OffloadBuffer;
+
+    VerilatedVbt& m_owner;  // Trace file owning this buffer. Required by subclasses.
+
+    // Write pointer into the raw chunk buffer. The chunk buffer always has room for a
+    // complete dump, so no checks are needed here.
+    uint32_t* m_writep = m_owner.m_writep;
+
+    // CONSTRUCTOR
+    explicit VerilatedVbtBuffer(VerilatedVbt& owner)
+        : m_owner{owner} {}
+    virtual ~VerilatedVbtBuffer() = default;
+
+    //=========================================================================
+    // Implementation of VerilatedTraceBuffer interface
+    // Implementations of duck-typed methods for VerilatedTraceBuffer. These are
+    // called from only one place (the full* methods), so always inline them.
+    VL_ATTR_ALWINLINE void emitEvent(uint32_t code, VlEvent newval);
+    VL_ATTR_ALWINLINE void emitBit(uint32_t code, CData newval);
+    VL_ATTR_ALWINLINE void emitCData(uint32_t code, CData newval, int bits);
+    VL_ATTR_ALWINLINE void emitSData(uint32_t code, SData newval, int bits);
+    VL_ATTR_ALWINLINE void emitIData(uint32_t code, IData newval, int bits);
+    VL_ATTR_ALWINLINE void emitQData(uint32_t code, QData newval, int bits);
+    VL_ATTR_ALWINLINE void emitWData(uint32_t code, const WData* newvalp, int bits);
+    VL_ATTR_ALWINLINE void emitDouble(uint32_t code, double newval);
+};
+
+//=============================================================================
+// VerilatedVbtC
+/// Class representing a VBT dump file in C standalone (no SystemC)
+/// simulations.
+
+class VerilatedVbtC VL_NOT_FINAL {
+    VerilatedVbt m_sptrace;  // Trace file being created
+
+    // CONSTRUCTORS
+    VL_UNCOPYABLE(VerilatedVbtC);
+
+public:
+    /// Construct the dump
+    VerilatedVbtC() = default;
+    /// Destruct, flush, and close the dump
+    virtual ~VerilatedVbtC() { close(); }
+
+    // METHODS - User called
+
+    /// Return if file is open
+    bool isOpen() const VL_MT_SAFE { return m_sptrace.isOpen(); }
+    /// Open a new VBT file
+    virtual void open(const char* filename) VL_MT_SAFE { m_sptrace.open(filename); }
+    /// Close dump
+    void close() VL_MT_SAFE { m_sptrace.close(); }
+    /// Flush dump, waiting until all chunks so far are written
+    void flush() VL_MT_SAFE { m_sptrace.flush(); }
+    /// Write one cycle of dump data
+    /// Call with the current context's time just after eval'ed,
+    /// e.g. ->dump(contextp->time())
+    void dump(uint64_t timeui) VL_MT_SAFE { m_sptrace.dump(timeui); }
+    /// Write one cycle of dump data - backward compatible and to reduce
+    /// conversion warnings.  It's better to use a uint64_t time instead.
+    void dump(double timestamp) { dump(static_cast<uint64_t>(timestamp)); }
+    void dump(uint32_t timestamp) { dump(static_cast<uint64_t>(timestamp)); }
+    void dump(int timestamp) { dump(static_cast<uint64_t>(timestamp)); }
+    /// Set number of compression threads (0 compresses in the calling
+    /// thread). Must be called before open.
+    void threads(unsigned n) VL_MT_SAFE { m_sptrace.threads(n); }
+    /// Set the raw size in bytes at which a chunk is handed off for
+    /// compression. Must be called before open.
+    void chunkSize(size_t bytes) VL_MT_SAFE { m_sptrace.chunkSize(bytes); }
+
+    // METHODS - Internal/backward compatible
+    // \protectedsection
+
+    // Set time units (s/ms, defaults to ns)
+    // Users should not need to call this, as for Verilated models, these
+    // propage from the Verilated default timeunit
+    void set_time_unit(const char* unit) VL_MT_SAFE { m_sptrace.set_time_unit(unit); }
+    void set_time_unit(const std::string& unit) VL_MT_SAFE { m_sptrace.set_time_unit(unit); }
+    // Set time resolution (s/ms, defaults to ns)
+    // Users should not need to call this, as for Verilated models, these
+    // propage from the Verilated default timeprecision
+    void set_time_resolution(const char* unit) VL_MT_SAFE { m_sptrace.set_time_resolution(unit); }
+    void set_time_resolution(const std::string& unit) VL_MT_SAFE {
+        m_sptrace.set_time_resolution(unit);
+    }
+    // Set variables to dump, using $dumpvars format
+    // If level = 0, dump everything and hier is then ignored
+    void dumpvars(int level, const std::string& hier) VL_MT_SAFE {
+        m_sptrace.dumpvars(level, hier);
+    }
+    // Write only every 'every'th call to dump()
+    void sampleEvery(uint32_t every) VL_MT_SAFE { m_sptrace.sampleEvery(every); }
+    // Write dumps only within windows of 'width' time units every 'period' from 'start'
+    void sampleWindow(uint64_t period, uint64_t width, uint64_t start = 0) VL_MT_SAFE {
+        m_sptrace.sampleWindow(period, width, start);
+    }
+
+    // Internal class access
+    VerilatedVbt* spTrace() { return &m_sptrace; }
+};
+
+#endif  // guard
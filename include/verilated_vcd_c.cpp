@@ -87,6 +87,112 @@ ssize_t VerilatedVcdFile::write(const char* bufp, ssize_t len) VL_MT_UNSAFE {
     return ::write(m_fd, bufp, len);
 }
 
+//=============================================================================
+// VerilatedVcdAsyncFile
+
+VerilatedVcdAsyncFile::~VerilatedVcdAsyncFile() { stop(); }
+
+bool VerilatedVcdAsyncFile::open(const std::string& name) VL_MT_UNSAFE {
+    if (!VerilatedVcdFile::open(name)) return false;
+    m_fill.reserve(BUFFER_SIZE);
+    m_pending.reserve(BUFFER_SIZE);
+    {
+        const VerilatedLockGuard lock{m_mutex};
+        m_shutdown = false;
+        m_errno = 0;
+    }
+    m_thread = std::thread{&VerilatedVcdAsyncFile::threadMain, this};
+    return true;
+}
+
+void VerilatedVcdAsyncFile::close() VL_MT_UNSAFE {
+    stop();
+    VerilatedVcdFile::close();
+}
+
+ssize_t VerilatedVcdAsyncFile::write(const char* bufp, ssize_t len) VL_MT_UNSAFE {
+    {
+        const VerilatedLockGuard lock{m_mutex};
+        if (VL_UNLIKELY(m_errno)) {
+            errno = m_errno;
+            return -1;
+        }
+    }
+    m_fill.insert(m_fill.end(), bufp, bufp + len);
+    if (m_fill.size() >= BUFFER_SIZE) submit();
+    return len;
+}
+
+void VerilatedVcdAsyncFile::flush() VL_MT_UNSAFE {
+    submit();
+    const int err = wait();
+    if (VL_UNCOVERABLE(err)) {
+        const std::string msg = std::string{"VerilatedVcdAsyncFile: "} + std::strerror(err);
+        VL_FATAL_MT("", 0, "", msg.c_str());  // LCOV_EXCL_LINE
+    }
+}
+
+void VerilatedVcdAsyncFile::submit() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    // Hand m_fill to the thread, once it has finished with the previous buffer
+    if (m_fill.empty()) return;
+    VerilatedLockGuard lock{m_mutex};
+    while (m_busy) m_cv.wait(m_mutex);
+    std::swap(m_fill, m_pending);
+    m_busy = true;
+    m_cv.notify_all();
+}
+
+int VerilatedVcdAsyncFile::wait() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    // Wait for the last buffer to be written, return errno of any write or 0
+    VerilatedLockGuard lock{m_mutex};
+    while (m_busy) m_cv.wait(m_mutex);
+    return m_errno;
+}
+
+void VerilatedVcdAsyncFile::stop() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    // Write everything gathered, then end the thread
+    if (!m_thread.joinable()) return;
+    submit();
+    wait();
+    {
+        const VerilatedLockGuard lock{m_mutex};
+        m_shutdown = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void VerilatedVcdAsyncFile::threadMain() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    while (true) {
+        {
+            VerilatedLockGuard lock{m_mutex};
+            while (!m_busy && !m_shutdown) m_cv.wait(m_mutex);
+            if (!m_busy) return;
+        }
+        // m_pending is not touched by other threads while m_busy
+        const char* wp = m_pending.data();
+        const char* const endp = wp + m_pending.size();
+        int err = 0;
+        while (wp < endp) {
+            errno = 0;
+            const ssize_t got = VerilatedVcdFile::write(wp, endp - wp);
+            if (got > 0) {
+                wp += got;
+            } else if (VL_UNCOVERABLE(got < 0 && errno != EAGAIN && errno != EINTR)) {
+                err = errno;  // LCOV_EXCL_LINE // Perhaps out of disk space
+                break;  // LCOV_EXCL_LINE
+            }
+        }
+        m_pending.clear();  // Keeps capacity for the next swap
+        {
+            const VerilatedLockGuard lock{m_mutex};
+            if (err && !m_errno) m_errno = err;
+            m_busy = false;
+        }
+        m_cv.notify_all();
+    }
+}
+
 //=============================================================================
 //=============================================================================
 //=============================================================================
@@ -116,6 +222,18 @@ void VerilatedVcd::open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex) {
 
     // When using rollover, the first chunk contains the header only.
     if (m_rolloverSize) openNextImp(true);
+
+    // In ring mode, only the header is written now
+    if (m_ringDumps) {
+        bufferFlush();
+        m_ringActive = true;
+        m_ringTriggered = false;
+        m_ring.clear();
+        m_ring.emplace_back();
+        m_ringHeldDumps = 0;
+        m_ringErrorCount = contextp() ? contextp()->errorCount() : 0;
+        m_ringGotError = contextp() ? contextp()->gotError() : false;
+    }
 }
 
 void VerilatedVcd::openNext(bool incFilename) VL_MT_SAFE_EXCLUDES(m_mutex) {
@@ -168,11 +286,77 @@ void VerilatedVcd::openNextImp(bool incFilename) {
     m_wroteBytes = 0;
 }
 
+bool VerilatedVcd::preFullDump() {
+    if (VL_UNLIKELY(m_ringActive)) ringPreDump(true);
+    return isOpen();
+}
+
 bool VerilatedVcd::preChangeDump() {
     if (VL_UNLIKELY(m_rolloverSize && m_wroteBytes > m_rolloverSize)) openNextImp(true);
+    if (VL_UNLIKELY(m_ringActive)) ringPreDump(false);
     return isOpen();
 }
 
+//=============================================================================
+// Triggered ring
+
+void VerilatedVcd::ringCheckErrors() {
+    // A $error, $stop or $fatal since the last check triggers the ring
+    if (!contextp()) return;
+    const int errorCount = contextp()->errorCount();
+    const bool gotError = contextp()->gotError();
+    if (errorCount != m_ringErrorCount || (gotError && !m_ringGotError)) m_ringTriggered = true;
+    m_ringErrorCount = errorCount;
+    m_ringGotError = gotError;
+}
+
+void VerilatedVcd::ringPreDump(bool full) {
+    // Write out a trigger from the previous dump, which showed the state at the
+    // error; the error itself is only visible to us after that eval
+    if (m_ringTriggered) {
+        ringWrite();
+        full = true;
+    }
+    ringCheckErrors();
+
+    // Start a new segment with a full snapshot periodically, so older segments can
+    // be dropped while what remains is still complete
+    const uint64_t snapshot
+        = m_ringSnapshot ? m_ringSnapshot : std::max<uint64_t>(1, m_ringDumps / 4);
+    if (!full && m_ring.back().m_dumps >= snapshot) {
+        fullDump(true);  // Makes this dump a full one
+        full = true;
+    }
+    if (full) {
+        bufferFlush();  // Text so far belongs to the previous segment
+        if (m_ring.back().m_dumps) m_ring.emplace_back();
+        while (m_ring.size() > 1 && m_ringHeldDumps - m_ring.front().m_dumps >= m_ringDumps) {
+            m_ringHeldDumps -= m_ring.front().m_dumps;
+            m_ring.pop_front();
+        }
+    }
+    ++m_ring.back().m_dumps;
+    ++m_ringHeldDumps;
+}
+
+void VerilatedVcd::ringWrite() {
+    bufferFlush();
+    for (const RingSegment& segment : m_ring) {
+        bufferWrite(segment.m_text.data(), segment.m_text.size());
+    }
+    m_ring.clear();
+    m_ring.emplace_back();
+    m_ringHeldDumps = 0;
+    m_ringTriggered = false;
+    fullDump(true);  // Next window must start from a full snapshot
+}
+
+void VerilatedVcd::trigger() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    if (!isOpen() || !m_ringActive) return;
+    ringWrite();
+}
+
 void VerilatedVcd::emitTimeChange(uint64_t timeui) {
     printStr("#");
     printQuad(timeui);
@@ -230,7 +414,14 @@ void VerilatedVcd::closePrev() {
     if (!isOpen()) return;
 
     Super::flushBase();
+    if (m_ringActive) {
+        ringCheckErrors();
+        if (m_ringTriggered) ringWrite();
+        bufferFlush();  // Into the ring, so dropped if not triggered
+        m_ringActive = false;
+    }
     bufferFlush();
+    m_ring.clear();
     m_isOpen = false;
     m_filep->close();
 }
@@ -256,10 +447,29 @@ void VerilatedVcd::close() VL_MT_SAFE_EXCLUDES(m_mutex) {
     Super::closeBase();
 }
 
+void VerilatedVcd::detach() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock{m_mutex};
+    if (!isOpen()) return;
+    Super::detachBase();
+    // Anything buffered or held in the ring belongs to the parent
+    m_writep = m_wrBufp;
+    m_ring.clear();
+    m_ringHeldDumps = 0;
+    m_ringActive = false;
+    m_isOpen = false;
+    // A user supplied file object might write on close, so only close our own
+    if (m_fileNewed) m_filep->close();
+}
+
 void VerilatedVcd::flush() VL_MT_SAFE_EXCLUDES(m_mutex) {
     const VerilatedLockGuard lock{m_mutex};
     Super::flushBase();
+    if (m_ringActive) {
+        ringCheckErrors();
+        if (m_ringTriggered) ringWrite();
+    }
     bufferFlush();
+    if (isOpen()) m_filep->flush();
 }
 
 void VerilatedVcd::printStr(const char* str) {
@@ -298,9 +508,21 @@ void VerilatedVcd::bufferFlush() VL_MT_UNSAFE_ONE {
     // When it gets nearly full we dump it using this routine which calls write()
     // This is much faster than using buffered I/O
     if (VL_UNLIKELY(!isOpen())) return;
-    const char* wp = m_wrBufp;
+    if (VL_UNLIKELY(m_ringActive)) {
+        // Hold on to the text, it is only written when the ring is triggered
+        m_ring.back().m_text.append(m_wrBufp, m_writep - m_wrBufp);
+    } else {
+        bufferWrite(m_wrBufp, m_writep - m_wrBufp);
+    }
+
+    // Reset buffer
+    m_writep = m_wrBufp;
+}
+
+void VerilatedVcd::bufferWrite(const char* wp, size_t size) VL_MT_UNSAFE_ONE {
+    const char* const endp = wp + size;
     while (true) {
-        const ssize_t remaining = (m_writep - wp);
+        const ssize_t remaining = (endp - wp);
         if (remaining == 0) break;
         errno = 0;
         const ssize_t got = m_filep->write(wp, remaining);
@@ -320,9 +542,6 @@ void VerilatedVcd::bufferFlush() VL_MT_UNSAFE_ONE {
             }
         }
     }
-
-    // Reset buffer
-    m_writep = m_wrBufp;
 }
 
 //=============================================================================
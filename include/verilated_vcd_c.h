@@ -24,6 +24,7 @@
 #include "verilated.h"
 #include "verilated_trace.h"
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -69,8 +70,24 @@ private:
     std::vector<std::pair<char*, size_t>> m_freeBuffers;
     size_t m_numBuffers = 0;  // Number of trace buffers allocated
 
+    // Triggered ring mode. Rendered dumps are kept in memory, in segments that each
+    // start with a full dump, and are only written to the file when triggered.
+    struct RingSegment final {
+        std::string m_text;  // Rendered VCD text
+        uint64_t m_dumps = 0;  // Number of dumps in m_text
+    };
+    uint64_t m_ringDumps = 0;  // Number of most recent dumps to keep, 0 = ring off
+    uint64_t m_ringSnapshot = 0;  // Dumps per segment, 0 = m_ringDumps / 4
+    bool m_ringActive = false;  // Ring is capturing, header has been written
+    bool m_ringTriggered = false;  // Ring is to be written out at the next opportunity
+    bool m_ringGotError = false;  // Context had gotError at last check
+    int m_ringErrorCount = 0;  // Context error count at last check
+    uint64_t m_ringHeldDumps = 0;  // Sum of m_dumps over m_ring
+    std::deque<RingSegment> m_ring;  // Held segments, oldest first
+
     void bufferResize(size_t minsize);
     void bufferFlush() VL_MT_UNSAFE_ONE;
+    void bufferWrite(const char* wp, size_t size) VL_MT_UNSAFE_ONE;
     void bufferCheck() {
         // Flush the write buffer if there's not enough space left for new information
         // We only call this once per vector, so we need enough slop for a very wide "b###" line
@@ -85,6 +102,9 @@ private:
     void printStr(const char* str);
     void printQuad(uint64_t n);
     void printTime(uint64_t timeui);
+    void ringCheckErrors();
+    void ringPreDump(bool full);
+    void ringWrite();
     void declare(uint32_t code, const char* name, const char* wirep, bool array, int arraynum,
                  bool tri, bool bussed, int msb, int lsb);
 
@@ -103,7 +123,7 @@ protected:
     void emitTimeChange(uint64_t timeui) override;
 
     // Hooks called from VerilatedTrace
-    bool preFullDump() override { return isOpen(); }
+    bool preFullDump() override;
     bool preChangeDump() override;
 
     // Trace buffer management
@@ -124,6 +144,11 @@ public:
     // ACCESSORS
     // Set size in bytes after which new file should be created.
     void rolloverSize(uint64_t size) VL_MT_SAFE { m_rolloverSize = size; }
+    // Keep only the last 'dumps' dumps in memory until triggered. Call before open.
+    void ringSize(uint64_t dumps, uint64_t snapshotInterval) VL_MT_SAFE {
+        m_ringDumps = dumps;
+        m_ringSnapshot = snapshotInterval;
+    }
 
     // METHODS - All must be thread safe
     // Open the file; call isOpen() to see if errors
@@ -134,6 +159,11 @@ public:
     void close() VL_MT_SAFE_EXCLUDES(m_mutex);
     // Flush any remaining data to this file
     void flush() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Write the dumps held in ring mode to the file
+    void trigger() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // In a child created by VerilatedContext::forkChild, stop writing to the
+    // parent's file without flushing or closing it; the trace is then closed
+    void detach() VL_MT_SAFE_EXCLUDES(m_mutex);
     // Return if file is open
     bool isOpen() const VL_MT_SAFE { return m_isOpen; }
 
@@ -162,6 +192,12 @@ template <>
 void VerilatedVcd::Super::set_time_resolution(const std::string& unit);
 template <>
 void VerilatedVcd::Super::dumpvars(int level, const std::string& hier);
+template <>
+void VerilatedVcd::Super::scopeEnable(const std::string& hier, bool flag);
+template <>
+void VerilatedVcd::Super::sampleEvery(uint32_t every);
+template <>
+void VerilatedVcd::Super::sampleWindow(uint64_t period, uint64_t width, uint64_t start);
 #endif  // DOXYGEN
 
 //=============================================================================
@@ -237,6 +273,46 @@ public:
     virtual void close() VL_MT_UNSAFE;
     /// Write data to file (if it is open)
     virtual ssize_t write(const char* bufp, ssize_t len) VL_MT_UNSAFE;
+    /// Pass any data held by the object to the file
+    virtual void flush() VL_MT_UNSAFE {}
+};
+
+//=============================================================================
+// VerilatedVcdAsyncFile
+/// File that writes from a background thread. Data is gathered into large
+/// buffers, and while one buffer is written the next is filled, so the
+/// dumping thread only waits when the disk falls a whole buffer behind.
+/// Pass to the VerilatedVcdC constructor, which does not take ownership.
+
+class VerilatedVcdAsyncFile VL_NOT_FINAL : public VerilatedVcdFile {
+private:
+    static constexpr size_t BUFFER_SIZE = 1024 * 1024;  // Bytes gathered per write
+
+    VerilatedMutex m_mutex;  // Protects members below
+    std::condition_variable_any m_cv;  // Signalled when m_busy or m_shutdown changes
+    bool m_busy VL_GUARDED_BY(m_mutex) = false;  // m_pending is owned by the thread
+    bool m_shutdown VL_GUARDED_BY(m_mutex) = false;  // Thread should exit
+    int m_errno VL_GUARDED_BY(m_mutex) = 0;  // First write error, 0 = none
+    std::vector<char> m_fill;  // Buffer being filled by write()
+    std::vector<char> m_pending;  // Buffer being written by the thread
+    std::thread m_thread;  // Writer thread, when open
+
+    // METHODS
+    void submit() VL_MT_SAFE_EXCLUDES(m_mutex);
+    int wait() VL_MT_SAFE_EXCLUDES(m_mutex);
+    void stop() VL_MT_SAFE_EXCLUDES(m_mutex);
+    void threadMain() VL_MT_SAFE_EXCLUDES(m_mutex);
+
+public:
+    // CONSTRUCTORS
+    VerilatedVcdAsyncFile() = default;
+    ~VerilatedVcdAsyncFile() override;
+    VL_UNCOPYABLE(VerilatedVcdAsyncFile);
+    // METHODS
+    bool open(const std::string& name) override VL_MT_UNSAFE;
+    void close() override VL_MT_UNSAFE;
+    ssize_t write(const char* bufp, ssize_t len) override VL_MT_UNSAFE;
+    void flush() override VL_MT_UNSAFE;
 };
 
 //=============================================================================
@@ -275,6 +351,18 @@ public:
     /// alignment to a start of a given time's dump).  Any file but the
     /// first may be removed.  Cat files together to create viewable vcd.
     void rolloverSize(size_t size) VL_MT_SAFE { m_sptrace.rolloverSize(size); }
+    /// Enable triggered ring mode: rather than writing every dump, keep at
+    /// least the most recent 'dumps' dumps in memory, with a full snapshot
+    /// every 'snapshotInterval' dumps (default dumps/4), and only write them
+    /// to the file when triggered. The ring is triggered by trigger(), by a
+    /// Verilog $error, $stop or $fatal, and is then further maintained so
+    /// later triggers append later windows. Must be called before open, and
+    /// cannot be combined with rolloverSize.
+    void ringSize(uint64_t dumps, uint64_t snapshotInterval = 0) VL_MT_SAFE {
+        m_sptrace.ringSize(dumps, snapshotInterval);
+    }
+    /// In ring mode, write the dumps currently held to the file
+    void trigger() VL_MT_SAFE { m_sptrace.trigger(); }
     /// Close dump
     void close() VL_MT_SAFE { m_sptrace.close(); }
     /// Flush dump
@@ -309,6 +397,16 @@ public:
     void dumpvars(int level, const std::string& hier) VL_MT_SAFE {
         m_sptrace.dumpvars(level, hier);
     }
+    // Enable or disable tracing of a scope and everything under it, at any time
+    void scopeEnable(const std::string& hier, bool flag) VL_MT_SAFE {
+        m_sptrace.scopeEnable(hier, flag);
+    }
+    // Write only every 'every'th call to dump()
+    void sampleEvery(uint32_t every) VL_MT_SAFE { m_sptrace.sampleEvery(every); }
+    // Write dumps only within windows of 'width' time units every 'period' from 'start'
+    void sampleWindow(uint64_t period, uint64_t width, uint64_t start = 0) VL_MT_SAFE {
+        m_sptrace.sampleWindow(period, width, start);
+    }
 
     // Internal class access
     VerilatedVcd* spTrace() { return &m_sptrace; }
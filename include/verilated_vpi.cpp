@@ -31,11 +31,12 @@
 #include "verilated.h"
 #include "verilated_imp.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
-#include <unordered_set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -72,28 +73,48 @@ class VerilatedVpio VL_NOT_FINAL {
     // MEM MANGLEMENT
     // Internal note: Globals may multi-construct, see verilated.cpp top.
     static thread_local uint8_t* t_freeHeadp;
+    // Chunks have an 8 byte header: word zero is the magic when active (or the next
+    // pointer when on the free list), word one is the reference count
+    static constexpr size_t CHUNK_SIZE = 96;  // Large enough for all derived types
+    static constexpr size_t SLAB_CHUNKS = 64;  // Chunks allocated at once on refill
+    uint32_t* headerp() {
+        return reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(this) - 8);
+    }
+
+    VerilatedVpio** m_internpp = nullptr;  // Intern slot referring to this, see intern()
 
 public:
     // CONSTRUCTORS
     VerilatedVpio() = default;
-    virtual ~VerilatedVpio() = default;
+    virtual ~VerilatedVpio() {
+        if (m_internpp) *m_internpp = nullptr;
+    }
     static void* operator new(size_t size) VL_MT_SAFE {
         // We new and delete tons of vpi structures, so keep them around
         // To simplify our free list, we use a size large enough for all derived types
         // We reserve word zero for the next pointer, as that's safer in case a
         // dangling reference to the original remains around.
-        static constexpr size_t CHUNK_SIZE = 96;
         if (VL_UNCOVERABLE(size > CHUNK_SIZE))
             VL_FATAL_MT(__FILE__, __LINE__, "", "increase CHUNK_SIZE");
-        if (VL_LIKELY(t_freeHeadp)) {
-            uint8_t* const newp = t_freeHeadp;
-            t_freeHeadp = *(reinterpret_cast<uint8_t**>(newp));
-            *(reinterpret_cast<uint32_t*>(newp)) = activeMagic();
-            return newp + 8;
-        }
+#ifdef VL_VPI_IMMEDIATE_FREE  // Define to aid in finding leaky handles
         // +8: 8 bytes for next
-        uint8_t* newp = reinterpret_cast<uint8_t*>(::operator new(CHUNK_SIZE + 8));
-        *(reinterpret_cast<uint32_t*>(newp)) = activeMagic();
+        uint8_t* const newp = reinterpret_cast<uint8_t*>(::operator new(CHUNK_SIZE + 8));
+#else
+        if (VL_UNLIKELY(!t_freeHeadp)) {
+            // Refill with a slab of chunks, rather than one heap allocation per handle
+            uint8_t* const slabp
+                = reinterpret_cast<uint8_t*>(::operator new(SLAB_CHUNKS * (CHUNK_SIZE + 8)));
+            for (size_t i = SLAB_CHUNKS; i > 0; --i) {
+                uint8_t* const chunkp = slabp + (i - 1) * (CHUNK_SIZE + 8);
+                *(reinterpret_cast<uint8_t**>(chunkp)) = t_freeHeadp;
+                t_freeHeadp = chunkp;
+            }
+        }
+        uint8_t* const newp = t_freeHeadp;
+        t_freeHeadp = *(reinterpret_cast<uint8_t**>(newp));
+#endif
+        reinterpret_cast<uint32_t*>(newp)[0] = activeMagic();
+        reinterpret_cast<uint32_t*>(newp)[1] = 1;  // Reference count
         return newp + 8;
     }
     static void operator delete(void* obj, size_t /*size*/) VL_MT_SAFE {
@@ -110,6 +131,15 @@ public:
         t_freeHeadp = oldp;
 #endif
     }
+    // Reference counting, for handles shared by intern()
+    void ref() { ++headerp()[1]; }
+    bool unref() {  // Return true when the last reference is gone, so must delete
+        // If not active, delete reports the double release
+        if (VL_UNLIKELY(headerp()[0] != activeMagic())) return true;
+        return --headerp()[1] == 0;
+    }
+    // Record the slot caching this handle, so it will be cleared on delete
+    void intern(VerilatedVpio** slotpp) { m_internpp = slotpp; }
     // MEMBERS
     static VerilatedVpio* castp(vpiHandle h) {
         return dynamic_cast<VerilatedVpio*>(reinterpret_cast<VerilatedVpio*>(h));
@@ -495,12 +525,102 @@ struct VerilatedVpiTimedCbsCmp {
     }
 };
 
+class VerilatedVpiNameIndex final {
+    // Flat index of scope and variable full names, for vpi_handle_by_name
+    // Built on first use, and rebuilt when a context's scopes change
+    struct CStrHash final {
+        size_t operator()(const char* strp) const {
+            size_t hash = 14695981039346656037ULL;  // FNV-1a
+            for (; *strp; ++strp) hash = (hash ^ static_cast<uint8_t>(*strp)) * 1099511628211ULL;
+            return hash;
+        }
+    };
+    struct CStrEq final {
+        bool operator()(const char* ap, const char* bp) const { return !std::strcmp(ap, bp); }
+    };
+
+public:
+    struct Entry final {
+        const VerilatedScope* m_scopep;  // Scope, or scope of variable
+        const VerilatedVar* m_varp;  // Variable, or nullptr if a scope
+        VerilatedVpio* m_handlep = nullptr;  // Live handle interned for this name
+    };
+
+private:
+    using NameMap = std::unordered_map<const char*, Entry, CStrHash, CStrEq>;
+
+    NameMap m_names;  // Scopes by name, and variables by scope name "." variable name
+    NameMap m_topVars;  // Variables of the TOP scope, by variable name
+    std::deque<std::string> m_keys;  // Storage for variable keys in m_names
+    const VerilatedContext* m_contextp = nullptr;  // Context indexed
+    uint64_t m_generation = 0;  // Context's scopeNameGeneration when indexed
+
+    void unintern() {
+        // Handles still live remain valid, but are no longer interned
+        for (NameMap* const mapp : {&m_names, &m_topVars}) {
+            for (auto& it : *mapp) {
+                if (it.second.m_handlep) it.second.m_handlep->intern(nullptr);
+            }
+        }
+    }
+    void build(VerilatedContext* contextp) {
+        unintern();
+        m_names.clear();
+        m_topVars.clear();
+        m_keys.clear();
+        const VerilatedScopeNameMap* const scopesp = contextp->scopeNameMap();
+        // Scopes first, as a scope hides a variable of the same name
+        for (const auto& it : *scopesp) m_names.emplace(it.first, Entry{it.second, nullptr});
+        for (const auto& it : *scopesp) {
+            const VerilatedScope* const scopep = it.second;
+            const VerilatedVarNameMap* const varsp = scopep->varsp();
+            if (!varsp) continue;
+            const bool isTop = !std::strcmp(scopep->name(), "TOP");
+            for (const auto& vit : *varsp) {
+                m_keys.emplace_back(std::string{scopep->name()} + "." + vit.first);
+                m_names.emplace(m_keys.back().c_str(), Entry{scopep, &vit.second});
+                if (isTop) m_topVars.emplace(vit.first, Entry{scopep, &vit.second});
+            }
+        }
+    }
+
+public:
+    ~VerilatedVpiNameIndex() { unintern(); }
+    // Find as vpi_handle_by_name would, returning nullptr if not found
+    Entry* find(const char* namep) {
+        VerilatedContext* const contextp = Verilated::threadContextp();
+        const uint64_t generation = contextp->impp()->scopeNameGeneration();
+        if (VL_UNLIKELY(contextp != m_contextp || generation != m_generation)) {
+            build(contextp);
+            m_contextp = contextp;
+            m_generation = generation;
+        }
+        const auto it = m_names.find(namep);
+        if (it != m_names.end() && !it->second.m_varp) {  // Whole thing found as a scope
+            return &it->second;
+        }
+        const char* const dotp = std::strrchr(namep, '.');
+        if (!dotp || !std::memchr(namep, '.', dotp - namep)) {
+            // This is a toplevel, hence search in our TOP ports first.
+            const auto vit = m_topVars.find(dotp ? dotp + 1 : namep);
+            if (vit != m_topVars.end()) return &vit->second;
+        }
+        if (it == m_names.end()) return nullptr;
+        return &it->second;
+    }
+};
+
 class VerilatedVpiError;
 
 class VerilatedVpiImp final {
     enum { CB_ENUM_MAX_VALUE = cbAtEndOfSimTime + 1 };  // Maximum callback reason
     using VpioCbList = std::list<VerilatedVpiCbHolder>;
     using VpioFutureCbs = std::map<std::pair<QData, uint64_t>, VerilatedVpiCbHolder>;
+    struct HookWatch final {
+        // cbValueChange callbacks on a variable with VLVF_VPI_HOOK
+        VpioCbList m_cbs;  // Callbacks on this variable
+        std::atomic<bool> m_queued{false};  // In m_hookChanged
+    };
 
     // All only medium-speed, so use singleton function
     // Callbacks that are past or at current timestamp
@@ -510,6 +630,14 @@ class VerilatedVpiImp final {
     VerilatedVpiError* m_errorInfop = nullptr;  // Container for vpi error info
     VerilatedAssertOneThread m_assertOne;  // Assert only called from single thread
     uint64_t m_nextCallbackId = 1;  // Id to identify callback
+    // Value change callbacks on hooked variables, keyed by the variable's datap()
+    // Only changed by VPI calls, so may be read by valueHook during model evaluation
+    std::unordered_map<const void*, HookWatch> m_hookWatches;
+    VerilatedMutex m_hookMutex;  // Protects m_hookChanged
+    std::vector<HookWatch*> m_hookChanged VL_GUARDED_BY(m_hookMutex);  // Hooked since last call
+    std::vector<HookWatch*> m_hookChanging;  // Hooked before current callValueCbs
+    std::vector<VerilatedVpioVar*> m_valueUpdates;  // Values to save after value callbacks
+    VerilatedVpiNameIndex m_nameIndex;  // Index for vpi_handle_by_name
 
     static VerilatedVpiImp& s() {  // Singleton
         static VerilatedVpiImp s_s;
@@ -519,6 +647,7 @@ class VerilatedVpiImp final {
 public:
     static void assertOneCheck() { s().m_assertOne.check(); }
     static uint64_t nextCallbackId() { return ++s().m_nextCallbackId; }
+    static VerilatedVpiNameIndex& nameIndex() { return s().m_nameIndex; }
 
     static void cbCurrentAdd(uint64_t id, const s_cb_data* cb_data_p) {
         // The passed cb_data_p was property of the user, so need to recreate
@@ -528,7 +657,16 @@ public:
         VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_register_cb reason=%d id=%" PRId64 " obj=%p\n",
                                     cb_data_p->reason, id, cb_data_p->obj););
         VerilatedVpioVar* varop = nullptr;
-        if (cb_data_p->reason == cbValueChange) varop = VerilatedVpioVar::castp(cb_data_p->obj);
+        if (cb_data_p->reason == cbValueChange) {
+            varop = VerilatedVpioVar::castp(cb_data_p->obj);
+            if (varop && varop->varp()->isVpiHooked()) {
+                // Only checked by callValueCbs when the generated code calls valueHook
+                HookWatch& watch = s().m_hookWatches[varop->varp()->datap()];
+                watch.m_cbs.emplace_back(id, cb_data_p, varop);
+                VerilatedVpi::s_hookWatched = true;
+                return;
+            }
+        }
         s().m_cbCurrentLists[cb_data_p->reason].emplace_back(id, cb_data_p, varop);
     }
     static void cbFutureAdd(uint64_t id, const s_cb_data* cb_data_p, QData time) {
@@ -560,6 +698,16 @@ public:
                 return;  // Once found, it won't also be in m_futureCbs
             }
         }
+        if (reason == cbValueChange) {  // Remove from hooked variables
+            for (auto& iw : s().m_hookWatches) {
+                for (auto& ir : iw.second.m_cbs) {
+                    if (ir.id() == id) {
+                        ir.invalidate();
+                        return;
+                    }
+                }
+            }
+        }
         {  // Remove from cbFuture queue
             const auto it = s().m_futureCbs.find(std::make_pair(time, id));
             if (it != s().m_futureCbs.end()) {
@@ -608,6 +756,9 @@ public:
         if (VL_LIKELY(it != s().m_futureCbs.cend())) return it->first.first;
         return ~0ULL;  // maxquad
     }
+    static void countCallback() VL_MT_SAFE {
+        Verilated::threadContextp()->stats().add(VerilatedContextStats::VPI_CALLBACKS);
+    }
     static bool callCbs(const uint32_t reason) VL_MT_UNSAFE_ONE {
         VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: callCbs reason=%u\n", reason););
         assertOneCheck();
@@ -624,16 +775,47 @@ public:
                                             reason, ihor.id()););
                 ihor.invalidate();  // Timed callbacks are one-shot
                 (ihor.cb_rtnp())(ihor.cb_datap());
+                countCallback();
                 called = true;
             }
         }
         return called;
     }
+    static void valueHook(const void* datap) VL_MT_SAFE {
+        const auto it = s().m_hookWatches.find(datap);
+        if (it == s().m_hookWatches.end()) return;
+        HookWatch& watch = it->second;
+        if (watch.m_queued.load(std::memory_order_relaxed) || watch.m_queued.exchange(true)) {
+            return;
+        }
+        const VerilatedLockGuard lock{s().m_hookMutex};
+        s().m_hookChanged.push_back(&watch);
+    }
     static bool callValueCbs() VL_MT_UNSAFE_ONE {
         assertOneCheck();
-        VpioCbList& cbObjList = s().m_cbCurrentLists[cbValueChange];
+        bool called = callValueCbList(s().m_cbCurrentLists[cbValueChange]);
+        if (!s().m_hookWatches.empty()) {
+            // Only hooked variables that may have changed need checking
+            std::vector<HookWatch*>& changing = s().m_hookChanging;
+            {
+                const VerilatedLockGuard lock{s().m_hookMutex};
+                std::swap(changing, s().m_hookChanged);
+            }
+            for (HookWatch* const watchp : changing) {
+                watchp->m_queued = false;
+                if (callValueCbList(watchp->m_cbs)) called = true;
+            }
+            changing.clear();
+        }
+        // Save values after all callbacks, as callbacks may change them
+        for (VerilatedVpioVar* const varop : s().m_valueUpdates) {
+            std::memcpy(varop->prevDatap(), varop->varDatap(), varop->entSize());
+        }
+        s().m_valueUpdates.clear();
+        return called;
+    }
+    static bool callValueCbList(VpioCbList& cbObjList) VL_MT_UNSAFE_ONE {
         bool called = false;
-        std::unordered_set<VerilatedVpioVar*> update;  // set of objects to update after callbacks
         if (cbObjList.empty()) return called;
         const auto last = std::prev(cbObjList.end());  // prevent looping over newly added elements
         for (auto it = cbObjList.begin(); true;) {
@@ -656,16 +838,14 @@ public:
                 VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: value_callback %" PRId64 " %s v[0]=%d\n",
                                             ho.id(), varop->fullname(),
                                             *(static_cast<CData*>(newDatap))););
-                update.insert(varop);
+                s().m_valueUpdates.push_back(varop);
                 vpi_get_value(ho.cb_datap()->obj, ho.cb_datap()->value);
                 (ho.cb_rtnp())(ho.cb_datap());
+                countCallback();
                 called = true;
             }
             if (was_last) break;
         }
-        for (const auto& ip : update) {
-            std::memcpy(ip->prevDatap(), ip->varDatap(), ip->entSize());
-        }
         return called;
     }
     static void dumpCbs() VL_MT_UNSAFE_ONE;
@@ -761,6 +941,12 @@ void VerilatedVpi::callTimedCbs() VL_MT_UNSAFE_ONE { VerilatedVpiImp::callCbs(cb
 
 bool VerilatedVpi::callValueCbs() VL_MT_UNSAFE_ONE { return VerilatedVpiImp::callValueCbs(); }
 
+bool VerilatedVpi::s_hookWatched = false;
+
+void VerilatedVpi::valueHookWatched(const void* datap) VL_MT_SAFE {
+    VerilatedVpiImp::valueHook(datap);
+}
+
 QData VerilatedVpi::cbNextDeadline() VL_MT_UNSAFE_ONE { return VerilatedVpiImp::cbNextDeadline(); }
 
 void VerilatedVpi::dumpCbs() VL_MT_UNSAFE_ONE { VerilatedVpiImp::dumpCbs(); }
@@ -1425,51 +1611,37 @@ vpiHandle vpi_handle_by_name(PLI_BYTE8* namep, vpiHandle scope) {
     VL_VPI_ERROR_RESET_();
     if (VL_UNLIKELY(!namep)) return nullptr;
     VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_handle_by_name %s %p\n", namep, scope););
-    const VerilatedVar* varp = nullptr;
-    const VerilatedScope* scopep;
     const VerilatedVpioScope* const voScopep = VerilatedVpioScope::castp(scope);
-    std::string scopeAndName = namep;
+    std::string scopeAndName;
     if (voScopep) {
         scopeAndName = std::string{voScopep->fullname()} + "." + namep;
         namep = const_cast<PLI_BYTE8*>(scopeAndName.c_str());
     }
-    {
-        // This doesn't yet follow the hierarchy in the proper way
-        scopep = Verilated::threadContextp()->scopeFind(namep);
-        if (scopep) {  // Whole thing found as a scope
-            if (scopep->type() == VerilatedScope::SCOPE_MODULE) {
-                return (new VerilatedVpioModule{scopep})->castVpiHandle();
-            } else {
-                return (new VerilatedVpioScope{scopep})->castVpiHandle();
-            }
-        }
-        const char* baseNamep = scopeAndName.c_str();
-        std::string scopename;
-        const char* const dotp = std::strrchr(namep, '.');
-        if (VL_LIKELY(dotp)) {
-            baseNamep = dotp + 1;
-            const size_t len = dotp - namep;
-            scopename = std::string{namep, len};
-        }
-
-        if (scopename.find('.') == std::string::npos) {
-            // This is a toplevel, hence search in our TOP ports first.
-            scopep = Verilated::threadContextp()->scopeFind("TOP");
-            if (scopep) varp = scopep->varFind(baseNamep);
-        }
-        if (!varp) {
-            scopep = Verilated::threadContextp()->scopeFind(scopename.c_str());
-            if (!scopep) return nullptr;
-            varp = scopep->varFind(baseNamep);
+    // This doesn't yet follow the hierarchy in the proper way
+    VerilatedVpiNameIndex::Entry* const entryp = VerilatedVpiImp::nameIndex().find(namep);
+    if (!entryp) return nullptr;
+    // Repeated lookups share one handle, which vpi_release_handle reference counts
+    if (entryp->m_handlep) {
+        entryp->m_handlep->ref();
+        return entryp->m_handlep->castVpiHandle();
+    }
+    const VerilatedScope* const scopep = entryp->m_scopep;
+    const VerilatedVar* const varp = entryp->m_varp;
+    VerilatedVpio* vop;
+    if (!varp) {  // Whole thing found as a scope
+        if (scopep->type() == VerilatedScope::SCOPE_MODULE) {
+            vop = new VerilatedVpioModule{scopep};
+        } else {
+            vop = new VerilatedVpioScope{scopep};
         }
-    }
-    if (!varp) return nullptr;
-
-    if (varp->isParam()) {
-        return (new VerilatedVpioParam{varp, scopep})->castVpiHandle();
+    } else if (varp->isParam()) {
+        vop = new VerilatedVpioParam{varp, scopep};
     } else {
-        return (new VerilatedVpioVar{varp, scopep})->castVpiHandle();
+        vop = new VerilatedVpioVar{varp, scopep};
     }
+    entryp->m_handlep = vop;
+    vop->intern(&entryp->m_handlep);
+    return vop->castVpiHandle();
 }
 
 vpiHandle vpi_handle_by_index(vpiHandle object, PLI_INT32 indx) {
@@ -2008,6 +2180,7 @@ vpiHandle vpi_put_value(vpiHandle object, p_vpi_value valuep, p_vpi_time /*time_
             return nullptr;
         }
         if (!vl_check_format(vop->varp(), valuep, vop->fullname(), false)) return nullptr;
+        VerilatedVpiImp::valueHook(vop->varp()->datap());  // Only read by callValueCbs
         if (valuep->format == vpiVectorVal) {
             if (VL_UNLIKELY(!valuep->value.vector)) return nullptr;
             if (vop->varp()->vltype() == VLVT_UINT8) {
@@ -2207,13 +2380,272 @@ vpiHandle vpi_put_value(vpiHandle object, p_vpi_value valuep, p_vpi_time /*time_
     return nullptr;
 }
 
-void vpi_get_value_array(vpiHandle /*object*/, p_vpi_arrayvalue /*arrayvalue_p*/,
-                         PLI_INT32* /*index_p*/, PLI_UINT32 /*num*/) {
-    VL_VPI_UNIMP_();
+// Array value processing (IEEE 1800-2017 38.15)
+// Elements are accessed from the given index in increasing index order,
+// wrapping from the last element to the first.
+
+// Raw values are least significant byte first, so on little endian hosts
+// are the same as the storage of whole byte variables
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static constexpr bool VL_VPI_RAW_NATIVE = false;
+#else
+static constexpr bool VL_VPI_RAW_NATIVE = true;
+#endif
+
+static const VerilatedVpioVar* vl_array_check(const char* funcp, vpiHandle object,
+                                              const p_vpi_arrayvalue arrayvalue_p,
+                                              const PLI_INT32* index_p, uint32_t& startr) {
+    const VerilatedVpioVar* const vop = VerilatedVpioVar::castp(object);
+    if (VL_UNLIKELY(!vop || VerilatedVpioMemoryWord::castp(object)
+                    || vop->varp()->udims() != 1)) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported vpiHandle (%p), not an unpacked array",
+                      funcp, object);
+        return nullptr;
+    }
+    if (VL_UNLIKELY(!arrayvalue_p || !index_p)) {
+        VL_VPI_WARNING_(__FILE__, __LINE__, "%s: Ignoring with nullptr value or index pointer",
+                        funcp);
+        return nullptr;
+    }
+    switch (vop->varp()->vltype()) {
+    case VLVT_UINT8:
+    case VLVT_UINT16:
+    case VLVT_UINT32:
+    case VLVT_UINT64:
+    case VLVT_WDATA: break;
+    default:
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported type (%d) for %s", funcp,
+                      vop->varp()->vltype(), vop->fullname());
+        return nullptr;
+    }
+    switch (arrayvalue_p->format) {
+    case vpiIntVal:
+    case vpiShortIntVal:
+    case vpiLongIntVal:
+    case vpiVectorVal:
+    case vpiRawTwoStateVal:
+    case vpiRawFourStateVal:
+    case vpiTimeVal: break;
+    default:
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported format (%s) for %s", funcp,
+                      VerilatedVpiError::strFromVpiVal(arrayvalue_p->format), vop->fullname());
+        return nullptr;
+    }
+    const VerilatedRange& range = vop->varp()->unpacked();
+    if (VL_UNLIKELY(index_p[0] < range.low() || index_p[0] > range.high())) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Index %d out of range for %s", funcp, index_p[0],
+                      vop->fullname());
+        return nullptr;
+    }
+    startr = index_p[0] - range.low();
+    return vop;
 }
-void vpi_put_value_array(vpiHandle /*object*/, p_vpi_arrayvalue /*arrayvalue_p*/,
-                         PLI_INT32* /*index_p*/, PLI_UINT32 /*num*/) {
-    VL_VPI_UNIMP_();
+
+// Number of bytes each element takes in arrayvalue_p's data
+static size_t vl_array_elem_bytes(PLI_UINT32 format, int bits) {
+    switch (format) {
+    case vpiIntVal: return sizeof(PLI_INT32);
+    case vpiShortIntVal: return sizeof(PLI_INT16);
+    case vpiLongIntVal: return sizeof(PLI_INT64);
+    case vpiVectorVal: return VL_WORDS_I(bits) * sizeof(s_vpi_vecval);
+    case vpiRawTwoStateVal: return VL_BYTES_I(bits);
+    case vpiRawFourStateVal: return 2 * VL_BYTES_I(bits);
+    case vpiTimeVal: return sizeof(s_vpi_time);
+    default: return 0;  // LCOV_EXCL_LINE // Rejected by vl_array_check
+    }
+}
+
+static void vl_array_elem_read(VerilatedVarType vltype, int words, const void* datap,
+                               EData* outp) {
+    switch (vltype) {
+    case VLVT_UINT8: outp[0] = *static_cast<const CData*>(datap); break;
+    case VLVT_UINT16: outp[0] = *static_cast<const SData*>(datap); break;
+    case VLVT_UINT32: outp[0] = *static_cast<const IData*>(datap); break;
+    case VLVT_UINT64: VL_SET_WQ(outp, *static_cast<const QData*>(datap)); break;
+    default: std::memcpy(outp, datap, words * sizeof(EData)); break;
+    }
+}
+
+static void vl_array_elem_write(VerilatedVarType vltype, int words, EData mask, void* datap,
+                                EData* inp) {
+    inp[words - 1] &= mask;
+    switch (vltype) {
+    case VLVT_UINT8: *static_cast<CData*>(datap) = inp[0]; break;
+    case VLVT_UINT16: *static_cast<SData*>(datap) = inp[0]; break;
+    case VLVT_UINT32: *static_cast<IData*>(datap) = inp[0]; break;
+    case VLVT_UINT64: *static_cast<QData*>(datap) = VL_SET_QW(inp); break;
+    default: std::memcpy(datap, inp, words * sizeof(EData)); break;
+    }
+}
+
+void vpi_get_value_array(vpiHandle object, p_vpi_arrayvalue arrayvalue_p, PLI_INT32* index_p,
+                         PLI_UINT32 num) {
+    VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_get_value_array %p %u\n", object, num););
+    VerilatedVpiImp::assertOneCheck();
+    VL_VPI_ERROR_RESET_();
+    uint32_t start = 0;
+    const VerilatedVpioVar* const vop
+        = vl_array_check(__func__, object, arrayvalue_p, index_p, start /*ref*/);
+    if (!vop) return;
+    const VerilatedVar* const varp = vop->varp();
+    const PLI_UINT32 format = arrayvalue_p->format;
+    const int bits = varp->packed().elements();
+    const int words = VL_WORDS_I(bits);
+    const int bytes = VL_BYTES_I(bits);
+    const size_t elemBytes = vl_array_elem_bytes(format, bits);
+    const uint32_t size = varp->unpacked().elements();
+    const uint32_t entSize = vop->entSize();
+    const uint8_t* const datap = static_cast<const uint8_t*>(varp->datap());
+
+    if (!(arrayvalue_p->flags & vpiUserAllocFlag)) {
+        // Owned by us until the next call, QData for alignment
+        static thread_local std::vector<QData> t_out;
+        t_out.resize((elemBytes * num + sizeof(QData) - 1) / sizeof(QData));
+        arrayvalue_p->value.rawvals = reinterpret_cast<PLI_BYTE8*>(t_out.data());
+    }
+    uint8_t* const outp = reinterpret_cast<uint8_t*>(arrayvalue_p->value.rawvals);
+
+    if (format == vpiRawTwoStateVal && static_cast<uint32_t>(bytes) == entSize
+        && VL_VPI_RAW_NATIVE) {
+        // Raw value is the storage itself; copy at most two runs, as may wrap
+        for (uint32_t done = 0; done < num;) {
+            const uint32_t offset = (start + done) % size;
+            const uint32_t n = std::min(num - done, size - offset);
+            std::memcpy(outp + done * elemBytes, datap + offset * entSize, n * elemBytes);
+            done += n;
+        }
+        return;
+    }
+
+    EData value[VL_VALUE_STRING_MAX_WORDS];
+    if (VL_UNLIKELY(words > VL_VALUE_STRING_MAX_WORDS)) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported width (%d) for %s", __func__, bits,
+                      vop->fullname());
+        return;
+    }
+    for (uint32_t i = 0; i < num; ++i) {
+        vl_array_elem_read(varp->vltype(), words, datap + ((start + i) % size) * entSize, value);
+        uint8_t* const elemp = outp + i * elemBytes;
+        switch (format) {
+        case vpiIntVal: reinterpret_cast<PLI_INT32*>(elemp)[0] = value[0]; break;
+        case vpiShortIntVal: reinterpret_cast<PLI_INT16*>(elemp)[0] = value[0]; break;
+        case vpiLongIntVal:
+            reinterpret_cast<PLI_INT64*>(elemp)[0] = words > 1 ? VL_SET_QW(value) : value[0];
+            break;
+        case vpiVectorVal: {
+            p_vpi_vecval const vecp = reinterpret_cast<p_vpi_vecval>(elemp);
+            for (int w = 0; w < words; ++w) {
+                vecp[w].aval = value[w];
+                vecp[w].bval = 0;
+            }
+            break;
+        }
+        case vpiRawTwoStateVal:
+        case vpiRawFourStateVal:
+            for (int b = 0; b < bytes; ++b) {
+                elemp[b] = value[b / sizeof(EData)] >> ((b % sizeof(EData)) * 8);
+            }
+            if (format == vpiRawFourStateVal) std::memset(elemp + bytes, 0, bytes);
+            break;
+        case vpiTimeVal: {
+            p_vpi_time const timep = reinterpret_cast<p_vpi_time>(elemp);
+            timep->type = vpiSimTime;
+            timep->low = value[0];
+            timep->high = words > 1 ? value[1] : 0;
+            timep->real = 0;
+            break;
+        }
+        default: break;  // LCOV_EXCL_LINE // Rejected by vl_array_check
+        }
+    }
+}
+
+void vpi_put_value_array(vpiHandle object, p_vpi_arrayvalue arrayvalue_p, PLI_INT32* index_p,
+                         PLI_UINT32 num) {
+    VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_put_value_array %p %u\n", object, num););
+    VerilatedVpiImp::assertOneCheck();
+    VL_VPI_ERROR_RESET_();
+    uint32_t start = 0;
+    const VerilatedVpioVar* const vop
+        = vl_array_check(__func__, object, arrayvalue_p, index_p, start /*ref*/);
+    if (!vop) return;
+    const VerilatedVar* const varp = vop->varp();
+    if (VL_UNLIKELY(!varp->isPublicRW())) {
+        VL_VPI_WARNING_(__FILE__, __LINE__,
+                        "Ignoring vpi_put_value_array to signal marked read-only,"
+                        " use public_flat_rw instead: %s",
+                        vop->fullname());
+        return;
+    }
+    const PLI_UINT32 format = arrayvalue_p->format;
+    const int bits = varp->packed().elements();
+    const int words = VL_WORDS_I(bits);
+    const int bytes = VL_BYTES_I(bits);
+    const EData mask = VL_MASK_E(bits);
+    // With vpiOneValue, the first value is written to all elements
+    const size_t elemBytes
+        = (arrayvalue_p->flags & vpiOneValue) ? 0 : vl_array_elem_bytes(format, bits);
+    const uint32_t size = varp->unpacked().elements();
+    const uint32_t entSize = vop->entSize();
+    uint8_t* const datap = static_cast<uint8_t*>(varp->datap());
+    const uint8_t* const inp = reinterpret_cast<const uint8_t*>(arrayvalue_p->value.rawvals);
+    VerilatedVpiImp::valueHook(datap);  // Only read by callValueCbs
+
+    if (format == vpiRawTwoStateVal && static_cast<uint32_t>(bytes) == entSize && elemBytes
+        && !(bits % 8) && VL_VPI_RAW_NATIVE) {
+        // Raw value is the storage itself, and fills it so there is no mask
+        for (uint32_t done = 0; done < num;) {
+            const uint32_t offset = (start + done) % size;
+            const uint32_t n = std::min(num - done, size - offset);
+            std::memcpy(datap + offset * entSize, inp + done * elemBytes, n * elemBytes);
+            done += n;
+        }
+        return;
+    }
+
+    EData value[VL_VALUE_STRING_MAX_WORDS];
+    if (VL_UNLIKELY(words > VL_VALUE_STRING_MAX_WORDS)) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported width (%d) for %s", __func__, bits,
+                      vop->fullname());
+        return;
+    }
+    for (uint32_t i = 0; i < num; ++i) {
+        const uint8_t* const elemp = inp + i * elemBytes;
+        std::memset(value, 0, words * sizeof(EData));
+        switch (format) {
+        case vpiIntVal: value[0] = reinterpret_cast<const PLI_INT32*>(elemp)[0]; break;
+        case vpiShortIntVal:
+            value[0] = static_cast<uint16_t>(reinterpret_cast<const PLI_INT16*>(elemp)[0]);
+            break;
+        case vpiLongIntVal: {
+            const QData q = reinterpret_cast<const PLI_INT64*>(elemp)[0];
+            value[0] = static_cast<EData>(q);
+            if (words > 1) value[1] = static_cast<EData>(q >> 32);
+            break;
+        }
+        case vpiVectorVal: {
+            const t_vpi_vecval* const vecp = reinterpret_cast<const t_vpi_vecval*>(elemp);
+            for (int w = 0; w < words; ++w) value[w] = vecp[w].aval;
+            break;
+        }
+        case vpiRawTwoStateVal:
+        case vpiRawFourStateVal:  // bval bytes ignored
+            for (int b = 0; b < bytes; ++b) {
+                value[b / sizeof(EData)] |= static_cast<EData>(elemp[b])
+                                            << ((b % sizeof(EData)) * 8);
+            }
+            break;
+        case vpiTimeVal: {
+            const t_vpi_time* const timep = reinterpret_cast<const t_vpi_time*>(elemp);
+            value[0] = timep->low;
+            if (words > 1) value[1] = timep->high;
+            break;
+        }
+        default: break;  // LCOV_EXCL_LINE // Rejected by vl_array_check
+        }
+        vl_array_elem_write(varp->vltype(), words, mask, datap + ((start + i) % size) * entSize,
+                            value);
+    }
 }
 
 // time processing
@@ -2348,6 +2780,7 @@ PLI_INT32 vpi_release_handle(vpiHandle object) {
     VerilatedVpio* const vop = VerilatedVpio::castp(object);
     VL_VPI_ERROR_RESET_();
     if (VL_UNLIKELY(!vop)) return 0;
+    if (!vop->unref()) return 1;  // Still shared by another vpi_handle_by_name
     VL_DO_DANGLING(delete vop, vop);
     return 1;
 }
@@ -46,6 +46,12 @@ public:
     /// Call value based callbacks.
     /// User wrapper code should call this from their main loops.
     static bool callValueCbs() VL_MT_UNSAFE_ONE;
+    /// Note the variable at the given address may have changed, so
+    /// callValueCbs checks its value change callbacks.
+    /// Called by code Verilated with --vpi-hooks after writing a public variable.
+    static void valueHook(const void* datap) VL_MT_SAFE {
+        if (VL_UNLIKELY(s_hookWatched)) valueHookWatched(datap);
+    }
     /// Call callbacks of arbitrary types.
     /// User wrapper code should call this from their main loops.
     static bool callCbs(uint32_t reason) VL_MT_UNSAFE_ONE;
@@ -57,6 +63,11 @@ public:
 
     // Self test, for internal use only
     static void selfTest() VL_MT_UNSAFE_ONE;
+
+private:
+    friend class VerilatedVpiImp;
+    static bool s_hookWatched;  // Any value change callback on a --vpi-hooks variable
+    static void valueHookWatched(const void* datap) VL_MT_SAFE;
 };
 
 #endif  // Guard
@@ -48,6 +48,9 @@
 # define VL_ATTR_NOINLINE __attribute__((noinline))
 # define VL_ATTR_COLD __attribute__((cold))
 # define VL_ATTR_HOT __attribute__((hot))
+# ifdef __ELF__
+#  define VL_ATTR_SECTION(name) __attribute__((section(name)))
+# endif
 # define VL_ATTR_NORETURN __attribute__((noreturn))
 // clang and gcc-8.0+ support no_sanitize("string") style attribute
 # if defined(__clang__) || (__GNUC__ >= 8)
@@ -67,6 +70,11 @@
 # define VL_UNREACHABLE __builtin_unreachable()  // C++23 std::unreachable()
 # define VL_PREFETCH_RD(p) __builtin_prefetch((p), 0)
 # define VL_PREFETCH_RW(p) __builtin_prefetch((p), 1)
+# if defined(__clang__)
+#  define VL_LOOP_VECTORIZE _Pragma("clang loop vectorize(enable)")
+# else
+#  define VL_LOOP_VECTORIZE _Pragma("GCC ivdep")
+# endif
 #endif
 
 // Function acquires a capability/lock (-fthread-safety)
@@ -139,6 +147,9 @@
 #ifndef VL_ATTR_NO_SANITIZE_ALIGN
 # define VL_ATTR_NO_SANITIZE_ALIGN  ///< Attribute that function contains intended unaligned access
 #endif
+#ifndef VL_ATTR_SECTION
+# define VL_ATTR_SECTION(name)  ///< Attribute to place function in named text section
+#endif
 #ifndef VL_ATTR_PRINTF
 # define VL_ATTR_PRINTF(fmtArgNum)  ///< Attribute for function with printf format checking
 #endif
@@ -166,6 +177,9 @@
 #ifndef VL_PREFETCH_RW
 # define VL_PREFETCH_RW(p)  ///< Prefetch pointer argument with read/write intent
 #endif
+#ifndef VL_LOOP_VECTORIZE
+# define VL_LOOP_VECTORIZE  ///< Following loop has independent iterations, so vectorize it
+#endif
 
 
 #ifndef VL_NO_LEGACY
@@ -400,6 +414,9 @@ using ssize_t = uint32_t;  ///< signed size_t; returned from read()
 #define VL_SHORTSIZE 16  ///< Bits in a SData / short
 #define VL_IDATASIZE 32  ///< Bits in an IData / word
 #define VL_QUADSIZE 64  ///< Bits in a QData / quadword
+// EData stays 32 bits so wide values share layout with the svBitVecVal and
+// s_vpi_vecval words of DPI and VPI, and with trace and save file words.
+// Functions that gain from 64-bit limbs should combine word pairs locally.
 #define VL_EDATASIZE 32  ///< Bits in an EData (WData entry)
 #define VL_EDATASIZE_LOG2 5  ///< log2(VL_EDATASIZE)
 #define VL_CACHE_LINE_BYTES 64  ///< Bytes in a cache line (for alignment)
@@ -0,0 +1,98 @@
+// DESCRIPTION: Verilator: Benchmark: Common simulation harness
+//
+// Clocks the "bench" top module for +cycles+<n> cycles, and reports the
+// simulation rate and resident memory as a single "BENCH" line that
+// nodist/bench/run_bench parses.
+//
+// Compile with -DBENCH_TRACE_VCD or -DBENCH_TRACE_FST to dump a trace, and
+// -DBENCH_TIMING when the design generates its own clock with --timing.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include "Vbench.h"
+
+#if defined(BENCH_TRACE_VCD)
+#include <verilated_vcd_c.h>
+#define BENCH_TRACE_CLASS VerilatedVcdC
+#define BENCH_TRACE_FILE "bench.vcd"
+#elif defined(BENCH_TRACE_FST)
+#include <verilated_fst_c.h>
+#define BENCH_TRACE_CLASS VerilatedFstC
+#define BENCH_TRACE_FILE "bench.fst"
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <sys/resource.h>
+
+double sc_time_stamp() { return 0; }
+
+int main(int argc, char** argv) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+#ifdef BENCH_TRACE_CLASS
+    contextp->traceEverOn(true);
+#endif
+    const std::unique_ptr<Vbench> topp{new Vbench{contextp.get(), "TOP"}};
+
+    uint64_t cycles = 100000;
+    const std::string cyclesArg = contextp->commandArgsPlusMatch("cycles+");
+    if (!cyclesArg.empty()) cycles = std::strtoull(cyclesArg.c_str() + 8, nullptr, 10);
+
+#ifdef BENCH_TRACE_CLASS
+    const std::unique_ptr<BENCH_TRACE_CLASS> tfp{new BENCH_TRACE_CLASS};
+    topp->trace(tfp.get(), 99);
+    tfp->open(BENCH_TRACE_FILE);
+#endif
+
+    const auto start = std::chrono::steady_clock::now();
+#ifdef BENCH_TIMING
+    // The design clocks itself with a period of 10 time units
+    const uint64_t endTime = cycles * 10;
+    topp->eval();
+    while (!contextp->gotFinish() && topp->eventsPending()
+           && topp->nextTimeSlot() <= endTime) {
+        contextp->time(topp->nextTimeSlot());
+        topp->eval();
+#ifdef BENCH_TRACE_CLASS
+        tfp->dump(contextp->time());
+#endif
+    }
+#else
+    topp->clk = 0;
+    topp->eval();
+    for (uint64_t cycle = 0; cycle < cycles && !contextp->gotFinish(); ++cycle) {
+        for (int edge = 0; edge < 2; ++edge) {
+            contextp->timeInc(5);
+            topp->clk = !topp->clk;
+            topp->eval();
+#ifdef BENCH_TRACE_CLASS
+            tfp->dump(contextp->time());
+#endif
+        }
+    }
+#endif
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+#ifdef BENCH_TRACE_CLASS
+    tfp->close();
+#endif
+    topp->final();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    const double seconds = elapsed.count();
+    std::printf("BENCH cycles %llu seconds %.6f khz %.3f rss_kb %ld result %08x\n",
+                static_cast<unsigned long long>(cycles), seconds,
+                seconds > 0 ? cycles / seconds / 1000.0 : 0.0, usage.ru_maxrss,
+                static_cast<unsigned>(topp->result));
+    return 0;
+}
@@ -0,0 +1,105 @@
+// DESCRIPTION: Verilator: Benchmark: Wide datapath crypto
+//
+// Pipelined ChaCha style double rounds over a 512-bit state, exercising
+// wide (VlWide) expressions. The output folds every pipeline stage into a
+// wide accumulator so no stage can be optimized away.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module bench #(parameter STAGES = 10, LANES = 4)
+   (input clk,
+    output reg [31:0] result);
+
+   reg [511:0] acc [0:LANES-1];
+   wire [511:0] outs [0:LANES-1];
+   reg [511:0] counter = 512'h1;
+
+   genvar l;
+   generate
+      for (l = 0; l < LANES; l = l + 1) begin : lanes
+         crypto_pipe #(.STAGES(STAGES))
+         pipe(.clk(clk), .in(counter ^ {16{32'(l)}}), .out(outs[l]));
+      end
+   endgenerate
+
+   integer i;
+   always @(posedge clk) begin
+      counter <= counter + 1;
+      for (i = 0; i < LANES; i = i + 1) acc[i] <= {acc[i][510:0], acc[i][511]} ^ outs[i];
+   end
+
+   reg [511:0] fold;
+   always @* begin
+      fold = 0;
+      for (i = 0; i < LANES; i = i + 1) fold = fold ^ acc[i];
+      result = 0;
+      for (i = 0; i < 16; i = i + 1) result = result ^ fold[i * 32 +: 32];
+   end
+endmodule
+
+module crypto_pipe #(parameter STAGES = 10)
+   (input clk,
+    input [511:0] in,
+    output [511:0] out);
+
+   reg [511:0] stage [0:STAGES];
+   wire [511:0] rounds [0:STAGES-1];
+
+   always @* stage[0] = in;
+
+   genvar s;
+   generate
+      for (s = 0; s < STAGES; s = s + 1) begin : stages
+         crypto_double_round dr(.in(stage[s]), .out(rounds[s]));
+         always @(posedge clk) stage[s + 1] <= rounds[s];
+      end
+   endgenerate
+
+   // Final feed-forward addition as in ChaCha
+   assign out = stage[STAGES] + in;
+endmodule
+
+module crypto_double_round
+   (input [511:0] in,
+    output reg [511:0] out);
+
+   reg [31:0] x [0:15];
+   integer i;
+
+   function [127:0] quarter(input [31:0] a_in, b_in, c_in, d_in);
+      reg [31:0] a, b, c, d;
+      begin
+         a = a_in; b = b_in; c = c_in; d = d_in;
+         a = a + b; d = d ^ a; d = {d[15:0], d[31:16]};
+         c = c + d; b = b ^ c; b = {b[19:0], b[31:20]};
+         a = a + b; d = d ^ a; d = {d[23:0], d[31:24]};
+         c = c + d; b = b ^ c; b = {b[24:0], b[31:25]};
+         quarter = {a, b, c, d};
+      end
+   endfunction
+
+   task automatic qr(input integer a, b, c, d);
+      reg [127:0] r;
+      begin
+         r = quarter(x[a], x[b], x[c], x[d]);
+         {x[a], x[b], x[c], x[d]} = r;
+      end
+   endtask
+
+   always @* begin
+      for (i = 0; i < 16; i = i + 1) x[i] = in[i * 32 +: 32];
+      // Column round
+      qr(0, 4, 8, 12);
+      qr(1, 5, 9, 13);
+      qr(2, 6, 10, 14);
+      qr(3, 7, 11, 15);
+      // Diagonal round
+      qr(0, 5, 10, 15);
+      qr(1, 6, 11, 12);
+      qr(2, 7, 8, 13);
+      qr(3, 4, 9, 14);
+      for (i = 0; i < 16; i = i + 1) out[i * 32 +: 32] = x[i];
+   end
+endmodule
@@ -0,0 +1,27 @@
+// DESCRIPTION: Verilator: Benchmark: DPI heavy design, C functions
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include "svdpi.h"
+
+#include <cstdint>
+
+extern "C" {
+int bench_dpi_hash(int id, int value);
+int bench_dpi_pure(int value);
+void bench_dpi_wide(const svBitVecVal* in, svBitVecVal* out);
+}
+
+int bench_dpi_hash(int id, int value) {
+    uint32_t h = static_cast<uint32_t>(id) * 2654435761U;
+    h ^= static_cast<uint32_t>(value) + 0x9e3779b9U + (h << 6) + (h >> 2);
+    return static_cast<int>(h);
+}
+
+int bench_dpi_pure(int value) { return value ^ (value >> 7); }
+
+void bench_dpi_wide(const svBitVecVal* in, svBitVecVal* out) {
+    for (int i = 0; i < 4; ++i) out[i] = in[(i + 1) % 4] + in[i];
+}
@@ -0,0 +1,48 @@
+// DESCRIPTION: Verilator: Benchmark: DPI heavy design
+//
+// Many instances calling DPI-C imported functions every cycle, measuring
+// the cost of crossing between the model and C. See dpi.cpp.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+import "DPI-C" function int bench_dpi_hash(input int id, input int value);
+import "DPI-C" pure function int bench_dpi_pure(input int value);
+import "DPI-C" function void bench_dpi_wide(input bit [127:0] in, output bit [127:0] out);
+
+module bench #(parameter INSTANCES = 64)
+   (input clk,
+    output reg [31:0] result);
+
+   wire [31:0] sums [0:INSTANCES-1];
+
+   genvar g;
+   generate
+      for (g = 0; g < INSTANCES; g = g + 1) begin : insts
+         dpi_user #(.ID(g)) user(.clk(clk), .sum(sums[g]));
+      end
+   endgenerate
+
+   integer i;
+   always @* begin
+      result = 0;
+      for (i = 0; i < INSTANCES; i = i + 1) result = result ^ sums[i];
+   end
+endmodule
+
+module dpi_user #(parameter ID = 0)
+   (input clk,
+    output reg [31:0] sum);
+
+   reg [127:0] wide = {4{32'(ID)}};
+   reg [127:0] wide_out;
+
+   initial sum = 0;
+
+   always @(posedge clk) begin
+      sum <= sum + bench_dpi_hash(ID, sum) + bench_dpi_pure(sum ^ ID);
+      bench_dpi_wide(wide, wide_out);
+      wide <= wide_out;
+   end
+endmodule
@@ -0,0 +1,529 @@
+// DESCRIPTION: Verilator: Benchmark: Runtime library micro-benchmarks
+//
+// Times the hot primitives of the runtime library directly, without a
+// Verilated model: wide arithmetic from verilated_funcs.h, VlQueue and
+// VlAssocArray, VlTriggerVec, $sformatf formatting, VCD trace change
+// detection, and VerilatedSave serialization.
+//
+// Each benchmark is rerun with a growing number of iterations until it takes
+// at least --min-time seconds, and reported in nanoseconds per iteration.
+// Build this file together with the runtime library sources; see
+// nodist/bench/run_micro, which builds a variant per set of CPU specific
+// compiler flags and compares them.
+//
+//   micro_bench [--filter <regexp>] [--min-time <seconds>] [--json <file>]
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+#include <verilated_vcd_c.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <regex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32) && !defined(__MINGW32__) && !defined(__CYGWIN__)
+#define BENCH_NULL_FILE "NUL"
+#else
+#define BENCH_NULL_FILE "/dev/null"
+#endif
+
+double sc_time_stamp() { return 0; }
+
+//======================================================================
+// Harness
+
+class BenchState final {
+    const uint64_t m_iters;  // Iterations to run
+    uint64_t m_count = 0;  // Iterations run so far
+    uint64_t m_items = 0;  // Items processed, for the items per second rate
+    std::chrono::steady_clock::time_point m_start;  // Start of timed region
+
+public:
+    explicit BenchState(uint64_t iters)
+        : m_iters{iters} {}
+    // Loop condition for the timed region: while (state.loop()) { ... }
+    bool loop() {
+        if (VL_UNLIKELY(m_count == 0)) m_start = std::chrono::steady_clock::now();
+        return m_count++ < m_iters;
+    }
+    void items(uint64_t n) { m_items = n; }
+    uint64_t iters() const { return m_iters; }
+    uint64_t itemCount() const { return m_items; }
+    double elapsed() const {
+        const auto delta = std::chrono::steady_clock::now() - m_start;
+        return std::chrono::duration<double>(delta).count();
+    }
+};
+
+// Prevent the compiler from optimizing away a computed value, or assuming
+// memory is unchanged across iterations
+template <class T>
+static inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* s_sinkp;
+    s_sinkp = &value;
+#endif
+}
+static inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct Benchmark final {
+    std::string m_name;  // Name, including the argument, e.g. "wide/add/128"
+    std::function<void(BenchState&)> m_func;  // Benchmark body
+};
+
+static std::vector<Benchmark>& benchmarks() {
+    static std::vector<Benchmark> s_benchmarks;
+    return s_benchmarks;
+}
+
+// Register a benchmark taking one size argument, once per argument
+static void registerBench(const std::string& name, std::function<void(BenchState&, int)> func,
+                          std::initializer_list<int> args) {
+    for (const int arg : args) {
+        benchmarks().push_back(Benchmark{name + "/" + std::to_string(arg),
+                                         [func, arg](BenchState& state) { func(state, arg); }});
+    }
+}
+
+// Pseudo-random but reproducible data
+static uint32_t benchRand() {
+    static uint32_t s_state = 0x12345678;
+    s_state ^= s_state << 13;
+    s_state ^= s_state >> 17;
+    s_state ^= s_state << 5;
+    return s_state;
+}
+static std::vector<EData> randomWords(int bits) {
+    std::vector<EData> words(VL_WORDS_I(bits));
+    for (EData& word : words) word = benchRand();
+    words.back() &= VL_MASK_E(bits);
+    return words;
+}
+
+//======================================================================
+// Wide arithmetic (verilated_funcs.h)
+
+static void benchWideAdd(BenchState& state, int bits) {
+    const int words = VL_WORDS_I(bits);
+    const std::vector<EData> lhs = randomWords(bits);
+    const std::vector<EData> rhs = randomWords(bits);
+    std::vector<EData> out(words);
+    while (state.loop()) {
+        VL_ADD_W(words, out.data(), lhs.data(), rhs.data());
+        doNotOptimize(out[0]);
+    }
+}
+
+static void benchWideMul(BenchState& state, int bits) {
+    const int words = VL_WORDS_I(bits);
+    const std::vector<EData> lhs = randomWords(bits);
+    const std::vector<EData> rhs = randomWords(bits);
+    std::vector<EData> out(words);
+    while (state.loop()) {
+        VL_MUL_W(words, out.data(), lhs.data(), rhs.data());
+        doNotOptimize(out[0]);
+    }
+}
+
+static void benchWideDiv(BenchState& state, int bits) {
+    const std::vector<EData> lhs = randomWords(bits);
+    std::vector<EData> rhs = randomWords(bits / 2);
+    rhs.resize(lhs.size(), 0);
+    std::vector<EData> out(lhs.size());
+    while (state.loop()) {
+        VL_DIV_WWW(bits, out.data(), lhs.data(), rhs.data());
+        doNotOptimize(out[0]);
+    }
+}
+
+static void benchWideShiftL(BenchState& state, int bits) {
+    const std::vector<EData> lhs = randomWords(bits);
+    std::vector<EData> out(lhs.size());
+    IData shift = 0;
+    while (state.loop()) {
+        VL_SHIFTL_WWI(bits, bits, 32, out.data(), lhs.data(), shift);
+        doNotOptimize(out[0]);
+        shift = (shift + 7) % bits;
+    }
+}
+
+static void benchWideEq(BenchState& state, int bits) {
+    const int words = VL_WORDS_I(bits);
+    const std::vector<EData> lhs = randomWords(bits);
+    const std::vector<EData> rhs = lhs;  // Equal, so all words are compared
+    while (state.loop()) {
+        doNotOptimize(VL_EQ_W(words, lhs.data(), rhs.data()));
+        clobberMemory();
+    }
+}
+
+static void benchWideRedXor(BenchState& state, int bits) {
+    const int words = VL_WORDS_I(bits);
+    const std::vector<EData> lhs = randomWords(bits);
+    while (state.loop()) {
+        doNotOptimize(VL_REDXOR_W(words, lhs.data()));
+        clobberMemory();
+    }
+}
+
+//======================================================================
+// Containers (verilated_types.h)
+
+static void benchQueuePushPop(BenchState& state, int size) {
+    VlQueue<IData> queue;
+    while (state.loop()) {
+        for (int i = 0; i < size; ++i) queue.push_back(i);
+        for (int i = 0; i < size; ++i) doNotOptimize(queue.pop_front());
+    }
+    state.items(state.iters() * size);
+}
+
+static void benchQueueAt(BenchState& state, int size) {
+    VlQueue<IData> queue;
+    for (int i = 0; i < size; ++i) queue.push_back(benchRand());
+    IData sum = 0;
+    while (state.loop()) {
+        for (int i = 0; i < size; ++i) sum += queue.at((i * 7) % size);
+        doNotOptimize(sum);
+    }
+    state.items(state.iters() * size);
+}
+
+template <bool T_Ordered>
+static void benchAssocInsert(BenchState& state, int size) {
+    std::vector<IData> keys(size);
+    for (IData& key : keys) key = benchRand();
+    while (state.loop()) {
+        VlAssocArray<IData, IData, T_Ordered> assoc;
+        for (const IData key : keys) assoc.at(key) = key;
+        doNotOptimize(assoc.size());
+    }
+    state.items(state.iters() * size);
+}
+
+template <bool T_Ordered>
+static void benchAssocLookup(BenchState& state, int size) {
+    VlAssocArray<IData, IData, T_Ordered> assoc;
+    std::vector<IData> keys(size);
+    for (IData& key : keys) {
+        key = benchRand();
+        assoc.at(key) = key;
+    }
+    while (state.loop()) {
+        for (const IData key : keys) doNotOptimize(assoc.exists(key));
+    }
+    state.items(state.iters() * size);
+}
+
+template <std::size_t T_Size>
+static void benchTriggerVec(BenchState& state, int) {
+    // The work of one scheduling iteration: compute, mask, test and merge
+    VlTriggerVec<T_Size> triggered;
+    VlTriggerVec<T_Size> pre;
+    VlTriggerVec<T_Size> executed;
+    size_t index = 0;
+    while (state.loop()) {
+        triggered.clear();
+        triggered.set(index, true);
+        triggered.set((index * 13) % T_Size, true);
+        pre.andNot(triggered, executed);
+        doNotOptimize(pre.any());
+        executed.thisOr(pre);
+        index = (index + 1) % T_Size;
+    }
+}
+
+//======================================================================
+// Formatting (_vl_vsformat)
+
+static void benchSformatfInt(BenchState& state, int) {
+    IData value = 0;
+    while (state.loop()) {
+        doNotOptimize(VL_SFORMATF_NX("a=%d b=%x c=%b", 32, value, 32, value, 8, value & 0xff));
+        ++value;
+    }
+}
+
+static void benchSformatfWide(BenchState& state, int bits) {
+    const std::vector<EData> value = randomWords(bits);
+    while (state.loop()) {
+        doNotOptimize(VL_SFORMATF_NX("%x %d", bits, value.data(), bits, value.data()));
+    }
+}
+
+static void benchSformatfString(BenchState& state, int) {
+    const std::string str{"the quick brown fox"};
+    while (state.loop()) doNotOptimize(VL_SFORMATF_NX("name %@ len %0d", -1, &str, 32, 19));
+}
+
+//======================================================================
+// Trace change detection (VerilatedTraceBuffer::chg*)
+
+// A stand in for a Verilated model with 'size' signals, all 'bits' wide,
+// of which 1 in 8 change each dump
+class BenchTraceModel final : public VerilatedModel {
+    const int m_size;  // Number of signals
+    const int m_bits;  // Width of each signal
+    std::vector<EData> m_values;  // Signal values, VL_WORDS_I(bits) each
+    uint32_t m_baseCode = 0;  // First trace code
+    uint32_t m_step = 0;  // Dump count, selects the changing signals
+
+public:
+    BenchTraceModel(VerilatedContext& context, int size, int bits)
+        : VerilatedModel{context}
+        , m_size{size}
+        , m_bits{bits}
+        , m_values(size * VL_WORDS_I(bits), 0) {}
+    const char* hierName() const override { return "bench"; }
+    const char* modelName() const override { return "BenchTraceModel"; }
+    unsigned threads() const override { return 1; }
+    std::unique_ptr<VerilatedTraceConfig> traceConfig() const override {
+        // Not parallel, no offloading, no FST writer thread
+        return std::unique_ptr<VerilatedTraceConfig>{
+            new VerilatedTraceConfig{false, false, false}};
+    }
+    void trace(VerilatedVcdC* tfp) {
+        tfp->spTrace()->addModel(this);
+        tfp->spTrace()->addInitCb(&traceInit, this);
+        tfp->spTrace()->addFullCb(&traceFull, this);
+        tfp->spTrace()->addChgCb(&traceChg, this);
+    }
+    void step() {
+        const int words = VL_WORDS_I(m_bits);
+        for (int i = m_step % 8; i < m_size; i += 8) m_values[i * words] ^= 1;
+        ++m_step;
+    }
+
+private:
+    static void traceInit(void* selfp, VerilatedVcd* tracep, uint32_t code) {
+        BenchTraceModel* const modelp = static_cast<BenchTraceModel*>(selfp);
+        modelp->m_baseCode = code;
+        const int words = VL_WORDS_I(modelp->m_bits);
+        for (int i = 0; i < modelp->m_size; ++i) {
+            const std::string name = "bench sig" + std::to_string(i);
+            tracep->declBus(code + i * words, name.c_str(), false, -1, modelp->m_bits - 1, 0);
+        }
+    }
+    template <bool T_Full>
+    static void traceDump(BenchTraceModel* modelp, VerilatedVcd::Buffer* bufp) {
+        const int words = VL_WORDS_I(modelp->m_bits);
+        uint32_t* oldp = bufp->oldp(modelp->m_baseCode);
+        const EData* valuep = modelp->m_values.data();
+        for (int i = 0; i < modelp->m_size; ++i, oldp += words, valuep += words) {
+            if (words == 1) {
+                if (T_Full) {
+                    bufp->fullIData(oldp, *valuep, modelp->m_bits);
+                } else {
+                    bufp->chgIData(oldp, *valuep, modelp->m_bits);
+                }
+            } else {
+                if (T_Full) {
+                    bufp->fullWData(oldp, valuep, modelp->m_bits);
+                } else {
+                    bufp->chgWData(oldp, valuep, modelp->m_bits);
+                }
+            }
+        }
+    }
+    static void traceFull(void* selfp, VerilatedVcd::Buffer* bufp) {
+        traceDump<true>(static_cast<BenchTraceModel*>(selfp), bufp);
+    }
+    static void traceChg(void* selfp, VerilatedVcd::Buffer* bufp) {
+        traceDump<false>(static_cast<BenchTraceModel*>(selfp), bufp);
+    }
+};
+
+static void benchTraceChg(BenchState& state, int bits) {
+    constexpr int SIGNALS = 1024;
+    VerilatedContext context;
+    context.traceEverOn(true);
+    BenchTraceModel model{context, SIGNALS, bits};
+    VerilatedVcdC tfp;
+    model.trace(&tfp);
+    tfp.open(BENCH_NULL_FILE);
+    uint64_t time = 0;
+    tfp.dump(time++);  // Full dump
+    while (state.loop()) {
+        model.step();
+        tfp.dump(time++);
+    }
+    tfp.close();
+    state.items(state.iters() * SIGNALS);
+}
+
+//======================================================================
+// Serialization (VerilatedSerialize operators)
+
+static void benchSaveScalars(BenchState& state, int size) {
+    VerilatedSave os;
+    os.open(BENCH_NULL_FILE);
+    std::vector<uint32_t> values(size);
+    for (uint32_t& value : values) value = benchRand();
+    while (state.loop()) {
+        for (const uint32_t& value : values) os << value;
+    }
+    os.close();
+    state.items(state.iters() * size);
+}
+
+static void benchSaveWide(BenchState& state, int size) {
+    VerilatedSave os;
+    os.open(BENCH_NULL_FILE);
+    std::vector<VlWide<16>> values(size);
+    for (VlWide<16>& value : values) {
+        for (int i = 0; i < 16; ++i) value[i] = benchRand();
+    }
+    while (state.loop()) {
+        for (const VlWide<16>& value : values) os << value;
+    }
+    os.close();
+    state.items(state.iters() * size);
+}
+
+static void benchSaveAssoc(BenchState& state, int size) {
+    VerilatedSave os;
+    os.open(BENCH_NULL_FILE);
+    VlAssocArray<IData, QData> assoc;
+    for (int i = 0; i < size; ++i) assoc.at(benchRand()) = benchRand();
+    while (state.loop()) os << assoc;
+    os.close();
+    state.items(state.iters() * size);
+}
+
+//======================================================================
+
+static void registerAll() {
+    registerBench("wide/add", benchWideAdd, {128, 512, 4096});
+    registerBench("wide/mul", benchWideMul, {128, 512, 4096});
+    registerBench("wide/div", benchWideDiv, {128, 512});
+    registerBench("wide/shiftl", benchWideShiftL, {128, 512, 4096});
+    registerBench("wide/eq", benchWideEq, {128, 512, 4096});
+    registerBench("wide/redxor", benchWideRedXor, {128, 512, 4096});
+    registerBench("queue/push_pop", benchQueuePushPop, {16, 1024});
+    registerBench("queue/at", benchQueueAt, {16, 1024});
+    registerBench("assoc/insert", benchAssocInsert<true>, {16, 1024});
+    registerBench("assoc/lookup", benchAssocLookup<true>, {16, 1024});
+    registerBench("assoc_unordered/insert", benchAssocInsert<false>, {16, 1024});
+    registerBench("assoc_unordered/lookup", benchAssocLookup<false>, {16, 1024});
+    registerBench("trigger/iterate", benchTriggerVec<64>, {64});
+    registerBench("trigger/iterate", benchTriggerVec<512>, {512});
+    registerBench("trigger/iterate", benchTriggerVec<4096>, {4096});
+    registerBench("sformatf/int", benchSformatfInt, {32});
+    registerBench("sformatf/wide", benchSformatfWide, {128, 1024});
+    registerBench("sformatf/string", benchSformatfString, {0});
+    registerBench("trace/chg", benchTraceChg, {1, 32, 128});
+    registerBench("save/scalars", benchSaveScalars, {1024});
+    registerBench("save/wide", benchSaveWide, {1024});
+    registerBench("save/assoc", benchSaveAssoc, {1024});
+}
+
+// Describe the compiler and the instruction set extensions it was told to use
+static std::string buildInfo() {
+    std::string info;
+#if defined(__clang__)
+    info += "clang " __clang_version__;
+#elif defined(__GNUC__)
+    info += "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    info += "msvc " + std::to_string(_MSC_VER);
+#else
+    info += "unknown compiler";
+#endif
+#ifdef __SSE4_2__
+    info += " sse4.2";
+#endif
+#ifdef __AVX2__
+    info += " avx2";
+#endif
+#ifdef __BMI2__
+    info += " bmi2";
+#endif
+#ifdef __AVX512F__
+    info += " avx512f";
+#endif
+#ifdef __ARM_NEON
+    info += " neon";
+#endif
+#ifdef __ARM_FEATURE_SVE
+    info += " sve";
+#endif
+    return info;
+}
+
+int main(int argc, char** argv) {
+    std::string filter = ".*";
+    double minTime = 0.2;
+    std::string jsonFilename;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTime = std::atof(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonFilename = argv[++i];
+        } else {
+            std::fprintf(stderr,
+                         "Usage: %s [--filter <regexp>] [--min-time <seconds>]"
+                         " [--json <file>]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    registerAll();
+    const std::regex filterRe{filter};
+
+    std::printf("Build: %s\n", buildInfo().c_str());
+    std::printf("%-32s %14s %12s %14s\n", "Benchmark", "ns/iter", "Iterations", "Items/s");
+    std::ofstream json;
+    if (!jsonFilename.empty()) {
+        json.open(jsonFilename);
+        json << "{\n  \"build\": \"" << buildInfo() << "\",\n  \"benchmarks\": [";
+    }
+    const char* sep = "\n";
+    for (const Benchmark& bench : benchmarks()) {
+        if (!std::regex_search(bench.m_name, filterRe)) continue;
+        uint64_t iters = 1;
+        double elapsed = 0;
+        uint64_t items = 0;
+        while (true) {
+            BenchState state{iters};
+            bench.m_func(state);
+            elapsed = state.elapsed();
+            items = state.itemCount();
+            if (elapsed >= minTime || iters >= (1ULL << 40)) break;
+            // Aim a little over the minimum time, but grow at most 10x
+            const double scale = elapsed > 0 ? (minTime * 1.2) / elapsed : 10;
+            iters = static_cast<uint64_t>(iters * std::min(10.0, std::max(2.0, scale)));
+        }
+        const double nsPerIter = elapsed * 1e9 / iters;
+        const double itemsPerSec = items ? items / elapsed : 0;
+        std::printf("%-32s %14.2f %12" PRIu64, bench.m_name.c_str(), nsPerIter, iters);
+        if (items) std::printf(" %14.4g", itemsPerSec);
+        std::printf("\n");
+        std::fflush(stdout);
+        if (json.is_open()) {
+            json << sep << "    {\"name\": \"" << bench.m_name << "\", \"ns_per_iter\": "
+                 << nsPerIter << ", \"iterations\": " << iters
+                 << ", \"items_per_second\": " << itemsPerSec << "}";
+            sep = ",\n";
+        }
+    }
+    if (json.is_open()) json << "\n  ]\n}\n";
+    return 0;
+}
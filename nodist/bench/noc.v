@@ -0,0 +1,123 @@
+// DESCRIPTION: Verilator: Benchmark: Network on chip
+//
+// A torus of deflection routers, each injecting packets to pseudo-random
+// destinations, and counting the packets delivered to it.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module bench #(parameter N = 8)  // Routers per side, power of 2, at most 16
+   (input clk,
+    output reg [31:0] result);
+
+   localparam PW = 41;  // Packet: valid, dest x, dest y, payload
+
+   // Link leaving router (x, y) in each direction, indexed by x + y * N
+   wire [PW-1:0] to_n [0:N*N-1];
+   wire [PW-1:0] to_s [0:N*N-1];
+   wire [PW-1:0] to_e [0:N*N-1];
+   wire [PW-1:0] to_w [0:N*N-1];
+   wire [31:0] sums [0:N*N-1];
+
+   genvar x, y;
+   generate
+      for (y = 0; y < N; y = y + 1) begin : rows
+         for (x = 0; x < N; x = x + 1) begin : cols
+            noc_router #(.N(N), .PW(PW), .X(x), .Y(y))
+            router(.clk(clk),
+                   // Arriving from the neighbor on each side
+                   .in_n(to_s[x + ((y + 1) % N) * N]),
+                   .in_s(to_n[x + ((y + N - 1) % N) * N]),
+                   .in_e(to_w[((x + 1) % N) + y * N]),
+                   .in_w(to_e[((x + N - 1) % N) + y * N]),
+                   .out_n(to_n[x + y * N]),
+                   .out_s(to_s[x + y * N]),
+                   .out_e(to_e[x + y * N]),
+                   .out_w(to_w[x + y * N]),
+                   .sum(sums[x + y * N]));
+         end
+      end
+   endgenerate
+
+   integer i;
+   always @* begin
+      result = 0;
+      for (i = 0; i < N * N; i = i + 1) result = result ^ sums[i];
+   end
+endmodule
+
+module noc_router #(parameter N = 8, PW = 41, X = 0, Y = 0)
+   (input clk,
+    input [PW-1:0] in_n,
+    input [PW-1:0] in_s,
+    input [PW-1:0] in_e,
+    input [PW-1:0] in_w,
+    output reg [PW-1:0] out_n,
+    output reg [PW-1:0] out_s,
+    output reg [PW-1:0] out_e,
+    output reg [PW-1:0] out_w,
+    output reg [31:0] sum);
+
+   // Ports are indexed 0 = north, 1 = south, 2 = east, 3 = west
+   reg [3:0][PW-1:0] in_pkts;
+   reg [3:0][PW-1:0] out_pkts;
+   reg [3:0] taken;
+   reg ejected;
+   reg [31:0] eject_payload;
+   reg [31:0] lfsr = 32'h1 + X + Y * N;
+   integer i, port, p;
+
+   // Output port towards the packet's destination, preferring x first
+   function integer productive(input [PW-1:0] pkt);
+      reg [3:0] dx, dy;
+      begin
+         dx = pkt[PW-2:PW-5];
+         dy = pkt[PW-6:PW-9];
+         if (dx != X) productive = ((dx - X) & (N - 1)) < N / 2 ? 2 : 3;
+         else productive = ((dy - Y) & (N - 1)) < N / 2 ? 0 : 1;
+      end
+   endfunction
+
+   always @* begin
+      in_pkts[0] = in_n;
+      in_pkts[1] = in_s;
+      in_pkts[2] = in_e;
+      in_pkts[3] = in_w;
+      out_pkts = 0;
+      taken = 0;
+      ejected = 0;
+      eject_payload = 0;
+      for (i = 0; i < 4; i = i + 1) begin
+         if (in_pkts[i][PW-1]) begin
+            if (!ejected && in_pkts[i][PW-2:PW-5] == X && in_pkts[i][PW-6:PW-9] == Y) begin
+               ejected = 1;
+               eject_payload = in_pkts[i][31:0];
+            end else begin
+               port = productive(in_pkts[i]);
+               // Deflect to the first free port if the productive one is taken
+               if (taken[port]) begin
+                  for (p = 3; p >= 0; p = p - 1) if (!taken[p]) port = p;
+               end
+               out_pkts[port] = in_pkts[i];
+               taken[port] = 1;
+            end
+         end
+      end
+      // Inject a new packet when a port is free
+      if (!(&taken)) begin
+         port = 0;
+         for (p = 3; p >= 0; p = p - 1) if (!taken[p]) port = p;
+         out_pkts[port] = {1'b1, lfsr[7:4] & 4'(N - 1), lfsr[11:8] & 4'(N - 1), lfsr};
+      end
+   end
+
+   always @(posedge clk) begin
+      out_n <= out_pkts[0];
+      out_s <= out_pkts[1];
+      out_e <= out_pkts[2];
+      out_w <= out_pkts[3];
+      lfsr <= {lfsr[30:0], lfsr[31] ^ lfsr[21] ^ lfsr[1] ^ lfsr[0]};
+      if (ejected) sum <= {sum[30:0], sum[31]} ^ eject_payload;
+   end
+endmodule
@@ -0,0 +1,131 @@
+// DESCRIPTION: Verilator: Benchmark: RISC-V cores
+//
+// Several single-cycle RV32I subset cores, each running a small program
+// with arithmetic, loads/stores, and branches out of its own memories.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module bench #(parameter CORES = 4)
+   (input clk,
+    output reg [31:0] result);
+
+   wire [31:0] results [0:CORES-1];
+
+   genvar g;
+   generate
+      for (g = 0; g < CORES; g = g + 1) begin : cores
+         riscv_core #(.ID(g)) core(.clk(clk), .result(results[g]));
+      end
+   endgenerate
+
+   integer i;
+   always @* begin
+      result = 0;
+      for (i = 0; i < CORES; i = i + 1) result = result ^ results[i];
+   end
+endmodule
+
+module riscv_core #(parameter ID = 0)
+   (input clk,
+    output [31:0] result);
+
+   reg [31:0] imem [0:31];
+   reg [31:0] dmem [0:255];
+   reg [31:0] regs [0:31];
+   reg [31:0] pc;
+
+   integer i;
+   initial begin
+      pc = 0;
+      for (i = 0; i < 32; i = i + 1) begin
+         imem[i] = 32'h00000013;  // nop
+         regs[i] = 0;
+      end
+      for (i = 0; i < 256; i = i + 1) dmem[i] = 0;
+      imem[0] = 32'h00000093;  // addi x1, x0, 0
+      imem[1] = 32'h00100113;  // addi x2, x0, 1
+      imem[2] = 32'h00100193;  // addi x3, x0, 1
+      imem[3] = 32'h06400293 + (ID << 20);  // addi x5, x0, 100 + ID
+      imem[4] = 32'h00310233;  // add x4, x2, x3
+      imem[5] = 32'h00018113;  // addi x2, x3, 0
+      imem[6] = 32'h00020193;  // addi x3, x4, 0
+      imem[7] = 32'h00209313;  // slli x6, x1, 2
+      imem[8] = 32'h00432023;  // sw x4, 0(x6)
+      imem[9] = 32'h00032383;  // lw x7, 0(x6)
+      imem[10] = 32'h00744433;  // xor x8, x8, x7
+      imem[11] = 32'h401404b3;  // sub x9, x8, x1
+      imem[12] = 32'h4034d493;  // srai x9, x9, 3
+      imem[13] = 32'h00946433;  // or x8, x8, x9
+      imem[14] = 32'h00108093;  // addi x1, x1, 1
+      imem[15] = 32'hfc50cae3;  // blt x1, x5, -44
+      imem[16] = 32'hfc1ff06f;  // jal x0, -64
+   end
+
+   wire [31:0] inst = imem[pc[6:2]];
+   wire [6:0] opcode = inst[6:0];
+   wire [4:0] rd = inst[11:7];
+   wire [2:0] funct3 = inst[14:12];
+   wire [4:0] rs1 = inst[19:15];
+   wire [4:0] rs2 = inst[24:20];
+   wire [31:0] imm_i = {{20{inst[31]}}, inst[31:20]};
+   wire [31:0] imm_s = {{20{inst[31]}}, inst[31:25], inst[11:7]};
+   wire [31:0] imm_b = {{19{inst[31]}}, inst[31], inst[7], inst[30:25], inst[11:8], 1'b0};
+   wire [31:0] imm_u = {inst[31:12], 12'b0};
+   wire [31:0] imm_j = {{11{inst[31]}}, inst[31], inst[19:12], inst[20], inst[30:21], 1'b0};
+   wire [31:0] a = regs[rs1];
+   wire [31:0] b = regs[rs2];
+
+   function [31:0] alu(input [2:0] f3, input alt, input [31:0] x, input [31:0] y);
+      case (f3)
+        3'b000: alu = alt ? x - y : x + y;
+        3'b001: alu = x << y[4:0];
+        3'b010: alu = {31'b0, $signed(x) < $signed(y)};
+        3'b011: alu = {31'b0, x < y};
+        3'b100: alu = x ^ y;
+        3'b101: alu = alt ? $signed(x) >>> y[4:0] : x >> y[4:0];
+        3'b110: alu = x | y;
+        default: alu = x & y;
+      endcase
+   endfunction
+
+   reg taken;
+   always @* begin
+      case (funct3)
+        3'b000: taken = a == b;
+        3'b001: taken = a != b;
+        3'b100: taken = $signed(a) < $signed(b);
+        3'b101: taken = $signed(a) >= $signed(b);
+        3'b110: taken = a < b;
+        default: taken = a >= b;
+      endcase
+   end
+
+   reg [31:0] wdata;
+   reg wen;
+   always @* begin
+      wen = rd != 0;
+      case (opcode)
+        7'b0110011: wdata = alu(funct3, inst[30], a, b);
+        7'b0010011: wdata = alu(funct3, funct3 == 3'b101 && inst[30], a, imm_i);
+        7'b0000011: wdata = dmem[(a + imm_i) >> 2 & 255];
+        7'b0110111: wdata = imm_u;
+        7'b1101111: wdata = pc + 4;
+        default: begin
+           wdata = 0;
+           wen = 0;
+        end
+      endcase
+   end
+
+   always @(posedge clk) begin
+      if (wen) regs[rd] <= wdata;
+      if (opcode == 7'b0100011) dmem[(a + imm_s) >> 2 & 255] <= b;
+      if (opcode == 7'b1100011 && taken) pc <= pc + imm_b;
+      else if (opcode == 7'b1101111) pc <= pc + imm_j;
+      else pc <= pc + 4;
+   end
+
+   assign result = regs[8];
+endmodule
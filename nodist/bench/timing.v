@@ -0,0 +1,68 @@
+// DESCRIPTION: Verilator: Benchmark: Timing heavy testbench
+//
+// Many behavioral processes using delays, events, and fork/join, as a
+// testbench would. Requires --timing. The clock is generated internally,
+// so the harness only advances time.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+`timescale 1ns/1ns
+
+module bench #(parameter AGENTS = 32)
+   (input clk,  // Unused, the clock is generated with delays
+    output reg [31:0] result);
+
+   reg tclk = 0;
+   always #5 tclk = ~tclk;
+
+   wire [31:0] sums [0:AGENTS-1];
+
+   genvar g;
+   generate
+      for (g = 0; g < AGENTS; g = g + 1) begin : agents
+         timing_agent #(.ID(g)) agent(.clk(tclk), .sum(sums[g]));
+      end
+   endgenerate
+
+   integer i;
+   always @* begin
+      result = 0;
+      for (i = 0; i < AGENTS; i = i + 1) result = result ^ sums[i];
+   end
+endmodule
+
+module timing_agent #(parameter ID = 0)
+   (input clk,
+    output reg [31:0] sum);
+
+   event req;
+   event ack;
+   reg [31:0] data = ID;
+
+   initial sum = 0;
+
+   // Driver: issue a request with a variable delay after each clock
+   initial forever begin
+      @(posedge clk);
+      #(1 + data[1:0] % 3);
+      data = data * 1103515245 + 12345;
+      ->req;
+      @ack;
+   end
+
+   // Responder: process each request with parallel sub-tasks
+   initial forever begin
+      @req;
+      fork
+         #1 sum = sum + data;
+         #2 sum = {sum[30:0], sum[31]};
+         begin
+            @(negedge clk);
+            sum = sum ^ ID;
+         end
+      join
+      ->ack;
+   end
+endmodule
@@ -21,8 +21,12 @@
 
 #include "V3Ast.h"
 #include "V3Global.h"
+#include "V3Hasher.h"
 #include "V3Stats.h"
 
+#include <unordered_map>
+#include <vector>
+
 VL_DEFINE_DEBUG_FUNCTIONS;
 
 //######################################################################
@@ -35,8 +39,21 @@ private:
     //  AstNode::user()         -> bool.  True if processed
     const VNUser1InUse m_inuser1;
 
+    // TYPES
+    // History registers of a $past expression, shared by each $past of it on the same clock
+    struct PastHistory final {
+        AstNodeExpr* m_exprp;  // Expression, for comparison (unlinked)
+        AstSenTree* m_sentreep;  // Clock, for comparison (unlinked copy)
+        AstAlways* m_alwaysp;  // Process shifting the history
+        std::vector<AstVar*> m_varps;  // History registers, most recent first
+        unsigned m_num;  // Number for register names
+        bool m_shared;  // Expression is pure, so history may be shared
+    };
+    using PastHistories = std::unordered_map<V3Hash, std::vector<PastHistory>>;
+
     // STATE
     AstNodeModule* m_modp = nullptr;  // Last module
+    PastHistories* m_pastHistoriesp = nullptr;  // $past histories in current module
     const AstBegin* m_beginp = nullptr;  // Last begin
     unsigned m_monitorNum = 0;  // Global $monitor numbering (not per module)
     AstVar* m_monitorNumVarp = nullptr;  // $monitor number variable
@@ -48,6 +65,7 @@ private:
     VDouble0 m_statAsNotImm;  // Statistic tracking
     VDouble0 m_statAsImm;  // Statistic tracking
     VDouble0 m_statAsFull;  // Statistic tracking
+    VDouble0 m_statPastShared;  // Statistic tracking
     bool m_inSampled = false;  // True inside a sampled expression
 
     // METHODS
@@ -352,6 +370,29 @@ private:
     }
 
     //========== Past
+    // Find history of 'exprp' on 'sentreep', or make a new one, taking ownership of both
+    PastHistory& pastHistory(AstNodeExpr* exprp, AstSenTree* sentreep) {
+        std::vector<PastHistory>& histories = (*m_pastHistoriesp)[V3Hasher::uncachedHash(exprp)];
+        const bool shared = exprp->isPure();
+        if (shared) {
+            for (PastHistory& history : histories) {
+                if (history.m_shared && history.m_exprp->dtypep() == exprp->dtypep()
+                    && history.m_exprp->sameTree(exprp)
+                    && history.m_sentreep->sameTree(sentreep)) {
+                    VL_DO_DANGLING(pushDeletep(exprp), exprp);
+                    VL_DO_DANGLING(pushDeletep(sentreep), sentreep);
+                    ++m_statPastShared;
+                    return history;
+                }
+            }
+        }
+        AstAlways* const alwaysp
+            = new AstAlways{exprp->fileline(), VAlwaysKwd::ALWAYS, sentreep, nullptr};
+        m_modp->addStmtsp(alwaysp);
+        histories.push_back(
+            {exprp, sentreep->cloneTree(false), alwaysp, {}, m_modPastNum++, shared});
+        return histories.back();
+    }
     void visit(AstPast* nodep) override {
         iterateChildren(nodep);
         uint32_t ticks = 1;
@@ -362,25 +403,28 @@ private:
         }
         UASSERT_OBJ(ticks >= 1, nodep, "0 tick should have been checked in V3Width");
         AstNodeExpr* const exprp = nodep->exprp()->unlinkFrBack();
-        AstNodeExpr* inp = newSampledExpr(exprp);
-        AstVar* invarp = nullptr;
         AstSenTree* const sentreep = nodep->sentreep()->unlinkFrBack();
-        AstAlways* const alwaysp
-            = new AstAlways{nodep->fileline(), VAlwaysKwd::ALWAYS, sentreep, nullptr};
-        m_modp->addStmtsp(alwaysp);
-        for (uint32_t i = 0; i < ticks; ++i) {
+        PastHistory& history = pastHistory(exprp, sentreep);
+        // Extend history with more registers if needed
+        for (uint32_t i = history.m_varps.size(); i < ticks; ++i) {
+            FileLine* const flp = history.m_alwaysp->fileline();
+            AstNodeExpr* inp;
+            if (i == 0) {
+                inp = newSampledExpr(history.m_exprp->cloneTree(false));
+            } else {
+                inp = new AstVarRef{flp, history.m_varps.back(), VAccess::READ};
+            }
             AstVar* const outvarp = new AstVar{
-                nodep->fileline(), VVarType::MODULETEMP,
-                "_Vpast_" + cvtToStr(m_modPastNum++) + "_" + cvtToStr(i), inp->dtypep()};
+                flp, VVarType::MODULETEMP,
+                "_Vpast_" + cvtToStr(history.m_num) + "_" + cvtToStr(i), inp->dtypep()};
             m_modp->addStmtsp(outvarp);
-            AstNode* const assp = new AstAssignDly{
-                nodep->fileline(), new AstVarRef{nodep->fileline(), outvarp, VAccess::WRITE}, inp};
-            alwaysp->addStmtsp(assp);
-            // if (debug() >= 9) assp->dumpTree("-  ass: ");
-            invarp = outvarp;
-            inp = new AstVarRef{nodep->fileline(), invarp, VAccess::READ};
+            AstNode* const assp
+                = new AstAssignDly{flp, new AstVarRef{flp, outvarp, VAccess::WRITE}, inp};
+            history.m_alwaysp->addStmtsp(assp);
+            history.m_varps.push_back(outvarp);
         }
-        nodep->replaceWith(inp);
+        nodep->replaceWith(
+            new AstVarRef{nodep->fileline(), history.m_varps[ticks - 1], VAccess::READ});
         VL_DO_DANGLING(pushDeletep(nodep), nodep);
     }
 
@@ -503,11 +547,20 @@ private:
         VL_RESTORER(m_modp);
         VL_RESTORER(m_modPastNum);
         VL_RESTORER(m_modStrobeNum);
+        VL_RESTORER(m_pastHistoriesp);
         {
             m_modp = nodep;
             m_modPastNum = 0;
             m_modStrobeNum = 0;
+            PastHistories pastHistories;
+            m_pastHistoriesp = &pastHistories;
             iterateChildren(nodep);
+            for (const auto& pair : pastHistories) {
+                for (const PastHistory& history : pair.second) {
+                    pushDeletep(history.m_exprp);
+                    pushDeletep(history.m_sentreep);
+                }
+            }
         }
     }
     void visit(AstNodeProcedure* nodep) override {
@@ -535,6 +588,7 @@ public:
         V3Stats::addStat("Assertions, assert immediate statements", m_statAsImm);
         V3Stats::addStat("Assertions, cover statements", m_statCover);
         V3Stats::addStat("Assertions, full/parallel case", m_statAsFull);
+        V3Stats::addStat("Assertions, $past histories shared", m_statPastShared);
     }
 };
 
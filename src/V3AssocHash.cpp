@@ -0,0 +1,163 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Hash associative arrays never iterated in order
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+// ASSOCHASH TRANSFORMATIONS:
+//      For each expression of associative array type
+//          If it is only indexed, or used with exists/delete/num/size,
+//          or copied, the array need not keep its keys in order
+//          Otherwise (first/next/last/prev, find, reductions, or any
+//          other use) mark the C++ type of the array as ordered
+//      For each public variable
+//          Mark its associative array types as ordered, as user code
+//          may access it
+//      For each associative array type with integral or string keys
+//          If its C++ type was never marked ordered, emit a hash table
+//
+//      Decisions are by C++ type, not by data type node, so arrays of
+//      different, but equivalent, types can still be assigned or passed
+//      to each other.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3AssocHash.h"
+
+#include "V3Ast.h"
+#include "V3Global.h"
+#include "V3Stats.h"
+
+#include <unordered_set>
+#include <vector>
+
+VL_DEFINE_DEBUG_FUNCTIONS;
+
+//######################################################################
+// Visitor that marks ordered types, then hashes the remaining
+
+class AssocHashVisitor final : public VNVisitorConst {
+    // STATE
+    std::vector<AstAssocArrayDType*> m_dtypesp;  // All associative array types
+    std::unordered_set<std::string> m_ordered;  // C++ types that must stay ordered
+    VDouble0 m_statHashed;  // Statistic tracking, C++ types hashed
+
+    // METHODS
+    static std::string cTypeName(const AstNodeDType* dtypep) {
+        return dtypep->cType("", false, false);
+    }
+    static bool hashableKey(const AstAssocArrayDType* dtypep) {
+        const AstBasicDType* const basicp = dtypep->keyDTypep()->skipRefp()->basicp();
+        if (!basicp) return false;  // E.g. class handles, unpacked structs
+        if (basicp->isString()) return true;
+        return !basicp->isDouble() && !basicp->isOpaque() && basicp->widthMin() <= 64;
+    }
+    static bool orderFreeMethod(const string& name) {
+        return name == "at" || name == "exists" || name == "erase" || name == "clear"
+               || name == "size";
+    }
+    void markOrdered(const AstNodeDType* dtypep) {
+        dtypep = dtypep->skipRefp();
+        if (const AstAssocArrayDType* const adtypep = VN_CAST(dtypep, AssocArrayDType)) {
+            if (!m_ordered.insert(cTypeName(adtypep)).second) return;  // Already marked
+            UINFO(9, "  ordered " << adtypep << endl);
+            markOrdered(adtypep->subDTypep());
+        } else if (const AstNodeUOrStructDType* const sdtypep
+                   = VN_CAST(dtypep, NodeUOrStructDType)) {
+            for (const AstMemberDType* itemp = sdtypep->membersp(); itemp;
+                 itemp = VN_AS(itemp->nextp(), MemberDType)) {
+                markOrdered(itemp->subDTypep());
+            }
+        } else if (VN_IS(dtypep, ClassRefDType)) {
+            // Members are variables of their own, with their own uses
+        } else if (const AstNodeDType* const subp = dtypep->subDTypep()) {
+            if (subp != dtypep) markOrdered(subp);
+        }
+    }
+    // Return true if the given use of an associative array through childp
+    // does not depend on the order of its keys
+    static bool orderFreeUse(const AstNode* parentp, const AstNode* childp) {
+        if (const AstCMethodHard* const cmethodp = VN_CAST(parentp, CMethodHard)) {
+            return cmethodp->fromp() != childp || orderFreeMethod(cmethodp->name());
+        }
+        if (const AstAssocSel* const selp = VN_CAST(parentp, AssocSel)) {
+            return selp->fromp() == childp;
+        }
+        // Note $writemem and %p print in key order even when hashed, but
+        // printing is left ordered, as sorting on each print costs more
+        return VN_IS(parentp, NodeAssign) || VN_IS(parentp, NodeCCall) || VN_IS(parentp, CNew)
+               || VN_IS(parentp, CReturn) || VN_IS(parentp, NodeCond) || VN_IS(parentp, Eq)
+               || VN_IS(parentp, Neq) || VN_IS(parentp, EqCase) || VN_IS(parentp, NeqCase)
+               || VN_IS(parentp, SetAssoc) || VN_IS(parentp, ReadMem);
+    }
+
+    // VISITORS
+    void visit(AstAssocArrayDType* nodep) override {
+        m_dtypesp.push_back(nodep);
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstVar* nodep) override {
+        if (nodep->isSigPublic()) markOrdered(nodep->dtypep());
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNodeExpr* nodep) override {
+        if (nodep->dtypep() && VN_IS(nodep->dtypep()->skipRefp(), AssocArrayDType)) {
+            // Find the parent, stepping back over earlier list elements
+            const AstNode* childp = nodep;
+            while (childp->backp()->nextp() == childp) childp = childp->backp();
+            const AstNode* const parentp = childp->backp();
+            if (!orderFreeUse(parentp, childp)) {
+                UINFO(9, "  ordered use " << nodep << " under " << parentp << endl);
+                markOrdered(nodep->dtypep());
+            }
+        }
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNode* nodep) override { iterateChildrenConst(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit AssocHashVisitor(AstNetlist* nodep) {
+        iterateConst(nodep);
+        // Compute all names before changing any type, so each name matches
+        // the one used when marking
+        std::vector<AstAssocArrayDType*> hashp;
+        std::unordered_set<std::string> hashedNames;
+        for (AstAssocArrayDType* const dtypep : m_dtypesp) {
+            const std::string name = cTypeName(dtypep);
+            if (hashableKey(dtypep) && !m_ordered.count(name)) {
+                hashp.push_back(dtypep);
+                hashedNames.insert(name);
+            }
+        }
+        for (AstAssocArrayDType* const dtypep : hashp) {
+            UINFO(4, "  hashed " << dtypep << endl);
+            dtypep->hashed(true);
+        }
+        m_statHashed += hashedNames.size();
+    }
+    ~AssocHashVisitor() override {
+        V3Stats::addStat("Optimizations, Assoc array types hashed", m_statHashed);
+    }
+};
+
+//######################################################################
+// AssocHash class functions
+
+void V3AssocHash::assocHashAll(AstNetlist* nodep) {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    { AssocHashVisitor{nodep}; }  // Destruct before checking
+    V3Global::dumpCheckGlobalTree("assochash", 0, dumpTreeLevel() >= 3);
+}
@@ -24,6 +24,7 @@
 #include "V3File.h"
 #include "V3Global.h"
 #include "V3String.h"
+#include "V3ThreadPool.h"
 
 #include <iomanip>
 #include <memory>
@@ -34,12 +35,13 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 // Statics
 
 uint64_t AstNode::s_editCntLast = 0;
-uint64_t AstNode::s_editCntGbl = 0;  // Hot cache line
+thread_local uint64_t AstNode::s_editCntGbl = 0;  // Hot cache line
 
 // To allow for fast clearing of all user pointers, we keep a "timestamp"
 // along with each userp, and thus by bumping this count we can make it look
 // as if we iterated across the entire tree to set all the userp's to null.
-int AstNode::s_cloneCntGbl = 0;
+thread_local int AstNode::s_cloneCntGbl = 0;
+std::atomic<int> AstNode::s_cloneCntNext{0};
 uint32_t VNUser1InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
 uint32_t VNUser2InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
 uint32_t VNUser3InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
@@ -52,7 +54,7 @@ bool VNUser3InUse::s_userBusy = false;
 bool VNUser4InUse::s_userBusy = false;
 bool VNUser5InUse::s_userBusy = false;
 
-int AstNodeDType::s_uniqueNum = 0;
+std::atomic<int> AstNodeDType::s_uniqueNum{0};
 
 //######################################################################
 // V3AstType
@@ -907,6 +909,47 @@ void AstNode::operator delete(void* objp, size_t size) {
 }
 #endif
 
+void AstNode::foreachModuleParallel(AstNetlist* netlistp,
+                                    const std::function<void(AstNodeModule*)>& f) {
+    std::list<std::future<uint64_t>> futures;
+    for (AstNode* nodep = netlistp->modulesp(); nodep; nodep = nodep->nextp()) {
+        AstNodeModule* const modp = VN_AS(nodep, NodeModule);
+        futures.push_back(V3ThreadPool::s().enqueue<uint64_t>([modp, &f]() {
+            // Edit counts are per thread; report this job's edits back to the caller.
+            // The job may run synchronously on this thread, so restore the count after.
+            const uint64_t savedEditCnt = s_editCntGbl;
+            f(modp);
+            const uint64_t edits = s_editCntGbl - savedEditCnt;
+            s_editCntGbl = savedEditCnt;
+            return edits;
+        }));
+    }
+    for (const uint64_t edits : V3ThreadPool::waitForFutures(futures)) s_editCntGbl += edits;
+}
+
+void AstNode::foreachIndexParallel(size_t size, const std::function<void(size_t)>& f) {
+    const size_t jobs = static_cast<size_t>(std::max(v3Global.opt.verilateJobs(), 1));
+    if (jobs == 1 || size < 2) {
+        for (size_t i = 0; i < size; ++i) f(i);
+        return;
+    }
+    // A few chunks per job, so uneven chunks still balance
+    const size_t chunkSize = std::max<size_t>((size + jobs * 4 - 1) / (jobs * 4), 1);
+    std::list<std::future<uint64_t>> futures;
+    for (size_t begin = 0; begin < size; begin += chunkSize) {
+        const size_t end = std::min(begin + chunkSize, size);
+        futures.push_back(V3ThreadPool::s().enqueue<uint64_t>([begin, end, &f]() {
+            // As in foreachModuleParallel
+            const uint64_t savedEditCnt = s_editCntGbl;
+            for (size_t i = begin; i < end; ++i) f(i);
+            const uint64_t edits = s_editCntGbl - savedEditCnt;
+            s_editCntGbl = savedEditCnt;
+            return edits;
+        }));
+    }
+    for (const uint64_t edits : V3ThreadPool::waitForFutures(futures)) s_editCntGbl += edits;
+}
+
 //======================================================================
 // Iterators
 
@@ -25,11 +25,13 @@
 #include "V3FileLine.h"
 #include "V3FunctionTraits.h"
 #include "V3Global.h"
+#include "V3NodeAlloc.h"
 #include "V3Number.h"
 #include "V3StdFuture.h"
 
 #include "V3Ast__gen_forward_class_decls.h"  // From ./astgen
 
+#include <atomic>
 #include <cmath>
 #include <functional>
 #include <map>
@@ -1527,11 +1529,12 @@ class AstNode VL_NOT_FINAL {
     // In the release build we will take the space saving instead.
     uint64_t m_editCount;  // When it was last edited
 #endif
-    static uint64_t s_editCntGbl;  // Global edit counter
+    static thread_local uint64_t s_editCntGbl;  // Global edit counter, per thread
     static uint64_t s_editCntLast;  // Last committed value of global edit counter
 
     AstNode* m_clonep = nullptr;  // Pointer to clone/source of node (only for *LAST* cloneTree())
-    static int s_cloneCntGbl;  // Count of which userp is set
+    static thread_local int s_cloneCntGbl;  // Count of which userp is set, per thread
+    static std::atomic<int> s_cloneCntNext;  // Next s_cloneCntGbl value, unique across threads
 
     // This member ordering both allows 64 bit alignment and puts associated data together
     VNUser m_user1u{0};  // Contains any information the user iteration routine wants
@@ -1614,7 +1617,7 @@ protected:
         m_cloneCnt = s_cloneCntGbl;
     }
     static void cloneClearTree() {
-        s_cloneCntGbl++;
+        s_cloneCntGbl = ++s_cloneCntNext;
         UASSERT_STATIC(s_cloneCntGbl, "Rollover");
     }
 
@@ -1658,6 +1661,9 @@ public:
 #ifdef VL_LEAK_CHECKS
     static void* operator new(size_t size);
     static void operator delete(void* obj, size_t size);
+#else
+    static void* operator new(size_t size) { return V3NodeAlloc::allocate(size); }
+    static void operator delete(void* objp, size_t size) { V3NodeAlloc::deallocate(objp, size); }
 #endif
 
     // CONSTANTS
@@ -1815,6 +1821,15 @@ public:
     static uint64_t editCountGbl() VL_MT_SAFE { return s_editCntGbl; }
     static void editCountSetLast() { s_editCntLast = editCountGbl(); }
 
+    // Call 'f' on each module of the netlist, using V3ThreadPool when --verilate-jobs > 1.
+    // 'f' must only edit nodes under the module it is passed. Any VNUser*InUse must be
+    // allocated by the caller, which also merges per-module results after this returns.
+    static void foreachModuleParallel(AstNetlist* netlistp,
+                                      const std::function<void(AstNodeModule*)>& f);
+    // Call 'f' on each index in [0, size), in parallel chunks when --verilate-jobs > 1.
+    // 'f' must only edit nodes that no other index's call touches.
+    static void foreachIndexParallel(size_t size, const std::function<void(size_t)>& f);
+
     // ACCESSORS for specific types
     // Alas these can't be virtual or they break when passed a nullptr
     inline bool isZero() const;
@@ -1984,6 +1999,8 @@ public:
     virtual bool undead() const { return false; }
     // Check if node is consistent, return nullptr if ok, else reason string
     virtual const char* broken() const { return nullptr; }
+    // Size of this node's object, excluding any separately allocated members
+    virtual size_t nodeBytes() const = 0;
 
     // INVOKERS
     virtual void accept(VNVisitorConst& v) = 0;
@@ -42,7 +42,7 @@ private:
     // Other members
     bool m_generic = false;  // Simple globally referenced type, don't garbage collect
     // Unique number assigned to each dtype during creation for IEEE matching
-    static int s_uniqueNum;
+    static std::atomic<int> s_uniqueNum;
 
 protected:
     // CONSTRUCTORS
@@ -295,6 +295,7 @@ class AstAssocArrayDType final : public AstNodeDType {
 private:
     AstNodeDType* m_refDTypep;  // Elements of this type (after widthing)
     AstNodeDType* m_keyDTypep;  // Keys of this type (after widthing)
+    bool m_hashed = false;  // Never iterated in key order, emit as hash table (V3AssocHash)
 public:
     AstAssocArrayDType(FileLine* fl, VFlagChildDType, AstNodeDType* dtp, AstNodeDType* keyDtp)
         : ASTGEN_SUPER_AssocArrayDType(fl) {
@@ -350,6 +351,8 @@ public:
         return m_keyDTypep ? m_keyDTypep : keyChildDTypep();
     }
     void keyDTypep(AstNodeDType* nodep) { m_keyDTypep = nodep; }
+    bool hashed() const VL_MT_STABLE { return m_hashed; }
+    void hashed(bool flag) { m_hashed = flag; }
     // METHODS
     AstBasicDType* basicp() const override VL_MT_STABLE { return nullptr; }
     AstNodeDType* skipRefp() const override VL_MT_STABLE { return (AstNodeDType*)this; }
@@ -919,6 +922,54 @@ public:
         return false;
     }
 };
+class AstNBACommitQueueDType final : public AstNodeDType {
+    // Queue of pending non-blocking writes to whole elements of an unpacked array
+    // @astgen op1 := childDTypep : Optional[AstNodeDType]
+    AstNodeDType* m_refDTypep = nullptr;  // Elements of this type
+public:
+    AstNBACommitQueueDType(FileLine* fl, AstNodeDType* dtp)
+        : ASTGEN_SUPER_NBACommitQueueDType(fl) {
+        refDTypep(dtp);
+        dtypep(dtp);
+    }
+    ASTGEN_MEMBERS_AstNBACommitQueueDType;
+    const char* broken() const override {
+        BROKEN_RTN(!((m_refDTypep && !childDTypep() && m_refDTypep->brokeExists())
+                     || (!m_refDTypep && childDTypep())));
+        return nullptr;
+    }
+    void cloneRelink() override {
+        if (m_refDTypep && m_refDTypep->clonep()) m_refDTypep = m_refDTypep->clonep();
+    }
+    bool same(const AstNode* samep) const override {
+        const AstNBACommitQueueDType* const asamep
+            = static_cast<const AstNBACommitQueueDType*>(samep);
+        if (!asamep->subDTypep()) return false;
+        return (subDTypep() == asamep->subDTypep());
+    }
+    bool similarDType(const AstNodeDType* samep) const override {
+        const AstNBACommitQueueDType* const asamep
+            = static_cast<const AstNBACommitQueueDType*>(samep);
+        return type() == samep->type() && asamep->subDTypep()
+               && subDTypep()->skipRefp()->similarDType(asamep->subDTypep()->skipRefp());
+    }
+    void dumpSmall(std::ostream& str) const override;
+    AstNodeDType* getChildDTypep() const override { return childDTypep(); }
+    AstNodeDType* subDTypep() const override VL_MT_STABLE {
+        return m_refDTypep ? m_refDTypep : childDTypep();
+    }
+    void refDTypep(AstNodeDType* nodep) { m_refDTypep = nodep; }
+    AstNodeDType* virtRefDTypep() const override { return m_refDTypep; }
+    void virtRefDTypep(AstNodeDType* nodep) override { refDTypep(nodep); }
+    // METHODS
+    AstBasicDType* basicp() const override VL_MT_STABLE { return subDTypep()->basicp(); }
+    AstNodeDType* skipRefp() const override VL_MT_STABLE { return (AstNodeDType*)this; }
+    AstNodeDType* skipRefToConstp() const override { return (AstNodeDType*)this; }
+    AstNodeDType* skipRefToEnump() const override { return (AstNodeDType*)this; }
+    int widthAlignBytes() const override { return sizeof(std::vector<size_t>); }
+    int widthTotalBytes() const override { return sizeof(std::vector<size_t>); }
+    bool isCompound() const override { return true; }
+};
 class AstParamTypeDType final : public AstNodeDType {
     // Parents: MODULE
     // A parameter type statement; much like a var or typedef
@@ -1339,6 +1390,8 @@ public:
     void isCompound(bool flag) { m_isCompound = flag; }
     bool isCompound() const override VL_MT_SAFE { return m_isCompound; }
     bool isIntegralOrPacked() const override { return false; }
+    // Stored as paged VlSparseArray, see --sparse-arrays
+    bool isSparse() const VL_MT_STABLE;
 };
 
 // === AstNodeUOrStructDType ===
@@ -65,6 +65,7 @@ class AstNodeFTask VL_NOT_FINAL : public AstNode {
 private:
     string m_name;  // Name of task
     string m_cname;  // Name of task if DPI import
+    string m_dpiGroup;  // DPI import resource group, from dpi_group configuration
     uint64_t m_dpiOpenParent = 0;  // DPI import open array, if !=0, how many callees
     bool m_taskPublic : 1;  // Public task
     bool m_attrIsolateAssign : 1;  // User isolate_assignments attribute
@@ -127,6 +128,8 @@ public:
     void cname(const string& cname) { m_cname = cname; }
     bool isFunction() const { return fvarp() != nullptr; }
     // MORE ACCESSORS
+    string dpiGroup() const { return m_dpiGroup; }
+    void dpiGroup(const string& group) { m_dpiGroup = group; }
     void dpiOpenParentInc() { ++m_dpiOpenParent; }
     void dpiOpenParentClear() { m_dpiOpenParent = 0; }
     uint64_t dpiOpenParent() const { return m_dpiOpenParent; }
@@ -556,12 +559,16 @@ private:
     string m_argTypes;  // Argument types
     string m_baseCtors;  // Base class constructor
     string m_ifdef;  // #ifdef symbol around this function
+    string m_section;  // Text section to place this function into, or empty for default
+    string m_dpiGroup;  // DPI import resource group, from dpi_group configuration
+    int m_profilerId = -1;  // --prof-pgo counter number, or -1 if not profiled
     VBoolOrUnknown m_isConst;  // Function is declared const (*this not changed)
     bool m_isStatic : 1;  // Function is static (no need for a 'this' pointer)
     bool m_isTrace : 1;  // Function is related to tracing
     bool m_dontCombine : 1;  // V3Combine shouldn't compare this func tree, it's special
     bool m_declPrivate : 1;  // Declare it private
     bool m_slow : 1;  // Slow routine, called once or just at init time
+    bool m_isHot : 1;  // Profiling showed much time is spent in this routine
     bool m_funcPublic : 1;  // From user public task/function
     bool m_isConstructor : 1;  // Is C class constructor
     bool m_isDestructor : 1;  // Is C class destructor
@@ -578,6 +585,7 @@ private:
     bool m_dpiImportPrototype : 1;  // This is the DPI import prototype (i.e.: provided by user)
     bool m_dpiImportWrapper : 1;  // Wrapper for invoking DPI import prototype from generated code
     bool m_dpiTraceInit : 1;  // DPI trace_init
+    bool m_isStateMachine : 1;  // Process lowered to a state machine, resumed by the scheduler
 public:
     AstCFunc(FileLine* fl, const string& name, AstScope* scopep, const string& rtnType = "")
         : ASTGEN_SUPER_CFunc(fl) {
@@ -590,6 +598,7 @@ public:
         m_dontCombine = false;
         m_declPrivate = false;
         m_slow = false;
+        m_isHot = false;
         m_funcPublic = false;
         m_isConstructor = false;
         m_isDestructor = false;
@@ -605,6 +614,7 @@ public:
         m_dpiImportPrototype = false;
         m_dpiImportWrapper = false;
         m_dpiTraceInit = false;
+        m_isStateMachine = false;
     }
     ASTGEN_MEMBERS_AstCFunc;
     string name() const override VL_MT_STABLE { return m_name; }
@@ -644,6 +654,10 @@ public:
     void declPrivate(bool flag) { m_declPrivate = flag; }
     bool slow() const VL_MT_SAFE { return m_slow; }
     void slow(bool flag) { m_slow = flag; }
+    bool isHot() const { return m_isHot; }
+    void isHot(bool flag) { m_isHot = flag; }
+    int profilerId() const { return m_profilerId; }
+    void profilerId(int id) { m_profilerId = id; }
     bool funcPublic() const { return m_funcPublic; }
     void funcPublic(bool flag) { m_funcPublic = flag; }
     void argTypes(const string& str) { m_argTypes = str; }
@@ -652,6 +666,10 @@ public:
     string baseCtors() const { return m_baseCtors; }
     void ifdef(const string& str) { m_ifdef = str; }
     string ifdef() const { return m_ifdef; }
+    void section(const string& str) { m_section = str; }
+    string section() const { return m_section; }
+    void dpiGroup(const string& str) { m_dpiGroup = str; }
+    string dpiGroup() const { return m_dpiGroup; }
     bool isConstructor() const { return m_isConstructor; }
     void isConstructor(bool flag) { m_isConstructor = flag; }
     bool isDestructor() const { return m_isDestructor; }
@@ -682,6 +700,8 @@ public:
     void dpiTraceInit(bool flag) { m_dpiTraceInit = flag; }
     bool dpiTraceInit() const { return m_dpiTraceInit; }
     bool isCoroutine() const { return m_rtnType == "VlCoroutine"; }
+    bool isStateMachine() const { return m_isStateMachine; }
+    void isStateMachine(bool flag) { m_isStateMachine = flag; }
     // Special methods
     bool emptyBody() const {
         return argsp() == nullptr && initsp() == nullptr && stmtsp() == nullptr
@@ -1141,8 +1161,11 @@ class AstNetlist final : public AstNode {
     AstPackage* m_stdPackagep = nullptr;  // SystemVerilog std package
     AstCFunc* m_evalp = nullptr;  // The '_eval' function
     AstCFunc* m_evalNbap = nullptr;  // The '_eval__nba' function
+    AstCFunc* m_evalClockp = nullptr;  // The '_eval_clock' function, if any
     AstVarScope* m_dpiExportTriggerp = nullptr;  // The DPI export trigger variable
     AstVar* m_delaySchedulerp = nullptr;  // The delay scheduler variable
+    AstVar* m_evalIterCountp = nullptr;  // The '_eval' loop iteration counter variable
+    AstVar* m_inputsUnchangedp = nullptr;  // Set via the model API to skip the next 'ico' loop
     AstTopScope* m_topScopep = nullptr;  // The singleton AstTopScope under the top module
     VTimescale m_timeunit;  // Global time unit
     VTimescale m_timeprecision;  // Global time precision
@@ -1150,6 +1173,7 @@ class AstNetlist final : public AstNode {
     uint32_t m_nextFreeMTaskID = 1;  // Next unique MTask ID within netlist
                                      // starts at 1 so 0 means no MTask ID
     uint32_t m_nextFreeMTaskProfilingID = 0;  // Next unique ID to use for PGO
+    uint32_t m_nextFreeMTaskGuardID = 0;  // Next unique ID of an idle check guarding an MTask
 public:
     AstNetlist();
     ASTGEN_MEMBERS_AstNetlist;
@@ -1168,10 +1192,16 @@ public:
     void evalp(AstCFunc* funcp) { m_evalp = funcp; }
     AstCFunc* evalNbap() const { return m_evalNbap; }
     void evalNbap(AstCFunc* funcp) { m_evalNbap = funcp; }
+    AstCFunc* evalClockp() const { return m_evalClockp; }
+    void evalClockp(AstCFunc* funcp) { m_evalClockp = funcp; }
     AstVarScope* dpiExportTriggerp() const { return m_dpiExportTriggerp; }
     void dpiExportTriggerp(AstVarScope* varScopep) { m_dpiExportTriggerp = varScopep; }
     AstVar* delaySchedulerp() const { return m_delaySchedulerp; }
     void delaySchedulerp(AstVar* const varScopep) { m_delaySchedulerp = varScopep; }
+    AstVar* evalIterCountp() const { return m_evalIterCountp; }
+    void evalIterCountp(AstVar* const varp) { m_evalIterCountp = varp; }
+    AstVar* inputsUnchangedp() const { return m_inputsUnchangedp; }
+    void inputsUnchangedp(AstVar* const varp) { m_inputsUnchangedp = varp; }
     void stdPackagep(AstPackage* const packagep) { m_stdPackagep = packagep; }
     AstPackage* stdPackagep() const { return m_stdPackagep; }
     AstTopScope* topScopep() const { return m_topScopep; }
@@ -1189,6 +1219,8 @@ public:
     uint32_t allocNextMTaskID() { return m_nextFreeMTaskID++; }
     uint32_t allocNextMTaskProfilingID() { return m_nextFreeMTaskProfilingID++; }
     uint32_t usedMTaskProfilingIDs() const { return m_nextFreeMTaskProfilingID; }
+    uint32_t allocNextMTaskGuardID() { return m_nextFreeMTaskGuardID++; }
+    uint32_t usedMTaskGuardIDs() const { return m_nextFreeMTaskGuardID; }
 };
 class AstPackageExport final : public AstNode {
 private:
@@ -1659,6 +1691,7 @@ class AstVar final : public AstNode {
     bool m_isForceable : 1;  // May be forced/released externally from user C code
     bool m_isWrittenByDpi : 1;  // This variable can be written by a DPI Export
     bool m_isWrittenBySuspendable : 1;  // This variable can be written by a suspendable process
+    bool m_isCacheLineAligned : 1;  // Starts a new cache line, to avoid false sharing
 
     void init() {
         m_ansi = false;
@@ -1702,6 +1735,7 @@ class AstVar final : public AstNode {
         m_isForceable = false;
         m_isWrittenByDpi = false;
         m_isWrittenBySuspendable = false;
+        m_isCacheLineAligned = false;
         m_attrClocker = VVarAttrClocker::CLOCKER_UNKNOWN;
     }
 
@@ -1863,6 +1897,8 @@ public:
     void setWrittenByDpi() { m_isWrittenByDpi = true; }
     bool isWrittenBySuspendable() const { return m_isWrittenBySuspendable; }
     void setWrittenBySuspendable() { m_isWrittenBySuspendable = true; }
+    bool isCacheLineAligned() const { return m_isCacheLineAligned; }
+    void isCacheLineAligned(bool flag) { m_isCacheLineAligned = flag; }
 
     // METHODS
     void name(const string& name) override { m_name = name; }
@@ -1906,6 +1942,8 @@ public:
     bool isUsedLoopIdx() const { return m_usedLoopIdx; }
     bool isUsedVirtIface() const { return m_usedVirtIface; }
     bool isSc() const VL_MT_SAFE { return m_sc; }
+    bool isScPort() const;  // SystemC variable, or synchronized with one by --sc-sync-ports
+    bool isScSyncPort() const;  // Primary IO synchronized with a SystemC port
     bool isScQuad() const;
     bool isScBv() const;
     bool isScUint() const;
@@ -2484,6 +2522,8 @@ class AstCoverDecl final : public AstNodeStmt {
     // Coverage analysis point declaration
     AstCoverDecl* m_dataDeclp = nullptr;  // [After V3CoverageJoin] Pointer to duplicate
                                           // declaration to get data from instead
+    AstCoverDecl* m_derivedBasep = nullptr;  // If derived, count is this declaration's count
+    AstCoverDecl* m_derivedSubp = nullptr;  // If derived, minus this declaration's count
     string m_page;
     string m_text;
     string m_hier;
@@ -2504,10 +2544,14 @@ public:
         if (m_dataDeclp && m_dataDeclp->m_dataDeclp) {  // Avoid O(n^2) accessing
             v3fatalSrc("dataDeclp should point to real data, not be a list");
         }
+        BROKEN_RTN(m_derivedBasep && !m_derivedBasep->brokeExists());
+        BROKEN_RTN(m_derivedSubp && !m_derivedSubp->brokeExists());
         return nullptr;
     }
     void cloneRelink() override {
         if (m_dataDeclp && m_dataDeclp->clonep()) m_dataDeclp = m_dataDeclp->clonep();
+        if (m_derivedBasep && m_derivedBasep->clonep()) m_derivedBasep = m_derivedBasep->clonep();
+        if (m_derivedSubp && m_derivedSubp->clonep()) m_derivedSubp = m_derivedSubp->clonep();
     }
     void dump(std::ostream& str) const override;
     int instrCount() const override { return 1 + 2 * INSTR_COUNT_LD; }
@@ -2532,6 +2576,14 @@ public:
     // indicate to get data from here
     AstCoverDecl* dataDeclNullp() const { return m_dataDeclp; }
     AstCoverDecl* dataDeclThisp() { return dataDeclNullp() ? dataDeclNullp() : this; }
+    // Derived declarations have no counter of their own; their count is
+    // computed when coverage is written as basep's count minus subp's count
+    void derivedFrom(AstCoverDecl* basep, AstCoverDecl* subp) {
+        m_derivedBasep = basep;
+        m_derivedSubp = subp;
+    }
+    AstCoverDecl* derivedBasep() const { return m_derivedBasep; }
+    AstCoverDecl* derivedSubp() const { return m_derivedSubp; }
 };
 class AstCoverInc final : public AstNodeStmt {
     // Coverage analysis point; increment coverage count
@@ -2562,13 +2614,13 @@ public:
 class AstCoverToggle final : public AstNodeStmt {
     // Toggle analysis of given signal
     // Parents:  MODULE
-    // @astgen op1 := incp : AstCoverInc
+    // @astgen op1 := incsp : List[AstCoverInc] // One per bit of origp, or one for any change
     // @astgen op2 := origp : AstNodeExpr
     // @astgen op3 := changep : AstNodeExpr
 public:
-    AstCoverToggle(FileLine* fl, AstCoverInc* incp, AstNodeExpr* origp, AstNodeExpr* changep)
+    AstCoverToggle(FileLine* fl, AstCoverInc* incsp, AstNodeExpr* origp, AstNodeExpr* changep)
         : ASTGEN_SUPER_CoverToggle(fl) {
-        this->incp(incp);
+        this->addIncsp(incsp);
         this->origp(origp);
         this->changep(changep);
     }
@@ -3136,6 +3188,7 @@ class AstTraceInc final : public AstNodeStmt {
     // Trace point dump
     // @astgen op1 := precondsp : List[AstNode] // Statements to emit before this node
     // @astgen op2 := valuep : AstNodeExpr // Expression being traced (from decl)
+    // @astgen op3 := writtenp : Optional[AstNodeExpr] // Memory written element flags
 
 private:
     AstTraceDecl* m_declp;  // Pointer to declaration
@@ -3234,6 +3287,7 @@ class AstWhile final : public AstNodeStmt {
     // @astgen op2 := condp : AstNodeExpr
     // @astgen op3 := stmtsp : List[AstNode]
     // @astgen op4 := incsp : List[AstNode]
+    bool m_independent = false;  // Iterations have no dependencies, so may be vectorized
 public:
     AstWhile(FileLine* fl, AstNodeExpr* condp, AstNode* stmtsp = nullptr, AstNode* incsp = nullptr)
         : ASTGEN_SUPER_While(fl) {
@@ -3242,6 +3296,7 @@ public:
         this->addIncsp(incsp);
     }
     ASTGEN_MEMBERS_AstWhile;
+    void dump(std::ostream& str) const override;
     bool isGateOptimizable() const override { return false; }
     int instrCount() const override { return INSTR_COUNT_BRANCH; }
     bool same(const AstNode* /*samep*/) const override { return true; }
@@ -3250,6 +3305,8 @@ public:
     // Stop statement searchback here
     void addNextStmt(AstNode* newp, AstNode* belowp) override;
     bool isFirstInMyListOfStatements(AstNode* n) const override { return n == stmtsp(); }
+    bool independent() const { return m_independent; }
+    void independent(bool flag) { m_independent = flag; }
 };
 
 // === AstNodeAssign ===
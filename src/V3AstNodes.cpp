@@ -355,15 +355,22 @@ void AstNetlist::timeprecisionMerge(FileLine*, const VTimescale& value) {
 bool AstVar::isSigPublic() const {
     return (m_sigPublic || (v3Global.opt.allPublic() && !isTemp() && !isGenVar()));
 }
-bool AstVar::isScQuad() const { return (isSc() && isQuad() && !isScBv() && !isScBigUint()); }
+bool AstVar::isScPort() const { return isSc() || isScSyncPort(); }
+bool AstVar::isScSyncPort() const {
+    return !isSc() && isPrimaryIO() && v3Global.opt.scSyncPorts();
+}
+bool AstVar::isScQuad() const {
+    return (isScPort() && isQuad() && !isScBv() && !isScBigUint());
+}
 bool AstVar::isScBv() const {
-    return ((isSc() && width() >= v3Global.opt.pinsBv()) || m_attrScBv);
+    return ((isScPort() && width() >= v3Global.opt.pinsBv()) || m_attrScBv);
 }
 bool AstVar::isScUint() const {
-    return ((isSc() && v3Global.opt.pinsScUint() && width() >= 2 && width() <= 64) && !isScBv());
+    return ((isScPort() && v3Global.opt.pinsScUint() && width() >= 2 && width() <= 64)
+            && !isScBv());
 }
 bool AstVar::isScBigUint() const {
-    return ((isSc() && v3Global.opt.pinsScBigUint() && width() >= 65 && width() <= 512)
+    return ((isScPort() && v3Global.opt.pinsScBigUint() && width() >= 65 && width() <= 512)
             && !isScBv());
 }
 
@@ -729,7 +736,9 @@ AstNodeDType::CTypeRecursed AstNodeDType::cTypeRecurse(bool compound) const VL_M
     if (const auto* const adtypep = VN_CAST(dtypep, AssocArrayDType)) {
         const CTypeRecursed key = adtypep->keyDTypep()->cTypeRecurse(true);
         const CTypeRecursed val = adtypep->subDTypep()->cTypeRecurse(true);
-        info.m_type = "VlAssocArray<" + key.m_type + ", " + val.m_type + ">";
+        info.m_type = "VlAssocArray<" + key.m_type + ", " + val.m_type;
+        if (adtypep->hashed()) info.m_type += ", false";
+        info.m_type += ">";
     } else if (const auto* const adtypep = VN_CAST(dtypep, WildcardArrayDType)) {
         const CTypeRecursed sub = adtypep->subDTypep()->cTypeRecurse(true);
         info.m_type = "VlAssocArray<std::string, " + sub.m_type + ">";
@@ -745,6 +754,9 @@ AstNodeDType::CTypeRecursed AstNodeDType::cTypeRecurse(bool compound) const VL_M
     } else if (const auto* const adtypep = VN_CAST(dtypep, SampleQueueDType)) {
         const CTypeRecursed sub = adtypep->subDTypep()->cTypeRecurse(true);
         info.m_type = "VlSampleQueue<" + sub.m_type + ">";
+    } else if (const auto* const adtypep = VN_CAST(dtypep, NBACommitQueueDType)) {
+        const CTypeRecursed sub = adtypep->subDTypep()->cTypeRecurse(true);
+        info.m_type = "VlNBACommitQueue<" + sub.m_type + ">";
     } else if (const auto* const adtypep = VN_CAST(dtypep, ClassRefDType)) {
         info.m_type = "VlClassRef<" + EmitCBase::prefixNameProtect(adtypep) + ">";
     } else if (const auto* const adtypep = VN_CAST(dtypep, IfaceRefDType)) {
@@ -752,7 +764,7 @@ AstNodeDType::CTypeRecursed AstNodeDType::cTypeRecurse(bool compound) const VL_M
     } else if (const auto* const adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
         if (adtypep->isCompound()) compound = true;
         const CTypeRecursed sub = adtypep->subDTypep()->cTypeRecurse(compound);
-        info.m_type = "VlUnpacked<" + sub.m_type;
+        info.m_type = (adtypep->isSparse() ? "VlSparseArray<" : "VlUnpacked<") + sub.m_type;
         info.m_type += ", " + cvtToStr(adtypep->declRange().elements());
         info.m_type += ">";
     } else if (VN_IS(dtypep, NodeUOrStructDType) && !VN_AS(dtypep, NodeUOrStructDType)->packed()) {
@@ -1025,6 +1037,10 @@ bool AstSenTree::hasHybrid() const {
     return false;
 }
 
+// The type table is shared by passes run per module in parallel; guard lookups and inserts.
+// Recursive as some find functions build on others.
+static V3RecursiveMutex s_typeTableMutex;
+
 AstTypeTable::AstTypeTable(FileLine* fl)
     : ASTGEN_SUPER_TypeTable(fl) {
     for (int i = 0; i < VBasicDTypeKwd::_ENUM_MAX; ++i) m_basicps[i] = nullptr;
@@ -1033,6 +1049,7 @@ AstTypeTable::AstTypeTable(FileLine* fl)
 void AstTypeTable::clearCache() {
     // When we mass-change widthMin in V3WidthCommit, we need to correct the table.
     // Just clear out the maps; the search functions will be used to rebuild the map
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     for (auto& itr : m_basicps) itr = nullptr;
     m_detailedMap.clear();
     // Clear generic()'s so dead detection will work
@@ -1043,6 +1060,7 @@ void AstTypeTable::clearCache() {
 
 void AstTypeTable::repairCache() {
     // After we mass-change widthMin in V3WidthCommit, we need to correct the table.
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     clearCache();
     for (AstNode* nodep = typesp(); nodep; nodep = nodep->nextp()) {
         if (AstBasicDType* const bdtypep = VN_CAST(nodep, BasicDType)) {
@@ -1052,6 +1070,7 @@ void AstTypeTable::repairCache() {
 }
 
 AstEmptyQueueDType* AstTypeTable::findEmptyQueueDType(FileLine* fl) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     if (VL_UNLIKELY(!m_emptyQueuep)) {
         AstEmptyQueueDType* const newp = new AstEmptyQueueDType{fl};
         addTypesp(newp);
@@ -1061,6 +1080,7 @@ AstEmptyQueueDType* AstTypeTable::findEmptyQueueDType(FileLine* fl) {
 }
 
 AstVoidDType* AstTypeTable::findVoidDType(FileLine* fl) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     if (VL_UNLIKELY(!m_voidp)) {
         AstVoidDType* const newp = new AstVoidDType{fl};
         addTypesp(newp);
@@ -1070,6 +1090,7 @@ AstVoidDType* AstTypeTable::findVoidDType(FileLine* fl) {
 }
 
 AstQueueDType* AstTypeTable::findQueueIndexDType(FileLine* fl) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     if (VL_UNLIKELY(!m_queueIndexp)) {
         AstQueueDType* const newp = new AstQueueDType{fl, AstNode::findUInt32DType(), nullptr};
         addTypesp(newp);
@@ -1079,6 +1100,7 @@ AstQueueDType* AstTypeTable::findQueueIndexDType(FileLine* fl) {
 }
 
 AstBasicDType* AstTypeTable::findBasicDType(FileLine* fl, VBasicDTypeKwd kwd) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     if (m_basicps[kwd]) return m_basicps[kwd];
     //
     AstBasicDType* const new1p = new AstBasicDType{fl, kwd};
@@ -1098,6 +1120,7 @@ AstBasicDType* AstTypeTable::findBasicDType(FileLine* fl, VBasicDTypeKwd kwd) {
 
 AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, VBasicDTypeKwd kwd, int width,
                                                int widthMin, VSigning numeric) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     AstBasicDType* const new1p = new AstBasicDType{fl, kwd, numeric, width, widthMin};
     AstBasicDType* const newp = findInsertSameDType(new1p);
     if (newp != new1p) {
@@ -1111,6 +1134,7 @@ AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, VBasicDTypeKwd kwd,
 AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, VBasicDTypeKwd kwd,
                                                const VNumRange& range, int widthMin,
                                                VSigning numeric) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     AstBasicDType* const new1p = new AstBasicDType{fl, kwd, numeric, range, widthMin};
     AstBasicDType* const newp = findInsertSameDType(new1p);
     if (newp != new1p) {
@@ -1122,6 +1146,7 @@ AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, VBasicDTypeKwd kwd,
 }
 
 AstBasicDType* AstTypeTable::findInsertSameDType(AstBasicDType* nodep) {
+    const V3RecursiveLockGuard lock{s_typeTableMutex};
     const VBasicTypeKey key{nodep->width(), nodep->widthMin(), nodep->numeric(), nodep->keyword(),
                             nodep->nrange()};
     DetailedMap& mapr = m_detailedMap;
@@ -1885,6 +1910,10 @@ string AstPackArrayDType::prettyDTypeName() const {
     os << declRange();
     return os.str();
 }
+bool AstUnpackArrayDType::isSparse() const {
+    const int minElements = v3Global.opt.sparseArrays();
+    return minElements && elementsConst() >= minElements;
+}
 string AstUnpackArrayDType::prettyDTypeName() const {
     std::ostringstream os;
     string ranges = cvtToStr(declRange());
@@ -1919,9 +1948,12 @@ const char* AstNetlist::broken() const {
     BROKEN_RTN(m_constPoolp && !m_constPoolp->brokeExists());
     BROKEN_RTN(m_dollarUnitPkgp && !m_dollarUnitPkgp->brokeExists());
     BROKEN_RTN(m_evalp && !m_evalp->brokeExists());
+    BROKEN_RTN(m_evalClockp && !m_evalClockp->brokeExists());
     BROKEN_RTN(m_dpiExportTriggerp && !m_dpiExportTriggerp->brokeExists());
     BROKEN_RTN(m_topScopep && !m_topScopep->brokeExists());
     BROKEN_RTN(m_delaySchedulerp && !m_delaySchedulerp->brokeExists());
+    BROKEN_RTN(m_evalIterCountp && !m_evalIterCountp->brokeExists());
+    BROKEN_RTN(m_inputsUnchangedp && !m_inputsUnchangedp->brokeExists());
     return nullptr;
 }
 AstPackage* AstNetlist::dollarUnitPkgAddp() {
@@ -2021,6 +2053,7 @@ void AstTypeTable::dump(std::ostream& str) const {
 void AstAssocArrayDType::dumpSmall(std::ostream& str) const {
     this->AstNodeDType::dumpSmall(str);
     str << "[assoc-" << reinterpret_cast<const void*>(keyDTypep()) << "]";
+    if (hashed()) str << "[hash]";
 }
 string AstAssocArrayDType::prettyDTypeName() const {
     return subDTypep()->prettyDTypeName() + "[" + keyDTypep()->prettyDTypeName() + "]";
@@ -2053,6 +2086,10 @@ bool AstWildcardArrayDType::similarDType(const AstNodeDType* samep) const {
     return type() == samep->type() && asamep->subDTypep()
            && subDTypep()->skipRefp()->similarDType(asamep->subDTypep()->skipRefp());
 }
+void AstNBACommitQueueDType::dumpSmall(std::ostream& str) const {
+    this->AstNodeDType::dumpSmall(str);
+    str << "[nba]";
+}
 void AstSampleQueueDType::dumpSmall(std::ostream& str) const {
     this->AstNodeDType::dumpSmall(str);
     str << "[*]";
@@ -2139,6 +2176,7 @@ void AstVar::dump(std::ostream& str) const {
     if (isUsedClock()) str << " [CLK]";
     if (isSigPublic()) str << " [P]";
     if (isLatched()) str << " [LATCHED]";
+    if (isCacheLineAligned()) str << " [ALIGN]";
     if (isUsedLoopIdx()) str << " [LOOP]";
     if (noReset()) str << " [!RST]";
     if (attrIsolateAssign()) str << " [aISO]";
@@ -2255,6 +2293,7 @@ void AstCoverDecl::dump(std::ostream& str) const {
     this->AstNodeStmt::dump(str);
     if (!page().empty()) str << " page=" << page();
     if (!linescov().empty()) str << " lc=" << linescov();
+    if (derivedBasep()) str << " [DERIVED]";
     if (this->dataDeclNullp()) {
         str << " -> ";
         this->dataDeclNullp()->dump(str);
@@ -2279,6 +2318,10 @@ void AstTraceDecl::dump(std::ostream& str) const {
     this->AstNodeStmt::dump(str);
     if (code()) str << " [code=" << code() << "]";
 }
+void AstWhile::dump(std::ostream& str) const {
+    this->AstNodeStmt::dump(str);
+    if (independent()) str << " [INDEP]";
+}
 void AstTraceInc::dump(std::ostream& str) const {
     this->AstNodeStmt::dump(str);
     str << " -> ";
@@ -2310,17 +2353,20 @@ void AstCFile::dump(std::ostream& str) const {
 void AstCFunc::dump(std::ostream& str) const {
     this->AstNode::dump(str);
     if (slow()) str << " [SLOW]";
+    if (isHot()) str << " [HOT]";
     if (pure()) str << " [PURE]";
     if (isStatic()) str << " [STATIC]";
     if (dpiExportDispatcher()) str << " [DPIED]";
     if (dpiExportImpl()) str << " [DPIEI]";
     if (dpiImportPrototype()) str << " [DPIIP]";
     if (dpiImportWrapper()) str << " [DPIIW]";
+    if (!dpiGroup().empty()) str << " [DPIGROUP " << dpiGroup() << "]";
     if (dpiContext()) str << " [DPICTX]";
     if (isConstructor()) str << " [CTOR]";
     if (isDestructor()) str << " [DTOR]";
     if (isVirtual()) str << " [VIRT]";
     if (isCoroutine()) str << " [CORO]";
+    if (isStateMachine()) str << " [FSM]";
 }
 const char* AstCAwait::broken() const {
     BROKEN_RTN(m_sensesp && !m_sensesp->brokeExists());
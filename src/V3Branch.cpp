@@ -21,6 +21,15 @@
 //         Count calls into the function
 //      Then, if FTASK is called only once, add inline attribute
 //
+//      With --prof-pgo, give each eligible CFUNC a profiling counter.
+//      If profile data has CFUNC records, functions never called during
+//      profiling are made slow (cold, out of line in __Slow files), and
+//      functions taking a large share of the time are marked hot.
+//
+//      With --hot-sections, place each fast CFUNC in a text section named
+//      after the scheduling region (ico/act/nba) it is called from, so the
+//      code of each region is contiguous in the executable.
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -29,12 +38,19 @@
 #include "V3Branch.h"
 
 #include "V3Ast.h"
+#include "V3Config.h"
 #include "V3Global.h"
+#include "V3Stats.h"
 
+#include <functional>
 #include <map>
+#include <unordered_map>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
+// Functions taking at least this percentage of the most expensive function's time are hot
+constexpr uint64_t PGO_HOT_PERCENT = 5;
+
 //######################################################################
 // Branch state, as a visitor of each AstNode
 
@@ -46,9 +62,18 @@ private:
     const VNUser1InUse m_inuser1;
 
     // STATE
+    AstNodeModule* m_modp = nullptr;  // Current module
+    AstCFunc* m_cfuncp = nullptr;  // Current function
     int m_likely = false;  // Excuses for branch likely taken
     int m_unlikely = false;  // Excuses for branch likely not taken
     std::vector<AstCFunc*> m_cfuncsp;  // List of all tasks
+    std::vector<std::pair<AstNodeModule*, AstCFunc*>> m_profilep;  // Functions to profile
+    std::unordered_map<const AstCFunc*, std::vector<AstCFunc*>> m_callees;  // Call graph
+    std::vector<std::pair<string, AstCFunc*>> m_regionRootps;  // Scheduling region functions
+    VDouble0 m_statProfiled;  // Statistic tracking
+    VDouble0 m_statCold;  // Statistic tracking
+    VDouble0 m_statHot;  // Statistic tracking
+    VDouble0 m_statSections;  // Statistic tracking
 
     // METHODS
 
@@ -91,11 +116,27 @@ private:
     void visit(AstNodeCCall* nodep) override {
         checkUnlikely(nodep);
         nodep->funcp()->user1Inc();
+        if (m_cfuncp && v3Global.opt.hotSections()) m_callees[m_cfuncp].push_back(nodep->funcp());
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNodeModule* nodep) override {
+        VL_RESTORER(m_modp);
+        m_modp = nodep;
         iterateChildrenConst(nodep);
     }
     void visit(AstCFunc* nodep) override {
+        VL_RESTORER(m_cfuncp);
+        m_cfuncp = nodep;
         checkUnlikely(nodep);
         m_cfuncsp.push_back(nodep);
+        if (m_modp && profilable(nodep)) m_profilep.emplace_back(m_modp, nodep);
+        if (m_modp && m_modp->isTop() && v3Global.opt.hotSections()) {
+            for (const char* const region : {"ico", "act", "nba"}) {
+                if (nodep->name() == string{"_eval_"} + region) {
+                    m_regionRootps.emplace_back(region, nodep);
+                }
+            }
+        }
         iterateChildrenConst(nodep);
     }
     void visit(AstNode* nodep) override {
@@ -104,6 +145,69 @@ private:
     }
 
     // METHODS
+    bool profilable(const AstCFunc* nodep) const {
+        // Only functions given vlSymsp by the emitted prologue, and not suspendable
+        return v3Global.opt.profPgo() && !v3Global.opt.mtasks() && !VN_IS(m_modp, Class)
+               && nodep->isLoose() && !nodep->isStatic() && !nodep->slow() && nodep->stmtsp()
+               && !nodep->isTrace() && !nodep->isCoroutine() && !nodep->dpiExportImpl()
+               && !nodep->dpiImportWrapper() && nodep->ifdef().empty();
+    }
+    void calc_profile() {
+        const string& model = v3Global.opt.prefix();
+        const bool haveData = V3Config::hasProfileCFuncs(model);
+        uint64_t maxCost = 0;
+        if (haveData) {
+            for (const auto& pair : m_profilep) {
+                const string name = V3Branch::profileName(pair.first, pair.second);
+                const V3ConfigProfileCFunc* const datap = V3Config::getProfileCFunc(model, name);
+                if (datap) maxCost = std::max(maxCost, datap->m_cost);
+            }
+        }
+        for (const auto& pair : m_profilep) {
+            AstCFunc* const funcp = pair.second;
+            funcp->profilerId(v3Global.rootp()->allocNextMTaskProfilingID());
+            ++m_statProfiled;
+            if (!haveData) continue;
+            const V3ConfigProfileCFunc* const datap
+                = V3Config::getProfileCFunc(model, V3Branch::profileName(pair.first, funcp));
+            if (!datap) continue;  // New function, no opinion
+            if (datap->m_calls == 0 && !funcp->entryPoint()) {
+                UINFO(4, "  PGO cold: " << funcp << endl);
+                funcp->slow(true);
+                ++m_statCold;
+            } else if (datap->m_cost * 100 >= maxCost * PGO_HOT_PERCENT) {
+                UINFO(4, "  PGO hot: " << funcp << endl);
+                funcp->isHot(true);
+                ++m_statHot;
+            }
+        }
+    }
+    void calc_sections() {
+        // Region each fast function is called from, or "eval" if from several regions
+        std::unordered_map<const AstCFunc*, string> regions;
+        const std::function<void(AstCFunc*, const string&)> markRegion
+            = [&](AstCFunc* funcp, const string& region) {
+                  if (funcp->slow()) return;
+                  string& funcRegion = regions[funcp];
+                  if (funcRegion == region || funcRegion == "eval") return;
+                  funcRegion = funcRegion.empty() ? region : "eval";
+                  for (AstCFunc* const calleep : m_callees[funcp]) markRegion(calleep, funcRegion);
+              };
+        for (const auto& pair : m_regionRootps) markRegion(pair.second, pair.first);
+        for (AstCFunc* const funcp : m_cfuncsp) {
+            // Not defined by us, or constructed once
+            if (funcp->slow() || funcp->dpiImportPrototype() || funcp->isConstructor()
+                || funcp->isDestructor()) {
+                continue;
+            }
+            const auto it = regions.find(funcp);
+            const string region = funcp->isHot()         ? "hot"
+                                  : it != regions.end() ? it->second
+                                                        : "eval";
+            funcp->section(".text.hot.vl_" + region);
+            ++m_statSections;
+        }
+    }
     void calc_tasks() {
         for (AstCFunc* nodep : m_cfuncsp) {
             if (!nodep->dontInline()) nodep->isInline(true);
@@ -115,14 +219,29 @@ public:
     explicit BranchVisitor(AstNetlist* nodep) {
         reset();
         iterateChildrenConst(nodep);
+        calc_profile();
+        if (v3Global.opt.hotSections()) calc_sections();
         calc_tasks();
     }
-    ~BranchVisitor() override = default;
+    ~BranchVisitor() override {
+        if (v3Global.opt.profPgo() && !v3Global.opt.mtasks()) {
+            V3Stats::addStat("PGO, CFuncs profiled", m_statProfiled);
+            V3Stats::addStat("PGO, CFuncs made cold", m_statCold);
+            V3Stats::addStat("PGO, CFuncs made hot", m_statHot);
+        }
+        if (v3Global.opt.hotSections()) {
+            V3Stats::addStat("Optimizations, Hot sections assigned", m_statSections);
+        }
+    }
 };
 
 //######################################################################
 // Branch class functions
 
+string V3Branch::profileName(const AstNodeModule* modp, const AstCFunc* funcp) {
+    return modp->name() + "::" + funcp->name();
+}
+
 void V3Branch::branchAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
     { BranchVisitor{nodep}; }
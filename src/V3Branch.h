@@ -20,7 +20,9 @@
 #include "config_build.h"
 #include "verilatedos.h"
 
+class AstCFunc;
 class AstNetlist;
+class AstNodeModule;
 
 //============================================================================
 
@@ -28,6 +30,8 @@ class V3Branch final {
 public:
     // CONSTRUCTORS
     static void branchAll(AstNetlist* nodep);
+    // Name of a function's record in --prof-pgo data
+    static string profileName(const AstNodeModule* modp, const AstCFunc* funcp);
 };
 
 #endif  // Guard
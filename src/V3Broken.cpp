@@ -71,11 +71,13 @@ static class AllocTable final {
 private:
     // MEMBERS
     std::unordered_set<const AstNode*> m_allocated;  // Set of all nodes allocated but not freed
+    V3Mutex m_mutex;  // Nodes may be created and freed by passes running on V3ThreadPool
 
 public:
     // METHODS
     void addNewed(const AstNode* nodep) {
         // Called by operator new on any node - only if VL_LEAK_CHECKS
+        const V3LockGuard lock{m_mutex};
         // LCOV_EXCL_START
         if (VL_UNCOVERABLE(!m_allocated.emplace(nodep).second)) {
             nodep->v3fatalSrc("Newing AstNode object that is already allocated");
@@ -84,6 +86,7 @@ public:
     }
     void deleted(const AstNode* nodep) {
         // Called by operator delete on any node - only if VL_LEAK_CHECKS
+        const V3LockGuard lock{m_mutex};
         // LCOV_EXCL_START
         if (VL_UNCOVERABLE(m_allocated.erase(nodep) == 0)) {
             nodep->v3fatalSrc("Deleting AstNode object that was not allocated or already freed");
@@ -50,6 +50,9 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 #define CASE_OVERLAP_WIDTH 16  // Maximum width we can check for overlaps in
 #define CASE_BARF 999999  // Magic width when non-constant
 #define CASE_ENCODER_GROUP_DEPTH 8  // Levels of priority to be ORed together in top IF tree
+#define CASE_TREE_MIN_ITEMS 16  // Minimum items to build a decision tree over wide cases
+#define CASE_TREE_LEAF_ITEMS 4  // Items in decision tree leaves, tested in priority order
+#define CASE_TREE_DUP_FACTOR 4  // Limit on decision tree item duplicates, per item
 
 //######################################################################
 
@@ -126,8 +129,16 @@ private:
     //  AstIf::user3()          -> bool.  Set true to indicate clone not needed
     const VNUser3InUse m_inuser3;
 
+    // TYPES
+    struct CaseTreeEntry final {
+        uint64_t m_mask;  // Bits compared by this condition
+        uint64_t m_value;  // Value of compared bits
+        AstCaseItem* m_itemp;  // Case item of this condition
+    };
+
     // STATE
     VDouble0 m_statCaseFast;  // Statistic tracking
+    VDouble0 m_statCaseTree;  // Statistic tracking
     VDouble0 m_statCaseSlow;  // Statistic tracking
     const AstNode* m_alwaysp = nullptr;  // Always in which case is located
 
@@ -137,6 +148,11 @@ private:
     bool m_caseNoOverlapsAllCovered = false;  // Proven to be synopsys parallel_case compliant
     // For each possible value, the case branch we need
     std::array<AstNode*, 1 << CASE_OVERLAP_WIDTH> m_valueItem;
+    // For decision trees, the conditions in priority order, and the default item
+    std::vector<CaseTreeEntry> m_treeEntries;
+    AstCaseItem* m_treeDefaultp = nullptr;
+    int m_treeWidth = 0;  // Width of the case expression
+    size_t m_treeBudget = 0;  // Number of item duplicates the decision tree may still add
 
     // METHODS
     bool caseIsEnumComplete(AstCase* nodep, uint32_t numCases) {
@@ -365,6 +381,151 @@ private:
         if (debug() >= 9) ifrootp->dumpTree("-    _simp: ");
     }
 
+    bool isCaseTreeWide(AstCase* nodep) {
+        // Too wide for isCaseTreeFast, but all items are constants we can decide on bit by bit
+        m_treeEntries.clear();
+        m_treeDefaultp = nullptr;
+        m_treeWidth = nodep->exprp()->width();
+        if (m_treeWidth > 64 || nodep->exprp()->isDouble() || nodep->exprp()->isString()) {
+            return false;
+        }
+        for (AstCaseItem* itemp = nodep->itemsp(); itemp;
+             itemp = VN_AS(itemp->nextp(), CaseItem)) {
+            if (itemp->isDefault()) {
+                if (itemp->condsp()) return false;
+                m_treeDefaultp = itemp;
+                continue;
+            }
+            for (AstNode* icondp = itemp->condsp(); icondp; icondp = icondp->nextp()) {
+                AstConst* const iconstp = VN_CAST(icondp, Const);
+                if (!iconstp || iconstp->width() != m_treeWidth) return false;
+                if (iconstp->isDouble() || iconstp->isString()) return false;
+                if (neverItem(nodep, iconstp)) continue;  // X in casez can't ever be executed
+                V3Number nummask{itemp, iconstp->width()};
+                nummask.opBitsNonX(iconstp->num());
+                V3Number numval{itemp, iconstp->width()};
+                numval.opBitsOne(iconstp->num());
+                const uint64_t mask = nummask.toUQuad();
+                m_treeEntries.push_back({mask, numval.toUQuad() & mask, itemp});
+            }
+        }
+        return m_treeEntries.size() >= CASE_TREE_MIN_ITEMS;
+    }
+
+    static AstNode* cloneItemStmts(AstCaseItem* itemp) {
+        if (!itemp || !itemp->stmtsp()) return nullptr;
+        return itemp->stmtsp()->cloneTree(true);
+    }
+
+    AstConst* newTreeConst(FileLine* flp, uint64_t value) {
+        V3Number num{flp, m_treeWidth, 0};
+        num.setQuad(value);
+        return new AstConst{flp, num};
+    }
+
+    AstNode* replaceCaseTreeLeaf(AstNodeExpr* cexprp,
+                                 const std::vector<const CaseTreeEntry*>& entries,
+                                 uint64_t knownMask) {
+        // Test the remaining entries in priority order, on the bits not yet known
+        FileLine* const flp = cexprp->fileline();
+        AstNode* resultp = nullptr;
+        if (entries.back()->m_mask & ~knownMask) resultp = cloneItemStmts(m_treeDefaultp);
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            const CaseTreeEntry* const entryp = *it;
+            AstNode* const stmtsp = cloneItemStmts(entryp->m_itemp);
+            const uint64_t mask = entryp->m_mask & ~knownMask;
+            if (!mask) {  // Always matches if reached, only possible as the last entry
+                resultp = stmtsp;
+                continue;
+            }
+            AstNodeExpr* const andp
+                = new AstAnd{flp, cexprp->cloneTree(false), newTreeConst(flp, mask)};
+            AstNodeExpr* const condp
+                = AstEq::newTyped(flp, andp, newTreeConst(flp, entryp->m_value & mask));
+            resultp = new AstIf{flp, condp, stmtsp, resultp};
+        }
+        return resultp;
+    }
+
+    AstNode* replaceCaseTreeRecurse(AstNodeExpr* cexprp,
+                                    const std::vector<const CaseTreeEntry*>& entries,
+                                    uint64_t knownMask, uint64_t knownValue) {
+        // Drop the entries that can no longer match, and stop at the first that must match
+        std::vector<const CaseTreeEntry*> live;
+        for (const CaseTreeEntry* const entryp : entries) {
+            if (entryp->m_mask & knownMask & (entryp->m_value ^ knownValue)) continue;
+            live.push_back(entryp);
+            if (!(entryp->m_mask & ~knownMask)) break;
+        }
+        if (live.empty()) return cloneItemStmts(m_treeDefaultp);
+        if (!(live.front()->m_mask & ~knownMask)) return cloneItemStmts(live.front()->m_itemp);
+
+        // Cost model: split on the bit that minimizes the number of entries left to test on
+        // either side, counting entries that don't care about the bit on both sides. Only
+        // split while that makes progress and the budget for duplicated items allows.
+        int bestBit = -1;
+        size_t bestCost = live.size();
+        size_t bestDups = 0;
+        if (live.size() > CASE_TREE_LEAF_ITEMS) {
+            for (int bit = 0; bit < m_treeWidth; ++bit) {
+                const uint64_t bitMask = 1ULL << bit;
+                if (knownMask & bitMask) continue;
+                size_t n0 = 0;
+                size_t n1 = 0;
+                size_t nx = 0;
+                for (const CaseTreeEntry* const entryp : live) {
+                    if (!(entryp->m_mask & bitMask)) {
+                        ++nx;
+                    } else if (entryp->m_value & bitMask) {
+                        ++n1;
+                    } else {
+                        ++n0;
+                    }
+                }
+                const size_t cost = std::max(n0, n1) + nx;
+                if (cost < bestCost && nx <= m_treeBudget) {
+                    bestBit = bit;
+                    bestCost = cost;
+                    bestDups = nx;
+                }
+            }
+        }
+        if (bestBit < 0) return replaceCaseTreeLeaf(cexprp, live, knownMask);
+        m_treeBudget -= bestDups;
+
+        const uint64_t bitMask = 1ULL << bestBit;
+        AstNode* const tree0p
+            = replaceCaseTreeRecurse(cexprp, live, knownMask | bitMask, knownValue);
+        AstNode* const tree1p
+            = replaceCaseTreeRecurse(cexprp, live, knownMask | bitMask, knownValue | bitMask);
+        if (!tree0p && !tree1p) return nullptr;
+        FileLine* const flp = cexprp->fileline();
+        AstNodeExpr* const selp = new AstSel{flp, cexprp->cloneTree(false), bestBit, 1};
+        AstNodeExpr* const condp = new AstNeq{flp, new AstConst{flp, 0}, selp};
+        return new AstIf{flp, condp, tree1p, tree0p};
+    }
+
+    void replaceCaseTree(AstCase* nodep) {
+        // CASEx(cexpr,....
+        // ->  tree of IF(cexpr[bit],...), on the most discriminating bits, with short
+        //     priority chains of masked compares at the leaves
+        AstNodeExpr* const cexprp = nodep->exprp()->unlinkFrBack();
+        // Handle any assertions
+        replaceCaseParallel(nodep, false);
+        std::vector<const CaseTreeEntry*> entries;
+        for (const CaseTreeEntry& entry : m_treeEntries) entries.push_back(&entry);
+        m_treeBudget = m_treeEntries.size() * CASE_TREE_DUP_FACTOR;
+        AstNode* const treep = replaceCaseTreeRecurse(cexprp, entries, 0, 0);
+        if (treep) {
+            nodep->replaceWith(treep);
+        } else {
+            nodep->unlinkFrBack();
+        }
+        VL_DO_DANGLING(nodep->deleteTree(), nodep);
+        VL_DO_DANGLING(cexprp->deleteTree(), cexprp);
+        if (debug() >= 9 && treep) treep->dumpTree("-    _tree: ");
+    }
+
     void replaceCaseComplicated(AstCase* nodep) {
         // CASEx(cexpr,ITEM(icond1,istmts1),ITEM(icond2,istmts2),ITEM(default,istmts3))
         // ->  IF((cexpr==icond1),istmts1,
@@ -535,6 +696,11 @@ private:
             // we can make a tree of statements to avoid extra comparisons
             ++m_statCaseFast;
             VL_DO_DANGLING(replaceCaseFast(nodep), nodep);
+        } else if (v3Global.opt.fCase() && isCaseTreeWide(nodep)) {
+            // Large case on constants, decide it with a tree over the most discriminating bits
+            if (m_alwaysp) m_alwaysp->fileline()->warnOff(V3ErrorCode::LATCH, true);
+            ++m_statCaseTree;
+            VL_DO_DANGLING(replaceCaseTree(nodep), nodep);
         } else {
             // If a case statement is whole, presume signals involved aren't forming a latch
             if (m_alwaysp) m_alwaysp->fileline()->warnOff(V3ErrorCode::LATCH, true);
@@ -556,6 +722,7 @@ public:
     }
     ~CaseVisitor() override {
         V3Stats::addStat("Optimizations, Cases parallelized", m_statCaseFast);
+        V3Stats::addStat("Optimizations, Cases decision tree", m_statCaseTree);
         V3Stats::addStat("Optimizations, Cases complex", m_statCaseSlow);
     }
 };
@@ -19,6 +19,8 @@
 //      For each expression, if it requires a clean operand,
 //      and the operand is dirty, insert a CLEAN node.
 //      Resize operands to C++ 32/64/wide types.
+//      Arithmetic on clean operands whose values are small enough that the
+//      result can't carry past its width is also clean.
 //      Copy all width() values to widthMin() so RANGE, etc can still see orig widths
 //
 //*************************************************************************
@@ -45,9 +47,11 @@ private:
     //  AstNode::user()         -> CleanState.  For this node, 0==UNKNOWN
     //  AstNode::user2()        -> bool.  True indicates widthMin has been propagated
     //  AstNodeDType::user3()   -> AstNodeDType*.  Alternative node with C size
+    //  AstNodeExpr::user4()    -> int.  valueBits() plus one, 0==not yet computed
     const VNUser1InUse m_inuser1;
     const VNUser2InUse m_inuser2;
     const VNUser3InUse m_inuser3;
+    const VNUser4InUse m_inuser4;
 
     // TYPES
     enum CleanState : uint8_t { CS_UNKNOWN, CS_CLEAN, CS_DIRTY };
@@ -123,6 +127,42 @@ private:
         setCleanState(nodep, ((isClean || wholeUint) ? CS_CLEAN : CS_DIRTY));
     }
 
+    // Number of low bits that may be set in the value of a clean expression
+    int valueBits(AstNodeExpr* nodep) {
+        if (!nodep->user4()) {
+            nodep->user4(std::min(computeValueBits(nodep), nodep->widthMin()) + 1);
+        }
+        return nodep->user4() - 1;
+    }
+    int computeValueBits(AstNodeExpr* nodep) {
+        if (const AstConst* const constp = VN_CAST(nodep, Const)) {
+            if (!constp->num().isFourState()) return constp->num().mostSetBitP1();
+        } else if (const AstExtend* const extendp = VN_CAST(nodep, Extend)) {
+            return valueBits(extendp->lhsp());
+        } else if (const AstAnd* const andp = VN_CAST(nodep, And)) {
+            // Either clean operand bounds the result
+            int bits = nodep->widthMin();
+            if (isClean(andp->lhsp())) bits = std::min(bits, valueBits(andp->lhsp()));
+            if (isClean(andp->rhsp())) bits = std::min(bits, valueBits(andp->rhsp()));
+            return bits;
+        } else if (const AstAdd* const addp = VN_CAST(nodep, Add)) {
+            if (isClean(addp->lhsp()) && isClean(addp->rhsp())) {
+                return std::max(valueBits(addp->lhsp()), valueBits(addp->rhsp())) + 1;
+            }
+        } else if (const AstMul* const mulp = VN_CAST(nodep, Mul)) {
+            return valueBits(mulp->lhsp()) + valueBits(mulp->rhsp());
+        } else if (const AstShiftL* const shiftp = VN_CAST(nodep, ShiftL)) {
+            const AstConst* const amountp = VN_CAST(shiftp->rhsp(), Const);
+            if (isClean(shiftp->lhsp()) && amountp && !amountp->num().isFourState()
+                && amountp->num().mostSetBitP1() <= 16) {
+                return valueBits(shiftp->lhsp()) + amountp->num().toSInt();
+            }
+        }
+        return nodep->widthMin();
+    }
+    // Result can't carry past its width, so needs no masking
+    bool fitsWidth(AstNodeExpr* nodep) { return computeValueBits(nodep) <= nodep->widthMin(); }
+
     // Operate on nodes
     void insertClean(AstNodeExpr* nodep) {  // We'll insert ABOVE passed node
         UINFO(4, "  NeedClean " << nodep << endl);
@@ -198,6 +238,18 @@ private:
         operandBiop(nodep);
         setClean(nodep, isClean(nodep->lhsp()) || isClean(nodep->rhsp()));
     }
+    void visit(AstAdd* nodep) override {
+        operandBiop(nodep);
+        setClean(nodep, isClean(nodep->lhsp()) && isClean(nodep->rhsp()) && fitsWidth(nodep));
+    }
+    void visit(AstMul* nodep) override {
+        operandBiop(nodep);
+        setClean(nodep, fitsWidth(nodep));
+    }
+    void visit(AstShiftL* nodep) override {
+        operandBiop(nodep);
+        setClean(nodep, fitsWidth(nodep));
+    }
     void visit(AstXor* nodep) override {
         operandBiop(nodep);
         setClean(nodep, isClean(nodep->lhsp()) && isClean(nodep->rhsp()));
@@ -18,6 +18,7 @@
 // Top Scope:
 //   Check created ACTIVEs
 //      Compress adjacent ACTIVEs with same sensitivity list
+//      Guard runs of adjacent trigger checks with one check of all their triggers
 //      Form master _eval function
 //              Add around the SENTREE a (IF POSEDGE(..))
 //                      Add a __Vlast_{clock} for the comparison
@@ -35,8 +36,11 @@
 #include "V3Ast.h"
 #include "V3Global.h"
 #include "V3Sched.h"
+#include "V3Stats.h"
 
 #include <algorithm>
+#include <map>
+#include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
@@ -75,10 +79,13 @@ class ClockVisitor final : public VNVisitor {
 private:
     // STATE
     AstCFunc* m_evalp = nullptr;  // The '_eval' function
+    AstCFunc* m_evalClockp = nullptr;  // The '_eval_clock' function, if any
     AstScope* m_scopep = nullptr;  // Current scope
     AstSenTree* m_lastSenp = nullptr;  // Last sensitivity match, so we can detect duplicates.
     AstIf* m_lastIfp = nullptr;  // Last sensitivity if active to add more under
+    std::vector<AstIf*> m_activeIfps;  // All ifs made from actives, in tree order
     bool m_inSampled = false;  // True inside a sampled expression
+    VDouble0 m_statGuards;  // Statistic tracking
 
     // METHODS
 
@@ -106,6 +113,7 @@ private:
         // At the top of _eval, assign them
         AstAssign* const finalp = new AstAssign{flp, new AstVarRef{flp, newvscp, VAccess::WRITE},
                                                 new AstVarRef{flp, vscp, VAccess::READ}};
+        if (m_evalClockp) m_evalClockp->addInitsp(finalp->cloneTree(false));
         m_evalp->addInitsp(finalp);
         UINFO(4, "New Sampled: " << newvscp << endl);
         return newvscp;
@@ -120,21 +128,105 @@ private:
         m_lastSenp = nullptr;
         m_lastIfp = nullptr;
     }
+    // Gather the trigger bits tested by an active condition, per trigger word.
+    // Returns false if the condition is not a plain test of trigger vector bits.
+    static bool triggerBits(AstNodeExpr* nodep, AstVarScope*& vscpr,
+                            std::map<uint32_t, uint64_t>& masks) {
+        if (const AstOr* const orp = VN_CAST(nodep, Or)) {
+            return triggerBits(orp->lhsp(), vscpr, masks) && triggerBits(orp->rhsp(), vscpr, masks);
+        }
+        const AstAnd* const andp = VN_CAST(nodep, And);
+        if (!andp) return false;
+        const AstConst* const maskp = VN_CAST(andp->lhsp(), Const);
+        const AstCMethodHard* const callp = VN_CAST(andp->rhsp(), CMethodHard);
+        if (!maskp || !callp || callp->name() != "word") return false;
+        const AstVarRef* const refp = VN_CAST(callp->fromp(), VarRef);
+        const AstConst* const indexp = VN_CAST(callp->pinsp(), Const);
+        if (!refp || !indexp || (vscpr && refp->varScopep() != vscpr)) return false;
+        vscpr = refp->varScopep();
+        masks[indexp->toUInt()] |= maskp->toUQuad();
+        return true;
+    }
+    // With many domains most trigger checks in eval are false, so wrap runs of adjacent
+    // active ifs in a single if testing all their trigger bits at once
+    void guardActiveIfs() {
+        constexpr size_t MIN_RUN = 4;  // Shorter runs are not worth an extra check
+        constexpr size_t MAX_RUN = 64;  // Bound the work done when any trigger in a run is set
+        for (size_t i = 0; i < m_activeIfps.size();) {
+            AstVarScope* vscp = nullptr;
+            std::map<uint32_t, uint64_t> masks;  // Trigger word index -> bits tested in run
+            size_t j = i;
+            while (j < m_activeIfps.size() && j - i < MAX_RUN
+                   && (j == i || m_activeIfps[j - 1]->nextp() == m_activeIfps[j])) {
+                AstVarScope* runVscp = vscp;
+                std::map<uint32_t, uint64_t> runMasks = masks;
+                if (!triggerBits(m_activeIfps[j]->condp(), runVscp, runMasks)) break;
+                vscp = runVscp;
+                masks.swap(runMasks);
+                ++j;
+            }
+            const size_t count = j - i;
+            // Only worth it if the guard is much cheaper than the checks it skips
+            if (count >= MIN_RUN && masks.size() * 2 <= count) {
+                AstIf* const firstp = m_activeIfps[i];
+                FileLine* const flp = firstp->fileline();
+                AstNodeExpr* guardp = nullptr;
+                for (const auto& pair : masks) {
+                    AstCMethodHard* const callp
+                        = new AstCMethodHard{flp, new AstVarRef{flp, vscp, VAccess::READ},
+                                             "word", new AstConst{flp, pair.first}};
+                    callp->dtypeSetUInt64();
+                    callp->pure(true);
+                    AstNodeExpr* const termp = new AstAnd{
+                        flp, new AstConst{flp, AstConst::Unsized64{}, pair.second}, callp};
+                    guardp = guardp ? new AstOr{flp, guardp, termp} : termp;
+                }
+                AstIf* const guardIfp = new AstIf{flp, guardp};
+                ++m_statGuards;
+                firstp->addHereThisAsNext(guardIfp);
+                for (size_t k = i; k < j; ++k) {
+                    guardIfp->addThensp(m_activeIfps[k]->unlinkFrBack());
+                }
+            }
+            i = std::max(j, i + 1);
+        }
+    }
     // VISITORS
     void visit(AstCoverToggle* nodep) override {
         // nodep->dumpTree("-  ct: ");
         // COVERTOGGLE(INC, ORIG, CHANGE) ->
         //   IF(ORIG ^ CHANGE) { INC; CHANGE = ORIG; }
-        AstNode* const incp = nodep->incp()->unlinkFrBack();
+        // COVERTOGGLE(INC0 INC1..., ORIG, CHANGE) ->
+        //   IF(ORIG ^ CHANGE) {
+        //     IF(ORIG[0] ^ CHANGE[0]) INC0;
+        //     IF(ORIG[1] ^ CHANGE[1]) INC1;
+        //     ...
+        //     CHANGE = ORIG;
+        //   }
+        // so the common case of an unchanged signal is a single compare.
+        FileLine* const flp = nodep->fileline();
+        AstCoverInc* const incsp = nodep->incsp()->unlinkFrBackWithNext();
         AstNodeExpr* const origp = nodep->origp()->unlinkFrBack();
         AstNodeExpr* const changeWrp = nodep->changep()->unlinkFrBack();
         AstNodeExpr* const changeRdp = ConvertWriteRefsToRead::main(changeWrp->cloneTree(false));
-        AstIf* const newp
-            = new AstIf{nodep->fileline(), new AstXor{nodep->fileline(), origp, changeRdp}, incp};
+        AstIf* const newp = new AstIf{flp, new AstXor{flp, origp, changeRdp}};
+        if (!incsp->nextp()) {
+            newp->addThensp(incsp);
+        } else {
+            int bit = 0;
+            for (AstCoverInc *incp = incsp, *nextp; incp; incp = nextp, ++bit) {
+                nextp = VN_AS(incp->nextp(), CoverInc);
+                if (nextp) nextp->unlinkFrBackWithNext();
+                AstNodeExpr* const bitOrigp = new AstSel{flp, origp->cloneTree(false), bit, 1};
+                AstNodeExpr* const bitChangep
+                    = new AstSel{flp, changeRdp->cloneTree(false), bit, 1};
+                newp->addThensp(new AstIf{flp, new AstXor{flp, bitOrigp, bitChangep}, incp});
+            }
+        }
         // We could add another IF to detect posedges, and only increment if so.
         // It's another whole branch though versus a potential memory miss.
         // We'll go with the miss.
-        newp->addThensp(new AstAssign{nodep->fileline(), changeWrp, origp->cloneTree(false)});
+        newp->addThensp(new AstAssign{flp, changeWrp, origp->cloneTree(false)});
         nodep->replaceWith(newp);
         VL_DO_DANGLING(nodep->deleteTree(), nodep);
     }
@@ -157,6 +249,7 @@ private:
             // Make a new if statement
             m_lastIfp = makeActiveIf(m_lastSenp);
             relinker.relink(m_lastIfp);
+            m_activeIfps.push_back(m_lastIfp);
         } else {
             nodep->unlinkFrBack();
         }
@@ -213,9 +306,13 @@ public:
     // CONSTRUCTORS
     explicit ClockVisitor(AstNetlist* netlistp) {
         m_evalp = netlistp->evalp();
+        m_evalClockp = netlistp->evalClockp();
         iterate(netlistp);
+        guardActiveIfs();
+    }
+    ~ClockVisitor() override {
+        V3Stats::addStat("Optimizations, Clock trigger runs guarded", m_statGuards);
     }
-    ~ClockVisitor() override = default;
 };
 
 //######################################################################
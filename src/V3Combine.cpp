@@ -17,6 +17,10 @@
 //
 //      Combine identical CFuncs by retaining only a single copy
 //      Also drop empty CFuncs
+//      Combine CFuncs that are identical apart from which members of their
+//          own module they reference (e.g.: the same code in modules that only
+//          differ in parameter values), by making one of them a static
+//          function taking those members as reference arguments
 //*************************************************************************
 
 #include "config_build.h"
@@ -27,10 +31,14 @@
 #include "V3Ast.h"
 #include "V3AstUserAllocator.h"
 #include "V3DupFinder.h"
+#include "V3EmitCBase.h"
 #include "V3Global.h"
 #include "V3Stats.h"
 
 #include <list>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -46,6 +54,7 @@ class CombineVisitor final : VNVisitor {
 
     // TYPES
     using funcit_t = std::list<AstCFunc*>::iterator;
+    using VarMap = std::unordered_map<const AstVar*, AstVar*>;
     struct CFuncs {
         std::list<AstCFunc*> m_fast;
         std::list<AstCFunc*> m_slow;
@@ -57,6 +66,12 @@ class CombineVisitor final : VNVisitor {
     AstNodeModule* m_modp = nullptr;  // Current module
     const V3Hasher m_hasher;  // For hashing
     VDouble0 m_cfuncsCombined;  // Statistic tracking
+    VDouble0 m_cfuncsGeneralized;  // Statistic tracking
+
+    // Functions smaller than this are not worth the overhead of passing the arguments
+    static constexpr size_t GENERALIZE_MIN_NODES = 20;
+    // Functions referencing more members than this are not generalized
+    static constexpr size_t GENERALIZE_MAX_ARGS = 16;
 
     // METHODS
 
@@ -102,10 +117,10 @@ class CombineVisitor final : VNVisitor {
             }
 
             while (true) {
-                auto dit = dupFinder.findDuplicate(funcp);
-                if (dit == dupFinder.end()) break;
+                AstNode* const dupp = dupFinder.findDuplicate(funcp);
+                if (!dupp) break;
 
-                AstCFunc* oldp = VN_AS(dit->second, CFunc);
+                AstCFunc* oldp = VN_AS(dupp, CFunc);
                 AstCFunc* newp = funcp;
                 UASSERT_OBJ(!oldp->user2(), oldp, "Should have been removed from dupFinder");
 
@@ -153,6 +168,211 @@ class CombineVisitor final : VNVisitor {
         return replaced;
     }
 
+    // Generalizing functions over the members they reference
+
+    static bool isMemberRef(const AstVarRef* refp) { return refp->selfPointer() == "this"; }
+    static bool isAbsolute(const string& selfPointer) {
+        // References via the symbol table are valid in static functions given vlSymsp
+        return selfPointer.empty() || VString::startsWith(selfPointer, "(&");
+    }
+
+    // Member variables referenced by the function, in order of first reference, or empty
+    // if the function cannot be made static by passing these as arguments
+    std::vector<AstVar*> generalizableMembers(AstCFunc* funcp) {
+        std::vector<AstVar*> memberps;
+        if (funcp->dontCombine() || funcp->isStatic() || !funcp->isLoose() || funcp->argsp()
+            || !funcp->argTypes().empty() || funcp->rtnTypeVoid() != "void"
+            || funcp->isConstructor() || funcp->isDestructor() || funcp->isVirtual()
+            || funcp->funcPublic() || funcp->isCoroutine() || funcp->dpiExportImpl()
+            || funcp->dpiImportWrapper() || funcp->dpiImportPrototype()
+            || funcp->dpiExportDispatcher() || !funcp->ifdef().empty()
+            || m_callSites(funcp).empty()) {
+            return memberps;
+        }
+        // Callers must have a vlSymsp to pass on
+        for (AstCCall* const callp : m_callSites(funcp)) {
+            if (!callp->argTypes().empty()) return memberps;
+            const AstCFunc* const callerp = enclosingFunc(callp);
+            if (!callerp || callerp->isStatic() || !callerp->isLoose()) return memberps;
+        }
+        std::unordered_set<const AstVar*> seen;
+        size_t nodes = 0;
+        const bool bad = funcp->exists([&](const AstNode* nodep) {
+            ++nodes;
+            // Text might reference 'this' or 'vlSelf'. Calls are not allowed, so call sites
+            // are never in functions deleted as duplicates.
+            if (VN_IS(nodep, CStmt) || VN_IS(nodep, CExpr) || VN_IS(nodep, NodeText)
+                || VN_IS(nodep, ThisRef) || VN_IS(nodep, NodeCCall)) {
+                return true;
+            }
+            if (const AstVarRef* const refp = VN_CAST(nodep, VarRef)) {
+                if (!isMemberRef(refp)) return !isAbsolute(refp->selfPointer());
+                AstVar* const varp = refp->varp();
+                if (varp->isSc() || varp->isParam() || varp->isStatic()) return true;
+                if (seen.insert(varp).second) memberps.push_back(varp);
+            }
+            return false;
+        });
+        if (bad || nodes < GENERALIZE_MIN_NODES || memberps.size() > GENERALIZE_MAX_ARGS) {
+            memberps.clear();
+        }
+        return memberps;
+    }
+    static const AstCFunc* enclosingFunc(const AstNode* nodep) {
+        const AstNode* abovep = nodep;
+        while (abovep && !VN_IS(abovep, CFunc)) abovep = abovep->backp();
+        if (!abovep) return nullptr;
+        // Class methods do not have vlSymsp
+        const AstNode* modp = abovep;
+        while (modp && !VN_IS(modp, NodeModule)) modp = modp->backp();
+        return VN_IS(modp, Module) ? VN_AS(abovep, CFunc) : nullptr;
+    }
+
+    // Hash of the shape of the function, ignoring which variables are referenced
+    static V3Hash shapeHash(const AstCFunc* funcp) {
+        V3Hash hash;
+        funcp->foreach([&](const AstNode* nodep) {
+            hash += static_cast<uint32_t>(nodep->type());
+            hash += nodep->width();
+        });
+        return hash;
+    }
+
+    // Map variable 'ap' of one function to variable 'bp' of another, return false if
+    // inconsistent with the mapping so far, or not interchangeable
+    static bool mapVar(const AstVar* ap, AstVar* bp, VarMap& varMap,
+                       std::unordered_set<const AstVar*>& mappedps) {
+        const auto it = varMap.find(ap);
+        if (it != varMap.end()) return it->second == bp;
+        if (mappedps.count(bp)) return false;
+        if (ap->isFuncLocal() != bp->isFuncLocal() || ap->varType() != bp->varType()
+            || ap->vlArgType(false, false, false) != bp->vlArgType(false, false, false)) {
+            return false;
+        }
+        varMap.emplace(ap, bp);
+        mappedps.insert(bp);
+        return true;
+    }
+    // Return true if the two lists of nodes are identical, apart from references to function
+    // locals and own members, which are mapped one to one in 'varMap'
+    static bool isomorphic(const AstNode* ap, AstNode* bp, VarMap& varMap,
+                           std::unordered_set<const AstVar*>& mappedps) {
+        for (; ap && bp; ap = ap->nextp(), bp = bp->nextp()) {
+            if (ap->type() != bp->type() || ap->dtypep() != bp->dtypep()) return false;
+            if (const AstVarRef* const arefp = VN_CAST(ap, VarRef)) {
+                AstVarRef* const brefp = VN_AS(bp, VarRef);
+                if (arefp->access() != brefp->access()) return false;
+                if (isMemberRef(arefp) != isMemberRef(brefp)) return false;
+                if (isMemberRef(arefp) || arefp->varp()->isFuncLocal()) {
+                    if (!mapVar(arefp->varp(), brefp->varp(), varMap, mappedps)) return false;
+                } else if (arefp->varp() != brefp->varp()
+                           || arefp->selfPointer() != brefp->selfPointer()) {
+                    return false;
+                }
+            } else if (const AstVar* const avarp = VN_CAST(ap, Var)) {
+                if (!mapVar(avarp, VN_AS(bp, Var), varMap, mappedps)) return false;
+            } else if (!ap->same(bp)) {
+                return false;
+            }
+            if (!isomorphic(ap->op1p(), bp->op1p(), varMap, mappedps)
+                || !isomorphic(ap->op2p(), bp->op2p(), varMap, mappedps)
+                || !isomorphic(ap->op3p(), bp->op3p(), varMap, mappedps)
+                || !isomorphic(ap->op4p(), bp->op4p(), varMap, mappedps)) {
+                return false;
+            }
+        }
+        return !ap && !bp;
+    }
+    static bool isomorphic(const AstCFunc* ap, AstCFunc* bp, VarMap& varMap) {
+        std::unordered_set<const AstVar*> mappedps;
+        return ap->slow() == bp->slow()
+               && isomorphic(ap->initsp(), bp->initsp(), varMap, mappedps)
+               && isomorphic(ap->stmtsp(), bp->stmtsp(), varMap, mappedps)
+               && isomorphic(ap->finalsp(), bp->finalsp(), varMap, mappedps);
+    }
+
+    // Make 'funcp' static, taking 'memberps' as arguments, and redirect calls of 'dupps'
+    void generalize(AstCFunc* funcp, const std::vector<AstVar*>& memberps,
+                    const std::vector<std::pair<AstCFunc*, VarMap>>& dupps) {
+        UINFO(4, "Generalizing " << funcp << endl);
+        // Replace the member references with references to the new arguments
+        std::unordered_map<const AstVar*, AstVar*> argps;
+        for (AstVar* const varp : memberps) {
+            AstVar* const argp = new AstVar{varp->fileline(), VVarType::BLOCKTEMP,
+                                            "__Varg_" + varp->name(), varp};
+            argp->funcLocal(true);
+            argp->direction(VDirection::INOUT);
+            funcp->addArgsp(argp);
+            argps.emplace(varp, argp);
+        }
+        funcp->foreach([&](AstVarRef* refp) {
+            if (!isMemberRef(refp)) return;
+            refp->varp(argps.at(refp->varp()));
+            refp->selfPointer("");
+        });
+        funcp->isStatic(true);
+        funcp->argTypes(EmitCBase::symClassVar());
+        // Pass the members of the instance being called
+        const auto redirectCalls = [&](AstCFunc* oldp, const VarMap* varMapp) {
+            for (AstCCall* const callp : m_callSites(oldp)) {
+                callp->funcp(funcp);
+                callp->argTypes("vlSymsp");
+                for (AstVar* const varp : memberps) {
+                    AstVar* const actualp = varMapp ? varMapp->at(varp) : varp;
+                    AstVarRef* const refp
+                        = new AstVarRef{callp->fileline(), actualp, VAccess::READWRITE};
+                    refp->selfPointer(callp->selfPointer());
+                    callp->addArgsp(refp);
+                }
+            }
+        };
+        redirectCalls(funcp, nullptr);
+        for (const auto& pair : dupps) {
+            UINFO(4, "   replacing " << pair.first << endl);
+            ++m_cfuncsGeneralized;
+            redirectCalls(pair.first, &pair.second);
+            VL_DO_DANGLING(pair.first->unlinkFrBack()->deleteTree(), pair.first);
+        }
+    }
+
+    void generalizePass(AstNetlist* netlistp) {
+        // Calls redirected by combinePass are not in the call site lists, so gather again
+        netlistp->foreach([&](AstCFunc* funcp) { m_callSites(funcp).clear(); });
+        netlistp->foreach([&](AstCCall* callp) {
+            if (!callp->funcp()->dontCombine()) m_callSites(callp->funcp()).push_back(callp);
+        });
+        // Gather candidates with the same shape, in order
+        std::map<uint32_t, std::vector<std::pair<AstCFunc*, std::vector<AstVar*>>>> candidates;
+        for (AstNode* modp = netlistp->modulesp(); modp; modp = modp->nextp()) {
+            if (!VN_IS(modp, Module)) continue;
+            for (AstNode* nodep = VN_AS(modp, Module)->stmtsp(); nodep; nodep = nodep->nextp()) {
+                AstCFunc* const funcp = VN_CAST(nodep, CFunc);
+                if (!funcp) continue;
+                std::vector<AstVar*> memberps = generalizableMembers(funcp);
+                if (memberps.empty()) continue;
+                candidates[shapeHash(funcp).value()].emplace_back(funcp, std::move(memberps));
+            }
+        }
+        // Combine each candidate with the later equivalent ones
+        for (auto& pair : candidates) {
+            auto& funcs = pair.second;
+            for (size_t i = 0; i < funcs.size(); ++i) {
+                AstCFunc* const funcp = funcs[i].first;
+                if (!funcp) continue;  // Already replaced
+                std::vector<std::pair<AstCFunc*, VarMap>> dupps;
+                for (size_t j = i + 1; j < funcs.size(); ++j) {
+                    AstCFunc* const otherp = funcs[j].first;
+                    if (!otherp || funcs[j].second.size() != funcs[i].second.size()) continue;
+                    VarMap varMap;
+                    if (!isomorphic(funcp, otherp, varMap)) continue;
+                    dupps.emplace_back(otherp, std::move(varMap));
+                    funcs[j].first = nullptr;
+                }
+                if (!dupps.empty()) generalize(funcp, funcs[i].second, dupps);
+            }
+        }
+    }
+
     void process(AstNetlist* netlistp) {
         // First, remove empty functions. We need to do this separately, because removing
         // calls can change the hashes of the callers.
@@ -180,6 +400,9 @@ class CombineVisitor final : VNVisitor {
                 while (combinePass(funcps, dupFinder)) {}
             }
         }
+
+        // Combine functions differing only in the members they reference, across modules
+        generalizePass(netlistp);
     }
 
     // VISITORS
@@ -226,6 +449,7 @@ class CombineVisitor final : VNVisitor {
     explicit CombineVisitor(AstNetlist* nodep) { iterate(nodep); }
     ~CombineVisitor() override {
         V3Stats::addStat("Optimizations, Combined CFuncs", m_cfuncsCombined);
+        V3Stats::addStat("Optimizations, Combined CFuncs generalized", m_cfuncsGeneralized);
     }
 
 public:
@@ -22,10 +22,13 @@
 #include "V3Global.h"
 #include "V3String.h"
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
@@ -39,10 +42,35 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 template <typename T>
 class V3ConfigWildcardResolver final {
     using Map = std::map<const std::string, T>;
+    using Entry = typename Map::value_type;
+    // Literal prefix (text before first '*' or '?') to wildcard entries with that prefix
+    using PrefixIndex = std::unordered_map<std::string, std::vector<Entry*>>;
 
     mutable V3Mutex m_mutex;  // protects members
     Map m_mapWildcard VL_GUARDED_BY(m_mutex);  // Wildcard strings to entities
     Map m_mapResolved VL_GUARDED_BY(m_mutex);  // Resolved strings to converged entities
+    // Names known to match no wildcard
+    std::unordered_set<std::string> m_unresolved VL_GUARDED_BY(m_mutex);
+    PrefixIndex m_prefixIndex VL_GUARDED_BY(m_mutex);  // Index of m_mapWildcard
+    std::set<size_t> m_prefixLengths VL_GUARDED_BY(m_mutex);  // Prefix lengths in index
+    bool m_indexStale VL_GUARDED_BY(m_mutex) = false;  // m_prefixIndex needs rebuilding
+
+    // New wildcards may match names seen before
+    void wildcardsAdded() VL_REQUIRES(m_mutex) {
+        m_indexStale = true;
+        m_unresolved.clear();
+    }
+    void rebuildIndex() VL_REQUIRES(m_mutex) {
+        m_prefixIndex.clear();
+        m_prefixLengths.clear();
+        for (Entry& wildent : m_mapWildcard) {
+            const std::string prefix = wildent.first.substr(0, wildent.first.find_first_of("*?"));
+            m_prefixIndex[prefix].push_back(&wildent);
+            m_prefixLengths.insert(prefix.size());
+        }
+        m_indexStale = false;
+    }
+
 public:
     V3ConfigWildcardResolver() = default;
     ~V3ConfigWildcardResolver() = default;
@@ -54,13 +82,17 @@ public:
         V3LockGuard otherLock{other.m_mutex};
         for (const auto& itr : other.m_mapResolved) m_mapResolved[itr.first].update(itr.second);
         for (const auto& itr : other.m_mapWildcard) m_mapWildcard[itr.first].update(itr.second);
+        wildcardsAdded();
     }
 
     // Access and create a (wildcard) entity
     T& at(const string& name) VL_MT_SAFE_EXCLUDES(m_mutex) {
         V3LockGuard lock{m_mutex};
         // Don't store into wildcards if the name is not a wildcard string
-        return m_mapWildcard[name];
+        const size_t oldSize = m_mapWildcard.size();
+        T& entity = m_mapWildcard[name];
+        if (m_mapWildcard.size() != oldSize) wildcardsAdded();
+        return entity;
     }
     // Access an entity and resolve wildcards that match it
     T* resolve(const string& name) VL_MT_SAFE_EXCLUDES(m_mutex) {
@@ -69,24 +101,35 @@ public:
         auto it = m_mapResolved.find(name);
         if (VL_UNLIKELY(it != m_mapResolved.end())) return &it->second;
 
-        T* newp = nullptr;
-        // Cannot be resolved, create if matched
-
-        // Update this entity with all matches in the wildcards
-        for (const auto& wildent : m_mapWildcard) {
-            if (VString::wildmatch(name, wildent.first)) {
-                if (!newp) {
-                    newp = &m_mapResolved[name];  // Emplace and get pointer
-                }
-                newp->update(wildent.second);
+        if (m_unresolved.count(name)) return nullptr;
+        if (m_indexStale) rebuildIndex();
+
+        // Only wildcards whose literal prefix begins the name can match
+        std::vector<Entry*> candidates;
+        for (const size_t len : m_prefixLengths) {
+            if (len > name.size()) break;
+            const auto pit = m_prefixIndex.find(name.substr(0, len));
+            if (pit == m_prefixIndex.end()) continue;
+            for (Entry* const wildentp : pit->second) {
+                if (VString::wildmatch(name, wildentp->first)) candidates.push_back(wildentp);
             }
         }
+        if (candidates.empty()) {
+            m_unresolved.emplace(name);
+            return nullptr;
+        }
+        // Update this entity with all matches in the wildcards, in wildcard string order
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Entry* ap, const Entry* bp) { return ap->first < bp->first; });
+        T* const newp = &m_mapResolved[name];  // Emplace and get pointer
+        for (const Entry* const wildentp : candidates) newp->update(wildentp->second);
         return newp;
     }
     // Flush on update
     void flush() VL_MT_SAFE_EXCLUDES(m_mutex) {
         V3LockGuard lock{m_mutex};
         m_mapResolved.clear();
+        m_unresolved.clear();
     }
 };
 
@@ -133,6 +176,7 @@ class V3ConfigFTask final {
     bool m_isolate = false;  // Isolate function return
     bool m_noinline = false;  // Don't inline function/task
     bool m_public = false;  // Public function/task
+    string m_dpiGroup;  // DPI import resource group
 
 public:
     V3ConfigFTask() = default;
@@ -141,6 +185,7 @@ public:
         if (f.m_isolate) m_isolate = true;
         if (f.m_noinline) m_noinline = true;
         if (f.m_public) m_public = true;
+        if (!f.m_dpiGroup.empty()) m_dpiGroup = f.m_dpiGroup;
         m_vars.update(f.m_vars);
     }
 
@@ -149,8 +194,17 @@ public:
     void setIsolate(bool set) { m_isolate = set; }
     void setNoInline(bool set) { m_noinline = set; }
     void setPublic(bool set) { m_public = set; }
+    void setDpiGroup(const string& group) { m_dpiGroup = group; }
 
     void apply(AstNodeFTask* ftaskp) const {
+        if (!m_dpiGroup.empty()) {
+            if (ftaskp->dpiImport()) {
+                ftaskp->dpiGroup(m_dpiGroup);
+            } else {
+                ftaskp->v3error("dpi_group applies only to DPI imports, not "
+                                << ftaskp->prettyNameQ());
+            }
+        }
         if (m_noinline)
             ftaskp->addStmtsp(new AstPragma{ftaskp->fileline(), VPragmaType::NO_INLINE_TASK});
         if (m_public)
@@ -457,6 +511,8 @@ class V3ConfigResolver final {
     V3ConfigScopeTraceResolver m_scopeTraces;  // Regexp to trace enables
     std::unordered_map<string, std::unordered_map<string, uint64_t>>
         m_profileData;  // Access to profile_data records
+    std::unordered_map<string, std::unordered_map<string, V3ConfigProfileCFunc>>
+        m_profileCFuncs;  // Access to profile_data -cfunc records
     FileLine* m_profileFileLine = nullptr;
 
     V3ConfigResolver() = default;
@@ -483,6 +539,23 @@ public:
         if (it == mit->second.cend()) return 0;
         return it->second;
     }
+    void addProfileCFunc(FileLine* fl, const string& model, const string& cfunc, uint64_t cost,
+                         uint64_t calls) {
+        if (!m_profileFileLine) m_profileFileLine = fl;
+        V3ConfigProfileCFunc& data = m_profileCFuncs[model][cfunc];
+        data.m_cost += cost;
+        data.m_calls += calls;
+    }
+    bool hasProfileCFuncs(const string& model) const {
+        return m_profileCFuncs.find(model) != m_profileCFuncs.cend();
+    }
+    const V3ConfigProfileCFunc* getProfileCFunc(const string& model, const string& cfunc) const {
+        const auto mit = m_profileCFuncs.find(model);
+        if (mit == m_profileCFuncs.cend()) return nullptr;
+        const auto it = mit->second.find(cfunc);
+        if (it == mit->second.cend()) return nullptr;
+        return &it->second;
+    }
     FileLine* getProfileDataFileLine() const { return m_profileFileLine; }  // Maybe null
 };
 
@@ -518,6 +591,15 @@ void V3Config::addIgnore(V3ErrorCode code, bool on, const string& filename, int
     }
 }
 
+void V3Config::addDpiGroup(FileLine* fl, const string& module, const string& ftask,
+                           const string& group) {
+    if (ftask.empty()) {
+        fl->v3error("dpi_group requires -function or -task");
+    } else {
+        V3ConfigResolver::s().modules().at(module).ftasks().at(ftask).setDpiGroup(group);
+    }
+}
+
 void V3Config::addInline(FileLine* fl, const string& module, const string& ftask, bool on) {
     if (ftask.empty()) {
         V3ConfigResolver::s().modules().at(module).setInline(on);
@@ -539,6 +621,11 @@ void V3Config::addProfileData(FileLine* fl, const string& model, const string& k
     V3ConfigResolver::s().addProfileData(fl, model, key, cost);
 }
 
+void V3Config::addProfileCFunc(FileLine* fl, const string& model, const string& cfunc,
+                               uint64_t cost, uint64_t calls) {
+    V3ConfigResolver::s().addProfileCFunc(fl, model, cfunc, cost, calls);
+}
+
 void V3Config::addScopeTraceOn(bool on, const string& scope, int levels) {
     V3ConfigResolver::s().scopeTraces().addScopeTraceOn(on, scope, levels);
 }
@@ -646,6 +733,12 @@ void V3Config::applyVarAttr(AstNodeModule* modulep, AstNodeFTask* ftaskp, AstVar
 uint64_t V3Config::getProfileData(const string& model, const string& key) {
     return V3ConfigResolver::s().getProfileData(model, key);
 }
+bool V3Config::hasProfileCFuncs(const string& model) {
+    return V3ConfigResolver::s().hasProfileCFuncs(model);
+}
+const V3ConfigProfileCFunc* V3Config::getProfileCFunc(const string& model, const string& cfunc) {
+    return V3ConfigResolver::s().getProfileCFunc(model, cfunc);
+}
 FileLine* V3Config::getProfileDataFileLine() {
     return V3ConfigResolver::s().getProfileDataFileLine();
 }
@@ -27,6 +27,11 @@
 
 //######################################################################
 
+struct V3ConfigProfileCFunc final {
+    uint64_t m_cost = 0;  // Total time spent in function, including callees
+    uint64_t m_calls = 0;  // Number of calls
+};
+
 class V3Config final {
 public:
     static void addCaseFull(const string& file, int lineno);
@@ -34,10 +39,14 @@ public:
     static void addCoverageBlockOff(const string& file, int lineno);
     static void addCoverageBlockOff(const string& module, const string& blockname);
     static void addIgnore(V3ErrorCode code, bool on, const string& filename, int min, int max);
+    static void addDpiGroup(FileLine* fl, const string& module, const string& ftask,
+                            const string& group);
     static void addInline(FileLine* fl, const string& module, const string& ftask, bool on);
     static void addModulePragma(const string& module, VPragmaType pragma);
     static void addProfileData(FileLine* fl, const string& model, const string& key,
                                uint64_t cost);
+    static void addProfileCFunc(FileLine* fl, const string& model, const string& cfunc,
+                                uint64_t cost, uint64_t calls);
     static void addScopeTraceOn(bool on, const string& scope, int levels);
     static void addVarAttr(FileLine* fl, const string& module, const string& ftask,
                            const string& signal, VAttrType type, AstSenTree* nodep);
@@ -51,6 +60,8 @@ public:
     static void applyVarAttr(AstNodeModule* modulep, AstNodeFTask* ftaskp, AstVar* varp);
 
     static uint64_t getProfileData(const string& model, const string& key);
+    static bool hasProfileCFuncs(const string& model);
+    static const V3ConfigProfileCFunc* getProfileCFunc(const string& model, const string& cfunc);
     static FileLine* getProfileDataFileLine();
     static bool getScopeTraceOn(const string& scope);
     static bool waive(FileLine* filelinep, V3ErrorCode code, const string& message);
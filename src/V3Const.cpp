@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <memory>
 #include <type_traits>
+#include <unordered_map>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
@@ -905,6 +906,11 @@ private:
     const AstNode* m_scopep = nullptr;  // Current scope
     const AstAttrOf* m_attrp = nullptr;  // Current attribute
     VDouble0 m_statBitOpReduction;  // Ops reduced in ConstBitOpTreeVisitor
+    VDouble0 m_statFuncCacheHits;  // Constant function calls found in s_funcCache
+    VDouble0 m_statFuncCacheMisses;  // Constant function calls simulated, and cached
+    // Results of constant function calls, by function identity and argument values.
+    // Cleared by each global pass, as later passes may delete and reuse function nodes.
+    static std::unordered_map<std::string, V3Number> s_funcCache;
     const bool m_globalPass;  // ConstVisitor invoked as a global pass
     static uint32_t s_globalPassNum;  // Counts number of times ConstVisitor invoked as global pass
     V3UniqueNames m_concswapNames;  // For generating unique temporary variable names
@@ -2233,7 +2239,8 @@ private:
         if (debug() >= 9) newp->dumpTree("-       _new: ");
     }
 
-    void replaceWithSimulation(AstNode* nodep) {
+    AstNode* replaceWithSimulation(AstNode* nodep) {
+        // Returns replacement node, or nullptr if not a constant
         SimulateVisitor simvis;
         // Run it - may be unoptimizable due to large for loop, etc
         simvis.mainParamEmulate(nodep);
@@ -2245,6 +2252,7 @@ private:
                            << errorp->warnOther() << "... Location of non-constant "
                            << errorp->prettyTypeName() << ": " << simvis.whyNotMessage());
             VL_DO_DANGLING(replaceZero(nodep), nodep);
+            return nullptr;
         } else {
             // Fetch the result
             AstNode* const valuep = simvis.fetchValueNull(nodep);  // valuep is owned by Simulate
@@ -2256,7 +2264,33 @@ private:
             UINFO(4, "Simulate->" << newp << endl);
             nodep->replaceWith(newp);
             VL_DO_DANGLING(nodep->deleteTree(), nodep);
-        }
+            return newp;
+        }
+    }
+    static string funcCacheKey(const AstFuncRef* nodep) {
+        // Return key identifying the call's result, or "" if it must not be cached
+        const AstNodeFTask* const taskp = nodep->taskp();
+        if (!taskp || taskp->recursive()) return "";
+        // Only package functions; module functions may read parameters that differ per
+        // specialized module, and are deleted with unused specializations
+        const AstNode* upp = taskp->backp();
+        while (upp && !VN_IS(upp, NodeModule)) upp = upp->backp();
+        if (!VN_IS(upp, Package)) return "";
+        // $display must print on every call; and called functions may be edited separately
+        if (taskp->exists([](const AstNode* np) {  //
+                return VN_IS(np, Display) || VN_IS(np, NodeFTaskRef);
+            })) {
+            return "";
+        }
+        string key = cvtToHex(taskp);
+        key += "_" + cvtToStr(nodep->width()) + (nodep->isSigned() ? "s" : "u");
+        for (const AstNode* pinp = nodep->pinsp(); pinp; pinp = pinp->nextp()) {
+            const AstArg* const argp = VN_CAST(pinp, Arg);
+            const AstConst* const constp = argp ? VN_CAST(argp->exprp(), Const) : nullptr;
+            if (!constp) return "";
+            key += "_" + constp->num().ascii();
+        }
+        return key;
     }
 
     //----------------------------------------
@@ -3178,7 +3212,29 @@ private:
     void visit(AstFuncRef* nodep) override {
         iterateChildren(nodep);
         if (m_params) {  // Only parameters force us to do constant function call propagation
-            replaceWithSimulation(nodep);
+            // Packages often call the same function with the same arguments many times
+            const string key = funcCacheKey(nodep);
+            if (!key.empty()) {
+                const auto it = s_funcCache.find(key);
+                if (it != s_funcCache.end()) {
+                    ++m_statFuncCacheHits;
+                    AstConst* const newp = new AstConst{nodep->fileline(), it->second};
+                    newp->dtypeFrom(nodep);
+                    UINFO(4, "Simulate cached->" << newp << endl);
+                    nodep->replaceWith(newp);
+                    VL_DO_DANGLING(nodep->deleteTree(), nodep);
+                    return;
+                }
+            }
+            AstNode* const newp = replaceWithSimulation(nodep);
+            if (!key.empty()) {
+                if (const AstConst* const constp = VN_CAST(newp, Const)) {
+                    ++m_statFuncCacheMisses;
+                    V3Number num = constp->num();
+                    num.nodep(nullptr);
+                    s_funcCache.emplace(key, num);
+                }
+            }
         }
     }
     void visit(AstArg* nodep) override {
@@ -3663,6 +3719,7 @@ public:
     ConstVisitor(ProcMode pmode, bool globalPass)
         : m_globalPass{globalPass}
         , m_concswapNames{globalPass ? ("__Vconcswap_" + cvtToStr(s_globalPassNum++)) : ""} {
+        if (m_globalPass) s_funcCache.clear();
         // clang-format off
         switch (pmode) {
         case PROC_PARAMS:       m_doV = true;  m_doNConst = true; m_params = true;
@@ -3679,6 +3736,10 @@ public:
         // clang-format on
     }
     ~ConstVisitor() override {
+        if (m_params) {
+            V3Stats::addStatSum("Optimizations, Const func cache hits", m_statFuncCacheHits);
+            V3Stats::addStatSum("Optimizations, Const func cache misses", m_statFuncCacheMisses);
+        }
         if (m_doCpp) {
             if (m_globalPass) {
                 V3Stats::addStat("Optimizations, Const bit op reduction", m_statBitOpReduction);
@@ -3695,6 +3756,7 @@ public:
 };
 
 uint32_t ConstVisitor::s_globalPassNum = 0;
+std::unordered_map<std::string, V3Number> ConstVisitor::s_funcCache;
 
 //######################################################################
 // Const class functions
@@ -3798,10 +3860,25 @@ void V3Const::constifyAllLive(AstNetlist* nodep) {
 void V3Const::constifyAll(AstNetlist* nodep) {
     // Only call from Verilator.cpp, as it uses user#'s
     UINFO(2, __FUNCTION__ << ": " << endl);
-    {
-        ConstVisitor visitor{ConstVisitor::PROC_V_EXPENSIVE, /* globalPass: */ true};
-        (void)visitor.mainAcceptEdit(nodep);
-    }  // Destruct before checking
+    // Edit count and global phase when the last constifyAll completed. If nothing has been
+    // edited since, and the phase state that changes what folding is legal is the same, that
+    // pass already left the tree folded, so don't walk the whole netlist again.
+    static uint64_t s_doneEditCnt = 0;
+    static bool s_doneScoped = false;
+    static bool s_doneRemoveXs = false;
+    if (AstNode::editCountGbl() == s_doneEditCnt && v3Global.assertScoped() == s_doneScoped
+        && v3Global.constRemoveXs() == s_doneRemoveXs) {
+        UINFO(2, __FUNCTION__ << ": No edits since last sweep, skipping" << endl);
+        V3Stats::addStatSum("Optimizations, Const sweeps skipped", 1);
+    } else {
+        {
+            ConstVisitor visitor{ConstVisitor::PROC_V_EXPENSIVE, /* globalPass: */ true};
+            (void)visitor.mainAcceptEdit(nodep);
+        }  // Destruct before recording
+        s_doneEditCnt = AstNode::editCountGbl();
+        s_doneScoped = v3Global.assertScoped();
+        s_doneRemoveXs = v3Global.constRemoveXs();
+    }
     V3Global::dumpCheckGlobalTree("const", 0, dumpTreeLevel() >= 3);
 }
 
@@ -21,6 +21,11 @@
 //              (V3Emit reencodes into per-module numbers for emitting.)
 //              Insert a COVERINC node at the end of the statement list
 //              for that if/else/case.
+//      At each two-legged IF directly in a covered statement list,
+//         If nothing in the list can leave it early or suspend,
+//              The IF runs exactly once per count of the list, so
+//              remove the else's COVERINC, and derive its count
+//              when written as the list's count minus the if's count.
 //
 //*************************************************************************
 
@@ -31,6 +36,7 @@
 
 #include "V3Ast.h"
 #include "V3Global.h"
+#include "V3Stats.h"
 
 #include <map>
 #include <unordered_map>
@@ -76,7 +82,12 @@ private:
     // NODE STATE
     // Entire netlist:
     //  AstIf::user1()                  -> bool.  True indicates ifelse processed
+    //  AstCoverDecl::user1()           -> bool.  True indicates counts derived from this
+    //  AstIf::user2p()                 -> AstCoverInc*.  Increment of a branch's if
+    //  AstIf::user3p()                 -> AstCoverInc*.  Increment of a branch's else
     const VNUser1InUse m_inuser1;
+    const VNUser2InUse m_inuser2;
+    const VNUser3InUse m_inuser3;
 
     // STATE
     CheckState m_state;  // State save-restored on each new coverage scope/block
@@ -86,6 +97,7 @@ private:
     string m_beginHier;  // AstBegin hier name for user coverage points
     std::unordered_map<int, LinenoSet>
         m_handleLines;  // All line numbers for a given m_stateHandle
+    VDouble0 m_statDerived;  // Statistic tracking
 
     // METHODS
 
@@ -143,6 +155,45 @@ private:
         }
         return incp;
     }
+    // Node might leave its statement list before the list's increment, or suspend
+    static bool mayLeaveEarly(const AstNode* nodep) {
+        if (const AstNodeFTaskRef* const refp = VN_CAST(nodep, NodeFTaskRef)) {
+            return !VN_IS(refp->taskp(), Func);
+        }
+        return nodep->isTimingControl() || VN_IS(nodep, Fork) || VN_IS(nodep, WaitFork)
+               || VN_IS(nodep, Disable) || VN_IS(nodep, Return) || VN_IS(nodep, Break)
+               || VN_IS(nodep, Continue) || VN_IS(nodep, JumpGo) || VN_IS(nodep, JumpBlock)
+               || VN_IS(nodep, Stop);
+    }
+    // Each two-legged branch directly in the list ending with 'baseIncp' takes
+    // exactly one of its legs per count of the list, so count only its if.
+    void deriveBranches(AstNode* stmtsp, AstCoverInc* baseIncp) {
+        for (AstNode* stmtp = stmtsp; stmtp; stmtp = stmtp->nextp()) {
+            if (stmtp->exists([](const AstNode* np) { return mayLeaveEarly(np); })) return;
+        }
+        deriveBranchesIn(stmtsp, baseIncp->declp());
+    }
+    void deriveBranchesIn(AstNode* stmtsp, AstCoverDecl* baseDeclp) {
+        for (AstNode* stmtp = stmtsp; stmtp; stmtp = stmtp->nextp()) {
+            // A begin block's statements run as part of the enclosing list
+            if (AstBegin* const beginp = VN_CAST(stmtp, Begin)) {
+                deriveBranchesIn(beginp->stmtsp(), baseDeclp);
+                continue;
+            }
+            AstIf* const ifp = VN_CAST(stmtp, If);
+            if (!ifp || !ifp->user2p()) continue;
+            AstCoverDecl* const subDeclp = VN_AS(ifp->user2p(), CoverInc)->declp();
+            AstCoverInc* const elseIncp = VN_AS(ifp->user3p(), CoverInc);
+            // Can't derive counts from a derived count
+            if (elseIncp->declp()->user1()) continue;
+            UINFO(4, "   COVER-derived: " << elseIncp << endl);
+            elseIncp->declp()->derivedFrom(baseDeclp, subDeclp);
+            baseDeclp->user1(true);
+            subDeclp->user1(true);
+            VL_DO_DANGLING(elseIncp->unlinkFrBack()->deleteTree(), elseIncp);
+            ++m_statDerived;
+        }
+    }
     string traceNameForLine(AstNode* nodep, const string& type) {
         string name = "vlCoverageLineTrace_" + nodep->fileline()->filebasenameNoExt() + "__"
                       + cvtToStr(nodep->fileline()->lineno()) + "_" + type;
@@ -246,15 +297,18 @@ private:
             iterateChildren(nodep);
             if (m_state.lineCoverageOn(nodep)) {
                 lineTrack(nodep);
-                AstNode* const newp
+                AstCoverInc* const newp
                     = newCoverInc(nodep->fileline(), "", "v_line", "block",
                                   linesCov(m_state, nodep), 0, traceNameForLine(nodep, "block"));
                 if (AstNodeProcedure* const itemp = VN_CAST(nodep, NodeProcedure)) {
                     itemp->addStmtsp(newp);
+                    deriveBranches(itemp->stmtsp(), newp);
                 } else if (AstNodeFTask* const itemp = VN_CAST(nodep, NodeFTask)) {
                     itemp->addStmtsp(newp);
+                    deriveBranches(itemp->stmtsp(), newp);
                 } else if (AstWhile* const itemp = VN_CAST(nodep, While)) {
                     itemp->addStmtsp(newp);
+                    deriveBranches(itemp->stmtsp(), newp);
                 } else {
                     nodep->v3fatalSrc("Bad node type");
                 }
@@ -303,12 +357,14 @@ private:
         }
     }
 
-    void toggleVarBottom(const ToggleEnt& above, const AstVar* varp) {
-        AstCoverToggle* const newp = new AstCoverToggle{
-            varp->fileline(),
-            newCoverInc(varp->fileline(), "", "v_toggle", varp->name() + above.m_comment, "", 0,
-                        ""),
-            above.m_varRefp->cloneTree(true), above.m_chgRefp->cloneTree(true)};
+    AstCoverInc* newToggleInc(const AstVar* varp, const string& comment) {
+        return newCoverInc(varp->fileline(), "", "v_toggle", varp->name() + comment, "", 0, "");
+    }
+
+    void toggleVarBottom(const ToggleEnt& above, const AstVar* varp, AstCoverInc* incsp) {
+        AstCoverToggle* const newp
+            = new AstCoverToggle{varp->fileline(), incsp, above.m_varRefp->cloneTree(true),
+                                 above.m_chgRefp->cloneTree(true)};
         m_modp->addStmtsp(newp);
     }
 
@@ -316,20 +372,18 @@ private:
                           const ToggleEnt& above, AstVar* varp, AstVar* chgVarp) {  // Constant
         if (const AstBasicDType* const bdtypep = VN_CAST(dtypep, BasicDType)) {
             if (bdtypep->isRanged()) {
+                // One toggle for the whole vector with a point per bit, so V3Clock can skip
+                // all bits of an unchanged vector with a single compare
+                AstCoverInc* incsp = nullptr;
                 for (int index_docs = bdtypep->lo(); index_docs < bdtypep->hi() + 1;
                      ++index_docs) {
-                    const int index_code = index_docs - bdtypep->lo();
-                    ToggleEnt newent{above.m_comment + std::string{"["} + cvtToStr(index_docs)
-                                         + "]",
-                                     new AstSel{varp->fileline(), above.m_varRefp->cloneTree(true),
-                                                index_code, 1},
-                                     new AstSel{varp->fileline(), above.m_chgRefp->cloneTree(true),
-                                                index_code, 1}};
-                    toggleVarBottom(newent, varp);
-                    newent.cleanup();
+                    incsp = AstNode::addNext(
+                        incsp, newToggleInc(varp, above.m_comment + std::string{"["}
+                                                      + cvtToStr(index_docs) + "]"));
                 }
+                toggleVarBottom(above, varp, incsp);
             } else {
-                toggleVarBottom(above, varp);
+                toggleVarBottom(above, varp, newToggleInc(varp, above.m_comment));
             }
         } else if (const AstUnpackArrayDType* const adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
             for (int index_docs = adtypep->lo(); index_docs <= adtypep->hi(); ++index_docs) {
@@ -443,38 +497,51 @@ private:
                 // Normal if. Linecov shows what's inside the if (not condition that is
                 // always executed)
                 UINFO(4, "   COVER-branch: " << nodep << endl);
-                nodep->addThensp(newCoverInc(nodep->fileline(), "", "v_branch", "if",
-                                             linesCov(ifState, nodep), 0,
-                                             traceNameForLine(nodep, "if")));
+                AstCoverInc* const thenIncp
+                    = newCoverInc(nodep->fileline(), "", "v_branch", "if",
+                                  linesCov(ifState, nodep), 0, traceNameForLine(nodep, "if"));
+                nodep->addThensp(thenIncp);
+                deriveBranches(nodep->thensp(), thenIncp);
                 // The else has a column offset of 1 to uniquify it relative to the if
                 // As "if" and "else" are more than one character wide, this won't overlap
                 // another token
-                nodep->addElsesp(newCoverInc(nodep->fileline(), "", "v_branch", "else",
-                                             linesCov(elseState, nodep), 1,
-                                             traceNameForLine(nodep, "else")));
+                AstCoverInc* const elseIncp
+                    = newCoverInc(nodep->fileline(), "", "v_branch", "else",
+                                  linesCov(elseState, nodep), 1, traceNameForLine(nodep, "else"));
+                nodep->addElsesp(elseIncp);
+                deriveBranches(nodep->elsesp(), elseIncp);
+                // The enclosing list's increment may later derive the else's count
+                nodep->user2p(thenIncp);
+                nodep->user3p(elseIncp);
             }
             // If/else attributes to each block as non-branch coverage
             else if (first_elsif || cont_elsif) {
                 UINFO(4, "   COVER-elsif: " << nodep << endl);
                 if (ifState.lineCoverageOn(nodep)) {
-                    nodep->addThensp(newCoverInc(nodep->fileline(), "", "v_line", "elsif",
-                                                 linesCov(ifState, nodep), 0,
-                                                 traceNameForLine(nodep, "elsif")));
+                    AstCoverInc* const incp = newCoverInc(nodep->fileline(), "", "v_line", "elsif",
+                                                          linesCov(ifState, nodep), 0,
+                                                          traceNameForLine(nodep, "elsif"));
+                    nodep->addThensp(incp);
+                    deriveBranches(nodep->thensp(), incp);
                 }
                 // and we don't insert the else as the child if-else will do so
             } else {
                 // Cover as separate blocks (not a branch as is not two-legged)
                 if (ifState.lineCoverageOn(nodep)) {
                     UINFO(4, "   COVER-half-if: " << nodep << endl);
-                    nodep->addThensp(newCoverInc(nodep->fileline(), "", "v_line", "if",
-                                                 linesCov(ifState, nodep), 0,
-                                                 traceNameForLine(nodep, "if")));
+                    AstCoverInc* const incp
+                        = newCoverInc(nodep->fileline(), "", "v_line", "if",
+                                      linesCov(ifState, nodep), 0, traceNameForLine(nodep, "if"));
+                    nodep->addThensp(incp);
+                    deriveBranches(nodep->thensp(), incp);
                 }
                 if (elseState.lineCoverageOn(nodep)) {
                     UINFO(4, "   COVER-half-el: " << nodep << endl);
-                    nodep->addElsesp(newCoverInc(nodep->fileline(), "", "v_line", "else",
-                                                 linesCov(elseState, nodep), 1,
-                                                 traceNameForLine(nodep, "else")));
+                    AstCoverInc* const incp = newCoverInc(nodep->fileline(), "", "v_line", "else",
+                                                          linesCov(elseState, nodep), 1,
+                                                          traceNameForLine(nodep, "else"));
+                    nodep->addElsesp(incp);
+                    deriveBranches(nodep->elsesp(), incp);
                 }
             }
             m_state = lastState;
@@ -493,9 +560,11 @@ private:
                 if (m_state.lineCoverageOn(nodep)) {  // if the case body didn't disable it
                     lineTrack(nodep);
                     UINFO(4, "   COVER: " << nodep << endl);
-                    nodep->addStmtsp(newCoverInc(nodep->fileline(), "", "v_line", "case",
-                                                 linesCov(m_state, nodep), 0,
-                                                 traceNameForLine(nodep, "case")));
+                    AstCoverInc* const incp
+                        = newCoverInc(nodep->fileline(), "", "v_line", "case",
+                                      linesCov(m_state, nodep), 0, traceNameForLine(nodep, "case"));
+                    nodep->addStmtsp(incp);
+                    deriveBranches(nodep->stmtsp(), incp);
                 }
             }
         }
@@ -558,7 +627,9 @@ private:
 public:
     // CONSTRUCTORS
     explicit CoverageVisitor(AstNetlist* rootp) { iterateChildren(rootp); }
-    ~CoverageVisitor() override = default;
+    ~CoverageVisitor() override {
+        V3Stats::addStat("Coverage, derived branch points", m_statDerived);
+    }
 };
 
 //######################################################################
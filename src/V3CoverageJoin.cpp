@@ -59,30 +59,34 @@ private:
                 // This prevents making chains where a->b, then c->d, then b->c, as we'll
                 // find a->b, a->c, a->d directly.
                 while (true) {
-                    const auto dupit = dupFinder.findDuplicate(nodep->origp());
-                    if (dupit == dupFinder.end()) break;
-                    //
-                    const AstNode* const duporigp = dupit->second;
+                    AstNode* const duporigp = dupFinder.findDuplicate(nodep->origp());
+                    if (!duporigp) break;
                     // Note hashed will point to the original variable (what's
                     // duplicated), not the covertoggle, but we need to get back to the
                     // covertoggle which is immediately above, so:
                     AstCoverToggle* const removep = VN_AS(duporigp->backp(), CoverToggle);
                     UASSERT_OBJ(removep, nodep, "CoverageJoin duplicate of wrong type");
-                    UINFO(8, "  Orig " << nodep << " -->> " << nodep->incp()->declp() << endl);
-                    UINFO(8, "   dup " << removep << " -->> " << removep->incp()->declp() << endl);
-                    // The CoverDecl the duplicate pointed to now needs to point to the
-                    // original's data. I.e. the duplicate will get the coverage number
-                    // from the non-duplicate
-                    AstCoverDecl* const datadeclp = nodep->incp()->declp()->dataDeclThisp();
-                    removep->incp()->declp()->dataDeclp(datadeclp);
-                    UINFO(8, "   new " << removep->incp()->declp() << endl);
+                    UINFO(8, "  Orig " << nodep << " -->> " << nodep->incsp()->declp() << endl);
+                    UINFO(8, "   dup " << removep << " -->> " << removep->incsp()->declp()
+                                       << endl);
+                    // The CoverDecls the duplicate pointed to now need to point to the
+                    // original's data. I.e. the duplicate will get the coverage numbers
+                    // from the non-duplicate. Same signal, so same number of points.
+                    AstCoverInc* incp = nodep->incsp();
+                    AstCoverInc* dupIncp = removep->incsp();
+                    for (; incp && dupIncp; incp = VN_AS(incp->nextp(), CoverInc),
+                                            dupIncp = VN_AS(dupIncp->nextp(), CoverInc)) {
+                        dupIncp->declp()->dataDeclp(incp->declp()->dataDeclThisp());
+                        ++m_statToggleJoins;
+                    }
+                    UASSERT_OBJ(!incp && !dupIncp, removep, "Toggle points mismatch");
+                    UINFO(8, "   new " << removep->incsp()->declp() << endl);
                     // Mark the found node as a duplicate of the first node
-                    // (Not vice-versa as we have the iterator for the found node)
+                    // (Not vice-versa as we have the found node)
                     removep->unlinkFrBack();
                     VL_DO_DANGLING(pushDeletep(removep), removep);
                     // Remove node from comparison so don't hit it again
-                    dupFinder.erase(dupit);
-                    ++m_statToggleJoins;
+                    dupFinder.erase(duporigp);
                 }
             }
         }
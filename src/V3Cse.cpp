@@ -0,0 +1,305 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Common subexpression elimination in C functions
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+// V3Cse's Transformations:
+//
+//  After scheduling, the logic of many always blocks ends up as a single
+//  statement list in one eval region function. Different blocks often
+//  recompute the same pure expression, such as an opcode field decode, and
+//  the C compiler cannot always prove the operands are unchanged in between.
+//
+//  For each statement list of each AstCFunc, walk the statements in order,
+//  and remember the pure subexpressions on the right hand side of
+//  assignments and in the conditions of 'if' statements:
+//      lhs0 = (a[6:0] == 7'h33) & b;
+//      ...
+//      if (a[6:0] == 7'h33) ...
+//
+//  When a remembered expression appears again before any of the variables
+//  it reads is written, it is hoisted into a temporary just before its first
+//  occurrence, and both occurrences read the temporary instead:
+//      __Vcse = a[6:0] == 7'h33;
+//      lhs0 = __Vcse & b;
+//      ...
+//      if (__Vcse) ...
+//
+//  Operands evaluated only conditionally, such as the branches of a ?: or the
+//  right hand side of &&, may reuse an earlier temporary, but never become
+//  candidates themselves, as hoisting them would evaluate them unconditionally,
+//  e.g. an array read outside its bounds check.
+//
+//  Calls, and other statements with side effects we cannot see, forget all
+//  remembered expressions. To bound the live range of the temporaries, an
+//  expression is only reused within a limited number of statements of its
+//  first occurrence.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3Cse.h"
+
+#include "V3Ast.h"
+#include "V3DupFinder.h"
+#include "V3Global.h"
+#include "V3Hasher.h"
+#include "V3Stats.h"
+#include "V3UniqueNames.h"
+
+#include <unordered_map>
+#include <vector>
+
+VL_DEFINE_DEBUG_FUNCTIONS;
+
+namespace {
+
+// Maximum number of statements between the first and a later occurrence of an expression.
+// This bounds the live range of the temporaries, keeping register pressure in check.
+constexpr int CSE_MAX_DISTANCE = 64;
+// Minimum number of operations in an expression worth holding in a temporary
+constexpr int CSE_MIN_OPS = 2;
+
+//######################################################################
+
+class CseVisitor final : public VNVisitor {
+    // NODE STATE
+    //  AstNodeExpr::user1p()   -> AstVar*. Temporary holding the value of this candidate
+    //  AstNodeExpr::user2p()   -> AstNode*. Statement containing this candidate
+    //  AstNodeExpr::user3()    -> int. Position of that statement in its list
+    //  AstNode::user4()        -> Used by V3Hasher
+    const VNUser1InUse m_user1InUse;
+    const VNUser2InUse m_user2InUse;
+    const VNUser3InUse m_user3InUse;
+
+    // TYPES
+    // Candidates available in the statement list being processed
+    struct ListState final {
+        V3DupFinder m_dupFinder;  // Candidate expressions still valid
+        // Candidates reading each variable, to forget them when the variable is written
+        std::unordered_map<const AstVar*, std::vector<AstNodeExpr*>> m_readers;
+        int m_position = 0;  // Position of the current statement
+        explicit ListState(const V3Hasher& hasher)
+            : m_dupFinder{hasher} {}
+    };
+
+    // Rejects candidates first seen too far back
+    class DistanceCheck final : public V3DupFinderUserSame {
+        const int m_position;  // Position of the current statement
+    public:
+        explicit DistanceCheck(int position)
+            : m_position{position} {}
+        bool isSame(AstNode*, AstNode* node2p) override {
+            return m_position - node2p->user3() <= CSE_MAX_DISTANCE;
+        }
+    };
+
+    // STATE
+    const V3Hasher m_hasher;  // Hasher shared by all candidate sets
+    V3UniqueNames m_tempNames{"__Vcse"};  // For generating unique temporary variable names
+    AstCFunc* m_cfuncp = nullptr;  // Current function
+    ListState* m_listp = nullptr;  // Candidates of current statement list
+    AstNode* m_stmtp = nullptr;  // Current statement
+    bool m_conditional = false;  // Under an operand that is only evaluated conditionally
+
+    VDouble0 m_statHoisted;  // Statistic tracking
+    VDouble0 m_statReplaced;  // Statistic tracking
+
+    // METHODS
+
+    // Node might have effects, or depend on state, not visible as variable references
+    static bool isBarrier(const AstNode* nodep) {
+        return !nodep->isPure() || VN_IS(nodep, NodeCCall) || VN_IS(nodep, CMethodHard)
+               || VN_IS(nodep, CExpr) || VN_IS(nodep, CStmt) || VN_IS(nodep, ExprStmt)
+               || VN_IS(nodep, MemberSel) || VN_IS(nodep, JumpBlock) || VN_IS(nodep, JumpGo)
+               || VN_IS(nodep, JumpLabel);
+    }
+
+    // Value of this type can be held in a cheap local temporary
+    static bool isTempType(const AstNodeExpr* nodep) {
+        const AstNodeDType* const dtypep = nodep->dtypep();
+        if (!dtypep) return false;
+        const AstBasicDType* const basicp = VN_CAST(dtypep->skipRefp(), BasicDType);
+        return basicp && !basicp->isOpaque() && !nodep->isWide() && !nodep->isString();
+    }
+
+    void forgetAll() {
+        m_listp->m_dupFinder.clear();
+        m_listp->m_readers.clear();
+    }
+
+    void forgetReaders(const AstVar* varp) {
+        const auto it = m_listp->m_readers.find(varp);
+        if (it == m_listp->m_readers.end()) return;
+        for (AstNodeExpr* const exprp : it->second) m_listp->m_dupFinder.erase(exprp);
+        m_listp->m_readers.erase(it);
+    }
+
+    void addCandidate(AstNodeExpr* nodep) {
+        m_hasher.rehash(nodep);
+        m_listp->m_dupFinder.insert(nodep);
+        nodep->user2p(m_stmtp);
+        nodep->user3(m_listp->m_position);
+        nodep->foreach([&](const AstVarRef* refp) {
+            m_listp->m_readers[refp->varp()].push_back(nodep);
+        });
+    }
+
+    // Replace 'nodep' with a reference to the temporary holding 'candp'
+    void replaceWithTemp(AstNodeExpr* candp, AstNodeExpr* nodep) {
+        AstVar* varp = VN_AS(candp->user1p(), Var);
+        if (!varp) {
+            FileLine* const flp = candp->fileline();
+            varp = new AstVar{flp, VVarType::STMTTEMP, m_tempNames.get(candp), candp->dtypep()};
+            varp->noSubst(true);
+            m_cfuncp->addInitsp(varp);
+            // Put assignment before the statement of the first occurrence
+            AstNode* const stmtp = candp->user2p();
+            candp->replaceWith(new AstVarRef{flp, varp, VAccess::READ});
+            AstAssign* const assignp
+                = new AstAssign{flp, new AstVarRef{flp, varp, VAccess::WRITE}, candp};
+            stmtp->addHereThisAsNext(assignp);
+            // Candidates within the hoisted expression are now in the new statement
+            candp->foreach([&](AstNodeExpr* exprp) {
+                if (exprp->user2p() == stmtp) exprp->user2p(assignp);
+            });
+            candp->user1p(varp);
+            ++m_statHoisted;
+        }
+        nodep->replaceWith(new AstVarRef{nodep->fileline(), varp, VAccess::READ});
+        VL_DO_DANGLING(pushDeletep(nodep), nodep);
+        ++m_statReplaced;
+    }
+
+    // Replace repeated candidates under 'nodep', then add it and its subexpressions as
+    // candidates. Returns number of operations in 'nodep', or -1 if it cannot be a candidate.
+    int processExpr(AstNodeExpr* nodep) {
+        if (isBarrier(nodep)) return -1;
+        if (VN_IS(nodep, VarRef) || VN_IS(nodep, Const)) return 0;
+        // Largest repeated expression wins, so try to match before descending
+        if (isTempType(nodep)) {
+            DistanceCheck check{m_listp->m_position};
+            if (AstNode* const dupp = m_listp->m_dupFinder.findDuplicate(nodep, &check)) {
+                replaceWithTemp(VN_AS(dupp, NodeExpr), nodep);
+                return 0;
+            }
+        }
+        bool pure = true;
+        int ops = 1;
+        const auto processOperand = [&](AstNode* opp, bool conditional) {
+            VL_RESTORER(m_conditional);
+            m_conditional |= conditional;
+            for (AstNode *childp = opp, *nextp; childp; childp = nextp) {
+                nextp = childp->nextp();
+                AstNodeExpr* const exprp = VN_CAST(childp, NodeExpr);
+                const int childOps = exprp ? processExpr(exprp) : -1;
+                if (childOps < 0) {
+                    pure = false;
+                } else {
+                    ops += childOps;
+                }
+            }
+        };
+        // Branches of ?:, and right hand side of short-circuiting operators
+        const bool condOps = VN_IS(nodep, NodeCond);
+        const bool condRhs = VN_IS(nodep, LogAnd) || VN_IS(nodep, LogOr) || VN_IS(nodep, LogIf);
+        processOperand(nodep->op1p(), false);
+        processOperand(nodep->op2p(), condOps || condRhs);
+        processOperand(nodep->op3p(), condOps);
+        processOperand(nodep->op4p(), false);
+        if (!pure) return -1;
+        if (ops >= CSE_MIN_OPS && isTempType(nodep) && !m_conditional) addCandidate(nodep);
+        return ops;
+    }
+
+    void processList(AstNode* firstp) {
+        VL_RESTORER(m_listp);
+        ListState listState{m_hasher};
+        m_listp = &listState;
+        for (AstNode *stmtp = firstp, *nextp; stmtp; stmtp = nextp) {
+            nextp = stmtp->nextp();
+            ++listState.m_position;
+            processStmt(stmtp);
+        }
+    }
+
+    void processStmt(AstNode* stmtp) {
+        VL_RESTORER(m_stmtp);
+        m_stmtp = stmtp;
+        // Expressions evaluated before the statement has any effect
+        AstNodeExpr* exprp = nullptr;
+        if (AstAssign* const assignp = VN_CAST(stmtp, Assign)) {
+            exprp = assignp->rhsp();
+        } else if (AstIf* const ifp = VN_CAST(stmtp, If)) {
+            exprp = ifp->condp();
+        }
+        if (exprp) {
+            if (exprp->exists([](const AstNode* np) { return isBarrier(np); })) {
+                forgetAll();
+            } else {
+                processExpr(exprp);
+            }
+        }
+        // Branches start with no candidates of their own
+        if (AstIf* const ifp = VN_CAST(stmtp, If)) {
+            if (ifp->thensp()) processList(ifp->thensp());
+            if (ifp->elsesp()) processList(ifp->elsesp());
+        } else if (AstWhile* const whilep = VN_CAST(stmtp, While)) {
+            if (whilep->stmtsp()) processList(whilep->stmtsp());
+        }
+        // Forget candidates made stale by the statement
+        if (stmtp->exists([](const AstNode* np) { return isBarrier(np); })) {
+            forgetAll();
+            return;
+        }
+        stmtp->foreach([&](const AstVarRef* refp) {
+            if (refp->access().isWriteOrRW()) forgetReaders(refp->varp());
+        });
+    }
+
+    // VISITORS
+    void visit(AstCFunc* nodep) override {
+        // Arguments might alias other variables, so leave functions with arguments alone
+        if (nodep->argsp()) return;
+        VL_RESTORER(m_cfuncp);
+        m_cfuncp = nodep;
+        m_tempNames.reset();
+        if (nodep->stmtsp()) processList(nodep->stmtsp());
+    }
+
+    // For speed, only iterate what is necessary.
+    void visit(AstNetlist* nodep) override { iterateAndNextNull(nodep->modulesp()); }
+    void visit(AstNodeModule* nodep) override { iterateAndNextNull(nodep->stmtsp()); }
+    void visit(AstNode* nodep) override {}
+
+public:
+    // CONSTRUCTORS
+    explicit CseVisitor(AstNetlist* nodep) { iterate(nodep); }
+    ~CseVisitor() override {
+        V3Stats::addStat("Optimizations, CSE temporaries", m_statHoisted);
+        V3Stats::addStat("Optimizations, CSE expressions replaced", m_statReplaced);
+    }
+};
+
+}  // namespace
+
+//######################################################################
+// Cse class functions
+
+void V3Cse::cseAll(AstNetlist* nodep) {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    { CseVisitor{nodep}; }
+    V3Global::dumpCheckGlobalTree("cse", 0, dumpTreeLevel() >= 3);
+}
@@ -46,6 +46,14 @@
 //      ...
 //      ASSIGNW (BITSEL(ARRAYSEL(VARREF(x), __Vdlyvdim_x), __Vdlyvlsb_x), __Vdlyvval_x)
 //
+// Memories with whole element delayed assignments inside loops, or from many
+// places, instead use a commit queue of pending writes:
+// ASSIGNDLY (ARRAYSEL (VARREF(v), index), rhs)
+// ->   VAR __VdlyCommitQueue__x
+//      __VdlyCommitQueue__x.enqueue(rhs, index)
+//      ...
+//      __VdlyCommitQueue__x.commit(x)
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -60,9 +68,86 @@
 #include <algorithm>
 #include <deque>
 #include <map>
+#include <unordered_set>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
+// Minimum number of delayed assignments to a memory to commit them through a queue
+constexpr int DELAYED_QUEUE_MIN_SITES = 8;
+
+//######################################################################
+// Find memories with delayed assignments better committed through a queue
+
+class DelayedQueueVisitor final : public VNVisitorConst {
+private:
+    // TYPES
+    struct MemUsage final {
+        int m_sites = 0;  // Number of delayed assignments to whole elements
+        bool m_inLoop = false;  // Some of the delayed assignments are inside loops
+        bool m_other = false;  // Some of the delayed assignments cannot be queued
+    };
+
+    // STATE
+    std::unordered_map<const AstVarScope*, MemUsage> m_usage;  // Usage of each memory
+    bool m_inLoop = false;  // True in loops
+    bool m_inSuspendableOrFork = false;  // True in suspendable processes and forks
+
+    // VISITORS
+    void visit(AstNodeProcedure* nodep) override {
+        VL_RESTORER(m_inSuspendableOrFork);
+        m_inSuspendableOrFork = nodep->isSuspendable();
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstFork* nodep) override {
+        VL_RESTORER(m_inSuspendableOrFork);
+        m_inSuspendableOrFork = true;
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstWhile* nodep) override {
+        VL_RESTORER(m_inLoop);
+        m_inLoop = true;
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstAssignDly* nodep) override {
+        const AstNode* basep = nodep->lhsp();
+        int depth = 0;
+        if (const AstSel* const selp = VN_CAST(basep, Sel)) {
+            basep = selp->fromp();
+            ++depth;
+        }
+        for (; VN_IS(basep, ArraySel); basep = VN_AS(basep, ArraySel)->fromp()) ++depth;
+        const AstVarRef* const refp = VN_CAST(basep, VarRef);
+        if (!refp) return;
+        MemUsage& usage = m_usage[refp->varScopep()];
+        // Only single dimension, whole element assignments are queued. Suspendable processes
+        // commit through their own post blocks, which must not race with a queue commit.
+        if (m_inSuspendableOrFork || depth != 1 || !VN_IS(nodep->lhsp(), ArraySel)
+            || !nodep->lhsp()->dtypep()->skipRefp()->isIntegralOrPacked()) {
+            usage.m_other = true;
+            return;
+        }
+        ++usage.m_sites;
+        if (m_inLoop) usage.m_inLoop = true;
+    }
+    void visit(AstCFunc*) override {}  // Delayed assignments are unsupported here
+    void visit(AstNodeExpr*) override {}  // Accelerate
+    void visit(AstNode* nodep) override { iterateChildrenConst(nodep); }
+
+public:
+    // CONSTRUCTORS
+    DelayedQueueVisitor(AstNetlist* nodep, std::unordered_set<const AstVarScope*>& queuedr) {
+        iterateConst(nodep);
+        for (const auto& pair : m_usage) {
+            const MemUsage& usage = pair.second;
+            if (usage.m_other) continue;
+            if (usage.m_inLoop || usage.m_sites >= DELAYED_QUEUE_MIN_SITES) {
+                queuedr.insert(pair.first);
+            }
+        }
+    }
+    ~DelayedQueueVisitor() override = default;
+};
+
 //######################################################################
 // Delayed state, as a visitor of each AstNode
 
@@ -106,6 +191,10 @@ private:
     using VarMap = std::map<const std::pair<AstNodeModule*, std::string>, AstVar*>;
     VarMap m_modVarMap;  // Table of new var names created under module
     VDouble0 m_statSharedSet;  // Statistic tracking
+    VDouble0 m_statCommitQueues;  // Statistic tracking
+    std::unordered_set<const AstVarScope*> m_queuedVscps;  // Memories using commit queues
+    // Commit queue of each memory in m_queuedVscps
+    std::unordered_map<const AstVarScope*, AstVarScope*> m_queueVscps;
     std::unordered_map<const AstVarScope*, int> m_scopeVecMap;  // Next var number for each scope
 
     // METHODS
@@ -411,6 +500,54 @@ private:
         return newlhsp;
     }
 
+    void createDlyOnQueue(AstAssignDly* nodep) {
+        // Replace delayed assignment with enqueueing the write into the memory's commit queue
+        // See top of this file for transformation
+        FileLine* const flp = nodep->fileline();
+        AstArraySel* const arrayselp = VN_AS(nodep->lhsp(), ArraySel);
+        AstVarRef* const varrefp = VN_AS(arrayselp->fromp(), VarRef);
+        AstVarScope* const vscp = varrefp->varScopep();
+        UINFO(4, "AssignDlyQueue: " << nodep << endl);
+        AstVarScope*& queueVscpr = m_queueVscps[vscp];
+        if (!queueVscpr) {
+            AstNBACommitQueueDType* const dtypep
+                = new AstNBACommitQueueDType{flp, arrayselp->dtypep()};
+            v3Global.rootp()->typeTablep()->addTypesp(dtypep);
+            const string name = string{"__VdlyCommitQueue__"} + vscp->varp()->shortName();
+            queueVscpr = createVarSc(vscp, name, 0, dtypep);
+            ++m_statCommitQueues;
+        }
+        const auto queueRef = [&]() {
+            AstVarRef* const refp = new AstVarRef{flp, queueVscpr, VAccess::READWRITE};
+            refp->user2(true);  // Not a user variable, no reason to check it
+            return refp;
+        };
+        // All delayed assignments to the memory share one ALWAYSPOST, committing the queue
+        AstAlwaysPost* finalp = VN_AS(vscp->user4p(), AlwaysPost);
+        if (finalp) {
+            checkActivePost(varrefp, VN_AS(finalp->user2p(), Active));
+        } else {  // first time we've dealt with this memory
+            finalp = new AstAlwaysPost{flp, nullptr /*sens*/, nullptr /*body*/};
+            UINFO(9, "     Created " << finalp << endl);
+            AstActive* const newactp = createActive(varrefp);
+            newactp->addStmtsp(finalp);
+            vscp->user4p(finalp);
+            finalp->user2p(newactp);
+            AstVarRef* const memrefp = new AstVarRef{flp, vscp, VAccess::WRITE};
+            memrefp->user2(true);  // Do not generate a warning for this assignment
+            AstCMethodHard* const commitp
+                = new AstCMethodHard{flp, queueRef(), "commit", memrefp};
+            commitp->dtypeSetVoid();
+            finalp->addStmtsp(commitp->makeStmt());
+        }
+        AstNodeExpr* const valuep = nodep->rhsp()->unlinkFrBack();
+        AstCMethodHard* const enqueuep = new AstCMethodHard{flp, queueRef(), "enqueue", valuep};
+        enqueuep->addPinsp(arrayselp->bitp()->unlinkFrBack());
+        enqueuep->dtypeSetVoid();
+        nodep->replaceWith(enqueuep->makeStmt());
+        VL_DO_DANGLING(pushDeletep(nodep), nodep);
+    }
+
     // VISITORS
     void visit(AstNetlist* nodep) override {
         // VV*****  We reset all userp() on the netlist
@@ -527,6 +664,14 @@ private:
                           "Unsupported: Delayed assignment inside public function/task");
         }
         UASSERT_OBJ(m_procp, nodep, "Delayed assignment not under process");
+        if (!m_inSuspendableOrFork && VN_IS(nodep->lhsp(), ArraySel)) {
+            const AstVarRef* const refp
+                = VN_CAST(VN_AS(nodep->lhsp(), ArraySel)->fromp(), VarRef);
+            if (refp && m_queuedVscps.count(refp->varScopep())) {
+                VL_DO_DANGLING(createDlyOnQueue(nodep), nodep);
+                return;
+            }
+        }
         const bool isArray = VN_IS(nodep->lhsp(), ArraySel)
                              || (VN_IS(nodep->lhsp(), Sel)
                                  && VN_IS(VN_AS(nodep->lhsp(), Sel)->fromp(), ArraySel));
@@ -629,9 +774,13 @@ private:
 
 public:
     // CONSTRUCTORS
-    explicit DelayedVisitor(AstNetlist* nodep) { iterate(nodep); }
+    explicit DelayedVisitor(AstNetlist* nodep) {
+        { DelayedQueueVisitor{nodep, m_queuedVscps}; }
+        iterate(nodep);
+    }
     ~DelayedVisitor() override {
         V3Stats::addStat("Optimizations, Delayed shared-sets", m_statSharedSet);
+        V3Stats::addStat("Optimizations, Delayed commit queues", m_statCommitQueues);
     }
 };
 
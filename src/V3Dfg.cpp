@@ -27,8 +27,9 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 // DfgGraph
 //------------------------------------------------------------------------------
 
-DfgGraph::DfgGraph(AstModule& module, const string& name)
+DfgGraph::DfgGraph(AstModule& module, const string& name, AstScope* scopep)
     : m_modulep{&module}
+    , m_scopep{scopep}
     , m_name{name} {}
 
 DfgGraph::~DfgGraph() {
@@ -447,7 +448,7 @@ V3Hash DfgSel::selfHash() const { return V3Hash{lsb()}; }
 // DfgVertexVar ----------
 
 bool DfgVertexVar::selfEquals(const DfgVertex& that) const {
-    UASSERT_OBJ(varp() != that.as<DfgVertexVar>()->varp(), this,
+    UASSERT_OBJ(nodep() != that.as<DfgVertexVar>()->nodep(), this,
                 "There should only be one DfgVertexVar for a given AstVar");
     return false;
 }
@@ -37,6 +37,7 @@
 #include "V3Error.h"
 #include "V3Hash.h"
 #include "V3List.h"
+#include "V3NodeAlloc.h"
 
 #include "V3Dfg__gen_forward_class_decls.h"  // From ./astgen
 
@@ -136,11 +137,13 @@ class DfgGraph final {
     uint32_t m_userCnt = 0;  // Vertex user data generation counter
     // Parent of the graph (i.e.: the module containing the logic represented by this graph).
     AstModule* const m_modulep;
+    // Scope receiving new logic when the graph spans the scoped netlist, otherwise nullptr
+    AstScope* const m_scopep;
     const string m_name;  // Name of graph (for debugging)
 
 public:
     // CONSTRUCTOR
-    explicit DfgGraph(AstModule& module, const string& name = "");
+    explicit DfgGraph(AstModule& module, const string& name = "", AstScope* scopep = nullptr);
     ~DfgGraph();
     VL_UNCOPYABLE(DfgGraph);
 
@@ -154,6 +157,8 @@ public:
     size_t size() const { return m_size; }
     // Parent module
     AstModule* modulep() const { return m_modulep; }
+    // Scope for new logic, if built from the scoped netlist
+    AstScope* scopep() const { return m_scopep; }
     // Name of this graph
     const string& name() const { return m_name; }
 
@@ -237,6 +242,12 @@ class DfgEdge final {
 public:
     DfgEdge() {}
     void init(DfgVertex* sinkp) { const_cast<DfgVertex*&>(m_sinkp) = sinkp; }
+#ifndef VL_LEAK_CHECKS
+    static void* operator new[](size_t size) { return V3NodeAlloc::allocate(size); }
+    static void operator delete[](void* objp, size_t size) {
+        V3NodeAlloc::deallocate(objp, size);
+    }
+#endif
 
     // The source (driver) of this edge
     DfgVertex* sourcep() const { return m_sourcep; }
@@ -276,6 +287,10 @@ protected:
 
 public:
     virtual ~DfgVertex();
+#ifndef VL_LEAK_CHECKS
+    static void* operator new(size_t size) { return V3NodeAlloc::allocate(size); }
+    static void operator delete(void* objp, size_t size) { V3NodeAlloc::deallocate(objp, size); }
+#endif
 
     // METHODS
 private:
@@ -24,6 +24,9 @@
 // non-converted logic blocks (or other constructs under the AstModule) are marked as being
 // referenced in the AstModule, which is relevant for later optimization.
 //
+// After scoping, the logic in all scopes of the netlist can be converted into a single DfgGraph
+// instead, in which case variables are represented by their AstVarScope.
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -76,7 +79,7 @@ DfgSliceSel* makeVertex<DfgSliceSel, AstSliceSel>(const AstSliceSel*, DfgGraph&)
 class AstToDfgVisitor final : public VNVisitor {
     // NODE STATE
 
-    // AstNode::user1p   // DfgVertex for this AstNode
+    // AstNode::user1p   // DfgVertex for this AstNode (for variables, the AstVarScope if scoped)
     const VNUser1InUse m_user1InUse;
 
     // TYPES
@@ -106,10 +109,13 @@ class AstToDfgVisitor final : public VNVisitor {
         nodep->foreach([this](const AstVarRef* refp) {
             // No need to (and in fact cannot) mark variables with unsupported dtypes
             if (!DfgVertex::isSupportedDType(refp->varp()->dtypep())) return;
+            // When scoped, variables without an AstVarScope are never represented
+            if (m_dfgp->scopep() && !refp->varScopep()) return;
             // Mark vertex as having a module reference outside current DFG
-            getNet(refp->varp())->setHasModRefs();
+            DfgVertexVar* const vtxp = getNet(refp->varp(), refp->varScopep());
+            vtxp->setHasModRefs();
             // Mark variable as written from non-DFG logic
-            if (refp->access().isWriteOrRW()) refp->varp()->user3(true);
+            if (refp->access().isWriteOrRW()) vtxp->nodep()->user3(true);
         });
     }
 
@@ -120,24 +126,26 @@ class AstToDfgVisitor final : public VNVisitor {
         m_uncommittedVertices.clear();
     }
 
-    DfgVertexVar* getNet(AstVar* varp) {
-        if (!varp->user1p()) {
+    // Vertex of the given variable. 'varScopep' is nullptr unless building the scoped DFG, in
+    // which case the vertex is held by the AstVarScope rather than the AstVar.
+    DfgVertexVar* getNet(AstVar* varp, AstVarScope* varScopep = nullptr) {
+        AstNode* const keyp = varScopep ? static_cast<AstNode*>(varScopep) : varp;
+        if (!keyp->user1p()) {
             // Note DfgVertexVar vertices are not added to m_uncommittedVertices, because we
             // want to hold onto them via AstVar::user1p, and the AstVar might be referenced via
             // multiple AstVarRef instances, so we will never revert a DfgVertexVar once
             // created. We will delete unconnected variable vertices at the end.
             if (VN_IS(varp->dtypep()->skipRefp(), UnpackArrayDType)) {
-                DfgVarArray* const vtxp = new DfgVarArray{*m_dfgp, varp};
-                varp->user1p();
+                DfgVarArray* const vtxp = new DfgVarArray{*m_dfgp, varp, varScopep};
                 m_varArrayps.push_back(vtxp);
-                varp->user1p(vtxp);
+                keyp->user1p(vtxp);
             } else {
-                DfgVarPacked* const vtxp = new DfgVarPacked{*m_dfgp, varp};
+                DfgVarPacked* const vtxp = new DfgVarPacked{*m_dfgp, varp, varScopep};
                 m_varPackedps.push_back(vtxp);
-                varp->user1p(vtxp);
+                keyp->user1p(vtxp);
             }
         }
-        return varp->user1u().to<DfgVertexVar*>();
+        return keyp->user1u().to<DfgVertexVar*>();
     }
 
     DfgVertex* getVertex(AstNode* nodep) {
@@ -445,6 +453,13 @@ class AstToDfgVisitor final : public VNVisitor {
         // (these flags were set up in DataflowPrepVisitor)
         if (nodep->user2()) getNet(nodep)->setHasExtRefs();
     }
+    void visit(AstVarScope* nodep) override {
+        AstVar* const varp = nodep->varp();
+        // No need to (and in fact cannot) handle variables with unsupported dtypes
+        if (!DfgVertex::isSupportedDType(varp->dtypep())) return;
+        // After scoping, only the ports of the top module are referenced externally
+        if (varp->isPrimaryIO()) getNet(varp, nodep)->setHasExtRefs();
+    }
 
     void visit(AstAssignW* nodep) override {
         ++m_ctx.m_inputEquations;
@@ -524,6 +539,7 @@ class AstToDfgVisitor final : public VNVisitor {
             || nodep->varp()->isIfaceRef()  // Cannot handle interface references
             || nodep->varp()->delayp()  // Cannot handle delayed variables
             || nodep->classOrPackagep()  // Cannot represent cross module references
+            || (m_dfgp->scopep() && !nodep->varScopep())  // Scoped, but not a scoped reference
         ) {
             markReferenced(nodep);
             m_foundUnhandled = true;
@@ -538,7 +554,7 @@ class AstToDfgVisitor final : public VNVisitor {
             return;
         }
 
-        nodep->user1p(getNet(nodep->varp()));
+        nodep->user1p(getNet(nodep->varp(), nodep->varScopep()));
     }
 
     void visit(AstConst* nodep) override {
@@ -595,12 +611,38 @@ class AstToDfgVisitor final : public VNVisitor {
         canonicalizeArray();
     }
 
+    explicit AstToDfgVisitor(AstNetlist& netlist, V3DfgOptimizationContext& ctx)
+        : m_dfgp{new DfgGraph{*VN_AS(netlist.topModulep(), Module), "scoped",
+                              netlist.topScopep()->scopep()}}
+        , m_ctx{ctx} {
+        // Gather the scopes first, as converted logic is removed while iterating
+        std::vector<AstScope*> scopeps;
+        netlist.foreach([&](AstScope* scopep) { scopeps.push_back(scopep); });
+        // Build the DFG
+        for (AstScope* const scopep : scopeps) {
+            iterateAndNextNull(scopep->varsp());
+            iterateAndNextNull(scopep->blocksp());
+        }
+        UASSERT_OBJ(m_uncommittedVertices.empty(), &netlist, "Uncommitted vertices remain");
+
+        // Canonicalize variables
+        canonicalizePacked();
+        canonicalizeArray();
+    }
+
 public:
     static DfgGraph* apply(AstModule& module, V3DfgOptimizationContext& ctx) {
         return AstToDfgVisitor{module, ctx}.m_dfgp;
     }
+    static DfgGraph* apply(AstNetlist& netlist, V3DfgOptimizationContext& ctx) {
+        return AstToDfgVisitor{netlist, ctx}.m_dfgp;
+    }
 };
 
 DfgGraph* V3DfgPasses::astToDfg(AstModule& module, V3DfgOptimizationContext& ctx) {
     return AstToDfgVisitor::apply(module, ctx);
 }
+
+DfgGraph* V3DfgPasses::astToDfgScoped(AstNetlist& netlist, V3DfgOptimizationContext& ctx) {
+    return AstToDfgVisitor::apply(netlist, ctx);
+}
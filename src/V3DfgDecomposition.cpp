@@ -99,7 +99,8 @@ class SplitIntoComponents final {
         // Allocate the component graphs
         m_components.resize(m_componentCounter - 1);
         for (size_t i = 1; i < m_componentCounter; ++i) {
-            m_components[i - 1].reset(new DfgGraph{*m_dfg.modulep(), m_prefix + cvtToStr(i - 1)});
+            m_components[i - 1].reset(
+                new DfgGraph{*m_dfg.modulep(), m_prefix + cvtToStr(i - 1), m_dfg.scopep()});
         }
         // Move the vertices to the component graphs
         moveVertices(m_dfg.varVerticesBeginp());
@@ -325,9 +326,9 @@ class ExtractCyclicComponents final {
         DfgVertexVar*& clonep = m_clones[&vtx][component];
         if (!clonep) {
             if (DfgVarPacked* const pVtxp = vtx.cast<DfgVarPacked>()) {
-                clonep = new DfgVarPacked{m_dfg, pVtxp->varp()};
+                clonep = new DfgVarPacked{m_dfg, pVtxp->varp(), pVtxp->varScopep()};
             } else if (DfgVarArray* const aVtxp = vtx.cast<DfgVarArray>()) {
-                clonep = new DfgVarArray{m_dfg, aVtxp->varp()};
+                clonep = new DfgVarArray{m_dfg, aVtxp->varp(), aVtxp->varScopep()};
             }
             UASSERT_OBJ(clonep, &vtx, "Unhandled 'DfgVertexVar' sub-type");
             VertexState& cloneStatep = allocState(*clonep);
@@ -473,7 +474,8 @@ class ExtractCyclicComponents final {
         // Allocate result graphs
         m_components.resize(m_nonTrivialSCCs);
         for (size_t i = 0; i < m_nonTrivialSCCs; ++i) {
-            m_components[i].reset(new DfgGraph{*m_dfg.modulep(), m_prefix + cvtToStr(i)});
+            m_components[i].reset(
+                new DfgGraph{*m_dfg.modulep(), m_prefix + cvtToStr(i), m_dfg.scopep()});
         }
 
         // Fix up edges crossing components (we can only do this at variable boundaries, and the
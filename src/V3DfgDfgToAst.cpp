@@ -130,30 +130,41 @@ AstSliceSel* makeNode<AstSliceSel, DfgSliceSel, AstNodeExpr*, AstNodeExpr*, AstN
 class DfgToAstVisitor final : DfgVisitor {
     // NODE STATE
     // AstVar::user1()  bool: this is a temporary we are introducing
+    //                        (AstVarScope::user1() instead, if the graph is scoped)
 
     const VNUser1InUse m_inuser1;
 
     // STATE
 
     AstModule* const m_modp;  // The parent/result module
+    AstScope* const m_scopep;  // The scope receiving the result, if the graph is scoped
     V3DfgOptimizationContext& m_ctx;  // The optimization context for stats
     AstNodeExpr* m_resultp = nullptr;  // The result node of the current traversal
-    // Map from DfgVertex to the AstVar holding the value of that DfgVertex after conversion
-    std::unordered_map<const DfgVertex*, AstVar*> m_resultVars;
-    // Map from an AstVar, to the canonical AstVar that can be substituted for that AstVar
-    std::unordered_map<AstVar*, AstVar*> m_canonVars;
+    // Variables below are AstVarScope if the graph is scoped, otherwise AstVar
+    // Map from DfgVertex to the variable holding the value of that DfgVertex after conversion
+    std::unordered_map<const DfgVertex*, AstNode*> m_resultVars;
+    // Map from a variable, to the canonical variable that can be substituted for that variable
+    std::unordered_map<AstNode*, AstNode*> m_canonVars;
     V3UniqueNames m_tmpNames{"__VdfgTmp"};  // For generating temporary names
 
     // METHODS
 
-    // Given a DfgVarPacked, return the canonical AstVar that can be used for this DfgVarPacked.
+    // Reference to the given AstVar or AstVarScope
+    static AstVarRef* newVarRef(FileLine* flp, AstNode* varp, const VAccess& access) {
+        if (AstVarScope* const vscp = VN_CAST(varp, VarScope)) {
+            return new AstVarRef{flp, vscp, access};
+        }
+        return new AstVarRef{flp, VN_AS(varp, Var), access};
+    }
+
+    // Given a DfgVarPacked, return the canonical variable that can be used for this DfgVarPacked.
     // Also builds the m_canonVars map as a side effect.
-    AstVar* getCanonicalVar(const DfgVarPacked* vtxp) {
+    AstNode* getCanonicalVar(const DfgVarPacked* vtxp) {
         // If variable driven (at least partially) outside the DFG, then we have no choice
-        if (!vtxp->isDrivenFullyByDfg()) return vtxp->varp();
+        if (!vtxp->isDrivenFullyByDfg()) return vtxp->nodep();
 
         // Look up map
-        const auto it = m_canonVars.find(vtxp->varp());
+        const auto it = m_canonVars.find(vtxp->nodep());
         if (it != m_canonVars.end()) return it->second;
 
         // Not known yet, compute it (for all vars driven fully from the same driver)
@@ -170,22 +181,22 @@ class DfgToAstVisitor final : DfgVisitor {
                              const FileLine& aFl = *(ap->fileline());
                              const FileLine& bFl = *(bp->fileline());
                              if (const int cmp = aFl.operatorCompare(bFl)) return cmp < 0;
-                             return ap->varp()->name() < bp->varp()->name();
+                             return ap->nodep()->name() < bp->nodep()->name();
                          });
-        AstVar* const canonVarp = varps.front()->varp();
+        AstNode* const canonVarp = varps.front()->nodep();
 
         // Add results to map
-        for (const DfgVarPacked* const varp : varps) m_canonVars.emplace(varp->varp(), canonVarp);
+        for (const DfgVarPacked* const varp : varps) m_canonVars.emplace(varp->nodep(), canonVarp);
 
         // Return it
         return canonVarp;
     }
 
-    // Given a DfgVertex, return an AstVar that will hold the value of the given DfgVertex once we
-    // are done with converting this Dfg into Ast form.
-    AstVar* getResultVar(DfgVertex* vtxp) {
+    // Given a DfgVertex, return a variable that will hold the value of the given DfgVertex once
+    // we are done with converting this Dfg into Ast form.
+    AstNode* getResultVar(DfgVertex* vtxp) {
         const auto pair = m_resultVars.emplace(vtxp, nullptr);
-        AstVar*& varp = pair.first->second;
+        AstNode*& varp = pair.first->second;
         if (pair.second) {
             // If this vertex is a DfgVarPacked, then we know the variable. If this node is not a
             // DfgVarPacked, then first we try to find a DfgVarPacked driven by this node, and use
@@ -195,7 +206,7 @@ class DfgToAstVisitor final : DfgVisitor {
                 varp = getCanonicalVar(thisDfgVarPackedp);
             } else if (const DfgVarArray* const thisDfgVarArrayp = vtxp->cast<DfgVarArray>()) {
                 // This is a DfgVarArray
-                varp = thisDfgVarArrayp->varp();
+                varp = thisDfgVarArrayp->nodep();
             } else if (const DfgVarPacked* const sinkDfgVarPackedp = vtxp->findSink<DfgVarPacked>(
                            [](const DfgVarPacked& var) { return var.isDrivenFullyByDfg(); })) {
                 // We found a DfgVarPacked driven fully by this node
@@ -209,10 +220,18 @@ class DfgToAstVisitor final : DfgVisitor {
                 // their operands based on the expression type, not the operand type.
                 AstNodeDType* const dtypep = v3Global.rootp()->findBitDType(
                     vtxp->width(), vtxp->width(), VSigning::UNSIGNED);
-                varp = new AstVar{vtxp->fileline(), VVarType::MODULETEMP, name, dtypep};
-                varp->user1(true);  // Mark as temporary
+                AstVar* const tmpp
+                    = new AstVar{vtxp->fileline(), VVarType::MODULETEMP, name, dtypep};
                 // Add temporary AstVar to containing module
-                m_modp->addStmtsp(varp);
+                m_modp->addStmtsp(tmpp);
+                varp = tmpp;
+                if (m_scopep) {
+                    // Scoped, so also needs an AstVarScope
+                    AstVarScope* const vscp = new AstVarScope{tmpp->fileline(), m_scopep, tmpp};
+                    m_scopep->addVarsp(vscp);
+                    varp = vscp;
+                }
+                varp->user1(true);  // Mark as temporary
             }
             // Add to map
         }
@@ -235,13 +254,13 @@ class DfgToAstVisitor final : DfgVisitor {
             return convertDfgVertexToAstNodeExpr(vtxp);
         } else {
             // Vertices that are not inlined need a variable, just return a reference
-            return new AstVarRef{vtxp->fileline(), getResultVar(vtxp), VAccess::READ};
+            return newVarRef(vtxp->fileline(), getResultVar(vtxp), VAccess::READ);
         }
     }
 
     void convertCanonicalVarDriver(const DfgVarPacked* dfgVarp) {
         const auto wRef = [dfgVarp]() {
-            return new AstVarRef{dfgVarp->fileline(), dfgVarp->varp(), VAccess::WRITE};
+            return newVarRef(dfgVarp->fileline(), dfgVarp->nodep(), VAccess::WRITE);
         };
         if (dfgVarp->isDrivenFullyByDfg()) {
             // Whole variable is driven. Render driver and assign directly to whole variable.
@@ -264,12 +283,12 @@ class DfgToAstVisitor final : DfgVisitor {
         }
     }
 
-    void convertDuplicateVarDriver(const DfgVarPacked* dfgVarp, AstVar* canonVarp) {
+    void convertDuplicateVarDriver(const DfgVarPacked* dfgVarp, AstNode* canonVarp) {
         const auto rRef = [canonVarp]() {
-            return new AstVarRef{canonVarp->fileline(), canonVarp, VAccess::READ};
+            return newVarRef(canonVarp->fileline(), canonVarp, VAccess::READ);
         };
         const auto wRef = [dfgVarp]() {
-            return new AstVarRef{dfgVarp->fileline(), dfgVarp->varp(), VAccess::WRITE};
+            return newVarRef(dfgVarp->fileline(), dfgVarp->nodep(), VAccess::WRITE);
         };
         if (dfgVarp->isDrivenFullyByDfg()) {
             // Whole variable is driven. Just assign from the canonical variable.
@@ -298,7 +317,7 @@ class DfgToAstVisitor final : DfgVisitor {
             AstNodeExpr* const rhsp = convertDfgVertexToAstNodeExpr(edge.sourcep());
             // Create select LValue
             FileLine* const flp = dfgVarp->driverFileLine(idx);
-            AstVarRef* const refp = new AstVarRef{flp, dfgVarp->varp(), VAccess::WRITE};
+            AstVarRef* const refp = newVarRef(flp, dfgVarp->nodep(), VAccess::WRITE);
             AstConst* const idxp = new AstConst{flp, dfgVarp->driverIndex(idx)};
             AstArraySel* const lhsp = new AstArraySel{flp, refp, idxp};
             // Add assignment of the value to the selected bits
@@ -307,7 +326,12 @@ class DfgToAstVisitor final : DfgVisitor {
     }
 
     void addResultEquation(FileLine* flp, AstNodeExpr* lhsp, AstNodeExpr* rhsp) {
-        m_modp->addStmtsp(new AstAssignW{flp, lhsp, rhsp});
+        AstAssignW* const assignp = new AstAssignW{flp, lhsp, rhsp};
+        if (m_scopep) {
+            m_scopep->addBlocksp(assignp);
+        } else {
+            m_modp->addStmtsp(assignp);
+        }
         ++m_ctx.m_resultEquations;
     }
 
@@ -317,11 +341,11 @@ class DfgToAstVisitor final : DfgVisitor {
     }  // LCOV_EXCL_STOP
 
     void visit(DfgVarPacked* vtxp) override {
-        m_resultp = new AstVarRef{vtxp->fileline(), getCanonicalVar(vtxp), VAccess::READ};
+        m_resultp = newVarRef(vtxp->fileline(), getCanonicalVar(vtxp), VAccess::READ);
     }
 
     void visit(DfgVarArray* vtxp) override {
-        m_resultp = new AstVarRef{vtxp->fileline(), vtxp->varp(), VAccess::READ};
+        m_resultp = newVarRef(vtxp->fileline(), vtxp->nodep(), VAccess::READ);
     }
 
     void visit(DfgConst* vtxp) override {  //
@@ -350,6 +374,7 @@ class DfgToAstVisitor final : DfgVisitor {
     // Constructor
     explicit DfgToAstVisitor(DfgGraph& dfg, V3DfgOptimizationContext& ctx)
         : m_modp{dfg.modulep()}
+        , m_scopep{dfg.scopep()}
         , m_ctx{ctx} {
         // Convert the graph back to combinational assignments
 
@@ -357,7 +382,7 @@ class DfgToAstVisitor final : DfgVisitor {
         const auto userDataInUse = dfg.userDataInUse();
 
         // We can eliminate some variables completely
-        std::vector<AstVar*> redundantVarps;
+        std::vector<AstNode*> redundantVarps;
 
         // First render variable assignments
         for (DfgVertexVar *vtxp = dfg.varVerticesBeginp(), *nextp; vtxp; vtxp = nextp) {
@@ -371,8 +396,8 @@ class DfgToAstVisitor final : DfgVisitor {
                 // The driver of this DfgVarPacked might drive multiple variables. Only emit one
                 // assignment from the driver to an arbitrarily chosen canonical variable, and
                 // assign the other variables from that canonical variable
-                AstVar* const canonVarp = getCanonicalVar(dfgVarp);
-                if (canonVarp == dfgVarp->varp()) {
+                AstNode* const canonVarp = getCanonicalVar(dfgVarp);
+                if (canonVarp == dfgVarp->nodep()) {
                     // This is the canonical variable, so render the driver
                     convertCanonicalVarDriver(dfgVarp);
                 } else if (dfgVarp->keep()) {
@@ -381,7 +406,7 @@ class DfgToAstVisitor final : DfgVisitor {
                 } else {
                     // Not a canonical var, and it can be removed. We will replace all references
                     // to it with the canonical variable, and hence this can be removed.
-                    redundantVarps.push_back(dfgVarp->varp());
+                    redundantVarps.push_back(dfgVarp->nodep());
                     ++m_ctx.m_replacedVars;
                 }
                 // Done
@@ -405,7 +430,7 @@ class DfgToAstVisitor final : DfgVisitor {
             if (vtxp->inlined()) continue;
 
             // Check if this uses a temporary, vs one of the vars rendered above
-            AstVar* const resultVarp = getResultVar(vtxp);
+            AstNode* const resultVarp = getResultVar(vtxp);
             if (resultVarp->user1()) {
                 // We introduced a temporary for this DfgVertex
                 ++m_ctx.m_intermediateVars;
@@ -413,29 +438,33 @@ class DfgToAstVisitor final : DfgVisitor {
                 // Just render the logic
                 AstNodeExpr* const rhsp = convertDfgVertexToAstNodeExpr(vtxp);
                 // The lhs is the temporary
-                AstNodeExpr* const lhsp = new AstVarRef{flp, resultVarp, VAccess::WRITE};
+                AstNodeExpr* const lhsp = newVarRef(flp, resultVarp, VAccess::WRITE);
                 // Add assignment of the value to the variable
                 addResultEquation(flp, lhsp, rhsp);
             }
         }
 
-        // Remap all references to point to the canonical variables, if one exists
+        // Remap all references to point to the canonical variables, if one exists. When scoped,
+        // the references can be anywhere in the netlist.
         VNDeleter deleter;
-        m_modp->foreach([&](AstVarRef* refp) {
+        AstNode* const rootp = m_scopep ? static_cast<AstNode*>(v3Global.rootp()) : m_modp;
+        rootp->foreach([&](AstVarRef* refp) {
             // Any variable that is written partially outside the DFG will have itself as the
             // canonical var, so need not be replaced, furthermore, if a variable is traced, we
             // don't want to update the write-refs we just created above, so we only replace
             // read-only references to those variables to those variables we know are not written
             // in non-DFG logic.
-            if (!refp->access().isReadOnly() || refp->varp()->user3()) return;
-            const auto it = m_canonVars.find(refp->varp());
-            if (it == m_canonVars.end() || it->second == refp->varp()) return;
-            refp->replaceWith(new AstVarRef{refp->fileline(), it->second, refp->access()});
+            AstNode* const varp = m_scopep ? static_cast<AstNode*>(refp->varScopep())
+                                           : static_cast<AstNode*>(refp->varp());
+            if (!varp || !refp->access().isReadOnly() || varp->user3()) return;
+            const auto it = m_canonVars.find(varp);
+            if (it == m_canonVars.end() || it->second == varp) return;
+            refp->replaceWith(newVarRef(refp->fileline(), it->second, refp->access()));
             deleter.pushDeletep(refp);
         });
 
         // Remove redundant variables
-        for (AstVar* const varp : redundantVarps) varp->unlinkFrBack()->deleteTree();
+        for (AstNode* const varp : redundantVarps) varp->unlinkFrBack()->deleteTree();
     }
 
 public:
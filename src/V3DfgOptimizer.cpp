@@ -240,6 +240,51 @@ void V3DfgOptimizer::extract(AstNetlist* netlistp) {
     V3Global::dumpCheckGlobalTree("dfg-extract", 0, dumpTreeLevel() >= 3);
 }
 
+// Optimize the given DFG. The graph is rebuilt in place, ready to be converted back to Ast.
+static void optimizeGraph(DfgGraph& dfg, V3DfgOptimizationContext& ctx) {
+    // Extract the cyclic sub-graphs. We do this because a lot of the optimizations assume a
+    // DAG, and large, mostly acyclic graphs could not be optimized due to the presence of
+    // small cycles.
+    const std::vector<std::unique_ptr<DfgGraph>>& cyclicComponents
+        = dfg.extractCyclicComponents("cyclic");
+
+    // Split the remaining acyclic DFG into [weakly] connected components
+    const std::vector<std::unique_ptr<DfgGraph>>& acyclicComponents
+        = dfg.splitIntoComponents("acyclic");
+
+    // Quick sanity check
+    UASSERT(dfg.size() == 0, "DfgGraph should have become empty");
+
+    // For each cyclic component
+    for (auto& component : cyclicComponents) {
+        if (dumpDfgLevel() >= 7) component->dumpDotFilePrefixed(ctx.prefix() + "source");
+        // TODO: Apply optimizations safe for cyclic graphs
+        // Add back under the main DFG (we will convert everything back in one go)
+        dfg.addGraph(*component);
+    }
+
+    // Optimize each acyclic component
+    if (v3Global.opt.verilateJobs() > 1 && !dumpDfgLevel() && acyclicComponents.size() > 1) {
+        // Components are independent, so optimize them in parallel. Each has its own
+        // context, merged into 'ctx' when destroyed here on the main thread.
+        std::vector<std::unique_ptr<V3DfgOptimizationContext>> ctxps;
+        ctxps.reserve(acyclicComponents.size());
+        for (size_t i = 0; i < acyclicComponents.size(); ++i) {
+            ctxps.emplace_back(new V3DfgOptimizationContext{ctx});
+        }
+        AstNode::foreachIndexParallel(acyclicComponents.size(), [&](size_t i) {
+            V3DfgPasses::optimize(*acyclicComponents[i], *ctxps[i]);
+        });
+    } else {
+        for (auto& component : acyclicComponents) {
+            if (dumpDfgLevel() >= 7) component->dumpDotFilePrefixed(ctx.prefix() + "source");
+            V3DfgPasses::optimize(*component, ctx);
+        }
+    }
+    // Add back under the main DFG (we will convert everything back in one go)
+    for (auto& component : acyclicComponents) dfg.addGraph(*component);
+}
+
 void V3DfgOptimizer::optimize(AstNetlist* netlistp, const string& label) {
     UINFO(2, __FUNCTION__ << ": " << endl);
 
@@ -269,35 +314,7 @@ void V3DfgOptimizer::optimize(AstNetlist* netlistp, const string& label) {
         const std::unique_ptr<DfgGraph> dfg{V3DfgPasses::astToDfg(*modp, ctx)};
         if (dumpDfgLevel() >= 8) dfg->dumpDotFilePrefixed(ctx.prefix() + "whole-input");
 
-        // Extract the cyclic sub-graphs. We do this because a lot of the optimizations assume a
-        // DAG, and large, mostly acyclic graphs could not be optimized due to the presence of
-        // small cycles.
-        const std::vector<std::unique_ptr<DfgGraph>>& cyclicComponents
-            = dfg->extractCyclicComponents("cyclic");
-
-        // Split the remaining acyclic DFG into [weakly] connected components
-        const std::vector<std::unique_ptr<DfgGraph>>& acyclicComponents
-            = dfg->splitIntoComponents("acyclic");
-
-        // Quick sanity check
-        UASSERT_OBJ(dfg->size() == 0, nodep, "DfgGraph should have become empty");
-
-        // For each cyclic component
-        for (auto& component : cyclicComponents) {
-            if (dumpDfgLevel() >= 7) component->dumpDotFilePrefixed(ctx.prefix() + "source");
-            // TODO: Apply optimizations safe for cyclic graphs
-            // Add back under the main DFG (we will convert everything back in one go)
-            dfg->addGraph(*component);
-        }
-
-        // For each acyclic component
-        for (auto& component : acyclicComponents) {
-            if (dumpDfgLevel() >= 7) component->dumpDotFilePrefixed(ctx.prefix() + "source");
-            // Optimize the component
-            V3DfgPasses::optimize(*component, ctx);
-            // Add back under the main DFG (we will convert everything back in one go)
-            dfg->addGraph(*component);
-        }
+        optimizeGraph(*dfg, ctx);
 
         // Convert back to Ast
         if (dumpDfgLevel() >= 8) dfg->dumpDotFilePrefixed(ctx.prefix() + "whole-optimized");
@@ -306,3 +323,26 @@ void V3DfgOptimizer::optimize(AstNetlist* netlistp, const string& label) {
     }
     V3Global::dumpCheckGlobalTree("dfg-optimize", 0, dumpTreeLevel() >= 3);
 }
+
+void V3DfgOptimizer::optimizeScoped(AstNetlist* netlistp) {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+
+    // NODE STATE
+    // AstVarScope::user1 -> Used by V3DfgPasses::astToDfgScoped and DfgPassed::dfgToAst
+    // AstVarScope::user3 -> bool: Flag indicating written by logic not representable as DFG
+    //                             (set by V3DfgPasses::astToDfgScoped)
+    const VNUser3InUse user3InUse;
+
+    V3DfgOptimizationContext ctx{"scoped"};
+
+    // Build a single DFG of the whole design, so optimizations apply across the hierarchy
+    const std::unique_ptr<DfgGraph> dfg{V3DfgPasses::astToDfgScoped(*netlistp, ctx)};
+    if (dumpDfgLevel() >= 8) dfg->dumpDotFilePrefixed(ctx.prefix() + "whole-input");
+
+    optimizeGraph(*dfg, ctx);
+
+    // Convert back to Ast
+    if (dumpDfgLevel() >= 8) dfg->dumpDotFilePrefixed(ctx.prefix() + "whole-optimized");
+    V3DfgPasses::dfgToAst(*dfg, ctx);
+    V3Global::dumpCheckGlobalTree("dfg-scoped", 0, dumpTreeLevel() >= 3);
+}
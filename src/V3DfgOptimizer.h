@@ -30,6 +30,9 @@ void extract(AstNetlist*);
 
 // Optimize the design
 void optimize(AstNetlist*, const string& label);
+
+// Optimize the scoped design as a whole, across module boundaries
+void optimizeScoped(AstNetlist*);
 }  // namespace V3DfgOptimizer
 
 #endif  // Guard
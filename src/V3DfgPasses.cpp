@@ -27,15 +27,32 @@
 VL_DEFINE_DEBUG_FUNCTIONS;
 
 V3DfgCseContext::~V3DfgCseContext() {
+    if (m_parentp) {
+        m_parentp->m_eliminated += m_eliminated;
+        return;
+    }
     V3Stats::addStat("Optimizations, DFG " + m_label + " CSE, expressions eliminated",
                      m_eliminated);
 }
 
 DfgRemoveVarsContext::~DfgRemoveVarsContext() {
+    if (m_parentp) {
+        m_parentp->m_removed += m_removed;
+        for (AstNode* const varp : m_unusedps) m_parentp->deleteVar(varp);
+        return;
+    }
     V3Stats::addStat("Optimizations, DFG " + m_label + " Remove vars, variables removed",
                      m_removed);
 }
 
+void DfgRemoveVarsContext::deleteVar(AstNode* varp) {
+    if (m_parentp) {
+        m_unusedps.push_back(varp);
+    } else {
+        varp->unlinkFrBack()->deleteTree();
+    }
+}
+
 static std::string getPrefix(const std::string& label) {
     if (label.empty()) return "";
     std::string str = VString::removeWhitespace(label);
@@ -50,7 +67,17 @@ V3DfgOptimizationContext::V3DfgOptimizationContext(const std::string& label)
     : m_label{label}
     , m_prefix{getPrefix(label)} {}
 
+V3DfgOptimizationContext::V3DfgOptimizationContext(V3DfgOptimizationContext& parent)
+    : m_label{parent.m_label}
+    , m_prefix{parent.m_prefix}
+    , m_isChild{true}
+    , m_cseContext0{parent.m_cseContext0}
+    , m_cseContext1{parent.m_cseContext1}
+    , m_peepholeContext{parent.m_peepholeContext}
+    , m_removeVarsContext{parent.m_removeVarsContext} {}
+
 V3DfgOptimizationContext::~V3DfgOptimizationContext() {
+    if (m_isChild) return;  // Pass contexts merge themselves into the parent's
     const string prefix = "Optimizations, DFG " + m_label + " ";
     V3Stats::addStat(prefix + "General, modules", m_modules);
     V3Stats::addStat(prefix + "Ast2Dfg, coalesced assignments", m_coalescedAssignments);
@@ -209,10 +236,11 @@ void V3DfgPasses::removeVars(DfgGraph& dfg, DfgRemoveVarsContext& ctx) {
 
         // OK, we can delete this DfgVarPacked from the graph.
 
-        // If not referenced outside the DFG, then also delete the referenced AstVar (now unused).
+        // If not referenced outside the DFG, then also delete the referenced AstVar (now unused),
+        // or the AstVarScope if scoped, as the AstVar might be used in other scopes.
         if (!varp->hasRefs()) {
             ++ctx.m_removed;
-            varp->varp()->unlinkFrBack()->deleteTree();
+            ctx.deleteVar(varp->nodep());
         }
 
         // Unlink and delete vertex
@@ -21,36 +21,56 @@
 
 #include "V3DfgPeephole.h"
 
+#include <vector>
+
 class AstModule;
+class AstNetlist;
+class AstNode;
 class DfgGraph;
 
 //===========================================================================
 // Various context objects hold data that need to persist across invocations
 // of a DFG pass.
 
+// Contexts constructed from a parent context (used on worker threads) add their statistics
+// to the parent when destroyed, instead of reporting them.
+
 class V3DfgCseContext final {
     const std::string m_label;  // Label to apply to stats
+    V3DfgCseContext* const m_parentp = nullptr;  // Context to merge into, if any
 
 public:
     VDouble0 m_eliminated;  // Number of common sub-expressions eliminated
     explicit V3DfgCseContext(const std::string& label)
         : m_label{label} {}
+    explicit V3DfgCseContext(V3DfgCseContext& parent)
+        : m_label{parent.m_label}
+        , m_parentp{&parent} {}
     ~V3DfgCseContext();
 };
 
 class DfgRemoveVarsContext final {
     const std::string m_label;  // Label to apply to stats
+    DfgRemoveVarsContext* const m_parentp = nullptr;  // Context to merge into, if any
+    std::vector<AstNode*> m_unusedps;  // Variables to delete when merged into the parent
 
 public:
     VDouble0 m_removed;  // Number of redundant variables removed
     explicit DfgRemoveVarsContext(const std::string& label)
         : m_label{label} {}
+    explicit DfgRemoveVarsContext(DfgRemoveVarsContext& parent)
+        : m_label{parent.m_label}
+        , m_parentp{&parent} {}
     ~DfgRemoveVarsContext();
+    // Delete now unused AstVar or AstVarScope. Deferred until merged if a child context, as
+    // deleting edits the module's statement list, which is shared with the other components.
+    void deleteVar(AstNode* varp);
 };
 
 class V3DfgOptimizationContext final {
     const std::string m_label;  // Label to add to stats, etc.
     const std::string m_prefix;  // Prefix to add to file dumps (derived from label)
+    const bool m_isChild = false;  // Only the pass contexts are used, and merged into parent
 
 public:
     VDouble0 m_modules;  // Number of modules optimized
@@ -74,6 +94,8 @@ public:
     V3DfgPeepholeContext m_peepholeContext{m_label};
     DfgRemoveVarsContext m_removeVarsContext{m_label};
     explicit V3DfgOptimizationContext(const std::string& label);
+    // Context for V3DfgPasses::optimize on a worker thread, merged into 'parent' when destroyed
+    explicit V3DfgOptimizationContext(V3DfgOptimizationContext& parent);
     ~V3DfgOptimizationContext();
 
     const std::string& prefix() const { return m_prefix; }
@@ -89,11 +111,16 @@ namespace V3DfgPasses {
 // constructed DfgGraph.
 DfgGraph* astToDfg(AstModule&, V3DfgOptimizationContext&);
 
+// Construct a DfgGraph representing the combinational logic in all scopes of the scoped
+// netlist, with variables represented by their AstVarScope. The logic represented by the graph
+// is removed from the scopes. Returns the constructed DfgGraph.
+DfgGraph* astToDfgScoped(AstNetlist&, V3DfgOptimizationContext&);
+
 // Optimize the given DfgGraph
 void optimize(DfgGraph&, V3DfgOptimizationContext&);
 
-// Convert DfgGraph back into Ast, and insert converted graph back into its parent module.
-// Returns the parent module.
+// Convert DfgGraph back into Ast, and insert converted graph back into its parent module (or
+// into the top scope if the graph was built by 'astToDfgScoped'). Returns the parent module.
 AstModule* dfgToAst(DfgGraph&, V3DfgOptimizationContext&);
 
 //===========================================================================
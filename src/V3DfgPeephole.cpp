@@ -49,7 +49,19 @@ V3DfgPeepholeContext::V3DfgPeepholeContext(const std::string& label)
 #undef OPTIMIZATION_CHECK_ENABLED
 }
 
+V3DfgPeepholeContext::V3DfgPeepholeContext(V3DfgPeepholeContext& parent)
+    : m_label{parent.m_label}
+    , m_parentp{&parent} {
+    std::copy(std::begin(parent.m_enabled), std::end(parent.m_enabled), std::begin(m_enabled));
+}
+
 V3DfgPeepholeContext::~V3DfgPeepholeContext() {
+    if (m_parentp) {
+        for (size_t i = 0; i < VDfgPeepholePattern::_ENUM_END; ++i) {
+            m_parentp->m_count[i] += m_count[i];
+        }
+        return;
+    }
     const auto emitStat = [this](VDfgPeepholePattern id) {
         string str{id.ascii()};
         std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) {  //
@@ -414,6 +426,32 @@ class V3DfgPeephole final : public DfgVisitor {
         }
     }
 
+    // If the given Concat tree is a byte swap of (a part of) some vertex, i.e.: of the form
+    // {a[7+N:N], a[15+N:8+N], ...}, then return that vertex and set 'lsb' to the offset N of
+    // the swapped part. Otherwise returns nullptr.
+    static DfgVertex* byteSwapSource(DfgConcat* vtxp, uint32_t& lsb) {
+        // Gather the 8-bit terms of the tree, MSB first
+        std::vector<DfgSel*> terms;
+        const std::function<bool(DfgVertex*)> gather = [&](DfgVertex* termp) {
+            if (DfgConcat* const concatp = termp->cast<DfgConcat>()) {
+                return gather(concatp->lhsp()) && gather(concatp->rhsp());
+            }
+            DfgSel* const selp = termp->cast<DfgSel>();
+            if (!selp || selp->width() != 8) return false;
+            terms.push_back(selp);
+            return true;
+        };
+        if (!gather(vtxp)) return nullptr;
+        // The most significant term is the least significant byte of the source
+        DfgVertex* const fromp = terms.front()->fromp();
+        lsb = terms.front()->lsb();
+        for (size_t i = 1; i < terms.size(); ++i) {
+            if (terms[i]->lsb() != lsb + 8 * i) return nullptr;
+            if (!terms[i]->fromp()->equals(*fromp)) return nullptr;
+        }
+        return fromp;
+    }
+
     // Bitwise operation with one side Const, and the other side a Concat
     template <typename Vertex>
     bool tryPushBitwiseOpThroughConcat(Vertex* vtxp, DfgConst* constp, DfgConcat* concatp) {
@@ -1269,6 +1307,29 @@ class V3DfgPeephole final : public DfgVisitor {
                 }
             }
         }
+
+        // Byte swap of a whole word. Only consider the root of a Concat tree, as sub-trees might
+        // be byte swaps on their own.
+        const uint32_t width = vtxp->width();
+        if ((width == 16 || width == 32 || width == 64) && !vtxp->findSink<DfgConcat>()) {
+            uint32_t lsb = 0;
+            if (DfgVertex* const fromp = byteSwapSource(vtxp, lsb)) {
+                APPLYING(REPLACE_CONCAT_OF_REVERSED_BYTES_WITH_STREAML) {
+                    DfgVertex* srcp = fromp;
+                    if (lsb != 0 || fromp->width() != width) {
+                        DfgSel* const selp = make<DfgSel>(flp, vtxp->dtypep());
+                        selp->fromp(fromp);
+                        selp->lsb(lsb);
+                        srcp = selp;
+                    }
+                    DfgStreamL* const replacementp = make<DfgStreamL>(flp, vtxp->dtypep());
+                    replacementp->lhsp(srcp);
+                    replacementp->rhsp(makeI32(flp, 8));
+                    replace(vtxp, replacementp);
+                    return;
+                }
+            }
+        }
     }
 
     void visit(DfgDiv* vtxp) override {
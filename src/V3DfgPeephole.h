@@ -63,6 +63,7 @@
     _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_AND_OF_NOT_AND_NEQ) \
     _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_AND_OF_NOT_AND_NOT) \
     _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_AND_WITH_ZERO) \
+    _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_CONCAT_OF_REVERSED_BYTES_WITH_STREAML) \
     _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_CONCAT_SEL_BOTTOM_AND_ZERO_WITH_SHIFTL) \
     _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_CONCAT_ZERO_AND_SEL_TOP_WITH_SHIFTR) \
     _FOR_EACH_DFG_PEEPHOLE_OPTIMIZATION_APPLY(macro, REPLACE_COND_DEC) \
@@ -121,6 +122,7 @@ public:
 
 struct V3DfgPeepholeContext final {
     const std::string m_label;  // Label to apply to stats
+    V3DfgPeepholeContext* const m_parentp = nullptr;  // Context to merge stats into, if any
 
     // Enable flags for each optimization
     bool m_enabled[VDfgPeepholePattern::_ENUM_END];
@@ -128,6 +130,7 @@ struct V3DfgPeepholeContext final {
     VDouble0 m_count[VDfgPeepholePattern::_ENUM_END];
 
     explicit V3DfgPeepholeContext(const std::string& label);
+    explicit V3DfgPeepholeContext(V3DfgPeepholeContext& parent);
     ~V3DfgPeepholeContext();
 };
 
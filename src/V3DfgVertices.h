@@ -40,6 +40,7 @@
 
 class DfgVertexVar VL_NOT_FINAL : public DfgVertexVariadic {
     AstVar* const m_varp;  // The AstVar associated with this vertex (not owned by this vertex)
+    AstVarScope* const m_varScopep;  // The AstVarScope associated with this vertex, if scoped
     bool m_hasModRefs = false;  // This AstVar is referenced outside the DFG, but in the module
     bool m_hasExtRefs = false;  // This AstVar is referenced from outside the module
 
@@ -47,9 +48,11 @@ class DfgVertexVar VL_NOT_FINAL : public DfgVertexVariadic {
     V3Hash selfHash() const final;
 
 public:
-    DfgVertexVar(DfgGraph& dfg, VDfgType type, AstVar* varp, uint32_t initialCapacity)
+    DfgVertexVar(DfgGraph& dfg, VDfgType type, AstVar* varp, AstVarScope* varScopep,
+                 uint32_t initialCapacity)
         : DfgVertexVariadic{dfg, type, varp->fileline(), dtypeFor(varp), initialCapacity}
-        , m_varp{varp} {}
+        , m_varp{varp}
+        , m_varScopep{varScopep} {}
     ASTGEN_MEMBERS_DfgVertexVar;
 
     DfgVertexVar* verticesNext() const {
@@ -62,6 +65,11 @@ public:
     bool isDrivenByDfg() const { return arity() > 0; }
 
     AstVar* varp() const { return m_varp; }
+    AstVarScope* varScopep() const { return m_varScopep; }
+    // The AstVarScope if scoped, otherwise the AstVar this vertex stands for
+    AstNode* nodep() const {
+        return m_varScopep ? static_cast<AstNode*>(m_varScopep) : static_cast<AstNode*>(m_varp);
+    }
     bool hasModRefs() const { return m_hasModRefs; }
     void setHasModRefs() { m_hasModRefs = true; }
     bool hasExtRefs() const { return m_hasExtRefs; }
@@ -77,7 +85,7 @@ public:
         // Keep if public
         if (varp()->isSigPublic()) return true;
         // Keep if written in non-DFG code
-        if (varp()->user3()) return true;
+        if (nodep()->user3()) return true;
         // Otherwise it can be removed
         return false;
     }
@@ -184,8 +192,8 @@ class DfgVarArray final : public DfgVertexVar {
     std::vector<DriverData> m_driverData;  // Additional data associate with each driver
 
 public:
-    DfgVarArray(DfgGraph& dfg, AstVar* varp)
-        : DfgVertexVar{dfg, dfgType(), varp, 4u} {
+    DfgVarArray(DfgGraph& dfg, AstVar* varp, AstVarScope* varScopep = nullptr)
+        : DfgVertexVar{dfg, dfgType(), varp, varScopep, 4u} {
         UASSERT_OBJ(VN_IS(varp->dtypeSkipRefp(), UnpackArrayDType), varp, "Non array DfgVarArray");
     }
     ASTGEN_MEMBERS_DfgVarArray;
@@ -241,8 +249,8 @@ class DfgVarPacked final : public DfgVertexVar {
     std::vector<DriverData> m_driverData;  // Additional data associate with each driver
 
 public:
-    DfgVarPacked(DfgGraph& dfg, AstVar* varp)
-        : DfgVertexVar{dfg, dfgType(), varp, 1u} {}
+    DfgVarPacked(DfgGraph& dfg, AstVar* varp, AstVarScope* varScopep = nullptr)
+        : DfgVertexVar{dfg, dfgType(), varp, varScopep, 1u} {}
     ASTGEN_MEMBERS_DfgVarPacked;
 
     bool isDrivenFullyByDfg() const { return arity() == 1 && source(0)->dtypep() == dtypep(); }
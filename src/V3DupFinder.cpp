@@ -27,59 +27,56 @@
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
 //######################################################################
 // V3DupFinder class functions
 
-V3DupFinder::size_type V3DupFinder::erase(AstNode* nodep) {
-    const auto& er = equal_range(m_hasher(nodep));
-    for (iterator it = er.first; it != er.second; ++it) {
-        if (nodep == it->second) {
-            erase(it);
+size_t V3DupFinder::erase(AstNode* nodep) {
+    const auto it = m_buckets.find(m_hasher(nodep));
+    if (it == m_buckets.end()) return 0;
+    Bucket& bucket = it->second;
+    // Usually the most recently inserted node is erased, so search backwards
+    for (auto bit = bucket.rbegin(); bit != bucket.rend(); ++bit) {
+        if (nodep == *bit) {
+            bucket.erase(std::next(bit).base());
+            if (bucket.empty()) m_buckets.erase(it);
+            --m_size;
             return 1;
         }
     }
     return 0;
 }
 
-V3DupFinder::iterator V3DupFinder::findDuplicate(AstNode* nodep, V3DupFinderUserSame* checkp) {
-    const auto& er = equal_range(m_hasher(nodep));
-    for (iterator it = er.first; it != er.second; ++it) {
-        AstNode* const node2p = it->second;
+AstNode* V3DupFinder::findDuplicate(AstNode* nodep, V3DupFinderUserSame* checkp) const {
+    const auto it = m_buckets.find(m_hasher(nodep));
+    if (it == m_buckets.end()) return nullptr;
+    for (AstNode* const node2p : it->second) {
         if (nodep == node2p) continue;  // Same node is not a duplicate
         if (checkp && !checkp->isSame(nodep, node2p)) continue;  // User says it is not a duplicate
         if (!nodep->sameTree(node2p)) continue;  // Not the same trees
         // Found duplicate
-        return it;
+        return node2p;
     }
-    return end();
+    return nullptr;
 }
 
 void V3DupFinder::dumpFile(const string& filename, bool tree) {
     const std::unique_ptr<std::ofstream> logp{V3File::new_ofstream(filename)};
     if (logp->fail()) v3fatal("Can't write " << filename);
 
-    std::unordered_map<int, int> dist;
+    // Dump in hash order, so dumps are stable
+    std::vector<const std::pair<const V3Hash, Bucket>*> sorted;
+    sorted.reserve(m_buckets.size());
+    for (const auto& pair : m_buckets) sorted.push_back(&pair);
+    std::sort(sorted.begin(), sorted.end(), [](const auto* ap, const auto* bp) {  //
+        return ap->first < bp->first;
+    });
 
-    V3Hash lasthash;
-    int num_in_bucket = 0;
-    for (auto it = cbegin(); true; ++it) {
-        if (it == cend() || lasthash != it->first) {
-            if (it != cend()) lasthash = it->first;
-            if (num_in_bucket) {
-                if (dist.find(num_in_bucket) == dist.end()) {
-                    dist.emplace(num_in_bucket, 1);
-                } else {
-                    ++dist[num_in_bucket];
-                }
-            }
-            num_in_bucket = 0;
-        }
-        if (it == cend()) break;
-        num_in_bucket++;
-    }
+    std::map<size_t, int> dist;
+    for (const auto* const pairp : sorted) ++dist[pairp->second.size()];
     *logp << "\n*** STATS:\n\n";
     *logp << "    #InBucket   Occurrences\n";
     for (const auto& i : dist) {
@@ -87,15 +84,14 @@ void V3DupFinder::dumpFile(const string& filename, bool tree) {
     }
 
     *logp << "\n*** Dump:\n\n";
-    for (const auto& it : *this) {
-        if (lasthash != it.first) {
-            lasthash = it.first;
-            *logp << "    " << it.first << '\n';
+    for (const auto* const pairp : sorted) {
+        *logp << "    " << pairp->first << '\n';
+        for (AstNode* const nodep : pairp->second) {
+            *logp << "\t" << nodep << '\n';
+            // Dumping the entire tree may make nearly N^2 sized dumps,
+            // because the nodes under this one may also be in the hash table!
+            if (tree) nodep->dumpTree(*logp, "    ");
         }
-        *logp << "\t" << it.second << '\n';
-        // Dumping the entire tree may make nearly N^2 sized dumps,
-        // because the nodes under this one may also be in the hash table!
-        if (tree) it.second->dumpTree(*logp, "    ");
     }
 }
 
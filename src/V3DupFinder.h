@@ -27,8 +27,9 @@
 #include "V3Error.h"
 #include "V3Hasher.h"
 
-#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 //============================================================================
 
@@ -39,13 +40,20 @@ struct V3DupFinderUserSame {
     virtual ~V3DupFinderUserSame() = default;
 };
 
-// This really is just a multimap from 'node hash' to 'node pointer', with some minor extensions.
-class V3DupFinder final : private std::multimap<V3Hash, AstNode*> {
-    using Super = std::multimap<V3Hash, AstNode*>;
+// This really is just a hash multimap from 'node hash' to 'node pointer', with some minor
+// extensions. Nodes with equal hashes are kept in insertion order, so the earliest inserted
+// duplicate is found first.
+class V3DupFinder final {
+    // TYPES
+    using Bucket = std::vector<AstNode*>;  // Nodes with the same hash, in insertion order
 
     // MEMBERS
-    const V3Hasher* const m_hasherp = nullptr;  // Pointer to owned hasher
+    const V3Hasher* m_hasherp = nullptr;  // Pointer to owned hasher
     const V3Hasher& m_hasher;  // Reference to hasher
+    std::unordered_map<V3Hash, Bucket> m_buckets;  // Nodes by hash
+    size_t m_size = 0;  // Number of nodes in all buckets
+
+    VL_UNCOPYABLE(V3DupFinder);
 
 public:
     // CONSTRUCTORS
@@ -54,32 +62,46 @@ public:
         , m_hasher{*m_hasherp} {}
     explicit V3DupFinder(const V3Hasher& hasher)
         : m_hasher{hasher} {}
+    V3DupFinder(V3DupFinder&& other) noexcept
+        : m_hasherp{other.m_hasherp}
+        , m_hasher{other.m_hasher}
+        , m_buckets{std::move(other.m_buckets)}
+        , m_size{other.m_size} {
+        other.m_hasherp = nullptr;
+    }
     ~V3DupFinder() {
         if (m_hasherp) delete m_hasherp;
     }
+    V3DupFinder& operator=(V3DupFinder&&) = delete;
 
     // METHODS
-
-    // Expose minimal set of superclass interface
-    using Super::begin;
-    using Super::cbegin;
-    using Super::cend;
-    using Super::clear;
-    using Super::const_iterator;
-    using Super::empty;
-    using Super::end;
-    using Super::erase;
-    using Super::iterator;
-    using Super::size_type;
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    void clear() {
+        m_buckets.clear();
+        m_size = 0;
+    }
 
     // Insert node into data structure
-    iterator insert(AstNode* nodep) { return emplace(m_hasher(nodep), nodep); }
+    void insert(AstNode* nodep) {
+        m_buckets[m_hasher(nodep)].push_back(nodep);
+        ++m_size;
+    }
+
+    // Erase node from data structure, return number of nodes erased (0 or 1)
+    size_t erase(AstNode* nodep);
 
-    // Erase node from data structure
-    size_type erase(AstNode* nodep);
+    // Return duplicate, if one was inserted, with optional user check for sameness.
+    // Returns nullptr if there is no duplicate.
+    AstNode* findDuplicate(AstNode* nodep, V3DupFinderUserSame* checkp = nullptr) const;
 
-    // Return duplicate, if one was inserted, with optional user check for sameness
-    iterator findDuplicate(AstNode* nodep, V3DupFinderUserSame* checkp = nullptr);
+    // Call 'f' on each node in the data structure
+    template <typename T_Callable>
+    void foreach(T_Callable&& f) const {
+        for (const auto& pair : m_buckets) {
+            for (AstNode* const nodep : pair.second) f(nodep);
+        }
+    }
 
     // Dump for debug
     void dumpFile(const string& filename, bool tree);
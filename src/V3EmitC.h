@@ -20,17 +20,26 @@
 #include "config_build.h"
 #include "verilatedos.h"
 
+#include <deque>
+
+class AstCFile;
+class AstNodeModule;
+
 //============================================================================
 
 class V3EmitC final {
 public:
-    static void emitcConstPool();
-    static void emitcHeaders();
     static void emitcImp();
     static void emitcInlines();
-    static void emitcModel();
     static void emitcSyms(bool dpiHdrOnly = false);
+    static void emitcSupport();  // Syms, ConstPool, Model and Headers, in parallel
     static void emitcFiles();
+
+    // Emitters that may run on V3ThreadPool, appending created files to 'cfilesr'
+    static void emitcConstPool(std::deque<AstCFile*>& cfilesr);
+    static void emitcHeader(const AstNodeModule* modp, std::deque<AstCFile*>& cfilesr);
+    static void emitcModel(std::deque<AstCFile*>& cfilesr);
+    static void emitcSyms(bool dpiHdrOnly, std::deque<AstCFile*>& cfilesr);
 };
 
 #endif  // Guard
@@ -103,7 +103,12 @@ string EmitCBaseVisitorConst::cFuncArgs(const AstCFunc* nodep) {
 
 void EmitCBaseVisitorConst::emitCFuncHeader(const AstCFunc* funcp, const AstNodeModule* modp,
                                             bool withScope) {
-    if (funcp->slow()) puts("VL_ATTR_COLD ");
+    if (funcp->slow()) {
+        puts("VL_ATTR_COLD ");
+    } else if (funcp->isHot()) {
+        puts("VL_ATTR_HOT ");
+    }
+    if (!funcp->section().empty()) puts("VL_ATTR_SECTION(\"" + funcp->section() + "\") ");
     if (!funcp->isConstructor() && !funcp->isDestructor()) {
         puts(funcp->rtnTypeVoid());
         puts(" ");
@@ -147,6 +152,8 @@ void EmitCBaseVisitorConst::emitVarDecl(const AstVar* nodep, bool asRef) {
         }
     };
 
+    if (nodep->isCacheLineAligned() && !asRef) puts("alignas(VL_CACHE_LINE_BYTES) ");
+
     if (nodep->isIO() && nodep->isSc()) {
         UASSERT_OBJ(basicp, nodep, "Unimplemented: Outputting this data type");
         if (nodep->attrScClocked() && nodep->isReadOnly()) {
@@ -70,6 +70,7 @@ public:
                && !varp->isStatic()  // Not a static variable
                && !varp->isSc()  // Aggregates can't be anon
                && !VN_IS(varp->dtypep()->skipRefp(), SampleQueueDType)  // Aggregates can't be anon
+               && !VN_IS(varp->dtypep()->skipRefp(), NBACommitQueueDType)  // Nor queues
                && (varp->basicp() && !varp->basicp()->isOpaque());  // Aggregates can't be anon
     }
     static bool isConstPoolMod(const AstNode* modp) {
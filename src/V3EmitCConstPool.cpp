@@ -38,13 +38,14 @@ class EmitCConstPool final : public EmitCConstInit {
     int m_outFileSize = 0;
     VDouble0 m_tablesEmitted;
     VDouble0 m_constsEmitted;
+    std::deque<AstCFile*>& m_cfilesr;  // Created files, added to the netlist by the caller
 
     // METHODS
 
-    V3OutCFile* newOutCFile() const {
+    V3OutCFile* newOutCFile() {
         const string fileName = v3Global.opt.makeDir() + "/" + topClassName() + "__ConstPool_"
                                 + cvtToStr(m_outFileCount) + ".cpp";
-        newCFile(fileName, /* slow: */ true, /* source: */ true);
+        m_cfilesr.push_back(createCFile(fileName, /* slow: */ true, /* source: */ true));
         V3OutCFile* const ofp = new V3OutCFile{fileName};
         ofp->putsHeader();
         ofp->puts("// DESCRIPTION: Verilator output: Constant pool\n");
@@ -107,7 +108,8 @@ class EmitCConstPool final : public EmitCConstInit {
     }
 
 public:
-    explicit EmitCConstPool(AstConstPool* poolp) {
+    EmitCConstPool(AstConstPool* poolp, std::deque<AstCFile*>& cfilesr)
+        : m_cfilesr{cfilesr} {
         emitVars(poolp);
         V3Stats::addStatSum("ConstPool, Tables emitted", m_tablesEmitted);
         V3Stats::addStatSum("ConstPool, Constants emitted", m_constsEmitted);
@@ -117,7 +119,7 @@ public:
 //######################################################################
 // EmitC static functions
 
-void V3EmitC::emitcConstPool() {
+void V3EmitC::emitcConstPool(std::deque<AstCFile*>& cfilesr) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    EmitCConstPool(v3Global.rootp()->constPoolp());
+    EmitCConstPool(v3Global.rootp()->constPoolp(), cfilesr);
 }
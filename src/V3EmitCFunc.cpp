@@ -192,6 +192,14 @@ void EmitCFunc::displayEmit(AstNode* nodep, bool isScan) {
                 puts("VL_FWRITEF(");
                 iterateConst(dispp->filep());
                 puts(",");
+            } else if (m_emitDispState.m_format.find('%') == string::npos) {
+                // Constant text, so skip runtime format parsing
+                UASSERT_OBJ(m_emitDispState.m_argsp.empty(), nodep, "Arguments without format");
+                puts("VL_WRITES(");
+                ofp()->putsQuoted(m_emitDispState.m_format);
+                puts(");\n");
+                m_emitDispState.clear();
+                return;
             } else {
                 puts("VL_WRITEF(");
             }
@@ -414,7 +422,7 @@ void EmitCFunc::emitCCallArgs(const AstNodeCCall* nodep, const string& selfPoint
     bool comma = false;
     if (nodep->funcp()->isLoose() && !nodep->funcp()->isStatic()) {
         UASSERT_OBJ(!selfPointer.empty(), nodep, "Call to loose method without self pointer");
-        puts(selfPointer);
+        puts(selfPointerLocal(selfPointer));
         comma = true;
     }
     if (!nodep->argTypes().empty()) {
@@ -426,7 +434,8 @@ void EmitCFunc::emitCCallArgs(const AstNodeCCall* nodep, const string& selfPoint
     puts(")");
 }
 
-void EmitCFunc::emitDereference(const string& pointer) {
+void EmitCFunc::emitDereference(const string& selfPointer) {
+    const string& pointer = selfPointerLocal(selfPointer);
     if (pointer[0] == '(' && pointer[1] == '&') {
         // remove "address of" followed by immediate dereference
         // Note: this relies on only the form '(&OBJECT)' being used by Verilator
@@ -618,10 +627,13 @@ void EmitCFunc::emitVarReset(AstVar* varp) {
                                    VN_AS(valuep, Const));
             }
         } else if (AstUnpackArrayDType* const adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
-            if (initarp->defaultp()) {
+            AstConst* const defaultp = VN_AS(initarp->defaultp(), Const);
+            if (defaultp && adtypep->isSparse() && defaultp->isZero()) {
+                // Sparse arrays are initially zero, don't allocate every page
+            } else if (defaultp) {
                 puts("for (int __Vi = 0; __Vi < " + cvtToStr(adtypep->elementsConst()));
                 puts("; ++__Vi) {\n");
-                emitSetVarConstant(varNameProtected + "[__Vi]", VN_AS(initarp->defaultp(), Const));
+                emitSetVarConstant(varNameProtected + "[__Vi]", defaultp);
                 puts("}\n");
             }
             const auto& mapr = initarp->map();
@@ -638,6 +650,14 @@ void EmitCFunc::emitVarReset(AstVar* varp) {
     }
 }
 
+bool EmitCFunc::varResetZero(const AstVar* varp, const AstBasicDType* basicp) {
+    return (varp->attrFileDescr()  // Zero so we don't do file IO if never $fopen
+            || varp->isFuncLocal()  // Randomization too slow
+            || (basicp && basicp->isZeroInit())
+            || (v3Global.opt.underlineZero() && !varp->name().empty() && varp->name()[0] == '_')
+            || (v3Global.opt.xInitial() == "fast" || v3Global.opt.xInitial() == "0"));
+}
+
 string EmitCFunc::emitVarResetRecurse(const AstVar* varp, const string& varNameProtected,
                                       AstNodeDType* dtypep, int depth, const string& suffix) {
     dtypep = dtypep->skipRefp();
@@ -667,11 +687,35 @@ string EmitCFunc::emitVarResetRecurse(const AstVar* varp, const string& varNameP
         const string cvtarray = (adtypep->subDTypep()->isWide() ? ".data()" : "");
         return emitVarResetRecurse(varp, varNameProtected, adtypep->subDTypep(), depth + 1,
                                    suffix + ".atDefault()" + cvtarray);
-    } else if (VN_IS(dtypep, SampleQueueDType)) {
+    } else if (VN_IS(dtypep, SampleQueueDType) || VN_IS(dtypep, NBACommitQueueDType)) {
         return "";
     } else if (const AstUnpackArrayDType* const adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
         UASSERT_OBJ(adtypep->hi() >= adtypep->lo(), varp,
                     "Should have swapped msb & lsb earlier.");
+        // Sparse arrays read as zero until written, releasing pages resets them
+        if (adtypep->isSparse()) return varNameProtected + suffix + ".clear();\n";
+        // Randomly reset arrays of integral elements with a single call, which checks the
+        // reset mode once rather than per element, as memories may be very large
+        const AstNodeDType* const subp = adtypep->subDTypep()->skipRefp();
+        const AstBasicDType* const subBasicp = subp->basicp();
+        if ((VN_IS(subp, BasicDType) || VN_IS(subp, PackArrayDType) || VN_IS(subp, EnumDType))
+            && subBasicp && subBasicp->keyword().isIntNumeric() && !varp->valuep()
+            && !varResetZero(varp, subBasicp)
+            && !(v3Global.opt.xInitialEdge() && varp->isUsedClock())
+            && (!subp->isWide() || subp->widthWords() == VL_WORDS_I(subp->widthMin()))) {
+            // Element type as chosen by AstNodeDType::cType
+            const int width = subp->widthMin();
+            const char* const typeLetter = width <= 8              ? "C"
+                                           : width <= 16           ? "S"
+                                           : width <= VL_IDATASIZE ? "I"
+                                           : subp->isQuad()        ? "Q"
+                                                                   : "W";
+            const string firstp = subp->isWide() ? varNameProtected + suffix + "[0].data()"
+                                                 : "&" + varNameProtected + suffix + "[0]";
+            splitSizeInc(1);
+            return string{"VL_RAND_RESET_ARRAY_"} + typeLetter + "(" + cvtToStr(width) + ", "
+                   + firstp + ", " + cvtToStr(adtypep->elementsConst()) + ");\n";
+        }
         const string ivar = string{"__Vi"} + cvtToStr(depth);
         const string pre = ("for (int " + ivar + " = " + cvtToStr(0) + "; " + ivar + " < "
                             + cvtToStr(adtypep->elementsConst()) + "; ++" + ivar + ") {\n");
@@ -702,12 +746,7 @@ string EmitCFunc::emitVarResetRecurse(const AstVar* varp, const string& varNameP
     } else if (basicp && basicp->isDynamicTriggerScheduler()) {
         return "";
     } else if (basicp) {
-        const bool zeroit
-            = (varp->attrFileDescr()  // Zero so we don't do file IO if never $fopen
-               || varp->isFuncLocal()  // Randomization too slow
-               || (basicp && basicp->isZeroInit())
-               || (v3Global.opt.underlineZero() && !varp->name().empty() && varp->name()[0] == '_')
-               || (v3Global.opt.xInitial() == "fast" || v3Global.opt.xInitial() == "0"));
+        const bool zeroit = varResetZero(varp, basicp);
         const bool slow = !varp->isFuncLocal() && !varp->isClassMember();
         splitSizeInc(1);
         if (dtypep->isWide()) {  // Handle unpacked; not basicp->isWide
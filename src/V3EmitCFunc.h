@@ -24,6 +24,7 @@
 #include "V3Global.h"
 
 #include <algorithm>
+#include <cctype>
 #include <map>
 #include <unordered_set>
 #include <vector>
@@ -148,6 +149,8 @@ protected:
     bool m_useSelfForThis = false;  // Replace "this" with "vlSelf"
     const AstNodeModule* m_modp = nullptr;  // Current module being emitted
     const AstCFunc* m_cfuncp = nullptr;  // Current function being emitted
+    // Local variable holding each sub-instance self pointer hoisted in current function
+    std::map<string, string> m_selfPointerLocals;
 
 public:
     // METHODS
@@ -159,6 +162,17 @@ public:
     bool splitNeeded() const {
         return v3Global.opt.outputSplit() && m_splitSize >= v3Global.opt.outputSplit();
     }
+    // Is splitting needed before emitting the given function?
+    bool splitNeeded(const AstCFunc* nodep) const {
+        if (!v3Global.opt.outputSplitStable()) return splitNeeded();
+        const int split = v3Global.opt.outputSplit();
+        if (!split) return false;
+        // Content defined boundaries: only cut before functions whose name hashes to a
+        // boundary, so an edit moves just the nearby boundaries, not all following ones
+        if (m_splitSize < split / 2) return false;
+        if (m_splitSize >= split * 2) return true;
+        return V3Hash{nodep->name()}.value() % 4 == 0;
+    }
 
     // METHODS
     void displayNode(AstNode* nodep, AstScopeName* scopenamep, const string& vformat,
@@ -189,12 +203,13 @@ public:
     void emitOpName(AstNode* nodep, const string& format, AstNode* lhsp, AstNode* rhsp,
                     AstNode* thsp);
     void emitCCallArgs(const AstNodeCCall* nodep, const string& selfPointer);
-    void emitDereference(const string& pointer);
+    void emitDereference(const string& selfPointer);
     void emitCvtPackStr(AstNode* nodep);
     void emitCvtWideArray(AstNode* nodep, AstNode* fromp);
     void emitConstant(AstConst* nodep, AstVarRef* assigntop, const string& assignString);
     void emitSetVarConstant(const string& assignString, AstConst* constp);
     void emitVarReset(AstVar* varp);
+    static bool varResetZero(const AstVar* varp, const AstBasicDType* basicp);
     string emitVarResetRecurse(const AstVar* varp, const string& varNameProtected,
                                AstNodeDType* dtypep, int depth, const string& suffix);
     void emitChangeDet();
@@ -205,6 +220,52 @@ public:
         m_emitConstInit = true;
         iterateConst(initp);
     }
+    // True if a string constant that can be emitted as a plain C string literal
+    static bool isCStringLiteral(const AstNodeExpr* nodep) {
+        const AstConst* const constp = VN_CAST(nodep, Const);
+        return constp && constp->num().isString()
+               && constp->num().toString().find('\0') == string::npos;
+    }
+    // Emit a string operand, as a plain C string literal if possible, avoiding a std::string
+    // temporary where a 'const char*' overload exists
+    void emitStringOperand(AstNodeExpr* nodep) {
+        if (isCStringLiteral(nodep)) {
+            putsQuoted(VN_AS(nodep, Const)->num().toString());
+        } else {
+            iterateConst(nodep);
+        }
+    }
+    // If the assignment is 's = {s, a, b, ...}' on a string, return the operands appended to
+    // 's', in order, so it can be appended in place.  Otherwise returns an empty vector.
+    static std::vector<AstNodeExpr*> stringAppendOperands(AstNodeAssign* nodep) {
+        std::vector<AstNodeExpr*> operands;
+        const AstVarRef* const lhsp = VN_CAST(nodep->lhsp(), VarRef);
+        if (!lhsp || !lhsp->isString()) return operands;
+        AstNodeExpr* exprp = nodep->rhsp();
+        while (AstConcatN* const catp = VN_CAST(exprp, ConcatN)) {
+            operands.push_back(catp->rhsp());
+            exprp = catp->lhsp();
+        }
+        const AstVarRef* const basep = VN_CAST(exprp, VarRef);
+        if (operands.empty() || !basep || basep->varp() != lhsp->varp()
+            || basep->selfPointer() != lhsp->selfPointer()) {
+            operands.clear();
+            return operands;
+        }
+        std::reverse(operands.begin(), operands.end());
+        if (operands.size() > 1) {
+            // Later operands would see earlier appends if they read the string
+            for (AstNodeExpr* const operandp : operands) {
+                if (operandp->exists([&](const AstVarRef* refp) {  //
+                        return refp->varp() == lhsp->varp();
+                    })) {
+                    operands.clear();
+                    break;
+                }
+            }
+        }
+        return operands;
+    }
     void putCommaIterateNext(AstNode* nodep, bool comma = false) {
         for (AstNode* subnodep = nodep; subnodep; subnodep = subnodep->nextp()) {
             if (comma) puts(", ");
@@ -213,12 +274,44 @@ public:
         }
     }
 
+    // Sub-instance pointers used repeatedly are loaded once into locals at function
+    // entry, so the C++ compiler need not reload them after every store to the design.
+    void emitSelfPointerLocals(AstCFunc* nodep) {
+        std::map<string, int> uses;  // Sorted for stable output
+        const auto count = [&](const string& selfPointer) {
+            static const string prefix = "vlSelf->";
+            if (selfPointer.compare(0, prefix.size(), prefix) != 0) return;
+            const string cellName = selfPointer.substr(prefix.size());
+            const bool isCell = std::all_of(cellName.begin(), cellName.end(), [](char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+            });
+            if (isCell) ++uses[selfPointer];
+        };
+        nodep->foreach([&](const AstNodeVarRef* refp) {
+            if (!refp->varp()->isIfaceRef()) count(refp->selfPointerProtect(true));
+        });
+        nodep->foreach([&](const AstCCall* callp) { count(callp->selfPointerProtect(true)); });
+        for (const auto& pair : uses) {
+            if (pair.second < 2) continue;
+            const string localName = "__Vcell_" + pair.first.substr(pair.first.find("->") + 2);
+            puts("auto* const __restrict " + localName + " VL_ATTR_UNUSED = " + pair.first
+                 + ";\n");
+            m_selfPointerLocals.emplace(pair.first, localName);
+        }
+    }
+    const string& selfPointerLocal(const string& selfPointer) const {
+        const auto it = m_selfPointerLocals.find(selfPointer);
+        return it == m_selfPointerLocals.end() ? selfPointer : it->second;
+    }
+
     // VISITORS
     using EmitCConstInit::visit;
     void visit(AstCFunc* nodep) override {
         VL_RESTORER(m_useSelfForThis);
         VL_RESTORER(m_cfuncp);
+        VL_RESTORER(m_selfPointerLocals);
         m_cfuncp = nodep;
+        m_selfPointerLocals.clear();
 
         splitSizeInc(nodep);
 
@@ -255,6 +348,12 @@ public:
                 m_useSelfForThis = true;
                 puts("if (false && vlSelf) {}  // Prevent unused\n");
                 if (!VN_IS(m_modp, Class)) puts(symClassAssign());
+                if (nodep->profilerId() >= 0) {
+                    puts("const decltype(vlSymsp->_vm_pgoProfiler)::Scope __Vpgo{"
+                         "vlSymsp->_vm_pgoProfiler, "
+                         + cvtToStr(nodep->profilerId()) + "};\n");
+                }
+                emitSelfPointerLocals(nodep);
             }
         }
 
@@ -296,6 +395,18 @@ public:
     }
 
     void visit(AstNodeAssign* nodep) override {
+        const std::vector<AstNodeExpr*> appendps = stringAppendOperands(nodep);
+        if (!appendps.empty()) {
+            // Append to the string in place, rather than building and copying a new one
+            iterateAndNextConstNull(nodep->lhsp());
+            for (AstNodeExpr* const operandp : appendps) {
+                puts(".append(");
+                emitStringOperand(operandp);
+                puts(")");
+            }
+            puts(";\n");
+            return;
+        }
         bool paren = true;
         bool decind = false;
         bool rhs = true;
@@ -497,10 +608,22 @@ public:
         iterateChildrenConst(nodep);
     }
     void visit(AstCoverDecl* nodep) override {
+        const auto binRef = [](AstCoverDecl* declp) {
+            // First thread's counter if per-thread
+            return string{"&(vlSymsp->__Vcoverage["}
+                   + (v3Global.opt.coveragePerThread() ? "0][" : "")
+                   + cvtToStr(declp->dataDeclThisp()->binNum()) + "])";
+        };
         puts("vlSelf->__vlCoverInsert(");  // As Declared in emitCoverageDecl
-        puts("&(vlSymsp->__Vcoverage[");
-        puts(cvtToStr(nodep->dataDeclThisp()->binNum()));
-        puts("])");
+        if (nodep->derivedBasep()) {
+            // No bin of its own, count derived from two counted bins
+            puts(binRef(nodep->derivedBasep()));
+            puts(", ");
+            puts(binRef(nodep->derivedSubp()));
+        } else {
+            puts(binRef(nodep));
+            puts(", nullptr");
+        }
         // If this isn't the first instantiation of this module under this
         // design, don't really count the bucket, and rely on verilator_cov to
         // aggregate counts.  This is because Verilator combines all
@@ -525,7 +648,14 @@ public:
         puts(");\n");
     }
     void visit(AstCoverInc* nodep) override {
-        if (v3Global.opt.threads()) {
+        if (v3Global.opt.coveragePerThread()) {
+            // Modulo as the context may have more threads than the model
+            puts("++(vlSymsp->__Vcoverage[Verilated::threadIndex() % ");
+            puts(cvtToStr(v3Global.opt.threads()));
+            puts("][");
+            puts(cvtToStr(nodep->declp()->dataDeclThisp()->binNum()));
+            puts("]);\n");
+        } else if (v3Global.opt.threads()) {
             puts("vlSymsp->__Vcoverage[");
             puts(cvtToStr(nodep->declp()->dataDeclThisp()->binNum()));
             puts("].fetch_add(1, std::memory_order_relaxed);\n");
@@ -692,7 +822,11 @@ public:
         emitCvtPackStr(nodep->filenamep());
         putbs(", ");
         {
-            const bool need_ptr = !VN_IS(nodep->memp()->dtypep(), AssocArrayDType);
+            // Sparse and associative arrays are passed to a C++ template
+            const AstUnpackArrayDType* const adtypep
+                = VN_CAST(nodep->memp()->dtypep()->skipRefp(), UnpackArrayDType);
+            const bool need_ptr = !VN_IS(nodep->memp()->dtypep(), AssocArrayDType)
+                                  && !(adtypep && adtypep->isSparse());
             if (need_ptr) puts(" &(");
             iterateAndNextConstNull(nodep->memp());
             if (need_ptr) puts(")");
@@ -839,6 +973,7 @@ public:
     }
     void visit(AstWhile* nodep) override {
         iterateAndNextConstNull(nodep->precondsp());
+        if (nodep->independent()) puts("VL_LOOP_VECTORIZE\n");
         puts("while (");
         iterateAndNextConstNull(nodep->condp());
         puts(") {\n");
@@ -1001,6 +1136,29 @@ public:
             emitOpName(nodep, nodep->emitC(), nodep->lhsp(), nullptr, nullptr);
         }
     }
+    void emitStringEquality(AstNodeBiop* nodep) {
+        // A literal on one side compares through the 'const char*' overload, with no temporary
+        // (but never on both sides, which would compare pointers)
+        const bool lhsLiteral = isCStringLiteral(nodep->lhsp());
+        const bool rhsLiteral = isCStringLiteral(nodep->rhsp());
+        putbs("(");
+        if (lhsLiteral && !rhsLiteral) {
+            emitStringOperand(nodep->lhsp());
+        } else {
+            iterateAndNextConstNull(nodep->lhsp());
+        }
+        puts(" ");
+        putbs(nodep->emitSimpleOperator());
+        puts(" ");
+        if (rhsLiteral && !lhsLiteral) {
+            emitStringOperand(nodep->rhsp());
+        } else {
+            iterateAndNextConstNull(nodep->rhsp());
+        }
+        puts(")");
+    }
+    void visit(AstEqN* nodep) override { emitStringEquality(nodep); }
+    void visit(AstNeqN* nodep) override { emitStringEquality(nodep); }
     void visit(AstNodeBiop* nodep) override {
         if (nodep->emitCheckMaxWords() && nodep->widthWords() > VL_MULS_MAX_WORDS) {
             nodep->v3warn(
@@ -1021,6 +1179,18 @@ public:
             emitOpName(nodep, nodep->emitC(), nodep->lhsp(), nodep->rhsp(), nullptr);
         }
     }
+    void visit(AstArraySel* nodep) override {
+        // Read sparse arrays through a const reference, which does not allocate pages
+        const AstUnpackArrayDType* const adtypep
+            = VN_CAST(nodep->fromp()->dtypep()->skipRefp(), UnpackArrayDType);
+        const AstNodeVarRef* const varrefp = VN_CAST(nodep->fromp(), NodeVarRef);
+        if (adtypep && adtypep->isSparse() && varrefp && varrefp->access().isReadOnly()) {
+            emitOpName(nodep, "vlstd::as_const(%li)%k[%ri]", nodep->fromp(), nodep->bitp(),
+                       nullptr);
+        } else {
+            emitOpName(nodep, nodep->emitC(), nodep->fromp(), nodep->bitp(), nullptr);
+        }
+    }
     void visit(AstNodeTriop* nodep) override {
         UASSERT_OBJ(!emitSimpleOk(nodep), nodep, "Triop cannot be described in a simple way");
         emitOpName(nodep, nodep->emitC(), nodep->lhsp(), nodep->rhsp(), nodep->thsp());
@@ -1116,6 +1286,20 @@ public:
     void visit(AstStreamL* nodep) override {
         // Attempt to use a "fast" stream function for slice size = power of 2
         if (!nodep->isWide()) {
+            // Byte swap of a whole 16, 32 or 64-bit word
+            const int width = nodep->widthMin();
+            if (VN_AS(nodep->rhsp(), Const)->toUInt() == 8 && nodep->lhsp()->widthMin() == width
+                && (width == 16 || width == 32 || width == 64)) {
+                puts("VL_STREAML_BSWAP_");
+                emitIQW(nodep);
+                emitIQW(nodep->lhsp());
+                puts("(");
+                puts(cvtToStr(width));
+                puts(", ");
+                iterateAndNextConstNull(nodep->lhsp());
+                puts(")");
+                return;
+            }
             const uint32_t isPow2 = VN_AS(nodep->rhsp(), Const)->num().countOnes() == 1;
             const uint32_t sliceSize = VN_AS(nodep->rhsp(), Const)->toUInt();
             if (isPow2 && sliceSize <= (nodep->isQuad() ? sizeof(uint64_t) : sizeof(uint32_t))) {
@@ -169,8 +169,11 @@ class EmitCHeader final : public EmitCConstInit {
         if (v3Global.opt.coverage() && !VN_IS(modp, Class)) {
             decorateFirst(first, section);
             puts("void __vlCoverInsert(");
-            puts(v3Global.opt.threads() ? "std::atomic<uint32_t>" : "uint32_t");
-            puts("* countp, bool enable, const char* filenamep, int lineno, int column,\n");
+            const string countType = v3Global.opt.threads() && !v3Global.opt.coveragePerThread()
+                                         ? "std::atomic<uint32_t>"
+                                         : "uint32_t";
+            puts(countType + "* countp, " + countType + "* subp, bool enable,\n");
+            puts("const char* filenamep, int lineno, int column,\n");
             puts("const char* hierp, const char* pagep, const char* commentp, const char* "
                  "linescovp);\n");
         }
@@ -338,12 +341,12 @@ class EmitCHeader final : public EmitCConstInit {
         emitFuncDecls(modp, /* inClassBody: */ false);
     }
 
-    explicit EmitCHeader(const AstNodeModule* modp) {
+    EmitCHeader(const AstNodeModule* modp, std::deque<AstCFile*>& cfilesr) {
         UINFO(5, "  Emitting header for " << prefixNameProtect(modp) << endl);
 
         // Open output file
         const string filename = v3Global.opt.makeDir() + "/" + prefixNameProtect(modp) + ".h";
-        newCFile(filename, /* slow: */ false, /* source: */ false);
+        cfilesr.push_back(createCFile(filename, /* slow: */ false, /* source: */ false));
         m_ofp = v3Global.opt.systemC() ? new V3OutScFile{filename} : new V3OutCFile{filename};
 
         ofp()->putsHeader();
@@ -376,18 +379,14 @@ class EmitCHeader final : public EmitCConstInit {
     ~EmitCHeader() override = default;
 
 public:
-    static void main(const AstNodeModule* modp) { EmitCHeader emitCHeader{modp}; }
+    static void main(const AstNodeModule* modp, std::deque<AstCFile*>& cfilesr) {
+        EmitCHeader emitCHeader{modp, cfilesr};
+    }
 };
 
 //######################################################################
 // EmitC class functions
 
-void V3EmitC::emitcHeaders() {
-    UINFO(2, __FUNCTION__ << ": " << endl);
-
-    // Process each module in turn
-    for (const AstNode* nodep = v3Global.rootp()->modulesp(); nodep; nodep = nodep->nextp()) {
-        if (VN_IS(nodep, Class)) continue;  // Declared with the ClassPackage
-        EmitCHeader::main(VN_AS(nodep, NodeModule));
-    }
+void V3EmitC::emitcHeader(const AstNodeModule* modp, std::deque<AstCFile*>& cfilesr) {
+    EmitCHeader::main(modp, cfilesr);
 }
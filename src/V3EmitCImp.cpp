@@ -27,6 +27,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -153,6 +154,44 @@ public:
     }
 };
 
+//######################################################################
+// Estimate the C++ compile cost of a function, used to balance split files
+
+class EmitCCostEstimate final : public VNVisitorConst {
+    // MEMBERS
+    size_t m_cost = 0;  // Estimated cost so far
+
+    // VISITORS
+    void visit(AstCFunc* nodep) override {
+        m_cost += 10;  // Per function overhead: prologue, local declarations
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNodeSimpleText* nodep) override {
+        m_cost += 1 + nodep->text().size() / 16;  // Opaque text, guess by length
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNodeStmt* nodep) override {
+        m_cost += 2;
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNodeExpr* nodep) override {
+        ++m_cost;
+        // Wide operations expand into per word loops or VL_*_W template functions
+        if (nodep->dtypep() && nodep->isWide()) m_cost += nodep->widthWords();
+        iterateChildrenConst(nodep);
+    }
+    void visit(AstNode* nodep) override {
+        ++m_cost;
+        iterateChildrenConst(nodep);
+    }
+
+    // CONSTRUCTOR
+    explicit EmitCCostEstimate(AstCFunc* cfuncp) { iterateConst(cfuncp); }
+
+public:
+    static size_t estimate(AstCFunc* cfuncp) { return EmitCCostEstimate{cfuncp}.m_cost; }
+};
+
 //######################################################################
 // Internal EmitC implementation
 
@@ -164,9 +203,38 @@ class EmitCImp final : EmitCFunc {
     std::string m_subFileName;  // substring added to output filenames
     V3UniqueNames m_uniqueNames;  // For generating unique file names
     std::deque<AstCFile*>& m_cfilesr;  // cfiles generated by this emit
+    std::unordered_set<const AstCFunc*> m_splitBefore;  // Functions starting a new split file
 
     // METHODS
-    void openNextOutputFile(const std::set<string>& headers, const string& subFileName) {
+    // Choose the functions to start each new file at, to balance the estimated compile cost
+    // of the files, rather than fill each up to --output-split and leave a small remainder
+    void planSplits(const std::vector<AstCFunc*>& funcps) {
+        m_splitBefore.clear();
+        const size_t limit = v3Global.opt.outputSplit();
+        if (!limit || v3Global.opt.outputSplitStable()) return;
+        std::vector<size_t> costs;
+        costs.reserve(funcps.size());
+        size_t total = 0;
+        for (AstCFunc* const funcp : funcps) {
+            costs.push_back(EmitCCostEstimate::estimate(funcp));
+            total += costs.back();
+        }
+        const size_t nFiles = (total + limit - 1) / limit;
+        if (nFiles <= 1) return;
+        const size_t target = (total + nFiles - 1) / nFiles;
+        size_t size = 0;
+        for (size_t i = 0; i < funcps.size(); ++i) {
+            // Cut where the middle of the function would cross the target, so an
+            // oversized function is more likely to get a file of its own
+            if (size && size + costs[i] / 2 > target) {
+                m_splitBefore.insert(funcps[i]);
+                size = 0;
+            }
+            size += costs[i];
+        }
+    }
+    void openNextOutputFile(const std::set<string>& headers, const string& subFileName,
+                            const AstCFunc* firstFuncp = nullptr) {
         UASSERT(!m_ofp, "Output file already open");
 
         splitSizeReset();  // Reset file size tracking
@@ -182,6 +250,11 @@ class EmitCImp final : EmitCFunc {
             string filename = v3Global.opt.makeDir() + "/" + prefixNameProtect(m_fileModp);
             if (!subFileName.empty()) {
                 filename += "__" + subFileName;
+                // With --output-split-stable, name by the first function rather than by
+                // sequence number, so unchanged parts keep their file names
+                if (firstFuncp && v3Global.opt.outputSplitStable()) {
+                    filename += "__" + V3Hash{firstFuncp->name()}.toString();
+                }
                 filename = m_uniqueNames.get(filename);
             }
             if (m_slow) filename += "__Slow";
@@ -197,6 +270,7 @@ class EmitCImp final : EmitCFunc {
         // Include files
         puts("\n#include \"verilated.h\"\n");
         if (v3Global.dpi()) puts("#include \"verilated_dpi.h\"\n");
+        if (v3Global.opt.vpiHooks()) puts("#include \"verilated_vpi.h\"\n");
         puts("\n");
         puts("#include \"" + symClassName() + ".h\"\n");
         for (const string& name : headers) puts("#include \"" + name + ".h\"\n");
@@ -314,32 +388,55 @@ class EmitCImp final : EmitCFunc {
             // function. This gets around gcc slowness constructing all of the template
             // arguments.
             puts("void " + prefixNameProtect(m_modp) + "::__vlCoverInsert(");
-            puts(v3Global.opt.threads() ? "std::atomic<uint32_t>" : "uint32_t");
-            puts("* countp, bool enable, const char* filenamep, int lineno, int column,\n");
+            const string countType = v3Global.opt.threads() && !v3Global.opt.coveragePerThread()
+                                         ? "std::atomic<uint32_t>"
+                                         : "uint32_t";
+            puts(countType + "* countp, " + countType + "* subp, bool enable,\n");
+            puts("const char* filenamep, int lineno, int column,\n");
             puts("const char* hierp, const char* pagep, const char* commentp, const char* "
                  "linescovp) "
                  "{\n");
-            if (v3Global.opt.threads()) {
+            if (v3Global.opt.threads() && !v3Global.opt.coveragePerThread()) {
                 puts("assert(sizeof(uint32_t) == sizeof(std::atomic<uint32_t>));\n");
                 puts("uint32_t* count32p = reinterpret_cast<uint32_t*>(countp);\n");
+                puts("uint32_t* sub32p = reinterpret_cast<uint32_t*>(subp);\n");
             } else {
                 puts("uint32_t* count32p = countp;\n");
+                puts("uint32_t* sub32p = subp;\n");
             }
             // static doesn't need save-restore as is constant
             puts("static uint32_t fake_zero_count = 0;\n");
             // Used for second++ instantiation of identical bin
             puts("if (!enable) count32p = &fake_zero_count;\n");
+            puts("if (!enable && sub32p) sub32p = &fake_zero_count;\n");
             puts("*count32p = 0;\n");
-            puts("VL_COVER_INSERT(vlSymsp->_vm_contextp__->coveragep(), count32p,");
-            puts("  \"filename\",filenamep,");
-            puts("  \"lineno\",lineno,");
-            puts("  \"column\",column,\n");
+            // A disabled bin is the single fake_zero_count
+            const string shards
+                = v3Global.opt.coveragePerThread()
+                      ? " enable ? " + cvtToStr(v3Global.opt.threads()) + " : 1,"
+                            + " sizeof(vlSymsp->__Vcoverage[0]) / sizeof(uint32_t),"
+                      : " 1, 1,";
             // Need to move hier into scopes and back out if do this
             // puts( "\"hier\",std::string{vlSymsp->name()} + hierp,");
-            puts("\"hier\",std::string{name()} + hierp,");
-            puts("  \"page\",pagep,");
-            puts("  \"comment\",commentp,");
-            puts("  (linescovp[0] ? \"linescov\" : \"\"), linescovp);\n");
+            const string keys = "  \"filename\",filenamep,  \"lineno\",lineno,"
+                                "  \"column\",column,\n"
+                                "\"hier\",std::string{name()} + hierp,  \"page\",pagep,"
+                                "  \"comment\",commentp,"
+                                "  (linescovp[0] ? \"linescov\" : \"\"), linescovp);\n";
+            // Derived bins count the difference of two counted bins
+            puts("if (sub32p) {\n");
+            puts("VL_COVER_INSERT_DIFF(vlSymsp->_vm_contextp__->coveragep(), count32p, sub32p,");
+            puts(shards);
+            puts(keys);
+            puts("} else {\n");
+            if (v3Global.opt.coveragePerThread()) {
+                puts("VL_COVER_INSERT_SHARDS(vlSymsp->_vm_contextp__->coveragep(), count32p,");
+                puts(shards);
+            } else {
+                puts("VL_COVER_INSERT(vlSymsp->_vm_contextp__->coveragep(), count32p,");
+            }
+            puts(keys);
+            puts("}\n");
             puts("}\n");
             splitSizeInc(10);
         }
@@ -351,6 +448,20 @@ class EmitCImp final : EmitCFunc {
         puts("}\n");
         splitSizeInc(10);
     }
+    static bool isBulkSavable(const AstVar* varp) {
+        // Unpacked arrays of plain scalar elements
+        const AstNodeDType* dtypep = varp->dtypeSkipRefp();
+        if (!VN_IS(dtypep, UnpackArrayDType)) return false;
+        while (const AstUnpackArrayDType* const arrayp = VN_CAST(dtypep, UnpackArrayDType)) {
+            if (arrayp->isSparse()) return false;
+            dtypep = arrayp->subDTypep()->skipRefp();
+        }
+        if (const AstBasicDType* const basicp = VN_CAST(dtypep, BasicDType)) {
+            return basicp->keyword().isIntNumeric() || basicp->isDouble();
+        }
+        return VN_IS(dtypep, EnumDType) || VN_IS(dtypep, PackArrayDType)
+               || (VN_IS(dtypep, NodeUOrStructDType) && dtypep->isIntegralOrPacked());
+    }
     void emitSavableImp(const AstNodeModule* modp) {
         if (v3Global.opt.savable()) {
             puts("\n// Savable\n");
@@ -394,11 +505,19 @@ class EmitCImp final : EmitCFunc {
                         } else if (varp->isParam()) {
                         } else if (varp->isStatic() && varp->isConst()) {
                         } else if (varp->basicp() && varp->basicp()->isTriggerVec()) {
+                        } else if (isBulkSavable(varp)) {
+                            // Contiguous, so same layout as saving each element, but large
+                            // arrays are page aligned so may be mapped when restored
+                            const string name = varp->nameProtect();
+                            puts(string{"os."} + (de ? "readBulk" : "writeBulk") + "(&" + name
+                                 + ", sizeof(" + name + "));\n");
                         } else {
                             int vects = 0;
                             AstNodeDType* elementp = varp->dtypeSkipRefp();
+                            // Sparse arrays save their written pages, as an element
                             for (AstUnpackArrayDType* arrayp = VN_CAST(elementp, UnpackArrayDType);
-                                 arrayp; arrayp = VN_CAST(elementp, UnpackArrayDType)) {
+                                 arrayp && !arrayp->isSparse();
+                                 arrayp = VN_CAST(elementp, UnpackArrayDType)) {
                                 const int vecnum = vects++;
                                 UASSERT_OBJ(arrayp->hi() >= arrayp->lo(), varp,
                                             "Should have swapped msb & lsb earlier.");
@@ -413,7 +532,7 @@ class EmitCImp final : EmitCFunc {
                             if (basicp && basicp->keyword().isMTaskState()) continue;
                             // Want to detect types that are represented as arrays
                             // (i.e. packed types of more than 64 bits).
-                            if (elementp->isWide()
+                            if (elementp->isWide() && !VN_IS(elementp, UnpackArrayDType)
                                 && !(basicp && basicp->keyword() == VBasicDTypeKwd::STRING)) {
                                 const int vecnum = vects++;
                                 const string ivar = string{"__Vi"} + cvtToStr(vecnum);
@@ -517,8 +636,9 @@ class EmitCImp final : EmitCFunc {
             V3Hash hash;
             for (const string& name : *m_requiredHeadersp) hash += name;
             m_subFileName = "DepSet_" + hash.toString();
+            planSplits(pair.second);
             // Open output file
-            openNextOutputFile(*m_requiredHeadersp, m_subFileName);
+            openNextOutputFile(*m_requiredHeadersp, m_subFileName, pair.second.front());
             // Emit functions in this dependency set
             for (AstCFunc* const funcp : pair.second) {
                 VL_RESTORER(m_modp);
@@ -532,13 +652,15 @@ class EmitCImp final : EmitCFunc {
 
     // VISITORS
     void visit(AstCFunc* nodep) override {
-        if (splitNeeded()) {
+        const bool split = v3Global.opt.outputSplitStable() ? splitNeeded(nodep)
+                                                              : m_splitBefore.count(nodep);
+        if (split) {
             // Splitting file, so using parallel build.
             v3Global.useParallelBuild(true);
             // Close old file
             VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
             // Open a new file
-            openNextOutputFile(*m_requiredHeadersp, m_subFileName);
+            openNextOutputFile(*m_requiredHeadersp, m_subFileName, nodep);
         }
 
         EmitCFunc::visit(nodep);
@@ -593,8 +715,10 @@ class EmitCTrace final : EmitCFunc {
         splitSizeReset();  // Reset file size tracking
         m_lazyDecls.reset();  // Need to emit new lazy declarations
 
-        string filename
-            = (v3Global.opt.makeDir() + "/" + topClassName() + "_" + protect("_Trace"));
+        // Functions shared between instances by --trace-share-instances live in other modules
+        const string prefix = m_modp == v3Global.rootp()->topModulep() ? topClassName()
+                                                                        : prefixNameProtect(m_modp);
+        string filename = (v3Global.opt.makeDir() + "/" + prefix + "_" + protect("_Trace"));
         filename = m_uniqueNames.get(filename);
         if (m_slow) filename += "__Slow";
         filename += ".cpp";
@@ -804,6 +928,7 @@ class EmitCTrace final : EmitCFunc {
         const uint32_t code = nodep->declp()->code() + offset;
         puts(v3Global.opt.useTraceOffload() && !nodep->full() ? "(base+" : "(oldp+");
         puts(cvtToStr(code - nodep->baseCode()));
+        if (arrayindex == -2) puts("+i*" + cvtToStr(nodep->declp()->widthWords()));
         puts(",");
         emitTraceValue(nodep, arrayindex);
         if (emitWidth) puts("," + cvtToStr(nodep->declp()->widthMin()));
@@ -884,8 +1009,35 @@ class EmitCTrace final : EmitCFunc {
             puts("\n");
         }
     }
+    void emitTraceChangeWritten(AstTraceInc* nodep) {
+        // Only check the elements flagged as written since the last dump, 8 flags at a time
+        const string elements = cvtToStr(nodep->declp()->arrayRange().elements());
+        const auto putsWritten = [&](const string& index) {
+            iterateConst(nodep->writtenp());
+            puts("[" + index + "]");
+        };
+        puts("for (int w = 0; w < " + elements + "; w += 8) {\n");
+        puts("if (VL_UNLIKELY(VL_TRACE_ACTIVITY8(&");
+        putsWritten("w");
+        puts("))) {\n");
+        puts("for (int i = w; i < std::min(w + 8, " + elements + "); ++i) {\n");
+        puts("if (");
+        putsWritten("i");
+        puts(") {\n");
+        emitTraceChangeOne(nodep, -2);
+        puts("}\n");
+        puts("}\n");
+        puts("std::memset(&");
+        putsWritten("w");
+        puts(", 0, 8);\n");
+        puts("}\n");
+        puts("}\n");
+    }
+
     void visit(AstTraceInc* nodep) override {
-        if (nodep->declp()->arrayRange().ranged()) {
+        if (nodep->writtenp() && !nodep->full()) {
+            emitTraceChangeWritten(nodep);
+        } else if (nodep->declp()->arrayRange().ranged()) {
             // It traces faster if we unroll the loop
             for (int i = 0; i < nodep->declp()->arrayRange().elements(); i++) {
                 emitTraceChangeOne(nodep, i);
@@ -940,18 +1092,59 @@ void V3EmitC::emitcImp() {
             [modp, &fastCfilesr]() { EmitCImp::main(modp, /* slow: */ false, fastCfilesr); }));
     }
 
-    // Emit trace routines (currently they can only exist in the top module)
+    // Emit trace routines. These are in the top module, and with --trace-share-instances,
+    // in the modules of instances sharing change dump functions.
     if (v3Global.opt.trace() && !v3Global.opt.lintOnly()) {
+        for (AstNode* nodep = v3Global.rootp()->modulesp(); nodep; nodep = nodep->nextp()) {
+            if (VN_IS(nodep, Class)) continue;
+            AstNodeModule* const modp = VN_AS(nodep, NodeModule);
+            const bool isTop = modp == v3Global.rootp()->topModulep();
+            for (const bool slow : {true, false}) {
+                bool hasTrace = isTop;
+                for (AstNode* stmtp = modp->stmtsp(); stmtp && !hasTrace; stmtp = stmtp->nextp()) {
+                    const AstCFunc* const funcp = VN_CAST(stmtp, CFunc);
+                    hasTrace = funcp && funcp->isTrace() && funcp->slow() == slow;
+                }
+                if (!hasTrace) continue;
+                cfiles.emplace_back();
+                auto& cfilesr = cfiles.back();
+                futures.push_back(V3ThreadPool::s().enqueue<void>(
+                    [modp, slow, &cfilesr]() { EmitCTrace::main(modp, slow, cfilesr); }));
+            }
+        }
+    }
+    // Wait for futures
+    V3ThreadPool::waitForFutures(futures);
+    for (const auto& collr : cfiles) {
+        for (const auto cfilep : collr) v3Global.rootp()->addFilesp(cfilep);
+    }
+}
+
+void V3EmitC::emitcSupport() {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    // Files are added to the netlist in a fixed order, independent of job completion
+    std::list<std::deque<AstCFile*>> cfiles;
+    std::list<std::future<void>> futures;
+
+    cfiles.emplace_back();
+    auto& symsCfilesr = cfiles.back();
+    futures.push_back(V3ThreadPool::s().enqueue<void>(
+        [&symsCfilesr]() { V3EmitC::emitcSyms(/* dpiHdrOnly: */ false, symsCfilesr); }));
+    cfiles.emplace_back();
+    auto& constPoolCfilesr = cfiles.back();
+    futures.push_back(V3ThreadPool::s().enqueue<void>(
+        [&constPoolCfilesr]() { V3EmitC::emitcConstPool(constPoolCfilesr); }));
+    cfiles.emplace_back();
+    auto& modelCfilesr = cfiles.back();
+    futures.push_back(V3ThreadPool::s().enqueue<void>(
+        [&modelCfilesr]() { V3EmitC::emitcModel(modelCfilesr); }));
+    for (const AstNode* nodep = v3Global.rootp()->modulesp(); nodep; nodep = nodep->nextp()) {
+        if (VN_IS(nodep, Class)) continue;  // Declared with the ClassPackage
+        const AstNodeModule* const modp = VN_AS(nodep, NodeModule);
         cfiles.emplace_back();
-        auto& slowCfilesr = cfiles.back();
-        futures.push_back(V3ThreadPool::s().enqueue<void>([&slowCfilesr]() {
-            EmitCTrace::main(v3Global.rootp()->topModulep(), /* slow: */ true, slowCfilesr);
-        }));
-        cfiles.emplace_back();
-        auto& fastCfilesr = cfiles.back();
-        futures.push_back(V3ThreadPool::s().enqueue<void>([&fastCfilesr]() {
-            EmitCTrace::main(v3Global.rootp()->topModulep(), /* slow: */ false, fastCfilesr);
-        }));
+        auto& headerCfilesr = cfiles.back();
+        futures.push_back(V3ThreadPool::s().enqueue<void>(
+            [modp, &headerCfilesr]() { V3EmitC::emitcHeader(modp, headerCfilesr); }));
     }
     // Wait for futures
     V3ThreadPool::waitForFutures(futures);
@@ -74,19 +74,21 @@ private:
              + "{contextp.get()}};\n");
         puts("\n");
 
-        puts("// Simulate until $finish\n");
-        puts("while (!contextp->gotFinish()) {\n");
-        puts(/**/ "// Evaluate model\n");
-        puts(/**/ "topp->eval();\n");
-        puts(/**/ "// Advance time\n");
         if (v3Global.rootp()->delaySchedulerp()) {
-            puts("if (!topp->eventsPending()) break;\n");
-            puts("contextp->time(topp->nextTimeSlot());\n");
+            puts("// Simulate until $finish\n");
+            puts("while (!contextp->gotFinish()) {\n");
+            puts(/**/ "// Evaluate model\n");
+            puts(/**/ "topp->eval();\n");
+            puts(/**/ "// Advance time straight to the next delayed event, if any\n");
+            puts(/**/ "if (!topp->eventsPending()) break;\n");
+            puts(/**/ "contextp->time(topp->nextTimeSlot());\n");
+            puts("}\n");
         } else {
-            puts("contextp->timeInc(1);\n");
+            // With no inputs driven and no delays, later evaluations would never change
+            // anything, so only evaluate once rather than spinning on idle time until $finish
+            puts("// Evaluate model; with no delays nothing changes after this\n");
+            puts("topp->eval();\n");
         }
-
-        puts("}\n");
         puts("\n");
 
         puts("if (!contextp->gotFinish()) {\n");
@@ -96,6 +98,10 @@ private:
 
         puts("// Final model cleanup\n");
         puts("topp->final();\n");
+        if (v3Global.opt.mainStats()) {
+            puts("// Report simulation speed\n");
+            puts("contextp->statsPrintSummary();\n");
+        }
         puts("return 0;\n");
         puts("}\n");
 
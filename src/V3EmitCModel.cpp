@@ -34,6 +34,7 @@ class EmitCModel final : public EmitCFunc {
 
     // MEMBERS
     V3UniqueNames m_uniqueNames;  // For generating unique file names
+    std::deque<AstCFile*>& m_cfilesr;  // Created files, added to the netlist by the caller
 
     // METHODS
     CFuncVector findFuncps(std::function<bool(const AstCFunc*)> cb) {
@@ -48,6 +49,46 @@ class EmitCModel final : public EmitCFunc {
         return funcps;
     }
 
+    // Whether the model has evalAsync(), which needs the thread support of multithreaded models
+    bool asyncEval() { return v3Global.opt.mtasks() && !optSystemC(); }
+
+    void emitScSyncPortDecl(const AstVar* varp) {
+        // SystemC port of the model, synchronized with the variable by --sc-sync-ports
+        if (varp->attrScClocked() && varp->isReadOnly()) {
+            puts("sc_in_clk ");
+        } else {
+            puts(varp->isWritable() ? "sc_out<" : "sc_in<");
+            puts(varp->scType());
+            puts("> ");
+        }
+        puts(varp->nameProtect() + ";\n");
+    }
+
+    void emitScSyncPorts(AstNodeModule* modp, bool outputs) {
+        // Copy the input ports from SystemC, or the output ports to SystemC
+        for (const AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            const AstVar* const varp = VN_CAST(nodep, Var);
+            if (!varp || !varp->isScSyncPort() || varp->isWritable() != outputs) continue;
+            const string vvar = "vlSymsp->TOP." + varp->nameProtect();
+            const string svar = varp->nameProtect();
+            const string args = "(" + cvtToStr(varp->widthMin()) + ", "
+                                + (outputs ? svar + ", " + vvar : vvar + ", " + svar) + ");\n";
+            if (varp->isWide() && varp->isScBv()) {
+                // Whole vector at once
+                puts((outputs ? "VL_SC_BV_WRITE" : "VL_SC_BV_READ") + args);
+                continue;
+            }
+            // clang-format off
+            const string sc = varp->isScBigUint() ? "SB"
+                              : varp->isScUint()  ? "SU"
+                              : varp->isScBv()    ? "SW"
+                              : varp->isScQuad()  ? "SQ" : "SI";
+            // clang-format on
+            const string iqw = varp->isWide() ? "W" : varp->isQuad() ? "Q" : "I";
+            puts("VL_ASSIGN_" + (outputs ? sc + iqw : iqw + sc) + args);
+        }
+    }
+
     void putSectionDelimiter(const string& name) {
         puts("\n");
         puts("//============================================================\n");
@@ -58,7 +99,7 @@ class EmitCModel final : public EmitCFunc {
         UASSERT(!m_ofp, "Output file should not be open");
 
         const string filename = v3Global.opt.makeDir() + "/" + topClassName() + ".h";
-        newCFile(filename, /* slow: */ false, /* source: */ false);
+        m_cfilesr.push_back(createCFile(filename, /* slow: */ false, /* source: */ false));
         m_ofp = v3Global.opt.systemC() ? new V3OutScFile{filename} : new V3OutCFile{filename};
 
         ofp()->putsHeader();
@@ -100,6 +141,10 @@ class EmitCModel final : public EmitCFunc {
 
         puts("// Symbol table holding complete model state (owned by this class)\n");
         puts(symClassName() + "* const vlSymsp;\n");
+        if (asyncEval()) {
+            puts("// Thread running evaluations started by evalAsync(), created on first use\n");
+            puts("VlWorkerThread* __Vm_evalThreadp = nullptr;\n");
+        }
 
         puts("\n");
         ofp()->putsPrivate(false);  // public:
@@ -109,7 +154,9 @@ class EmitCModel final : public EmitCFunc {
              "// propagate new values into/out from the Verilated model.\n");
         for (const AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
             if (const AstVar* const varp = VN_CAST(nodep, Var)) {
-                if (varp->isPrimaryIO()) {  //
+                if (varp->isScSyncPort()) {
+                    emitScSyncPortDecl(varp);
+                } else if (varp->isPrimaryIO()) {
                     emitVarDecl(varp, /* asRef: */ true);
                 }
             }
@@ -183,6 +230,13 @@ class EmitCModel final : public EmitCFunc {
                 puts(";\n");
             }
         }
+        if (asyncEval()) {
+            puts("/// Start evaluating the model on a separate thread, and return without\n");
+            puts("/// waiting. Application must call evalWait() before accessing the model.\n");
+            puts("void evalAsync();\n");
+            puts("/// Wait for the evaluation started by evalAsync() to complete.\n");
+            puts("void evalWait();\n");
+        }
         if (!optSystemC()) {
             puts("/// Simulation complete, run final blocks.  Application "
                  "must call on completion.\n");
@@ -194,6 +248,17 @@ class EmitCModel final : public EmitCFunc {
         puts("bool eventsPending();\n");
         puts("/// Returns time at next time slot. Aborts if !eventsPending()\n");
         puts("uint64_t nextTimeSlot();\n");
+        puts("/// Number of eval loop iterations taken by the last evaluation\n");
+        puts("uint32_t evalIterations() const;\n");
+        if (v3Global.rootp()->inputsUnchangedp()) {
+            puts("/// Declare no input or public signal was written since the last evaluation,\n");
+            puts("/// so the next evaluation can skip the input combinational logic\n");
+            puts("void inputsUnchanged();\n");
+        }
+        if (v3Global.rootp()->evalClockp()) {
+            puts("/// Evaluate, then advance the clock input by whole cycles\n");
+            puts("void evalCycles(uint64_t cycles);\n");
+        }
 
         if (v3Global.opt.trace()) {
             puts("/// Trace signals in the model; called by application code\n");
@@ -240,11 +305,110 @@ class EmitCModel final : public EmitCFunc {
 
         puts("};\n");
 
+        if (v3Global.opt.batchInstances() && !optSystemC()) emitBatchHeader();
+
         ofp()->putsEndGuard();
 
         VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
     }
 
+    string batchClassName() const { return topClassName() + "__Batch"; }
+
+    void emitBatchHeader() {
+        const string batch = batchClassName();
+        const string instances = cvtToStr(v3Global.opt.batchInstances());
+        puts("\n");
+        puts("// This class evaluates --batch-instances independent instances of the model,\n");
+        puts("// each under its own VerilatedContext\n");
+        puts("class " + batch + " final {\n");
+        ofp()->resetPrivate();
+        ofp()->putsPrivate(true);  // private:
+        puts("std::unique_ptr<VerilatedContext> m_contextps[" + instances + "];\n");
+        puts("std::unique_ptr<" + topClassName() + "> m_modelps[" + instances + "];\n");
+        puts("VL_UNCOPYABLE(" + batch + ");  ///< Copying not allowed\n");
+        puts("\n");
+        ofp()->putsPrivate(false);  // public:
+        puts("static constexpr int INSTANCES = " + instances + ";\n");
+        puts("\n// CONSTRUCTORS\n");
+        puts("/// Construct every instance, each with a new context\n");
+        puts("explicit " + batch + "(const char* name = \"TOP\");\n");
+        puts("~" + batch + "();\n");
+        puts("\n// API METHODS\n");
+        puts("/// Return instance 'index', to access its ports\n");
+        puts(topClassName() + "& model(int index) { return *m_modelps[index]; }\n");
+        puts("/// Return the context of instance 'index'\n");
+        puts("VerilatedContext& context(int index) { return *m_contextps[index]; }\n");
+        puts("/// Pass runtime arguments to the context of every instance\n");
+        puts("void commandArgs(int argc, const char** argv);\n");
+        puts("/// Evaluate every instance that has not finished\n");
+        puts("void eval();\n");
+        puts("/// Advance the time of every instance that has not finished\n");
+        puts("void timeInc(uint64_t add);\n");
+        puts("/// Return the number of instances that have not finished\n");
+        puts("int running() const;\n");
+        puts("/// Run final blocks of every instance\n");
+        puts("void final();\n");
+        puts("};\n");
+    }
+
+    void emitBatchImplementation() {
+        const string batch = batchClassName();
+        putSectionDelimiter("Batch of instances");
+
+        puts("\n");
+        puts("constexpr int " + batch + "::INSTANCES;\n");
+        puts("\n");
+        puts(batch + "::" + batch + "(const char* name) {\n");
+        puts("for (int i = 0; i < INSTANCES; ++i) {\n");
+        puts("m_contextps[i].reset(new VerilatedContext);\n");
+        if (v3Global.opt.mtasks()) {
+            puts("// Rather than a thread pool per instance, oversubscribing the CPUs\n");
+            puts("m_contextps[i]->threadsShared(true);\n");
+        } else {
+            puts("m_contextps[i]->threads(1);\n");
+        }
+        puts("}\n");
+        puts("for (int i = 0; i < INSTANCES; ++i) {\n");
+        puts("Verilated::threadContextp(m_contextps[i].get());\n");
+        puts("m_modelps[i].reset(new " + topClassName() + "{m_contextps[i].get(), name});\n");
+        puts("}\n");
+        puts("}\n");
+        puts("\n");
+        puts(batch + "::~" + batch + "() = default;\n");
+        puts("\n");
+        puts("void " + batch + "::commandArgs(int argc, const char** argv) {\n");
+        puts("for (const auto& contextp : m_contextps) contextp->commandArgs(argc, argv);\n");
+        puts("}\n");
+        puts("\n");
+        puts("void " + batch + "::eval() {\n");
+        puts("for (int i = 0; i < INSTANCES; ++i) {\n");
+        puts("// Instances diverge, e.g. by different arguments; stop each at its $finish\n");
+        puts("if (VL_UNLIKELY(m_contextps[i]->gotFinish())) continue;\n");
+        puts("Verilated::threadContextp(m_contextps[i].get());\n");
+        puts("m_modelps[i]->eval();\n");
+        puts("}\n");
+        puts("}\n");
+        puts("\n");
+        puts("void " + batch + "::timeInc(uint64_t add) {\n");
+        puts("for (const auto& contextp : m_contextps) {\n");
+        puts("if (!contextp->gotFinish()) contextp->timeInc(add);\n");
+        puts("}\n");
+        puts("}\n");
+        puts("\n");
+        puts("int " + batch + "::running() const {\n");
+        puts("int count = 0;\n");
+        puts("for (const auto& contextp : m_contextps) count += !contextp->gotFinish();\n");
+        puts("return count;\n");
+        puts("}\n");
+        puts("\n");
+        puts("void " + batch + "::final() {\n");
+        puts("for (int i = 0; i < INSTANCES; ++i) {\n");
+        puts("Verilated::threadContextp(m_contextps[i].get());\n");
+        puts("m_modelps[i]->final();\n");
+        puts("}\n");
+        puts("}\n");
+    }
+
     void emitConstructorImplementation(AstNodeModule* modp) {
         putSectionDelimiter("Constructors");
 
@@ -263,7 +427,10 @@ class EmitCModel final : public EmitCFunc {
         // Set up IO references
         for (const AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
             if (const AstVar* const varp = VN_CAST(nodep, Var)) {
-                if (varp->isPrimaryIO()) {
+                if (varp->isScSyncPort()) {
+                    const string protName = varp->nameProtect();
+                    puts("    , " + protName + "{\"" + protName + "\"}\n");
+                } else if (varp->isPrimaryIO()) {
                     const string protName = varp->nameProtect();
                     puts("    , " + protName + "{vlSymsp->TOP." + protName + "}\n");
                 }
@@ -332,6 +499,8 @@ class EmitCModel final : public EmitCFunc {
 
         puts("\n");
         puts(topClassName() + "::~" + topClassName() + "() {\n");
+        // Finishes any evaluation still running, so must be before deleting the state
+        if (asyncEval()) puts("delete __Vm_evalThreadp;\n");
         puts("delete vlSymsp;\n");
         puts("}\n");
     }
@@ -354,6 +523,9 @@ class EmitCModel final : public EmitCFunc {
         puts("void " + topModNameProtected + "__" + protect("_eval_initial") + selfDecl + ";\n");
         puts("void " + topModNameProtected + "__" + protect("_eval_settle") + selfDecl + ";\n");
         puts("void " + topModNameProtected + "__" + protect("_eval") + selfDecl + ";\n");
+        if (v3Global.rootp()->evalClockp()) {
+            puts("void " + topModNameProtected + "__" + protect("_eval_clock") + selfDecl + ";\n");
+        }
 
         if (optSystemC() && v3Global.usesTiming()) {
             // ::eval
@@ -378,6 +550,11 @@ class EmitCModel final : public EmitCFunc {
         puts("VL_DEBUG_IF(VL_DBG_MSGF(\"+++++TOP Evaluate " + topClassName()
              + "::eval_step\\n\"); );\n");
 
+        if (v3Global.opt.scSyncPorts()) {
+            putsDecoration("// Synchronize inputs from SystemC\n");
+            emitScSyncPorts(modp, /* outputs: */ false);
+        }
+
         puts("#ifdef VL_DEBUG\n");
         putsDecoration("// Debug assertions\n");
         puts(topModNameProtected + "__" + protect("_eval_debug_assertions")
@@ -412,6 +589,11 @@ class EmitCModel final : public EmitCFunc {
         puts("VL_DEBUG_IF(VL_DBG_MSGF(\"+ Eval\\n\"););\n");
         puts(topModNameProtected + "__" + protect("_eval") + "(&(vlSymsp->TOP));\n");
 
+        if (v3Global.opt.scSyncPorts()) {
+            putsDecoration("// Synchronize outputs to SystemC\n");
+            emitScSyncPorts(modp, /* outputs: */ true);
+        }
+
         putsDecoration("// Evaluate cleanup\n");
         if (v3Global.opt.threads() == 1) {
             puts("Verilated::endOfThreadMTask(vlSymsp->__Vm_evalMsgQp);\n");
@@ -419,6 +601,61 @@ class EmitCModel final : public EmitCFunc {
         if (v3Global.opt.threads()) puts("Verilated::endOfEval(vlSymsp->__Vm_evalMsgQp);\n");
 
         if (v3Global.opt.profExec()) puts("VL_EXEC_TRACE_ADD_RECORD(vlSymsp).evalEnd();\n");
+        if (v3Global.opt.runtimeStats()) {
+            if (const AstVar* const delaySchedp = v3Global.rootp()->delaySchedulerp()) {
+                puts("vlSymsp->_vm_contextp__->stats().timingQueueDepth(vlSymsp->TOP.");
+                puts(delaySchedp->nameProtect());
+                puts(".size());\n");
+            }
+            puts("vlSymsp->_vm_contextp__->statsEvalDone();\n");
+        }
+        puts("}\n");
+
+        if (v3Global.rootp()->evalClockp()) emitEvalCycles(modp);
+        if (asyncEval()) emitEvalAsync();
+    }
+
+    void emitEvalAsync() {
+        // ::evalAsync
+        puts("\nvoid " + topClassName() + "::evalAsync() {\n");
+        puts("if (VL_UNLIKELY(!__Vm_evalThreadp)) {\n");
+        putsDecoration("// Not pinned, the calling thread keeps working meanwhile\n");
+        puts("__Vm_evalThreadp = new VlWorkerThread{contextp(), 0, -1};\n");
+        puts("}\n");
+        puts("__Vm_evalThreadp->addTask([](void* modelp, bool) {\n");
+        puts("static_cast<" + topClassName() + "*>(modelp)->eval();\n");
+        puts("}, this);\n");
+        puts("}\n");
+
+        // ::evalWait
+        puts("\nvoid " + topClassName() + "::evalWait() {\n");
+        puts("if (__Vm_evalThreadp) __Vm_evalThreadp->wait();\n");
+        puts("}\n");
+    }
+
+    void emitEvalCycles(AstNodeModule* modp) {
+        const string topModNameProtected = prefixNameProtect(modp);
+
+        // ::evalCycles
+        puts("\nvoid " + topClassName() + "::evalCycles(uint64_t cycles) {\n");
+        puts("VL_DEBUG_IF(VL_DBG_MSGF(\"+++++TOP Evaluate " + topClassName()
+             + "::evalCycles\\n\"); );\n");
+        putsDecoration("// Evaluate any input changes since the last evaluation\n");
+        puts("eval_step();\n");
+        if (v3Global.opt.threads() == 1) puts("Verilated::mtaskId(0);\n");
+        putsDecoration("// Only the clock changes from here, so skip the per-eval overhead\n");
+        puts("for (; cycles && VL_LIKELY(!contextp()->gotFinish()); --cycles) {\n");
+        puts("for (int edge = 0; edge < 2; ++edge) {\n");
+        if (v3Global.hasEvents()) puts("vlSymsp->clearTriggeredEvents();\n");
+        if (v3Global.hasClasses()) puts("vlSymsp->__Vm_deleter.deleteAll();\n");
+        puts(topModNameProtected + "__" + protect("_eval_clock") + "(&(vlSymsp->TOP));\n");
+        puts("}\n");
+        puts("}\n");
+        putsDecoration("// Evaluate cleanup\n");
+        if (v3Global.opt.threads() == 1) {
+            puts("Verilated::endOfThreadMTask(vlSymsp->__Vm_evalMsgQp);\n");
+        }
+        if (v3Global.opt.threads()) puts("Verilated::endOfEval(vlSymsp->__Vm_evalMsgQp);\n");
         puts("}\n");
     }
 
@@ -454,6 +691,16 @@ class EmitCModel final : public EmitCFunc {
                  "design\");\n");
             puts("return 0;\n}\n");
         }
+        puts("\nuint32_t " + topClassName() + "::evalIterations() const { ");
+        if (const AstVar* const varp = v3Global.rootp()->evalIterCountp()) {
+            puts("return vlSymsp->TOP." + varp->nameProtect() + "; }\n");
+        } else {
+            puts("return 0; }\n");
+        }
+        if (const AstVar* const varp = v3Global.rootp()->inputsUnchangedp()) {
+            puts("\nvoid " + topClassName() + "::inputsUnchanged() { ");
+            puts("vlSymsp->TOP." + varp->nameProtect() + " = 1; }\n");
+        }
 
         putSectionDelimiter("Utilities");
 
@@ -597,7 +844,7 @@ class EmitCModel final : public EmitCFunc {
         UASSERT(!m_ofp, "Output file should not be open");
 
         const string filename = v3Global.opt.makeDir() + "/" + topClassName() + ".cpp";
-        newCFile(filename, /* slow: */ false, /* source: */ true);
+        m_cfilesr.push_back(createCFile(filename, /* slow: */ false, /* source: */ true));
         m_ofp = v3Global.opt.systemC() ? new V3OutScFile{filename} : new V3OutCFile{filename};
 
         ofp()->putsHeader();
@@ -620,6 +867,7 @@ class EmitCModel final : public EmitCFunc {
         emitStandardMethods2(modp);
         if (v3Global.opt.trace()) { emitTraceMethods(modp); }
         if (v3Global.opt.savable()) { emitSerializationFunctions(); }
+        if (v3Global.opt.batchInstances() && !optSystemC()) emitBatchImplementation();
 
         VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
     }
@@ -643,7 +891,7 @@ class EmitCModel final : public EmitCFunc {
                 string filename = v3Global.opt.makeDir() + "/" + topClassName() + "__Dpi_Export";
                 filename = m_uniqueNames.get(filename);
                 filename += ".cpp";
-                newCFile(filename, /* slow: */ false, /* source: */ true);
+                m_cfilesr.push_back(createCFile(filename, /* slow: */ false, /* source: */ true));
                 m_ofp = v3Global.opt.systemC() ? new V3OutScFile{filename}
                                                : new V3OutCFile{filename};
                 splitSizeReset();  // Reset file size tracking
@@ -674,13 +922,16 @@ class EmitCModel final : public EmitCFunc {
     // VISITORS
 
 public:
-    explicit EmitCModel(AstNetlist* netlistp) { main(netlistp->topModulep()); }
+    EmitCModel(AstNetlist* netlistp, std::deque<AstCFile*>& cfilesr)
+        : m_cfilesr{cfilesr} {
+        main(netlistp->topModulep());
+    }
 };
 
 //######################################################################
 // EmitC class functions
 
-void V3EmitC::emitcModel() {
+void V3EmitC::emitcModel(std::deque<AstCFile*>& cfilesr) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    { EmitCModel{v3Global.rootp()}; }
+    EmitCModel{v3Global.rootp(), cfilesr};
 }
@@ -18,13 +18,19 @@
 #include "verilatedos.h"
 
 #include "V3EmitC.h"
+
+#include "V3Branch.h"
 #include "V3EmitCBase.h"
 #include "V3Global.h"
 #include "V3LanguageWords.h"
 #include "V3PartitionGraph.h"
+#include "V3Stats.h"
+#include "V3VpiHooks.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -84,6 +90,12 @@ class EmitCSyms final : EmitCBaseVisitorConst {
             return lhsp.first->name() < rhsp.first->name();
         }
     };
+    struct CmpModule {
+        const std::unordered_map<const AstNodeModule*, size_t>& m_modOrder;
+        bool operator()(const ScopeModPair& lhsp, const ScopeModPair& rhsp) const {
+            return m_modOrder.at(lhsp.second) < m_modOrder.at(rhsp.second);
+        }
+    };
     struct CmpDpi {
         bool operator()(const AstCFunc* lhsp, const AstCFunc* rhsp) const {
             if (lhsp->dpiImportPrototype() != rhsp->dpiImportPrototype()) {
@@ -106,21 +118,37 @@ class EmitCSyms final : EmitCBaseVisitorConst {
     ScopeNames m_vpiScopeCandidates;  // All scopes for VPI
     ScopeNameHierarchy m_vpiScopeHierarchy;  // The actual hierarchy of scopes
     int m_coverBins = 0;  // Coverage bin number
+    uint32_t m_traceCodes = 0;  // Number of trace codes, each a 32-bit old value
     const bool m_dpiHdrOnly;  // Only emit the DPI header
     int m_numStmts = 0;  // Number of statements output
     int m_funcNum = 0;  // CFunc split function number
     V3OutCFile* m_ofpBase = nullptr;  // Base (not split) C file
     std::unordered_map<int, bool> m_usesVfinal;  // Split method uses __Vfinal
+    std::deque<AstCFile*>& m_cfilesr;  // Created files, added to the netlist by the caller
 
     // METHODS
+    // Return m_scopes with the instances of each module adjacent, in order of
+    // each module's first instance. Code run for every instance of a module
+    // then walks consecutive memory, rather than instances spread among
+    // their submodules.
+    std::vector<ScopeModPair> scopesByModule() const {
+        std::unordered_map<const AstNodeModule*, size_t> modOrder;
+        for (const auto& i : m_scopes) modOrder.emplace(i.second, modOrder.size());
+        std::vector<ScopeModPair> scopes{m_scopes};
+        stable_sort(scopes.begin(), scopes.end(), CmpModule{modOrder});
+        return scopes;
+    }
     void emitSymHdr();
+    void emitPchHdr();
     void checkSplit(bool usesVfinal);
     void closeSplit();
     void emitSymImpPreamble();
     void emitScopeHier(bool destroy);
+    void emitThreadPlacement();
     void emitSymImp();
     void emitDpiHdr();
     void emitDpiImp();
+    void statsMemory();
 
     static void nameCheck(AstNode* nodep) {
         // Prevent GCC compile time error; name check all things that reach C++ code
@@ -292,6 +320,8 @@ class EmitCSyms final : EmitCBaseVisitorConst {
             // Must emit implementation first to determine number of splits
             emitSymImp();
             emitSymHdr();
+            emitPchHdr();
+            if (v3Global.opt.stats()) statsMemory();
         }
         if (v3Global.dpi()) {
             emitDpiHdr();
@@ -357,15 +387,23 @@ class EmitCSyms final : EmitCBaseVisitorConst {
     void visit(AstVar* nodep) override {
         nameCheck(nodep);
         iterateChildrenConst(nodep);
+        // Sparse arrays have no flat storage, so are not visible to the VPI
+        const AstUnpackArrayDType* const adtypep
+            = VN_CAST(nodep->dtypeSkipRefp(), UnpackArrayDType);
+        if (adtypep && adtypep->isSparse()) return;
         if (nodep->isSigUserRdPublic() && !m_cfuncp)
             m_modVars.emplace_back(std::make_pair(m_modp, nodep));
     }
     void visit(AstCoverDecl* nodep) override {
         // Assign numbers to all bins, so we know how big of an array to use
-        if (!nodep->dataDeclNullp()) {  // else duplicate we don't need code for
+        // Duplicate or derived declarations have no bin of their own
+        if (!nodep->dataDeclNullp() && !nodep->derivedBasep()) {
             nodep->binNum(m_coverBins++);
         }
     }
+    void visit(AstTraceDecl* nodep) override {
+        m_traceCodes = std::max(m_traceCodes, nodep->code() + nodep->codeInc());
+    }
     void visit(AstCFunc* nodep) override {
         nameCheck(nodep);
         if (nodep->dpiImportPrototype() || nodep->dpiExportDispatcher()) m_dpis.push_back(nodep);
@@ -381,16 +419,146 @@ class EmitCSyms final : EmitCBaseVisitorConst {
     void visit(AstNode* nodep) override { iterateChildrenConst(nodep); }
 
 public:
-    explicit EmitCSyms(AstNetlist* nodep, bool dpiHdrOnly)
-        : m_dpiHdrOnly{dpiHdrOnly} {
+    EmitCSyms(AstNetlist* nodep, bool dpiHdrOnly, std::deque<AstCFile*>& cfilesr)
+        : m_dpiHdrOnly{dpiHdrOnly}
+        , m_cfilesr{cfilesr} {
         iterateConst(nodep);
     }
 };
 
+// Estimated storage of a variable of the given type, and its kind, for statsMemory()
+static int memoryVarBytes(const AstNodeDType* dtypep, int& alignr, string& kindr) {
+    dtypep = dtypep->skipRefp();
+    if (const AstUnpackArrayDType* const adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
+        if (!adtypep->isSparse()) {
+            const int bytes = memoryVarBytes(adtypep->subDTypep(), alignr, kindr);
+            kindr = "memories";
+            return adtypep->elementsConst() * bytes;
+        }
+    } else if (const AstBasicDType* const bdtypep = VN_CAST(dtypep, BasicDType)) {
+        if (!bdtypep->isOpaque()) {
+            alignr = bdtypep->widthAlignBytes();
+            kindr = "signals";
+            return bdtypep->widthTotalBytes();
+        }
+        if (bdtypep->isDouble()) {
+            alignr = 8;
+            kindr = "signals";
+            return 8;
+        }
+    } else if (VN_IS(dtypep, NodeUOrStructDType) || VN_IS(dtypep, EnumDType)
+               || VN_IS(dtypep, PackArrayDType)) {
+        alignr = dtypep->widthAlignBytes();
+        kindr = "signals";
+        return dtypep->widthTotalBytes();
+    }
+    // Strings, queues, associative and sparse arrays and class handles; only
+    // the fixed part is counted, the contents are on the heap
+    alignr = 8;
+    kindr = "dynamic";
+    return 32;
+}
+
+void EmitCSyms::statsMemory() {
+    // Publish the estimated size of the model, by module and by kind of storage,
+    // so large contributors are visible without compiling the model
+    using KindBytes = std::map<const string, double>;
+    KindBytes kindBytes;
+    std::map<const AstNodeModule*, int> instances;
+    for (const ScopeModPair& pair : m_scopes) ++instances[pair.second];
+
+    struct VarBytes final {
+        double m_bytes;
+        string m_name;
+    };
+    std::vector<VarBytes> varBytes;
+    for (const auto& pair : instances) {
+        const AstNodeModule* const modp = pair.first;
+        const int count = pair.second;
+        // VerilatedModule base, vlSymsp, and a pointer per cell
+        uint64_t offset = 2 * sizeof(void*);
+        KindBytes modBytes;
+        modBytes["overhead"] += offset;
+        for (const AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (VN_IS(nodep, Cell)) {
+                offset += sizeof(void*);
+                modBytes["overhead"] += sizeof(void*);
+                continue;
+            }
+            const AstVar* const varp = VN_CAST(nodep, Var);
+            if (!varp || varp->isParam()) continue;
+            if (!(varp->isIO() || varp->isSignal() || varp->isClassMember() || varp->isTemp())) {
+                continue;
+            }
+            int align = 1;
+            string kind;
+            const int bytes = memoryVarBytes(varp->dtypep(), align, kind);
+            if (varp->isStatic()) {  // One copy shared by all instances
+                kindBytes[kind] += bytes;
+                continue;
+            }
+            // Padding to the alignment, including what V3VariableOrder adds
+            // to put variables of different threads on separate cache lines
+            if (varp->isCacheLineAligned()) align = VL_CACHE_LINE_BYTES;
+            const uint64_t aligned = (offset + align - 1) / align * align;
+            modBytes["padding"] += aligned - offset;
+            offset = aligned + bytes;
+            modBytes[kind] += bytes;
+            varBytes.push_back(
+                VarBytes{static_cast<double>(bytes) * count,
+                         modp->prettyName() + "." + varp->prettyName()});
+        }
+        // Modules are cache line aligned
+        const uint64_t size
+            = (offset + VL_CACHE_LINE_BYTES - 1) / VL_CACHE_LINE_BYTES * VL_CACHE_LINE_BYTES;
+        modBytes["padding"] += size - offset;
+        for (const auto& kindPair : modBytes) kindBytes[kindPair.first] += kindPair.second * count;
+        std::ostringstream os;
+        os << "Model memory, module " << modp->prettyName() << ", x" << count << ", bytes";
+        V3Stats::addStat(os.str(), static_cast<double>(size) * count);
+    }
+
+    // Storage outside the modules
+    if (m_coverBins) {
+        const int rows = v3Global.opt.coveragePerThread() ? v3Global.opt.threads() : 1;
+        kindBytes["coverage"] += static_cast<double>(rows) * m_coverBins * sizeof(uint32_t);
+    }
+    // The trace file keeps a 32-bit old value per code
+    if (m_traceCodes) kindBytes["trace"] += static_cast<double>(m_traceCodes) * sizeof(uint32_t);
+    if (const AstConstPool* const constPoolp = v3Global.rootp()->constPoolp()) {
+        for (const AstNode* nodep = constPoolp->modp()->stmtsp(); nodep;
+             nodep = nodep->nextp()) {
+            if (const AstVar* const varp = VN_CAST(nodep, Var)) {
+                int align = 1;
+                string kind;
+                kindBytes["constant pool"] += memoryVarBytes(varp->dtypep(), align, kind);
+            }
+        }
+    }
+
+    double total = 0;
+    for (const auto& pair : kindBytes) {
+        V3Stats::addStat("Model memory, " + pair.first + ", bytes", pair.second);
+        total += pair.second;
+    }
+    V3Stats::addStat("Model memory, TOTAL, bytes", total);
+
+    // The largest variables, numbered as statistics are sorted by name
+    constexpr size_t LARGEST = 10;
+    std::stable_sort(varBytes.begin(), varBytes.end(),
+                     [](const VarBytes& a, const VarBytes& b) { return a.m_bytes > b.m_bytes; });
+    for (size_t i = 0; i < std::min(LARGEST, varBytes.size()); ++i) {
+        std::ostringstream os;
+        os << "Model memory, largest " << std::setw(2) << std::setfill('0') << (i + 1) << " "
+           << varBytes[i].m_name << ", bytes";
+        V3Stats::addStat(os.str(), varBytes[i].m_bytes);
+    }
+}
+
 void EmitCSyms::emitSymHdr() {
     UINFO(6, __FUNCTION__ << ": " << endl);
     const string filename = v3Global.opt.makeDir() + "/" + symClassName() + ".h";
-    newCFile(filename, true /*slow*/, false /*source*/);
+    m_cfilesr.push_back(createCFile(filename, true /*slow*/, false /*source*/));
 
     if (v3Global.opt.systemC()) {
         m_ofp = new V3OutScFile{filename};
@@ -463,7 +631,11 @@ void EmitCSyms::emitSymHdr() {
              "  ///< Used by trace routines when tracing multiple models\n");
     }
     if (v3Global.hasEvents()) puts("std::vector<VlEvent*> __Vm_triggeredEvents;\n");
-    if (v3Global.hasClasses()) puts("VlDeleter __Vm_deleter;\n");
+    if (v3Global.hasClasses()) {
+        // Without multithreaded eval, class objects never cross threads during eval
+        puts(std::string{"VlDeleter __Vm_deleter"} + (v3Global.opt.mtasks() ? "" : "{true}")
+             + ";\n");
+    }
     puts("bool __Vm_didInit = false;\n");
 
     if (v3Global.opt.mtasks()) {
@@ -472,6 +644,14 @@ void EmitCSyms::emitSymHdr() {
         puts("bool __Vm_even_cycle__ico = false;\n");
         puts("bool __Vm_even_cycle__act = false;\n");
         puts("bool __Vm_even_cycle__nba = false;\n");
+        if (v3Global.opt.threadsSchedules() > 1 && !v3Global.opt.threadsDynamic()) {
+            puts("VlScheduleSelector __Vm_schedule__ico;\n");
+            puts("VlScheduleSelector __Vm_schedule__act;\n");
+            puts("VlScheduleSelector __Vm_schedule__nba;\n");
+        }
+        if (const uint32_t usedMTaskGuardIDs = v3Global.rootp()->usedMTaskGuardIDs()) {
+            puts("VlMTaskGuard __Vm_mtaskGuards[" + cvtToStr(usedMTaskGuardIDs) + "];\n");
+        }
     }
 
     if (v3Global.opt.profExec()) {
@@ -480,7 +660,7 @@ void EmitCSyms::emitSymHdr() {
     }
 
     puts("\n// MODULE INSTANCE STATE\n");
-    for (const auto& i : m_scopes) {
+    for (const auto& i : scopesByModule()) {
         const AstScope* const scopep = i.first;
         const AstNodeModule* const modp = i.second;
         if (VN_IS(modp, Class)) continue;
@@ -489,7 +669,17 @@ void EmitCSyms::emitSymHdr() {
         puts(protectIf(scopep->nameDotless(), scopep->protect()) + ";\n");
     }
 
-    if (m_coverBins) {
+    if (m_coverBins && v3Global.opt.coveragePerThread()) {
+        puts("\n// COVERAGE\n");
+        // One row of counters per thread, each row in its own cache lines
+        constexpr int binsPerLine = VL_CACHE_LINE_BYTES / sizeof(uint32_t);
+        const int rowBins = (m_coverBins + binsPerLine - 1) / binsPerLine * binsPerLine;
+        puts("alignas(VL_CACHE_LINE_BYTES) uint32_t __Vcoverage[");
+        puts(cvtToStr(v3Global.opt.threads()));
+        puts("][");
+        puts(cvtToStr(rowBins));
+        puts("];\n");
+    } else if (m_coverBins) {
         puts("\n// COVERAGE\n");
         puts(v3Global.opt.threads() ? "std::atomic<uint32_t>" : "uint32_t");
         puts(" __Vcoverage[");
@@ -503,6 +693,11 @@ void EmitCSyms::emitSymHdr() {
         puts("VlPgoProfiler<" + cvtToStr(usedMTaskProfilingIDs) + "> _vm_pgoProfiler;\n");
     }
 
+    if (v3Global.opt.profSample()) {
+        puts("\n// SAMPLING PROFILING\n");
+        puts("VlSampleProfiler _vm_sampleProfiler;\n");
+    }
+
     if (!m_scopeNames.empty()) {  // Scope names
         puts("\n// SCOPE NAMES\n");
         for (const auto& itr : m_scopeNames) {
@@ -568,6 +763,47 @@ void EmitCSyms::closeSplit() {
     VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
 }
 
+void EmitCSyms::emitThreadPlacement() {
+    // For each variable accessed by mtasks, ask the thread pool to move it near the thread
+    // that statically executes most of those mtasks. This only takes effect with thread
+    // affinity (VerilatedContext::threadsAffinity), otherwise threads may migrate anyway.
+    std::unordered_map<uint32_t, int> mtaskThreads;  // MTask id -> thread id
+    v3Global.rootp()->topModulep()->foreach([&](const AstExecGraph* execGraphp) {
+        for (const V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp(); vxp;
+             vxp = vxp->verticesNextp()) {
+            const ExecMTask* const mtaskp = static_cast<const ExecMTask*>(vxp);
+            mtaskThreads.emplace(mtaskp->id(), mtaskp->threadId());
+        }
+    });
+    bool first = true;
+    for (AstNode* nodep = v3Global.rootp()->topModulep()->stmtsp(); nodep;
+         nodep = nodep->nextp()) {
+        const AstVar* const varp = VN_CAST(nodep, Var);
+        if (!varp || varp->isStatic() || varp->isParam() || varp->mtaskIds().empty()) continue;
+        std::map<int, int> counts;  // Thread id -> number of mtasks using the variable
+        for (const int id : varp->mtaskIds()) {
+            const auto it = mtaskThreads.find(id);
+            if (it != mtaskThreads.end() && it->second != ExecMTask::THREAD_NONE) {
+                ++counts[it->second];
+            }
+        }
+        if (counts.empty()) continue;
+        const auto bestIt
+            = std::max_element(counts.begin(), counts.end(),
+                               [](const std::pair<const int, int>& a,
+                                  const std::pair<const int, int>& b) { return a.second < b.second; });
+        if (first) {
+            puts("// Place variables near the threads using them\n");
+            first = false;
+        }
+        checkSplit(false);
+        const string name = "TOP." + varp->nameProtect();
+        puts("__Vm_threadPoolp->placeOnThread(" + cvtToStr(bestIt->first) + ", &" + name
+             + ", sizeof(" + name + "));\n");
+        ++m_numStmts;
+    }
+}
+
 void EmitCSyms::checkSplit(bool usesVfinal) {
     if (m_ofp
         && (!v3Global.opt.outputSplitCFuncs() || m_numStmts < v3Global.opt.outputSplitCFuncs())) {
@@ -580,7 +816,8 @@ void EmitCSyms::checkSplit(bool usesVfinal) {
     m_numStmts = 0;
     const string filename
         = v3Global.opt.makeDir() + "/" + symClassName() + "__" + cvtToStr(++m_funcNum) + ".cpp";
-    AstCFile* const cfilep = newCFile(filename, true /*slow*/, true /*source*/);
+    AstCFile* const cfilep = createCFile(filename, true /*slow*/, true /*source*/);
+    m_cfilesr.push_back(cfilep);
     cfilep->support(true);
     m_usesVfinal[m_funcNum] = usesVfinal;
     closeSplit();
@@ -631,14 +868,14 @@ void EmitCSyms::emitScopeHier(bool destroy) {
     if (v3Global.opt.vpi()) {
         const string verb = destroy ? "Tear down" : "Set up";
         const string method = destroy ? "remove" : "add";
-        puts("\n// " + verb + " scope hierarchy\n");
+        std::vector<string> lines;
         for (ScopeNames::const_iterator it = m_scopeNames.begin(); it != m_scopeNames.end();
              ++it) {
             const string name = it->second.m_prettyName;
             if (it->first == "TOP") continue;
             if ((name.find('.') == string::npos) && (it->second.m_type == "SCOPE_MODULE")) {
-                puts("__Vhier." + method + "(0, &" + protect("__Vscope_" + it->second.m_symName)
-                     + ");\n");
+                lines.push_back("__Vhier." + method + "(0, &"
+                                + protect("__Vscope_" + it->second.m_symName) + ");\n");
             }
         }
 
@@ -651,11 +888,15 @@ void EmitCSyms::emitScopeHier(bool destroy) {
                 const auto to = vlstd::as_const(m_scopeNames).find(toname);
                 UASSERT(from != m_scopeNames.end(), fromname + " not in m_scopeNames");
                 UASSERT(to != m_scopeNames.end(), toname + " not in m_scopeNames");
-                puts("__Vhier." + method + "(");
-                puts("&" + protect("__Vscope_" + from->second.m_symName) + ", ");
-                puts("&" + protect("__Vscope_" + to->second.m_symName) + ");\n");
+                lines.push_back("__Vhier." + method + "("
+                                + "&" + protect("__Vscope_" + from->second.m_symName) + ", "
+                                + "&" + protect("__Vscope_" + to->second.m_symName) + ");\n");
             }
         }
+        // Tear down in reverse order, which the runtime removes from each list in constant time
+        if (destroy) std::reverse(lines.begin(), lines.end());
+        puts("\n// " + verb + " scope hierarchy\n");
+        for (const string& line : lines) puts(line);
         puts("\n");
     }
 }
@@ -663,7 +904,8 @@ void EmitCSyms::emitScopeHier(bool destroy) {
 void EmitCSyms::emitSymImp() {
     UINFO(6, __FUNCTION__ << ": " << endl);
     const string filename = v3Global.opt.makeDir() + "/" + symClassName() + ".cpp";
-    AstCFile* const cfilep = newCFile(filename, true /*slow*/, true /*source*/);
+    AstCFile* const cfilep = createCFile(filename, true /*slow*/, true /*source*/);
+    m_cfilesr.push_back(cfilep);
     cfilep->support(true);
 
     if (v3Global.opt.systemC()) {
@@ -712,6 +954,10 @@ void EmitCSyms::emitSymImp() {
         puts("_vm_pgoProfiler.write(\"" + topClassName()
              + "\", _vm_contextp__->profVltFilename());\n");
     }
+    if (v3Global.opt.profSample()) {
+        puts("_vm_sampleProfiler.write(\"" + topClassName()
+             + "\", _vm_contextp__->profSampleFilename());\n");
+    }
     puts("}\n");
 
     if (v3Global.needTraceDumper()) {
@@ -781,7 +1027,7 @@ void EmitCSyms::emitSymImp() {
     }
 
     puts("    // Setup module instances\n");
-    for (const auto& i : m_scopes) {
+    for (const auto& i : scopesByModule()) {
         const AstScope* const scopep = i.first;
         const AstNodeModule* const modp = i.second;
         puts("    , ");
@@ -812,6 +1058,61 @@ void EmitCSyms::emitSymImp() {
                 }
             });
         }
+        for (const AstNode* nodep = v3Global.rootp()->modulesp(); nodep; nodep = nodep->nextp()) {
+            const AstNodeModule* const modp = VN_AS(nodep, NodeModule);
+            for (const AstNode* itemp = modp->stmtsp(); itemp; itemp = itemp->nextp()) {
+                const AstCFunc* const funcp = VN_CAST(itemp, CFunc);
+                if (!funcp || funcp->profilerId() < 0) continue;
+                puts("_vm_pgoProfiler.addCFuncCounter(" + cvtToStr(funcp->profilerId()) + ", \""
+                     + V3Branch::profileName(modp, funcp) + "\");\n");
+            }
+        }
+    }
+
+    if (v3Global.opt.profExec() && v3Global.opt.mtasks()) {
+        puts("// Record mtask dependencies for the execution profile\n");
+        v3Global.rootp()->topModulep()->foreach([&](const AstExecGraph* execGraphp) {
+            for (const V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp(); vxp;
+                 vxp = vxp->verticesNextp()) {
+                string deps;
+                for (const V3GraphEdge* edgep = vxp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+                    if (!deps.empty()) deps += " ";
+                    deps += cvtToStr(static_cast<const ExecMTask*>(edgep->fromp())->id());
+                }
+                if (deps.empty()) continue;
+                const ExecMTask* const mtp = static_cast<const ExecMTask*>(vxp);
+                puts("__Vm_executionProfilerp->addMTaskDeps(" + cvtToStr(mtp->id()) + ", \""
+                     + deps + "\");\n");
+            }
+        });
+    }
+
+    if (v3Global.opt.profSample() && !v3Global.opt.protectIds()) {
+        puts("// Configure sampling profiler, mapping functions back to Verilog\n");
+        for (const AstNode* nodep = v3Global.rootp()->modulesp(); nodep; nodep = nodep->nextp()) {
+            const AstNodeModule* const modp = VN_AS(nodep, NodeModule);
+            for (const AstNode* itemp = modp->stmtsp(); itemp; itemp = itemp->nextp()) {
+                const AstCFunc* const funcp = VN_CAST(itemp, CFunc);
+                if (!funcp || funcp->isConstructor() || funcp->isDestructor()
+                    || funcp->dpiImportPrototype() || funcp->dpiExportDispatcher()) {
+                    continue;
+                }
+                // Name as demangled from the symbol, without arguments
+                const string cname = funcp->isLoose()
+                                         ? funcNameProtect(funcp, modp)
+                                         : prefixNameProtect(modp) + "::" + funcp->nameProtect();
+                const FileLine* const flp = funcp->fileline();
+                puts("_vm_sampleProfiler.addFunc(");
+                putsQuoted(cname);
+                puts(", ");
+                putsQuoted(modp->prettyName());
+                puts(", ");
+                putsQuoted(funcp->scopep() ? funcp->scopep()->prettyName() : "");
+                puts(", ");
+                putsQuoted(flp->filename() + ":" + cvtToStr(flp->lineno()));
+                puts(");\n");
+            }
+        }
     }
 
     puts("// Configure time unit / time precision\n");
@@ -877,9 +1178,15 @@ void EmitCSyms::emitSymImp() {
 
     emitScopeHier(false);
 
+    if (v3Global.opt.mtasks() && !v3Global.opt.threadsDynamic()) emitThreadPlacement();
+
     // Everything past here is in the __Vfinal loop, so start a new split file if needed
     closeSplit();
 
+    if (v3Global.opt.mtasks() && !v3Global.opt.threadsDynamic()) {
+        m_ofpBase->puts("__Vm_threadPoolp->placeCommit();\n");
+    }
+
     if (v3Global.dpi()) {
         m_ofpBase->puts("// Setup export functions\n");
         m_ofpBase->puts("for (int __Vfinal = 0; __Vfinal < 2; ++__Vfinal) {\n");
@@ -978,6 +1285,7 @@ void EmitCSyms::emitSymImp() {
             puts(varp->vlEnumType());  // VLVT_UINT32 etc
             puts(",");
             puts(varp->vlEnumDir());  // VLVD_IN etc
+            if (V3VpiHooks::hooked(varp)) puts("|VLVF_VPI_HOOK");
             puts(",");
             puts(cvtToStr(pdim + udim));
             puts(bounds);
@@ -996,10 +1304,46 @@ void EmitCSyms::emitSymImp() {
 
 //######################################################################
 
+void EmitCSyms::emitPchHdr() {
+    UINFO(6, __FUNCTION__ << ": " << endl);
+    const string filename = v3Global.opt.makeDir() + "/" + topClassName() + "__pch.h";
+    AstCFile* const cfilep = createCFile(filename, false /*slow*/, false /*source*/);
+    m_cfilesr.push_back(cfilep);
+    cfilep->support(true);
+
+    if (v3Global.opt.systemC()) {
+        m_ofp = new V3OutScFile{filename};
+    } else {
+        m_ofp = new V3OutCFile{filename};
+    }
+
+    ofp()->putsHeader();
+    puts("// DESCR"
+         "IPTION: Verilator output: Precompiled header\n");
+    puts("//\n");
+    puts("// Internal details; headers common to all generated .cpp files. When supported,\n");
+    puts("// verilated.mk precompiles this once, and forces it into each parallel compile.\n");
+
+    ofp()->putsGuard();
+
+    puts("\n");
+    puts("#include \"verilated.h\"\n");
+    if (v3Global.dpi()) puts("#include \"verilated_dpi.h\"\n");
+    if (v3Global.opt.vpiHooks()) puts("#include \"verilated_vpi.h\"\n");
+    puts("\n");
+    puts("#include \"" + symClassName() + ".h\"\n");
+
+    ofp()->putsEndGuard();
+    VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
+}
+
+//######################################################################
+
 void EmitCSyms::emitDpiHdr() {
     UINFO(6, __FUNCTION__ << ": " << endl);
     const string filename = v3Global.opt.makeDir() + "/" + topClassName() + "__Dpi.h";
-    AstCFile* const cfilep = newCFile(filename, false /*slow*/, false /*source*/);
+    AstCFile* const cfilep = createCFile(filename, false /*slow*/, false /*source*/);
+    m_cfilesr.push_back(cfilep);
     cfilep->support(true);
     V3OutCFile hf{filename};
     m_ofp = &hf;
@@ -1054,7 +1398,8 @@ void EmitCSyms::emitDpiHdr() {
 void EmitCSyms::emitDpiImp() {
     UINFO(6, __FUNCTION__ << ": " << endl);
     const string filename = v3Global.opt.makeDir() + "/" + topClassName() + "__Dpi.cpp";
-    AstCFile* const cfilep = newCFile(filename, false /*slow*/, true /*source*/);
+    AstCFile* const cfilep = createCFile(filename, false /*slow*/, true /*source*/);
+    m_cfilesr.push_back(cfilep);
     cfilep->support(true);
     V3OutCFile hf(filename);
     m_ofp = &hf;
@@ -1109,5 +1454,11 @@ void EmitCSyms::emitDpiImp() {
 
 void V3EmitC::emitcSyms(bool dpiHdrOnly) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    EmitCSyms(v3Global.rootp(), dpiHdrOnly);
+    std::deque<AstCFile*> cfiles;
+    emitcSyms(dpiHdrOnly, cfiles);
+    for (AstCFile* const cfilep : cfiles) v3Global.rootp()->addFilesp(cfilep);
+}
+
+void V3EmitC::emitcSyms(bool dpiHdrOnly, std::deque<AstCFile*>& cfilesr) {
+    EmitCSyms(v3Global.rootp(), dpiHdrOnly, cfilesr);
 }
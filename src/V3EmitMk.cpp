@@ -24,6 +24,9 @@
 #include "V3HierBlock.h"
 #include "V3Os.h"
 
+#include <algorithm>
+#include <sys/stat.h>
+
 VL_DEFINE_DEBUG_FUNCTIONS;
 
 // ######################################################################
@@ -37,6 +40,51 @@ public:
         of.puts("\t" + V3Os::filenameNonDirExt(name) + " \\\n");
     }
 
+    // Return estimated compile cost of a generated file, currently its size on disk
+    static uint64_t fileCost(const string& name) {
+        struct stat sstat;  // Stat information
+        const string filename = v3Global.opt.makeDir() + "/" + name;
+        return stat(filename.c_str(), &sstat) == 0 ? sstat.st_size : 0;
+    }
+
+    // Concatenate the given files into at most 'groups' jumbo files, balancing the total cost
+    // of each group, and return the names of the files to compile.
+    static std::vector<string> groupFiles(const std::vector<string>& names, int groups,
+                                          bool slow, bool support) {
+        if (groups <= 0 || names.size() <= static_cast<size_t>(groups)) return names;
+        // Largest files first, each to the currently cheapest group
+        std::vector<std::pair<uint64_t, size_t>> costs;  // (cost, index into names)
+        for (size_t i = 0; i < names.size(); ++i) costs.emplace_back(fileCost(names[i]), i);
+        std::stable_sort(costs.begin(), costs.end(),
+                         [](const std::pair<uint64_t, size_t>& a,
+                            const std::pair<uint64_t, size_t>& b) { return a.first > b.first; });
+        std::vector<uint64_t> groupCosts(groups, 0);
+        std::vector<std::vector<size_t>> members(groups);
+        for (const auto& pair : costs) {
+            const auto it = std::min_element(groupCosts.begin(), groupCosts.end());
+            *it += pair.first;
+            members[it - groupCosts.begin()].push_back(pair.second);
+        }
+        // Emit each group, including its members in their original order
+        std::vector<string> result;
+        for (int group = 0; group < groups; ++group) {
+            std::vector<size_t>& indices = members[group];
+            std::sort(indices.begin(), indices.end());
+            const string name = v3Global.opt.prefix() + "__" + (support ? "Support" : "")
+                                + (slow ? "Slow" : "Fast") + "Group__" + cvtToStr(group)
+                                + ".cpp";
+            V3OutCFile of{v3Global.opt.makeDir() + "/" + name};
+            of.putsHeader();
+            of.puts("// DESCR"
+                    "IPTION: Verilator output: Concatenated compile of generated files\n");
+            of.puts("// See --output-groups\n");
+            of.puts("\n");
+            for (const size_t index : indices) of.puts("#include \"" + names[index] + "\"\n");
+            result.push_back(name);
+        }
+        return result;
+    }
+
     void emitClassMake() {
         // Generate the makefile
         V3OutMkFile of{v3Global.opt.makeDir() + "/" + v3Global.opt.prefix() + "_classes.mk"};
@@ -63,7 +111,7 @@ public:
         of.puts("VM_PARALLEL_BUILDS = ");
         of.puts(v3Global.useParallelBuild() ? "1" : "0");
         of.puts("\n");
-        of.puts("# Tracing output mode?  0/1 (from --trace/--trace-fst)\n");
+        of.puts("# Tracing output mode?  0/1 (from --trace/--trace-fst/--trace-vbt)\n");
         of.puts("VM_TRACE = ");
         of.puts(v3Global.opt.trace() ? "1" : "0");
         of.puts("\n");
@@ -75,6 +123,10 @@ public:
         of.puts("VM_TRACE_FST = ");
         of.puts(v3Global.opt.trace() && v3Global.opt.traceFormat().fst() ? "1" : "0");
         of.puts("\n");
+        of.puts("# Tracing output mode in VBT format?  0/1 (from --trace-vbt)\n");
+        of.puts("VM_TRACE_VBT = ");
+        of.puts(v3Global.opt.trace() && v3Global.opt.traceFormat().vbt() ? "1" : "0");
+        of.puts("\n");
 
         of.puts("\n### Object file lists...\n");
         for (int support = 0; support < 3; ++support) {
@@ -114,14 +166,20 @@ public:
                     }
                 } else if (support == 2 && slow) {
                 } else {
+                    std::vector<string> names;
                     for (AstNodeFile* nodep = v3Global.rootp()->filesp(); nodep;
                          nodep = VN_AS(nodep->nextp(), NodeFile)) {
                         const AstCFile* const cfilep = VN_CAST(nodep, CFile);
                         if (cfilep && cfilep->source() && cfilep->slow() == (slow != 0)
                             && cfilep->support() == (support != 0)) {
-                            putMakeClassEntry(of, cfilep->name());
+                            names.push_back(V3Os::filenameNonDir(cfilep->name()));
                         }
                     }
+                    // Serial builds compile everything through one __ALL file anyway
+                    if (v3Global.useParallelBuild()) {
+                        names = groupFiles(names, v3Global.opt.outputGroups(), slow, support);
+                    }
+                    for (const string& name : names) putMakeClassEntry(of, name);
                 }
                 of.puts("\n");
             }
@@ -170,6 +228,12 @@ public:
         of.puts("\n### Switches...\n");
         of.puts("# C++ code coverage  0/1 (from --prof-c)\n");
         of.puts(string{"VM_PROFC = "} + ((v3Global.opt.profC()) ? "1" : "0") + "\n");
+        of.puts("# Sampling profiler symbols  0/1 (from --prof-sample)\n");
+        of.puts(string{"VM_PROF_SAMPLE = "} + (v3Global.opt.profSample() ? "1" : "0") + "\n");
+        of.puts("# Cluster hot code by scheduling region  0/1 (from --hot-sections)\n");
+        of.puts(string{"VM_HOT_SECTIONS = "} + (v3Global.opt.hotSections() ? "1" : "0") + "\n");
+        of.puts("# Align text for huge pages  0/1 (from --hugepage-text)\n");
+        of.puts(string{"VM_HUGEPAGE_TEXT = "} + (v3Global.opt.hugepageText() ? "1" : "0") + "\n");
         of.puts("# SystemC output mode?  0/1 (from --sc)\n");
         of.puts(string{"VM_SC = "} + ((v3Global.opt.systemC()) ? "1" : "0") + "\n");
         of.puts("# Legacy or SystemC output mode?  0/1 (from --sc)\n");
@@ -337,8 +401,9 @@ class EmitMkHierVerilation final {
         }
         of.puts("\n");
 
-        // Build hierarchical libraries as soon as possible to get maximum parallelism
-        of.puts("hier_build: $(VM_HIER_LIBS) " + v3Global.opt.prefix() + ".mk\n");
+        // The top makefile includes this one, and its archive depends on the hierarchical
+        // libraries, so it builds them in parallel with its own objects
+        of.puts("hier_build: " + v3Global.opt.prefix() + ".mk\n");
         of.puts("\t$(MAKE) -f " + v3Global.opt.prefix() + ".mk\n");
         of.puts("hier_verilation: " + v3Global.opt.prefix() + ".mk\n");
         emitCommonOpts(of);
@@ -367,7 +432,10 @@ class EmitMkHierVerilation final {
         for (const V3HierBlock* const blockp : m_planp->hierBlocksSorted()) {
             const string prefix = blockp->hierPrefix();
             const string argsFile = blockp->commandArgsFileName(false);
-            of.puts(blockp->hierGenerated(true));
+            // One Verilation generates both files, so only the wrapper has the recipe, or
+            // parallel make could Verilate the block twice at once
+            of.puts(blockp->hierMk(true) + ": " + blockp->hierWrapper(true) + "\n");
+            of.puts(blockp->hierWrapper(true));
             of.puts(": $(VM_HIER_INPUT_FILES) $(VM_HIER_VERILOG_LIBS) ");
             of.puts(V3Os::filenameNonDir(argsFile) + " ");
             const V3HierBlock::HierBlockSet& children = blockp->children();
@@ -378,16 +446,11 @@ class EmitMkHierVerilation final {
             of.puts("\n");
             emitLaunchVerilator(of, argsFile);
 
-            // Rule to build lib*.a
+            // Rule to build lib*.a. Only the final link needs the libraries of the children, so
+            // the blocks of all levels can be compiled in parallel.
             of.puts(blockp->hierLib(true));
             of.puts(": ");
             of.puts(blockp->hierMk(true));
-            of.puts(" ");
-            for (V3HierBlock::HierBlockSet::const_iterator child = children.begin();
-                 child != children.end(); ++child) {
-                of.puts((*child)->hierLib(true));
-                of.puts(" ");
-            }
             of.puts("\n\t$(MAKE) -f " + blockp->hierMk(false) + " -C " + prefix);
             of.puts(" VM_PREFIX=" + prefix);
             of.puts("\n\n");
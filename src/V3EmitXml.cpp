@@ -23,6 +23,7 @@
 #include "V3Global.h"
 #include "V3String.h"
 
+#include <array>
 #include <map>
 #include <vector>
 
@@ -39,6 +40,7 @@ class EmitXmlFileVisitor final : public VNVisitorConst {
     // MEMBERS
     V3OutFile* const m_ofp;
     uint64_t m_id = 0;
+    std::array<string, VNType::_ENUM_END> m_tagNames;  // Lower case typeName() cache
 
     // METHODS
 
@@ -56,13 +58,17 @@ class EmitXmlFileVisitor final : public VNVisitorConst {
     }
 
     // XML methods
+    const string& tagName(const AstNode* nodep) {
+        string& tag = m_tagNames[nodep->type()];
+        if (tag.empty()) tag = VString::downcase(nodep->typeName());
+        return tag;
+    }
     void outputId(AstNode* nodep) {
         if (!nodep->user1()) nodep->user1(++m_id);
         puts("\"" + cvtToStr(nodep->user1()) + "\"");
     }
     void outputTag(AstNode* nodep, const string& tagin) {
-        string tag = tagin;
-        if (tag == "") tag = VString::downcase(nodep->typeName());
+        const string& tag = tagin.empty() ? tagName(nodep) : tagin;
         puts("<" + tag);
         puts(" " + nodep->fileline()->xmlDetailedLocation());
         if (VN_IS(nodep, NodeDType)) {
@@ -90,8 +96,7 @@ class EmitXmlFileVisitor final : public VNVisitorConst {
         }
     }
     void outputChildrenEnd(AstNode* nodep, const string& tagin) {
-        string tag = tagin;
-        if (tag == "") tag = VString::downcase(nodep->typeName());
+        const string& tag = tagin.empty() ? tagName(nodep) : tagin;
         if (nodep->op1p() || nodep->op2p() || nodep->op3p() || nodep->op4p()) {
             puts(">\n");
             iterateChildrenConst(nodep);
@@ -424,6 +429,12 @@ private:
         if (nodep->name() != "") m_hier += nodep->name() + ".";
         iterateChildrenConst(nodep);
     }
+    // Cells cannot be under these, and they are the bulk of each module walked per instance
+    void visit(AstNodeExpr*) override {}
+    void visit(AstNodeDType*) override {}
+    void visit(AstVar*) override {}
+    void visit(AstNodeProcedure*) override {}
+    void visit(AstNodeFTask*) override {}
     //-----
     void visit(AstNode* nodep) override { iterateChildrenConst(nodep); }
 
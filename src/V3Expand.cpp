@@ -36,35 +36,53 @@
 #include "V3Stats.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
+//######################################################################
+// Statistics, accumulated per module so modules can be expanded in parallel
+
+struct ExpandStats final {
+    VDouble0 m_statWides;  // Statistic tracking
+    VDouble0 m_statWideWords;  // Statistic tracking
+    VDouble0 m_statWideLimited;  // Statistic tracking
+    VDouble0 m_statWideSimd;  // Statistic tracking
+};
+
 //######################################################################
 // Expand state, as a visitor of each AstNode
 
 class ExpandVisitor final : public VNVisitor {
 private:
-    // NODE STATE
+    // NODE STATE (allocated by V3Expand::expandAll)
     //  AstNode::user1()        -> bool.  Processed
-    const VNUser1InUse m_inuser1;
 
     // STATE
     AstNode* m_stmtp = nullptr;  // Current statement
-    VDouble0 m_statWides;  // Statistic tracking
-    VDouble0 m_statWideWords;  // Statistic tracking
-    VDouble0 m_statWideLimited;  // Statistic tracking
+    ExpandStats& m_stats;  // Statistics for the module being expanded
 
     // METHODS
 
     bool doExpand(AstNode* nodep) {
-        ++m_statWides;
+        ++m_stats.m_statWides;
         if (nodep->widthWords() <= v3Global.opt.expandLimit()) {
-            m_statWideWords += nodep->widthWords();
+            m_stats.m_statWideWords += nodep->widthWords();
             return true;
         } else {
-            ++m_statWideLimited;
+            ++m_stats.m_statWideLimited;
+            return false;
+        }
+    }
+    bool doExpandBitwise(AstNode* nodep) {
+        // Bitwise operations filling a vector register are faster in the library
+        // functions, which use vector instructions, than as separate word statements
+        const int simdWords = v3Global.opt.expandSimdWidth() / VL_EDATASIZE;
+        if (simdWords && nodep->widthWords() >= simdWords) {
+            ++m_stats.m_statWideSimd;
             return false;
         }
+        return doExpand(nodep);
     }
 
     static int longOrQuadWidth(AstNode* nodep) {
@@ -260,7 +278,7 @@ private:
     bool expandWide(AstNodeAssign* nodep, AstNot* rhsp) {
         UINFO(8, "    Wordize ASSIGN(NOT) " << nodep << endl);
         // -> {for each_word{ ASSIGN(WORDSEL(wide,#),NOT(WORDSEL(lhs,#))) }}
-        if (!doExpand(nodep)) return false;
+        if (!doExpandBitwise(nodep)) return false;
         FileLine* const fl = rhsp->fileline();
         for (int w = 0; w < nodep->widthWords(); ++w) {
             addWordAssign(nodep, w, new AstNot{fl, newAstWordSelClone(rhsp->lhsp(), w)});
@@ -270,7 +288,7 @@ private:
     //-------- Biops
     bool expandWide(AstNodeAssign* nodep, AstAnd* rhsp) {
         UINFO(8, "    Wordize ASSIGN(AND) " << nodep << endl);
-        if (!doExpand(nodep)) return false;
+        if (!doExpandBitwise(nodep)) return false;
         FileLine* const fl = nodep->fileline();
         for (int w = 0; w < nodep->widthWords(); ++w) {
             addWordAssign(nodep, w,
@@ -281,7 +299,7 @@ private:
     }
     bool expandWide(AstNodeAssign* nodep, AstOr* rhsp) {
         UINFO(8, "    Wordize ASSIGN(OR) " << nodep << endl);
-        if (!doExpand(nodep)) return false;
+        if (!doExpandBitwise(nodep)) return false;
         FileLine* const fl = nodep->fileline();
         for (int w = 0; w < nodep->widthWords(); ++w) {
             addWordAssign(nodep, w,
@@ -292,7 +310,7 @@ private:
     }
     bool expandWide(AstNodeAssign* nodep, AstXor* rhsp) {
         UINFO(8, "    Wordize ASSIGN(XOR) " << nodep << endl);
-        if (!doExpand(nodep)) return false;
+        if (!doExpandBitwise(nodep)) return false;
         FileLine* const fl = nodep->fileline();
         for (int w = 0; w < nodep->widthWords(); ++w) {
             addWordAssign(nodep, w,
@@ -747,7 +765,8 @@ private:
     void visitEqNeq(AstNodeBiop* nodep) {
         if (nodep->user1SetOnce()) return;  // Process once
         iterateChildren(nodep);
-        if (nodep->lhsp()->isWide()) {
+        // Past the limit VL_EQ_W compares many words per instruction
+        if (nodep->lhsp()->isWide() && doExpand(nodep->lhsp())) {
             UINFO(8, "    Wordize EQ/NEQ " << nodep << endl);
             // -> (0=={or{for each_word{WORDSEL(lhs,#)^WORDSEL(rhs,#)}}}
             FileLine* const fl = nodep->fileline();
@@ -823,7 +842,7 @@ private:
     void visit(AstRedXor* nodep) override {
         if (nodep->user1SetOnce()) return;  // Process once
         iterateChildren(nodep);
-        if (nodep->lhsp()->isWide()) {
+        if (nodep->lhsp()->isWide() && doExpand(nodep->lhsp())) {
             UINFO(8, "    Wordize REDXOR " << nodep << endl);
             // -> (0!={redxor{for each_word{XOR(WORDSEL(lhs,#))}}}
             FileLine* const fl = nodep->fileline();
@@ -898,12 +917,11 @@ private:
 
 public:
     // CONSTRUCTORS
-    explicit ExpandVisitor(AstNetlist* nodep) { iterate(nodep); }
-    ~ExpandVisitor() override {
-        V3Stats::addStat("Optimizations, expand wides", m_statWides);
-        V3Stats::addStat("Optimizations, expand wide words", m_statWideWords);
-        V3Stats::addStat("Optimizations, expand limited", m_statWideLimited);
+    ExpandVisitor(AstNodeModule* nodep, ExpandStats& stats)
+        : m_stats{stats} {
+        iterate(nodep);
     }
+    ~ExpandVisitor() override = default;
 };
 
 //----------------------------------------------------------------------
@@ -914,6 +932,29 @@ public:
 
 void V3Expand::expandAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    { ExpandVisitor{nodep}; }  // Destruct before checking
+    {
+        const VNUser1InUse inuser1;
+        // Modules are independent, so expand them in parallel, each with its own statistics
+        std::unordered_map<const AstNodeModule*, ExpandStats> modStats;
+        for (AstNode* modp = nodep->modulesp(); modp; modp = modp->nextp()) {
+            modStats[VN_AS(modp, NodeModule)];
+        }
+        AstNode::foreachModuleParallel(nodep, [&modStats](AstNodeModule* modp) {
+            ExpandVisitor{modp, modStats.at(modp)};
+        });
+        // The constant pool is not under modulesp()
+        ExpandStats total;
+        ExpandVisitor{nodep->constPoolp()->modp(), total};
+        for (const auto& itr : modStats) {
+            total.m_statWides += itr.second.m_statWides;
+            total.m_statWideWords += itr.second.m_statWideWords;
+            total.m_statWideLimited += itr.second.m_statWideLimited;
+            total.m_statWideSimd += itr.second.m_statWideSimd;
+        }
+        V3Stats::addStat("Optimizations, expand wides", total.m_statWides);
+        V3Stats::addStat("Optimizations, expand wide words", total.m_statWideWords);
+        V3Stats::addStat("Optimizations, expand limited", total.m_statWideLimited);
+        V3Stats::addStat("Optimizations, expand SIMD library calls", total.m_statWideSimd);
+    }
     V3Global::dumpCheckGlobalTree("expand", 0, dumpTreeLevel() >= 3);
 }
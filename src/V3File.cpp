@@ -23,13 +23,16 @@
 #include "V3Global.h"
 #include "V3Os.h"
 #include "V3String.h"
+#include "V3ThreadPool.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdarg>
 #include <fcntl.h>
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <sstream>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -334,6 +337,7 @@ class VInFilterImp final {
     using StrList = VInFilter::StrList;
 
     std::map<const std::string, std::string> m_contentsMap;  // Cache of file contents
+    std::map<const std::string, std::string> m_prefetchMap;  // Prefetched, not yet read contents
     bool m_readEof = false;  // Received EOF on read
 #ifdef INFILTER_PIPE
     pid_t m_pid = 0;  // fork() process id
@@ -574,7 +578,13 @@ protected:
             outl.push_back(it->second);
             return true;
         }
-        if (!readContents(filename, outl)) return false;
+        const auto pit = m_prefetchMap.find(filename);
+        if (pit != m_prefetchMap.end()) {
+            outl.push_back(std::move(pit->second));
+            m_prefetchMap.erase(pit);
+        } else if (!readContents(filename, outl)) {
+            return false;
+        }
         if (listSize(outl) < INFILTER_CACHE_MAX) {
             // Cache small files (only to save space)
             // It's quite common to `include "timescale" thousands of times
@@ -583,6 +593,34 @@ protected:
         }
         return true;
     }
+    // Read the given files concurrently, ahead of readWholefile needing them
+    void prefetch(const std::vector<string>& filenames) {
+        if (m_pid) return;  // The filter is a single pipe, so must be used serially
+        std::vector<string> todo;
+        for (const string& filename : filenames) {
+            if (m_contentsMap.count(filename) || m_prefetchMap.count(filename)) continue;
+            if (std::find(todo.begin(), todo.end(), filename) != todo.end()) continue;
+            todo.push_back(filename);
+        }
+        std::list<std::future<std::pair<bool, string>>> futures;
+        for (const string& filename : todo) {
+            futures.push_back(V3ThreadPool::s().enqueue<std::pair<bool, string>>(
+                [filename]() -> std::pair<bool, string> {
+                    std::ifstream is{filename, std::ios::in | std::ios::binary};
+                    if (!is) return {false, ""};
+                    std::ostringstream os;
+                    os << is.rdbuf();
+                    return {true, os.str()};
+                }));
+        }
+        auto results = V3ThreadPool::waitForFutures(futures);
+        auto nameIt = todo.cbegin();
+        for (auto& result : results) {
+            // Missing files are left for readWholefile to report as usual
+            if (result.first) m_prefetchMap.emplace(*nameIt, std::move(result.second));
+            ++nameIt;
+        }
+    }
     static size_t listSize(const StrList& sl) {
         size_t result = 0;
         for (const string& i : sl) result += i.length();
@@ -612,6 +650,11 @@ bool VInFilter::readWholefile(const string& filename, VInFilter::StrList& outl)
     return m_impp->readWholefile(filename, outl);
 }
 
+void VInFilter::prefetch(const std::vector<string>& filenames) {
+    if (!m_impp) v3fatalSrc("prefetch on invalid filter");
+    m_impp->prefetch(filenames);
+}
+
 //######################################################################
 // V3OutFormatter: A class for printing to a file, with automatic indentation of C++ code.
 
@@ -710,6 +753,19 @@ void V3OutFormatter::puts(const char* strg) {
     bool wordstart = true;
     bool equalsForBracket = false;  // Looking for "= {"
     for (const char* cp = strg; *cp; ++cp) {
+        if (isPlainChar(*cp)) {
+            // Output a run of plain characters at once, with the same effect as the
+            // default cases below, as most of the text emitted is identifiers and numbers
+            const char* const startp = cp;
+            while (isPlainChar(cp[1])) ++cp;
+            const size_t len = cp - startp + 1;
+            putnOutput(startp, len);
+            m_column += len;
+            m_nobreak = false;
+            wordstart = false;
+            equalsForBracket = false;
+            continue;
+        }
         putcNoTracking(*cp);
         if (std::isalpha(*cp)) {
             if (wordstart && m_lang == LA_VERILOG && tokenNotStart(cp)) notstart = true;
@@ -799,6 +855,31 @@ void V3OutFormatter::puts(const char* strg) {
     }
 }
 
+bool V3OutFormatter::isPlainChar(char chr) const {
+    switch (chr) {
+    case '\0':
+    case '\n':
+    case '\t':
+    case ' ':
+    case '"':
+    case '/':
+    case '{':
+    case '}':
+    case '(':
+    case ')':
+    case '<':
+    case '>':
+    case '=':
+    case '|':
+    case '&': return false;
+    default: return m_lang != LA_VERILOG || !std::isalpha(chr);
+    }
+}
+
+void V3OutFormatter::putnOutput(const char* strp, size_t len) {
+    for (const char* const endp = strp + len; strp != endp; ++strp) putcOutput(*strp);
+}
+
 void V3OutFormatter::putBreakExpr() {
     if (!m_parenVec.empty()) putBreak();
 }
@@ -923,8 +1004,16 @@ void V3OutFormatter::printf(const char* fmt...) {
 V3OutFile::V3OutFile(const string& filename, V3OutFormatter::Language lang)
     : V3OutFormatter{filename, lang}
     , m_bufferp{new std::array<char, WRITE_BUFFER_SIZE_BYTES>{}} {
-    if ((m_fp = V3File::new_fopen_w(filename)) == nullptr) {
-        v3fatal("Cannot write " << filename);
+    // With --write-if-changed, write a temporary and only replace an existing
+    // output if the contents differ, so its timestamp (and thus the object
+    // file compiled from it) stays valid across re-verilation
+    if (v3Global.opt.writeIfChanged() && V3OutFile::fileExists(filename)) {
+        m_tmpFilename = filename + ".vltmp";
+        V3File::addTgtDepend(filename);
+    }
+    const string& openName = m_tmpFilename.empty() ? filename : m_tmpFilename;
+    if ((m_fp = V3File::new_fopen_w(openName)) == nullptr) {
+        v3fatal("Cannot write " << openName);
     }
 }
 
@@ -933,6 +1022,36 @@ V3OutFile::~V3OutFile() {
 
     if (m_fp) fclose(m_fp);
     m_fp = nullptr;
+
+    if (!m_tmpFilename.empty()) {
+        if (filesIdentical(m_tmpFilename, filename())) {
+            std::remove(m_tmpFilename.c_str());
+        } else if (rename(m_tmpFilename.c_str(), filename().c_str()) != 0) {
+            v3fatal("Cannot rename " << m_tmpFilename << " to " << filename());
+        }
+    }
+}
+
+bool V3OutFile::fileExists(const string& filename) {
+    struct stat sstat;  // Stat information
+    return stat(filename.c_str(), &sstat) == 0;
+}
+
+bool V3OutFile::filesIdentical(const string& filenamea, const string& filenameb) {
+    std::ifstream fa{filenamea, std::ios::binary};
+    std::ifstream fb{filenameb, std::ios::binary};
+    if (!fa || !fb) return false;
+    constexpr std::streamsize BUF_SIZE = 64 * 1024;
+    std::unique_ptr<char[]> bufap{new char[BUF_SIZE]};
+    std::unique_ptr<char[]> bufbp{new char[BUF_SIZE]};
+    while (true) {
+        fa.read(bufap.get(), BUF_SIZE);
+        fb.read(bufbp.get(), BUF_SIZE);
+        const std::streamsize gota = fa.gcount();
+        if (gota != fb.gcount()) return false;
+        if (std::memcmp(bufap.get(), bufbp.get(), gota) != 0) return false;
+        if (!fa || !fb) return !fa && !fb;
+    }
 }
 
 void V3OutFile::putsForceIncs() {
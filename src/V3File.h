@@ -96,6 +96,8 @@ public:
     // METHODS
     // Read file contents and return it.  Return true on success.
     bool readWholefile(const string& filename, StrList& outl);
+    // Read the given files ahead of time, in parallel on the thread pool
+    void prefetch(const std::vector<string>& filenames);
 };
 
 //============================================================================
@@ -130,6 +132,8 @@ private:
 
     int endLevels(const char* strg);
     void putcNoTracking(char chr);
+    // True if chr has no special meaning to puts() formatting
+    bool isPlainChar(char chr) const;
 
 public:
     V3OutFormatter(const string& filename, Language lang);
@@ -180,6 +184,8 @@ public:
     // CALLBACKS - MUST OVERRIDE
     virtual void putcOutput(char chr) = 0;
     virtual void putsOutput(const char* str) = 0;
+    // Output len characters of strp, override for a faster block copy
+    virtual void putnOutput(const char* strp, size_t len);
 };
 
 //============================================================================
@@ -198,6 +204,7 @@ class V3OutFile VL_NOT_FINAL : public V3OutFormatter {
     FILE* m_fp = nullptr;
     std::size_t m_usedBytes = 0;  // Number of bytes stored in m_bufferp
     std::unique_ptr<std::array<char, WRITE_BUFFER_SIZE_BYTES>> m_bufferp;  // Write buffer
+    string m_tmpFilename;  // --write-if-changed file written instead of filename(), or empty
 
 public:
     V3OutFile(const string& filename, V3OutFormatter::Language lang);
@@ -210,6 +217,8 @@ public:
     void putsForceIncs();
 
 private:
+    static bool fileExists(const string& filename);
+    static bool filesIdentical(const string& filenamea, const string& filenameb);
     void writeBlock() {
         if (VL_LIKELY(m_usedBytes > 0)) fwrite(m_bufferp->data(), m_usedBytes, 1, m_fp);
         m_usedBytes = 0;
@@ -217,11 +226,11 @@ private:
 
     // CALLBACKS
     void putcOutput(char chr) override {
-        m_bufferp->at(m_usedBytes++) = chr;
+        (*m_bufferp)[m_usedBytes++] = chr;
         if (VL_UNLIKELY(m_usedBytes >= WRITE_BUFFER_SIZE_BYTES)) writeBlock();
     }
-    void putsOutput(const char* str) override {
-        std::size_t len = strlen(str);
+    void putsOutput(const char* str) override { putnOutput(str, strlen(str)); }
+    void putnOutput(const char* str, std::size_t len) override {
         std::size_t availableBytes = WRITE_BUFFER_SIZE_BYTES - m_usedBytes;
         while (VL_UNLIKELY(len >= availableBytes)) {
             std::memcpy(m_bufferp->data() + m_usedBytes, str, availableBytes);
@@ -24,12 +24,20 @@
 //          initial <name>__VforceEn = 0;
 //      add a continuous assignment:
 //          assign <name>__VforceRd = <name>__VforceEn ? <name>__VforceVl : <name>;
+//      or, unless the signal is externally forceable (via its public __VforceEn/__VforceVl):
+//          assign <name>__VforceRd = __VforceAny
+//                                    ? (<name>__VforceEn ? <name>__VforceVl : <name>) : <name>;
 //      replace all READ references to <name> with a read reference to <name>_VforceRd
 //
-//  Replace each AstAssignForce with 3 assignments:
+//  Replace each AstAssignForce with 4 assignments:
 //      - <lhs>__VforceEn = 1
 //      - <lhs>__VforceVl = <rhs>
 //      - <lhs>__VforceRd = <rhs>
+//      - __VforceAny = 1
+//
+//  __VforceAny is a single global flag, cleared by a static initializer, set by the first force
+//  statement executed and never cleared again, so designs which rarely force anything only pay
+//  for testing it.
 //
 //  Replace each AstRelease with 1 or 2 assignments:
 //      - <lhs>__VforceEn = 0
@@ -83,7 +91,8 @@ class ForceConvertVisitor final : public VNVisitor {
         AstVarScope* const m_rdVscp;  // New variable to replace read references with
         AstVarScope* const m_enVscp;  // Force enabled signal
         AstVarScope* const m_valVscp;  // Forced value
-        explicit ForceComponentsVarScope(AstVarScope* vscp, ForceComponentsVar& fcv)
+        explicit ForceComponentsVarScope(AstVarScope* vscp, ForceComponentsVar& fcv,
+                                         AstVarScope* anyVscp)
             : m_rdVscp{new AstVarScope{vscp->fileline(), vscp->scopep(), fcv.m_rdVarp}}
             , m_enVscp{new AstVarScope{vscp->fileline(), vscp->scopep(), fcv.m_enVarp}}
             , m_valVscp{new AstVarScope{vscp->fileline(), vscp->scopep(), fcv.m_valVarp}} {
@@ -124,6 +133,13 @@ class ForceConvertVisitor final : public VNVisitor {
                     rhsp = new AstCond{flp, new AstVarRef{flp, m_enVscp, VAccess::READ},
                                        new AstVarRef{flp, m_valVscp, VAccess::READ}, origp};
                 }
+                if (!vscp->varp()->isForceable()) {
+                    // Only evaluate the override once something has been forced
+                    AstVarRef* const fastp = new AstVarRef{flp, vscp, VAccess::READ};
+                    fastp->user2(1);  // Don't replace this read ref with the read signal
+                    rhsp = new AstCond{flp, new AstVarRef{flp, anyVscp, VAccess::READ}, rhsp,
+                                       fastp};
+                }
 
                 AstActive* const activep
                     = new AstActive{flp, "force-comb",
@@ -144,6 +160,10 @@ class ForceConvertVisitor final : public VNVisitor {
     AstUser1Allocator<AstVar, ForceComponentsVar> m_forceComponentsVar;
     AstUser1Allocator<AstVarScope, ForceComponentsVarScope> m_forceComponentsVarScope;
 
+    // STATE
+    AstScope* const m_topScopep;  // The top level scope
+    AstVarScope* m_anyVscp = nullptr;  // Flag set when anything has been forced
+
     // METHODS
     static bool isRangedDType(AstNode* nodep) {
         // If ranged we need a multibit enable to support bit-by-bit part-select forces,
@@ -153,7 +173,23 @@ class ForceConvertVisitor final : public VNVisitor {
     }
     const ForceComponentsVarScope& getForceComponents(AstVarScope* vscp) {
         AstVar* const varp = vscp->varp();
-        return m_forceComponentsVarScope(vscp, vscp, m_forceComponentsVar(varp, varp));
+        return m_forceComponentsVarScope(vscp, vscp, m_forceComponentsVar(varp, varp),
+                                         getAnyVscp());
+    }
+    AstVarScope* getAnyVscp() {
+        if (m_anyVscp) return m_anyVscp;
+        m_anyVscp = m_topScopep->createTemp("__VforceAny", 1);
+        // Clear it in a static initializer, so it is set before any initial block can force
+        FileLine* const flp = m_anyVscp->fileline();
+        AstAssign* const assignp
+            = new AstAssign{flp, new AstVarRef{flp, m_anyVscp, VAccess::WRITE},
+                            new AstConst{flp, AstConst::BitFalse{}}};
+        AstActive* const activep = new AstActive{
+            flp, "force-any-init", new AstSenTree{flp, new AstSenItem{flp, AstSenItem::Static{}}}};
+        activep->sensesStorep(activep->sensesp());
+        activep->addStmtsp(new AstInitialStatic{flp, assignp});
+        m_topScopep->addBlocksp(activep);
+        return m_anyVscp;
     }
 
     // Replace each AstNodeVarRef in the given 'nodep' that writes a variable by transforming the
@@ -205,8 +241,14 @@ class ForceConvertVisitor final : public VNVisitor {
             return getForceComponents(vscp).m_rdVscp;
         });
 
+        // Enable the override logic
+        AstAssign* const setAnyp
+            = new AstAssign{flp, new AstVarRef{flp, getAnyVscp(), VAccess::WRITE},
+                            new AstConst{flp, AstConst::BitTrue{}}};
+
         setEnp->addNext(setValp);
         setEnp->addNext(setRdp);
+        setEnp->addNext(setAnyp);
         relinker.relink(setEnp);
     }
 
@@ -292,7 +334,8 @@ class ForceConvertVisitor final : public VNVisitor {
     }
 
     // CONSTRUCTOR
-    explicit ForceConvertVisitor(AstNetlist* nodep) {
+    explicit ForceConvertVisitor(AstNetlist* nodep)
+        : m_topScopep{nodep->topScopep()->scopep()} {
         // Transform all force and release statements
         iterateAndNextNull(nodep->modulesp());
 
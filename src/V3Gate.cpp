@@ -396,15 +396,31 @@ private:
         m_substitutions(consumerp).emplace(varscp, substp->cloneTree(false));
     }
 
+    bool substituteElimVar(AstNode* logicp) {
+        // Apply pending substitutions, return true if any. Only edits under 'logicp'.
+        auto* const substitutionsp = m_substitutions.tryGet(logicp);
+        if (!substitutionsp || substitutionsp->empty()) return false;
+        eliminate(logicp, *substitutionsp, nullptr);
+        for (const auto& pair : *substitutionsp) pair.second->deleteTree();
+        substitutionsp->clear();
+        return true;
+    }
+    static void foldElimVar(AstNode* logicp) {
+        AstNode* const foldedp = V3Const::constifyEdit(logicp);
+        UASSERT_OBJ(foldedp == logicp, foldedp, "Should not remove whole logic");
+    }
     void commitElimVar(AstNode* logicp) {
-        if (auto* const substitutionsp = m_substitutions.tryGet(logicp)) {
-            if (!substitutionsp->empty()) {
-                eliminate(logicp, *substitutionsp, nullptr);
-                AstNode* const foldedp = V3Const::constifyEdit(logicp);
-                UASSERT_OBJ(foldedp == logicp, foldedp, "Should not remove whole logic");
-                for (const auto& pair : *substitutionsp) pair.second->deleteTree();
-                substitutionsp->clear();
-            }
+        if (substituteElimVar(logicp)) foldElimVar(logicp);
+    }
+    void commitAllElimVars() {
+        // Each logic block has its own copy of its substitutions, so substitute in parallel.
+        // V3Const is not thread safe, so fold the results serially afterwards.
+        std::vector<uint8_t> changed(m_optimized.size(), 0);
+        AstNode::foreachIndexParallel(m_optimized.size(), [&](size_t i) {
+            changed[i] = substituteElimVar(m_optimized[i]);
+        });
+        for (size_t i = 0; i < m_optimized.size(); ++i) {
+            if (changed[i]) foldElimVar(m_optimized[i]);
         }
     }
 
@@ -434,7 +450,7 @@ private:
         // Then propagate more complicated equations
         optimizeSignals(true);
         // Commit substitutions on the optimized logic
-        for (AstNode* const logicp : m_optimized) commitElimVar(logicp);
+        commitAllElimVars();
         // Remove redundant logic
         if (v3Global.opt.fDedupe()) {
             dedupe();
@@ -860,22 +876,21 @@ public:
         rhsp->user3p(extra1p);
         rhsp->user5p(extra2p);
 
-        const auto inserted = m_dupFinder.insert(rhsp);
-        const auto dupit = m_dupFinder.findDuplicate(rhsp, this);
+        m_dupFinder.insert(rhsp);
+        const AstNode* const dupp = m_dupFinder.findDuplicate(rhsp, this);
         // Even though rhsp was just inserted, V3DupFinder::findDuplicate doesn't
         // return anything in the hash that has the same pointer (V3DupFinder::findDuplicate)
-        // So dupit is either a different, duplicate rhsp, or the end of the hash.
-        if (dupit != m_dupFinder.end()) {
-            m_dupFinder.erase(inserted);
-            return VN_AS(dupit->second->user2p(), NodeAssign);
+        // So dupp is either a different, duplicate rhsp, or nullptr.
+        if (dupp) {
+            m_dupFinder.erase(rhsp);
+            return VN_AS(dupp->user2p(), NodeAssign);
         }
         // Retain new inserted information
         return nullptr;
     }
 
     void check() {
-        for (const auto& itr : m_dupFinder) {
-            AstNode* const nodep = itr.second;
+        m_dupFinder.foreach([&](AstNode* nodep) {
             const AstNode* const activep = nodep->user3p();
             const AstNode* const condVarp = nodep->user5p();
             if (!isReplaced(nodep)) {
@@ -886,7 +901,7 @@ public:
                 UASSERT_OBJ(!condVarp || !VN_DELETED(condVarp), nodep,
                             "V3DupFinder check failed, lost if pointer");
             }
-        }
+        });
     }
 };
 
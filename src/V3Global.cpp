@@ -54,6 +54,22 @@ void V3Global::readFiles() {
 
     V3Parse parser{v3Global.rootp(), &filter, &parseSyms};
 
+    // Preprocessing and parsing share lexer and symbol state so stay serial,
+    // but with --verilate-jobs read the source files from disk in parallel
+    if (v3Global.opt.verilateJobs() > 1) {
+        FileLine fl{FileLine::commandLineFilename()};
+        std::vector<string> filenames;
+        // Resolve as the preprocessor will, so the prefetched contents are found
+        const auto addFile = [&](const string& filename) {
+            const string path = v3Global.opt.filePath(&fl, filename, "", "");
+            if (!path.empty()) filenames.push_back(path);
+        };
+        if (v3Global.opt.std()) addFile(V3Options::getStdPackagePath());
+        for (const string& filename : v3Global.opt.vFiles()) addFile(filename);
+        for (const string& filename : v3Global.opt.libraryFiles()) addFile(filename);
+        filter.prefetch(filenames);
+    }
+
     // Parse the std package
     if (v3Global.opt.std()) {
         parser.parseFile(new FileLine{V3Options::getStdPackagePath()},
@@ -115,6 +131,7 @@ void V3Global::dumpCheckGlobalTree(const string& stagename, int newNumber, bool
         v3Global.rootp()->dumpTreeDotFile(treeFilename + ".dot", false, doDump);
     }
     if (v3Global.opt.stats()) V3Stats::statsStage(stagename);
+    if (v3Global.opt.profVerilation()) V3Stats::profVerilationStage(stagename);
 }
 
 const std::string& V3Global::ptrToId(const void* p) {
@@ -30,6 +30,7 @@
 #include "V3FileLine.h"
 #include "V3Options.h"
 
+#include <atomic>
 #include <string>
 #include <unordered_map>
 
@@ -112,7 +113,7 @@ class V3Global final {
     bool m_usesTiming = false;  // Design uses timing constructs
     bool m_hasForceableSignals = false;  // Need to apply V3Force pass
     bool m_hasSCTextSections = false;  // Has `systemc_* sections that need to be emitted
-    bool m_useParallelBuild = false;  // Use parallel build for model
+    std::atomic<bool> m_useParallelBuild{false};  // Use parallel build, set by emit jobs
     bool m_useRandomizeMethods = false;  // Need to define randomize() class methods
 
     // Memory address to short string mapping (for debug)
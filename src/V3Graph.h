@@ -24,6 +24,7 @@
 #include "V3List.h"
 
 #include <algorithm>
+#include <vector>
 
 class FileLine;
 class V3Graph;
@@ -341,6 +342,41 @@ public:
     V3GraphEdge* nextp(GraphWay way) const { return way.forward() ? outNextp() : inNextp(); }
 };
 
+//============================================================================
+// Compressed sparse row snapshot of a V3Graph, for algorithms that traverse
+// a graph many times without changing it. Vertices are numbered in
+// verticesBeginp() order, and the edges of each vertex are stored
+// contiguously, in list order, instead of being chased through pointers.
+// Only edges with a weight, for which the edge function is true, are kept.
+// Building the snapshot overwrites V3GraphVertex::user(); changing the graph
+// invalidates the snapshot.
+
+class V3GraphCsr final {
+    // MEMBERS
+    std::vector<V3GraphVertex*> m_vertexps;  // Vertex of each index
+    std::vector<uint32_t> m_outStart;  // Start of each vertex's out edges in m_outs, then end
+    std::vector<uint32_t> m_outs;  // Index of top() vertex of each out edge
+    std::vector<uint32_t> m_inStart;  // Start of each vertex's in edges in m_ins, then end
+    std::vector<uint32_t> m_ins;  // Index of fromp() vertex of each in edge
+
+public:
+    // CONSTRUCTORS
+    explicit V3GraphCsr(const V3Graph& graph,
+                        V3EdgeFuncP edgeFuncp = &V3GraphEdge::followAlwaysTrue);
+    // ACCESSORS
+    uint32_t size() const { return static_cast<uint32_t>(m_vertexps.size()); }
+    V3GraphVertex* vertexp(uint32_t i) const { return m_vertexps[i]; }
+    const uint32_t* outBegin(uint32_t i) const { return m_outs.data() + m_outStart[i]; }
+    const uint32_t* outEnd(uint32_t i) const { return m_outs.data() + m_outStart[i + 1]; }
+    const uint32_t* inBegin(uint32_t i) const { return m_ins.data() + m_inStart[i]; }
+    const uint32_t* inEnd(uint32_t i) const { return m_ins.data() + m_inStart[i + 1]; }
+    uint32_t inSize(uint32_t i) const { return m_inStart[i + 1] - m_inStart[i]; }
+    // METHODS
+    // Set 'order' to the vertex indices such that every edge goes forward.
+    // Returns false if the graph has a loop, in which case 'order' is incomplete.
+    bool topologicalOrder(std::vector<uint32_t>& order) const;
+};
+
 //============================================================================
 
 #endif  // Guard
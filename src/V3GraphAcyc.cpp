@@ -17,11 +17,14 @@
 #include "config_build.h"
 #include "verilatedos.h"
 
+#include "V3Ast.h"
 #include "V3Global.h"
 #include "V3Graph.h"
 
 #include <algorithm>
+#include <deque>
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -91,6 +94,14 @@ class GraphAcyc final {
 private:
     using OrigEdgeList
         = std::list<V3GraphEdge*>;  // List of orig edges, see also GraphAcycEdge's decl
+    using WorkList = V3List<GraphAcycVertex*>;
+    // Placement state of a strongly connected component of m_breakGraph. Loops can only go
+    // through a single component, so each is placed independently, possibly in parallel.
+    struct PlaceScc final {
+        std::vector<V3GraphEdge*> m_edges;  // Cutable edges within the component
+        WorkList m_work;  // Vertices with ranks changed by the edge being placed
+        uint32_t m_placeStep = 0;  // Number that user() must be equal to to indicate processing
+    };
     // GRAPH USERS
     //  origGraph
     //    GraphVertex::user()   GraphAycVerted* New graph node
@@ -100,11 +111,10 @@ private:
     // MEMBERS
     V3Graph* const m_origGraphp;  // Original graph
     V3Graph m_breakGraph;  // Graph with only breakable edges represented
-    V3List<GraphAcycVertex*> m_work;  // List of vertices with optimization work left
+    WorkList m_work;  // List of vertices with optimization work left
     std::vector<OrigEdgeList*> m_origEdgeDelp;  // List of deletions to do when done
     const V3EdgeFuncP
         m_origEdgeFuncp;  // Function that says we follow this edge (in original graph)
-    uint32_t m_placeStep = 0;  // Number that user() must be equal to to indicate processing
 
     // METHODS
     void buildGraph(V3Graph* origGraphp);
@@ -118,8 +128,8 @@ private:
     void cutBackward(GraphAcycVertex* avertexp);
     void deleteMarked();
     void place();
-    void placeTryEdge(V3GraphEdge* edgep);
-    bool placeIterate(GraphAcycVertex* vertexp, uint32_t currentRank);
+    void placeTryEdge(PlaceScc& scc, V3GraphEdge* edgep);
+    bool placeIterate(PlaceScc& scc, GraphAcycVertex* vertexp, uint32_t currentRank);
 
     bool origFollowEdge(V3GraphEdge* edgep) {
         return (edgep->weight() && (m_origEdgeFuncp)(edgep));
@@ -164,20 +174,22 @@ private:
         }
     }
     // Work Queue
-    void workPush(V3GraphVertex* vertexp) {
+    static void workPush(WorkList& work, V3GraphVertex* vertexp) {
         GraphAcycVertex* const avertexp = static_cast<GraphAcycVertex*>(vertexp);
         // Add vertex to list of nodes needing further optimization trials
         if (!avertexp->m_onWorkList) {
             avertexp->m_onWorkList = true;
-            avertexp->m_work.pushBack(m_work, avertexp);
+            avertexp->m_work.pushBack(work, avertexp);
         }
     }
-    GraphAcycVertex* workBeginp() { return m_work.begin(); }
-    void workPop() {
-        GraphAcycVertex* const avertexp = workBeginp();
+    static void workPop(WorkList& work) {
+        GraphAcycVertex* const avertexp = work.begin();
         avertexp->m_onWorkList = false;
-        avertexp->m_work.unlink(m_work, avertexp);
+        avertexp->m_work.unlink(work, avertexp);
     }
+    void workPush(V3GraphVertex* vertexp) { workPush(m_work, vertexp); }
+    GraphAcycVertex* workBeginp() { return m_work.begin(); }
+    void workPop() { workPop(m_work); }
 
 public:
     // CONSTRUCTORS
@@ -444,84 +456,91 @@ void GraphAcyc::cutBackward(GraphAcycVertex* avertexp) {
 void GraphAcyc::place() {
     // Input is m_breakGraph with ranks already assigned on non-breakable edges
 
-    // Make a list of all cutable edges in the graph
-    int numEdges = 0;
-    for (V3GraphVertex* vertexp = m_breakGraph.verticesBeginp(); vertexp;
-         vertexp = vertexp->verticesNextp()) {
-        for (V3GraphEdge* edgep = vertexp->outBeginp(); edgep; edgep = edgep->outNextp()) {
-            if (edgep->weight() && edgep->cutable()) ++numEdges;
-        }
-    }
-    UINFO(4, "    Cutable edges = " << numEdges << endl);
+    // Color the strongly connected components, as only edges within one can be in a loop
+    m_breakGraph.stronglyConnected(&V3GraphEdge::followAlwaysTrue);
 
-    std::vector<V3GraphEdge*> edges;  // List of all edges to be processed
-    // Make the vector properly sized right off the bat -- faster than reallocating
-    edges.reserve(numEdges + 1);
+    // Make a list of the cutable edges in each component
+    std::deque<PlaceScc> sccs;
+    std::unordered_map<uint32_t, size_t> sccIndex;  // Color -> index in 'sccs'
+    int numEdges = 0;
     for (V3GraphVertex* vertexp = m_breakGraph.verticesBeginp(); vertexp;
          vertexp = vertexp->verticesNextp()) {
         vertexp->user(0);  // Clear in prep of next step
+        const uint32_t color = vertexp->color();
+        if (!color) continue;
         for (V3GraphEdge* edgep = vertexp->outBeginp(); edgep; edgep = edgep->outNextp()) {
-            if (edgep->weight() && edgep->cutable()) edges.push_back(edgep);
+            if (edgep->weight() && edgep->cutable() && edgep->top()->color() == color) {
+                const auto pair = sccIndex.emplace(color, sccs.size());
+                if (pair.second) sccs.emplace_back();
+                sccs[pair.first->second].m_edges.push_back(edgep);
+                ++numEdges;
+            }
         }
     }
-
-    // Sort by weight, then by vertex (so that we completely process one vertex, when possible)
-    stable_sort(edges.begin(), edges.end(), GraphAcycEdgeCmp());
-
-    // Process each edge in weighted order
-    m_placeStep = 10;
-    for (V3GraphEdge* edgep : edges) placeTryEdge(edgep);
+    UINFO(4, "    Cutable edges = " << numEdges << " in " << sccs.size() << " components"
+                                    << endl);
+
+    AstNode::foreachIndexParallel(sccs.size(), [&](size_t i) {
+        PlaceScc& scc = sccs[i];
+        // Sort by weight, then by vertex (so that we completely process one vertex, when
+        // possible)
+        std::stable_sort(scc.m_edges.begin(), scc.m_edges.end(), GraphAcycEdgeCmp());
+        // Process each edge in weighted order
+        scc.m_placeStep = 10;
+        for (V3GraphEdge* edgep : scc.m_edges) placeTryEdge(scc, edgep);
+    });
 }
 
-void GraphAcyc::placeTryEdge(V3GraphEdge* edgep) {
+void GraphAcyc::placeTryEdge(PlaceScc& scc, V3GraphEdge* edgep) {
     // Try to make this edge uncutable
-    m_placeStep++;
-    UINFO(8, "    PlaceEdge s" << m_placeStep << " w" << edgep->weight() << " " << edgep->fromp()
-                               << endl);
+    scc.m_placeStep++;
+    UINFO(8, "    PlaceEdge s" << scc.m_placeStep << " w" << edgep->weight() << " "
+                               << edgep->fromp() << endl);
     // Make the edge uncutable so we detect it in placement
     edgep->cutable(false);
     // Vertex::m_user begin: number indicates this edge was completed
     // Try to assign ranks, presuming this edge is in place
     // If we come across user()==placestep, we've detected a loop and must back out
-    const bool loop
-        = placeIterate(static_cast<GraphAcycVertex*>(edgep->top()), edgep->fromp()->rank() + 1);
+    const bool loop = placeIterate(scc, static_cast<GraphAcycVertex*>(edgep->top()),
+                                   edgep->fromp()->rank() + 1);
     if (!loop) {
         // No loop, we can keep it as uncutable
         // Commit the new ranks we calculated
         // Just cleanup the list.  If this is slow, we can add another set of
         // user counters to avoid cleaning up the list.
-        while (workBeginp()) workPop();
+        while (scc.m_work.begin()) workPop(scc.m_work);
     } else {
         // Adding this edge would cause a loop, kill it
         edgep->cutable(true);  // So graph still looks pretty
         cutOrigEdge(edgep, "  Cut loop");
         VL_DO_DANGLING(edgep->unlinkDelete(), edgep);
         // Back out the ranks we calculated
-        while (GraphAcycVertex* vertexp = workBeginp()) {
-            workPop();
+        while (GraphAcycVertex* vertexp = scc.m_work.begin()) {
+            workPop(scc.m_work);
             vertexp->rank(vertexp->m_storedRank);
         }
     }
 }
 
-bool GraphAcyc::placeIterate(GraphAcycVertex* vertexp, uint32_t currentRank) {
+bool GraphAcyc::placeIterate(PlaceScc& scc, GraphAcycVertex* vertexp, uint32_t currentRank) {
     // Assign rank to each unvisited node
     //   rank() is the "committed rank" of the graph known without loops
     // If larger rank is found, assign it and loop back through
     // If we hit a back node make a list of all loops
     if (vertexp->rank() >= currentRank) return false;  // Already processed it
-    if (vertexp->user() == m_placeStep) return true;  // Loop detected
-    vertexp->user(m_placeStep);
+    if (vertexp->user() == scc.m_placeStep) return true;  // Loop detected
+    vertexp->user(scc.m_placeStep);
     // Remember we're changing the rank of this node; might need to back out
     if (!vertexp->m_onWorkList) {
         vertexp->m_storedRank = vertexp->rank();
-        workPush(vertexp);
+        workPush(scc.m_work, vertexp);
     }
     vertexp->rank(currentRank);
-    // Follow all edges and increase their ranks
+    // Follow all edges within the component and increase their ranks. Loops cannot leave the
+    // component, and ranks outside of it are not needed for placement.
     for (V3GraphEdge* edgep = vertexp->outBeginp(); edgep; edgep = edgep->outNextp()) {
-        if (edgep->weight() && !edgep->cutable()) {
-            if (placeIterate(static_cast<GraphAcycVertex*>(edgep->top()), currentRank + 1)) {
+        if (edgep->weight() && !edgep->cutable() && edgep->top()->color() == vertexp->color()) {
+            if (placeIterate(scc, static_cast<GraphAcycVertex*>(edgep->top()), currentRank + 1)) {
                 // We don't need to reset user(); we'll use a different placeStep for the next edge
                 return true;  // Loop detected
             }
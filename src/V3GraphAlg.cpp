@@ -29,6 +29,54 @@
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
+//######################################################################
+//######################################################################
+// Compressed sparse row snapshot
+
+V3GraphCsr::V3GraphCsr(const V3Graph& graph, V3EdgeFuncP edgeFuncp) {
+    // Number vertices, using user() to map back from vertex to index
+    for (V3GraphVertex* vertexp = graph.verticesBeginp(); vertexp;
+         vertexp = vertexp->verticesNextp()) {
+        vertexp->user(static_cast<uint32_t>(m_vertexps.size()));
+        m_vertexps.push_back(vertexp);
+    }
+    const auto follow = [edgeFuncp](const V3GraphEdge* edgep) {
+        return edgep->weight() && edgeFuncp(edgep);
+    };
+    m_outStart.reserve(m_vertexps.size() + 1);
+    m_inStart.reserve(m_vertexps.size() + 1);
+    for (V3GraphVertex* const vertexp : m_vertexps) {
+        m_outStart.push_back(static_cast<uint32_t>(m_outs.size()));
+        for (V3GraphEdge* edgep = vertexp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+            if (follow(edgep)) m_outs.push_back(edgep->top()->user());
+        }
+        m_inStart.push_back(static_cast<uint32_t>(m_ins.size()));
+        for (V3GraphEdge* edgep = vertexp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+            if (follow(edgep)) m_ins.push_back(edgep->fromp()->user());
+        }
+    }
+    m_outStart.push_back(static_cast<uint32_t>(m_outs.size()));
+    m_inStart.push_back(static_cast<uint32_t>(m_ins.size()));
+}
+
+bool V3GraphCsr::topologicalOrder(std::vector<uint32_t>& order) const {
+    // Kahn's algorithm, using 'order' itself as the work queue
+    order.clear();
+    order.reserve(size());
+    std::vector<uint32_t> pending(size());  // Number of in edges not yet visited
+    for (uint32_t i = 0; i < size(); ++i) {
+        pending[i] = inSize(i);
+        if (!pending[i]) order.push_back(i);
+    }
+    for (size_t next = 0; next < order.size(); ++next) {
+        const uint32_t i = order[next];
+        for (const uint32_t* itp = outBegin(i); itp != outEnd(i); ++itp) {
+            if (!--pending[*itp]) order.push_back(*itp);
+        }
+    }
+    return order.size() == size();
+}
+
 //######################################################################
 //######################################################################
 // Algorithms - weakly connected components
@@ -266,6 +314,23 @@ void V3Graph::stronglyConnected(V3EdgeFuncP edgeFuncp) { GraphAlgStrongly{this,
 class GraphAlgRank final : GraphAlg<> {
 private:
     void main() {
+        // Acyclic graphs are ranked with a longest path pass over a snapshot of the graph,
+        // without pointer chasing. Loops need the depth first search below to report them.
+        const V3GraphCsr csr{*m_graphp, m_edgeFuncp};
+        std::vector<uint32_t> order;
+        if (csr.topologicalOrder(order)) {
+            std::vector<uint32_t> ranks(csr.size(), 1);
+            for (const uint32_t i : order) {
+                V3GraphVertex* const vertexp = csr.vertexp(i);
+                vertexp->rank(ranks[i]);
+                vertexp->user(2);
+                const uint32_t nextRank = ranks[i] + vertexp->rankAdder();
+                for (const uint32_t* itp = csr.outBegin(i); itp != csr.outEnd(i); ++itp) {
+                    ranks[*itp] = std::max(ranks[*itp], nextRank);
+                }
+            }
+            return;
+        }
         // Rank each vertex, ignoring cutable edges
         // Vertex::m_user begin: 1 indicates processing, 2 indicates completed
         // Clear existing ranks
@@ -481,11 +546,29 @@ void V3Graph::order() {
 }
 
 void V3Graph::orderPreRanked() {
-    // Compute fanouts
-    // Vertex::m_user begin: 1 indicates processing, 2 indicates completed
-    userClearVertices();
-    for (V3GraphVertex* vertexp = verticesBeginp(); vertexp; vertexp = vertexp->verticesNextp()) {
-        if (!vertexp->user()) orderDFSIterate(vertexp);
+    // Compute fanouts, on a snapshot of the graph in reverse topological order when acyclic
+    const V3GraphCsr csr{*this};
+    std::vector<uint32_t> order;
+    if (csr.topologicalOrder(order)) {
+        std::vector<double> fanouts(csr.size());
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const uint32_t i = *it;
+            double fanout = 0;
+            for (const uint32_t* itp = csr.outBegin(i); itp != csr.outEnd(i); ++itp) {
+                fanout += fanouts[*itp];
+            }
+            fanout += csr.inSize(i);
+            fanouts[i] = fanout;
+            csr.vertexp(i)->fanout(fanout);
+            csr.vertexp(i)->user(2);
+        }
+    } else {
+        // Vertex::m_user begin: 1 indicates processing, 2 indicates completed
+        userClearVertices();
+        for (V3GraphVertex* vertexp = verticesBeginp(); vertexp;
+             vertexp = vertexp->verticesNextp()) {
+            if (!vertexp->user()) orderDFSIterate(vertexp);
+        }
     }
 
     // Sort list of vertices by rank, then fanout. Fanout is a bit of a
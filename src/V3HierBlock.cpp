@@ -81,8 +81,12 @@
 #include "V3Stats.h"
 #include "V3String.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -199,10 +203,6 @@ string V3HierBlock::hierMk(bool withDir) const { return hierSomeFile(withDir, "V
 
 string V3HierBlock::hierLib(bool withDir) const { return hierSomeFile(withDir, "lib", ".a"); }
 
-string V3HierBlock::hierGenerated(bool withDir) const {
-    return hierWrapper(withDir) + ' ' + hierMk(withDir);
-}
-
 string V3HierBlock::vFileIfNecessary() const {
     string filename = V3Os::filenameRealPath(m_modp->fileline()->filename());
     for (const string& v : v3Global.opt.vFiles()) {
@@ -306,6 +306,178 @@ public:
     }
 };
 
+//######################################################################
+// Choose hierarchical blocks automatically with --hierarchical-auto
+//
+// Blocks are chosen bottom up. A module becomes a block when its instances, less any blocks
+// already chosen under it, are large enough to be worth a separate Verilation and C++ build,
+// while its ports are narrow enough to bound the runtime cost of the block boundary. Modules
+// that could not be hierarchical blocks (parameter overrides, inout or interface ports, timing
+// controls, or hierarchical references across their boundary) are never chosen.
+
+class HierBlockAutoSelect final {
+    // TYPES
+    struct ModInfo final {
+        std::vector<AstNodeModule*> m_cellps;  // Modules instantiated, once per instance
+        uint64_t m_nodes = 0;  // Nodes in this module alone
+        uint64_t m_size = 0;  // Nodes including instances, excluding those under blocks
+        uint64_t m_instances = 0;  // Instances of this module in the design
+        uint64_t m_portBits = 0;  // Total width of the ports
+        bool m_eligible = false;  // May be a hierarchical block
+        bool m_timing = false;  // Has timing controls, not allowed in a block
+    };
+
+    // CONSTANTS
+    static constexpr uint64_t MIN_NODES = 1000;  // Smallest block, in AstNodes
+    static constexpr uint64_t PORT_COST = 4;  // Port bits are at most block nodes / PORT_COST
+
+    // STATE
+    std::unordered_map<const AstNodeModule*, ModInfo> m_infos;  // Per module information
+    // Modules on either side of a hierarchical reference, nullptr if unresolved
+    std::vector<std::pair<const AstNodeModule*, const AstNodeModule*>> m_xrefs;
+    VDouble0 m_statBlocks;  // Blocks chosen
+
+    // METHODS
+    static uint64_t portBits(const AstVar* varp) {
+        if (const AstBasicDType* const basicp = VN_CAST(varp->childDTypep(), BasicDType)) {
+            const AstRange* const rangep = basicp->rangep();
+            if (!rangep) return basicp->keyword().width() ? basicp->keyword().width() : 32;
+            if (VN_IS(rangep->leftp(), Const) && VN_IS(rangep->rightp(), Const)) {
+                return rangep->elementsConst();
+            }
+        } else if (const int width = varp->width()) {
+            return width;
+        }
+        return 32;  // Width not known until V3Width, assume an int
+    }
+
+    void gather(AstNetlist* netlistp) {
+        std::unordered_map<const AstNode*, const AstNodeModule*> declModule;
+        for (AstNodeModule* modp = netlistp->modulesp(); modp;
+             modp = VN_AS(modp->nextp(), NodeModule)) {
+            ModInfo& info = m_infos[modp];
+            info.m_eligible = VN_IS(modp, Module) && !modp->isTop() && !modp->hierBlock()
+                              && !modp->recursiveClone();
+            modp->foreach([&](const AstNode* nodep) {
+                ++info.m_nodes;
+                if (const AstCell* const cellp = VN_CAST(nodep, Cell)) {
+                    if (cellp->modp()) info.m_cellps.push_back(cellp->modp());
+                } else if (const AstVar* const varp = VN_CAST(nodep, Var)) {
+                    declModule.emplace(varp, modp);
+                    if (varp->isIO()) info.m_portBits += portBits(varp);
+                    if (varp->isInoutish() || varp->isIfaceRef()
+                        || (varp->isGParam() && varp->overriddenParam())) {
+                        info.m_eligible = false;
+                    }
+                } else if (VN_IS(nodep, NodeFTask)) {
+                    declModule.emplace(nodep, modp);
+                } else if (VN_IS(nodep, Delay) || VN_IS(nodep, EventControl)
+                           || VN_IS(nodep, Wait)) {
+                    info.m_timing = true;
+                }
+            });
+        }
+        for (AstNodeModule* modp = netlistp->modulesp(); modp;
+             modp = VN_AS(modp->nextp(), NodeModule)) {
+            modp->foreach([&](const AstNode* nodep) {
+                const AstNode* targetp = nullptr;
+                if (const AstVarXRef* const refp = VN_CAST(nodep, VarXRef)) {
+                    targetp = refp->varp();
+                } else if (const AstNodeFTaskRef* const refp = VN_CAST(nodep, NodeFTaskRef)) {
+                    if (refp->dotted().empty()) return;
+                    targetp = refp->taskp();
+                } else {
+                    return;
+                }
+                const auto it = declModule.find(targetp);
+                const AstNodeModule* const targetModp
+                    = it == declModule.end() ? nullptr : it->second;
+                if (targetModp != modp) m_xrefs.emplace_back(modp, targetModp);
+            });
+        }
+    }
+
+    // Can the module be a block, with no timing controls under it, and no hierarchical
+    // references across its boundary?
+    bool blockable(const AstNodeModule* modp) {
+        std::unordered_set<const AstNodeModule*> under{modp};
+        std::vector<const AstNodeModule*> stack{modp};
+        while (!stack.empty()) {
+            const AstNodeModule* const currp = stack.back();
+            stack.pop_back();
+            for (const AstNodeModule* const childp : m_infos[currp].m_cellps) {
+                if (under.insert(childp).second) stack.push_back(childp);
+            }
+        }
+        for (const AstNodeModule* const underp : under) {
+            if (m_infos[underp].m_timing) return false;
+        }
+        for (const auto& pair : m_xrefs) {
+            if (!pair.second || under.count(pair.first) != under.count(pair.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit HierBlockAutoSelect(AstNetlist* netlistp) {
+        gather(netlistp);
+
+        // Modules by level, so parents are before their children
+        std::vector<AstNodeModule*> modps;
+        for (AstNodeModule* modp = netlistp->modulesp(); modp;
+             modp = VN_AS(modp->nextp(), NodeModule)) {
+            modps.push_back(modp);
+        }
+        std::stable_sort(modps.begin(), modps.end(),
+                         [](const AstNodeModule* ap, const AstNodeModule* bp) {
+                             return ap->level() < bp->level();
+                         });
+
+        // Count instances, and the size of the flattened design
+        uint64_t flatNodes = 0;
+        m_infos[netlistp->topModulep()].m_instances = 1;
+        for (const AstNodeModule* const modp : modps) {
+            const ModInfo& info = m_infos[modp];
+            flatNodes += info.m_nodes * info.m_instances;
+            for (const AstNodeModule* const childp : info.m_cellps) {
+                m_infos[childp].m_instances += info.m_instances;
+            }
+        }
+
+        // Aim for a few blocks per build job, so the blocks can be built in parallel
+        const int jobs = v3Global.opt.buildJobs() > 0
+                             ? v3Global.opt.buildJobs()
+                             : std::max(1U, std::thread::hardware_concurrency());
+        const uint64_t target = std::max(MIN_NODES, flatNodes / (2 * jobs));
+        UINFO(4, "Automatic hierarchical blocks of " << target << " nodes, from " << flatNodes
+                                                     << endl);
+
+        // Choose blocks bottom up
+        for (auto it = modps.rbegin(); it != modps.rend(); ++it) {
+            AstNodeModule* const modp = *it;
+            ModInfo& info = m_infos[modp];
+            info.m_size = info.m_nodes;
+            for (const AstNodeModule* const childp : info.m_cellps) {
+                if (!childp->hierBlock()) info.m_size += m_infos[childp].m_size;
+            }
+            if (!info.m_eligible || !info.m_instances) continue;
+            if (info.m_size < MIN_NODES || info.m_size * info.m_instances < target) continue;
+            if (info.m_portBits * PORT_COST > info.m_size) continue;
+            if (!blockable(modp)) continue;
+            UINFO(3, "Automatic hierarchical block " << modp->prettyNameQ() << " of "
+                                                     << info.m_size << " nodes, "
+                                                     << info.m_instances << " instances" << endl);
+            modp->hierBlock(true);
+            ++m_statBlocks;
+        }
+    }
+    ~HierBlockAutoSelect() {
+        V3Stats::addStat("HierBlock, Automatic hierarchical blocks", m_statBlocks);
+    }
+};
+
 //######################################################################
 
 void V3HierBlockPlan::add(const AstNodeModule* modp, const std::vector<AstVar*>& gparams) {
@@ -343,6 +515,8 @@ void V3HierBlockPlan::createPlan(AstNetlist* nodep) {
         modp->hierBlock(false);
     }
 
+    if (v3Global.opt.hierarchicalAuto()) HierBlockAutoSelect{nodep};
+
     std::unique_ptr<V3HierBlockPlan> planp(new V3HierBlockPlan);
     { HierBlockUsageCollectVisitor{planp.get(), nodep}; }
 
@@ -80,7 +80,6 @@ public:
     string hierWrapper(bool withDir) const;
     string hierMk(bool withDir) const;
     string hierLib(bool withDir) const;
-    string hierGenerated(bool withDir) const;
     // Returns the original HDL file if it is not included in v3Global.opt.vFiles().
     string vFileIfNecessary() const;
     // Write command line arguments to .f file for this hierarchical block
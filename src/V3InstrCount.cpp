@@ -21,8 +21,13 @@
 #include "V3InstrCount.h"
 
 #include "V3Ast.h"
+#include "V3File.h"
+#include "V3Global.h"
 
+#include <array>
+#include <cmath>
 #include <iomanip>
+#include <sstream>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
@@ -32,6 +37,53 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 /// we'll count instructions from either the 'if' or the 'else' branch,
 /// whichever is larger. We know we won't run both.
 
+class InstrCountScales final {
+    // MEMBERS
+    std::array<double, VNType::_ENUM_END> m_scales;  // Cost scale factor, by node type
+
+public:
+    // CONSTRUCTORS
+    InstrCountScales() {
+        m_scales.fill(1.0);
+        const string& filename = v3Global.opt.instrCountScales();
+        if (!filename.empty()) read(filename);
+    }
+
+    // METHODS
+    static const InstrCountScales& s() {
+        static const InstrCountScales s_scales;
+        return s_scales;
+    }
+    double scale(VNType type) const { return m_scales[type]; }
+
+private:
+    void read(const string& filename) {
+        // Each line is "<node type name> <scale>", as written by verilator_gantt
+        const std::unique_ptr<std::ifstream> ifp{V3File::new_ifstream(filename)};
+        if (ifp->fail()) v3fatal("Cannot open --instr-count-scales file: " << filename);
+        std::map<string, int> types;
+        for (int i = 0; i < VNType::_ENUM_END; ++i) types[VNType{i}.ascii()] = i;
+        string line;
+        while (std::getline(*ifp, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream is{line};
+            string name;
+            double scale = 0;
+            if (!(is >> name >> scale) || scale < 0) {
+                v3fatal("Malformed line in --instr-count-scales file " << filename << ": "
+                                                                       << line);
+            }
+            const auto it = types.find(name);
+            if (it == types.end()) {
+                v3warn(E_UNSUPPORTED, "Unknown node type in --instr-count-scales file "
+                                          << filename << ": " << name);
+                continue;
+            }
+            m_scales[it->second] = scale;
+        }
+    }
+};
+
 class InstrCountVisitor final : public VNVisitorConst {
 private:
     // NODE STATE
@@ -47,6 +99,7 @@ private:
     bool m_ignoreRemaining = false;  // Ignore remaining statements in the block
     const bool m_assertNoDups;  // Check for duplicates
     const std::ostream* const m_osp;  // Dump file
+    V3InstrCount::TypeCosts* const m_typeCostsp;  // Cost by node type, or nullptr
 
     // TYPES
     // Little class to cleanly call startVisitBase/endVisitBase
@@ -72,10 +125,12 @@ private:
 
 public:
     // CONSTRUCTORS
-    InstrCountVisitor(AstNode* nodep, bool assertNoDups, std::ostream* osp)
+    InstrCountVisitor(AstNode* nodep, bool assertNoDups, std::ostream* osp,
+                      V3InstrCount::TypeCosts* typeCostsp)
         : m_startNodep{nodep}
         , m_assertNoDups{assertNoDups}
-        , m_osp{osp} {
+        , m_osp{osp}
+        , m_typeCostsp{typeCostsp} {
         if (nodep) iterateConst(nodep);
     }
     ~InstrCountVisitor() override = default;
@@ -112,7 +167,7 @@ private:
         // debug prints to show local cost of each subtree, so we can see a
         // hierarchical view of the cost when in debug mode.
         const uint32_t savedCount = m_instrCount;
-        m_instrCount = nodep->instrCount();
+        m_instrCount = nodeCost(nodep);
         return savedCount;
     }
     void endVisitBase(uint32_t savedCount, AstNode* nodep) {
@@ -120,6 +175,14 @@ private:
         markCost(nodep);
         if (!m_ignoreRemaining) m_instrCount += savedCount;
     }
+    uint32_t nodeCost(AstNode* nodep) {
+        const int instrCount = nodep->instrCount();
+        const double scale = InstrCountScales::s().scale(nodep->type());
+        const uint32_t cost
+            = scale == 1.0 ? instrCount : static_cast<uint32_t>(std::lround(instrCount * scale));
+        if (m_typeCostsp && cost) (*m_typeCostsp)[nodep->typeName()] += cost;
+        return cost;
+    }
     void markCost(AstNode* nodep) {
         if (m_osp) nodep->user4(m_instrCount + 1);  // Else don't mark to avoid writeback
     }
@@ -331,8 +394,9 @@ private:
     VL_UNCOPYABLE(InstrCountDumpVisitor);
 };
 
-uint32_t V3InstrCount::count(AstNode* nodep, bool assertNoDups, std::ostream* osp) {
-    const InstrCountVisitor visitor{nodep, assertNoDups, osp};
+uint32_t V3InstrCount::count(AstNode* nodep, bool assertNoDups, std::ostream* osp,
+                             TypeCosts* typeCostsp) {
+    const InstrCountVisitor visitor{nodep, assertNoDups, osp, typeCostsp};
     if (osp) InstrCountDumpVisitor dumper{nodep, osp};
     return visitor.instrCount();
 }
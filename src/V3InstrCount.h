@@ -21,10 +21,17 @@
 #include "config_build.h"
 #include "verilatedos.h"
 
+#include <map>
+#include <string>
+
 class AstNode;
 
 class V3InstrCount final {
 public:
+    // Cost attributed to each AstNode type, by type name. Both sides of
+    // conditionals are included, so the sum may exceed the returned count.
+    using TypeCosts = std::map<std::string, uint64_t>;
+
     // Return the estimate count of instructions we'd incur while running
     // code in and under nodep.
     //
@@ -38,7 +45,12 @@ public:
     // if we see the same node twice (across more than one call to count,
     // potentially) raises an error.
     // Optional osp is stream to dump critical path to.
-    static uint32_t count(AstNode* nodep, bool assertNoDups, std::ostream* osp = nullptr);
+    // Optional typeCostsp is incremented by the cost of each node type.
+    //
+    // The cost of each node type is scaled by the factors read from the
+    // --instr-count-scales file, if any.
+    static uint32_t count(AstNode* nodep, bool assertNoDups, std::ostream* osp = nullptr,
+                          TypeCosts* typeCostsp = nullptr);
 };
 
 #endif  // guard
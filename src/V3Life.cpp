@@ -19,7 +19,10 @@
 //          ASSIGN(x,...), ASSIGN(x,...) => delete first one
 //          We also track across if statements:
 //          ASSIGN(X,...) IF( ..., ASSIGN(X,...), ASSIGN(X,...)) => deletes first
-//          We don't do the opposite yet though (remove assigns in if followed by outside if)
+//          And the opposite:
+//          IF( ..., ASSIGN(X,...)) ASSIGN(X,...) => deletes first
+//          As calls are followed into the called functions, this also deletes
+//          stores in one function of _eval that are overwritten by a later one.
 //
 //*************************************************************************
 
@@ -50,6 +53,7 @@ class LifeState final {
 public:
     VDouble0 m_statAssnDel;  // Statistic tracking
     VDouble0 m_statAssnCon;  // Statistic tracking
+    VDouble0 m_statAssnCondDel;  // Statistic tracking
     std::vector<AstNode*> m_unlinkps;
 
     // CONSTRUCTORS
@@ -57,6 +61,8 @@ public:
     ~LifeState() {
         V3Stats::addStatSum("Optimizations, Lifetime assign deletions", m_statAssnDel);
         V3Stats::addStatSum("Optimizations, Lifetime constant prop", m_statAssnCon);
+        V3Stats::addStatSum("Optimizations, Lifetime conditional assign deletions",
+                            m_statAssnCondDel);
         for (AstNode* ip : m_unlinkps) {
             ip->unlinkFrBack();
             ip->deleteTree();
@@ -72,6 +78,8 @@ public:
 class LifeVarEntry final {
     // Last assignment to this varscope, nullptr if no longer relevant
     AstNodeAssign* m_assignp = nullptr;
+    // Last assignments to this varscope in conditional blocks below, if no longer relevant
+    std::vector<AstNodeAssign*> m_condAssignps;
     AstConst* m_constp = nullptr;  // Known constant value
     // First access was a set (and thus block above may have a set that can be deleted
     bool m_setBeforeUse;
@@ -98,19 +106,26 @@ public:
     ~LifeVarEntry() = default;
     void simpleAssign(AstNodeAssign* assp) {  // New simple A=.... assignment
         m_assignp = assp;
+        m_condAssignps.clear();
         m_constp = nullptr;
         m_everSet = true;
         if (VN_IS(assp->rhsp(), Const)) m_constp = VN_AS(assp->rhsp(), Const);
     }
     void complexAssign() {  // A[x]=... or some complicated assignment
         m_assignp = nullptr;
+        m_condAssignps.clear();
         m_constp = nullptr;
         m_everSet = true;
     }
     void consumed() {  // Rvalue read of A
         m_assignp = nullptr;
+        m_condAssignps.clear();
+    }
+    void condAssign(AstNodeAssign* assp) {  // A=... in a conditional block, not yet read
+        m_condAssignps.push_back(assp);
     }
     AstNodeAssign* assignp() const { return m_assignp; }
+    const std::vector<AstNodeAssign*>& condAssignps() const { return m_condAssignps; }
     AstConst* constNodep() const { return m_constp; }
     bool setBeforeUse() const { return m_setBeforeUse; }
     bool everSet() const { return m_everSet; }
@@ -151,10 +166,17 @@ public:
                 // Don't delete it now as it will confuse iteration since it maybe WAY
                 // above our current iteration point.
                 if (debug() > 4) oldassp->dumpTree("-      REMOVE/SAMEBLK: ");
-                entp->complexAssign();
                 VL_DO_DANGLING(m_statep->pushUnlinkDeletep(oldassp), oldassp);
                 ++m_statep->m_statAssnDel;
             }
+            for (AstNodeAssign* const oldassp : entp->condAssignps()) {
+                // Redundant assignment, in conditional block above
+                UINFO(7, "       PREV COND: " << oldassp << endl);
+                if (debug() > 4) oldassp->dumpTree("-      REMOVE/CONDBLK: ");
+                m_statep->pushUnlinkDeletep(oldassp);
+                ++m_statep->m_statAssnCondDel;
+            }
+            entp->complexAssign();
         }
     }
     void simpleAssign(AstVarScope* nodep, AstNodeAssign* assp) {
@@ -220,12 +242,27 @@ public:
             m_map.emplace(nodep, LifeVarEntry{LifeVarEntry::CONSUMED{}});
         }
     }
-    void lifeToAbove() {
+    void condAssignFind(AstVarScope* nodep, AstNodeAssign* assp) {
+        const auto it = m_map.find(nodep);
+        UASSERT_OBJ(it != m_map.end(), nodep, "Should have been added by complexAssignFind");
+        it->second.condAssign(assp);
+    }
+    void lifeToAbove(bool keepAssigns) {
         // Any varrefs under a if/else branch affect statements outside and after the if/else
+        // If keepAssigns, assignments not read by the end of this block can still be deleted
+        // if overwritten after it. Not for loops, as the next iteration might read them.
         if (!m_aboveLifep) v3fatalSrc("Pushing life when already at the top level");
         for (auto& itr : m_map) {
             AstVarScope* const nodep = itr.first;
             m_aboveLifep->complexAssignFind(nodep);
+            if (keepAssigns) {
+                if (AstNodeAssign* const assp = itr.second.assignp()) {
+                    m_aboveLifep->condAssignFind(nodep, assp);
+                }
+                for (AstNodeAssign* const assp : itr.second.condAssignps()) {
+                    m_aboveLifep->condAssignFind(nodep, assp);
+                }
+            }
             if (itr.second.everSet()) {
                 // Record there may be an assignment, so we don't constant propagate across the if.
                 complexAssignFind(nodep);
@@ -365,8 +402,8 @@ private:
         // Find sets on both flows
         m_lifep->dualBranch(ifLifep, elseLifep);
         // For the next assignments, clear any variables that were read or written in the block
-        ifLifep->lifeToAbove();
-        elseLifep->lifeToAbove();
+        ifLifep->lifeToAbove(true);
+        elseLifep->lifeToAbove(true);
         VL_DO_DANGLING(delete ifLifep, ifLifep);
         VL_DO_DANGLING(delete elseLifep, elseLifep);
     }
@@ -395,8 +432,8 @@ private:
         m_lifep = prevLifep;
         UINFO(4, "   joinfor" << endl);
         // For the next assignments, clear any variables that were read or written in the block
-        condLifep->lifeToAbove();
-        bodyLifep->lifeToAbove();
+        condLifep->lifeToAbove(false);
+        bodyLifep->lifeToAbove(false);
         VL_DO_DANGLING(delete condLifep, condLifep);
         VL_DO_DANGLING(delete bodyLifep, bodyLifep);
     }
@@ -415,7 +452,7 @@ private:
         }
         UINFO(4, "   joinjump" << endl);
         // For the next assignments, clear any variables that were read or written in the block
-        bodyLifep->lifeToAbove();
+        bodyLifep->lifeToAbove(false);
         VL_DO_DANGLING(delete bodyLifep, bodyLifep);
     }
     void visit(AstNodeCCall* nodep) override {
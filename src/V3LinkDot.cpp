@@ -2184,9 +2184,8 @@ private:
                                AstClass* interfaceClassp) {
         UINFO(8, "importImplementsClass to " << implementsClassp << " from " << interfaceClassp
                                              << endl);
-        for (VSymEnt::const_iterator it = interfaceSymp->begin(); it != interfaceSymp->end();
-             ++it) {
-            if (AstNode* interfaceSubp = it->second->nodep()) {
+        for (const auto* const itp : interfaceSymp->sortedIds()) {
+            if (AstNode* interfaceSubp = itp->second->nodep()) {
                 UINFO(8, "  SymFunc " << interfaceSubp << endl);
                 if (VN_IS(interfaceSubp, NodeFTask)) {
                     const VSymEnt* const foundp = m_curSymp->findIdFlat(interfaceSubp->name());
@@ -3444,13 +3443,13 @@ private:
         // so add members pointing to appropriate enum values
         {
             nodep->repairCache();
-            for (VSymEnt::const_iterator it = m_curSymp->begin(); it != m_curSymp->end(); ++it) {
-                AstNode* const itemp = it->second->nodep();
-                if (!nodep->findMember(it->first)) {
+            for (const auto* const itp : m_curSymp->sortedIds()) {
+                AstNode* const itemp = itp->second->nodep();
+                if (!nodep->findMember(itp->first)) {
                     if (AstEnumItem* const aitemp = VN_CAST(itemp, EnumItem)) {
                         AstEnumItemRef* const newp = new AstEnumItemRef{
-                            aitemp->fileline(), aitemp, it->second->classOrPackagep()};
-                        UINFO(8, "Class import noderef '" << it->first << "' " << newp << endl);
+                            aitemp->fileline(), aitemp, itp->second->classOrPackagep()};
+                        UINFO(8, "Class import noderef '" << itp->first << "' " << newp << endl);
                         nodep->addMembersp(newp);
                     }
                 }
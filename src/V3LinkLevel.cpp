@@ -283,7 +283,10 @@ void V3LinkLevel::wrapTopCell(AstNetlist* rootp) {
                                          << varp->prettyNameQ());
                     }
                     if (varp->isIO() && v3Global.opt.systemC()) {
-                        varp->sc(true);
+                        // With --sc-sync-ports the model copies scalar ports from/to
+                        // SystemC once per eval, so the variable is plain C++
+                        varp->sc(!v3Global.opt.scSyncPorts() || varp->isInoutish()
+                                 || VN_IS(varp->dtypeSkipRefp(), UnpackArrayDType));
                         // User can see trace one level down from the wrapper
                         // Avoids packing & unpacking SC signals a second time
                         varp->trace(false);
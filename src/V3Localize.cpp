@@ -19,6 +19,11 @@
 //             if only referenced in one CFUNC, make it local
 //          VARSCOPE
 //             if non-public, always written before used, make it local
+//          VARSCOPE
+//             if non-public, only referenced in one CFUNC and leaf CFUNCs
+//             called only from it, and that CFUNC assigns it (itself or by
+//             an unconditional call) before anything reads it, make it local
+//             in that CFUNC, and pass it by reference to the callees
 //
 //*************************************************************************
 
@@ -32,6 +37,8 @@
 #include "V3Global.h"
 #include "V3Stats.h"
 
+#include <limits>
+#include <map>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -57,11 +64,28 @@ private:
     AstUser4Allocator<AstCFunc, std::unordered_multimap<const AstVarScope*, AstVarRef*>>
         m_references;
 
+    // TYPES
+    struct CallSite final {
+        AstCFunc* m_callerp;  // Calling function
+        AstCCall* m_callp;  // The call
+        uint32_t m_seq;  // Position of call in caller
+        bool m_uncond;  // Call is unconditional, at the top level of the caller
+    };
+    using SeqMap = std::map<std::pair<const AstCFunc*, const AstVarScope*>, uint32_t>;
+
     // STATE
     VDouble0 m_statLocVars;  // Statistic tracking
+    VDouble0 m_statLocArgs;  // Statistic tracking
     AstCFunc* m_cfuncp = nullptr;  // Current active function
     uint32_t m_nodeDepth = 0;  // Node depth under m_cfuncp
+    uint32_t m_seq = 0;  // Position of current node in m_cfuncp, in execution order
     std::vector<AstVarScope*> m_varScopeps;  // List of variables to consider for localization
+    // Position of first whole assignment of variable at top level of function
+    SeqMap m_writeSeqs;
+    // Position of first read of variable in function
+    SeqMap m_readSeqs;
+    std::unordered_map<const AstCFunc*, std::vector<CallSite>> m_callSites;  // Calls to function
+    std::unordered_set<const AstCFunc*> m_addressTaken;  // Functions called via pointers
 
     // METHODS
     bool isOptimizable(AstVarScope* nodep) {
@@ -77,18 +101,128 @@ private:
         return false;
     }
 
+    static string localName(const AstVarScope* nodep, const AstCFunc* funcp) {
+        return nodep->scopep() == funcp->scopep()
+                   ? nodep->varp()->name()
+                   : nodep->scopep()->nameDotless() + "__DOT__" + nodep->varp()->name();
+    }
+
+    void replaceReferences(AstCFunc* funcp, const AstVarScope* nodep, AstVar* newVarp) {
+        const auto er = m_references(funcp).equal_range(nodep);
+        for (auto it = er.first; it != er.second; ++it) {
+            AstVarRef* const refp = it->second;
+            refp->varScopep(nullptr);
+            refp->varp(newVarp);
+        }
+    }
+
+    static uint32_t seqOf(const SeqMap& seqs, const AstCFunc* funcp, const AstVarScope* nodep) {
+        const auto it = seqs.find({funcp, nodep});
+        return it == seqs.end() ? std::numeric_limits<uint32_t>::max() : it->second;
+    }
+    bool readsFirst(const AstCFunc* funcp, const AstVarScope* nodep) const {
+        return seqOf(m_readSeqs, funcp, nodep) < seqOf(m_writeSeqs, funcp, nodep);
+    }
+    bool writesFirst(const AstCFunc* funcp, const AstVarScope* nodep) const {
+        return seqOf(m_writeSeqs, funcp, nodep) < seqOf(m_readSeqs, funcp, nodep);
+    }
+
+    // Return the function that can own the value of the variable as a local, and pass it to
+    // the other referencing functions, or nullptr if none. The others must be leaf functions
+    // only called from the owner, and the owner must assign the variable, or call a function
+    // assigning it, unconditionally before anything reads it.
+    AstCFunc* findOwner(const AstVarScope* nodep, const std::unordered_set<AstCFunc*>& funcps) {
+        if (!VN_IS(nodep->varp()->dtypeSkipRefp(), BasicDType)) return nullptr;
+        AstCFunc* ownerp = nullptr;
+        for (AstCFunc* const funcp : funcps) {
+            if (funcp->isCoroutine()) return nullptr;
+            if (!funcp->user1()) continue;
+            if (ownerp) return nullptr;  // Multiple non-leaf functions
+            ownerp = funcp;
+        }
+        for (const AstCFunc* const funcp : funcps) {
+            if (funcp == ownerp) continue;
+            // Only change the signature of functions called directly, and not from outside
+            if (funcp->entryPoint() || funcp->funcPublic() || funcp->isVirtual()
+                || funcp->dpiExportImpl() || funcp->dpiImportWrapper() || funcp->isTrace()
+                || funcp->isConstructor() || funcp->isDestructor()
+                || m_addressTaken.count(funcp)) {
+                return nullptr;
+            }
+            const auto it = m_callSites.find(funcp);
+            if (it == m_callSites.end()) return nullptr;
+            for (const CallSite& site : it->second) {
+                if (!ownerp) ownerp = site.m_callerp;
+                if (site.m_callerp != ownerp) return nullptr;
+            }
+        }
+        if (!ownerp || ownerp->isCoroutine() || (funcps.size() == 1 && funcps.count(ownerp))) {
+            return nullptr;
+        }
+        // Find the first unconditional assignment
+        uint32_t defSeq = funcps.count(ownerp) && writesFirst(ownerp, nodep)
+                              ? seqOf(m_writeSeqs, ownerp, nodep)
+                              : std::numeric_limits<uint32_t>::max();
+        for (const AstCFunc* const funcp : funcps) {
+            if (funcp == ownerp || !writesFirst(funcp, nodep)) continue;
+            for (const CallSite& site : m_callSites[funcp]) {
+                if (site.m_uncond) defSeq = std::min(defSeq, site.m_seq);
+            }
+        }
+        if (defSeq == std::numeric_limits<uint32_t>::max()) return nullptr;
+        // Everything reading the old value must come after it
+        if (funcps.count(ownerp) && seqOf(m_readSeqs, ownerp, nodep) < defSeq) return nullptr;
+        for (const AstCFunc* const funcp : funcps) {
+            if (funcp == ownerp || !readsFirst(funcp, nodep)) continue;
+            for (const CallSite& site : m_callSites[funcp]) {
+                if (site.m_seq <= defSeq) return nullptr;
+            }
+        }
+        return ownerp;
+    }
+
+    void moveVarScopeToArgs(AstVarScope* nodep, AstCFunc* ownerp,
+                            const std::unordered_set<AstCFunc*>& funcps) {
+        UINFO(4, "Localizing into " << ownerp << " and callees " << nodep << endl);
+        ++m_statLocArgs;
+        pushDeletep(nodep->unlinkFrBack());
+        AstVar* const oldVarp = nodep->varp();
+        AstVar* const newVarp = new AstVar{oldVarp->fileline(), oldVarp->varType(),
+                                           localName(nodep, ownerp), oldVarp};
+        newVarp->funcLocal(true);
+        newVarp->noReset(oldVarp->noReset());
+        ownerp->addInitsp(newVarp);
+        replaceReferences(ownerp, nodep, newVarp);
+        for (AstCFunc* const funcp : funcps) {
+            if (funcp == ownerp) continue;
+            AstVar* const argp = new AstVar{oldVarp->fileline(), oldVarp->varType(),
+                                            localName(nodep, funcp), oldVarp};
+            argp->funcLocal(true);
+            argp->direction(VDirection::INOUT);
+            funcp->addArgsp(argp);
+            replaceReferences(funcp, nodep, argp);
+            for (const CallSite& site : m_callSites[funcp]) {
+                site.m_callp->addArgsp(
+                    new AstVarRef{site.m_callp->fileline(), newVarp, VAccess::READWRITE});
+            }
+        }
+    }
+
     void moveVarScopes() {
         for (AstVarScope* const nodep : m_varScopeps) {
-            if (!isOptimizable(nodep)) continue;  // Not optimizable
-
             const std::unordered_set<AstCFunc*>& funcps = m_accessors(nodep);
             if (funcps.empty()) continue;  // No referencing functions at all
 
-            // If more than one referencing function, but not all are leaf
-            // functions, then don't localize, as one of the referencing
-            // functions might be calling another, which the current analysis
-            // cannot cope with. This should be rare (introduced by V3Depth).
-            if (funcps.size() > 1 && existsNonLeaf(funcps)) continue;
+            // If not written before read in every referencing function, or more than one
+            // referencing function, but not all are leaf functions, then one of the
+            // referencing functions might be calling another. Localize only if that caller
+            // owns the value, and pass it to its callees.
+            if (!isOptimizable(nodep) || (funcps.size() > 1 && existsNonLeaf(funcps))) {
+                if (AstCFunc* const ownerp = findOwner(nodep, funcps)) {
+                    moveVarScopeToArgs(nodep, ownerp, funcps);
+                }
+                continue;
+            }
 
             UINFO(4, "Localizing " << nodep << endl);
             ++m_statLocVars;
@@ -101,23 +235,14 @@ private:
             AstVar* const oldVarp = nodep->varp();
             for (AstCFunc* const funcp : funcps) {
                 // Create the new local variable.
-                const string newName
-                    = nodep->scopep() == funcp->scopep()
-                          ? oldVarp->name()
-                          : nodep->scopep()->nameDotless() + "__DOT__" + oldVarp->name();
-                AstVar* const newVarp
-                    = new AstVar{oldVarp->fileline(), oldVarp->varType(), newName, oldVarp};
+                AstVar* const newVarp = new AstVar{oldVarp->fileline(), oldVarp->varType(),
+                                                   localName(nodep, funcp), oldVarp};
                 newVarp->funcLocal(true);
                 newVarp->noReset(oldVarp->noReset());
                 funcp->addInitsp(newVarp);
 
                 // Fix up all the references within this function
-                const auto er = m_references(funcp).equal_range(nodep);
-                for (auto it = er.first; it != er.second; ++it) {
-                    AstVarRef* const refp = it->second;
-                    refp->varScopep(nullptr);
-                    refp->varp(newVarp);
-                }
+                replaceReferences(funcp, nodep, newVarp);
             }
         }
         m_varScopeps.clear();
@@ -136,6 +261,7 @@ private:
         {
             m_cfuncp = nodep;
             m_nodeDepth = 0;
+            m_seq = 0;
             const VNUser2InUse user2InUse;
             iterateChildrenConst(nodep);
         }
@@ -144,8 +270,12 @@ private:
     void visit(AstCCall* nodep) override {
         m_cfuncp->user1(true);  // Mark caller as not a leaf function
         iterateChildrenConst(nodep);
+        const bool uncond = m_nodeDepth == 1 && VN_IS(nodep->backp(), StmtExpr);
+        m_callSites[nodep->funcp()].push_back({m_cfuncp, nodep, ++m_seq, uncond});
     }
 
+    void visit(AstAddrOfCFunc* nodep) override { m_addressTaken.emplace(nodep->funcp()); }
+
     void visit(AstNodeAssign* nodep) override {
         // Analyze RHS first so "a = a + 1" is detected as a read before write
         iterate(nodep->rhsp());
@@ -157,6 +287,9 @@ private:
             // variable (and in particular, it is not assigned only in part).
             if (const AstVarRef* const refp = VN_CAST(nodep->lhsp(), VarRef)) {
                 // Mark this VarScope as assigned in this function
+                if (!refp->varScopep()->user2()) {
+                    m_writeSeqs.emplace(std::make_pair(m_cfuncp, refp->varScopep()), ++m_seq);
+                }
                 refp->varScopep()->user2(1);
             }
         }
@@ -200,6 +333,10 @@ private:
                 varScopep->user1(1);
             }
         }
+        // Also record per function, for localizing across calls
+        if (nodep->access().isReadOrRW()) {
+            m_readSeqs.emplace(std::make_pair(m_cfuncp, varScopep), ++m_seq);
+        }
         // No iterate; Don't want varrefs under it  (e.g.: in child dtype?)
     }
 
@@ -214,6 +351,7 @@ public:
     explicit LocalizeVisitor(AstNetlist* nodep) { iterate(nodep); }
     ~LocalizeVisitor() override {
         V3Stats::addStat("Optimizations, Vars localized", m_statLocVars);
+        V3Stats::addStat("Optimizations, Vars localized into arguments", m_statLocArgs);
     }
 };
 
@@ -42,6 +42,12 @@
 //
 //  Also merges consecutive AstNodeIf statements with the same condition.
 //
+//  Merging trades a conditional select per assignment, which the C compiler
+//  turns into branch free conditional moves, for one branch. If the condition
+//  is data dependent, that branch is often mispredicted, so short lists of
+//  cheap assignments are left as selects when a simple cost model says the
+//  expected misprediction penalty outweighs evaluating both sides.
+//
 //  Because this optimization has notable performance impact, we go further
 //  and perform code motion to try to move mergeable conditionals next to each
 //  other, which in turn enable us to merge more conditionals. To do this, we
@@ -82,6 +88,7 @@
 #include "V3DupFinder.h"
 #include "V3Global.h"
 #include "V3Hasher.h"
+#include "V3InstrCount.h"
 #include "V3Stats.h"
 
 #include <queue>
@@ -91,6 +98,12 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 
 namespace {
 
+// Expected cost of a branch on a data dependent condition, in instructions. This assumes half
+// of such branches are mispredicted, at a penalty of about 20 instructions.
+constexpr uint32_t MERGE_COND_BRANCH_COST = 10;
+// Maximum number of assignments to consider leaving as conditional selects
+constexpr uint32_t MERGE_COND_BRANCHLESS_MAX_ITEMS = 4;
+
 //######################################################################
 // Utilities
 
@@ -210,15 +223,14 @@ class CodeMotionAnalysisVisitor final : public VNVisitorConst {
                 // Grab the duplicate finder of this list
                 V3DupFinder& dupFinder = m_stack.back();
                 // Find a duplicate condition
-                const V3DupFinder::iterator& dit = dupFinder.findDuplicate(condp);
-                if (dit == dupFinder.end()) {
+                AstNode* const firstp = dupFinder.findDuplicate(condp);
+                if (!firstp) {
                     // First time seeing this condition in the current list
                     dupFinder.insert(condp);
                     // Remember last statement with this condition (which is this statement)
                     condp->user5p(nodep);
                 } else {
                     // Seen a conditional with the same condition earlier in the current list
-                    AstNode* const firstp = dit->second;
                     // Add to properties for easy retrieval during optimization
                     m_propsp->m_prevWithSameCondp = static_cast<AstNodeStmt*>(firstp->user5p());
                     // Remember last statement with this condition (which is this statement)
@@ -445,6 +457,7 @@ private:
     VDouble0 m_statMerges;  // Statistic tracking
     VDouble0 m_statMergedItems;  // Statistic tracking
     VDouble0 m_statLongestList;  // Statistic tracking
+    VDouble0 m_statBranchless;  // Statistic tracking
 
     AstNode* m_mgFirstp = nullptr;  // First node in merged sequence
     AstNodeExpr* m_mgCondp = nullptr;  // The condition of the first node
@@ -623,6 +636,36 @@ private:
         // LCOV_EXCL_STOP
     }
 
+    // Decide if the list is better left as conditional selects, which the C++ compiler turns
+    // into branch free code, than merged under an 'if', which might be mispredicted.
+    bool preferBranchless() const {
+        const uint32_t condCost = V3InstrCount::count(m_mgCondp, false);
+        uint32_t items = 0;
+        uint32_t selectCost = condCost;  // Cost if all selects evaluate both sides
+        uint32_t branchCost = condCost + MERGE_COND_BRANCH_COST;  // Cost if merged
+        for (AstNode* nodep = m_mgFirstp;; nodep = nodep->nextp()) {
+            if (!VN_IS(nodep, Comment)) {
+                // Other statements need the branch
+                const AstNodeAssign* const assignp = VN_CAST(nodep, NodeAssign);
+                if (!assignp || assignp->isWide()) return false;
+                if (++items > MERGE_COND_BRANCHLESS_MAX_ITEMS) return false;
+                if (const AstNodeCond* const condp = extractCondFromRhs(assignp->rhsp())) {
+                    const uint32_t thenCost = V3InstrCount::count(condp->thenp(), false);
+                    const uint32_t elseCost = V3InstrCount::count(condp->elsep(), false);
+                    selectCost += thenCost + elseCost + 1;
+                    branchCost += std::max(thenCost, elseCost);
+                } else {
+                    // Reduced forms and cheap assignments cost about the same either way
+                    const uint32_t cost = V3InstrCount::count(assignp->rhsp(), false);
+                    selectCost += cost;
+                    branchCost += cost;
+                }
+            }
+            if (nodep == m_mgLastp) break;
+        }
+        return selectCost < branchCost;
+    }
+
     void mergeEnd() {
         UASSERT(m_mgFirstp, "mergeEnd without list");
         // Drop leading cheap nodes. These were only added in the hope of finding
@@ -646,8 +689,12 @@ private:
         // If the list contains a single AstNodeIf, we will want to merge its branches.
         // If so, keep hold of the AstNodeIf in this variable.
         AstNodeIf* recursivep = nullptr;
-        // Merge if list is longer than one node
-        if (m_mgFirstp != m_mgLastp) {
+        // Merge if list is longer than one node, and not better without branches
+        if (m_mgFirstp != m_mgLastp && v3Global.opt.fMergeCondBranchless()
+            && preferBranchless()) {
+            UINFO(6, "MergeCond - Branchless: " << m_mgFirstp << endl);
+            ++m_statBranchless;
+        } else if (m_mgFirstp != m_mgLastp) {
             UINFO(6, "MergeCond - First: " << m_mgFirstp << " Last: " << m_mgLastp << endl);
             ++m_statMerges;
             if (m_listLenght > m_statLongestList) m_statLongestList = m_listLenght;
@@ -877,6 +924,7 @@ public:
         V3Stats::addStat("Optimizations, MergeCond merges", m_statMerges);
         V3Stats::addStat("Optimizations, MergeCond merged items", m_statMergedItems);
         V3Stats::addStat("Optimizations, MergeCond longest merge", m_statLongestList);
+        V3Stats::addStat("Optimizations, MergeCond left branchless", m_statBranchless);
     }
 };
 
@@ -0,0 +1,96 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Arena allocator for AST and DFG objects
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+//
+// Passes create and delete very large numbers of small objects (AstNode,
+// DfgVertex, DfgEdge arrays). Instead of calling malloc/free for each, this
+// allocator bumps a pointer through large chunks, and keeps freed objects on
+// a free list per size class, to be reused by the next allocation of the
+// same size. Chunks are never returned to the system.
+//
+// Each thread has its own arena so no locking is needed. An object freed by
+// a thread other than the one that allocated it is simply reused by the
+// freeing thread.
+//
+//*************************************************************************
+
+#ifndef VERILATOR_V3NODEALLOC_H_
+#define VERILATOR_V3NODEALLOC_H_
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include <cstddef>
+#include <new>
+
+//============================================================================
+
+class V3NodeAlloc final {
+    // CONSTANTS
+    static constexpr size_t ALIGNMENT = 16;  // Alignment (and granularity) of all allocations
+    static constexpr size_t MAX_SIZE = 512;  // Larger objects use the global operator new
+    static constexpr size_t CHUNK_SIZE = 1024 * 1024;  // Bytes taken from the system at once
+
+    // TYPES
+    struct FreeItem final {
+        FreeItem* m_nextp;  // Next free object of the same size class
+    };
+    struct Arena final {
+        FreeItem* m_freeps[MAX_SIZE / ALIGNMENT + 1] = {};  // Free list per size class
+        char* m_bumpp = nullptr;  // Next unused byte of current chunk
+        char* m_endp = nullptr;  // End of current chunk
+    };
+
+    // METHODS
+    static Arena& arena() VL_MT_SAFE {
+        static thread_local Arena s_arena;
+        return s_arena;
+    }
+    static size_t sizeClass(size_t size) { return (size + ALIGNMENT - 1) / ALIGNMENT; }
+
+public:
+    static void* allocate(size_t size) VL_MT_SAFE {
+        if (VL_UNLIKELY(size > MAX_SIZE)) return ::operator new(size);
+        Arena& arena = V3NodeAlloc::arena();
+        const size_t sc = sizeClass(size);
+        if (FreeItem* const itemp = arena.m_freeps[sc]) {
+            arena.m_freeps[sc] = itemp->m_nextp;
+            return itemp;
+        }
+        const size_t bytes = sc * ALIGNMENT;
+        if (VL_UNLIKELY(static_cast<size_t>(arena.m_endp - arena.m_bumpp) < bytes)) {
+            // The (less than MAX_SIZE) tail of the previous chunk is abandoned
+            arena.m_bumpp = static_cast<char*>(::operator new(CHUNK_SIZE));
+            arena.m_endp = arena.m_bumpp + CHUNK_SIZE;
+        }
+        void* const resultp = arena.m_bumpp;
+        arena.m_bumpp += bytes;
+        return resultp;
+    }
+    static void deallocate(void* objp, size_t size) VL_MT_SAFE {
+        if (!objp) return;
+        if (VL_UNLIKELY(size > MAX_SIZE)) {
+            ::operator delete(objp);
+            return;
+        }
+        Arena& arena = V3NodeAlloc::arena();
+        const size_t sc = sizeClass(size);
+        FreeItem* const itemp = static_cast<FreeItem*>(objp);
+        itemp->m_nextp = arena.m_freeps[sc];
+        arena.m_freeps[sc] = itemp;
+    }
+};
+
+#endif  // Guard
@@ -1329,6 +1329,15 @@ V3Number& V3Number::opNot(const V3Number& lhs) {
     NUM_ASSERT_OP_ARGS1(lhs);
     NUM_ASSERT_LOGIC_ARGS1(lhs);
     // op i, L(lhs) bit return
+    if (lhs.width() == width()) {  // Fast path, a word at a time
+        for (int i = 0; i < words(); i++) {
+            const ValueAndX l = lhs.m_data.num()[i];
+            const uint32_t xz = l.m_valueX;
+            m_data.num()[i] = {~l.m_value | xz, xz};
+        }
+        opCleanThis();
+        return *this;
+    }
     setZero();
     for (int bit = 0; bit < width(); bit++) {
         if (lhs.bitIs0(bit)) {
@@ -1344,6 +1353,18 @@ V3Number& V3Number::opAnd(const V3Number& lhs, const V3Number& rhs) {
     NUM_ASSERT_OP_ARGS2(lhs, rhs);
     NUM_ASSERT_LOGIC_ARGS2(lhs, rhs);
     // i op j, max(L(lhs),L(rhs)) bit return, careful need to X/Z extend.
+    if (lhs.width() == width() && rhs.width() == width()) {  // Fast path, a word at a time
+        for (int i = 0; i < words(); i++) {
+            const ValueAndX l = lhs.m_data.num()[i];
+            const ValueAndX r = rhs.m_data.num()[i];
+            const uint32_t ones = (l.m_value & ~l.m_valueX) & (r.m_value & ~r.m_valueX);
+            const uint32_t zeros = (~l.m_value & ~l.m_valueX) | (~r.m_value & ~r.m_valueX);
+            const uint32_t xs = ~(ones | zeros);
+            m_data.num()[i] = {ones | xs, xs};
+        }
+        opCleanThis();
+        return *this;
+    }
     setZero();
     for (int bit = 0; bit < width(); bit++) {
         if (lhs.bitIs1(bit) && rhs.bitIs1(bit)) {
@@ -1360,6 +1381,18 @@ V3Number& V3Number::opOr(const V3Number& lhs, const V3Number& rhs) {
     NUM_ASSERT_OP_ARGS2(lhs, rhs);
     NUM_ASSERT_LOGIC_ARGS2(lhs, rhs);
     // i op j, max(L(lhs),L(rhs)) bit return, careful need to X/Z extend.
+    if (lhs.width() == width() && rhs.width() == width()) {  // Fast path, a word at a time
+        for (int i = 0; i < words(); i++) {
+            const ValueAndX l = lhs.m_data.num()[i];
+            const ValueAndX r = rhs.m_data.num()[i];
+            const uint32_t ones = (l.m_value & ~l.m_valueX) | (r.m_value & ~r.m_valueX);
+            const uint32_t zeros = (~l.m_value & ~l.m_valueX) & (~r.m_value & ~r.m_valueX);
+            const uint32_t xs = ~(ones | zeros);
+            m_data.num()[i] = {ones | xs, xs};
+        }
+        opCleanThis();
+        return *this;
+    }
     setZero();
     for (int bit = 0; bit < width(); bit++) {
         if (lhs.bitIs1(bit) || rhs.bitIs1(bit)) {
@@ -1377,6 +1410,16 @@ V3Number& V3Number::opXor(const V3Number& lhs, const V3Number& rhs) {
     // i op j, max(L(lhs),L(rhs)) bit return, careful need to X/Z extend.
     NUM_ASSERT_OP_ARGS2(lhs, rhs);
     NUM_ASSERT_LOGIC_ARGS2(lhs, rhs);
+    if (lhs.width() == width() && rhs.width() == width()) {  // Fast path, a word at a time
+        for (int i = 0; i < words(); i++) {
+            const ValueAndX l = lhs.m_data.num()[i];
+            const ValueAndX r = rhs.m_data.num()[i];
+            const uint32_t xs = l.m_valueX | r.m_valueX;
+            m_data.num()[i] = {(l.m_value ^ r.m_value) | xs, xs};
+        }
+        opCleanThis();
+        return *this;
+    }
     setZero();
     for (int bit = 0; bit < width(); bit++) {
         if (lhs.bitIs1(bit) && rhs.bitIs0(bit)) {
@@ -1618,6 +1661,13 @@ V3Number& V3Number::opEq(const V3Number& lhs, const V3Number& rhs) {
     NUM_ASSERT_OP_ARGS2(lhs, rhs);
     if (lhs.isString()) return opEqN(lhs, rhs);
     if (lhs.isDouble()) return opEqD(lhs, rhs);
+    if (lhs.width() == rhs.width() && !lhs.isFourState() && !rhs.isFourState()) {
+        // Fast path, a word at a time
+        for (int i = 0; i < lhs.words(); i++) {
+            if (lhs.wordValue(i) != rhs.wordValue(i)) return setSingleBits(0);
+        }
+        return setSingleBits(1);
+    }
     char outc = 1;
     for (int bit = 0; bit < std::max(lhs.width(), rhs.width()); bit++) {
         if (lhs.bitIs1(bit) && rhs.bitIs0(bit)) {
@@ -1640,6 +1690,13 @@ V3Number& V3Number::opNeq(const V3Number& lhs, const V3Number& rhs) {
     NUM_ASSERT_OP_ARGS2(lhs, rhs);
     if (lhs.isString()) return opNeqN(lhs, rhs);
     if (lhs.isDouble()) return opNeqD(lhs, rhs);
+    if (lhs.width() == rhs.width() && !lhs.isFourState() && !rhs.isFourState()) {
+        // Fast path, a word at a time
+        for (int i = 0; i < lhs.words(); i++) {
+            if (lhs.wordValue(i) != rhs.wordValue(i)) return setSingleBits(1);
+        }
+        return setSingleBits(0);
+    }
     char outc = 0;
     for (int bit = 0; bit < std::max(lhs.width(), rhs.width()); bit++) {
         if (lhs.bitIs1(bit) && rhs.bitIs0(bit)) {
@@ -1795,6 +1852,10 @@ V3Number& V3Number::opShiftR(const V3Number& lhs, const V3Number& rhs) {
         if (rhs.bitIs1(bit)) return *this;  // shift of over 2^32 must be zero
     }
     const uint32_t rhsval = rhs.toUInt();
+    if (lhs.width() <= 64 && !lhs.isFourState()) {  // Fast path
+        if (rhsval < 64) setQuad(lhs.toUQuad() >> rhsval);
+        return *this;
+    }
     if (rhsval < static_cast<uint32_t>(lhs.width())) {
         for (int bit = 0; bit < width(); bit++) setBit(bit, lhs.bitIs(bit + rhsval));
     }
@@ -1839,6 +1900,10 @@ V3Number& V3Number::opShiftL(const V3Number& lhs, const V3Number& rhs) {
         if (rhs.bitIs1(bit)) return *this;  // shift of over 2^32 must be zero
     }
     const uint32_t rhsval = rhs.toUInt();
+    if (width() <= 64 && lhs.width() <= 64 && !lhs.isFourState()) {  // Fast path
+        if (rhsval < 64) setQuad(lhs.toUQuad() << rhsval);
+        return *this;
+    }
     for (int bit = 0; bit < width(); bit++) {
         if (bit >= static_cast<int>(rhsval)) setBit(bit, lhs.bitIs(bit - rhsval));
     }
@@ -1865,13 +1930,14 @@ V3Number& V3Number::opAdd(const V3Number& lhs, const V3Number& rhs) {
     NUM_ASSERT_LOGIC_ARGS2(lhs, rhs);
     if (lhs.isFourState() || rhs.isFourState()) return setAllBitsX();
     setZero();
-    // Addem
-    int carry = 0;
-    for (int bit = 0; bit < width(); bit++) {
-        const int sum = ((lhs.bitIs1(bit) ? 1 : 0) + (rhs.bitIs1(bit) ? 1 : 0) + carry);
-        if (sum & 1) setBit(bit, 1);
-        carry = (sum >= 2);
+    // Addem, a word at a time
+    uint64_t carry = 0;
+    for (int i = 0; i < words(); i++) {
+        carry += static_cast<uint64_t>(lhs.wordValue(i)) + rhs.wordValue(i);
+        m_data.num()[i].m_value = static_cast<uint32_t>(carry);
+        carry >>= 32ULL;
     }
+    opCleanThis();
     return *this;
 }
 V3Number& V3Number::opSub(const V3Number& lhs, const V3Number& rhs) {
@@ -1879,6 +1945,17 @@ V3Number& V3Number::opSub(const V3Number& lhs, const V3Number& rhs) {
     NUM_ASSERT_OP_ARGS2(lhs, rhs);
     NUM_ASSERT_LOGIC_ARGS2(lhs, rhs);
     if (lhs.isFourState() || rhs.isFourState()) return setAllBitsX();
+    if (rhs.width() == width()) {  // Fast path, subtract a word at a time
+        uint64_t borrow = 0;
+        for (int i = 0; i < words(); i++) {
+            const uint64_t diff = static_cast<uint64_t>(lhs.wordValue(i)) - rhs.wordValue(i)
+                                  - borrow;
+            m_data.num()[i] = {static_cast<uint32_t>(diff), 0};
+            borrow = (diff >> 63ULL) & 1;
+        }
+        opCleanThis();
+        return *this;
+    }
     V3Number negrhs(&rhs, rhs.width());
     negrhs.opNegate(rhs);
     return opAdd(lhs, negrhs);
@@ -464,6 +464,12 @@ private:
 
     int words() const VL_MT_SAFE { return ((width() + 31) / 32); }
     uint32_t hiWordMask() const VL_MT_SAFE { return VL_MASK_I(width()); }
+    // Value bits of word 'i', zero above width(); for word-at-a-time 2-state operations
+    uint32_t wordValue(int i) const VL_MT_SAFE {
+        if (i >= words()) return 0;
+        const uint32_t value = m_data.num()[i].m_value;
+        return i == words() - 1 ? value & hiWordMask() : value;
+    }
 
     V3Number& opModDivGuts(const V3Number& lhs, const V3Number& rhs, bool is_modulus);
 
@@ -49,6 +49,7 @@
 #include <thread>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include "config_rev.h"
 
@@ -65,7 +66,7 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 class V3OptionsImp final {
 public:
     // TYPES
-    using DirMap = std::map<const string, std::set<std::string>>;  // Directory listing
+    using DirMap = std::unordered_map<string, V3Os::DirListing>;  // Directory listings
 
     // STATE
     std::list<string> m_allArgs;  // List of every argument encountered
@@ -475,40 +476,28 @@ void V3Options::fileNfsFlush(const string& filename) {
 string V3Options::fileExists(const string& filename) {
     // Surprisingly, for VCS and other simulators, this process
     // is quite slow; presumably because of re-reading each directory
-    // many times.  So we read a whole dir at once and cache it
+    // many times.  So we read a whole dir at once and cache it, and
+    // only stat entries the listing could not classify
 
     const string dir = V3Os::filenameDir(filename);
     const string basename = V3Os::filenameNonDir(filename);
 
     auto diriter = m_impp->m_dirMap.find(dir);
     if (diriter == m_impp->m_dirMap.end()) {
-        // Read the listing
-        m_impp->m_dirMap.emplace(dir, std::set<string>());
-        diriter = m_impp->m_dirMap.find(dir);
-
-        std::set<string>* setp = &(diriter->second);
-
-#ifdef _MSC_VER
-        try {
-            for (const auto& dirEntry : std::filesystem::directory_iterator(dir.c_str()))
-                setp->insert(dirEntry.path().filename().string());
-        } catch (std::filesystem::filesystem_error const& ex) { return ""; }
-#else
-        if (DIR* const dirp = opendir(dir.c_str())) {
-            while (struct dirent* direntp = readdir(dirp)) setp->insert(direntp->d_name);
-            closedir(dirp);
-        }
-#endif
+        diriter = m_impp->m_dirMap.emplace(dir, V3Os::dirListing(dir)).first;
     }
     // Find it
-    const std::set<string>* filesetp = &(diriter->second);
-    const auto fileiter = filesetp->find(basename);
-    if (fileiter == filesetp->end()) {
+    const auto fileiter = diriter->second.find(basename);
+    if (fileiter == diriter->second.end()) {
         return "";  // Not found
     }
     // Check if it is a directory, ignore if so
     string filenameOut = V3Os::filenameFromDirBase(dir, basename);
-    if (!fileStatNormal(filenameOut)) return "";  // Directory
+    if (fileiter->second == V3Os::DirEntryType::UNKNOWN) {
+        fileiter->second = fileStatNormal(filenameOut) ? V3Os::DirEntryType::NORMAL
+                                                       : V3Os::DirEntryType::DIRECTORY;
+    }
+    if (fileiter->second != V3Os::DirEntryType::NORMAL) return "";  // Directory
     return filenameOut;
 }
 
@@ -536,7 +525,8 @@ int V3Options::stripOptionsForChildRun(const string& opt, bool forTop) {
         return 2;
     }
     if (opt == "build" || (!forTop && (opt == "cc" || opt == "exe" || opt == "sc"))
-        || opt == "hierarchical" || (opt.length() > 2 && opt.substr(0, 2) == "G=")) {
+        || opt == "hierarchical" || opt == "hierarchical-auto"
+        || (opt.length() > 2 && opt.substr(0, 2) == "G=")) {
         return 1;
     }
     return 0;
@@ -851,11 +841,24 @@ void V3Options::notify() {
     }
 
     if (trace()) {
-        // With --trace-fst, --trace-threads implies --threads 1 unless explicitly specified
-        if (traceFormat().fst() && traceThreads() && !threads()) m_threads = 1;
+        // With --trace-fst or --trace, --trace-threads implies --threads 1 unless explicitly
+        // specified
+        if ((traceFormat().fst() || traceFormat().vcd()) && traceThreads() && !threads()) {
+            m_threads = 1;
+        }
 
-        // With --trace, --trace-threads is ignored
-        if (traceFormat().vcd()) m_traceThreads = threads() ? 1 : 0;
+        // With --trace, the VCD text is rendered by at least --threads threads
+        if (traceFormat().vcd()) m_traceThreads = std::max(m_traceThreads, threads() ? 1 : 0);
+
+        // VBT compresses on its own worker threads, --trace-threads is ignored
+        if (traceFormat().vbt()) {
+            m_traceThreads = 0;
+            if (systemC()) {
+                cmdfl->v3warn(E_UNSUPPORTED, "Unsupported: --trace-vbt with --sc\n"
+                                                 + cmdfl->warnMore()
+                                                 + "... Suggest use --trace or --trace-fst.");
+            }
+        }
     }
 
     UASSERT(!(useTraceParallel() && useTraceOffload()),
@@ -1069,6 +1072,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-assert", OnOff, &m_assert);
     DECL_OPTION("-autoflush", OnOff, &m_autoflush);
 
+    DECL_OPTION("-batch-instances", CbVal, [this, fl](const char* valp) {
+        m_batchInstances = std::atoi(valp);
+        if (m_batchInstances < 1) fl->v3fatal("--batch-instances must be >= 1: " << valp);
+    });
     DECL_OPTION("-bbox-sys", OnOff, &m_bboxSys);
     DECL_OPTION("-bbox-unsup", CbOnOff, [this](bool flag) {
         m_bboxUnsup = flag;
@@ -1127,6 +1134,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-converge-limit", Set, &m_convergeLimit);
     DECL_OPTION("-coverage-line", OnOff, &m_coverageLine);
     DECL_OPTION("-coverage-max-width", Set, &m_coverageMaxWidth);
+    DECL_OPTION("-coverage-per-thread", OnOff, &m_coveragePerThread);
     DECL_OPTION("-coverage-toggle", OnOff, &m_coverageToggle);
     DECL_OPTION("-coverage-underscore", OnOff, &m_coverageUnderscore);
     DECL_OPTION("-coverage-user", OnOff, &m_coverageUser);
@@ -1169,6 +1177,13 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-exe", OnOff, &m_exe);
     DECL_OPTION("-expand-limit", CbVal,
                 [this](const char* valp) { m_expandLimit = std::atoi(valp); });
+    DECL_OPTION("-expand-simd-width", CbVal, [this, fl](const char* valp) {
+        m_expandSimdWidth = std::atoi(valp);
+        if (m_expandSimdWidth != 0 && m_expandSimdWidth != 128 && m_expandSimdWidth != 256
+            && m_expandSimdWidth != 512) {
+            fl->v3fatal("--expand-simd-width must be 0, 128, 256 or 512: " << valp);
+        }
+    });
 
     DECL_OPTION("-F", CbVal, [this, fl, &optdir](const char* valp) {
         parseOptsFile(fl, parseFileArg(optdir, valp), true);
@@ -1184,15 +1199,19 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 
     DECL_OPTION("-facyc-simp", FOnOff, &m_fAcycSimp);
     DECL_OPTION("-fassemble", FOnOff, &m_fAssemble);
+    DECL_OPTION("-fassoc-hash", FOnOff, &m_fAssocHash);
     DECL_OPTION("-fcase", FOnOff, &m_fCase);
+    DECL_OPTION("-fclock-gate", FOnOff, &m_fClockGate);
     DECL_OPTION("-fcombine", FOnOff, &m_fCombine);
     DECL_OPTION("-fconst", FOnOff, &m_fConst);
     DECL_OPTION("-fconst-before-dfg", FOnOff, &m_fConstBeforeDfg);
     DECL_OPTION("-fconst-bit-op-tree", FOnOff, &m_fConstBitOpTree);
+    DECL_OPTION("-fcse", FOnOff, &m_fCse);
     DECL_OPTION("-fdedup", FOnOff, &m_fDedupe);
     DECL_OPTION("-fdfg", CbFOnOff, [this](bool flag) {
         m_fDfgPreInline = flag;
         m_fDfgPostInline = flag;
+        if (!flag) m_fDfgScoped = false;
     });
     DECL_OPTION("-fdfg-peephole", FOnOff, &m_fDfgPeephole);
     DECL_OPTION("-fdfg-peephole-", CbPartialMatch, [this](const char* optp) {  //
@@ -1203,6 +1222,8 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     });
     DECL_OPTION("-fdfg-pre-inline", FOnOff, &m_fDfgPreInline);
     DECL_OPTION("-fdfg-post-inline", FOnOff, &m_fDfgPostInline);
+    DECL_OPTION("-fdfg-scoped", FOnOff, &m_fDfgScoped);
+    DECL_OPTION("-fdpi-direct", FOnOff, &m_fDpiDirect);
     DECL_OPTION("-fexpand", FOnOff, &m_fExpand);
     DECL_OPTION("-fgate", FOnOff, &m_fGate);
     DECL_OPTION("-finline", FOnOff, &m_fInline);
@@ -1210,11 +1231,13 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-flife-post", FOnOff, &m_fLifePost);
     DECL_OPTION("-flocalize", FOnOff, &m_fLocalize);
     DECL_OPTION("-fmerge-cond", FOnOff, &m_fMergeCond);
+    DECL_OPTION("-fmerge-cond-branchless", FOnOff, &m_fMergeCondBranchless);
     DECL_OPTION("-fmerge-cond-motion", FOnOff, &m_fMergeCondMotion);
     DECL_OPTION("-fmerge-const-pool", FOnOff, &m_fMergeConstPool);
     DECL_OPTION("-freloop", FOnOff, &m_fReloop);
     DECL_OPTION("-freorder", FOnOff, &m_fReorder);
     DECL_OPTION("-fsplit", FOnOff, &m_fSplit);
+    DECL_OPTION("-fsplit-var-auto", FOnOff, &m_fSplitVarAuto);
     DECL_OPTION("-fsubst", FOnOff, &m_fSubst);
     DECL_OPTION("-fsubst-const", FOnOff, &m_fSubstConst);
     DECL_OPTION("-ftable", FOnOff, &m_fTable);
@@ -1237,11 +1260,17 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     });
 
     DECL_OPTION("-hierarchical", OnOff, &m_hierarchical);
+    DECL_OPTION("-hierarchical-auto", CbOnOff, [this](bool flag) {
+        m_hierarchicalAuto = flag;
+        if (flag) m_hierarchical = true;
+    });
     DECL_OPTION("-hierarchical-block", CbVal, [this](const char* valp) {
         const V3HierarchicalBlockOption opt{valp};
         m_hierBlocks.emplace(opt.mangledName(), opt);
     });
     DECL_OPTION("-hierarchical-child", Set, &m_hierChild);
+    DECL_OPTION("-hot-sections", OnOff, &m_hotSections);
+    DECL_OPTION("-hugepage-text", OnOff, &m_hugepageText);
 
     DECL_OPTION("-I", CbPartialMatch,
                 [this, &optdir](const char* optp) { addIncDirUser(parseFileArg(optdir, optp)); });
@@ -1252,6 +1281,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         m_instrCountDpi = val;
         if (m_instrCountDpi < 0) fl->v3fatal("--instr-count-dpi must be non-negative: " << val);
     });
+    DECL_OPTION("-instr-count-scales", Set, &m_instrCountScales);
 
     DECL_OPTION("-LDFLAGS", CbVal, callStrSetter(&V3Options::addLdLibs));
     const auto setLang = [this, fl](const char* valp) {
@@ -1282,6 +1312,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         addIncDirFallback(m_makeDir);  // Need to find generated files there too
     });
     DECL_OPTION("-main", OnOff, &m_main);
+    DECL_OPTION("-main-stats", CbOnOff, [this](bool flag) {
+        m_mainStats = flag;
+        if (flag) m_runtimeStats = true;
+    });
     DECL_OPTION("-make", CbVal, [this, fl](const char* valp) {
         if (!std::strcmp(valp, "cmake")) {
             m_cmake = true;
@@ -1344,6 +1378,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-order-clock-delay", CbOnOff, [fl](bool /*flag*/) {
         fl->v3warn(DEPRECATED, "Option order-clock-delay is deprecated and has no effect.");
     });
+    DECL_OPTION("-output-groups", CbVal, [this, fl](const char* valp) {
+        m_outputGroups = std::atoi(valp);
+        if (m_outputGroups < 0) fl->v3error("--output-groups must be >= 0: " << valp);
+    });
     DECL_OPTION("-output-split", Set, &m_outputSplit);
     DECL_OPTION("-output-split-cfuncs", CbVal, [this, fl](const char* valp) {
         m_outputSplitCFuncs = std::atoi(valp);
@@ -1357,6 +1395,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
             fl->v3error("--output-split-ctrace must be >= 0: " << valp);
         }
     });
+    DECL_OPTION("-output-split-stable", OnOff, &m_outputSplitStable);
 
     DECL_OPTION("-P", Set, &m_preprocNoLine);
     DECL_OPTION("-pvalue+", CbPartialMatch,
@@ -1386,6 +1425,8 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
                 [this]() { m_profC = m_profCFuncs = true; });  // Renamed
     DECL_OPTION("-prof-exec", OnOff, &m_profExec);
     DECL_OPTION("-prof-pgo", OnOff, &m_profPgo);
+    DECL_OPTION("-prof-sample", OnOff, &m_profSample);
+    DECL_OPTION("-prof-verilation", OnOff, &m_profVerilation);
     DECL_OPTION("-prof-threads", CbOnOff, [this, fl](bool flag) {
         fl->v3warn(DEPRECATED, "Option --prof-threads is deprecated. "
                                "Use --prof-exec and --prof-pgo instead.");
@@ -1415,6 +1456,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         if (m_reloopLimit < 2) { fl->v3error("--reloop-limit must be >= 2: " << valp); }
     });
     DECL_OPTION("-report-unoptflat", OnOff, &m_reportUnoptflat);
+    DECL_OPTION("-runtime-stats", OnOff, &m_runtimeStats);
     DECL_OPTION("-rr", CbCall, []() {});  // Processed only in bin/verilator shell
 
     DECL_OPTION("-savable", OnOff, &m_savable);
@@ -1422,7 +1464,12 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         m_outFormatOk = true;
         m_systemC = true;
     });
+    DECL_OPTION("-sc-sync-ports", OnOff, &m_scSyncPorts);
     DECL_OPTION("-skip-identical", OnOff, &m_skipIdentical);
+    DECL_OPTION("-sparse-arrays", CbVal, [this, fl](const char* valp) {
+        m_sparseArrays = std::atoi(valp);
+        if (m_sparseArrays < 0) fl->v3error("--sparse-arrays must be >= 0: " << valp);
+    });
     DECL_OPTION("-stats", OnOff, &m_stats);
     DECL_OPTION("-stats-vars", CbOnOff, [this](bool flag) {
         m_statsVars = flag;
@@ -1432,6 +1479,11 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-structs-packed", OnOff, &m_structsPacked);
     DECL_OPTION("-sv", CbCall, [this]() { m_defaultLanguage = V3LangCode::L1800_2017; });
 
+    DECL_OPTION("-table-cache-bytes", CbVal, [this, fl](const char* valp) {
+        m_tableCacheBytes = std::atoi(valp);
+        if (m_tableCacheBytes < 0) fl->v3fatal("--table-cache-bytes must be >= 0: " << valp);
+    });
+
     DECL_OPTION("-threads-coarsen", OnOff, &m_threadsCoarsen).undocumented();  // Debug
     DECL_OPTION("-no-threads", CbCall, [this, fl]() {
         fl->v3warn(DEPRECATED, "Option --no-threads is deprecated, use '--threads 1' instead");
@@ -1461,10 +1513,24 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
                         << fl->warnMore() << "... Suggest 'all', 'none', or 'pure'");
         }
     });
+    DECL_OPTION("-threads-dynamic", OnOff, &m_threadsDynamic);
     DECL_OPTION("-threads-max-mtasks", CbVal, [this, fl](const char* valp) {
         m_threadsMaxMTasks = std::atoi(valp);
         if (m_threadsMaxMTasks < 1) fl->v3fatal("--threads-max-mtasks must be >= 1: " << valp);
     });
+    DECL_OPTION("-threads-pad-budget", CbVal, [this, fl](const char* valp) {
+        m_threadsPadBudget = std::atoi(valp);
+        if (m_threadsPadBudget < 0) fl->v3fatal("--threads-pad-budget must be >= 0: " << valp);
+    });
+    DECL_OPTION("-threads-region-cost", CbVal, [this, fl](const char* valp) {
+        m_threadsRegionCost = std::atoi(valp);
+        if (m_threadsRegionCost < 0) fl->v3fatal("--threads-region-cost must be >= 0: " << valp);
+    });
+    DECL_OPTION("-threads-skip-idle", OnOff, &m_threadsSkipIdle);
+    DECL_OPTION("-threads-schedules", CbVal, [this, fl](const char* valp) {
+        m_threadsSchedules = std::atoi(valp);
+        if (m_threadsSchedules < 1) fl->v3fatal("--threads-schedules must be >= 1: " << valp);
+    });
     DECL_OPTION("-timescale", CbVal, [this, fl](const char* valp) {
         VTimescale unit;
         VTimescale prec;
@@ -1507,7 +1573,12 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-trace-max-array", Set, &m_traceMaxArray);
     DECL_OPTION("-trace-max-width", Set, &m_traceMaxWidth);
     DECL_OPTION("-trace-params", OnOff, &m_traceParams);
+    DECL_OPTION("-trace-share-instances", OnOff, &m_traceShareInstances);
     DECL_OPTION("-trace-structs", OnOff, &m_traceStructs);
+    DECL_OPTION("-trace-vbt", CbCall, [this]() {
+        m_trace = true;
+        m_traceFormat = TraceFormat::VBT;
+    });
     DECL_OPTION("-trace-threads", CbVal, [this, fl](const char* valp) {
         m_trace = true;
         m_traceThreads = std::atoi(valp);
@@ -1546,6 +1617,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         std::exit(0);
     });
     DECL_OPTION("-vpi", OnOff, &m_vpi);
+    DECL_OPTION("-vpi-hooks", CbOnOff, [this](bool flag) {
+        m_vpiHooks = flag;
+        if (flag) m_vpi = true;
+    });
 
     DECL_OPTION("-Wpedantic", CbCall, [this]() {
         m_pedantic = true;
@@ -1618,6 +1693,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         V3Error::pretendError(V3ErrorCode::WIDTH, false);
     });
     DECL_OPTION("-waiver-output", Set, &m_waiverOutput);
+    DECL_OPTION("-write-if-changed", OnOff, &m_writeIfChanged);
 
     DECL_OPTION("-x-assign", CbVal, [this, fl](const char* valp) {
         if (!std::strcmp(valp, "0")) {
@@ -1703,6 +1779,8 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
             ++i;
         }
     }
+    // Unless given, group output files by the number of build jobs, if those were given
+    if (m_outputGroups == -1 && m_buildJobs != -1) m_outputGroups = m_buildJobs;
     if (m_buildJobs == -1) m_buildJobs = 1;
     if (m_verilateJobs == -1) m_verilateJobs = 1;
 }
@@ -1977,9 +2055,11 @@ void V3Options::optimize(int level) {
     m_fAcycSimp = flag;
     m_fAssemble = flag;
     m_fCase = flag;
+    m_fClockGate = flag;
     m_fCombine = flag;
     m_fConst = flag;
     m_fConstBitOpTree = flag;
+    m_fCse = flag;
     m_fDedupe = flag;
     m_fDfgPreInline = flag;
     m_fDfgPostInline = flag;
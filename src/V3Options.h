@@ -134,7 +134,7 @@ inline std::ostream& operator<<(std::ostream& os, const VTimescale& rhs) {
 
 class TraceFormat final {
 public:
-    enum en : uint8_t { VCD = 0, FST } m_e;
+    enum en : uint8_t { VCD = 0, FST, VBT } m_e;
     // cppcheck-suppress noExplicitConstructor
     constexpr TraceFormat(en _e = VCD)
         : m_e{_e} {}
@@ -143,12 +143,13 @@ public:
     constexpr operator en() const { return m_e; }
     bool fst() const { return m_e == FST; }
     bool vcd() const { return m_e == VCD; }
+    bool vbt() const { return m_e == VBT; }
     string classBase() const {
-        static const char* const names[] = {"VerilatedVcd", "VerilatedFst"};
+        static const char* const names[] = {"VerilatedVcd", "VerilatedFst", "VerilatedVbt"};
         return names[m_e];
     }
     string sourceName() const VL_MT_SAFE {
-        static const char* const names[] = {"verilated_vcd", "verilated_fst"};
+        static const char* const names[] = {"verilated_vcd", "verilated_fst", "verilated_vbt"};
         return names[m_e];
     }
 };
@@ -228,6 +229,7 @@ private:
     bool m_cmake = false;           // main switch: --make cmake
     bool m_context = true;          // main switch: --Wcontext
     bool m_coverageLine = false;    // main switch: --coverage-block
+    bool m_coveragePerThread = false;  // main switch: --coverage-per-thread
     bool m_coverageToggle = false;  // main switch: --coverage-toggle
     bool m_coverageUnderscore = false;  // main switch: --coverage-underscore
     bool m_coverageUser = false;    // main switch: --coverage-func
@@ -246,11 +248,16 @@ private:
     bool m_exe = false;             // main switch: --exe
     bool m_flatten = false;         // main switch: --flatten
     bool m_hierarchical = false;    // main switch: --hierarchical
+    bool m_hierarchicalAuto = false;  // main switch: --hierarchical-auto
+    bool m_hotSections = false;     // main switch: --hot-sections
+    bool m_hugepageText = false;    // main switch: --hugepage-text
     bool m_ignc = false;            // main switch: --ignc
     bool m_lintOnly = false;        // main switch: --lint-only
     bool m_gmake = false;           // main switch: --make gmake
     bool m_main = false;            // main switch: --main
+    bool m_mainStats = false;       // main switch: --main-stats
     bool m_outFormatOk = false;     // main switch: --cc, --sc or --sp was specified
+    bool m_outputSplitStable = false;  // main switch: --output-split-stable
     bool m_pedantic = false;        // main switch: --Wpedantic
     bool m_pinsScUint = false;      // main switch: --pins-sc-uint
     bool m_pinsScBigUint = false;   // main switch: --pins-sc-biguint
@@ -260,6 +267,8 @@ private:
     bool m_profCFuncs = false;      // main switch: --prof-cfuncs
     bool m_profExec = false;        // main switch: --prof-exec
     bool m_profPgo = false;         // main switch: --prof-pgo
+    bool m_profSample = false;      // main switch: --prof-sample
+    bool m_profVerilation = false;  // main switch: --prof-verilation
     bool m_protectIds = false;      // main switch: --protect-ids
     bool m_public = false;          // main switch: --public
     bool m_publicFlatRW = false;    // main switch: --public-flat-rw
@@ -267,7 +276,9 @@ private:
     bool m_quietExit = false;       // main switch: --quiet-exit
     bool m_relativeIncludes = false; // main switch: --relative-includes
     bool m_reportUnoptflat = false; // main switch: --report-unoptflat
+    bool m_runtimeStats = false;    // main switch: --runtime-stats
     bool m_savable = false;         // main switch: --savable
+    bool m_scSyncPorts = false;     // main switch: --sc-sync-ports
     bool m_std = true;              // main switch: --std
     bool m_structsPacked = false;   // main switch: --structs-packed
     bool m_systemC = false;         // main switch: --sc: System C instead of simple C++
@@ -276,22 +287,29 @@ private:
     bool m_threadsCoarsen = true;   // main switch: --threads-coarsen
     bool m_threadsDpiPure = true;   // main switch: --threads-dpi all/pure
     bool m_threadsDpiUnpure = false;  // main switch: --threads-dpi all
+    bool m_threadsDynamic = false;  // main switch: --threads-dynamic
+    bool m_threadsSkipIdle = false;  // main switch: --threads-skip-idle
     VOptionBool m_timing;           // main switch: --timing
     bool m_trace = false;           // main switch: --trace
     bool m_traceCoverage = false;   // main switch: --trace-coverage
     bool m_traceParams = true;      // main switch: --trace-params
+    bool m_traceShareInstances = false;  // main switch: --trace-share-instances
     bool m_traceStructs = false;    // main switch: --trace-structs
     bool m_traceUnderscore = false; // main switch: --trace-underscore
     bool m_underlineZero = false;   // main switch: --underline-zero; undocumented old Verilator 2
     bool m_verilate = true;         // main switch: --verilate
     bool m_vpi = false;             // main switch: --vpi
+    bool m_vpiHooks = false;        // main switch: --vpi-hooks
+    bool m_writeIfChanged = false;  // main switch: --write-if-changed
     bool m_xInitialEdge = false;    // main switch: --x-initial-edge
     bool m_xmlOnly = false;         // main switch: --xml-only
 
+    int         m_batchInstances = 0;  // main switch: --batch-instances
     int         m_buildJobs = -1;    // main switch: --build-jobs, -j
     int         m_convergeLimit = 100;  // main switch: --converge-limit
     int         m_coverageMaxWidth = 256; // main switch: --coverage-max-width
     int         m_expandLimit = 64;  // main switch: --expand-limit
+    int         m_expandSimdWidth = 0;  // main switch: --expand-simd-width
     int         m_gateStmts = 100;    // main switch: --gate-stmts
     int         m_hierChild = 0;      // main switch: --hierarchical-child
     int         m_ifDepth = 0;      // main switch: --if-depth
@@ -300,6 +318,7 @@ private:
     VOptionBool m_makeDepend;  // main switch: -MMD
     int         m_maxNumWidth = 65536;  // main switch: --max-num-width
     int         m_moduleRecursion = 100;  // main switch: --module-recursion-depth
+    int         m_outputGroups = -1;  // main switch: --output-groups
     int         m_outputSplit = 20000;  // main switch: --output-split
     int         m_outputSplitCFuncs = -1;  // main switch: --output-split-cfuncs
     int         m_outputSplitCTrace = -1;  // main switch: --output-split-ctrace
@@ -307,14 +326,19 @@ private:
     int         m_publicDepth = 0;   // main switch: --public-depth
     int         m_reloopLimit = 40; // main switch: --reloop-limit
     VOptionBool m_skipIdentical;  // main switch: --skip-identical
+    int         m_sparseArrays = 0;  // main switch: --sparse-arrays
+    int         m_tableCacheBytes = 2 * 1024 * 1024;  // main switch: --table-cache-bytes
     int         m_threads = 1;      // main switch: --threads
     int         m_threadsMaxMTasks = 0;  // main switch: --threads-max-mtasks
+    int         m_threadsPadBudget = 4096;  // main switch: --threads-pad-budget
+    int         m_threadsRegionCost = 2000;  // main switch: --threads-region-cost
+    int         m_threadsSchedules = 1;  // main switch: --threads-schedules
     VTimescale  m_timeDefaultPrec;  // main switch: --timescale
     VTimescale  m_timeDefaultUnit;  // main switch: --timescale
     VTimescale  m_timeOverridePrec;  // main switch: --timescale-override
     VTimescale  m_timeOverrideUnit;  // main switch: --timescale-override
     int         m_traceDepth = 0;   // main switch: --trace-depth
-    TraceFormat m_traceFormat;  // main switch: --trace or --trace-fst
+    TraceFormat m_traceFormat;  // main switch: --trace, --trace-fst or --trace-vbt
     int         m_traceMaxArray = 32;  // main switch: --trace-max-array
     int         m_traceMaxWidth = 256; // main switch: --trace-max-width
     int         m_traceThreads = 0; // main switch: --trace-threads
@@ -329,6 +353,7 @@ private:
     string      m_buildDepBin;  // main switch: --build-dep-bin {filename}
     string      m_exeName;      // main switch: -o {name}
     string      m_flags;        // main switch: -f {name}
+    string      m_instrCountScales;  // main switch: --instr-count-scales {filename}
     string      m_l2Name;       // main switch: --l2name; "" for top-module's name
     string      m_libCreate;    // main switch: --lib-create {lib_name}
     string      m_makeDir;      // main switch: -Mdir
@@ -350,15 +375,20 @@ private:
     // MEMBERS (optimizations)
     bool m_fAcycSimp;    // main switch: -fno-acyc-simp: acyclic pre-optimizations
     bool m_fAssemble;    // main switch: -fno-assemble: assign assemble
+    bool m_fAssocHash = true;  // main switch: -fno-assoc-hash: hash unordered assoc arrays
     bool m_fCase;        // main switch: -fno-case: case tree conversion
+    bool m_fClockGate;   // main switch: -fno-clock-gate: gated clock triggers from clock
     bool m_fCombine;     // main switch: -fno-combine: common icode packing
     bool m_fConst;       // main switch: -fno-const: constant folding
     bool m_fConstBeforeDfg = true;  // main switch: -fno-const-before-dfg for testing only!
     bool m_fConstBitOpTree;  // main switch: -fno-const-bit-op-tree constant bit op tree
+    bool m_fCse;         // main switch: -fno-cse: common subexpression elimination
     bool m_fDedupe;      // main switch: -fno-dedupe: logic deduplication
     bool m_fDfgPeephole = true; // main switch: -fno-dfg-peephole
     bool m_fDfgPreInline;    // main switch: -fno-dfg-pre-inline and -fno-dfg
     bool m_fDfgPostInline;   // main switch: -fno-dfg-post-inline and -fno-dfg
+    bool m_fDfgScoped = false;  // main switch: -fdfg-scoped
+    bool m_fDpiDirect = true;  // main switch: -fno-dpi-direct: call scalar DPI imports directly
     bool m_fExpand;      // main switch: -fno-expand: expansion of C macros
     bool m_fGate;        // main switch: -fno-gate: gate wire elimination
     bool m_fInline;      // main switch: -fno-inline: module inlining
@@ -366,11 +396,13 @@ private:
     bool m_fLifePost;    // main switch: -fno-life-post: delayed assignment elimination
     bool m_fLocalize;    // main switch: -fno-localize: convert temps to local variables
     bool m_fMergeCond;   // main switch: -fno-merge-cond: merge conditionals
+    bool m_fMergeCondBranchless = true; // main switch: -fno-merge-cond-branchless: keep selects
     bool m_fMergeCondMotion = true; // main switch: -fno-merge-cond-motion: perform code motion
     bool m_fMergeConstPool = true;  // main switch: -fno-merge-const-pool
     bool m_fReloop;      // main switch: -fno-reloop: reform loops
     bool m_fReorder;     // main switch: -fno-reorder: reorder assignments in blocks
     bool m_fSplit;       // main switch: -fno-split: always assignment splitting
+    bool m_fSplitVarAuto = false;  // main switch: -fsplit-var-auto: split_var without metacomment
     bool m_fSubst;       // main switch: -fno-subst: substitute expression temp values
     bool m_fSubstConst;  // main switch: -fno-subst-const: final constant substitution
     bool m_fTable;       // main switch: -fno-table: lookup table creation
@@ -431,6 +463,7 @@ public:
     bool underlineZero() const { return m_underlineZero; }
     string flags() const { return m_flags; }
     bool systemC() const VL_MT_SAFE { return m_systemC; }
+    bool scSyncPorts() const VL_MT_SAFE { return m_systemC && m_scSyncPorts; }
     bool savable() const VL_MT_SAFE { return m_savable; }
     bool stats() const { return m_stats; }
     bool statsVars() const { return m_statsVars; }
@@ -449,6 +482,8 @@ public:
         return m_coverageLine || m_coverageToggle || m_coverageUser;
     }
     bool coverageLine() const { return m_coverageLine; }
+    // Per-thread counters only apply when there is more than one thread
+    bool coveragePerThread() const { return m_coveragePerThread && m_threads > 1; }
     bool coverageToggle() const { return m_coverageToggle; }
     bool coverageUnderscore() const { return m_coverageUnderscore; }
     bool coverageUser() const { return m_coverageUser; }
@@ -474,13 +509,17 @@ public:
     bool threadsDpiPure() const { return m_threadsDpiPure; }
     bool threadsDpiUnpure() const { return m_threadsDpiUnpure; }
     bool threadsCoarsen() const { return m_threadsCoarsen; }
+    bool threadsDynamic() const { return m_threadsDynamic; }
+    bool threadsSkipIdle() const { return m_threadsSkipIdle; }
     VOptionBool timing() const { return m_timing; }
     bool trace() const { return m_trace; }
     bool traceCoverage() const { return m_traceCoverage; }
     bool traceParams() const { return m_traceParams; }
+    bool traceShareInstances() const { return m_traceShareInstances; }
     bool traceStructs() const { return m_traceStructs; }
     bool traceUnderscore() const { return m_traceUnderscore; }
     bool main() const { return m_main; }
+    bool mainStats() const { return m_mainStats; }
     bool outFormatOk() const { return m_outFormatOk; }
     bool keepTempFiles() const { return (V3Error::debugDefault() != 0); }
     bool pedantic() const { return m_pedantic; }
@@ -488,11 +527,14 @@ public:
     bool pinsScBigUint() const { return m_pinsScBigUint; }
     bool pinsUint8() const { return m_pinsUint8; }
     bool ppComments() const { return m_ppComments; }
+    bool outputSplitStable() const { return m_outputSplitStable; }
     bool profC() const { return m_profC; }
     bool profCFuncs() const { return m_profCFuncs; }
     bool profExec() const { return m_profExec; }
     bool profPgo() const { return m_profPgo; }
-    bool usesProfiler() const { return profExec() || profPgo(); }
+    bool profSample() const { return m_profSample; }
+    bool profVerilation() const { return m_profVerilation; }
+    bool usesProfiler() const { return profExec() || profPgo() || profSample(); }
     bool protectIds() const VL_MT_SAFE { return m_protectIds; }
     bool allPublic() const { return m_public; }
     bool publicParams() const { return m_public_params; }
@@ -501,24 +543,31 @@ public:
     bool ignc() const { return m_ignc; }
     bool quietExit() const VL_MT_SAFE { return m_quietExit; }
     bool reportUnoptflat() const { return m_reportUnoptflat; }
+    bool runtimeStats() const { return m_runtimeStats; }
     bool verilate() const { return m_verilate; }
     bool vpi() const { return m_vpi; }
+    bool vpiHooks() const { return m_vpiHooks; }
+    bool writeIfChanged() const VL_MT_SAFE { return m_writeIfChanged; }
     bool xInitialEdge() const { return m_xInitialEdge; }
     bool xmlOnly() const { return m_xmlOnly; }
     bool topIfacesSupported() const { return lintOnly() && !hierarchical(); }
 
+    int batchInstances() const { return m_batchInstances; }
     int buildJobs() const VL_MT_SAFE { return m_buildJobs; }
     int convergeLimit() const { return m_convergeLimit; }
     int coverageMaxWidth() const { return m_coverageMaxWidth; }
     bool dumpTreeAddrids() const VL_MT_SAFE;
     int expandLimit() const { return m_expandLimit; }
+    int expandSimdWidth() const { return m_expandSimdWidth; }
     int gateStmts() const { return m_gateStmts; }
     int ifDepth() const { return m_ifDepth; }
     int inlineMult() const { return m_inlineMult; }
     int instrCountDpi() const { return m_instrCountDpi; }
+    string instrCountScales() const { return m_instrCountScales; }
     VOptionBool makeDepend() const { return m_makeDepend; }
     int maxNumWidth() const { return m_maxNumWidth; }
     int moduleRecursionDepth() const { return m_moduleRecursion; }
+    int outputGroups() const { return m_outputGroups; }
     int outputSplit() const { return m_outputSplit; }
     int outputSplitCFuncs() const { return m_outputSplitCFuncs; }
     int outputSplitCTrace() const { return m_outputSplitCTrace; }
@@ -526,8 +575,13 @@ public:
     int publicDepth() const { return m_publicDepth; }
     int reloopLimit() const { return m_reloopLimit; }
     VOptionBool skipIdentical() const { return m_skipIdentical; }
+    int sparseArrays() const { return m_sparseArrays; }
+    int tableCacheBytes() const { return m_tableCacheBytes; }
     int threads() const VL_MT_SAFE { return m_threads; }
     int threadsMaxMTasks() const { return m_threadsMaxMTasks; }
+    int threadsPadBudget() const { return m_threadsPadBudget; }
+    int threadsRegionCost() const { return m_threadsRegionCost; }
+    int threadsSchedules() const { return m_threadsSchedules; }
     bool mtasks() const { return (m_threads > 1); }
     VTimescale timeDefaultPrec() const { return m_timeDefaultPrec; }
     VTimescale timeDefaultUnit() const { return m_timeDefaultUnit; }
@@ -542,11 +596,14 @@ public:
     int traceThreads() const { return m_traceThreads; }
     bool useTraceOffload() const { return trace() && traceFormat().fst() && traceThreads() > 1; }
     bool useTraceParallel() const {
-        return trace() && traceFormat().vcd() && threads() && (threads() > 1 || hierChild() > 1);
+        return trace() && traceFormat().vcd() && threads()
+               && (threads() > 1 || hierChild() > 1 || traceThreads() > 1);
     }
     bool useFstWriterThread() const { return traceThreads() && traceFormat().fst(); }
     unsigned vmTraceThreads() const {
-        return useTraceParallel() ? threads() : useTraceOffload() ? 1 : 0;
+        return useTraceParallel() ? std::max(threads(), traceThreads())
+               : useTraceOffload() ? 1
+                                   : 0;
     }
     int unrollCount() const { return m_unrollCount; }
     int unrollStmts() const { return m_unrollStmts; }
@@ -605,18 +662,23 @@ public:
     // ACCESSORS (optimization options)
     bool fAcycSimp() const { return m_fAcycSimp; }
     bool fAssemble() const { return m_fAssemble; }
+    bool fAssocHash() const { return m_fAssocHash; }
     bool fCase() const { return m_fCase; }
+    bool fClockGate() const { return m_fClockGate; }
     bool fCombine() const { return m_fCombine; }
     bool fConst() const { return m_fConst; }
     bool fConstBeforeDfg() const { return m_fConstBeforeDfg; }
     bool fConstBitOpTree() const { return m_fConstBitOpTree; }
+    bool fCse() const { return m_fCse; }
     bool fDedupe() const { return m_fDedupe; }
     bool fDfgPeephole() const { return m_fDfgPeephole; }
     bool fDfgPreInline() const { return m_fDfgPreInline; }
     bool fDfgPostInline() const { return m_fDfgPostInline; }
+    bool fDfgScoped() const { return m_fDfgScoped; }
     bool fDfgPeepholeEnabled(const std::string& name) const {
         return !m_fDfgPeepholeDisabled.count(name);
     }
+    bool fDpiDirect() const { return m_fDpiDirect; }
     bool fExpand() const { return m_fExpand; }
     bool fGate() const { return m_fGate; }
     bool fInline() const { return m_fInline; }
@@ -624,11 +686,13 @@ public:
     bool fLifePost() const { return m_fLifePost; }
     bool fLocalize() const { return m_fLocalize; }
     bool fMergeCond() const { return m_fMergeCond; }
+    bool fMergeCondBranchless() const { return m_fMergeCondBranchless; }
     bool fMergeCondMotion() const { return m_fMergeCondMotion; }
     bool fMergeConstPool() const { return m_fMergeConstPool; }
     bool fReloop() const { return m_fReloop; }
     bool fReorder() const { return m_fReorder; }
     bool fSplit() const { return m_fSplit; }
+    bool fSplitVarAuto() const { return m_fSplitVarAuto; }
     bool fSubst() const { return m_fSubst; }
     bool fSubstConst() const { return m_fSubstConst; }
     bool fTable() const { return m_fTable; }
@@ -641,6 +705,9 @@ public:
     }
 
     bool hierarchical() const { return m_hierarchical; }
+    bool hierarchicalAuto() const { return m_hierarchical && m_hierarchicalAuto; }
+    bool hotSections() const { return m_hotSections; }
+    bool hugepageText() const { return m_hugepageText; }
     int hierChild() const { return m_hierChild; }
     bool hierTop() const VL_MT_SAFE { return !m_hierChild && !m_hierBlocks.empty(); }
     const V3HierBlockOptSet& hierBlocks() const { return m_hierBlocks; }
@@ -471,21 +471,31 @@ class OrderMoveDomScope final {
     // Information stored for each unique loop, domain & scope trifecta
 public:
     V3ListEnt<OrderMoveDomScope*> m_readyDomScopeE;  // List of next ready dom scope
+    V3ListEnt<OrderMoveDomScope*> m_readyDomainE;  // List of next ready scope in same domain
     V3List<OrderMoveVertex*> m_readyVertices;  // Ready vertices with same domain & scope
 private:
     bool m_onReadyList = false;  // True if DomScope is already on list of ready dom/scopes
     const AstSenTree* const m_domainp;  // Domain all vertices belong to
     const AstScope* const m_scopep;  // Scope all vertices belong to
+    // Ready dom/scopes under same domain, in the same order as the list of all ready dom/scopes
+    V3List<OrderMoveDomScope*>* const m_readyDomainp;
 
-    using DomScopeKey = std::pair<const AstSenTree*, const AstScope*>;
-    using DomScopeMap = std::map<DomScopeKey, OrderMoveDomScope*>;
-    static DomScopeMap s_dsMap;  // Structure registered for each dom/scope pairing
+    struct DomainInfo final {
+        // Structure registered for each scope under this domain
+        std::unordered_map<const AstScope*, OrderMoveDomScope*> m_scopes;
+        V3List<OrderMoveDomScope*> m_ready;  // Ready dom/scopes under this domain
+    };
+    using DomainMap = std::unordered_map<const AstSenTree*, DomainInfo>;
+    static DomainMap s_domains;  // Structure registered for each domain
 
 public:
-    OrderMoveDomScope(const AstSenTree* domainp, const AstScope* scopep)
+    OrderMoveDomScope(const AstSenTree* domainp, const AstScope* scopep,
+                      V3List<OrderMoveDomScope*>* readyDomainp)
         : m_domainp{domainp}
-        , m_scopep{scopep} {}
-    OrderMoveDomScope* readyDomScopeNextp() const { return m_readyDomScopeE.nextp(); }
+        , m_scopep{scopep}
+        , m_readyDomainp{readyDomainp} {}
+    // First ready dom/scope with the same domain as this, or nullptr if none
+    OrderMoveDomScope* readyDomainBeginp() const { return m_readyDomainp->begin(); }
     const AstSenTree* domainp() const { return m_domainp; }
     const AstScope* scopep() const { return m_scopep; }
     // Check the domScope is on ready list, add if not
@@ -494,27 +504,24 @@ public:
     void movedVertex(OrderProcess* opp, OrderMoveVertex* vertexp);
     // STATIC MEMBERS (for lookup)
     static void clear() {
-        for (const auto& itr : s_dsMap) delete itr.second;
-        s_dsMap.clear();
+        for (const auto& ditr : s_domains) {
+            for (const auto& sitr : ditr.second.m_scopes) delete sitr.second;
+        }
+        s_domains.clear();
     }
     V3List<OrderMoveVertex*>& readyVertices() { return m_readyVertices; }
     static OrderMoveDomScope* findCreate(const AstSenTree* domainp, const AstScope* scopep) {
-        const DomScopeKey key = std::make_pair(domainp, scopep);
-        const auto iter = s_dsMap.find(key);
-        if (iter != s_dsMap.end()) {
-            return iter->second;
-        } else {
-            OrderMoveDomScope* domScopep = new OrderMoveDomScope{domainp, scopep};
-            s_dsMap.emplace(key, domScopep);
-            return domScopep;
-        }
+        DomainInfo& domain = s_domains[domainp];
+        OrderMoveDomScope*& domScopep = domain.m_scopes[scopep];
+        if (!domScopep) domScopep = new OrderMoveDomScope{domainp, scopep, &domain.m_ready};
+        return domScopep;
     }
     string name() const {
         return string{"MDS:"} + " d=" + cvtToHex(domainp()) + " s=" + cvtToHex(scopep());
     }
 };
 
-OrderMoveDomScope::DomScopeMap OrderMoveDomScope::s_dsMap;
+OrderMoveDomScope::DomainMap OrderMoveDomScope::s_domains;
 
 std::ostream& operator<<(std::ostream& lhs, const OrderMoveDomScope& rhs) {
     lhs << rhs.name();
@@ -830,7 +837,7 @@ class OrderProcess final : VNDeleter {
 
     // METHODS
 
-    void process(bool multiThreaded);
+    void process(uint32_t threads);
     void processDomains();
     void processDomainsIterate(OrderEitherVertex* vertexp);
     void processEdgeReport();
@@ -853,7 +860,7 @@ class OrderProcess final : VNDeleter {
         ExecMTask* m_execMTaskp = nullptr;
         MTaskState() = default;
     };
-    void processMTasks();
+    void processMTasks(uint32_t threads);
 
     string cfuncName(AstNodeModule* modp, AstSenTree* domainp, AstScope* scopep,
                      AstNode* forWhatp) {
@@ -908,10 +915,10 @@ public:
     static std::vector<AstNode*>
     main(AstNetlist* netlistp, OrderGraph& graph,
          const std::unordered_map<const AstSenItem*, const AstSenTree*>& trigToSen,
-         const string& tag, bool parallel, bool slow,
+         const string& tag, uint32_t threads, bool slow,
          const V3Order::ExternalDomainsProvider& externalDomains) {
         OrderProcess visitor{netlistp, graph, trigToSen, tag, slow, externalDomains};
-        visitor.process(parallel);
+        visitor.process(threads);
         return std::move(visitor.m_result);
     }
 };
@@ -924,6 +931,7 @@ void OrderMoveDomScope::ready(OrderProcess* opp) {
     if (!m_onReadyList) {
         m_onReadyList = true;
         m_readyDomScopeE.pushBack(opp->m_pomReadyDomScope, this);
+        m_readyDomainE.pushBack(*m_readyDomainp, this);
     }
 }
 
@@ -934,6 +942,7 @@ void OrderMoveDomScope::movedVertex(OrderProcess* opp, OrderMoveVertex* vertexp)
     if (m_readyVertices.empty()) {  // Else more work to get to later
         m_onReadyList = false;
         m_readyDomScopeE.unlink(opp->m_pomReadyDomScope, this);
+        m_readyDomainE.unlink(*m_readyDomainp, this);
     }
 }
 
@@ -1115,16 +1124,8 @@ void OrderProcess::processMove() {
                 processMoveOne(vertexp, domScopep, 1);
             }
             // Done with scope/domain pair, pick new scope under same domain, or nullptr if none
-            // left
-            OrderMoveDomScope* domScopeNextp = nullptr;
-            for (OrderMoveDomScope* huntp = m_pomReadyDomScope.begin(); huntp;
-                 huntp = huntp->readyDomScopeNextp()) {
-                if (huntp->domainp() == domScopep->domainp()) {
-                    domScopeNextp = huntp;
-                    break;
-                }
-            }
-            domScopep = domScopeNextp;
+            // left. This is the first one with this domain on the list of all ready dom/scopes.
+            domScopep = domScopep->readyDomainBeginp();
         }
     }
     UASSERT(m_pomWaiting.empty(),
@@ -1280,7 +1281,7 @@ AstActive* OrderProcess::processMoveOneLogic(const OrderLogicVertex* lvertexp,
     return activep;
 }
 
-void OrderProcess::processMTasks() {
+void OrderProcess::processMTasks(uint32_t threads) {
     // For nondeterminism debug:
     V3Partition::hashGraphDebug(&m_graph, "V3Order's m_graph");
 
@@ -1302,7 +1303,7 @@ void OrderProcess::processMTasks() {
     // Partition logicGraph into LogicMTask's. The partitioner will annotate
     // each vertex in logicGraph with a 'color' which is really an mtask ID
     // in this context.
-    V3Partition partitioner(&m_graph, &logicGraph);
+    V3Partition partitioner(&m_graph, &logicGraph, threads);
     V3Graph mtasks;
     partitioner.go(&mtasks);
 
@@ -1405,7 +1406,9 @@ void OrderProcess::processMTasks() {
             const AbstractLogicMTask* const fromp
                 = static_cast<const AbstractLogicMTask*>(fromVxp);
             const MTaskState& fromState = mtaskStates[fromp->id()];
-            new V3GraphEdge{depGraphp, fromState.m_execMTaskp, state.m_execMTaskp, 1};
+            // Keep the weight, it carries the communication cost for thread packing
+            new V3GraphEdge{depGraphp, fromState.m_execMTaskp, state.m_execMTaskp,
+                            inp->weight()};
         }
         execGraphp->addMTaskBodiesp(bodyp);
     }
@@ -1414,7 +1417,7 @@ void OrderProcess::processMTasks() {
 //######################################################################
 // OrderVisitor - Top processing
 
-void OrderProcess::process(bool multiThreaded) {
+void OrderProcess::process(uint32_t threads) {
     // Dump data
     if (dumpGraphLevel()) m_graph.dumpDotFilePrefixed(m_tag + "_orderg_pre");
 
@@ -1438,7 +1441,7 @@ void OrderProcess::process(bool multiThreaded) {
 
     if (dumpLevel()) processEdgeReport();
 
-    if (!multiThreaded) {
+    if (!threads) {
         UINFO(2, "  Construct Move Graph...\n");
         processMoveBuildGraph();
         // Different prefix (ordermv) as it's not the same graph
@@ -1450,7 +1453,7 @@ void OrderProcess::process(bool multiThreaded) {
         processMove();
     } else {
         UINFO(2, "  Set up mtasks...\n");
-        processMTasks();
+        processMTasks(threads);
     }
 
     // Dump data
@@ -1465,14 +1468,14 @@ AstCFunc* order(AstNetlist* netlistp,  //
                 const std::vector<V3Sched::LogicByScope*>& logic,  //
                 const std::unordered_map<const AstSenItem*, const AstSenTree*>& trigToSen,
                 const string& tag,  //
-                bool parallel,  //
+                uint32_t threads,  //
                 bool slow,  //
                 const ExternalDomainsProvider& externalDomains) {
     // Order the code
     const std::unique_ptr<OrderGraph> graph
         = OrderBuildVisitor::process(netlistp, logic, trigToSen);
     const auto& nodeps
-        = OrderProcess::main(netlistp, *graph, trigToSen, tag, parallel, slow, externalDomains);
+        = OrderProcess::main(netlistp, *graph, trigToSen, tag, threads, slow, externalDomains);
 
     // Create the result function
     AstScope* const scopeTopp = netlistp->topScopep()->scopep();
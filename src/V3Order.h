@@ -45,7 +45,7 @@ AstCFunc* order(
     const std::vector<V3Sched::LogicByScope*>& logic,  //
     const std::unordered_map<const AstSenItem*, const AstSenTree*>& trigToSen,
     const string& tag,  //
-    bool parallel,  //
+    uint32_t threads,  // Threads to partition for, or 0 for serial code
     bool slow,  //
     const ExternalDomainsProvider& externalDomains
     = [](const AstVarScope*, std::vector<AstSenTree*>&) {});
@@ -71,6 +71,7 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 #  endif
 # endif
 #else
+# include <sys/resource.h>  // getrusage
 # include <sys/time.h>
 # include <sys/wait.h>  // Needed on FreeBSD for WIFEXITED
 # include <unistd.h>  // usleep
@@ -274,6 +275,34 @@ void V3Os::unlinkRegexp(const string& dir, const string& regexp) {
 #endif
 }
 
+V3Os::DirListing V3Os::dirListing(const string& dirname) {
+    DirListing listing;
+#ifdef _MSC_VER
+    try {
+        for (const auto& dirEntry : std::filesystem::directory_iterator(dirname.c_str())) {
+            // Windows returns the attributes with the listing, so this does not stat
+            const DirEntryType type
+                = dirEntry.is_directory() ? DirEntryType::DIRECTORY : DirEntryType::NORMAL;
+            listing.emplace(dirEntry.path().filename().string(), type);
+        }
+    } catch (std::filesystem::filesystem_error const& ex) { listing.clear(); }
+#else
+    if (DIR* const dirp = opendir(dirname.c_str())) {
+        while (struct dirent* const direntp = readdir(dirp)) {
+            DirEntryType type = DirEntryType::UNKNOWN;
+#ifdef DT_REG  // Not all platforms report types
+            // Symbolic links and others need a stat to resolve
+            if (direntp->d_type == DT_REG) type = DirEntryType::NORMAL;
+            if (direntp->d_type == DT_DIR) type = DirEntryType::DIRECTORY;
+#endif
+            listing.emplace(direntp->d_name, type);
+        }
+        closedir(dirp);
+    }
+#endif
+    return listing;
+}
+
 //######################################################################
 // METHODS (random)
 
@@ -352,6 +381,43 @@ uint64_t V3Os::memUsageBytes() {
 #endif
 }
 
+uint64_t V3Os::memPeakUsageBytes() {
+#if defined(_WIN32) || defined(__MINGW32__)
+    const HANDLE process = GetCurrentProcess();
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(process, &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize;
+    return 0;
+#else
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) < 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;  // Already in bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+uint64_t V3Os::cpuTimeUsecs() {
+#if defined(_WIN32) || defined(__MINGW32__)
+    FILETIME createTime, exitTime, kernelTime, userTime;  // 0.1us intervals
+    if (!GetProcessTimes(GetCurrentProcess(), &createTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    const auto toUsecs = [](const FILETIME& ft) {
+        return ((static_cast<uint64_t>(ft.dwHighDateTime) << 32) + ft.dwLowDateTime) / 10ULL;
+    };
+    return toUsecs(kernelTime) + toUsecs(userTime);
+#else
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) < 0) return 0;
+    return (static_cast<uint64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
 void V3Os::u_sleep(int64_t usec) {
 #if defined(_WIN32) || defined(__MINGW32__)
     std::this_thread::sleep_for(std::chrono::microseconds(usec));
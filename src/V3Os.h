@@ -21,6 +21,7 @@
 #include "verilatedos.h"
 
 #include <array>
+#include <unordered_map>
 
 // Limited V3 headers here - this is a base class for Vlc etc
 #include "V3Error.h"
@@ -30,6 +31,11 @@
 
 class V3Os final {
 public:
+    // TYPES
+    enum class DirEntryType : uint8_t { UNKNOWN, NORMAL, DIRECTORY };
+    // Directory listing, mapping entry names to their type
+    using DirListing = std::unordered_map<string, DirEntryType>;
+
     // METHODS (environment)
     static string getenvStr(const string& envvar, const string& defaultValue);
     static void setenvStr(const string& envvar, const string& value, const string& why);
@@ -56,6 +62,9 @@ public:
     // METHODS (directory utilities)
     static void createDir(const string& dirname);
     static void unlinkRegexp(const string& dir, const string& regexp);
+    /// Return listing of directory, or empty if not readable. Reads the directory once,
+    /// types not reported by the directory read are UNKNOWN rather than stat'ed
+    static DirListing dirListing(const string& dirname);
 
     // METHODS (random)
     static uint64_t rand64(std::array<uint64_t, 2>& stater);
@@ -66,6 +75,10 @@ public:
     /// Return wall time since epoch in microseconds, or 0 if not implemented
     static uint64_t timeUsecs();
     static uint64_t memUsageBytes();  ///< Return memory usage in bytes, or 0 if not implemented
+    /// Return peak resident memory in bytes, or 0 if not implemented
+    static uint64_t memPeakUsageBytes();
+    /// Return CPU time used by all threads in microseconds, or 0 if not implemented
+    static uint64_t cpuTimeUsecs();
 
     // METHODS (sub command)
     /// Run system command, returns the exit code of the child process.
@@ -63,6 +63,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -257,6 +258,11 @@ class ParamProcessor final : public VNDeleter {
     // Generated modules by this visitor is not included
     V3StringSet m_allModuleNames;
 
+    // Parameters referenced from within their own module, filled per module on first use
+    std::unordered_set<const AstNodeModule*> m_refScannedMods;  // Modules already scanned
+    std::unordered_set<const AstVar*> m_refParams;  // Parameters with a reference
+    V3StringSet m_xrefNames;  // Names of all hierarchical references in the design
+
     CloneMap m_originalParams;  // Map between parameters of copied parameteized classes and their
                                 // original nodes
 
@@ -666,6 +672,23 @@ class ParamProcessor final : public VNDeleter {
         return modInfop;
     }
 
+    bool paramReferenced(const AstNodeModule* modp, const AstVar* varp) {
+        // Overriding a parameter nothing can observe needs no new module flavor.
+        // Be conservative: only plain modules, and nothing visible outside the model.
+        if (!VN_IS(modp, Module) || modp->hierBlock()) return true;
+        if (v3Global.opt.trace() || v3Global.opt.publicParams() || v3Global.opt.allPublic()
+            || varp->isSigPublic() || varp->isSigUserRdPublic()) {
+            return true;
+        }
+        if (m_xrefNames.count(varp->name())) return true;
+        if (m_refScannedMods.insert(modp).second) {
+            modp->foreach([this](const AstVarRef* refp) {
+                if (refp->varp()) m_refParams.insert(refp->varp());
+            });
+        }
+        return m_refParams.count(varp);
+    }
+
     void cellPinCleanup(AstNode* nodep, AstPin* pinp, AstNodeModule* srcModp, string& longnamer,
                         bool& any_overridesr) {
         if (!pinp->exprp()) return;  // No-connect
@@ -692,6 +715,10 @@ class ParamProcessor final : public VNDeleter {
                     // Setting parameter to its default value.  Just ignore it.
                     // This prevents making additional modules, and makes coverage more
                     // obvious as it won't show up under a unique module page name.
+                } else if (!paramReferenced(srcModp, modvarp)) {
+                    // Parameter is never read in the module, so every value results in an
+                    // identical flavor. Ignore it too, so they all share one module.
+                    UINFO(8, "Ignoring override of unreferenced " << modvarp << endl);
                 } else if (exprp->num().isDouble() || exprp->num().isString()
                            || exprp->num().isFourState() || exprp->num().width() != 32) {
                     longnamer
@@ -932,6 +959,7 @@ public:
              modp = VN_AS(modp->nextp(), NodeModule)) {
             m_allModuleNames.insert(modp->name());
         }
+        nodep->foreach([this](const AstVarXRef* refp) { m_xrefNames.insert(refp->name()); });
     }
     ~ParamProcessor() = default;
     VL_UNCOPYABLE(ParamProcessor);
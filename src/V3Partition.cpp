@@ -35,7 +35,9 @@
 #include <algorithm>
 #include <array>
 #include <list>
+#include <map>
 #include <memory>
+#include <set>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -89,6 +91,26 @@ class SiblingMC;
 // vertices, leave this as is.
 constexpr unsigned PART_SIBLING_EDGE_LIMIT = 26;
 
+//   PART_COMM_COST_PER_LINE (integer)
+//
+// Abstract cost, in V3InstrCount units, of moving one cache line of data
+// from an MTask to a dependent MTask running on a different thread.
+//
+// Each MTaskEdge is weighted with the cost of the variables communicated
+// along it. Merging the two MTasks of an edge saves this communication, so
+// it is credited in the edge's merge score. The cost also carries over to
+// the ExecMTask graph, where the thread packer charges it when an MTask
+// starts on a different thread than its predecessor.
+//
+// Set to 0 to model instruction counts only.
+constexpr unsigned PART_COMM_COST_PER_LINE = 8;
+
+//   PART_COMM_MAX_LINES (integer)
+//
+// Limit on the cache lines counted for a single variable. Large arrays are
+// rarely communicated in full between two MTasks.
+constexpr unsigned PART_COMM_MAX_LINES = 16;
+
 //   PART_STEPPED_COST (defined/undef)
 //
 // When computing critical path costs, use a step function on the actual
@@ -535,6 +557,9 @@ public:
     }
     LogicMTask* fromMTaskp() const { return static_cast<LogicMTask*>(fromp()); }
     LogicMTask* toMTaskp() const { return static_cast<LogicMTask*>(top()); }
+    // The edge weight is 1 + the cost of communication along this edge
+    uint32_t commCost() const { return weight() - 1; }
+    void addCommCost(uint32_t cost) { weight(weight() + cost); }
     bool mergeWouldCreateCycle() const {
         return LogicMTask::pathExistsFrom(fromMTaskp(), toMTaskp(), this);
     }
@@ -718,7 +743,11 @@ static uint32_t edgeScore(const MTaskEdge* edgep) {
                                               top->critPathCostWithout(GraphWay::FORWARD, edgep));
     const uint32_t mergedCpCostRev = std::max(fromp->critPathCostWithout(GraphWay::REVERSE, edgep),
                                               top->critPathCost(GraphWay::REVERSE));
-    return mergedCpCostRev + mergedCpCostFwd + LogicMTask::stepCost(fromp->cost() + top->cost());
+    const uint32_t mergedCost = LogicMTask::stepCost(fromp->cost() + top->cost());
+    // Merging saves the communication along this edge. Credit it, but no more
+    // than the merged cost, so the score still bounds the local CP from below.
+    const uint32_t commCredit = std::min(edgep->commCost(), mergedCost);
+    return mergedCpCostRev + mergedCpCostFwd + mergedCost - commCredit;
 }
 
 void MergeCandidate::rescore() {
@@ -1160,15 +1189,18 @@ static void partRedirectEdgesFrom(V3Graph* graphp, LogicMTask* recipientp, Logic
 
         if (recipientp->hasRelativeMTask(relativep)) {
             // An edge already exists between recipient and relative of donor.
-            // Mark it in need of a rescore
-            if (sbp) {
-                if (sbp->contains(edgep)) sbp->remove(edgep);
+            // Move the communication cost onto it, and mark it in need of a rescore
+            if (sbp || edgep->commCost()) {
                 MTaskEdge* const existMTaskEdgep = static_cast<MTaskEdge*>(
                     recipientp->findConnectingEdgep(GraphWay::FORWARD, relativep));
 #if VL_DEBUG
                 UASSERT(existMTaskEdgep, "findConnectingEdge didn't find edge");
 #endif
-                if (sbp->contains(existMTaskEdgep)) sbp->hintScoreChanged(existMTaskEdgep);
+                existMTaskEdgep->addCommCost(edgep->commCost());
+                if (sbp) {
+                    if (sbp->contains(edgep)) sbp->remove(edgep);
+                    if (sbp->contains(existMTaskEdgep)) sbp->hintScoreChanged(existMTaskEdgep);
+                }
             }
             VL_DO_DANGLING(edgep->unlinkDelete(), edgep);
         } else {
@@ -1200,15 +1232,18 @@ static void partRedirectEdgesFrom(V3Graph* graphp, LogicMTask* recipientp, Logic
 
         if (relativep->hasRelativeMTask(recipientp)) {
             // An edge already exists between recipient and relative of donor.
-            // Mark it in need of a rescore
-            if (sbp) {
-                if (sbp->contains(edgep)) sbp->remove(edgep);
+            // Move the communication cost onto it, and mark it in need of a rescore
+            if (sbp || edgep->commCost()) {
                 MTaskEdge* const existMTaskEdgep = static_cast<MTaskEdge*>(
                     recipientp->findConnectingEdgep(GraphWay::REVERSE, relativep));
 #if VL_DEBUG
                 UASSERT(existMTaskEdgep, "findConnectingEdge didn't find edge");
 #endif
-                if (sbp->contains(existMTaskEdgep)) sbp->hintScoreChanged(existMTaskEdgep);
+                existMTaskEdgep->addCommCost(edgep->commCost());
+                if (sbp) {
+                    if (sbp->contains(edgep)) sbp->remove(edgep);
+                    if (sbp->contains(existMTaskEdgep)) sbp->hintScoreChanged(existMTaskEdgep);
+                }
             }
             VL_DO_DANGLING(edgep->unlinkDelete(), edgep);
         } else {
@@ -1829,19 +1864,19 @@ private:
 // DpiImportCallVisitor
 
 // Scan node, indicate whether it contains a call to a DPI imported
-// routine.
+// routine, and the dpi_group of each such routine ("" if none).
 class DpiImportCallVisitor final : public VNVisitor {
 private:
-    bool m_hasDpiHazard = false;  // Found a DPI import call.
+    std::set<string> m_dpiGroups;  // Groups of the DPI import calls found
     bool m_tracingCall = false;  // Iterating into a CCall to a CFunc
     // METHODS
     void visit(AstCFunc* nodep) override {
         if (!m_tracingCall) return;
         m_tracingCall = false;
-        if (nodep->dpiImportWrapper()) {
+        if (nodep->dpiImportWrapper() || nodep->dpiImportPrototype()) {
             if (nodep->pure() ? !v3Global.opt.threadsDpiPure()
                               : !v3Global.opt.threadsDpiUnpure()) {
-                m_hasDpiHazard = true;
+                m_dpiGroups.insert(nodep->dpiGroup());
             }
         }
         iterateChildren(nodep);
@@ -1857,7 +1892,7 @@ private:
 public:
     // CONSTRUCTORS
     explicit DpiImportCallVisitor(AstNode* nodep) { iterate(nodep); }
-    bool hasDpiHazard() const { return m_hasDpiHazard; }
+    const std::set<string>& dpiGroups() const { return m_dpiGroups; }
     ~DpiImportCallVisitor() override = default;
 
 private:
@@ -1952,6 +1987,12 @@ class PartFixDataHazards final {
 private:
     // TYPES
     using TasksByRank = std::map<uint32_t /*rank*/, std::set<LogicMTask*, MTaskIdLessThan>>;
+    struct RankLessThan final {
+        bool operator()(const LogicMTask* lhsp, const LogicMTask* rhsp) const {
+            if (lhsp->rank() != rhsp->rank()) return lhsp->rank() < rhsp->rank();
+            return lhsp->id() < rhsp->id();
+        }
+    };
 
     // MEMBERS
     const OrderGraph* const m_orderGraphp;  // The OrderGraph
@@ -2007,7 +2048,7 @@ private:
             lastRecipientp = recipientp;
         }
     }
-    bool hasDpiHazard(LogicMTask* mtaskp) {
+    void addDpiGroups(LogicMTask* mtaskp, std::set<string>& groups) {
         for (const MTaskMoveVertex* const moveVtxp : *(mtaskp->vertexListp())) {
             if (OrderLogicVertex* const lvtxp = moveVtxp->logicp()) {
                 // NOTE: We don't handle DPI exports. If testbench code calls a
@@ -2018,10 +2059,47 @@ private:
                 // Find all calls to DPI-imported functions, we can put those
                 // into a serial order at least. That should solve the most
                 // likely DPI-related data hazards.
-                if (DpiImportCallVisitor{lvtxp->nodep()}.hasDpiHazard()) return true;
+                const DpiImportCallVisitor visitor{lvtxp->nodep()};
+                groups.insert(visitor.dpiGroups().begin(), visitor.dpiGroups().end());
             }
         }
-        return false;
+    }
+    // Order the MTasks of each DPI group against each other with edges. Unlike merging,
+    // this leaves them free to run in parallel with unrelated MTasks.
+    void orderDpiGroups() {
+        // MTasks calling DPI imports of each group, in rank order
+        std::map<string, std::set<LogicMTask*, RankLessThan>> groupTasks;
+        for (V3GraphVertex* vtxp = m_mtasksp->verticesBeginp(); vtxp;
+             vtxp = vtxp->verticesNextp()) {
+            LogicMTask* const mtaskp = static_cast<LogicMTask*>(vtxp);
+            std::set<string> groups;
+            addDpiGroups(mtaskp, groups);
+            for (const string& group : groups) groupTasks[group].insert(mtaskp);
+        }
+        // Chain each group. All edges go from a lower to a higher (rank, id), per the ranks
+        // before adding any, so no cycle is created.
+        for (const auto& pair : groupTasks) {
+            LogicMTask* lastp = nullptr;
+            for (LogicMTask* const mtaskp : pair.second) {
+                if (lastp && !lastp->hasRelativeMTask(mtaskp)) {
+                    new MTaskEdge{m_mtasksp, lastp, mtaskp, 1};
+                }
+                lastp = mtaskp;
+            }
+        }
+        // Edges between MTasks of the same rank invalidate the ranks, so recompute them
+        rank();
+    }
+    void rank() {
+        GraphStreamUnordered serialize{m_mtasksp};
+        while (LogicMTask* const mtaskp
+               = const_cast<LogicMTask*>(static_cast<const LogicMTask*>(serialize.nextp()))) {
+            uint32_t rank = 0;
+            for (V3GraphEdge* edgep = mtaskp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+                rank = std::max(edgep->fromp()->rank() + 1, rank);
+            }
+            mtaskp->rank(rank);
+        }
     }
 
 public:
@@ -2127,16 +2205,11 @@ public:
         }
 
         // Handle nodes containing DPI calls, we want to serialize those
-        // by default unless user gave --threads-dpi-concurrent.
-        // Same basic strategy as above to serialize access to SC vars.
+        // by default unless user gave --threads-dpi all. Calls are only
+        // ordered against calls in the same dpi_group, as imports in
+        // different groups use unrelated C resources.
         if (!v3Global.opt.threadsDpiPure() || !v3Global.opt.threadsDpiUnpure()) {
-            TasksByRank tasksByRank;
-            for (V3GraphVertex *vtxp = m_mtasksp->verticesBeginp(), *nextp; vtxp; vtxp = nextp) {
-                nextp = vtxp->verticesNextp();
-                LogicMTask* const mtaskp = static_cast<LogicMTask*>(vtxp);
-                if (hasDpiHazard(mtaskp)) tasksByRank[mtaskp->rank()].insert(mtaskp);
-            }
-            mergeSameRankTasks(tasksByRank);
+            orderDpiGroups();
         }
     }
 
@@ -2144,6 +2217,148 @@ private:
     VL_UNCOPYABLE(PartFixDataHazards);
 };
 
+//######################################################################
+// PartPreCoarsen
+
+// Cheap multilevel pre-coarsening of very large MTask graphs, run before
+// PartContraction. Each round computes a greedy matching over the
+// dependency edges and contracts every matched pair, similar to the
+// heavy-edge matching used by multilevel graph partitioners: each MTask is
+// matched along the edge with the highest communication cost, then with the
+// partner that yields the cheapest combined MTask.
+//
+// Only trivially acyclic contractions are performed: 'from' has no other
+// successor, or 'to' has no other predecessor. Neither can create a cycle,
+// and neither needs the critical path bookkeeping, so this pass is linear
+// in the size of the graph per round, while PartContraction is not.
+class PartPreCoarsen final {
+    // CONSTANTS
+    static constexpr size_t MIN_MTASKS = 4096;  // Only pre-coarsen graphs larger than this
+    static constexpr unsigned MAX_ROUNDS = 8;  // Maximum number of matching rounds
+    static constexpr unsigned COST_DIVISOR = 16;  // Merged cost limit is cpLimit / this
+
+    // MEMBERS
+    V3Graph* const m_mtasksp;  // Mtask graph
+    const uint32_t m_costLimit;  // Do not create MTasks more costly than this
+    std::unordered_set<const LogicMTask*> m_matched;  // MTasks merged in the current round
+
+public:
+    // CONSTRUCTORS
+    PartPreCoarsen(V3Graph* mtasksp, uint32_t cpLimit)
+        : m_mtasksp{mtasksp}
+        , m_costLimit{cpLimit / COST_DIVISOR} {}
+
+private:
+    // METHODS
+    // Return the best unmatched successor of 'fromp' that can be safely merged with it
+    LogicMTask* findPartner(LogicMTask* fromp) const {
+        LogicMTask* bestp = nullptr;
+        uint32_t bestCommCost = 0;
+        const bool fromOutSize1 = fromp->outSize1();
+        for (V3GraphEdge* edgep = fromp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+            const uint32_t commCost = static_cast<MTaskEdge*>(edgep)->commCost();
+            LogicMTask* const top = static_cast<MTaskEdge*>(edgep)->toMTaskp();
+            // Never merge into the artificial exit MTask
+            if (top->outEmpty() || m_matched.count(top)) continue;
+            if (!fromOutSize1 && !top->inSize1()) continue;
+            if (fromp->cost() + top->cost() > m_costLimit) continue;
+            if (bestp && commCost < bestCommCost) continue;
+            if (!bestp || commCost > bestCommCost || top->cost() < bestp->cost()
+                || (top->cost() == bestp->cost() && top->id() < bestp->id())) {
+                bestp = top;
+                bestCommCost = commCost;
+            }
+        }
+        return bestp;
+    }
+    void merge(LogicMTask* fromp, LogicMTask* top) {
+        // Merge into the MTask that keeps the existing ranks consistent: if 'fromp' has
+        // no other successor, all its predecessors have lower rank than 'top', otherwise
+        // 'top' has no other predecessor and all its successors have higher rank than 'fromp'.
+        const bool intoTo = fromp->outSize1();
+        LogicMTask* const recipientp = intoTo ? top : fromp;
+        LogicMTask* const donorp = intoTo ? fromp : top;
+        // Remove and free the connecting edge
+        MTaskEdge* const edgep
+            = static_cast<MTaskEdge*>(fromp->findConnectingEdgep(GraphWay::FORWARD, top));
+        fromp->removeRelativeMTask(top);
+        fromp->removeRelativeEdge<GraphWay::FORWARD>(edgep);
+        top->removeRelativeEdge<GraphWay::REVERSE>(edgep);
+        VL_DO_DANGLING(edgep->unlinkDelete(), edgep);
+        // Move all vertices from donorp to recipientp
+        recipientp->moveAllVerticesFrom(donorp);
+        // Redirect edges from donorp to recipientp, delete donorp
+        partRedirectEdgesFrom(m_mtasksp, recipientp, donorp, nullptr);
+    }
+    size_t matchRound() {
+        // Snapshot the MTasks, as merging deletes vertices
+        std::vector<LogicMTask*> mtasks;
+        for (V3GraphVertex* vtxp = m_mtasksp->verticesBeginp(); vtxp;
+             vtxp = vtxp->verticesNextp()) {
+            mtasks.push_back(static_cast<LogicMTask*>(vtxp));
+        }
+        m_matched.clear();
+        size_t merges = 0;
+        for (LogicMTask* const fromp : mtasks) {
+            // Check before dereferencing, matched donors have been deleted
+            if (m_matched.count(fromp)) continue;
+            // Never merge the artificial entry MTask
+            if (fromp->inEmpty()) continue;
+            LogicMTask* const top = findPartner(fromp);
+            if (!top) continue;
+            m_matched.insert(fromp);
+            m_matched.insert(top);
+            merge(fromp, top);
+            ++merges;
+        }
+        return merges;
+    }
+
+public:
+    void go() {
+        size_t nMTasks = 0;
+        for (V3GraphVertex* vtxp = m_mtasksp->verticesBeginp(); vtxp;
+             vtxp = vtxp->verticesNextp()) {
+            ++nMTasks;
+        }
+        for (unsigned round = 0; round < MAX_ROUNDS && nMTasks > MIN_MTASKS; ++round) {
+            const size_t merges = matchRound();
+            UINFO(4, "PartPreCoarsen round " << round << " merged " << merges << " of "
+                                             << nMTasks << " mtasks" << endl);
+            nMTasks -= merges;
+            // Stop when a round no longer shrinks the graph substantially
+            if (merges * 100 < nMTasks) break;
+        }
+    }
+
+    // SELF TESTS
+
+    // A long chain must shrink by about half in each round, until the
+    // graph is no longer considered large.
+    static void selfTest() {
+        V3Graph mtasks;
+        LogicMTask* lastp = nullptr;
+        for (unsigned i = 0; i < 10000; ++i) {
+            LogicMTask* const mtp = new LogicMTask{&mtasks, nullptr};
+            mtp->setCost(1);
+            if (lastp) new MTaskEdge{&mtasks, lastp, mtp, 1};
+            lastp = mtp;
+        }
+        PartPreCoarsen{&mtasks, 64 * COST_DIVISOR}.go();
+
+        PartParallelismEst check{&mtasks};
+        check.traverse();
+        // The chain ends are never merged; round one leaves 5001 MTasks, round two 2502.
+        UASSERT_SELFTEST(uint32_t, check.totalGraphCost(), 10000);
+        UASSERT_SELFTEST(uint32_t, check.longestCritPathCost(), 10000);
+        UASSERT_SELFTEST(size_t, check.vertexCount(), 2502);
+        UASSERT_SELFTEST(size_t, check.edgeCount(), 2501);
+    }
+
+private:
+    VL_UNCOPYABLE(PartPreCoarsen);
+};
+
 //######################################################################
 // ThreadSchedule
 
@@ -2410,7 +2625,12 @@ public:
                     for (V3GraphEdge* edgep = mtaskp->inBeginp(); edgep;
                          edgep = edgep->inNextp()) {
                         const ExecMTask* const priorp = dynamic_cast<ExecMTask*>(edgep->fromp());
-                        const uint32_t priorEndTime = completionTime(schedule, priorp, threadId);
+                        uint32_t priorEndTime = completionTime(schedule, priorp, threadId);
+                        // Data from another thread arrives later, the edge weight is
+                        // 1 + the communication cost, see PART_COMM_COST_PER_LINE
+                        if (schedule.threadId(priorp) != threadId) {
+                            priorEndTime += edgep->weight() - 1;
+                        }
                         if (priorEndTime > timeBegin) timeBegin = priorEndTime;
                     }
                     UINFO(6, "Task " << mtaskp->name() << " start at " << timeBegin
@@ -2639,6 +2859,17 @@ static bool bypassOk(MTaskMoveVertex* mvtxp) {
     return fanIn + fanOut == 4;
 }
 
+static uint32_t partCommCost(const MTaskMoveVertex* mvtxp) {
+    // Cost of communicating the variable of this vertex between threads
+    const OrderVarVertex* const varVtxp = dynamic_cast<const OrderVarVertex*>(mvtxp->varp());
+    if (!varVtxp) return 0;
+    const AstNodeDType* const dtypep = varVtxp->vscp()->varp()->dtypep()->skipRefp();
+    // Compound types are not flat, count their handle only
+    const uint32_t bytes = dtypep->isCompound() ? 1 : dtypep->widthTotalBytes();
+    const uint32_t lines = (bytes + VL_CACHE_LINE_BYTES - 1) / VL_CACHE_LINE_BYTES;
+    return std::min(std::max(lines, 1U), PART_COMM_MAX_LINES) * PART_COMM_COST_PER_LINE;
+}
+
 uint32_t V3Partition::setupMTaskDeps(V3Graph* mtasksp) {
     uint32_t totalGraphCost = 0;
 
@@ -2682,11 +2913,18 @@ uint32_t V3Partition::setupMTaskDeps(V3Graph* mtasksp) {
         MTaskMoveVertex* const mvtxp = mtaskp->vertexListp()->front();
         UASSERT_OBJ(mvtxp->userp(), mtaskp, "Bypassed MTaskMoveVertex should not have MTask");
 
-        // Function to add a edge to a dependent from 'mtaskp'
-        const auto addEdge = [mtasksp, mtaskp](LogicMTask* otherp) {
+        // Dependents of 'mtaskp', with the communication cost to each, in order of discovery
+        std::vector<std::pair<LogicMTask*, uint32_t>> dependents;
+        std::unordered_map<const LogicMTask*, size_t> dependentIndex;
+
+        // Function to add a dependent of 'mtaskp', via the given variable vertex
+        const auto addEdge = [&](LogicMTask* otherp, const V3GraphVertex* varVtxp) {
             UASSERT_OBJ(otherp != mtaskp, mtaskp, "Would create a cycle edge");
-            if (mtaskp->hasRelativeMTask(otherp)) return;  // Don't create redundant edges.
-            new MTaskEdge{mtasksp, mtaskp, otherp, 1};
+            // Don't create redundant edges, but do sum the communication
+            const auto pair = dependentIndex.emplace(otherp, dependents.size());
+            if (pair.second) dependents.emplace_back(otherp, 0);
+            dependents[pair.first->second].second
+                += partCommCost(static_cast<const MTaskMoveVertex*>(varVtxp));
         };
 
         // Iterate downstream direct dependents
@@ -2695,7 +2933,7 @@ uint32_t V3Partition::setupMTaskDeps(V3Graph* mtasksp) {
             V3GraphVertex* const top = dEdgep->top();
             if (LogicMTask* const otherp = static_cast<LogicMTask*>(top->userp())) {
                 // The opposite end of the edge is not a bypassed vertex, add as direct dependent
-                addEdge(otherp);
+                addEdge(otherp, mvtxp->logicp() ? top : mvtxp);
             } else {
                 // The opposite end of the edge is a bypassed vertex, add transitive dependents
                 for (V3GraphEdge *tEdgep = top->outBeginp(), *tNextp; tEdgep; tEdgep = tNextp) {
@@ -2704,10 +2942,14 @@ uint32_t V3Partition::setupMTaskDeps(V3Graph* mtasksp) {
                     // The Move graph is bipartite (logic <-> var), and logic is never bypassed,
                     // hence 'transp' must be non nullptr.
                     UASSERT_OBJ(transp, mvtxp, "This cannot be a bypassed vertex");
-                    addEdge(transp);
+                    addEdge(transp, top);
                 }
             }
         }
+
+        for (const auto& pair : dependents) {
+            new MTaskEdge{mtasksp, mtaskp, pair.first, static_cast<int>(1 + pair.second)};
+        }
     }
 
     // Create Dependencies to/from the entry/exit vertices.
@@ -2749,6 +2991,27 @@ void V3Partition::go(V3Graph* mtasksp) {
         hashGraphDebug(mtasksp, "mtasksp after fixDataHazards()");
     }
 
+    const int targetParFactor = m_threads;
+    if (targetParFactor < 2) v3fatalSrc("We should not reach V3Partition when --threads <= 1");
+
+    // Set cpLimit to roughly totalGraphCost / nThreads
+    //
+    // Actually set it a bit lower, by a hardcoded fudge factor. This
+    // results in more smaller mtasks, which helps reduce fragmentation
+    // when scheduling them.
+    const unsigned fudgeNumerator = 3;
+    const unsigned fudgeDenominator = 5;
+    const uint32_t cpLimit
+        = ((totalGraphCost * fudgeNumerator) / (targetParFactor * fudgeDenominator));
+    UINFO(4, "V3Partition set cpLimit = " << cpLimit << endl);
+
+    // Shrink very large graphs cheaply before the expensive contraction below.
+    if (v3Global.opt.threadsCoarsen()) {
+        PartPreCoarsen{mtasksp, cpLimit}.go();
+        V3Partition::debugMTaskGraphStats(mtasksp, "precoarsen");
+        hashGraphDebug(mtasksp, "mtasksp after PartPreCoarsen");
+    }
+
     // Setup the critical path into and out of each node.
     partInitCriticalPaths(mtasksp);
     hashGraphDebug(mtasksp, "after partInitCriticalPaths()");
@@ -2766,20 +3029,6 @@ void V3Partition::go(V3Graph* mtasksp) {
     // remove this later if it doesn't really help.
     mtasksp->orderPreRanked();
 
-    const int targetParFactor = v3Global.opt.threads();
-    if (targetParFactor < 2) v3fatalSrc("We should not reach V3Partition when --threads <= 1");
-
-    // Set cpLimit to roughly totalGraphCost / nThreads
-    //
-    // Actually set it a bit lower, by a hardcoded fudge factor. This
-    // results in more smaller mtasks, which helps reduce fragmentation
-    // when scheduling them.
-    const unsigned fudgeNumerator = 3;
-    const unsigned fudgeDenominator = 5;
-    const uint32_t cpLimit
-        = ((totalGraphCost * fudgeNumerator) / (targetParFactor * fudgeDenominator));
-    UINFO(4, "V3Partition set cpLimit = " << cpLimit << endl);
-
     // Merge MTask nodes together, repeatedly, until the CP budget is
     // reached.  Coarsens the graph, usually by several orders of
     // magnitude.
@@ -2920,7 +3169,7 @@ void V3Partition::selfTestNormalizeCosts() {
     }
 }
 
-static void fillinCosts(V3Graph* execMTaskGraphp) {
+static void fillinCosts(V3Graph* execMTaskGraphp, std::ostream* costModelOsp) {
     V3UniqueNames m_uniqueNames;  // For generating unique mtask profile hash names
 
     // Pass 1: See what profiling data applies
@@ -2933,7 +3182,16 @@ static void fillinCosts(V3Graph* execMTaskGraphp) {
         mtp->hashName(m_uniqueNames.get(mtp->bodyp()));
 
         // This estimate is 64 bits, but the final mtask graph algorithm needs 32 bits
-        const uint64_t costEstimate = V3InstrCount::count(mtp->bodyp(), false);
+        V3InstrCount::TypeCosts typeCosts;
+        const uint64_t costEstimate = V3InstrCount::count(
+            mtp->bodyp(), false, nullptr, costModelOsp ? &typeCosts : nullptr);
+        if (costModelOsp) {
+            *costModelOsp << "mtask " << mtp->id() << " estimate " << costEstimate;
+            for (const auto& pair : typeCosts) {
+                *costModelOsp << " " << pair.first << ":" << pair.second;
+            }
+            *costModelOsp << "\n";
+        }
         const uint64_t costProfiled
             = V3Config::getProfileData(v3Global.opt.prefix(), mtp->hashName());
         if (costProfiled) {
@@ -3041,35 +3299,147 @@ static void finalizeCosts(V3Graph* execMTaskGraphp) {
     }
 }
 
-static void addMTaskToFunction(const ThreadSchedule& schedule, const uint32_t threadId,
-                               AstCFunc* funcp, const ExecMTask* mtaskp) {
+static void addMTaskStateVar(const string& name, uint32_t nDependencies) {
     AstNodeModule* const modp = v3Global.rootp()->topModulep();
     FileLine* const fl = modp->fileline();
+    AstBasicDType* const mtaskStateDtypep
+        = v3Global.rootp()->typeTablep()->findBasicDType(fl, VBasicDTypeKwd::MTASKSTATE);
+    AstVar* const varp = new AstVar{fl, VVarType::MODULETEMP, name, mtaskStateDtypep};
+    varp->valuep(new AstConst{fl, nDependencies});
+    varp->protect(false);  // Do not protect as we still have references in AstText
+    modp->addStmtsp(varp);
+}
+
+//######################################################################
+// MTaskGuard - with --threads-skip-idle, find the state an mtask reads and
+// writes, so it can be skipped while that state is unchanged
+
+class MTaskGuard final : VNVisitorConst {
+    // CONSTANTS
+    static constexpr uint64_t BYTES_PER_COST = 4;  // Max bytes compared per unit of mtask cost
+
+    // STATE
+    string m_self = "this";  // Self pointer of visited function, as seen from the mtask
+    std::set<string> m_inputs;  // Expressions read
+    std::set<string> m_outputs;  // Expressions written
+    std::map<string, size_t> m_sizes;  // Size of each expression
+    std::set<std::pair<const AstCFunc*, string>> m_visited;  // Functions visited, with m_self
+    bool m_ok = true;  // Can be guarded
+
+    // METHODS
+    // Element type of variable, after removing unpacked array dimensions
+    static const AstNodeDType* elementDTypep(const AstVar* varp) {
+        const AstNodeDType* dtypep = varp->dtypeSkipRefp();
+        while (const AstUnpackArrayDType* const adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
+            dtypep = adtypep->subDTypep()->skipRefp();
+        }
+        return dtypep;
+    }
+    // Variable is plain data that can be copied and compared as bytes
+    static bool isPlainData(const AstVar* varp) {
+        if (varp->isSc() || varp->isStatic() || varp->isIfaceRef()) return false;
+        return elementDTypep(varp)->isIntegralOrPacked();
+    }
+    // Expression for the variable referenced via 'selfPointer' in the visited function
+    string refText(const AstNodeVarRef* refp) const {
+        string self = VString::replaceWord(refp->selfPointer(), "this", m_self);
+        self = VIdProtect::protectWordsIf(VString::replaceWord(self, "this", "vlSelf"),
+                                          refp->protect());
+        return (self == "vlSelf" ? self : "(" + self + ")") + "->" + refp->varp()->nameProtect();
+    }
+    void addRef(const string& text, size_t size, bool read, bool write) {
+        m_sizes.emplace(text, size);
+        if (read) m_inputs.insert(text);
+        if (write) m_outputs.insert(text);
+    }
+    static string argList(const std::set<string>& texts) {
+        string out;
+        for (const string& text : texts) out += (out.empty() ? "" : ", ") + text;
+        return out;
+    }
+
+    // VISITORS
+    void visit(AstVarRef* nodep) override {
+        AstVar* const varp = nodep->varp();
+        // Locals and the constant pool are not state
+        if (varp->isFuncLocal() || nodep->selfPointer().empty()) return;
+        if (!isPlainData(varp)) {
+            m_ok = false;
+            return;
+        }
+        const size_t size = varp->dtypeSkipRefp()->arrayUnpackedElements()
+                            * elementDTypep(varp)->widthAlignBytes();
+        addRef(refText(nodep), size, nodep->access().isReadOrRW(),
+               nodep->access().isWriteOrRW());
+    }
+    void visit(AstCMethodHard* nodep) override {
+        // Triggers are read a word at a time, only those words are inputs
+        const AstVarRef* const refp = VN_CAST(nodep->fromp(), VarRef);
+        const AstConst* const indexp = VN_CAST(nodep->pinsp(), Const);
+        if (nodep->name() == "word" && refp && indexp && refp->varp()->basicp()
+            && refp->varp()->basicp()->keyword() == VBasicDTypeKwd::TRIGGERVEC) {
+            addRef(refText(refp) + ".word(" + cvtToStr(indexp->toUInt()) + "U)",
+                   sizeof(uint64_t), true, false);
+            return;
+        }
+        m_ok = false;
+    }
+    void visit(AstCCall* nodep) override {
+        const AstCFunc* const funcp = nodep->funcp();
+        if (funcp->dpiImportPrototype() || funcp->dpiImportWrapper()
+            || funcp->dpiExportDispatcher() || !nodep->argTypes().empty()) {
+            m_ok = false;
+            return;
+        }
+        iterateChildrenConst(nodep);
+        VL_RESTORER(m_self);
+        m_self = VString::replaceWord(nodep->selfPointer(), "this", m_self);
+        if (!m_visited.emplace(funcp, m_self).second) return;
+        iterateAndNextConstNull(funcp->initsp());
+        iterateAndNextConstNull(funcp->stmtsp());
+        iterateAndNextConstNull(funcp->finalsp());
+    }
+    void visit(AstNode* nodep) override {
+        if (!m_ok) return;
+        // Anything with side effects, or reading state other than variables, must run
+        if (!nodep->isPredictOptimizable() || nodep->isOutputter() || !nodep->isPure()) {
+            m_ok = false;
+            return;
+        }
+        iterateChildrenConst(nodep);
+    }
+
+public:
+    // CONSTRUCTORS
+    explicit MTaskGuard(const ExecMTask* mtaskp) {
+        iterateAndNextConstNull(mtaskp->bodyp()->stmtsp());
+        size_t size = 0;
+        for (const auto& pair : m_sizes) size += pair.second;
+        // Without outputs the mtask does nothing to skip, and comparing must be cheap
+        if (m_outputs.empty() || size > mtaskp->cost() * BYTES_PER_COST) m_ok = false;
+    }
+    ~MTaskGuard() override = default;
+
+    // METHODS
+    bool ok() const { return m_ok; }
+    string inputs() const { return argList(m_inputs); }
+    string outputs() const { return argList(m_outputs); }
+};
+
+static void addMTaskBody(AstCFunc* funcp, const ExecMTask* mtaskp) {
+    FileLine* const fl = v3Global.rootp()->topModulep()->fileline();
 
     // Helper function to make the code a bit more legible
     const auto addStrStmt = [=](const string& stmt) -> void {  //
         funcp->addStmtsp(new AstCStmt{fl, stmt});
     };
 
-    if (const uint32_t nDependencies = schedule.crossThreadDependencies(mtaskp)) {
-        // This mtask has dependencies executed on another thread, so it may block. Create the task
-        // state variable and wait to be notified.
-        const string name = "__Vm_mtaskstate_" + cvtToStr(mtaskp->id());
-        AstBasicDType* const mtaskStateDtypep
-            = v3Global.rootp()->typeTablep()->findBasicDType(fl, VBasicDTypeKwd::MTASKSTATE);
-        AstVar* const varp = new AstVar{fl, VVarType::MODULETEMP, name, mtaskStateDtypep};
-        varp->valuep(new AstConst{fl, nDependencies});
-        varp->protect(false);  // Do not protect as we still have references in AstText
-        modp->addStmtsp(varp);
-        // For now, reference is still via text bashing
-        addStrStmt("vlSelf->" + name + +".waitUntilUpstreamDone(even_cycle);\n");
-    }
-
     if (v3Global.opt.profExec()) {
         const string& id = cvtToStr(mtaskp->id());
         const string& predictStart = cvtToStr(mtaskp->predictStart());
         addStrStmt("VL_EXEC_TRACE_ADD_RECORD(vlSymsp).mtaskBegin(" + id + ", " + predictStart
                    + ");\n");
+        addStrStmt("VL_EXEC_TRACE_ADD_COUNTERS(vlSymsp);\n");
     }
     if (v3Global.opt.profPgo()) {
         // No lock around startCounter, as counter numbers are unique per thread
@@ -3080,8 +3450,24 @@ static void addMTaskToFunction(const ThreadSchedule& schedule, const uint32_t th
     //
     addStrStmt("Verilated::mtaskId(" + cvtToStr(mtaskp->id()) + ");\n");
 
+    // With --threads-skip-idle, skip the mtask while the state it uses is unchanged
+    string guard;  // Guard of the mtask, empty if always run
+    string outputs;  // Outputs recorded by the guard after running the mtask
+    if (v3Global.opt.threadsSkipIdle()) {
+        const MTaskGuard mtaskGuard{mtaskp};
+        if (mtaskGuard.ok()) {
+            guard = "vlSymsp->__Vm_mtaskGuards["
+                    + cvtToStr(v3Global.rootp()->allocNextMTaskGuardID()) + "]";
+            outputs = mtaskGuard.outputs();
+            addStrStmt("if (" + guard + ".inputsChanged(" + mtaskGuard.inputs() + ") || "
+                       + guard + ".outputsChanged(" + outputs + ")) {\n");
+            V3Stats::addStatSum("Optimizations, MTasks guarded by idle check", 1);
+        }
+    }
+
     // Move the actual body of calls to leaf functions into this function
     funcp->addStmtsp(mtaskp->bodyp()->unlinkFrBack());
+    if (!guard.empty()) addStrStmt(guard + ".outputsSave(" + outputs + ");\n}\n");
 
     // Flush message queue
     addStrStmt("Verilated::endOfThreadMTask(vlSymsp->__Vm_evalMsgQp);\n");
@@ -3094,22 +3480,54 @@ static void addMTaskToFunction(const ThreadSchedule& schedule, const uint32_t th
     if (v3Global.opt.profExec()) {
         const string& id = cvtToStr(mtaskp->id());
         const string& predictConst = cvtToStr(mtaskp->cost());
+        addStrStmt("VL_EXEC_TRACE_ADD_COUNTERS(vlSymsp);\n");
         addStrStmt("VL_EXEC_TRACE_ADD_RECORD(vlSymsp).mtaskEnd(" + id + ", " + predictConst
                    + ");\n");
     }
+}
+
+static void addMTaskToFunction(const ThreadSchedule& schedule, const uint32_t threadId,
+                               AstCFunc* funcp, const ExecMTask* mtaskp, const string& suffix,
+                               AstCFunc* bodyFuncp) {
+    FileLine* const fl = v3Global.rootp()->topModulep()->fileline();
+
+    // Helper function to make the code a bit more legible
+    const auto addStrStmt = [=](const string& stmt) -> void {  //
+        funcp->addStmtsp(new AstCStmt{fl, stmt});
+    };
+
+    if (const uint32_t nDependencies = schedule.crossThreadDependencies(mtaskp)) {
+        // This mtask has dependencies executed on another thread, so it may block. Create the task
+        // state variable and wait to be notified.
+        const string name = "__Vm_mtaskstate_" + cvtToStr(mtaskp->id()) + suffix;
+        addMTaskStateVar(name, nDependencies);
+        // For now, reference is still via text bashing
+        addStrStmt("vlSelf->" + name + +".waitUntilUpstreamDone(even_cycle);\n");
+    }
+
+    if (bodyFuncp) {
+        // Body is shared with other schedules
+        AstCCall* const callp = new AstCCall{fl, bodyFuncp};
+        callp->dtypeSetVoid();
+        callp->argTypes("vlSelf, even_cycle");
+        funcp->addStmtsp(callp->makeStmt());
+    } else {
+        addMTaskBody(funcp, mtaskp);
+    }
 
     // For any dependent mtask that's on another thread, signal one dependency completion.
     for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
         const ExecMTask* const nextp = dynamic_cast<ExecMTask*>(edgep->top());
         if (schedule.threadId(nextp) != threadId) {
-            addStrStmt("vlSelf->__Vm_mtaskstate_" + cvtToStr(nextp->id())
+            addStrStmt("vlSelf->__Vm_mtaskstate_" + cvtToStr(nextp->id()) + suffix
                        + ".signalUpstreamDone(even_cycle);\n");
         }
     }
 }
 
-static const std::vector<AstCFunc*> createThreadFunctions(const ThreadSchedule& schedule,
-                                                          const string& tag) {
+static const std::vector<AstCFunc*>
+createThreadFunctions(const ThreadSchedule& schedule, const string& tag, const string& suffix,
+                      const std::unordered_map<const ExecMTask*, AstCFunc*>& bodyFuncps) {
     AstNodeModule* const modp = v3Global.rootp()->topModulep();
     FileLine* const fl = modp->fileline();
 
@@ -3119,7 +3537,7 @@ static const std::vector<AstCFunc*> createThreadFunctions(const ThreadSchedule&
     for (const std::vector<const ExecMTask*>& thread : schedule.threads) {
         if (thread.empty()) continue;
         const uint32_t threadId = schedule.threadId(thread.front());
-        const string name{"__Vthread__" + tag + "__" + cvtToStr(threadId)};
+        const string name{"__Vthread__" + tag + suffix + "__" + cvtToStr(threadId)};
         AstCFunc* const funcp = new AstCFunc{fl, name, nullptr, "void"};
         modp->addStmtsp(funcp);
         funcps.push_back(funcp);
@@ -3134,28 +3552,121 @@ static const std::vector<AstCFunc*> createThreadFunctions(const ThreadSchedule&
 
         // Invoke each mtask scheduled to this thread from the thread function
         for (const ExecMTask* const mtaskp : thread) {
-            addMTaskToFunction(schedule, threadId, funcp, mtaskp);
+            const auto it = bodyFuncps.find(mtaskp);
+            addMTaskToFunction(schedule, threadId, funcp, mtaskp, suffix,
+                               it == bodyFuncps.end() ? nullptr : it->second);
         }
 
         // Unblock the fake "final" mtask when this thread is finished
-        funcp->addStmtsp(new AstCStmt{fl, "vlSelf->__Vm_mtaskstate_final__" + tag
+        funcp->addStmtsp(new AstCStmt{fl, "vlSelf->__Vm_mtaskstate_final__" + tag + suffix
                                               + ".signalUpstreamDone(even_cycle);\n"});
     }
 
     // Create the fake "final" mtask state variable
-    AstBasicDType* const mtaskStateDtypep
-        = v3Global.rootp()->typeTablep()->findBasicDType(fl, VBasicDTypeKwd::MTASKSTATE);
-    AstVar* const varp
-        = new AstVar{fl, VVarType::MODULETEMP, "__Vm_mtaskstate_final__" + tag, mtaskStateDtypep};
-    varp->valuep(new AstConst(fl, funcps.size()));
-    varp->protect(false);  // Do not protect as we still have references in AstText
-    modp->addStmtsp(varp);
+    addMTaskStateVar("__Vm_mtaskstate_final__" + tag + suffix, funcps.size());
 
     return funcps;
 }
 
+static AstCFunc* createDynamicMTaskFunction(const ExecMTask* mtaskp) {
+    AstNodeModule* const modp = v3Global.rootp()->topModulep();
+    FileLine* const fl = modp->fileline();
+    AstCFunc* const funcp = new AstCFunc{fl, mtaskp->cFuncName(), nullptr, "void"};
+    modp->addStmtsp(funcp);
+    funcp->isStatic(true);  // Uses void self pointer, so static and hand rolled
+    funcp->isLoose(true);
+    funcp->entryPoint(true);
+    funcp->argTypes("void* voidSelf, bool even_cycle");
+    return funcp;
+}
+
+static void createDynamicMTaskFunctions(AstExecGraph* const execGraphp) {
+    // With --threads-dynamic, every mtask becomes its own function. The VlThreadPool
+    // runs an mtask once all its upstream mtasks have completed, on whichever
+    // thread gets to it first, so all dependencies are tracked via mtask state.
+    AstNodeModule* const modp = v3Global.rootp()->topModulep();
+    FileLine* const fl = v3Global.rootp()->fileline();
+    const string& tag = execGraphp->name();
+    const V3Graph* const depGraphp = execGraphp->depGraphp();
+
+    // Create all functions first, so they can refer to each other
+    std::unordered_map<const ExecMTask*, AstCFunc*> funcps;
+    for (const V3GraphVertex* vxp = depGraphp->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        const ExecMTask* const mtaskp = static_cast<const ExecMTask*>(vxp);
+        funcps.emplace(mtaskp, createDynamicMTaskFunction(mtaskp));
+    }
+
+    std::vector<AstCFunc*> rootps;
+    uint32_t nSinks = 0;
+    for (const V3GraphVertex* vxp = depGraphp->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        const ExecMTask* const mtaskp = static_cast<const ExecMTask*>(vxp);
+        AstCFunc* const funcp = funcps.at(mtaskp);
+
+        uint32_t nDependencies = 0;
+        for (V3GraphEdge* edgep = mtaskp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+            ++nDependencies;
+        }
+        if (nDependencies) {
+            addMTaskStateVar("__Vm_mtaskstate_" + cvtToStr(mtaskp->id()), nDependencies);
+        } else {
+            rootps.push_back(funcp);
+        }
+
+        // Setup vlSelf and vlSyms
+        funcp->addStmtsp(new AstCStmt{fl, EmitCBase::voidSelfAssign(modp)});
+        funcp->addStmtsp(new AstCStmt{fl, EmitCBase::symClassAssign()});
+
+        addMTaskBody(funcp, mtaskp);
+
+        // Signal each downstream mtask, and make it ready if this was its last dependency
+        for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+            const ExecMTask* const nextp = static_cast<ExecMTask*>(edgep->top());
+            AstCStmt* const stmtp = new AstCStmt{
+                fl, new AstText{fl,
+                                "if (vlSelf->__Vm_mtaskstate_" + cvtToStr(nextp->id())
+                                    + ".signalUpstreamDone(even_cycle)) {\n"
+                                    + "vlSymsp->__Vm_threadPoolp->pushTask(",
+                                /* tracking: */ true}};
+            stmtp->addExprsp(new AstAddrOfCFunc{fl, funcps.at(nextp)});
+            stmtp->addExprsp(new AstText{fl, ");\n}\n", /* tracking: */ true});
+            funcp->addStmtsp(stmtp);
+        }
+        // Sinks unblock the fake "final" mtask
+        if (mtaskp->outEmpty()) {
+            ++nSinks;
+            funcp->addStmtsp(new AstCStmt{fl, "vlSelf->__Vm_mtaskstate_final__" + tag
+                                                  + ".signalUpstreamDone(even_cycle);\n"});
+        }
+    }
+    UASSERT(!rootps.empty() && nSinks, "Non-empty ExecGraph yields no roots or sinks?");
+
+    // Create the fake "final" mtask state variable
+    addMTaskStateVar("__Vm_mtaskstate_final__" + tag, nSinks);
+
+    // Execute the graph at the point this AstExecGraph is located in the tree
+    execGraphp->addStmtsp(new AstCStmt{fl, "vlSymsp->__Vm_even_cycle__" + tag
+                                               + " = !vlSymsp->__Vm_even_cycle__" + tag
+                                               + ";\n"});
+    AstCStmt* const stmtp = new AstCStmt{
+        fl, new AstText{fl,
+                        "vlSymsp->__Vm_threadPoolp->executeDynamic(vlSelf, "
+                        "vlSymsp->__Vm_even_cycle__"
+                            + tag + ", vlSelf->__Vm_mtaskstate_final__" + tag + ", {",
+                        /* tracking: */ true}};
+    for (AstCFunc* const rootp : rootps) {
+        if (rootp != rootps.front()) stmtp->addExprsp(new AstText{fl, ", ", true});
+        stmtp->addExprsp(new AstAddrOfCFunc{fl, rootp});
+    }
+    stmtp->addExprsp(new AstText{fl, "});\n", /* tracking: */ true});
+    execGraphp->addStmtsp(stmtp);
+    execGraphp->addStmtsp(new AstCStmt{fl, "Verilated::mtaskId(0);\n"});
+}
+
 static void addThreadStartToExecGraph(AstExecGraph* const execGraphp,
-                                      const std::vector<AstCFunc*>& funcps) {
+                                      const std::vector<AstCFunc*>& funcps, const string& suffix,
+                                      const string& evenCycle) {
     // FileLine used for constructing nodes below
     FileLine* const fl = v3Global.rootp()->fileline();
     const string& tag = execGraphp->name();
@@ -3168,29 +3679,108 @@ static void addThreadStartToExecGraph(AstExecGraph* const execGraphp,
         execGraphp->addStmtsp(new AstText{fl, text, /* tracking: */ true});
     };
 
-    addStrStmt("vlSymsp->__Vm_even_cycle__" + tag + " = !vlSymsp->__Vm_even_cycle__" + tag
-               + ";\n");
-
     const uint32_t last = funcps.size() - 1;
+    // With a thread pool shared between contexts, reserve the workers used
+    if (last) addStrStmt("vlSymsp->__Vm_threadPoolp->lease(" + cvtToStr(last) + ");\n");
     for (uint32_t i = 0; i <= last; ++i) {
         AstCFunc* const funcp = funcps.at(i);
         if (i != last) {
             // The first N-1 will run on the thread pool.
             addTextStmt("vlSymsp->__Vm_threadPoolp->workerp(" + cvtToStr(i) + ")->addTask(");
             execGraphp->addStmtsp(new AstAddrOfCFunc{fl, funcp});
-            addTextStmt(", vlSelf, vlSymsp->__Vm_even_cycle__" + tag + ");\n");
+            addTextStmt(", vlSelf, " + evenCycle + ");\n");
         } else {
             // The last will run on the main thread.
             AstCCall* const callp = new AstCCall{fl, funcp};
             callp->dtypeSetVoid();
-            callp->argTypes("vlSelf, vlSymsp->__Vm_even_cycle__" + tag);
+            callp->argTypes("vlSelf, " + evenCycle);
             execGraphp->addStmtsp(callp->makeStmt());
             addStrStmt("Verilated::mtaskId(0);\n");
         }
     }
 
-    addStrStmt("vlSelf->__Vm_mtaskstate_final__" + tag
-               + ".waitUntilUpstreamDone(vlSymsp->__Vm_even_cycle__" + tag + ");\n");
+    addStrStmt("vlSelf->__Vm_mtaskstate_final__" + tag + suffix + ".waitUntilUpstreamDone("
+               + evenCycle + ");\n");
+    if (last) addStrStmt("vlSymsp->__Vm_threadPoolp->unlease();\n");
+}
+
+static std::unordered_map<const ExecMTask*, AstCFunc*>
+createMTaskBodyFunctions(AstExecGraph* const execGraphp) {
+    // With --threads-schedules, every schedule calls the same function for an mtask,
+    // rather than each having its own copy of the body
+    AstNodeModule* const modp = v3Global.rootp()->topModulep();
+    FileLine* const fl = v3Global.rootp()->fileline();
+    std::unordered_map<const ExecMTask*, AstCFunc*> funcps;
+    for (const V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        const ExecMTask* const mtaskp = static_cast<const ExecMTask*>(vxp);
+        AstCFunc* const funcp = createDynamicMTaskFunction(mtaskp);
+        funcp->entryPoint(false);  // Only called from the thread functions
+        funcp->addStmtsp(new AstCStmt{fl, EmitCBase::voidSelfAssign(modp)});
+        funcp->addStmtsp(new AstCStmt{fl, EmitCBase::symClassAssign()});
+        addMTaskBody(funcp, mtaskp);
+        funcps.emplace(mtaskp, funcp);
+    }
+    return funcps;
+}
+
+static void
+addAlternativeSchedules(AstExecGraph* const execGraphp, const ThreadSchedule& schedule,
+                        const std::vector<AstCFunc*>& funcps,
+                        const std::unordered_map<const ExecMTask*, AstCFunc*>& bodyFuncps) {
+    // Create up to --threads-schedules alternative schedules of the graph, and
+    // let the VlScheduleSelector pick the fastest at run time. The alternatives
+    // vary the padding at cross-thread dependencies (see PartPackMTasks), then
+    // use fewer threads, which can win when threads contend for CPUs.
+    FileLine* const fl = v3Global.rootp()->fileline();
+    const string& tag = execGraphp->name();
+    const V3Graph* const depGraphp = execGraphp->depGraphp();
+    const string selector = "vlSymsp->__Vm_schedule__" + tag;
+    const string evenCycle = selector + ".evenCycle()";
+    static constexpr unsigned sandbags[] = {30, 0, 100};
+
+    // Keep the start times predicted for the main schedule, used for profiling
+    std::unordered_map<const ExecMTask*, uint64_t> predictStarts;
+    for (const V3GraphVertex* vxp = depGraphp->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        const ExecMTask* const mtaskp = static_cast<const ExecMTask*>(vxp);
+        predictStarts.emplace(mtaskp, mtaskp->predictStart());
+    }
+
+    AstText* const switchp = new AstText{fl, "", /* tracking: */ true};
+    execGraphp->addStmtsp(switchp);
+    execGraphp->addStmtsp(new AstText{fl, "case 0: {\n", true});
+    addThreadStartToExecGraph(execGraphp, funcps, "", evenCycle);
+    execGraphp->addStmtsp(new AstText{fl, "break;\n}\n", true});
+
+    std::vector<std::vector<std::vector<const ExecMTask*>>> packed{schedule.threads};
+    const uint32_t nThreads = v3Global.opt.threads();
+    for (uint32_t i = 1; i < static_cast<uint32_t>(v3Global.opt.threadsSchedules()); ++i) {
+        const uint32_t nUsed = i / 3 < nThreads ? nThreads - i / 3 : 1;
+        const ThreadSchedule& alternative
+            = PartPackMTasks{nUsed, sandbags[i % 3]}.pack(*depGraphp);
+        // Skip alternatives identical to earlier schedules
+        if (std::find(packed.begin(), packed.end(), alternative.threads) != packed.end()) {
+            continue;
+        }
+        const string suffix = "__s" + cvtToStr(packed.size());
+        execGraphp->addStmtsp(
+            new AstText{fl, "case " + cvtToStr(packed.size()) + ": {\n", true});
+        packed.push_back(alternative.threads);
+        addThreadStartToExecGraph(
+            execGraphp, createThreadFunctions(alternative, tag, suffix, bodyFuncps), suffix,
+            evenCycle);
+        execGraphp->addStmtsp(new AstText{fl, "break;\n}\n", true});
+    }
+    UINFO(4, "ExecGraph " << tag << " has " << packed.size() << " schedules" << endl);
+
+    switchp->text("switch (" + selector + ".begin(vlSymsp->_vm_contextp__, "
+                  + cvtToStr(packed.size()) + ")) {\ndefault:\n");
+    execGraphp->addStmtsp(new AstText{fl, "}\n" + selector + ".end();\n", true});
+
+    for (const auto& pair : predictStarts) {
+        const_cast<ExecMTask*>(pair.first)->predictStart(pair.second);
+    }
 }
 
 static void implementExecGraph(AstExecGraph* const execGraphp) {
@@ -3201,24 +3791,70 @@ static void implementExecGraph(AstExecGraph* const execGraphp) {
     // and determine the order in which each thread will runs its mtasks.
     const ThreadSchedule& schedule = PartPackMTasks{}.pack(*execGraphp->depGraphp());
 
+    // With dynamic scheduling the static schedule is only used for the predicted start times
+    if (v3Global.opt.threadsDynamic()) {
+        createDynamicMTaskFunctions(execGraphp);
+        return;
+    }
+
+    // With multiple schedules, the mtask bodies are moved into functions shared by all of them
+    std::unordered_map<const ExecMTask*, AstCFunc*> bodyFuncps;
+    if (v3Global.opt.threadsSchedules() > 1) bodyFuncps = createMTaskBodyFunctions(execGraphp);
+
     // Create a function to be run by each thread. Note this moves all AstMTaskBody nodes form the
     // AstExecGrap into the AstCFunc created
-    const std::vector<AstCFunc*>& funcps = createThreadFunctions(schedule, execGraphp->name());
+    const std::vector<AstCFunc*>& funcps
+        = createThreadFunctions(schedule, execGraphp->name(), "", bodyFuncps);
     UASSERT(!funcps.empty(), "Non-empty ExecGraph yields no threads?");
 
+    // Record which thread pool worker runs each mtask, the last thread runs on the eval thread.
+    // (Used to place variables near the threads using them, see V3EmitCSyms.)
+    std::vector<int> workerIds(schedule.threads.size(), ExecMTask::THREAD_NONE);
+    size_t nextWorkerId = 0;
+    for (size_t i = 0; i < schedule.threads.size(); ++i) {
+        if (schedule.threads[i].empty()) continue;
+        ++nextWorkerId;
+        workerIds[i] = nextWorkerId == funcps.size() ? ExecMTask::THREAD_EVAL
+                                                     : static_cast<int>(nextWorkerId - 1);
+    }
+    for (V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        ExecMTask* const mtaskp = static_cast<ExecMTask*>(vxp);
+        mtaskp->threadId(workerIds.at(schedule.threadId(mtaskp)));
+    }
+
     // Start the thread functions at the point this AstExecGraph is located in the tree.
-    addThreadStartToExecGraph(execGraphp, funcps);
+    if (v3Global.opt.threadsSchedules() > 1) {
+        addAlternativeSchedules(execGraphp, schedule, funcps, bodyFuncps);
+        return;
+    }
+    const string& tag = execGraphp->name();
+    FileLine* const fl = v3Global.rootp()->fileline();
+    execGraphp->addStmtsp(new AstCStmt{fl, "vlSymsp->__Vm_even_cycle__" + tag
+                                               + " = !vlSymsp->__Vm_even_cycle__" + tag
+                                               + ";\n"});
+    addThreadStartToExecGraph(execGraphp, funcps, "", "vlSymsp->__Vm_even_cycle__" + tag);
 }
 
 void V3Partition::finalize(AstNetlist* netlistp) {
     // Called by Verilator top stage
+    // With --prof-exec, write the cost estimate of each mtask and what it is made
+    // of, for verilator_gantt --cost-model
+    std::unique_ptr<std::ofstream> costModelOfp;
+    if (v3Global.opt.profExec()) {
+        const string filename = v3Global.opt.makeDir() + "/" + v3Global.opt.prefix()
+                                + "__cost_model.dat";
+        costModelOfp.reset(V3File::new_ofstream(filename));
+        if (costModelOfp->fail()) v3fatal("Can't write " << filename);
+        *costModelOfp << "# Verilator mtask cost estimates, for verilator_gantt --cost-model\n";
+    }
     netlistp->topModulep()->foreach([&](AstExecGraph* execGraphp) {
         // Back in V3Order, we partitioned mtasks using provisional cost
         // estimates. However, V3Order precedes some optimizations (notably
         // V3LifePost) that can change the cost of logic within each mtask.
         // Now that logic is final, recompute the cost and priority of each
         // ExecMTask.
-        fillinCosts(execGraphp->depGraphp());
+        fillinCosts(execGraphp->depGraphp(), costModelOfp.get());
         finalizeCosts(execGraphp->depGraphp());
 
         // Replace the graph body with its multi-threaded implementation.
@@ -3231,4 +3867,5 @@ void V3Partition::selfTest() {
     PartPropagateCpSelfTest::selfTest();
     PartPackMTasks::selfTest();
     PartContraction::selfTest();
+    PartPreCoarsen::selfTest();
 }
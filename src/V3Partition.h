@@ -40,11 +40,13 @@ class V3Partition final {
     // MEMBERS
     const OrderGraph* const m_orderGraphp;  // The OrderGraph
     const V3Graph* const m_fineDepsGraphp;  // Fine-grained dependency graph
+    const uint32_t m_threads;  // Number of threads to partition for
 public:
     // CONSTRUCTORS
-    explicit V3Partition(const OrderGraph* orderGraphp, const V3Graph* fineDepsGraphp)
+    V3Partition(const OrderGraph* orderGraphp, const V3Graph* fineDepsGraphp, uint32_t threads)
         : m_orderGraphp{orderGraphp}
-        , m_fineDepsGraphp{fineDepsGraphp} {}
+        , m_fineDepsGraphp{fineDepsGraphp}
+        , m_threads{threads} {}
     ~V3Partition() = default;
 
     // METHODS
@@ -53,6 +53,11 @@ public:
 };
 
 class ExecMTask final : public AbstractMTask {
+public:
+    // CONSTANTS
+    static constexpr int THREAD_NONE = -2;  // Not statically assigned to a thread
+    static constexpr int THREAD_EVAL = -1;  // Statically assigned to the eval thread
+
 private:
     AstMTaskBody* const m_bodyp;  // Task body
     const uint32_t m_id;  // Unique id of this mtask.
@@ -64,6 +69,7 @@ private:
                           // abstract time units as priority().
     uint64_t m_predictStart = 0;  // Predicted start time of task
     uint64_t m_profilerId = 0;  // VerilatedCounter number for profiling
+    int m_threadId = THREAD_NONE;  // Thread pool worker statically executing this mtask
     VL_UNCOPYABLE(ExecMTask);
 
 public:
@@ -81,6 +87,8 @@ public:
     uint64_t predictStart() const { return m_predictStart; }
     void profilerId(uint64_t id) { m_profilerId = id; }
     uint64_t profilerId() const { return m_profilerId; }
+    void threadId(int id) { m_threadId = id; }
+    int threadId() const { return m_threadId; }
     string cFuncName() const {
         // If this MTask maps to a C function, this should be the name
         return std::string{"__Vmtask"} + "__" + cvtToStr(m_id);
@@ -117,6 +117,7 @@ public:
 
     // Defines list
     DefinesMap m_defines;  ///< Map of defines
+    std::map<const std::string, std::string> m_includeGuards;  ///< File's guard define, or ""
 
     // STATE
     const V3PreProc* m_preprocp = nullptr;  ///< Object we're holding data for
@@ -207,6 +208,7 @@ private:
     string commentCleanup(const string& text);
     bool commentTokenMatch(string& cmdr, const char* strg);
     static string trimWhitespace(const string& strg, bool trailing);
+    static string findIncludeGuard(const string& text);
     void unputString(const string& strg);
     void unputDefrefString(const string& strg);
 
@@ -777,6 +779,16 @@ void V3PreProcImp::openFile(FileLine*, VInFilter* filterp, const string& filenam
     m_lexp->setYYDebug(debug() >= 5);
     V3File::addSrcDepend(filename);
 
+    if (!m_preprocp->isEof() && !v3Global.opt.preprocOnly()) {  // IE an include
+        // A file wholly inside `ifndef GUARD ... `endif produces nothing once GUARD is
+        // defined, so skip reading and lexing headers that are included many times
+        const auto it = m_includeGuards.find(filename);
+        if (it != m_includeGuards.end() && !it->second.empty() && defExists(it->second)) {
+            UINFO(4, "Skip include of " << filename << ", guarded by " << it->second << endl);
+            return;
+        }
+    }
+
     // Read a list<string> with the whole file.
     StrList wholefile;
     const bool ok = filterp->readWholefile(filename, wholefile /*ref*/);
@@ -784,6 +796,11 @@ void V3PreProcImp::openFile(FileLine*, VInFilter* filterp, const string& filenam
         error("File not found: " + filename + "\n");
         return;
     }
+    if (m_includeGuards.find(filename) == m_includeGuards.end()) {
+        string text;
+        for (const string& i : wholefile) text += i;
+        m_includeGuards.emplace(filename, findIncludeGuard(text));
+    }
 
     if (!m_preprocp->isEof()) {  // IE not the first file.
         // We allow the same include file twice, because occasionally it pops
@@ -856,6 +873,86 @@ void V3PreProcImp::openFile(FileLine*, VInFilter* filterp, const string& filenam
     }
 }
 
+string V3PreProcImp::findIncludeGuard(const string& text) {
+    // Return the define of a `ifndef ... `endif enclosing all of text, apart from
+    // whitespace and comments, else "" if the text is not so guarded.
+    const auto isIdChar = [](char c) { return std::isalnum(c) || c == '_' || c == '$'; };
+    const size_t len = text.length();
+    string guard;
+    int depth = 0;  // `ifdef/`ifndef nesting depth
+    bool closed = false;  // Seen the `endif matching the guard
+    size_t pos = 0;
+    while (pos < len) {
+        const char c = text[pos];
+        if (std::isspace(c)) {
+            ++pos;
+        } else if (c == '/' && pos + 1 < len && (text[pos + 1] == '/' || text[pos + 1] == '*')) {
+            const bool blockCmt = text[pos + 1] == '*';
+            size_t end = text.find(blockCmt ? "*/" : "\n", pos + 2);
+            if (end == string::npos) {
+                if (blockCmt) return "";  // Unterminated
+                end = len;
+            } else if (blockCmt) {
+                end += 2;
+            }
+            if (depth == 0) {
+                // Metacomments outside the guard still apply when included again
+                const string cmt = text.substr(pos, end - pos);
+                for (const char* const wordp :
+                     {"verilator", "synopsys", "cadence", "pragma", "ambit"}) {
+                    if (cmt.find(wordp) != string::npos) return "";
+                }
+            }
+            pos = end;
+        } else if (depth == 0 && (closed || c != '`')) {
+            return "";  // Text outside of the guard
+        } else if (c == '"') {
+            for (++pos; pos < len && text[pos] != '"'; ++pos) {
+                if (text[pos] == '\\') ++pos;
+            }
+            ++pos;
+        } else if (c == '\\') {  // Escaped identifier
+            while (pos < len && !std::isspace(text[pos])) ++pos;
+        } else if (c != '`') {
+            ++pos;
+        } else {
+            size_t idEnd = pos + 1;
+            while (idEnd < len && isIdChar(text[idEnd])) ++idEnd;
+            const string directive = text.substr(pos + 1, idEnd - pos - 1);
+            pos = idEnd;
+            if (depth == 0 && directive != "ifndef") return "";
+            if (directive == "ifdef" || directive == "ifndef") {
+                if (depth == 0) {
+                    while (pos < len && (text[pos] == ' ' || text[pos] == '\t')) ++pos;
+                    size_t nameEnd = pos;
+                    while (nameEnd < len && isIdChar(text[nameEnd])) ++nameEnd;
+                    guard = text.substr(pos, nameEnd - pos);
+                    if (guard.empty()) return "";
+                    pos = nameEnd;
+                }
+                ++depth;
+            } else if (directive == "else" || directive == "elsif") {
+                if (depth == 1) return "";  // Guard has an alternative, so is not a guard
+            } else if (directive == "endif") {
+                if (--depth == 0) closed = true;
+            } else if (directive == "define") {
+                // The body may hold any text, up to the end of an unescaped line
+                while (pos < len && text[pos] != '\n') {
+                    if (text[pos] == '\\') {
+                        ++pos;
+                    } else if (text.compare(pos, 2, "/*") == 0) {
+                        const size_t end = text.find("*/", pos + 2);
+                        if (end == string::npos) return "";
+                        pos = end + 1;
+                    }
+                    ++pos;
+                }
+            }
+        }
+    }
+    return closed ? guard : "";
+}
+
 void V3PreProcImp::insertUnreadbackAtBol(const string& text) {
     // Insert insuring we're at the beginning of line, for `line
     // We don't always add a leading newline, as it may result in extra unreadback(newlines).
@@ -55,9 +55,12 @@ private:
     AstTextBlock* m_cHashValuep = nullptr;  // CPP hash value
     AstTextBlock* m_cComboParamsp = nullptr;  // Combo function parameter list
     AstTextBlock* m_cComboInsp = nullptr;  // Combo input copy list
+    AstTextBlock* m_cComboChangesp = nullptr;  // Combo input change detection list
+    AstTextBlock* m_cPrevDeclsp = nullptr;  // Previous combo input value declaration list
     AstTextBlock* m_cComboOutsp = nullptr;  // Combo output copy list
     AstTextBlock* m_cSeqParamsp = nullptr;  // Sequential parameter list
     AstTextBlock* m_cSeqClksp = nullptr;  // Sequential clock copy list
+    AstTextBlock* m_cSeqChangesp = nullptr;  // Sequential clock change detection list
     AstTextBlock* m_cSeqOutsp = nullptr;  // Sequential output copy list
     AstTextBlock* m_cIgnoreParamsp = nullptr;  // Combo ignore parameter list
     const string m_libName;
@@ -324,13 +327,17 @@ private:
         txtp->addText(fl, "#include \"" + m_topName + ".h\"\n");
         txtp->addText(fl, "#include \"verilated_dpi.h\"\n\n");
         txtp->addText(fl, "#include <cstdio>\n");
-        txtp->addText(fl, "#include <cstdlib>\n\n");
+        txtp->addText(fl, "#include <cstdlib>\n");
+        txtp->addText(fl, "#include <cstring>\n\n");
 
         // Verilated module plus sequence number
         addComment(txtp, fl, "Container class to house verilated object and sequence number");
         txtp->addText(fl, "class " + m_topName + "_container: public " + m_topName + " {\n");
         txtp->addText(fl, "public:\n");
         txtp->addText(fl, "long long m_seqnum;\n");
+        txtp->addText(fl, "bool m_evalNeeded__V = true;\n");
+        m_cPrevDeclsp = new AstTextBlock{fl};
+        txtp->addNodesp(m_cPrevDeclsp);
         txtp->addText(fl, m_topName + "_container(const char* scopep__V):\n");
         txtp->addText(fl, m_topName + "(scopep__V) {}\n");
         txtp->addText(fl, "};\n\n");
@@ -372,7 +379,15 @@ private:
         m_cComboInsp = new AstTextBlock{fl, "{\n"};
         castPtr(fl, m_cComboInsp);
         txtp->addNodesp(m_cComboInsp);
-        m_cComboOutsp = new AstTextBlock{fl, "handlep__V->eval();\n"};
+        // Only evaluate when an input changed since the last evaluation, as the parent
+        // calls this whenever the domain of any input triggered, changed or not
+        m_cComboChangesp = new AstTextBlock{fl};
+        txtp->addNodesp(m_cComboChangesp);
+        txtp->addText(fl, "if (handlep__V->m_evalNeeded__V) {\n");
+        txtp->addText(fl, /**/ "handlep__V->m_evalNeeded__V = false;\n");
+        txtp->addText(fl, /**/ "handlep__V->eval();\n");
+        txtp->addText(fl, "}\n");
+        m_cComboOutsp = new AstTextBlock{fl};
         txtp->addNodesp(m_cComboOutsp);
         txtp->addText(fl, "return handlep__V->m_seqnum++;\n");
         txtp->addText(fl, "}\n\n");
@@ -387,7 +402,14 @@ private:
             m_cSeqClksp = new AstTextBlock{fl, "{\n"};
             castPtr(fl, m_cSeqClksp);
             txtp->addNodesp(m_cSeqClksp);
-            m_cSeqOutsp = new AstTextBlock{fl, "handlep__V->eval();\n"};
+            // Edges that do not change the two-state value (e.g. from X) need no evaluation
+            m_cSeqChangesp = new AstTextBlock{fl};
+            txtp->addNodesp(m_cSeqChangesp);
+            txtp->addText(fl, "if (handlep__V->m_evalNeeded__V) {\n");
+            txtp->addText(fl, /**/ "handlep__V->m_evalNeeded__V = false;\n");
+            txtp->addText(fl, /**/ "handlep__V->eval();\n");
+            txtp->addText(fl, "}\n");
+            m_cSeqOutsp = new AstTextBlock{fl};
             txtp->addNodesp(m_cSeqOutsp);
             txtp->addText(fl, "return handlep__V->m_seqnum++;\n");
             txtp->addText(fl, "}\n\n");
@@ -458,6 +480,7 @@ private:
         }
         m_cSeqParamsp->addText(fl, varp->dpiArgType(true, false) + "\n");
         m_cSeqClksp->addText(fl, cInputConnection(varp));
+        addChangeDetection(m_cSeqChangesp, varp);
     }
 
     void handleDataInput(AstVar* varp) {
@@ -469,9 +492,28 @@ private:
         if (m_hasClk) m_comboIgnoreParamsp->addText(fl, varp->name() + "\n");
         m_cComboParamsp->addText(fl, varp->dpiArgType(true, false) + "\n");
         m_cComboInsp->addText(fl, cInputConnection(varp));
+        addChangeDetection(m_cComboChangesp, varp);
         m_cIgnoreParamsp->addText(fl, varp->dpiArgType(true, false) + "\n");
     }
 
+    void addChangeDetection(AstTextBlock* txtp, AstVar* varp) {
+        FileLine* const fl = varp->fileline();
+        if (varp->isString()) {
+            // Not plain data, so no cheap comparison, always evaluate
+            txtp->addText(fl, "handlep__V->m_evalNeeded__V = true;\n");
+            return;
+        }
+        const string prev = "handlep__V->" + varp->name() + "__prev__V";
+        const string cur = "&handlep__V->" + varp->name();
+        m_cPrevDeclsp->addText(fl, "unsigned char " + varp->name() + "__prev__V[sizeof("
+                                       + varp->name() + ")];\n");
+        const string args = "(" + prev + ", " + cur + ", sizeof(" + prev + "))";
+        txtp->addText(fl, "if (std::memcmp" + args + ") {\n");
+        txtp->addText(fl, /**/ "std::memcpy" + args + ";\n");
+        txtp->addText(fl, /**/ "handlep__V->m_evalNeeded__V = true;\n");
+        txtp->addText(fl, "}\n");
+    }
+
     void handleInput(AstVar* varp) { m_modPortsp->addNodesp(varp->cloneTree(false)); }
 
     static void addLocalVariable(AstTextBlock* textp, AstVar* varp, const char* suffix) {
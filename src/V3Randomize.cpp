@@ -170,11 +170,24 @@ private:
         nodep->user2p(varp);
         return varp;
     }
+    static bool hasEnumMember(const AstStructDType* structDtp) {
+        for (const AstMemberDType* memberp = structDtp->membersp(); memberp;
+             memberp = VN_AS(memberp->nextp(), MemberDType)) {
+            const AstNodeDType* const dtypep = memberp->subDTypep()->skipRefp();
+            if (VN_IS(dtypep, EnumDType)) return true;
+            if (const AstStructDType* const subp = VN_CAST(dtypep, StructDType)) {
+                if (hasEnumMember(subp)) return true;
+            }
+        }
+        return false;
+    }
     AstNodeStmt* newRandStmtsp(FileLine* fl, AstNodeVarRef* varrefp, int offset = 0,
                                AstMemberDType* memberp = nullptr) {
-        if (const auto* const structDtp
+        const auto* const structDtp
             = VN_CAST(memberp ? memberp->subDTypep()->skipRefp() : varrefp->dtypep()->skipRefp(),
-                      StructDType)) {
+                      StructDType);
+        // Without enums every bit is free, so fill a packed struct with a single call
+        if (structDtp && (!structDtp->packed() || hasEnumMember(structDtp))) {
             AstNodeStmt* stmtsp = nullptr;
             offset += memberp ? memberp->lsb() : 0;
             for (AstMemberDType* smemberp = structDtp->membersp(); smemberp;
@@ -198,10 +211,13 @@ private:
                 tabRefp->classOrPackagep(v3Global.rootp()->dollarUnitPkgAddp());
                 AstRandRNG* const randp
                     = new AstRandRNG{fl, varrefp->findBasicDType(VBasicDTypeKwd::UINT32)};
-                AstNodeExpr* const moddivp = new AstModDiv{
-                    fl, randp, new AstConst{fl, static_cast<uint32_t>(enumDtp->itemCount())}};
-                moddivp->dtypep(enumDtp);
-                valp = new AstArraySel{fl, tabRefp, moddivp};
+                // Multiply-shift reduction into [0, itemCount), avoiding a division
+                AstNodeExpr* const mulp = new AstMul{
+                    fl, new AstExtend{fl, randp, 64},
+                    new AstConst{fl, AstConst::Unsized64{},
+                                 static_cast<uint64_t>(enumDtp->itemCount())}};
+                mulp->dtypeSetLogicSized(64, VSigning::UNSIGNED);
+                valp = new AstArraySel{fl, tabRefp, new AstSel{fl, mulp, 32, 32}};
             } else {
                 valp = new AstRandRNG{fl,
                                       (memberp ? memberp->dtypep() : varrefp->varp()->dtypep())};
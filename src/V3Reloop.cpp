@@ -27,6 +27,14 @@
 //
 //   Likewise vector assign to the same constant converted to a loop.
 //
+//   Likewise element-wise expressions of other arrays, with all indices
+//   advancing together:
+//
+//      ASSIGN(ARRAYREF(var, #), ADD(ARRAYREF(a, #), ARRAYREF(b, #+C)))
+//
+//   The iterations of created loops are independent, so they are marked
+//   for the C++ compiler to vectorize.
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -53,6 +61,7 @@ private:
     // STATE
     VDouble0 m_statReloops;  // Statistic tracking
     VDouble0 m_statReItems;  // Statistic tracking
+    VDouble0 m_statReloopsElementwise;  // Statistic tracking
     AstCFunc* m_cfuncp = nullptr;  // Current block
 
     std::vector<AstNodeAssign*> m_mgAssignps;  // List of assignments merging
@@ -64,11 +73,59 @@ private:
     const AstNodeVarRef* m_mgVarrefRp = nullptr;  // Parent varref, nullptr = constant
     int64_t m_mgOffset = 0;  // Index offset
     const AstConst* m_mgConstRp = nullptr;  // Parent RHS constant, nullptr = sel
+    const AstNodeExpr* m_mgExprRp = nullptr;  // Parent RHS element-wise expression
+    uint32_t m_mgIndexFirst = 0;  // Index of first assign, which has m_mgExprRp
     uint32_t m_mgIndexLo = 0;  // Merge range
     uint32_t m_mgIndexHi = 0;  // Merge range
 
     // METHODS
 
+    static bool isElementwise(const AstNodeExpr* nodep, const AstVar* lvarp) {
+        // Return true if expression reads only elements of other arrays at constant indices,
+        // and other variables, without side effects
+        bool anySel = false;
+        const bool bad = nodep->exists([&](const AstNode* np) {
+            if (!np->isPure()) return true;
+            if (const AstNodeVarRef* const refp = VN_CAST(np, NodeVarRef)) {
+                return refp->varp() == lvarp || refp->access().isWriteOrRW();
+            }
+            if (const AstArraySel* const selp = VN_CAST(np, ArraySel)) {
+                const AstConst* const bitp = VN_CAST(selp->bitp(), Const);
+                if (!bitp || bitp->width() > 32 || !VN_IS(selp->fromp(), NodeVarRef)) {
+                    return true;
+                }
+                anySel = true;
+            }
+            return false;
+        });
+        return anySel && !bad;
+    }
+    static bool sameElementwise(const AstNode* ap, const AstNode* bp, int64_t delta) {
+        // Return true if the trees are identical, except for array selects at constant
+        // indices, which in 'bp' must be 'delta' more than in 'ap'
+        for (; ap && bp; ap = ap->nextp(), bp = bp->nextp()) {
+            if (ap->type() != bp->type() || ap->dtypep() != bp->dtypep() || !ap->same(bp)) {
+                return false;
+            }
+            if (const AstArraySel* const aselp = VN_CAST(ap, ArraySel)) {
+                const AstArraySel* const bselp = VN_AS(bp, ArraySel);
+                const AstConst* const abitp = VN_AS(aselp->bitp(), Const);
+                const AstConst* const bbitp = VN_CAST(bselp->bitp(), Const);
+                if (!bbitp || bbitp->width() > 32) return false;
+                if (static_cast<int64_t>(bbitp->toUInt()) - abitp->toUInt() != delta) {
+                    return false;
+                }
+                if (!sameElementwise(aselp->fromp(), bselp->fromp(), delta)) return false;
+                continue;
+            }
+            if (!sameElementwise(ap->op1p(), bp->op1p(), delta)) return false;
+            if (!sameElementwise(ap->op2p(), bp->op2p(), delta)) return false;
+            if (!sameElementwise(ap->op3p(), bp->op3p(), delta)) return false;
+            if (!sameElementwise(ap->op4p(), bp->op4p(), delta)) return false;
+        }
+        return !ap && !bp;
+    }
+
     static AstVar* findCreateVarTemp(FileLine* fl, AstCFunc* cfuncp) {
         AstVar* varp = VN_AS(cfuncp->user1p(), Var);
         if (!varp) {
@@ -116,6 +173,9 @@ private:
                     fl, new AstVarRef{fl, itp, VAccess::WRITE},
                     new AstAdd{fl, new AstConst{fl, 1}, new AstVarRef{fl, itp, VAccess::READ}}};
                 AstWhile* const whilep = new AstWhile{fl, condp, nullptr, incp};
+                // Right hand sides never read the left hand side array, so the iterations
+                // are independent
+                whilep->independent(true);
                 initp->addNext(whilep);
                 bodyp->replaceWith(initp);
                 whilep->addStmtsp(bodyp);
@@ -133,6 +193,26 @@ private:
                     rbitp->replaceWith(m_mgOffset < 0 ? new AstAdd{fl, rvrefp, offsetp} : rvrefp);
                     VL_DO_DANGLING(rbitp->deleteTree(), lbitp);
                 }
+                if (m_mgExprRp) {  // Index every array select relative to the loop index
+                    ++m_statReloopsElementwise;
+                    std::vector<AstConst*> rbitps;
+                    bodyp->rhsp()->foreach([&](AstArraySel* selp) {
+                        rbitps.push_back(VN_AS(selp->bitp(), Const));
+                    });
+                    for (AstConst* const rbitp : rbitps) {
+                        const int64_t delta = static_cast<int64_t>(rbitp->toUInt())
+                                              - static_cast<int64_t>(m_mgIndexFirst);
+                        const uint32_t absDelta = static_cast<uint32_t>(std::abs(delta));
+                        AstNodeExpr* newp = new AstVarRef{fl, itp, VAccess::READ};
+                        if (delta > 0) {
+                            newp = new AstAdd{fl, newp, new AstConst{fl, absDelta}};
+                        } else if (delta < 0) {
+                            newp = new AstSub{fl, newp, new AstConst{fl, absDelta}};
+                        }
+                        rbitp->replaceWith(newp);
+                        VL_DO_DANGLING(rbitp->deleteTree(), rbitp);
+                    }
+                }
                 if (debug() >= 9) initp->dumpTree("-  new: ");
                 if (debug() >= 9) whilep->dumpTree("-  new: ");
 
@@ -151,6 +231,7 @@ private:
             m_mgVarrefRp = nullptr;
             m_mgOffset = 0;
             m_mgConstRp = nullptr;
+            m_mgExprRp = nullptr;
         }
     }
 
@@ -190,12 +271,13 @@ private:
             return;
         }
 
-        // RHS is a constant or a select
+        // RHS is a constant, a select, or an element-wise expression
         const AstConst* const rconstp = VN_CAST(nodep->rhsp(), Const);
         const AstNodeSel* const rselp = VN_CAST(nodep->rhsp(), NodeSel);
+        const AstNodeExpr* rexprp = nullptr;
         const AstNodeVarRef* rvarrefp = nullptr;
         uint32_t rindex = lindex;
-        if (rconstp) {  // Ok
+        if (rconstp || rexprp) {  // Ok
         } else if (rselp) {
             const AstConst* const rbitp = VN_CAST(rselp->bitp(), Const);
             rvarrefp = VN_CAST(rselp->fromp(), NodeVarRef);
@@ -204,6 +286,8 @@ private:
                 return;
             }
             rindex = rbitp->toUInt();
+        } else if (isElementwise(nodep->rhsp(), lvarrefp->varp())) {
+            rexprp = nodep->rhsp();
         } else {
             mergeEnd();
             return;
@@ -215,9 +299,14 @@ private:
                 && m_mgVarrefLp->same(lvarrefp)  // Same array on left hand side
                 && (m_mgConstRp  // On the right hand side either ...
                         ? (rconstp && m_mgConstRp->same(rconstp))  // ... same constant
+                    : m_mgExprRp  // ... or same expression, with indices offset as on the left
+                        ? (rexprp
+                           && sameElementwise(m_mgExprRp, rexprp,
+                                              static_cast<int64_t>(lindex) - m_mgIndexFirst))
                         : (rselp && m_mgVarrefRp->same(rvarrefp)))  // ... or same array
                 && (lindex == m_mgIndexLo - 1 || lindex == m_mgIndexHi + 1)  // Left index +/- 1
-                && (m_mgConstRp || lindex == rindex + m_mgOffset)  // Same right index offset
+                && (m_mgConstRp || m_mgExprRp
+                    || lindex == rindex + m_mgOffset)  // Same right index offset
             ) {
                 // Sequentially next to last assign; continue merge
                 if (lindex == m_mgIndexLo - 1) {
@@ -249,6 +338,8 @@ private:
         m_mgVarrefRp = rvarrefp;
         m_mgOffset = static_cast<int64_t>(lindex) - static_cast<int64_t>(rindex);
         m_mgConstRp = rconstp;
+        m_mgExprRp = rexprp;
+        m_mgIndexFirst = lindex;
         m_mgIndexLo = lindex;
         m_mgIndexHi = lindex;
         UINFO(9, "Start merge i=" << lindex << " o=" << m_mgOffset << nodep << endl);
@@ -264,6 +355,7 @@ public:
     ~ReloopVisitor() override {
         V3Stats::addStat("Optimizations, Reloops", m_statReloops);
         V3Stats::addStat("Optimizations, Reloop iterations", m_statReItems);
+        V3Stats::addStat("Optimizations, Reloops element-wise", m_statReloopsElementwise);
     }
 };
 
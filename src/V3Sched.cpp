@@ -43,6 +43,7 @@
 #include "V3Ast.h"
 #include "V3EmitCBase.h"
 #include "V3EmitV.h"
+#include "V3InstrCount.h"
 #include "V3Order.h"
 #include "V3SenExprBuilder.h"
 #include "V3Stats.h"
@@ -97,6 +98,15 @@ AstAssign* setVar(AstVarScope* vscp, uint32_t val) {
     return new AstAssign{flp, refp, valp};
 };
 
+AstAssign* incrementVar(AstVarScope* vscp) {
+    FileLine* const flp = vscp->fileline();
+    AstVarRef* const wrefp = new AstVarRef{flp, vscp, VAccess::WRITE};
+    AstVarRef* const rrefp = new AstVarRef{flp, vscp, VAccess::READ};
+    AstConst* const onep = new AstConst{flp, AstConst::DTyped{}, vscp->dtypep()};
+    onep->num().setLong(1);
+    return new AstAssign{flp, wrefp, new AstAdd{flp, rrefp, onep}};
+}
+
 void remapSensitivities(const LogicByScope& lbs,
                         std::unordered_map<const AstSenTree*, AstSenTree*> senTreeMap) {
     for (const auto& pair : lbs) {
@@ -116,6 +126,23 @@ void invertAndMergeSenTreeMap(
     }
 }
 
+//============================================================================
+// Number of threads to partition the logic of a region other than 'nba' for,
+// or 0 to evaluate it serially. Regions are only worth evaluating in
+// parallel if they have enough logic to amortize the thread synchronization.
+
+uint32_t regionThreads(const std::vector<const LogicByScope*>& lbsps) {
+    if (!v3Global.opt.mtasks() || !v3Global.opt.threadsRegionCost()) return 0;
+    uint64_t cost = 0;
+    for (const LogicByScope* const lbsp : lbsps) {
+        lbsp->foreachLogic([&](AstNode* nodep) { cost += V3InstrCount::count(nodep, false); });
+    }
+    const uint64_t threads = std::min<uint64_t>(v3Global.opt.threads(),
+                                                cost / v3Global.opt.threadsRegionCost());
+    UINFO(4, "Region cost " << cost << " allows " << threads << " threads" << endl);
+    return threads >= 2 ? threads : 0;
+}
+
 //============================================================================
 // Split large function according to --output-split-cfuncs
 
@@ -241,17 +268,27 @@ void orderSequentially(AstCFunc* funcp, const LogicByScope& lbs) {
             if (AstNodeProcedure* const procp = VN_CAST(logicp, NodeProcedure)) {
                 if (AstNode* bodyp = procp->stmtsp()) {
                     bodyp->unlinkFrBackWithNext();
-                    // If the process is suspendable, we need a separate function (a coroutine)
+                    // If the process is suspendable, we need a separate function (a coroutine),
+                    // unless it is simple enough to be lowered into a state machine
                     if (procp->isSuspendable()) {
-                        funcp->slow(false);
-                        subFuncp = createNewSubFuncp(scopep);
-                        subFuncp->name(subFuncp->name() + "__" + cvtToStr(scopep->user2Inc()));
-                        subFuncp->rtnType("VlCoroutine");
-                        if (VN_IS(procp, Always)) {
-                            subFuncp->slow(false);
-                            FileLine* const flp = procp->fileline();
-                            bodyp
-                                = new AstWhile{flp, new AstConst{flp, AstConst::BitTrue{}}, bodyp};
+                        const string name
+                            = subFuncp->name() + "__" + cvtToStr(scopep->user2Inc());
+                        AstNode* const startp = VN_IS(procp, Always)
+                                                    ? lowerToStateMachine(scopep, bodyp, name)
+                                                    : nullptr;
+                        if (startp) {
+                            bodyp = startp;
+                        } else {
+                            funcp->slow(false);
+                            subFuncp = createNewSubFuncp(scopep);
+                            subFuncp->name(name);
+                            subFuncp->rtnType("VlCoroutine");
+                            if (VN_IS(procp, Always)) {
+                                subFuncp->slow(false);
+                                FileLine* const flp = procp->fileline();
+                                bodyp = new AstWhile{
+                                    flp, new AstConst{flp, AstConst::BitTrue{}}, bodyp};
+                            }
                         }
                     }
                     subFuncp->addStmtsp(bodyp);
@@ -311,15 +348,29 @@ struct TriggerKit {
     // No VL_UNCOPYABLE(TriggerKit) as causes C++20 errors on MSVC
 
     // Utility that assigns the given index trigger to fire when the given variable is zero
-    void addFirstIterationTriggerAssignment(AstVarScope* counterp, uint32_t index) const {
+    // If 'skipp' is given, the first iteration does not trigger while it is set, and it is
+    // cleared on evaluating the trigger.
+    void addFirstIterationTriggerAssignment(AstVarScope* counterp, uint32_t index,
+                                            AstVarScope* skipp = nullptr) const {
         FileLine* const flp = counterp->fileline();
         AstVarRef* const vrefp = new AstVarRef{flp, m_vscp, VAccess::WRITE};
         AstCMethodHard* const callp = new AstCMethodHard{flp, vrefp, "set"};
         callp->addPinsp(new AstConst{flp, index});
-        callp->addPinsp(
-            new AstEq{flp, new AstVarRef{flp, counterp, VAccess::READ}, new AstConst{flp, 0}});
+        AstNodeExpr* condp
+            = new AstEq{flp, new AstVarRef{flp, counterp, VAccess::READ}, new AstConst{flp, 0}};
+        if (skipp) {
+            AstNodeExpr* const notSkipp
+                = new AstNot{flp, new AstVarRef{flp, skipp, VAccess::READ}};
+            condp = new AstAnd{flp, condp, notSkipp};
+        }
+        callp->addPinsp(condp);
         callp->dtypeSetVoid();
-        m_funcp->stmtsp()->addHereThisAsNext(callp->makeStmt());
+        AstNode* const stmtp = callp->makeStmt();
+        if (skipp) {
+            stmtp->addNext(new AstAssign{flp, new AstVarRef{flp, skipp, VAccess::WRITE},
+                                         new AstConst{flp, AstConst::BitFalse{}}});
+        }
+        m_funcp->stmtsp()->addHereThisAsNext(stmtp);
     }
 
     // Utility to set then clear the dpiExportTrigger trigger
@@ -589,7 +640,8 @@ std::pair<AstVarScope*, AstNodeStmt*> makeEvalLoop(AstNetlist* netlistp, const s
                                                    const string& name, AstVarScope* trigVscp,
                                                    AstCFunc* trigDumpp,
                                                    std::function<AstNodeStmt*()> computeTriggers,
-                                                   std::function<AstNodeStmt*()> makeBody) {
+                                                   std::function<AstNodeStmt*()> makeBody,
+                                                   AstVarScope* evalIterVscp = nullptr) {
     UASSERT_OBJ(trigVscp->dtypep()->basicp()->isTriggerVec(), trigVscp, "Not TRIGGERVEC");
     AstTopScope* const topScopep = netlistp->topScopep();
     AstScope* const scopeTopp = topScopep->scopep();
@@ -602,6 +654,15 @@ std::pair<AstVarScope*, AstNodeStmt*> makeEvalLoop(AstNetlist* netlistp, const s
     nodep->addNext(buildLoop(netlistp, tag, [&](AstVarScope* continuep, AstWhile* loopp) {
         // Compute triggers
         loopp->addStmtsp(computeTriggers());
+        // Record the triggers fired with --prof-exec
+        if (v3Global.opt.profExec()) {
+            AstCStmt* const stmtp = new AstCStmt{
+                flp, new AstText{flp, "VL_EXEC_TRACE_ADD_TRIGGERS(vlSymsp, \"" + tag + "\", ",
+                                 true}};
+            stmtp->addExprsp(new AstVarRef{flp, trigVscp, VAccess::READ});
+            stmtp->addExprsp(new AstText{flp, ");\n", true});
+            loopp->addStmtsp(stmtp);
+        }
         // Invoke body if triggered
         {
             AstVarRef* const refp = new AstVarRef{flp, trigVscp, VAccess::READ};
@@ -636,17 +697,24 @@ std::pair<AstVarScope*, AstNodeStmt*> makeEvalLoop(AstNetlist* netlistp, const s
                 add("\"" + name + " region did not converge.\");\n");
             }
 
-            // Increment iteration count
-            {
-                AstVarRef* const wrefp = new AstVarRef{flp, counterp, VAccess::WRITE};
-                AstVarRef* const rrefp = new AstVarRef{flp, counterp, VAccess::READ};
-                AstConst* const onep = new AstConst{flp, AstConst::DTyped{}, counterp->dtypep()};
-                onep->num().setLong(1);
-                ifp->addThensp(new AstAssign{flp, wrefp, new AstAdd{flp, rrefp, onep}});
+            // Increment iteration count, and the total for this '_eval' call if counted
+            ifp->addThensp(incrementVar(counterp));
+            if (evalIterVscp) ifp->addThensp(incrementVar(evalIterVscp));
+            if (v3Global.opt.runtimeStats()) {
+                const string counter = tag == "stl"   ? "ITER_STL"
+                                       : tag == "ico" ? "ITER_ICO"
+                                       : tag == "act" ? "ITER_ACT"
+                                       : tag == "nba" ? "ITER_NBA"
+                                                      : "ITER_OTHER";
+                const string text = "vlSymsp->_vm_contextp__->stats().add(VerilatedContextStats::"
+                                    + counter + ");\n";
+                ifp->addThensp(new AstCStmt{flp, text});
             }
 
             // Add body
+            if (v3Global.opt.profExec()) ifp->addThensp(profExecSectionPush(flp, tag));
             ifp->addThensp(makeBody());
+            if (v3Global.opt.profExec()) ifp->addThensp(profExecSectionPop(flp));
         }
     }));
 
@@ -690,7 +758,7 @@ void createSettle(AstNetlist* netlistp, AstCFunc* const initFuncp, SenExprBuilde
 
     // Create and the body function
     AstCFunc* const stlFuncp = V3Order::order(
-        netlistp, {&comb, &hybrid}, trigToSen, "stl", false, true,
+        netlistp, {&comb, &hybrid}, trigToSen, "stl", 0, true,
         [=](const AstVarScope*, std::vector<AstSenTree*>& out) { out.push_back(inputChanged); });
     splitCheck(stlFuncp);
 
@@ -719,7 +787,8 @@ void createSettle(AstNetlist* netlistp, AstCFunc* const initFuncp, SenExprBuilde
 // Order the replicated combinational logic to create the 'ico' region
 
 AstNode* createInputCombLoop(AstNetlist* netlistp, AstCFunc* const initFuncp,
-                             SenExprBuilder& senExprBuilder, LogicByScope& logic) {
+                             SenExprBuilder& senExprBuilder, LogicByScope& logic,
+                             AstVarScope* evalIterVscp) {
     // Nothing to do if no combinational logic is sensitive to top level inputs
     if (logic.empty()) return nullptr;
 
@@ -773,7 +842,7 @@ AstNode* createInputCombLoop(AstNetlist* netlistp, AstCFunc* const initFuncp,
 
     // Create and Order the body function
     AstCFunc* const icoFuncp
-        = V3Order::order(netlistp, {&logic}, trigToSen, "ico", false, false,
+        = V3Order::order(netlistp, {&logic}, trigToSen, "ico", regionThreads({&logic}), false,
                          [=](const AstVarScope* vscp, std::vector<AstSenTree*>& out) {
                              AstVar* const varp = vscp->varp();
                              if (varp->isPrimaryInish() || varp->isSigUserRWPublic()) {
@@ -795,15 +864,65 @@ AstNode* createInputCombLoop(AstNetlist* netlistp, AstCFunc* const initFuncp,
             AstCCall* const callp = new AstCCall{icoFuncp->fileline(), icoFuncp};
             callp->dtypeSetVoid();
             return callp->makeStmt();
-        });
+        },
+        evalIterVscp);
+
+    // With SystemC the model synchronizes the inputs itself, so the application cannot know
+    // they are unchanged. Otherwise, the first iteration can be skipped via the model API.
+    AstVarScope* inputsUnchangedVscp = nullptr;
+    if (!v3Global.opt.systemC()) {
+        AstScope* const scopeTopp = netlistp->topScopep()->scopep();
+        inputsUnchangedVscp = scopeTopp->createTemp("__VicoInputsUnchanged", 1);
+        inputsUnchangedVscp->varp()->noReset(true);
+        inputsUnchangedVscp->varp()->sigPublic(true);
+        netlistp->inputsUnchangedp(inputsUnchangedVscp->varp());
+        // Not set before the first evaluation
+        FileLine* const flp = inputsUnchangedVscp->fileline();
+        initFuncp->addStmtsp(
+            new AstAssign{flp, new AstVarRef{flp, inputsUnchangedVscp, VAccess::WRITE},
+                          new AstConst{flp, AstConst::BitFalse{}}});
+    }
 
     // Add the first iteration trigger to the trigger computation function
-    trig.addFirstIterationTriggerAssignment(pair.first, firstIterationTrigger);
+    trig.addFirstIterationTriggerAssignment(pair.first, firstIterationTrigger,
+                                            inputsUnchangedVscp);
 
     // Return the eval loop itself
     return pair.second;
 }
 
+//============================================================================
+// The single clock input 'evalCycles' in the model API toggles, or nullptr if
+// the model cannot be advanced by whole clock cycles. With several clock
+// inputs (e.g.: an asynchronous reset), the one marked as 'clocker' is used.
+
+AstVarScope* findCycleClock(AstScope* scopeTopp) {
+    if (v3Global.opt.systemC() || v3Global.usesTiming()) return nullptr;
+    std::vector<AstVarScope*> clocks;
+    std::vector<AstVarScope*> clockers;
+    for (AstVarScope* vscp = scopeTopp->varsp(); vscp; vscp = VN_AS(vscp->nextp(), VarScope)) {
+        const AstVar* const varp = vscp->varp();
+        if (!varp->isPrimaryInish() || varp->isInoutish() || !varp->isUsedClock()) continue;
+        if (varp->width() != 1) continue;
+        clocks.push_back(vscp);
+        if (varp->attrClocker() == VVarAttrClocker::CLOCKER_YES) clockers.push_back(vscp);
+    }
+    if (clocks.size() == 1) return clocks.front();
+    if (clockers.size() == 1) return clockers.front();
+    return nullptr;
+}
+
+bool readsVar(LogicByScope& lbs, const AstVarScope* vscp) {
+    bool reads = false;
+    lbs.foreachLogic([&](AstNode* logicp) {
+        if (reads) return;
+        reads = logicp->exists([&](const AstVarRef* refp) {
+            return refp->varScopep() == vscp && refp->access().isReadOrRW();
+        });
+    });
+    return reads;
+}
+
 //============================================================================
 // Helpers for 'createEval'
 
@@ -839,19 +958,38 @@ AstStmtExpr* createTriggerAndNotCall(FileLine* const flp, AstVarScope* const lhs
 
 void createEval(AstNetlist* netlistp,  //
                 AstNode* icoLoop,  //
+                AstVarScope* evalIterVscp,  //
                 const EvalKit& actKit,  //
                 AstVarScope* preTrigsp,  //
                 const EvalKit& nbaKit,  //
                 const EvalKit& obsKit,  //
                 const EvalKit& reactKit,  //
                 AstCFunc* postponedFuncp,  //
-                TimingKit& timingKit  //
+                TimingKit& timingKit,  //
+                AstVarScope* cycleClockVscp,  //
+                bool icoReadsClock  //
 ) {
     FileLine* const flp = netlistp->fileline();
 
     AstCFunc* const funcp = makeTopFunction(netlistp, "_eval", false);
     netlistp->evalp(funcp);
 
+    // '_eval_clock' inverts the cycle clock and then evaluates the model as '_eval' does, but
+    // knowing no other input changed, it skips the ico loop unless that reads the clock
+    AstCFunc* clockFuncp = nullptr;
+    if (cycleClockVscp) {
+        clockFuncp = makeTopFunction(netlistp, "_eval_clock", false);
+        netlistp->evalClockp(clockFuncp);
+        AstVarRef* const rdp = new AstVarRef{flp, cycleClockVscp, VAccess::READ};
+        AstVarRef* const wrp = new AstVarRef{flp, cycleClockVscp, VAccess::WRITE};
+        clockFuncp->addInitsp(new AstAssign{flp, wrp, new AstNot{flp, rdp}});
+        clockFuncp->addStmtsp(setVar(evalIterVscp, 0));
+        if (icoLoop && icoReadsClock) clockFuncp->addStmtsp(icoLoop->cloneTree(true));
+    }
+
+    // Reset the iteration count of this call
+    funcp->addStmtsp(setVar(evalIterVscp, 0));
+
     // Start with the ico loop, if any
     if (icoLoop) funcp->addStmtsp(icoLoop);
 
@@ -895,7 +1033,8 @@ void createEval(AstNetlist* netlistp,  //
                   }
 
                   return resultp;
-              })
+              },
+              evalIterVscp)
               .second;
 
     // Create the NBA eval loop. This uses the Active eval loop in the trigger section.
@@ -920,7 +1059,8 @@ void createEval(AstNetlist* netlistp,  //
                           resultp, createTriggerSetCall(flp, nextVscp, nbaKit.m_vscp));
                   }
                   return resultp;
-              })
+              },
+              evalIterVscp)
               .second;
 
     if (obsKit.m_funcp) {
@@ -945,7 +1085,8 @@ void createEval(AstNetlist* netlistp,  //
                               resultp, createTriggerSetCall(flp, reactKit.m_vscp, obsKit.m_vscp));
                       }
                       return resultp;
-                  })
+                  },
+                  evalIterVscp)
                   .second;
     }
 
@@ -964,21 +1105,139 @@ void createEval(AstNetlist* netlistp,  //
                                auto* const callp = new AstCCall{flp, reactKit.m_funcp};
                                callp->dtypeSetVoid();
                                return callp->makeStmt();
-                           })
+                           },
+                           evalIterVscp)
                            .second;
     }
+    if (clockFuncp) clockFuncp->addStmtsp(topEvalLoopp->cloneTree(true));
     funcp->addStmtsp(topEvalLoopp);
 
     // Add the Postponed eval call
     if (postponedFuncp) {
         AstCCall* const callp = new AstCCall{flp, postponedFuncp};
         callp->dtypeSetVoid();
-        funcp->addStmtsp(callp->makeStmt());
+        AstNodeStmt* const stmtp = callp->makeStmt();
+        if (clockFuncp) clockFuncp->addStmtsp(stmtp->cloneTree(false));
+        funcp->addStmtsp(stmtp);
     }
 }
 
 }  // namespace
 
+//============================================================================
+// Profiling of sections of evaluation with --prof-exec
+
+AstNodeStmt* profExecSectionPush(FileLine* flp, const string& name) {
+    // Hardware counters are sampled after the push and before the pop
+    const string text = "VL_EXEC_TRACE_ADD_RECORD(vlSymsp).sectionPush(\"" + name + "\");\n"
+                        "VL_EXEC_TRACE_ADD_COUNTERS(vlSymsp);\n";
+    return new AstCStmt{flp, text};
+}
+
+AstNodeStmt* profExecSectionPop(FileLine* flp) {
+    return new AstCStmt{flp, "VL_EXEC_TRACE_ADD_COUNTERS(vlSymsp);\n"
+                             "VL_EXEC_TRACE_ADD_RECORD(vlSymsp).sectionPop();\n"};
+}
+
+//============================================================================
+// Find clocks gated as 'clk & en', where 'en' cannot change while 'clk' is
+// high, as with an integrated clock gating (ICG) cell: 'en' is either a latch
+// transparent while 'clk' is low, or is only set on the negedge of 'clk'. The
+// posedge of such a gated clock is then the posedge of 'clk' while 'en' is set,
+// so its trigger can share the edge detection of 'clk' with all other clocks
+// gated from it, leaving one test of the enable per gated clock.
+
+void findGatedClocks(const LogicClasses& logicClasses, SenExprBuilder& senExprBuilder) {
+    // Logic writing each variable, excluding static, initial and final logic
+    std::unordered_map<const AstVarScope*, std::vector<std::pair<const AstActive*, AstNode*>>>
+        writers;
+    for (const LogicByScope* const lbsp :
+         {&logicClasses.m_comb, &logicClasses.m_clocked, &logicClasses.m_hybrid,
+          &logicClasses.m_postponed, &logicClasses.m_observed, &logicClasses.m_reactive}) {
+        for (const auto& pair : *lbsp) {
+            for (AstNode* logicp = pair.second->stmtsp(); logicp; logicp = logicp->nextp()) {
+                logicp->foreach([&](const AstVarRef* refp) {
+                    if (!refp->access().isWriteOrRW()) return;
+                    auto& vec = writers[refp->varScopep()];
+                    if (vec.empty() || vec.back().second != logicp) {
+                        vec.emplace_back(pair.second, logicp);
+                    }
+                });
+            }
+        }
+    }
+
+    // Single bit variable that is only written by the design
+    const auto isInternalBit = [](const AstVarScope* vscp) {
+        const AstVar* const varp = vscp->varp();
+        return vscp->width() == 1 && VN_IS(vscp->dtypep()->skipRefp(), BasicDType)
+               && !varp->isSigPublic() && !varp->isForceable() && !varp->isWrittenByDpi();
+    };
+    const auto isRefTo = [](const AstNode* nodep, const AstVarScope* vscp) {
+        const AstVarRef* const refp = VN_CAST(nodep, VarRef);
+        return refp && refp->varScopep() == vscp;
+    };
+    // Logic is 'always @(negedge clk)'
+    const auto isNegedgeOf = [&](const AstActive* activep, const AstVarScope* clkp) {
+        const AstSenItem* const senItemp = activep->sensesp()->sensesp();
+        return senItemp && !senItemp->nextp() && senItemp->edgeType() == VEdgeType::ET_NEGEDGE
+               && isRefTo(senItemp->sensp(), clkp);
+    };
+    // Logic is 'always_latch if (!clk) en = ...'
+    const auto isLatchOf = [&](const AstNode* logicp, const AstVarScope* enp,
+                               const AstVarScope* clkp) {
+        const AstAlways* const alwaysp = VN_CAST(logicp, Always);
+        if (!alwaysp || alwaysp->sensesp() || !alwaysp->stmtsp() || alwaysp->stmtsp()->nextp()) {
+            return false;
+        }
+        const AstIf* const ifp = VN_CAST(alwaysp->stmtsp(), If);
+        if (!ifp) return false;
+        const AstNode* bodyp = nullptr;
+        const AstNodeExpr* const condp = ifp->condp();
+        if (!ifp->elsesp() && (VN_IS(condp, Not) || VN_IS(condp, LogNot))
+            && isRefTo(condp->op1p(), clkp)) {
+            bodyp = ifp->thensp();
+        } else if (!ifp->thensp() && isRefTo(condp, clkp)) {
+            bodyp = ifp->elsesp();
+        }
+        const AstAssign* const assignp = VN_CAST(bodyp, Assign);
+        return assignp && !assignp->nextp() && isRefTo(assignp->lhsp(), enp);
+    };
+    // 'en' cannot change while 'clk' is high
+    const auto isStableWhileHigh = [&](const AstVarScope* enp, const AstVarScope* clkp) {
+        const auto it = writers.find(enp);
+        if (it == writers.end() || !isInternalBit(enp)) return false;
+        for (const auto& pair : it->second) {
+            if (!isNegedgeOf(pair.first, clkp) && !isLatchOf(pair.second, enp, clkp)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    size_t nGated = 0;
+    for (const auto& item : writers) {
+        AstVarScope* const gclkp = const_cast<AstVarScope*>(item.first);
+        if (item.second.size() != 1 || !isInternalBit(gclkp)) continue;
+        const AstAssignW* const assignp = VN_CAST(item.second.front().second, AssignW);
+        if (!assignp || !isRefTo(assignp->lhsp(), gclkp)) continue;
+        const AstAnd* const andp = VN_CAST(assignp->rhsp(), And);
+        if (!andp) continue;
+        const AstVarRef* const lhsp = VN_CAST(andp->lhsp(), VarRef);
+        const AstVarRef* const rhsp = VN_CAST(andp->rhsp(), VarRef);
+        if (!lhsp || !rhsp || lhsp->width() != 1 || rhsp->width() != 1) continue;
+        if (isStableWhileHigh(rhsp->varScopep(), lhsp->varScopep())) {
+            senExprBuilder.addGatedClock(gclkp, lhsp->varScopep(), rhsp->varScopep());
+        } else if (isStableWhileHigh(lhsp->varScopep(), rhsp->varScopep())) {
+            senExprBuilder.addGatedClock(gclkp, rhsp->varScopep(), lhsp->varScopep());
+        } else {
+            continue;
+        }
+        ++nGated;
+    }
+    V3Stats::addStat("Scheduling, gated clocks", nGated);
+}
+
 //============================================================================
 // Top level entry-point to scheduling
 
@@ -1027,6 +1286,7 @@ void schedule(AstNetlist* netlistp) {
     AstTopScope* const topScopep = netlistp->topScopep();
     AstScope* const scopeTopp = topScopep->scopep();
     SenExprBuilder senExprBuilder{scopeTopp};
+    if (v3Global.opt.fClockGate()) findGatedClocks(logicClasses, senExprBuilder);
 
     // Step 4: Create 'settle' region that restores the combinational invariant
     createSettle(netlistp, initp, senExprBuilder, logicClasses);
@@ -1053,9 +1313,20 @@ void schedule(AstNetlist* netlistp) {
         V3Stats::statsStage("sched-replicate");
     }
 
+    // Total number of eval loop iterations in the last '_eval' call, read via the model API
+    AstVarScope* const evalIterVscp = scopeTopp->createTemp("__VevalIterCount", 32);
+    evalIterVscp->varp()->noReset(true);
+    evalIterVscp->varp()->sigPublic(true);
+    netlistp->evalIterCountp(evalIterVscp->varp());
+
+    // The clock input advanced by 'evalCycles', if any. Check now if the ico logic reads it,
+    // as that logic is moved under the ico eval function below.
+    AstVarScope* const cycleClockVscp = findCycleClock(scopeTopp);
+    const bool icoReadsClock = cycleClockVscp && readsVar(logicReplicas.m_ico, cycleClockVscp);
+
     // Step 7: Create input combinational logic loop
-    AstNode* const icoLoopp
-        = createInputCombLoop(netlistp, initp, senExprBuilder, logicReplicas.m_ico);
+    AstNode* const icoLoopp = createInputCombLoop(netlistp, initp, senExprBuilder,
+                                                  logicReplicas.m_ico, evalIterVscp);
     if (v3Global.opt.stats()) V3Stats::statsStage("sched-create-ico");
 
     // Step 8: Create the pre/act/nba triggers
@@ -1133,9 +1404,11 @@ void schedule(AstNetlist* netlistp) {
               ? createTriggerSenTree(netlistp, actTrig.m_vscp, dpiExportTriggerIndex)
               : nullptr;
 
+    const uint32_t actThreads
+        = regionThreads({&logicRegions.m_pre, &logicRegions.m_act, &logicReplicas.m_act});
     AstCFunc* const actFuncp = V3Order::order(
         netlistp, {&logicRegions.m_pre, &logicRegions.m_act, &logicReplicas.m_act}, trigToSenAct,
-        "act", false, false, [&](const AstVarScope* vscp, std::vector<AstSenTree*>& out) {
+        "act", actThreads, false, [&](const AstVarScope* vscp, std::vector<AstSenTree*>& out) {
             auto it = actTimingDomains.find(vscp);
             if (it != actTimingDomains.end()) out = it->second;
             if (vscp->varp()->isWrittenByDpi()) out.push_back(dpiExportTriggeredAct);
@@ -1165,7 +1438,8 @@ void schedule(AstNetlist* netlistp) {
 
         const auto& timingDomains = timingKit.remapDomains(trigMap);
         AstCFunc* const funcp = V3Order::order(
-            netlistp, logic, trigToSen, name, name == "nba" && v3Global.opt.mtasks(), false,
+            netlistp, logic, trigToSen, name,
+            name == "nba" && v3Global.opt.mtasks() ? v3Global.opt.threads() : 0, false,
             [&](const AstVarScope* vscp, std::vector<AstSenTree*>& out) {
                 auto it = timingDomains.find(vscp);
                 if (it != timingDomains.end()) out = it->second;
@@ -1216,8 +1490,8 @@ void schedule(AstNetlist* netlistp) {
     auto* const postponedFuncp = createPostponed(netlistp, logicClasses);
 
     // Step 14: Bolt it all together to create the '_eval' function
-    createEval(netlistp, icoLoopp, actKit, preTrigVscp, nbaKit, obsKit, reactKit, postponedFuncp,
-               timingKit);
+    createEval(netlistp, icoLoopp, evalIterVscp, actKit, preTrigVscp, nbaKit, obsKit, reactKit,
+               postponedFuncp, timingKit, cycleClockVscp, icoReadsClock);
 
     transformForks(netlistp);
 
@@ -151,6 +151,10 @@ public:
 // Creates the timing kit and marks variables written by suspendables
 TimingKit prepareTiming(AstNetlist* const netlistp);
 
+// Lowers the body of a simple suspendable always block into a state machine function named
+// after 'name', returning the statements starting the process, or nullptr if not simple enough
+AstNode* lowerToStateMachine(AstScope* const scopep, AstNode* const bodyp, const string& name);
+
 // Transforms fork sub-statements into separate functions
 void transformForks(AstNetlist* const netlistp);
 
@@ -163,6 +167,10 @@ LogicRegions partition(LogicByScope& clockedLogic, LogicByScope& combinationalLo
                        LogicByScope& hybridLogic);
 LogicReplicas replicateLogic(LogicRegions&);
 
+// Statements recording the start and end of a section of evaluation with --prof-exec
+AstNodeStmt* profExecSectionPush(FileLine* flp, const string& name);
+AstNodeStmt* profExecSectionPop(FileLine* flp);
+
 }  // namespace V3Sched
 
 #endif  // Guard
@@ -43,9 +43,11 @@
 #include "V3Global.h"
 #include "V3Graph.h"
 #include "V3Sched.h"
+#include "V3Stats.h"
 
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -103,6 +105,7 @@ public:
     SchedVarVertex(V3Graph* graphp, AstVarScope* vscp)
         : V3GraphVertex{graphp}
         , m_vscp{vscp} {}
+    const AstVarScope* vscp() const { return m_vscp; }
 
     // LCOV_EXCL_START // Debug code
     string name() const override VL_MT_STABLE { return m_vscp->name(); }
@@ -332,6 +335,49 @@ void colorActiveRegion(const V3Graph& graph) {
     }
 }
 
+// Report logic that causes the eval loops to iterate more than once. The triggers are computed
+// before the body of the 'act' and 'nba' regions, so any 'act' logic or NBA update ('nba' region
+// AstAssignPost/AstAlwaysPost) writing a variable read by a sensitivity requires another
+// iteration of the enclosing loop to settle.
+void reportIterationPaths(const V3Graph& graph, const LogicByScope& clockedLogic) {
+    std::unordered_set<const AstVarScope*> trigVscps;
+    size_t nAct = 0;
+    for (V3GraphVertex* vtxp = graph.verticesBeginp(); vtxp; vtxp = vtxp->verticesNextp()) {
+        const SchedVarVertex* const vvtxp = dynamic_cast<SchedVarVertex*>(vtxp);
+        if (!vvtxp) continue;
+        bool isTrigger = false;
+        for (V3GraphEdge* edgep = vtxp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+            if (dynamic_cast<SchedSenVertex*>(edgep->top())) isTrigger = true;
+        }
+        if (!isTrigger) continue;
+        trigVscps.insert(vvtxp->vscp());
+        for (V3GraphEdge* edgep = vtxp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+            const SchedLogicVertex* const lvtxp = dynamic_cast<SchedLogicVertex*>(edgep->fromp());
+            if (!lvtxp) continue;
+            UINFO(3, "Active region re-iterates when writing '"
+                         << vvtxp->vscp()->prettyName() << "' at "
+                         << lvtxp->logicp()->fileline() << endl);
+            ++nAct;
+        }
+    }
+
+    size_t nNba = 0;
+    clockedLogic.foreachLogic([&](AstNode* nodep) {
+        if (!VN_IS(nodep, AssignPost) && !VN_IS(nodep, AlwaysPost)) return;
+        nodep->foreach([&](const AstVarRef* refp) {
+            if (refp->access().isReadOnly()) return;
+            if (!trigVscps.count(refp->varScopep())) return;
+            UINFO(3, "NBA region re-iterates when updating '" << refp->varScopep()->prettyName()
+                                                              << "' at " << nodep->fileline()
+                                                              << endl);
+            ++nNba;
+        });
+    });
+
+    V3Stats::addStat("Scheduling, iteration-inducing logic: Active", nAct);
+    V3Stats::addStat("Scheduling, iteration-inducing logic: NBA", nNba);
+}
+
 }  // namespace
 
 LogicRegions partition(LogicByScope& clockedLogic, LogicByScope& combinationalLogic,
@@ -347,6 +393,9 @@ LogicRegions partition(LogicByScope& clockedLogic, LogicByScope& combinationalLo
     colorActiveRegion(*(graphp.get()));
     if (dumpGraphLevel() >= 6) graphp->dumpDotFilePrefixed("sched-partitioned", true);
 
+    // Report logic that causes re-iteration of the eval loops
+    reportIterationPaths(*(graphp.get()), clockedLogic);
+
     LogicRegions result;
 
     for (V3GraphVertex* vtxp = graphp->verticesBeginp(); vtxp; vtxp = vtxp->verticesNextp()) {
@@ -30,6 +30,11 @@
 // information through it. We then replicate any logic into its additional
 // driving regions.
 //
+// Replicated logic costs both code size and evaluation time, so with --stats
+// we report the number of logic blocks replicated into each region, and for the
+// 'act' and 'nba' regions, the variables whose reads directly cause the
+// replication. These are the variables to look at when trying to avoid it.
+//
 // For more details, please see the internals documentation.
 //
 //*************************************************************************
@@ -41,6 +46,9 @@
 #include "V3Error.h"
 #include "V3Graph.h"
 #include "V3Sched.h"
+#include "V3Stats.h"
+
+#include <map>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
@@ -237,24 +245,66 @@ void propagateDrivingRegions(Vertex* vtxp) {
     vtxp->user(true);
 }
 
+uint8_t targetRegions(const LogicVertex* lvtxp) {
+    return lvtxp->drivingRegions() & ~lvtxp->assignedRegion();
+}
+
 LogicReplicas replicate(Graph* graphp) {
     LogicReplicas result;
+    VDouble0 statReplicas[NBA + 1];  // Number of logic blocks replicated into each region
     for (V3GraphVertex* vtxp = graphp->verticesBeginp(); vtxp; vtxp = vtxp->verticesNextp()) {
         if (LogicVertex* const lvtxp = dynamic_cast<LogicVertex*>(vtxp)) {
-            const auto replicateTo = [&](LogicByScope& lbs) {
+            const auto replicateTo = [&](LogicByScope& lbs, RegionFlags region) {
                 lbs.add(lvtxp->scopep(), lvtxp->senTreep(), lvtxp->logicp()->cloneTree(false));
+                ++statReplicas[region];
             };
-            const uint8_t targetRegions = lvtxp->drivingRegions() & ~lvtxp->assignedRegion();
-            UASSERT(!lvtxp->senTreep()->hasClocked() || targetRegions == 0,
+            const uint8_t regions = targetRegions(lvtxp);
+            UASSERT(!lvtxp->senTreep()->hasClocked() || regions == 0,
                     "replicating clocked logic");
-            if (targetRegions & INPUT) replicateTo(result.m_ico);
-            if (targetRegions & ACTIVE) replicateTo(result.m_act);
-            if (targetRegions & NBA) replicateTo(result.m_nba);
+            if (regions & INPUT) replicateTo(result.m_ico, INPUT);
+            if (regions & ACTIVE) replicateTo(result.m_act, ACTIVE);
+            if (regions & NBA) replicateTo(result.m_nba, NBA);
         }
     }
+    V3Stats::addStat("Scheduling, replicated logic into 'ico'", statReplicas[INPUT]);
+    V3Stats::addStat("Scheduling, replicated logic into 'act'", statReplicas[ACTIVE]);
+    V3Stats::addStat("Scheduling, replicated logic into 'nba'", statReplicas[NBA]);
     return result;
 }
 
+// Report variables written in one of the 'act' or 'nba' regions, whose reads cause
+// logic assigned to the other region to be replicated. Replication into 'ico' is
+// inherent to top level inputs, so is not reported.
+void reportReplicationCauses(Graph* graphp) {
+    // Number of logic blocks replicated due to reads of each variable, sorted by name
+    std::map<string, uint32_t> causes[NBA + 1];
+    for (V3GraphVertex* vtxp = graphp->verticesBeginp(); vtxp; vtxp = vtxp->verticesNextp()) {
+        VarVertex* const vvtxp = dynamic_cast<VarVertex*>(vtxp);
+        if (!vvtxp) continue;
+        // Regions writing this variable directly, as opposed to through other logic
+        uint8_t writingRegions = vvtxp->varp()->isWrittenBySuspendable() ? ACTIVE : NONE;
+        for (V3GraphEdge* edgep = vvtxp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+            writingRegions |= static_cast<LogicVertex*>(edgep->fromp())->assignedRegion();
+        }
+        writingRegions &= ACTIVE | NBA;
+        if (!writingRegions) continue;
+        for (V3GraphEdge* edgep = vvtxp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+            const LogicVertex* const lvtxp = static_cast<LogicVertex*>(edgep->top());
+            const uint8_t regions = targetRegions(lvtxp) & writingRegions;
+            if (regions & ACTIVE) ++causes[ACTIVE][vvtxp->vscp()->prettyName()];
+            if (regions & NBA) ++causes[NBA][vvtxp->vscp()->prettyName()];
+        }
+    }
+    for (const auto& pair : causes[ACTIVE]) {
+        V3Stats::addStat("Scheduling, replicated into 'act' by read of " + pair.first,
+                         pair.second);
+    }
+    for (const auto& pair : causes[NBA]) {
+        V3Stats::addStat("Scheduling, replicated into 'nba' by read of " + pair.first,
+                         pair.second);
+    }
+}
+
 }  // namespace
 
 LogicReplicas replicateLogic(LogicRegions& logicRegionsRegions) {
@@ -268,6 +318,8 @@ LogicReplicas replicateLogic(LogicRegions& logicRegionsRegions) {
     }
     // Dump for debug
     if (dumpGraphLevel() >= 6) graphp->dumpDotFilePrefixed("sched-replicate-propagated");
+    // Report what causes replication
+    if (v3Global.opt.stats()) reportReplicationCauses(graphp.get());
     // Replicate the necessary logic
     return replicate(graphp.get());
 }
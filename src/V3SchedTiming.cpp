@@ -27,9 +27,11 @@
 #include "config_build.h"
 #include "verilatedos.h"
 
+#include "V3Const.h"
 #include "V3EmitCBase.h"
 #include "V3Error.h"
 #include "V3Sched.h"
+#include "V3Stats.h"
 
 #include <unordered_map>
 
@@ -69,11 +71,16 @@ AstCCall* TimingKit::createResume(AstNetlist* const netlistp) {
         m_resumeFuncp->isConst(false);
         m_resumeFuncp->declPrivate(true);
         scopeTopp->addBlocksp(m_resumeFuncp);
+        FileLine* const flp = m_resumeFuncp->fileline();
+        if (v3Global.opt.profExec()) {
+            m_resumeFuncp->addStmtsp(profExecSectionPush(flp, "timing"));
+        }
         for (auto& p : m_lbs) {
             // Put all the timing actives in the resume function
             AstActive* const activep = p.second;
             m_resumeFuncp->addStmtsp(activep);
         }
+        if (v3Global.opt.profExec()) m_resumeFuncp->addStmtsp(profExecSectionPop(flp));
     }
     AstCCall* const callp = new AstCCall{m_resumeFuncp->fileline(), m_resumeFuncp};
     callp->dtypeSetVoid();
@@ -240,6 +247,141 @@ TimingKit prepareTiming(AstNetlist* const netlistp) {
     return {std::move(lbs), postUpdates, std::move(externalDomains)};
 }
 
+//============================================================================
+// Lowers a simple suspendable always block into a state machine function
+
+AstNode* lowerToStateMachine(AstScope* const scopep, AstNode* const bodyp, const string& name) {
+    // Returns the 'delay' call if the statement is just a 'co_await __VdlySched.delay(...)'
+    const auto delayOf = [](AstNode* stmtp) -> AstCMethodHard* {
+        AstStmtExpr* const exprStmtp = VN_CAST(stmtp, StmtExpr);
+        AstCAwait* const awaitp = exprStmtp ? VN_CAST(exprStmtp->exprp(), CAwait) : nullptr;
+        AstCMethodHard* const methodp = awaitp ? VN_CAST(awaitp->exprp(), CMethodHard) : nullptr;
+        if (!methodp || methodp->name() != "delay") return nullptr;
+        const AstBasicDType* const basicp = methodp->fromp()->dtypep()->basicp();
+        return basicp && basicp->isDelayScheduler() ? methodp : nullptr;
+    };
+    // Can the statement (or delay value) run from a plain static function
+    const auto isPlain = [](AstNode* nodep) {
+        return !nodep->exists([](const AstNode* np) {
+            if (const AstNodeVarRef* const refp = VN_CAST(np, NodeVarRef)) {
+                return refp->varp()->isFuncLocal();
+            }
+            return VN_IS(np, CAwait) || VN_IS(np, Fork) || VN_IS(np, CStmt) || VN_IS(np, Var);
+        });
+    };
+
+    // The body must only be plain statements and constant delays between them
+    std::vector<std::vector<AstNode*>> segments(1);  // Statements before each delay, then rest
+    std::vector<AstCMethodHard*> delayps;  // The delay ending each segment
+    for (AstNode* stmtp = bodyp; stmtp; stmtp = stmtp->nextp()) {
+        if (AstCMethodHard* const delayp = delayOf(stmtp)) {
+            if (!isPlain(delayp->pinsp())) return nullptr;
+            delayps.push_back(delayp);
+            segments.emplace_back();
+        } else if (isPlain(stmtp)) {
+            segments.back().push_back(stmtp);
+        } else {
+            return nullptr;
+        }
+    }
+    if (delayps.empty()) return nullptr;
+
+    // Split the body into individual statements
+    for (AstNode *stmtp = bodyp, *nextp; stmtp; stmtp = nextp) {
+        nextp = stmtp->nextp();
+        if (nextp) nextp->unlinkFrBackWithNext();
+    }
+
+    // Create the state machine function, resumed with a void self pointer by the scheduler
+    FileLine* const flp = bodyp->fileline();
+    AstCFunc* const funcp = new AstCFunc{flp, name + "__fsm", scopep};
+    funcp->isStatic(true);
+    funcp->isLoose(true);
+    funcp->entryPoint(true);
+    funcp->isStateMachine(true);
+    funcp->argTypes("void* voidSelf");
+    funcp->addStmtsp(new AstCStmt{flp, EmitCBase::voidSelfAssign(scopep->modp())});
+    funcp->addStmtsp(new AstCStmt{flp, EmitCBase::symClassAssign()});
+    scopep->addBlocksp(funcp);
+
+    // With more than one delay, a state index tells which delay the process is waiting in
+    const size_t nStates = delayps.size();
+    AstVarScope* statep = nullptr;
+    if (nStates > 1) {
+        AstScope* const scopeTopp = v3Global.rootp()->topScopep()->scopep();
+        statep = scopeTopp->createTemp("__V" + name + "__state", 32);
+    }
+
+    // A single constant delay is a periodic process, such as a clock generator. The delay
+    // scheduler resumes these by itself, without rescheduling through its queue each time.
+    bool periodic = false;
+    if (nStates == 1) {
+        AstNodeExpr* const valuep = V3Const::constifyEdit(delayps[0]->pinsp());
+        const AstConst* const constp = VN_CAST(valuep, Const);
+        periodic = constp && !constp->isZero();
+    }
+
+    // Schedule the resumption of the state machine after the given delay, entering 'state'
+    const auto scheduleResume = [&](size_t state) {
+        AstCMethodHard* const delayp = delayps[state];
+        AstCMethodHard* const callp = new AstCMethodHard{
+            flp, delayp->fromp()->cloneTree(false), periodic ? "resumeEvery" : "resumeAfter",
+            delayp->pinsp()->cloneTree(false)};
+        callp->dtypeSetVoid();
+        callp->addPinsp(new AstAddrOfCFunc{flp, funcp});
+        AstCExpr* const selfp = new AstCExpr{flp, "vlSelf", 0};
+        selfp->dtypep(selfp->findCHandleDType());
+        callp->addPinsp(selfp);
+        // Debug info
+        if (AstNode* const infop = delayp->pinsp()->nextp()) {
+            callp->addPinsp(VN_AS(infop, NodeExpr)->cloneTree(true));
+        }
+        AstNode* const stmtsp = callp->makeStmt();
+        if (!statep) return stmtsp;
+        return AstNode::addNext(
+            stmtsp, new AstAssign{flp, new AstVarRef{flp, statep, VAccess::WRITE},
+                                  new AstConst{flp, static_cast<uint32_t>(state)}});
+    };
+
+    // When resumed in state 'k', run the statements after delay 'k' up to the next delay. The
+    // last delay loops back to the first, so the statements before the first are repeated.
+    AstNode* chainp = nullptr;
+    for (size_t k = nStates; k-- > 0;) {
+        const size_t next = (k + 1) % nStates;
+        AstNode* stmtsp = nullptr;
+        for (AstNode* const stmtp : segments[k + 1]) stmtsp = AstNode::addNext(stmtsp, stmtp);
+        if (!next) {
+            for (AstNode* const stmtp : segments[0]) {
+                stmtsp = AstNode::addNext(stmtsp, stmtp->cloneTree(false));
+            }
+        }
+        if (!periodic) stmtsp = AstNode::addNext(stmtsp, scheduleResume(next));
+        if (!chainp) {
+            chainp = stmtsp;
+        } else {
+            AstNodeExpr* const condp
+                = new AstEq{flp, new AstVarRef{flp, statep, VAccess::READ},
+                            new AstConst{flp, static_cast<uint32_t>(k)}};
+            chainp = new AstIf{flp, condp, stmtsp, chainp};
+        }
+    }
+    if (chainp) funcp->addStmtsp(chainp);
+
+    // The process starts by running the statements before the first delay
+    AstNode* startp = nullptr;
+    for (AstNode* const stmtp : segments[0]) startp = AstNode::addNext(startp, stmtp);
+    startp = AstNode::addNext(startp, scheduleResume(0));
+    for (AstCMethodHard* const delayp : delayps) {
+        // Delete the 'co_await' statements
+        AstNode* stmtp = delayp;
+        while (!VN_IS(stmtp, StmtExpr)) stmtp = stmtp->backp();
+        VL_DO_DANGLING(stmtp->deleteTree(), stmtp);
+    }
+    V3Stats::addStatSum("Timing, processes lowered to state machines", 1);
+    if (periodic) V3Stats::addStatSum("Timing, periodic processes", 1);
+    return startp;
+}
+
 //============================================================================
 // Visits all forks and transforms their sub-statements into separate functions.
 
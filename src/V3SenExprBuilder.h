@@ -42,6 +42,9 @@ class SenExprBuilder final {
                                                         // has an update statement in m_preUpdates
     std::unordered_set<VNRef<AstNode>> m_hasPostUpdate;  // Likewise for m_postUpdates
 
+    // Gated clock -> reference to the clock and the enable it is gated from, see addGatedClock
+    std::unordered_map<const AstVarScope*, std::pair<AstVarRef*, AstVarScope*>> m_gatedClocks;
+
     V3UniqueNames m_currNames{"__Vtrigcurrexpr"};  // For generating unique current value
                                                    // signal names
     V3UniqueNames m_prevNames{"__Vtrigprevexpr"};  // Likewise for previous values
@@ -151,6 +154,22 @@ class SenExprBuilder final {
         return prevp;
     }
 
+    // Posedge of a gated clock, computed from its clock, or nullptr if not gated
+    AstNodeExpr* createGatedPosedge(AstNodeExpr* senp) {
+        const AstVarRef* const gclkRefp = VN_CAST(senp, VarRef);
+        if (!gclkRefp) return nullptr;
+        const auto it = m_gatedClocks.find(gclkRefp->varScopep());
+        if (it == m_gatedClocks.end()) return nullptr;
+        FileLine* const flp = senp->fileline();
+        AstVarRef* const clkRefp = it->second.first;
+        AstNodeExpr* const edgep = new AstSel{
+            flp,
+            new AstAnd{flp, getCurr(clkRefp),
+                       new AstNot{flp, new AstVarRef{flp, getPrev(clkRefp), VAccess::READ}}},
+            0, 1};
+        return new AstAnd{flp, edgep, new AstVarRef{flp, it->second.second, VAccess::READ}};
+    }
+
     std::pair<AstNodeExpr*, bool> createTerm(AstSenItem* senItemp) {
         FileLine* const flp = senItemp->fileline();
         AstNodeExpr* const senp = senItemp->sensp();
@@ -174,6 +193,7 @@ class SenExprBuilder final {
         case VEdgeType::ET_BOTHEDGE:  //
             return {lsb(new AstXor{flp, currp(), prevp()}), false};
         case VEdgeType::ET_POSEDGE:  //
+            if (AstNodeExpr* const gatedp = createGatedPosedge(senp)) return {gatedp, false};
             return {lsb(new AstAnd{flp, currp(), new AstNot{flp, prevp()}}), false};
         case VEdgeType::ET_NEGEDGE:  //
             return {lsb(new AstAnd{flp, new AstNot{flp, currp()}, prevp()}), false};
@@ -231,6 +251,13 @@ public:
         return {resultp, firedAtInitialization};
     }
 
+    // Declare 'gclkp' to be 'clkp & enp', where 'enp' does not change while 'clkp' is high, so
+    // the posedge of 'gclkp' is computed as the posedge of 'clkp' while 'enp' is set
+    void addGatedClock(AstVarScope* gclkp, AstVarScope* clkp, AstVarScope* enp) {
+        FileLine* const flp = gclkp->fileline();
+        m_gatedClocks.emplace(gclkp, std::make_pair(new AstVarRef{flp, clkp, VAccess::READ}, enp));
+    }
+
     std::vector<AstNodeStmt*> getAndClearInits() { return std::move(m_inits); }
     std::vector<AstVar*> getAndClearLocals() { return std::move(m_locals); }
 
@@ -247,6 +274,9 @@ public:
     // CONSTRUCTOR
     explicit SenExprBuilder(AstScope* scopep)
         : m_scopep{scopep} {}
+    ~SenExprBuilder() {
+        for (const auto& pair : m_gatedClocks) pair.second.first->deleteTree();
+    }
 };
 
 #endif  // Guard
@@ -21,6 +21,11 @@
 //  splitReorderAll() reorders statements within individual blocks
 //  to avoid delay vars when possible. It no longer splits always blocks.
 //
+//  With --threads, splitAlwaysAll() first also cuts huge combinational
+//  always blocks into chunks of consecutive statements, where no variable
+//  is written in a later chunk than it is accessed, so each chunk only
+//  depends on earlier ones.
+//
 // Both use a common base class, and common graph-building code to reflect
 // data dependencies within an always block (the "scoreboard".)
 //
@@ -85,6 +90,7 @@
 #include "V3Ast.h"
 #include "V3Global.h"
 #include "V3Graph.h"
+#include "V3InstrCount.h"
 #include "V3Stats.h"
 
 #include <algorithm>
@@ -235,6 +241,119 @@ public:
     string dotColor() const override { return "blue"; }
 };
 
+//######################################################################
+// Split huge combinational always blocks into chunks of statements
+
+class SplitCombVisitor final : public VNVisitor {
+    // Combinational blocks costing at least twice this (in V3InstrCount units)
+    // are split into chunks of consecutive statements costing about this much.
+    static constexpr uint64_t CHUNK_COST = 1000;
+
+    // TYPES
+    struct VarAccess final {
+        size_t m_first;  // Index of first statement accessing the variable
+        size_t m_lastWrite = 0;  // Index of last statement writing the variable
+        bool m_written = false;  // Variable is written in the block
+        explicit VarAccess(size_t first)
+            : m_first{first} {}
+    };
+
+    // STATE
+    bool m_inCombo = false;  // Under a combinational AstActive
+    VDouble0 m_statChunks;  // Statistic tracking
+
+    // METHODS
+    void splitBlock(AstAlways* nodep) {
+        std::vector<AstNode*> stmtps;
+        for (AstNode* stmtp = nodep->stmtsp(); stmtp; stmtp = stmtp->nextp()) {
+            stmtps.push_back(stmtp);
+        }
+        if (stmtps.size() < 2) return;
+
+        // Find the statements accessing each variable. Give up on anything
+        // that must stay in order or that V3InstrCount cannot cost.
+        std::unordered_map<const AstVarScope*, VarAccess> accesses;
+        bool splittable = true;
+        for (size_t i = 0; i < stmtps.size(); ++i) {
+            stmtps[i]->foreach([&](AstNode* np) {
+                if (!np->isPure() || np->isTimingControl() || VN_IS(np, AssignDly)
+                    || VN_IS(np, JumpGo) || VN_IS(np, SliceSel) || VN_IS(np, MemberSel)) {
+                    splittable = false;
+                }
+                const AstVarRef* const refp = VN_CAST(np, VarRef);
+                if (!refp || refp->varp()->isConst()) return;
+                VarAccess& access = accesses.emplace(refp->varScopep(), i).first->second;
+                if (refp->access().isWriteOrRW()) {
+                    access.m_written = true;
+                    access.m_lastWrite = i;
+                }
+            });
+            if (!splittable) return;
+        }
+
+        std::vector<uint64_t> costs;
+        uint64_t totalCost = 0;
+        for (AstNode* const stmtp : stmtps) {
+            costs.push_back(V3InstrCount::count(stmtp, false));
+            totalCost += costs.back();
+        }
+        if (totalCost < 2 * CHUNK_COST) return;
+
+        // A cut before statement 'i' is legal when no variable written at or
+        // after 'i' is accessed before 'i'. All dependencies between chunks
+        // then point forward, so the chunks cannot form a combinational loop.
+        // Count the variables forbidding each cut, via a difference vector.
+        std::vector<int> forbidDelta(stmtps.size() + 1, 0);
+        for (const auto& pair : accesses) {
+            const VarAccess& access = pair.second;
+            if (!access.m_written || access.m_lastWrite <= access.m_first) continue;
+            ++forbidDelta[access.m_first + 1];
+            --forbidDelta[access.m_lastWrite + 1];
+        }
+
+        // Greedily cut at the first legal point after each CHUNK_COST
+        std::vector<size_t> cuts;
+        int forbidders = 0;
+        uint64_t chunkCost = 0;
+        uint64_t remainingCost = totalCost;
+        for (size_t i = 0; i < stmtps.size(); ++i) {
+            forbidders += forbidDelta[i];
+            if (!forbidders && chunkCost >= CHUNK_COST && remainingCost >= CHUNK_COST) {
+                cuts.push_back(i);
+                chunkCost = 0;
+            }
+            chunkCost += costs[i];
+            remainingCost -= costs[i];
+        }
+
+        // Move each chunk into its own always block, following the original
+        for (auto it = cuts.crbegin(); it != cuts.crend(); ++it) {
+            AstNode* const headp = stmtps[*it]->unlinkFrBackWithNext();
+            nodep->addNextHere(new AstAlways{nodep->fileline(), nodep->keyword(), nullptr, headp});
+            ++m_statChunks;
+        }
+    }
+
+    // VISITORS
+    void visit(AstActive* nodep) override {
+        VL_RESTORER(m_inCombo);
+        m_inCombo = nodep->hasCombo();
+        iterateChildren(nodep);
+    }
+    void visit(AstAlways* nodep) override {
+        if (m_inCombo && !nodep->sensesp()) splitBlock(nodep);
+    }
+    void visit(AstNodeExpr*) override {}  // Accelerate
+    void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit SplitCombVisitor(AstNetlist* nodep) { iterate(nodep); }
+    ~SplitCombVisitor() override {
+        V3Stats::addStat("Optimizations, Split combinational always chunks", m_statChunks);
+    }
+};
+
 //######################################################################
 // Split class functions
 
@@ -1007,6 +1126,9 @@ void V3Split::splitReorderAll(AstNetlist* nodep) {
 }
 void V3Split::splitAlwaysAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
+    // Huge combinational blocks leave the thread partitioner nothing to work
+    // with, so cut them into chunks, that SplitVisitor may then split further
+    if (v3Global.opt.mtasks()) { SplitCombVisitor{nodep}; }
     { SplitVisitor{nodep}; }  // Destruct before checking
     V3Global::dumpCheckGlobalTree("split", 0, dumpTreeLevel() >= 3);
 }
@@ -15,7 +15,8 @@
 //*************************************************************************
 // V3SplitVar divides a variable into multiple variables to avoid UNOPTFLAT warning
 // and get better performance.
-// Variables to be split must be marked by /*verilator split_var*/ metacomment.
+// Variables to be split must be marked by /*verilator split_var*/ metacomment,
+// or with -fsplit-var-auto, are selected by SplitVarAutoVisitor.
 // There are several kinds of data types that may cause the warning.
 // 1) Unpacked arrays
 // 2) Packed arrays
@@ -86,6 +87,11 @@
 //
 // Two visitor classes are defined here, SplitUnpackedVarVisitor and SplitPackedVarVisitor.
 //
+// With -fsplit-var-auto, SplitVarAutoVisitor runs first and marks packed variables that
+// combinational logic both partially writes and reads, e.g. 'packed_var' above without the
+// metacomment. Such variables are split as if they were marked, but without SPLITVAR warnings
+// if they turn out not to be splittable.
+//
 // - SplitUnpackedVarVisitor class splits unpacked arrays. ( 1) in the explanation above.)
 //   "unpacked_array_var" in the example above is a target of the class.
 //   The class changes AST from "Original" to "Intermediate".
@@ -231,6 +237,7 @@ struct SplitVarImpl {
 // Utilities required in various placs
 
 static void warnNoSplit(const AstVar* varp, const AstNode* wherep, const char* reasonp) {
+    if (varp->user2()) return;  // Selected by SplitVarAutoVisitor, not by the user
     wherep->v3warn(SPLITVAR, varp->prettyNameQ()
                                  << " has split_var metacomment but will not be split because "
                                  << reasonp << ".\n");
@@ -1239,11 +1246,136 @@ const char* SplitVarImpl::cannotSplitPackedVarReason(const AstVar* varp) {
     return SplitPackedVarVisitor::cannotSplitReason(varp, true);
 }
 
+//######################################################################
+// Select variables to split without split_var metacomment
+
+class SplitVarAutoVisitor final : public VNVisitor {
+    // NODE STATE
+    //  AstVar::user1()  -> bool. Read in current process
+    //  AstVar::user2()  -> bool. Selected by this visitor (set here, read by warnNoSplit)
+    //  AstVar::user3()  -> bool. Cannot be selected
+    //  AstVar::user4()  -> bool. Partially written and read by the same combinational process
+    const VNUser1InUse m_user1InUse;
+    const VNUser3InUse m_user3InUse;
+    const VNUser4InUse m_user4InUse;
+
+    // STATE
+    const AstNodeModule* m_modp = nullptr;  // Current module
+    AstNode* m_procp = nullptr;  // Current combinational process, or nullptr
+    std::vector<AstVar*> m_procWrites;  // Variables partially written in current process
+    std::vector<AstVar*> m_procReads;  // Variables read in current process
+    std::vector<AstVar*> m_candidates;  // Variables read and written by the same process
+    size_t m_numSelected = 0;  // Statistic tracking
+
+    // METHODS
+    static bool isCombo(const AstAlways* nodep) {
+        if (nodep->keyword() == VAlwaysKwd::ALWAYS_COMB) return true;
+        const AstSenTree* const sensesp = nodep->sensesp();
+        if (!sensesp) return false;
+        if (sensesp->hasCombo()) return true;
+        // Level sensitive list
+        for (const AstSenItem* itemp = sensesp->sensesp(); itemp;
+             itemp = VN_AS(itemp->nextp(), SenItem)) {
+            if (itemp->edgeType() != VEdgeType::ET_CHANGED) return false;
+        }
+        return true;
+    }
+    static bool isConstSel(const AstSel* selp) {
+        return VN_IS(selp->lsbp(), Const) && VN_IS(selp->widthp(), Const);
+    }
+    void iterateProcess(AstNode* nodep) {
+        VL_RESTORER(m_procp);
+        m_procp = nodep;
+        m_procWrites.clear();
+        m_procReads.clear();
+        iterateChildren(nodep);
+        for (AstVar* const varp : m_procReads) varp->user1(true);
+        for (AstVar* const varp : m_procWrites) {
+            if (varp->user1() && !varp->user4()) {
+                varp->user4(true);
+                m_candidates.push_back(varp);
+            }
+        }
+        for (AstVar* const varp : m_procReads) varp->user1(false);
+    }
+
+    // VISITORS
+    void visit(AstNodeModule* nodep) override {
+        VL_RESTORER(m_modp);
+        m_modp = nodep;
+        iterateChildren(nodep);
+    }
+    void visit(AstVar* nodep) override {
+        // Only variables of plain modules, not of packages, interfaces or classes
+        if (!VN_IS(m_modp, Module)) nodep->user3(true);
+    }
+    void visit(AstAlways* nodep) override {
+        if (isCombo(nodep)) {
+            iterateProcess(nodep);
+        } else {
+            iterateChildren(nodep);
+        }
+    }
+    void visit(AstAssignW* nodep) override { iterateProcess(nodep); }
+    void visit(AstNodeFTask* nodep) override {
+        VL_RESTORER(m_procp);
+        m_procp = nullptr;
+        iterateChildren(nodep);
+    }
+    void visit(AstVarXRef* nodep) override {
+        // Hierarchical references are not rewritten by the split
+        if (nodep->varp()) nodep->varp()->user3(true);
+        iterateChildren(nodep);
+    }
+    void visit(AstVarRef* nodep) override {
+        AstVar* const varp = nodep->varp();
+        if (nodep->classOrPackagep() || !VN_IS(m_modp, Module)) varp->user3(true);
+        const AstSel* const selp = VN_CAST(nodep->backp(), Sel);
+        const bool constSel = selp && selp->fromp() == nodep && isConstSel(selp);
+        if (nodep->access().isWriteOrRW()) {
+            // Writing the whole variable, or an unknown part of it, gains nothing from splitting
+            if (!constSel) varp->user3(true);
+            if (m_procp && constSel) m_procWrites.push_back(varp);
+        }
+        if (nodep->access().isReadOrRW()) {
+            // Reading an unknown part of it prevents splitting
+            if (selp && selp->fromp() == nodep && !constSel) varp->user3(true);
+            if (m_procp) m_procReads.push_back(varp);
+        }
+    }
+    void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit SplitVarAutoVisitor(AstNetlist* nodep) {
+        iterate(nodep);
+        // References from anywhere in the design may disqualify, so select only at the end
+        for (AstVar* const varp : m_candidates) {
+            if (varp->user3() || varp->attrSplitVar()) continue;
+            if (varp->isIO() || varp->isFuncLocal() || varp->isFuncReturn()) continue;
+            if (SplitPackedVarVisitor::cannotSplitReason(varp, true)) continue;
+            UINFO(4, "Automatically split " << varp->prettyNameQ() << endl);
+            varp->attrSplitVar(true);
+            varp->user2(true);
+            ++m_numSelected;
+        }
+    }
+    ~SplitVarAutoVisitor() override {
+        V3Stats::addStat("SplitVar, Automatically selected variables", m_numSelected);
+    }
+};
+
 //######################################################################
 // Split class functions
 
 void V3SplitVar::splitVariable(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
+    // AstVar::user2() -> bool. Selected by SplitVarAutoVisitor
+    const VNUser2InUse user2InUse;
+    if (v3Global.opt.fSplitVarAuto()) {
+        { SplitVarAutoVisitor{nodep}; }
+        V3Global::dumpCheckGlobalTree("split_var_auto", 0, dumpTreeLevel() >= 9);
+    }
     SplitVarRefsMap refs;
     {
         const SplitUnpackedVarVisitor visitor{nodep};
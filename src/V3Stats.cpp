@@ -51,6 +51,7 @@ private:
     bool m_tracingCall;  // Iterating into a CCall to a CFunc
 
     std::vector<VDouble0> m_statTypeCount;  // Nodes of given type
+    std::vector<VDouble0> m_statTypeBytes;  // Memory used by nodes of given type
     VDouble0 m_statAbove[VNType::_ENUM_END][VNType::_ENUM_END];  // Nodes of given type
     std::array<VDouble0, VBranchPred::_ENUM_END> m_statPred;  // Nodes of given type
     VDouble0 m_statInstr;  // Instruction count
@@ -68,6 +69,7 @@ private:
         m_instrs += nodep->instrCount();
         if (m_counting) {
             ++m_statTypeCount[nodep->type()];
+            m_statTypeBytes[nodep->type()] += nodep->nodeBytes();
             if (nodep->firstAbovep()) {  // Grab only those above, not those "back"
                 ++m_statAbove[nodep->firstAbovep()->type()][nodep->type()];
             }
@@ -217,6 +219,7 @@ public:
         m_tracingCall = false;
         // Initialize arrays
         m_statTypeCount.resize(VNType::_ENUM_END);
+        m_statTypeBytes.resize(VNType::_ENUM_END);
         // Process
         iterateConst(nodep);
     }
@@ -249,13 +252,24 @@ public:
             }
         }
         // Node types
+        double nodes = 0;
+        double nodeBytes = 0;
         for (int type = 0; type < VNType::_ENUM_END; type++) {
             const double count{m_statTypeCount.at(type)};
             if (count != 0.0) {
                 V3Stats::addStat(m_stage, std::string{"Node count, "} + VNType{type}.ascii(),
                                  count);
+                V3Stats::addStat(m_stage,
+                                 std::string{"Node memory, bytes, "} + VNType{type}.ascii(),
+                                 m_statTypeBytes.at(type));
+                nodes += count;
+                nodeBytes += m_statTypeBytes.at(type);
             }
         }
+        if (nodes != 0.0) {
+            V3Stats::addStat(m_stage, "Node memory, bytes, TOTAL", nodeBytes);
+            V3Stats::addStat(m_stage, "Node memory, bytes per node", nodeBytes / nodes);
+        }
         for (int type = 0; type < VNType::_ENUM_END; type++) {
             for (int type2 = 0; type2 < VNType::_ENUM_END; type2++) {
                 const double count{m_statAbove[type][type2]};
@@ -121,6 +121,10 @@ public:
     static void statsFinalAll(AstNetlist* nodep);
     /// Called by the top level to dump the statistics
     static void statsReport();
+    /// Called at start, after each stage, and at end of Verilation with --prof-verilation
+    static void profVerilationStart();
+    static void profVerilationStage(const string& name);
+    static void profVerilationReport();
     /// Called by debug dumps
     static void infoHeader(std::ofstream& os, const string& prefix);
 };
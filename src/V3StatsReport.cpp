@@ -25,6 +25,7 @@
 
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -194,7 +195,13 @@ void V3Statistic::dump(std::ofstream& os) const {
 //######################################################################
 // Top Stats class
 
-void V3Stats::addStat(const V3Statistic& stat) { StatsReport::addStat(stat); }
+// Statistics may be added by passes running on V3ThreadPool
+static V3Mutex s_addStatMutex;
+
+void V3Stats::addStat(const V3Statistic& stat) {
+    const V3LockGuard lock{s_addStatMutex};
+    StatsReport::addStat(stat);
+}
 
 void V3Stats::statsStage(const string& name) {
     static double lastWallTime = -1;
@@ -213,6 +220,90 @@ void V3Stats::statsStage(const string& name) {
     V3Stats::addStatPerf("Stage, Memory (MB), " + digitName, memory);
 }
 
+//######################################################################
+// Verilation profiling
+
+class ProfVerilation final {
+    // TYPES
+    struct Sample final {
+        string m_name;  // Stage name
+        double m_wallTime;  // Wall time at end of stage, seconds
+        double m_cpuTime;  // CPU time of all threads at end of stage, seconds
+        uint64_t m_memory;  // Memory usage at end of stage, bytes
+        uint64_t m_memoryPeak;  // Peak resident memory so far, bytes
+        int m_nodes;  // AstNodes in the netlist at end of stage
+    };
+
+    // STATE
+    static std::vector<Sample> s_samples;  // In stage order, first is start of Verilator
+
+    static Sample sample(const string& name) {
+        const int nodes = v3Global.rootp() ? v3Global.rootp()->nodeCount() : 0;
+        return Sample{name,
+                      V3Os::timeUsecs() / 1.0e6,
+                      V3Os::cpuTimeUsecs() / 1.0e6,
+                      V3Os::memUsageBytes(),
+                      V3Os::memPeakUsageBytes(),
+                      nodes};
+    }
+    static string quoted(const string& str) {
+        return "\"" + VString::quoteAny(VString::quoteBackslash(VString::spaceUnprintable(str)),
+                                        '"', '\\')
+               + "\"";
+    }
+
+public:
+    static void start() {
+        if (s_samples.empty()) s_samples.push_back(sample("start"));
+    }
+    static void stage(const string& name) {
+        start();
+        s_samples.push_back(sample(name));
+    }
+    static void report() {
+        const string filename = v3Global.opt.hierTopDataDir() + "/" + v3Global.opt.prefix()
+                                + "__prof_verilation.json";
+        const std::unique_ptr<std::ofstream> ofp{V3File::new_ofstream(filename)};
+        if (ofp->fail()) v3fatal("Can't write " << filename);
+        std::ostream& os = *ofp;
+        constexpr double MB = 1024.0 * 1024.0;
+        os << std::fixed << std::setprecision(6);
+        os << "{\n";
+        os << "  \"version\": " << quoted(V3Options::version()) << ",\n";
+        os << "  \"arguments\": " << quoted(v3Global.opt.allArgsString()) << ",\n";
+        os << "  \"verilate_jobs\": " << v3Global.opt.verilateJobs() << ",\n";
+        os << "  \"stages\": [";
+        for (size_t i = 1; i < s_samples.size(); ++i) {
+            const Sample& prev = s_samples[i - 1];
+            const Sample& curr = s_samples[i];
+            const double wall = curr.m_wallTime - prev.m_wallTime;
+            const double cpu = curr.m_cpuTime - prev.m_cpuTime;
+            os << (i > 1 ? "," : "") << "\n    {";
+            os << "\"number\": " << i;
+            os << ", \"name\": " << quoted(curr.m_name);
+            os << ", \"wall_sec\": " << wall;
+            os << ", \"cpu_sec\": " << cpu;
+            // Average number of busy threads
+            os << ", \"thread_utilization\": " << (wall > 0 ? cpu / wall : 0.0);
+            os << ", \"memory_mb\": " << curr.m_memory / MB;
+            os << ", \"memory_delta_mb\": "
+               << (static_cast<double>(curr.m_memory) - prev.m_memory) / MB;
+            os << ", \"memory_peak_mb\": " << curr.m_memoryPeak / MB;
+            os << ", \"nodes\": " << curr.m_nodes;
+            os << ", \"nodes_delta\": " << curr.m_nodes - prev.m_nodes;
+            os << "}";
+        }
+        os << "\n  ]\n";
+        os << "}\n";
+    }
+};
+
+std::vector<ProfVerilation::Sample> ProfVerilation::s_samples;
+
+void V3Stats::profVerilationStart() { ProfVerilation::start(); }
+void V3Stats::profVerilationStage(const string& name) { ProfVerilation::stage(name); }
+void V3Stats::profVerilationReport() { ProfVerilation::report(); }
+
 void V3Stats::infoHeader(std::ofstream& os, const string& prefix) {
     os << prefix << "Information:\n";
     os << prefix << "  " << V3Options::version() << '\n';
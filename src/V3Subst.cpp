@@ -20,6 +20,11 @@
 //      Later usages of that word may then be replaced as long as
 //      the RHS hasn't changed value.
 //
+// Each function:
+//      Wide temporaries that remain after substitution are not kept in
+//      registers, so temporaries of the same type whose live ranges in
+//      the function's statements don't overlap share one variable.
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -32,6 +37,7 @@
 #include "V3Stats.h"
 
 #include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -378,11 +384,96 @@ public:
     }
 };
 
+//######################################################################
+// Reuse wide temporaries, as a visitor of each AstCFunc
+
+class SubstReuseVisitor final : public VNVisitor {
+private:
+    // STATE
+    VDouble0 m_statReused;  // Statistic tracking
+
+    // METHODS
+    static bool isReusable(const AstVar* varp) {
+        return varp->isStatementTemp() && varp->isWide() && !varp->noSubst();
+    }
+
+    // VISITORS
+    void visit(AstCFunc* nodep) override {
+        // Live range of each temporary, as indices of the top level statements using it
+        std::unordered_map<AstVar*, std::pair<int, int>> ranges;
+        for (AstNode* np = nodep->initsp(); np; np = np->nextp()) {
+            AstVar* const varp = VN_CAST(np, Var);
+            if (varp && isReusable(varp)) ranges.emplace(varp, std::make_pair(-1, -1));
+        }
+        if (ranges.size() < 2) return;
+        int index = 0;
+        for (AstNode* stmtp = nodep->stmtsp(); stmtp; stmtp = stmtp->nextp(), ++index) {
+            stmtp->foreach([&](const AstVarRef* refp) {
+                const auto it = ranges.find(refp->varp());
+                if (it == ranges.end()) return;
+                if (it->second.first < 0) it->second.first = index;
+                it->second.second = index;
+            });
+        }
+        // Greedily give each temporary, in order of first use, a free variable of its type
+        std::vector<AstVar*> temps;
+        for (const auto& pair : ranges) {
+            if (pair.second.first >= 0) temps.push_back(pair.first);
+        }
+        std::stable_sort(temps.begin(), temps.end(), [&](AstVar* ap, AstVar* bp) {
+            if (ranges.at(ap).first != ranges.at(bp).first) {
+                return ranges.at(ap).first < ranges.at(bp).first;
+            }
+            return ap->name() < bp->name();  // For output stability
+        });
+        struct Slot final {
+            AstVar* m_varp;  // Variable shared by the temporaries
+            int m_last;  // Index of last statement using the variable
+        };
+        std::vector<Slot> slots;
+        std::unordered_map<AstVar*, AstVar*> replacements;
+        for (AstVar* const varp : temps) {
+            const std::pair<int, int>& range = ranges.at(varp);
+            const auto it = std::find_if(slots.begin(), slots.end(), [&](const Slot& slot) {
+                return slot.m_last < range.first && slot.m_varp->width() == varp->width()
+                       && slot.m_varp->dtypep()->similarDType(varp->dtypep());
+            });
+            if (it == slots.end()) {
+                slots.push_back({varp, range.second});
+            } else {
+                replacements.emplace(varp, it->m_varp);
+                it->m_last = range.second;
+            }
+        }
+        if (replacements.empty()) return;
+        nodep->foreach([&](AstVarRef* refp) {
+            const auto it = replacements.find(refp->varp());
+            if (it != replacements.end()) refp->varp(it->second);
+        });
+        for (const auto& pair : replacements) {
+            AstVar* varp = pair.first;
+            VL_DO_DANGLING(varp->unlinkFrBack()->deleteTree(), varp);
+            ++m_statReused;
+        }
+    }
+    void visit(AstNodeStmt*) override {}  // Accelerate
+    void visit(AstNodeExpr*) override {}  // Accelerate
+    void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit SubstReuseVisitor(AstNetlist* nodep) { iterate(nodep); }
+    ~SubstReuseVisitor() override {
+        V3Stats::addStat("Optimizations, Wide temps reused", m_statReused);
+    }
+};
+
 //######################################################################
 // Subst class functions
 
 void V3Subst::substituteAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
     { SubstVisitor{nodep}; }  // Destruct before checking
+    { SubstReuseVisitor{nodep}; }
     V3Global::dumpCheckGlobalTree("subst", 0, dumpTreeLevel() >= 3);
 }
@@ -25,10 +25,12 @@
 #include "V3Global.h"
 #include "V3String.h"
 
+#include <algorithm>
 #include <cstdarg>
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -43,7 +45,8 @@ using VSymConstMap = std::unordered_set<const VSymEnt*>;
 class VSymEnt final {
     // Symbol table that can have a "superior" table for resolving upper references
     // MEMBERS
-    using IdNameMap = std::multimap<std::string, VSymEnt*>;
+    // Hashed, as lookups by name are far more common than iteration, which uses sortedIds()
+    using IdNameMap = std::unordered_multimap<std::string, VSymEnt*>;
     IdNameMap m_idNameMap;  // Hash of variables by name
     AstNode* m_nodep;  // Node that entry belongs to
     VSymEnt* m_fallbackp;  // Table "above" this one in name scope, for fallback resolution
@@ -58,9 +61,18 @@ class VSymEnt final {
     static constexpr int debug() { return 0; }  // NOT runtime, too hot of a function
 #endif
 public:
-    using const_iterator = IdNameMap::const_iterator;
-    const_iterator begin() const { return m_idNameMap.begin(); }
-    const_iterator end() const { return m_idNameMap.end(); }
+    using SortedIds = std::vector<const IdNameMap::value_type*>;
+    // Return entries sorted by name, for iteration in a deterministic order
+    SortedIds sortedIds() const {
+        SortedIds result;
+        result.reserve(m_idNameMap.size());
+        for (const IdNameMap::value_type& itr : m_idNameMap) result.push_back(&itr);
+        std::stable_sort(result.begin(), result.end(),
+                         [](const IdNameMap::value_type* ap, const IdNameMap::value_type* bp) {
+                             return ap->first < bp->first;
+                         });
+        return result;
+    }
 
     void dumpIterate(std::ostream& os, VSymConstMap& doneSymsr, const string& indent,
                      int numLevels, const string& searchName) const {
@@ -75,11 +87,10 @@ public:
             os << indent << "| ^ duplicate, so no children printed\n";  // LCOV_EXCL_LINE
         } else {
             doneSymsr.insert(this);
-            for (IdNameMap::const_iterator it = m_idNameMap.begin(); it != m_idNameMap.end();
-                 ++it) {
+            for (const IdNameMap::value_type* const itp : sortedIds()) {
                 if (numLevels >= 1) {
-                    it->second->dumpIterate(os, doneSymsr, indent + "| ", numLevels - 1,
-                                            it->first);
+                    itp->second->dumpIterate(os, doneSymsr, indent + "| ", numLevels - 1,
+                                             itp->first);
                 }
             }
         }
@@ -163,8 +174,8 @@ public:
     }
     void candidateIdFlat(VSpellCheck* spellerp, const VNodeMatcher* matcherp) const {
         // Suggest alternative symbol candidates without looking upward through symbol hierarchy
-        for (IdNameMap::const_iterator it = m_idNameMap.begin(); it != m_idNameMap.end(); ++it) {
-            const AstNode* const itemp = it->second->nodep();
+        for (const IdNameMap::value_type* const itp : sortedIds()) {
+            const AstNode* const itemp = itp->second->nodep();
             if (itemp && (!matcherp || matcherp->nodeMatch(itemp))) {
                 spellerp->pushCandidate(itemp->prettyName());
             }
@@ -201,9 +212,8 @@ public:
     void importFromClass(VSymGraph* graphp, const VSymEnt* srcp) {
         // Import tokens from source symbol table into this symbol table
         // Used for classes in early parsing only to handle "extends"
-        for (IdNameMap::const_iterator it = srcp->m_idNameMap.begin();
-             it != srcp->m_idNameMap.end(); ++it) {
-            importOneSymbol(graphp, it->first, it->second, false);
+        for (const IdNameMap::value_type* const itp : srcp->sortedIds()) {
+            importOneSymbol(graphp, itp->first, itp->second, false);
         }
     }
     void importFromPackage(VSymGraph* graphp, const VSymEnt* srcp, const string& id_or_star) {
@@ -214,9 +224,8 @@ public:
                 importOneSymbol(graphp, it->first, it->second, true);
             }
         } else {
-            for (IdNameMap::const_iterator it = srcp->m_idNameMap.begin();
-                 it != srcp->m_idNameMap.end(); ++it) {
-                importOneSymbol(graphp, it->first, it->second, true);
+            for (const IdNameMap::value_type* const itp : srcp->sortedIds()) {
+                importOneSymbol(graphp, itp->first, itp->second, true);
             }
         }
     }
@@ -226,26 +235,24 @@ public:
             const auto it = vlstd::as_const(srcp->m_idNameMap).find(id_or_star);
             if (it != srcp->m_idNameMap.end()) exportOneSymbol(graphp, it->first, it->second);
         } else {
-            for (IdNameMap::const_iterator it = srcp->m_idNameMap.begin();
-                 it != srcp->m_idNameMap.end(); ++it) {
-                exportOneSymbol(graphp, it->first, it->second);
+            for (const IdNameMap::value_type* const itp : srcp->sortedIds()) {
+                exportOneSymbol(graphp, itp->first, itp->second);
             }
         }
     }
     void exportStarStar(VSymGraph* graphp) {
         // Export *:*: Export all tokens from imported packages
-        for (IdNameMap::const_iterator it = m_idNameMap.begin(); it != m_idNameMap.end(); ++it) {
-            VSymEnt* const symp = it->second;
+        for (const auto& itr : m_idNameMap) {
+            VSymEnt* const symp = itr.second;
             if (!symp->exported()) symp->exported(true);
         }
     }
     void importFromIface(VSymGraph* graphp, const VSymEnt* srcp, bool onlyUnmodportable = false) {
         // Import interface tokens from source symbol table into this symbol table, recursively
         UINFO(9, "     importIf  se" << cvtToHex(this) << " from se" << cvtToHex(srcp) << endl);
-        for (IdNameMap::const_iterator it = srcp->m_idNameMap.begin();
-             it != srcp->m_idNameMap.end(); ++it) {
-            const string& name = it->first;
-            VSymEnt* const subSrcp = it->second;
+        for (const IdNameMap::value_type* const itp : srcp->sortedIds()) {
+            const string& name = itp->first;
+            VSymEnt* const subSrcp = itp->second;
             const AstVar* const varp = VN_CAST(subSrcp->nodep(), Var);
             if (!onlyUnmodportable || (varp && varp->isParam())) {
                 VSymEnt* const subSymp = new VSymEnt{graphp, subSrcp};
@@ -258,11 +265,11 @@ public:
     void cellErrorScopes(AstNode* lookp, string prettyName = "") {
         if (prettyName == "") prettyName = lookp->prettyName();
         string scopes;
-        for (IdNameMap::iterator it = m_idNameMap.begin(); it != m_idNameMap.end(); ++it) {
-            AstNode* const itemp = it->second->nodep();
+        for (const IdNameMap::value_type* const itp : sortedIds()) {
+            AstNode* const itemp = itp->second->nodep();
             if (VN_IS(itemp, Cell) || (VN_IS(itemp, Module) && VN_AS(itemp, Module)->isTop())) {
                 if (scopes != "") scopes += ", ";
-                scopes += AstNode::prettyName(it->first);
+                scopes += AstNode::prettyName(itp->first);
             }
         }
         if (scopes == "") scopes = "<no instances found>";
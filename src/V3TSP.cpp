@@ -24,6 +24,7 @@
 
 #include "V3TSP.h"
 
+#include "V3Ast.h"
 #include "V3Error.h"
 #include "V3File.h"
 #include "V3Global.h"
@@ -31,6 +32,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <list>
 #include <memory>
 #include <sstream>
@@ -47,6 +49,16 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 namespace V3TSP {
 static uint32_t edgeIdNext = 0;
 
+// At or above this many states, use the sparse approximation, as building the complete graph
+// becomes too expensive in time and memory
+constexpr size_t TSP_SPARSE_MIN_STATES = 2048;
+// Number of nearest neighbors of each state considered by the sparse approximation
+constexpr size_t TSP_SPARSE_NEIGHBORS = 8;
+// Maximum number of 2-opt improvement passes of the sparse approximation
+constexpr int TSP_SPARSE_PASSES = 8;
+
+static void tspSortSparse(const StateVec& states, StateVec* resultp);
+static void selfTestSparse();
 static void selfTestStates();
 static void selfTestString();
 }  // namespace V3TSP
@@ -435,6 +447,108 @@ private:
     VL_UNCOPYABLE(TspGraphTmpl);
 };
 
+//######################################################################
+// Sparse approximation for large state sets
+
+void V3TSP::tspSortSparse(const V3TSP::StateVec& states, V3TSP::StateVec* resultp) {
+    // Greedy nearest neighbor walk over the k nearest neighbors of each state, improved by
+    // 2-opt moves between neighbors. This needs O(n*k) memory, rather than the O(n^2) of
+    // the complete graph, and no matching.
+    const size_t size = states.size();
+    const size_t k = std::min(TSP_SPARSE_NEIGHBORS, size - 1);
+
+    // Find the nearest neighbors of each state, nearest first
+    std::vector<std::vector<uint32_t>> neighbors(size);
+    AstNode::foreachIndexParallel(size, [&](size_t i) {
+        // Max-heap of the nearest neighbors found so far
+        std::vector<std::pair<int, uint32_t>> nearest;
+        nearest.reserve(k);
+        for (uint32_t j = 0; j < size; ++j) {
+            if (j == i) continue;
+            const std::pair<int, uint32_t> candidate{states[i]->cost(states[j]), j};
+            if (nearest.size() < k) {
+                nearest.push_back(candidate);
+                std::push_heap(nearest.begin(), nearest.end());
+            } else if (candidate < nearest.front()) {
+                std::pop_heap(nearest.begin(), nearest.end());
+                nearest.back() = candidate;
+                std::push_heap(nearest.begin(), nearest.end());
+            }
+        }
+        std::sort_heap(nearest.begin(), nearest.end());
+        neighbors[i].reserve(nearest.size());
+        for (const auto& pair : nearest) neighbors[i].push_back(pair.second);
+    });
+
+    // Greedy walk, always stepping to the nearest unvisited state
+    std::vector<uint32_t> path;
+    path.reserve(size);
+    std::vector<bool> visited(size, false);
+    uint32_t current = 0;
+    while (true) {
+        visited[current] = true;
+        path.push_back(current);
+        if (path.size() == size) break;
+        uint32_t next = size;
+        for (const uint32_t j : neighbors[current]) {
+            if (!visited[j]) {
+                next = j;
+                break;
+            }
+        }
+        if (next == size) {
+            // All neighbors visited, fall back to a scan of the remaining states
+            int minCost = std::numeric_limits<int>::max();
+            for (uint32_t j = 0; j < size; ++j) {
+                if (visited[j]) continue;
+                const int cost = states[current]->cost(states[j]);
+                if (cost < minCost) {
+                    minCost = cost;
+                    next = j;
+                }
+            }
+        }
+        current = next;
+    }
+
+    // Improve with 2-opt moves. Reversing path[p+1..q] replaces arcs (p, p+1) and (q, q+1)
+    // with (p, q) and (p+1, q+1). The path is not a cycle, so positions -1 and 'size' are
+    // virtual end points, with no cost to any state.
+    std::vector<size_t> position(size);
+    for (size_t p = 0; p < size; ++p) position[path[p]] = p;
+    const auto arcCost = [&](ptrdiff_t a, ptrdiff_t b) {
+        if (a < 0 || b < 0 || a >= static_cast<ptrdiff_t>(size)
+            || b >= static_cast<ptrdiff_t>(size)) {
+            return 0;
+        }
+        return states[path[a]]->cost(states[path[b]]);
+    };
+    bool improved = true;
+    for (int pass = 0; improved && pass < TSP_SPARSE_PASSES; ++pass) {
+        improved = false;
+        for (uint32_t a = 0; a < size; ++a) {
+            for (const uint32_t b : neighbors[a]) {
+                const ptrdiff_t lo = std::min(position[a], position[b]);
+                const ptrdiff_t hi = std::max(position[a], position[b]);
+                if (hi <= lo + 1) continue;  // Already adjacent
+                // Make 'a' and 'b' adjacent, either as the new (p, q) or (p+1, q+1) arc
+                for (const ptrdiff_t p : {lo, lo - 1}) {
+                    const ptrdiff_t q = p == lo ? hi : hi - 1;
+                    const int delta = arcCost(p, q) + arcCost(p + 1, q + 1)
+                                      - arcCost(p, p + 1) - arcCost(q, q + 1);
+                    if (delta >= 0) continue;
+                    std::reverse(path.begin() + p + 1, path.begin() + q + 1);
+                    for (ptrdiff_t r = p + 1; r <= q; ++r) position[path[r]] = r;
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (const uint32_t i : path) resultp->push_back(states[i]);
+}
+
 //######################################################################
 // Main algorithm
 
@@ -449,6 +563,10 @@ void V3TSP::tspSort(const V3TSP::StateVec& states, V3TSP::StateVec* resultp) {
         resultp->push_back(*(states.begin()));
         return;
     }
+    if (states.size() >= TSP_SPARSE_MIN_STATES) {
+        tspSortSparse(states, resultp);
+        return;
+    }
 
     // Build the initial graph from the starting state set.
     using Graph = TspGraphTmpl<const TspStateBase*>;
@@ -653,6 +771,36 @@ void V3TSP::selfTestStates() {
     }
 }
 
+void V3TSP::selfTestSparse() {
+    // Linear test of the sparse approximation -- coords all along the x-axis, shuffled
+    constexpr unsigned size = 256;
+    std::vector<std::unique_ptr<TspTestState>> points;
+    V3TSP::StateVec states;
+    for (unsigned i = 0; i < size; ++i) {
+        points.emplace_back(new TspTestState{(i * 37) % size, 0});
+        states.push_back(points.back().get());
+    }
+
+    V3TSP::StateVec result;
+    tspSortSparse(states, &result);
+
+    // Must be in order of xpos, in either direction
+    bool ok = result.size() == size;
+    const bool ascending = ok && dynamic_cast<const TspTestState*>(result.front())->xpos() == 0;
+    for (unsigned i = 0; ok && i < size; ++i) {
+        const unsigned xpos = dynamic_cast<const TspTestState*>(result[i])->xpos();
+        ok = xpos == (ascending ? i : size - 1 - i);
+    }
+    if (VL_UNCOVERABLE(!ok)) {
+        for (V3TSP::StateVec::iterator it = result.begin(); it != result.end(); ++it) {
+            const TspTestState* const statep = dynamic_cast<const TspTestState*>(*it);
+            cout << statep->xpos() << " ";
+        }
+        cout << endl;
+        v3fatalSrc("TSP sparse self-test fail. Result (above) did not match expectation.");
+    }
+}
+
 void V3TSP::selfTestString() {
     using Graph = TspGraphTmpl<std::string>;
     Graph graph;
@@ -699,4 +847,5 @@ void V3TSP::selfTestString() {
 void V3TSP::selfTest() {
     selfTestString();
     selfTestStates();
+    selfTestSparse();
 }
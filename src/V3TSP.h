@@ -34,6 +34,7 @@ public:
     // This is the cost function that the TSP sort will minimize.
     // All costs in V3TSP are int, chosen to match the type of
     // V3GraphEdge::weight() which will reflect each edge's cost.
+    // May be called concurrently from multiple threads for large sorts.
     virtual int cost(const TspStateBase* otherp) const = 0;
 
     // This operator< must place a meaningless, arbitrary, but
@@ -49,6 +50,7 @@ using StateVec = std::vector<const TspStateBase*>;
 
 // Given an unsorted set of TspState's, sort them to minimize
 // the transition cost for walking the sorted list.
+// Large state sets use a cheaper approximation on a sparse nearest neighbor graph.
 void tspSort(const StateVec& states, StateVec* resultp);
 
 void selfTest();
@@ -18,6 +18,13 @@
 //      Count # of input bits and # of output bits, and # of statements
 //      If high # of statements relative to inpbits*outbits,
 //      replace with lookup table
+//      If all outputs fit in one table entry, pack them into a single table
+//      If another instance of the module already converted the same logic,
+//      reuse its tables without simulating again
+//
+//      Replace reads of constant unpacked array parameters with reads of a
+//      table in the constant pool, so instances with the same values share
+//      one copy, which being constant data is also shared between processes
 //
 //*************************************************************************
 
@@ -32,6 +39,7 @@
 #include "V3Stats.h"
 
 #include <cmath>
+#include <unordered_map>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -40,8 +48,7 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 // Table class functions
 
 // CONFIG
-// 1MB is max table size (better be lots of instructs to be worth it!)
-static constexpr int TABLE_MAX_BYTES = 1 * 1024 * 1024;
+// Max table size is half of --table-cache-bytes (better be lots of instructs to be worth it!)
 // 64MB is close to max memory of some systems (256MB or so), so don't get out of control
 static constexpr int TABLE_TOTAL_BYTES = 64 * 1024 * 1024;
 // Worth no more than 8 bytes of data to replace an instruction
@@ -124,6 +131,7 @@ public:
 class TableOutputVar final {
     AstVarScope* const m_varScopep;  // The output variable
     const unsigned m_ord;  // Output ordinal number in this block
+    int m_packLsb = 0;  // LSB of this output in a packed table entry
     bool m_mayBeUnassigned = false;  // If true, then this variable may be unassigned through
                                      // some path through the block being table converted
     TableBuilder m_tableBuilder;
@@ -137,6 +145,8 @@ public:
     AstVarScope* varScopep() const { return m_varScopep; }
     string name() const { return varScopep()->varp()->name(); }
     unsigned ord() const { return m_ord; }
+    int packLsb() const { return m_packLsb; }
+    void packLsb(int lsb) { m_packLsb = lsb; }
     void setMayBeUnassigned() { m_mayBeUnassigned = true; }
     bool mayBeUnassigned() const { return m_mayBeUnassigned; }
     void setTableSize(unsigned size) { m_tableBuilder.setTableSize(varScopep()->dtypep(), size); }
@@ -152,13 +162,25 @@ private:
     // NODE STATE
     // Cleared on each always/assignw
 
+    // TYPES
+    // Logic converted to a table in this module, to reuse in other instances of the module
+    struct CachedTable final {
+        AstNode* m_logicp;  // Copy of the original statements
+        AstNode* m_tablep;  // Copy of the statements replacing them
+        std::vector<AstVarScope*> m_ioVscps;  // Inputs then outputs, as in m_tablep
+        std::vector<AstVarScope*> m_tempVscps;  // Temporaries, as in m_tablep
+    };
+
     // STATE
     double m_totalBytes = 0;  // Total bytes in tables created
     VDouble0 m_statTablesCre;  // Statistic tracking
+    VDouble0 m_statTablesPacked;  // Statistic tracking
+    VDouble0 m_statTablesShared;  // Statistic tracking
 
     //  State cleared on each module
     AstNodeModule* m_modp = nullptr;  // Current MODULE
     int m_modTables = 0;  // Number of tables created in this module
+    std::vector<CachedTable> m_cache;  // Tables created in this module
 
     //  State cleared on each scope
     AstScope* m_scopep = nullptr;  // Current SCOPE
@@ -167,8 +189,10 @@ private:
     bool m_assignDly = false;  // Consists of delayed assignments instead of normal assignments
     unsigned m_inWidthBits = 0;  // Input table width - in bits
     unsigned m_outWidthBytes = 0;  // Output table width - in bytes
+    int m_packWidth = 0;  // Width of packed table entry, or 0 if a table per output
     std::vector<AstVarScope*> m_inVarps;  // Input variable list
     std::vector<TableOutputVar> m_outVarps;  // Output variable list
+    const CachedTable* m_cachedp = nullptr;  // Same logic already converted in this module
 
     // METHODS
 
@@ -190,12 +214,73 @@ public:
     }
 
 private:
+    static bool sameExceptScope(const AstNode* ap, const AstNode* bp) {
+        // Return true if the two trees are identical, except for referencing the same variables
+        // in different scopes
+        for (; ap && bp; ap = ap->nextp(), bp = bp->nextp()) {
+            if (ap->type() != bp->type() || ap->dtypep() != bp->dtypep()) return false;
+            if (const AstVarRef* const arefp = VN_CAST(ap, VarRef)) {
+                const AstVarRef* const brefp = VN_AS(bp, VarRef);
+                if (arefp->varp() != brefp->varp() || arefp->access() != brefp->access()) {
+                    return false;
+                }
+            } else if (!ap->same(bp)) {
+                return false;
+            }
+            if (!sameExceptScope(ap->op1p(), bp->op1p())) return false;
+            if (!sameExceptScope(ap->op2p(), bp->op2p())) return false;
+            if (!sameExceptScope(ap->op3p(), bp->op3p())) return false;
+            if (!sameExceptScope(ap->op4p(), bp->op4p())) return false;
+        }
+        return !ap && !bp;
+    }
+
+    const CachedTable* findCached(AstAlways* nodep) const {
+        for (const CachedTable& cached : m_cache) {
+            if (cached.m_ioVscps.size() != m_inVarps.size() + m_outVarps.size()) continue;
+            bool same = true;
+            size_t i = 0;
+            for (const AstVarScope* const vscp : m_inVarps) {
+                same = same && cached.m_ioVscps[i++]->varp() == vscp->varp();
+            }
+            for (const TableOutputVar& tov : m_outVarps) {
+                same = same && cached.m_ioVscps[i++]->varp() == tov.varScopep()->varp();
+            }
+            if (same && sameExceptScope(cached.m_logicp, nodep->stmtsp())) return &cached;
+        }
+        return nullptr;
+    }
+
+    void clearCache() {
+        for (CachedTable& cached : m_cache) {
+            VL_DO_DANGLING(cached.m_logicp->deleteTree(), cached.m_logicp);
+            VL_DO_DANGLING(cached.m_tablep->deleteTree(), cached.m_tablep);
+        }
+        m_cache.clear();
+    }
+
+    int packWidth() const {
+        // Width of a table entry holding all outputs and their assigned flags, if that takes
+        // no more space than a table per output, else 0
+        if (m_outVarps.size() < 2) return 0;
+        int width = m_outVarps.size();
+        for (const TableOutputVar& tov : m_outVarps) {
+            if (!tov.varScopep()->dtypep()->skipRefp()->isIntegralOrPacked()) return 0;
+            width += tov.varScopep()->width();
+        }
+        if (width > VL_QUADSIZE) return 0;
+        const int separateBytes = m_outWidthBytes + (m_outVarps.size() + 7) / 8;
+        const int packedBytes = width <= 8 ? 1 : width <= 16 ? 2 : width <= 32 ? 4 : 8;
+        return packedBytes <= separateBytes ? width : 0;
+    }
+
     bool treeTest(AstAlways* nodep) {
         // Process alw/assign tree
         m_inWidthBits = 0;
         m_outWidthBytes = 0;
         m_inVarps.clear();
         m_outVarps.clear();
+        m_cachedp = nullptr;
 
         // Collect stats
         TableSimulateVisitor chkvis{this};
@@ -206,6 +291,12 @@ private:
         // Also sets m_inVarps
         // Also sets m_outVarps
 
+        // If the same logic was converted in another scope, just reuse those tables
+        if (chkvis.optimizable() && (m_cachedp = findCached(nodep))) {
+            UINFO(4, "  Test: Opt=OK, same as earlier table: " << nodep << endl);
+            return true;
+        }
+
         // Calc data storage in bytes
         const size_t chgWidth = m_outVarps.size();
         const double space = std::pow<double>(2.0, m_inWidthBits) * (m_outWidthBytes + chgWidth);
@@ -215,7 +306,7 @@ private:
         if (chkvis.instrCount() < TABLE_MIN_NODE_COUNT) {
             chkvis.clearOptimizable(nodep, "Table has too few nodes involved");
         }
-        if (space > TABLE_MAX_BYTES) {
+        if (space > v3Global.opt.tableCacheBytes() / 2) {
             chkvis.clearOptimizable(nodep, "Table takes too much space");
         }
         if (space > time * TABLE_SPACE_TIME_MULT) {
@@ -243,35 +334,67 @@ private:
         return chkvis.optimizable();
     }
 
+    AstVarScope* newTempVarScope(FileLine* fl, const string& name, int width) {
+        AstVar* const varp = new AstVar{fl, VVarType::BLOCKTEMP, name + cvtToStr(m_modTables),
+                                        VFlagBitPacked{}, width};
+        m_modp->addStmtsp(varp);
+        AstVarScope* const vscp = new AstVarScope{varp->fileline(), m_scopep, varp};
+        m_scopep->addVarsp(vscp);
+        return vscp;
+    }
+
     void replaceWithTable(AstAlways* nodep) {
         // We've determined this table of nodes is optimizable, do it.
-        ++m_modTables;
         ++m_statTablesCre;
+        if (m_cachedp) {
+            replaceWithCachedTable(nodep);
+            return;
+        }
+        ++m_modTables;
 
         FileLine* const fl = nodep->fileline();
 
         // We will need a table index variable, create it here.
-        AstVar* const indexVarp
-            = new AstVar{fl, VVarType::BLOCKTEMP, "__Vtableidx" + cvtToStr(m_modTables),
-                         VFlagBitPacked{}, static_cast<int>(m_inWidthBits)};
-        m_modp->addStmtsp(indexVarp);
-        AstVarScope* const indexVscp = new AstVarScope{indexVarp->fileline(), m_scopep, indexVarp};
-        m_scopep->addVarsp(indexVscp);
-
-        // The 'output assigned' table builder
-        TableBuilder outputAssignedTableBuilder{fl};
-        outputAssignedTableBuilder.setTableSize(
-            nodep->findBitDType(m_outVarps.size(), m_outVarps.size(), VSigning::UNSIGNED),
-            VL_MASK_I(m_inWidthBits));
+        AstVarScope* const indexVscp = newTempVarScope(fl, "__Vtableidx", m_inWidthBits);
 
-        // Set sizes of output tables
-        for (TableOutputVar& tov : m_outVarps) { tov.setTableSize(VL_MASK_I(m_inWidthBits)); }
+        // The 'output assigned' table builder, or if all outputs fit in one entry, the table
+        // holding both the outputs and the 'output assigned' flags
+        m_packWidth = packWidth();
+        TableBuilder outputAssignedTableBuilder{fl};
+        if (m_packWidth) {
+            ++m_statTablesPacked;
+            int lsb = 0;
+            for (TableOutputVar& tov : m_outVarps) {
+                tov.packLsb(lsb);
+                lsb += tov.varScopep()->width();
+            }
+            outputAssignedTableBuilder.setTableSize(
+                nodep->findBitDType(m_packWidth, m_packWidth, VSigning::UNSIGNED),
+                VL_MASK_I(m_inWidthBits));
+        } else {
+            outputAssignedTableBuilder.setTableSize(
+                nodep->findBitDType(m_outVarps.size(), m_outVarps.size(), VSigning::UNSIGNED),
+                VL_MASK_I(m_inWidthBits));
+            // Set sizes of output tables
+            for (TableOutputVar& tov : m_outVarps) { tov.setTableSize(VL_MASK_I(m_inWidthBits)); }
+        }
 
         // Populate the tables
         createTables(nodep, outputAssignedTableBuilder);
 
         AstNode* const stmtsp = createLookupInput(fl, indexVscp);
-        createOutputAssigns(nodep, stmtsp, indexVscp, outputAssignedTableBuilder.varScopep());
+        std::vector<AstVarScope*> tempVscps{indexVscp};
+        createOutputAssigns(nodep, stmtsp, indexVscp, outputAssignedTableBuilder.varScopep(),
+                            tempVscps);
+
+        // Remember it for other instances of this module
+        CachedTable cached;
+        cached.m_logicp = nodep->stmtsp()->cloneTree(true);
+        cached.m_tablep = stmtsp->cloneTree(true);
+        for (AstVarScope* const vscp : m_inVarps) cached.m_ioVscps.push_back(vscp);
+        for (TableOutputVar& tov : m_outVarps) cached.m_ioVscps.push_back(tov.varScopep());
+        cached.m_tempVscps = tempVscps;
+        m_cache.push_back(cached);
 
         // Link it in.
         // Keep sensitivity list, but delete all else
@@ -280,6 +403,29 @@ private:
         if (debug() >= 6) nodep->dumpTree("-  table_new: ");
     }
 
+    void replaceWithCachedTable(AstAlways* nodep) {
+        // Same logic as an earlier table in this module, so look up the same tables, with
+        // variable references retargeted to this scope
+        ++m_statTablesShared;
+        std::unordered_map<const AstVarScope*, AstVarScope*> remap;
+        size_t i = 0;
+        for (AstVarScope* const vscp : m_inVarps) remap[m_cachedp->m_ioVscps[i++]] = vscp;
+        for (TableOutputVar& tov : m_outVarps) remap[m_cachedp->m_ioVscps[i++]] = tov.varScopep();
+        for (AstVarScope* const tempp : m_cachedp->m_tempVscps) {
+            AstVarScope* const vscp = new AstVarScope{tempp->fileline(), m_scopep, tempp->varp()};
+            m_scopep->addVarsp(vscp);
+            remap[tempp] = vscp;
+        }
+        AstNode* const stmtsp = m_cachedp->m_tablep->cloneTree(true);
+        stmtsp->foreachAndNext([&](AstVarRef* refp) {
+            const auto it = remap.find(refp->varScopep());
+            if (it != remap.end()) refp->varScopep(it->second);
+        });
+        nodep->stmtsp()->unlinkFrBackWithNext()->deleteTree();
+        nodep->addStmtsp(stmtsp);
+        if (debug() >= 6) nodep->dumpTree("-  table_shared: ");
+    }
+
     void createTables(AstAlways* nodep, TableBuilder& outputAssignedTableBuilder) {
         // Create table
         // There may be a simulation path by which the output doesn't change value.
@@ -317,19 +463,30 @@ private:
 
             // Build output value tables and the assigned flags table
             V3Number outputAssignedMask{nodep, static_cast<int>(m_outVarps.size()), 0};
+            V3Number packed{nodep, m_packWidth ? m_packWidth : 1, 0};
             for (TableOutputVar& tov : m_outVarps) {
                 if (V3Number* const outnump = simvis.fetchOutNumberNull(tov.varScopep())) {
                     UINFO(8, "   Output " << tov.name() << " = " << *outnump << endl);
                     outputAssignedMask.setBit(tov.ord(), 1);  // Mark output as assigned
-                    tov.addValue(inValue, *outnump);
+                    if (m_packWidth) {
+                        packed.opSelInto(*outnump, tov.packLsb(), tov.varScopep()->width());
+                    } else {
+                        tov.addValue(inValue, *outnump);
+                    }
                 } else {
                     UINFO(8, "   Output " << tov.name() << " not set for this input\n");
                     tov.setMayBeUnassigned();
                 }
             }
 
-            // Set changed table
-            outputAssignedTableBuilder.addValue(inValue, outputAssignedMask);
+            // Set changed table, in the top bits of packed entries
+            if (m_packWidth) {
+                packed.opSelInto(outputAssignedMask, m_packWidth - m_outVarps.size(),
+                                 m_outVarps.size());
+                outputAssignedTableBuilder.addValue(inValue, packed);
+            } else {
+                outputAssignedTableBuilder.addValue(inValue, outputAssignedMask);
+            }
         }  // each value
     }
 
@@ -356,22 +513,41 @@ private:
     }
 
     void createOutputAssigns(AstNode* nodep, AstNode* stmtsp, AstVarScope* indexVscp,
-                             AstVarScope* outputAssignedTableVscp) {
+                             AstVarScope* outputAssignedTableVscp,
+                             std::vector<AstVarScope*>& tempVscps) {
         FileLine* const fl = nodep->fileline();
+        // With packed outputs, read the entry once, then select the outputs from it
+        AstVarScope* entryVscp = nullptr;
+        if (m_packWidth) {
+            entryVscp = newTempVarScope(fl, "__Vtableval", m_packWidth);
+            tempVscps.push_back(entryVscp);
+            stmtsp->addNext(new AstAssign{fl, new AstVarRef{fl, entryVscp, VAccess::WRITE},
+                                          select(fl, outputAssignedTableVscp, indexVscp)});
+        }
+        const int flagsLsb = m_packWidth - m_outVarps.size();
         for (TableOutputVar& tov : m_outVarps) {
             AstNodeExpr* const alhsp = new AstVarRef{fl, tov.varScopep(), VAccess::WRITE};
-            AstNodeExpr* const arhsp = select(fl, tov.tabeVarScopep(), indexVscp);
+            AstNodeExpr* const arhsp
+                = entryVscp ? static_cast<AstNodeExpr*>(
+                      new AstSel{fl, new AstVarRef{fl, entryVscp, VAccess::READ},
+                                 tov.packLsb(), tov.varScopep()->width()})
+                            : select(fl, tov.tabeVarScopep(), indexVscp);
             AstNode* outsetp = m_assignDly
                                    ? static_cast<AstNode*>(new AstAssignDly{fl, alhsp, arhsp})
                                    : static_cast<AstNode*>(new AstAssign{fl, alhsp, arhsp});
 
             // If this output is unassigned on some code paths, wrap the assignment in an If
             if (tov.mayBeUnassigned()) {
-                V3Number outputChgMask{nodep, static_cast<int>(m_outVarps.size()), 0};
-                outputChgMask.setBit(tov.ord(), 1);
-                AstNodeExpr* const condp
-                    = new AstAnd{fl, select(fl, outputAssignedTableVscp, indexVscp),
-                                 new AstConst{fl, outputChgMask}};
+                AstNodeExpr* condp;
+                if (entryVscp) {
+                    condp = new AstSel{fl, new AstVarRef{fl, entryVscp, VAccess::READ},
+                                       flagsLsb + static_cast<int>(tov.ord()), 1};
+                } else {
+                    V3Number outputChgMask{nodep, static_cast<int>(m_outVarps.size()), 0};
+                    outputChgMask.setBit(tov.ord(), 1);
+                    condp = new AstAnd{fl, select(fl, outputAssignedTableVscp, indexVscp),
+                                       new AstConst{fl, outputChgMask}};
+                }
                 outsetp = new AstIf{fl, condp, outsetp};
             }
 
@@ -388,6 +564,7 @@ private:
             m_modp = nodep;
             m_modTables = 0;
             iterateChildren(nodep);
+            clearCache();
         }
     }
     void visit(AstScope* nodep) override {
@@ -414,6 +591,66 @@ public:
     explicit TableVisitor(AstNetlist* nodep) { iterate(nodep); }
     ~TableVisitor() override {  //
         V3Stats::addStat("Optimizations, Tables created", m_statTablesCre);
+        V3Stats::addStat("Optimizations, Tables packed", m_statTablesPacked);
+        V3Stats::addStat("Optimizations, Tables shared", m_statTablesShared);
+    }
+};
+
+//######################################################################
+// Move array parameters into the constant pool
+
+class TableParamVisitor final : public VNVisitor {
+private:
+    // NODE STATE
+    //  AstVar::user1p()  -> AstVarScope*. Constant pool table replacing this parameter
+    //  AstVar::user2()   -> bool. Checked if parameter can be replaced
+    const VNUser1InUse m_inuser1;
+    const VNUser2InUse m_inuser2;
+
+    // STATE
+    VDouble0 m_statParamTables;  // Statistic tracking
+
+    // METHODS
+    static bool isConstTable(const AstVar* varp) {
+        const AstInitArray* const initp = VN_CAST(varp->valuep(), InitArray);
+        if (!initp) return false;
+        const AstUnpackArrayDType* const adtypep
+            = VN_CAST(varp->dtypep()->skipRefp(), UnpackArrayDType);
+        if (!adtypep || adtypep->isSparse()) return false;
+        if (initp->defaultp() && !VN_IS(initp->defaultp(), Const)) return false;
+        for (const AstNode* nodep = initp->initsp(); nodep; nodep = nodep->nextp()) {
+            if (!VN_IS(VN_AS(nodep, InitItem)->valuep(), Const)) return false;
+        }
+        return true;
+    }
+    AstVarScope* tableFor(AstVar* varp) {
+        if (!varp->user2()) {
+            varp->user2(true);
+            if (isConstTable(varp)) {
+                varp->user1p(v3Global.rootp()->constPoolp()->findTable(
+                    VN_AS(varp->valuep(), InitArray)));
+                ++m_statParamTables;
+            }
+        }
+        return VN_AS(varp->user1p(), VarScope);
+    }
+
+    // VISITORS
+    void visit(AstVarRef* nodep) override {
+        AstVar* const varp = nodep->varp();
+        if (!varp->isParam() || !nodep->access().isReadOnly() || !nodep->varScopep()) return;
+        if (AstVarScope* const tablep = tableFor(varp)) {
+            nodep->varScopep(tablep);
+            nodep->varp(tablep->varp());
+        }
+    }
+    void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit TableParamVisitor(AstNetlist* nodep) { iterate(nodep); }
+    ~TableParamVisitor() override {
+        V3Stats::addStat("Optimizations, Tables from parameters", m_statParamTables);
     }
 };
 
@@ -431,5 +668,6 @@ void TableSimulateVisitor::varRefCb(AstVarRef* nodep) {
 void V3Table::tableAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
     { TableVisitor{nodep}; }  // Destruct before checking
+    { TableParamVisitor{nodep}; }  // Destruct before checking
     V3Global::dumpCheckGlobalTree("table", 0, dumpTreeLevel() >= 3);
 }
@@ -34,6 +34,7 @@
 #include "V3Global.h"
 #include "V3Graph.h"
 #include "V3LinkLValue.h"
+#include "V3Sched.h"
 
 #include <map>
 #include <tuple>
@@ -585,6 +586,9 @@ private:
                             E_TASKNSVAR,
                             "Unsupported: Function/task input argument is not simple variable");
                     }
+                } else if (portp->isWritable() && dpiOpenOutputInPlace(refp, portp, pinp)) {
+                    // Connect to this exact variable, so the import writes it without a copy
+                    V3LinkLValue::linkLValueSet(pinp);
                 } else if (portp->isWritable()) {
                     // Make output variables
                     // Correct lvalue; we didn't know when we linked
@@ -641,6 +645,94 @@ private:
         return beginp;
     }
 
+    static bool dpiOpenOutputInPlace(const AstNodeFTaskRef* refp, const AstVar* portp,
+                                     const AstNodeExpr* pinp) {
+        // A DPI open array output may be written directly into the actual variable, avoiding
+        // a temporary and the copy of the whole array back, if the layouts match and nothing
+        // can observe the variable before the import returns. Open array ports take the
+        // type of the actual in V3Width, so the layout is known to match here.
+        const AstNodeFTask* const taskp = refp->taskp();
+        if (!taskp->dpiImport() || taskp->dpiContext() || !portp->isDpiOpenArray()) return false;
+        const AstVarRef* const varrefp = VN_CAST(pinp, VarRef);
+        if (!varrefp || !varrefp->varScopep()) return false;
+        if (portp->dtypep()->skipRefp() != varrefp->varp()->dtypep()->skipRefp()) return false;
+        // Another argument referencing the same variable would alias it
+        for (const AstNode* argp = refp->pinsp(); argp; argp = argp->nextp()) {
+            if (argp->exists([&](const AstVarRef* otherp) {
+                    return otherp != varrefp && otherp->varScopep() == varrefp->varScopep();
+                })) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool dpiDirectType(const AstVar* portp, bool isReturn) {
+        // C type takes the internal value as is, so a DPI temporary is not needed
+        const AstBasicDType* const basicp = VN_CAST(portp->dtypep()->skipRefp(), BasicDType);
+        if (!basicp) return false;
+        switch (basicp->keyword()) {
+        case VBasicDTypeKwd::BYTE:
+        case VBasicDTypeKwd::SHORTINT:
+        case VBasicDTypeKwd::INT:
+        case VBasicDTypeKwd::LONGINT:
+        case VBasicDTypeKwd::DOUBLE: return true;
+        case VBasicDTypeKwd::BIT:
+        case VBasicDTypeKwd::LOGIC:
+            // svBit/svLogic, but the C side may return a value that needs masking
+            return !isReturn && !basicp->isRanged();
+        default: return false;
+        }
+    }
+
+    static bool dpiDirect(const AstNodeFTask* nodep) {
+        // DPI import can be called without the wrapper function, see createDirectDpiImport
+        if (!v3Global.opt.fDpiDirect() || !nodep->dpiImport() || nodep->dpiContext()
+            || nodep->dpiTask() || nodep->dpiOpenParent() || nodep->dpiOpenChild()) {
+            return false;
+        }
+        if (const AstVar* const rtnvarp = VN_CAST(nodep->fvarp(), Var)) {
+            if (!dpiDirectType(rtnvarp, true)) return false;
+        }
+        for (const AstNode* stmtp = nodep->stmtsp(); stmtp; stmtp = stmtp->nextp()) {
+            if (const AstVar* const portp = VN_CAST(stmtp, Var)) {
+                if (!portp->isIO()) continue;
+                if (portp->isWritable() || !dpiDirectType(portp, false)) return false;
+            }
+        }
+        return true;
+    }
+
+    AstNode* createDirectDpiImport(AstNodeFTaskRef* refp, AstVarScope* outvscp) {
+        // Call a DPI import with only scalar inputs as an expression, avoiding the
+        // wrapper function and its temporaries
+        // outvscp is the variable for functions only, if nullptr, it's a void function
+        FileLine* const flp = refp->fileline();
+        const auto it = m_dpiNames.find(refp->taskp()->cname());
+        UASSERT_OBJ(it != m_dpiNames.end(), refp, "No DPI import prototype for this call?");
+        AstCCall* const ccallp = new AstCCall{flp, std::get<2>(it->second)};
+        AstNode* const beginp = new AstComment{flp, string{"Function: "} + refp->name(), true};
+        // Put pins in port order
+        V3Task::taskConnects(refp, refp->taskp()->stmtsp());
+        AstNode* nextpinp;
+        for (AstNode* pinp = refp->pinsp(); pinp; pinp = nextpinp) {
+            nextpinp = pinp->nextp();
+            ccallp->addArgsp(VN_AS(pinp, Arg)->exprp()->unlinkFrBack());
+        }
+        if (outvscp) {
+            ccallp->dtypeFrom(outvscp);
+            AstAssign* const assp
+                = new AstAssign{flp, new AstVarRef{flp, outvscp, VAccess::WRITE}, ccallp};
+            assp->fileline()->modifyWarnOff(V3ErrorCode::BLKSEQ, true);  // Ok if in <= block
+            beginp->addNext(assp);
+        } else {
+            ccallp->dtypeSetVoid();
+            beginp->addNext(ccallp->makeStmt());
+        }
+        if (debug() >= 9) beginp->dumpTreeAndNext(cout, "-  dpitask: ");
+        return beginp;
+    }
+
     string dpiSignature(AstNodeFTask* nodep, AstVar* rtnvarp) const {
         // Return fancy signature for DPI function. Variable names are not included so differences
         // in only argument names will not matter (as required by the standard).
@@ -903,6 +995,7 @@ private:
         AstCFunc* const funcp = new AstCFunc{nodep->fileline(), nodep->cname(), m_scopep, rtnType};
         funcp->dpiContext(nodep->dpiContext());
         funcp->dpiImportPrototype(true);
+        funcp->dpiGroup(nodep->dpiGroup());
         funcp->dontCombine(true);
         funcp->entryPoint(false);
         funcp->isMethod(false);
@@ -1038,6 +1131,13 @@ private:
             cfuncp->addStmtsp(new AstCStmt{nodep->fileline(), stmt});
         }
 
+        // Time the call with --prof-exec. Class methods have no vlSymsp.
+        const bool profExec = v3Global.opt.profExec() && !VN_IS(m_modp, Class);
+        if (profExec) {
+            cfuncp->addStmtsp(
+                V3Sched::profExecSectionPush(nodep->fileline(), "dpi:" + nodep->cname()));
+        }
+
         {  // Call the imported function
             if (rtnvscp) {  // isFunction will no longer work as we unlinked the return var
                 cfuncp->addStmtsp(createDpiTemp(rtnvscp->varp(), tmpSuffixp));
@@ -1051,6 +1151,16 @@ private:
             callp->argTypes(args);
             cfuncp->addStmtsp(callp->makeStmt());
         }
+        if (profExec) {
+            cfuncp->addStmtsp(V3Sched::profExecSectionPop(nodep->fileline()));
+        }
+        if (v3Global.opt.runtimeStats()) {
+            const string contextp = VN_IS(m_modp, Class) ? "Verilated::threadContextp()"
+                                                         : "vlSymsp->_vm_contextp__";
+            cfuncp->addStmtsp(new AstCStmt{
+                nodep->fileline(),
+                contextp + "->stats().add(VerilatedContextStats::DPI_CALLS);\n"});
+        }
 
         // Convert output/inout arguments back to internal type
         for (AstNode* stmtp = cfuncp->argsp(); stmtp; stmtp = stmtp->nextp()) {
@@ -1174,6 +1284,7 @@ private:
         cfuncp->dpiContext(nodep->dpiContext());
         cfuncp->dpiExportImpl(nodep->dpiExport());
         cfuncp->dpiImportWrapper(nodep->dpiImport());
+        cfuncp->dpiGroup(nodep->dpiGroup());
         cfuncp->dpiTraceInit(nodep->dpiTraceInit());
         if (nodep->dpiImport() || nodep->dpiExport()) {
             cfuncp->isStatic(true);
@@ -1402,7 +1513,9 @@ private:
         // Create cloned statements
         AstNode* beginp;
         AstCNew* cnewp = nullptr;
-        if (m_statep->ftaskNoInline(nodep->taskp())) {
+        if (dpiDirect(nodep->taskp())) {
+            beginp = createDirectDpiImport(nodep, outvscp);
+        } else if (m_statep->ftaskNoInline(nodep->taskp())) {
             // This may share VarScope's with a public task, if any.  Yuk.
             beginp = createNonInlinedFTask(nodep, namePrefix, outvscp, cnewp /*ref*/);
         } else {
@@ -40,15 +40,21 @@
 
 #include "V3Trace.h"
 
+#include "V3Const.h"
 #include "V3DupFinder.h"
 #include "V3EmitCBase.h"
 #include "V3Global.h"
 #include "V3Graph.h"
+#include "V3Sched.h"
 #include "V3Stats.h"
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
@@ -178,23 +184,49 @@ private:
     AstTraceDecl* m_tracep = nullptr;  // Trace function adding to graph
     AstVarScope* m_activityVscp = nullptr;  // Activity variable
     uint32_t m_activityNumber = 0;  // Count of fields in activity variable
+    uint32_t m_activityWords = 0;  // Count of 8 field words in activity variable
     uint32_t m_code = 0;  // Trace ident code# being assigned
     V3Graph m_graph;  // Var/CFunc tracking
     TraceActivityVertex* const m_alwaysVtxp;  // "Always trace" vertex
     bool m_finding = false;  // Pass one of algorithm?
 
-    // Trace parallelism. Only VCD tracing can be parallelized at this time.
+    // Trace parallelism. VCD tracing renders the dump functions, each covering a range of
+    // trace codes, in parallel, on --trace-threads or --threads threads. Offloaded (FST)
+    // tracing captures the values to offload in parallel, when the model has threads.
     const uint32_t m_parallelism
-        = v3Global.opt.useTraceParallel() ? static_cast<uint32_t>(v3Global.opt.threads()) : 1;
+        = v3Global.opt.useTraceParallel()
+              ? static_cast<uint32_t>(v3Global.opt.vmTraceThreads())
+          : (v3Global.opt.useTraceOffload() && v3Global.opt.threads() > 1)
+              ? static_cast<uint32_t>(v3Global.opt.threads())
+              : 1;
 
     VDouble0 m_statUniqSigs;  // Statistic tracking
     VDouble0 m_statUniqCodes;  // Statistic tracking
 
+    // Maximum number of activity words tested before calling a change dump sub function
+    static constexpr size_t MAX_GUARD_WORDS = 4;
+
     // All activity numbers applying to a given trace
     using ActCodeSet = std::set<uint32_t>;
     // For activity set, what traces apply
     using TraceVec = std::multimap<ActCodeSet, TraceTraceVertex*>;
 
+    // An instance sharing its change dump functions, with --trace-share-instances
+    struct TraceInstance final {
+        AstScope* m_scopep;  // Scope of the instance
+        std::vector<TraceTraceVertex*> m_vtxps;  // Canonical traces of values in the scope
+    };
+    // Instances of the same module with the same traces, the first one is representative
+    using InstanceGroup = std::vector<TraceInstance>;
+    std::vector<InstanceGroup> m_instGroups;  // Instances sharing change dump functions
+    std::unordered_set<const TraceTraceVertex*> m_sharedVtxps;  // Traces in m_instGroups
+
+    // Memories with at least this many elements track which elements were written
+    static constexpr uint32_t WRITTEN_MIN_ELEMENTS = 256;
+    // Written element flags of traced memories
+    std::unordered_map<const AstTraceDecl*, AstVarScope*> m_writtenVscps;
+    VDouble0 m_statWrittenMems;  // Statistic tracking
+
     // METHODS
 
     void detectDuplicates() {
@@ -212,7 +244,7 @@ private:
                                 "Trace duplicate back needs consistency,"
                                 " so we can map duplicates back to TRACEINCs");
                     // Just keep one node in the map and point all duplicates to this node
-                    if (dupFinder.findDuplicate(nodep->valuep()) == dupFinder.end()) {
+                    if (!dupFinder.findDuplicate(nodep->valuep())) {
                         dupFinder.insert(nodep->valuep());
                     }
                 }
@@ -223,10 +255,8 @@ private:
             if (TraceTraceVertex* const vvertexp = dynamic_cast<TraceTraceVertex*>(itp)) {
                 const AstTraceDecl* const nodep = vvertexp->nodep();
                 if (nodep->valuep() && !vvertexp->duplicatep()) {
-                    const auto dupit = dupFinder.findDuplicate(nodep->valuep());
-                    if (dupit != dupFinder.end()) {
-                        const AstTraceDecl* const dupDeclp
-                            = VN_AS(dupit->second->backp(), TraceDecl);
+                    if (const AstNode* const dupp = dupFinder.findDuplicate(nodep->valuep())) {
+                        const AstTraceDecl* const dupDeclp = VN_AS(dupp->backp(), TraceDecl);
                         UASSERT_OBJ(dupDeclp, nodep, "Trace duplicate of wrong type");
                         TraceTraceVertex* const dupvertexp
                             = dynamic_cast<TraceTraceVertex*>(dupDeclp->user1u().toGraphVertex());
@@ -241,6 +271,105 @@ private:
         }
     }
 
+    static AstScope* traceScopep(const AstTraceDecl* declp) {
+        // Scope of the variables referenced by the traced value, or nullptr if it
+        // references no variables, or variables in multiple scopes
+        AstScope* scopep = nullptr;
+        const bool mixed = declp->valuep()->exists([&](const AstVarRef* refp) {
+            AstScope* const varScopep = refp->varScopep()->scopep();
+            if (scopep && scopep != varScopep) return true;
+            scopep = varScopep;
+            return false;
+        });
+        return mixed ? nullptr : scopep;
+    }
+
+    static bool sameTraceShape(const AstTraceDecl* ap, const AstTraceDecl* bp) {
+        // True if the traces differ only in the scope of the variables they reference,
+        // so dumping one emits the same code as dumping the other
+        if (ap->dtypep() != bp->dtypep() || ap->codeInc() != bp->codeInc()) return false;
+        std::vector<const AstNode*> anodeps;
+        std::vector<const AstNode*> bnodeps;
+        ap->valuep()->foreach([&](const AstNode* nodep) { anodeps.push_back(nodep); });
+        bp->valuep()->foreach([&](const AstNode* nodep) { bnodeps.push_back(nodep); });
+        if (anodeps.size() != bnodeps.size()) return false;
+        for (size_t i = 0; i < anodeps.size(); ++i) {
+            const AstNode* const anodep = anodeps[i];
+            const AstNode* const bnodep = bnodeps[i];
+            if (anodep->type() != bnodep->type() || anodep->dtypep() != bnodep->dtypep()) {
+                return false;
+            }
+            if (const AstVarRef* const refp = VN_CAST(anodep, VarRef)) {
+                if (refp->varp() != VN_AS(bnodep, VarRef)->varp()) return false;
+            } else if (!anodep->same(bnodep)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void findInstanceGroups() {
+        // Gather the canonical traces of each module instance, in declaration order
+        std::vector<TraceInstance> instances;
+        std::unordered_map<const AstScope*, size_t> instIndex;
+        for (V3GraphVertex* itp = m_graph.verticesBeginp(); itp; itp = itp->verticesNextp()) {
+            TraceTraceVertex* const vtxp = dynamic_cast<TraceTraceVertex*>(itp);
+            if (!vtxp || vtxp->duplicatep()) continue;
+            AstScope* const scopep = traceScopep(vtxp->nodep());
+            if (!scopep || scopep->isTop() || !VN_IS(scopep->modp(), Module)) continue;
+            const auto pair = instIndex.emplace(scopep, instances.size());
+            if (pair.second) instances.push_back(TraceInstance{scopep, {}});
+            instances[pair.first->second].m_vtxps.push_back(vtxp);
+        }
+        // Group the instances of each module that have the same traces
+        std::vector<InstanceGroup> groups;
+        for (TraceInstance& inst : instances) {
+            const auto sameTraces = [&](const InstanceGroup& group) {
+                const TraceInstance& repr = group.front();
+                return repr.m_scopep->modp() == inst.m_scopep->modp()
+                       && repr.m_vtxps.size() == inst.m_vtxps.size()
+                       && std::equal(repr.m_vtxps.begin(), repr.m_vtxps.end(),
+                                     inst.m_vtxps.begin(),
+                                     [](const TraceTraceVertex* ap, const TraceTraceVertex* bp) {
+                                         return sameTraceShape(ap->nodep(), bp->nodep());
+                                     });
+            };
+            const auto it = std::find_if(groups.begin(), groups.end(), sameTraces);
+            if (it != groups.end()) {
+                it->push_back(std::move(inst));
+            } else {
+                groups.emplace_back();
+                groups.back().push_back(std::move(inst));
+            }
+        }
+        // Only instances with identical siblings share functions
+        for (InstanceGroup& group : groups) {
+            if (group.size() < 2) continue;
+            UINFO(5, "Sharing trace functions of " << group.size() << " instances of "
+                                                   << group.front().m_scopep->modp() << endl);
+            for (const TraceInstance& inst : group) {
+                for (const TraceTraceVertex* const vtxp : inst.m_vtxps) m_sharedVtxps.insert(vtxp);
+            }
+            m_instGroups.push_back(std::move(group));
+        }
+    }
+
+    void allocateInstanceCodes() {
+        // Allocate the codes of each instance sharing change dump functions contiguously,
+        // so the codes of all instances in a group are laid out the same way
+        for (const InstanceGroup& group : m_instGroups) {
+            for (const TraceInstance& inst : group) {
+                for (TraceTraceVertex* const vtxp : inst.m_vtxps) {
+                    AstTraceDecl* const declp = vtxp->nodep();
+                    declp->code(m_code);
+                    m_code += declp->codeInc();
+                    m_statUniqCodes += declp->codeInc();
+                    ++m_statUniqSigs;
+                }
+            }
+        }
+    }
+
     void graphSimplify(bool initial) {
         if (initial) {
             // Remove all variable nodes
@@ -453,12 +582,14 @@ private:
         // Create an array of bytes, not a bit vector, as they can be set
         // atomically by mtasks, and are cheaper to set (no need for
         // read-modify-write on the C type), and the speed of the tracing code
-        // is the same on largish designs.
+        // is the same on largish designs. The array is padded to a multiple
+        // of 8 flags, so the change dump can test 8 flags at a time as a word.
+        m_activityWords = (m_activityNumber + 7) / 8;
         FileLine* const flp = m_topScopep->fileline();
         AstNodeDType* const newScalarDtp = new AstBasicDType{flp, VFlagBitPacked{}, 1};
         v3Global.rootp()->typeTablep()->addTypesp(newScalarDtp);
         AstRange* const newArange
-            = new AstRange{flp, VNumRange{static_cast<int>(m_activityNumber) - 1, 0}};
+            = new AstRange{flp, VNumRange{static_cast<int>(m_activityWords * 8) - 1, 0}};
         AstNodeDType* const newArrDtp = new AstUnpackArrayDType{flp, newScalarDtp, newArange};
         v3Global.rootp()->typeTablep()->addTypesp(newArrDtp);
         AstVar* const newvarp
@@ -486,6 +617,115 @@ private:
         }
     }
 
+    static AstArraySel* writtenElementSel(AstVarRef* refp, AstNode* stmtp) {
+        // If 'refp' is written by assigning to one of its elements, in a way that the index
+        // can be evaluated before the assignment, return the element select, else nullptr
+        AstArraySel* const selp = VN_CAST(refp->backp(), ArraySel);
+        AstNodeAssign* const assignp = VN_CAST(stmtp, NodeAssign);
+        if (!selp || selp->fromp() != refp || !assignp) return nullptr;
+        AstNodeExpr* lhsp = selp;
+        while (AstSel* const bitSelp = VN_CAST(lhsp->backp(), Sel)) {
+            if (bitSelp->fromp() != lhsp) return nullptr;
+            lhsp = bitSelp;
+        }
+        if (assignp->lhsp() != lhsp) return nullptr;
+        const auto impure = [](const AstNode* nodep) { return !nodep->isPure(); };
+        if (selp->bitp()->exists(impure) || assignp->rhsp()->exists(impure)) return nullptr;
+        return selp;
+    }
+
+    void createWrittenFlags(const TraceVec& traces) {
+        // Large memories track which of their elements were written since the last dump,
+        // so the change dump only needs to check those. As for the activity flags, this
+        // uses one byte per element, so they can be set atomically by mtasks, padded to a
+        // multiple of 8, so the change dump can test 8 flags at a time as a word.
+        std::unordered_map<const AstVarScope*, AstVarScope*> memVscps;  // Memory -> flags
+        std::unordered_map<const AstVar*, AstVar*> memVarps;  // Memory -> flags
+        for (const auto& pair : traces) {
+            const TraceTraceVertex* const vtxp = pair.second;
+            const ActCodeSet& actSet = pair.first;
+            if (vtxp->duplicatep() || m_sharedVtxps.count(vtxp)) continue;
+            // Constant, or might be written by the user
+            if (actSet.count(TraceActivityVertex::ACTIVITY_NEVER)) continue;
+            if (actSet.count(TraceActivityVertex::ACTIVITY_ALWAYS)) continue;
+            AstTraceDecl* const declp = vtxp->nodep();
+            const AstVarRef* const refp = VN_CAST(declp->valuep(), VarRef);
+            if (!refp || !declp->arrayRange().ranged()) continue;
+            const uint32_t elements = declp->arrayRange().elements();
+            if (elements < WRITTEN_MIN_ELEMENTS) continue;
+            AstVarScope* const memVscp = refp->varScopep();
+            AstVar* const memVarp = memVscp->varp();
+            if (memVarp->isPrimaryIO() || memVscps.count(memVscp)) continue;
+            AstVar*& varpr = memVarps[memVarp];
+            if (!varpr) {
+                FileLine* const flp = memVarp->fileline();
+                AstNodeDType* const scalarDtp = new AstBasicDType{flp, VFlagBitPacked{}, 1};
+                v3Global.rootp()->typeTablep()->addTypesp(scalarDtp);
+                const int nFlags = static_cast<int>((elements + 7) / 8 * 8);
+                AstRange* const rangep = new AstRange{flp, VNumRange{nFlags - 1, 0}};
+                AstNodeDType* const arrDtp = new AstUnpackArrayDType{flp, scalarDtp, rangep};
+                v3Global.rootp()->typeTablep()->addTypesp(arrDtp);
+                varpr = new AstVar{flp, VVarType::MODULETEMP,
+                                   "__Vm_traceWritten__" + memVarp->name(), arrDtp};
+                memVscp->scopep()->modp()->addStmtsp(varpr);
+            }
+            AstVarScope* const vscp = new AstVarScope{varpr->fileline(), memVscp->scopep(), varpr};
+            memVscp->scopep()->addVarsp(vscp);
+            memVscps.emplace(memVscp, vscp);
+            m_writtenVscps.emplace(declp, vscp);
+            ++m_statWrittenMems;
+        }
+        if (memVscps.empty()) return;
+
+        // Set the flags wherever the memories are written
+        std::vector<AstVarRef*> writeps;
+        v3Global.rootp()->foreach([&](AstVarRef* refp) {
+            if (refp->access().isWriteOrRW() && memVscps.count(refp->varScopep())) {
+                writeps.push_back(refp);
+            }
+        });
+        for (AstVarRef* const refp : writeps) {
+            AstVarScope* const vscp = memVscps.at(refp->varScopep());
+            FileLine* const flp = refp->fileline();
+            AstNode* stmtp = refp;
+            while (!VN_IS(stmtp, NodeStmt)) stmtp = stmtp->backp();
+            AstNode* setterp;
+            if (AstArraySel* const selp = writtenElementSel(refp, stmtp)) {
+                // Flag the element written, unless out of bounds
+                AstNodeExpr* const bitp = selp->bitp();
+                const uint32_t elements
+                    = VN_AS(refp->varp()->dtypep()->skipRefToEnump(), UnpackArrayDType)
+                          ->elementsConst();
+                setterp = new AstAssign{
+                    flp,
+                    new AstArraySel{flp, new AstVarRef{flp, vscp, VAccess::WRITE},
+                                    bitp->cloneTree(false)},
+                    new AstConst{flp, AstConst::BitTrue{}}};
+                AstNodeExpr* condp
+                    = new AstGte{flp,
+                                 new AstConst{flp, AstConst::WidthedValue{}, bitp->width(),
+                                              elements - 1},
+                                 bitp->cloneTree(false)};
+                condp = V3Const::constifyEdit(condp);
+                if (condp->isOne()) {
+                    VL_DO_DANGLING(condp->deleteTree(), condp);
+                } else {
+                    setterp = new AstIf{flp, condp, setterp};
+                }
+            } else {
+                // Written some other way, flag all elements, this should be rare
+                const uint32_t nFlags = VN_AS(vscp->dtypep(), UnpackArrayDType)->elementsConst();
+                AstCStmt* const cstmtp
+                    = new AstCStmt{flp, new AstText{flp, "std::memset(&", true}};
+                cstmtp->addExprsp(new AstVarRef{flp, vscp, VAccess::WRITE});
+                cstmtp->addExprsp(
+                    new AstText{flp, "[0], 1, " + cvtToStr(nFlags) + ");\n", true});
+                setterp = cstmtp;
+            }
+            stmtp->addHereThisAsNext(setterp);
+        }
+    }
+
     AstCFunc* newCFunc(bool full, AstCFunc* topFuncp, int& funcNump, uint32_t baseCode = 0) {
         // Create new function
         const bool isTopFunc = topFuncp == nullptr;
@@ -517,6 +757,11 @@ private:
             if (!full) {  //
                 addInitStr("if (VL_UNLIKELY(!vlSymsp->__Vm_activity)) return;\n");
             }
+            // Time the dump with --prof-exec
+            if (v3Global.opt.profExec()) {
+                funcp->addInitsp(V3Sched::profExecSectionPush(flp, "trace"));
+                funcp->addFinalsp(V3Sched::profExecSectionPop(flp));
+            }
             // Register function
             if (full) {
                 m_regFuncp->addStmtsp(new AstText{flp, "tracep->addFullCb(", true});
@@ -589,14 +834,17 @@ private:
                                 "Canonical node should have code assigned already");
                     declp->code(canonDeclp->code());
                 } else {
-                    // This is a canonical trace node. Assign signal number and
-                    // add a TraceInc node to the full dump function.
-                    UASSERT_OBJ(declp->code() == 0, declp,
-                                "Canonical node should not have code assigned yet");
-                    declp->code(m_code);
-                    m_code += declp->codeInc();
-                    m_statUniqCodes += declp->codeInc();
-                    ++m_statUniqSigs;
+                    // This is a canonical trace node. Assign signal number, unless
+                    // allocated by allocateInstanceCodes, and add a TraceInc node to
+                    // the full dump function.
+                    if (!m_sharedVtxps.count(vtxp)) {
+                        UASSERT_OBJ(declp->code() == 0, declp,
+                                    "Canonical node should not have code assigned yet");
+                        declp->code(m_code);
+                        m_code += declp->codeInc();
+                        m_statUniqCodes += declp->codeInc();
+                        ++m_statUniqSigs;
+                    }
 
                     // Create top function if not yet created
                     if (!topFuncp) { topFuncp = newCFunc(/* full: */ true, nullptr, topFuncNum); }
@@ -630,6 +878,10 @@ private:
                                                                 : std::numeric_limits<int>::max();
         int topFuncNum = 0;
         int subFuncNum = 0;
+        // Activity words read by each sub function, absent if it always needs to run
+        std::unordered_map<const AstCFunc*, std::set<uint32_t>> subWords;
+        // Range of codes dumped by each sub function
+        std::unordered_map<const AstCFunc*, std::pair<uint32_t, uint32_t>> subCodes;
         TraceVec::const_iterator it = traces.begin();
         while (it != traces.end()) {
             AstCFunc* topFuncp = nullptr;
@@ -648,6 +900,8 @@ private:
                 const ActCodeSet& actSet = it->first;
                 // Traced value never changes, no need to add it to incremental dump
                 if (actSet.count(TraceActivityVertex::ACTIVITY_NEVER)) continue;
+                // Dumped by the functions shared between instances
+                if (m_sharedVtxps.count(vtxp)) continue;
 
                 AstTraceDecl* const declp = vtxp->nodep();
 
@@ -659,6 +913,8 @@ private:
                     baseCode = declp->code();
                     subStmts = 0;
                     subFuncp = newCFunc(/* full: */ false, topFuncp, subFuncNum, baseCode);
+                    subWords.emplace(subFuncp, std::set<uint32_t>{});
+                    subCodes.emplace(subFuncp, std::make_pair(baseCode, baseCode));
                     prevActSet = nullptr;
                     ifp = nullptr;
                 }
@@ -670,8 +926,11 @@ private:
                     AstNodeExpr* condp = nullptr;
                     if (always) {
                         condp = new AstConst{flp, 1};  // Always true, will be folded later
+                        subWords.erase(subFuncp);
                     } else {
+                        const auto wit = subWords.find(subFuncp);
                         for (const uint32_t actCode : actSet) {
+                            if (wit != subWords.end()) wit->second.insert(actCode / 8);
                             AstNodeExpr* const selp = selectActivity(flp, actCode, VAccess::READ);
                             condp = condp ? new AstOr{flp, condp, selp} : selp;
                         }
@@ -686,8 +945,15 @@ private:
                 // Add TraceInc node
                 AstTraceInc* const incp
                     = new AstTraceInc{declp->fileline(), declp, /* full: */ false, baseCode};
+                const auto wit = m_writtenVscps.find(declp);
+                if (wit != m_writtenVscps.end()) {
+                    incp->writtenp(
+                        new AstVarRef{declp->fileline(), wit->second, VAccess::READWRITE});
+                }
                 ifp->addThensp(incp);
                 subStmts += incp->nodeCount();
+                uint32_t& codeEnd = subCodes[subFuncp].second;
+                codeEnd = std::max(codeEnd, declp->code() + declp->codeInc());
 
                 // Track partitioning
                 nCodes += declp->codeInc();
@@ -695,6 +961,182 @@ private:
             if (topFuncp) {  // might be nullptr if all trailing entries were duplicates/constants
                 UINFO(5, "trace_chg_top" << topFuncNum - 1 << " codes: " << nCodes << "/"
                                          << maxCodes << endl);
+                guardChgSubFunctions(topFuncp, subWords, subCodes);
+            }
+        }
+        createSharedChgTraceFunctions(traces, topFuncNum);
+    }
+
+    void guardChgSubFunctions(
+        AstCFunc* topFuncp,
+        const std::unordered_map<const AstCFunc*, std::set<uint32_t>>& subWords,
+        const std::unordered_map<const AstCFunc*, std::pair<uint32_t, uint32_t>>& subCodes) {
+        // Skip calling sub functions when none of the activity flags they check are
+        // set. This tests the activity flags 8 at a time, so the cost of a dump
+        // mostly depends on the number of active flags, not of trace statements.
+        // Also skip them when all their codes have been disabled at run time, e.g.
+        // by VerilatedVcdC::scopeEnable.
+        FileLine* const flp = m_topScopep->fileline();
+        for (AstNode *stmtp = topFuncp->stmtsp(), *nextp; stmtp; stmtp = nextp) {
+            nextp = stmtp->nextp();
+            AstStmtExpr* const exprp = VN_CAST(stmtp, StmtExpr);
+            AstCCall* const callp = exprp ? VN_CAST(exprp->exprp(), CCall) : nullptr;
+            if (!callp) continue;
+            const auto it = subWords.find(callp->funcp());
+            const bool activity = it != subWords.end() && !it->second.empty()
+                                  && it->second.size() <= MAX_GUARD_WORDS;
+            AstNode* exprsp = nullptr;
+            if (activity) {
+                for (const uint32_t word : it->second) {
+                    const string sep = word == *it->second.begin() ? "(" : " | ";
+                    exprsp = AstNode::addNext(
+                        exprsp, new AstText{flp, sep + "VL_TRACE_ACTIVITY8(&", true});
+                    exprsp = AstNode::addNext(
+                        exprsp, new AstVarRef{flp, m_activityVscp, VAccess::READ});
+                    exprsp = AstNode::addNext(
+                        exprsp, new AstText{flp, "[" + cvtToStr(word * 8) + "])", true});
+                }
+                exprsp = AstNode::addNext(exprsp, new AstText{flp, ") && ", true});
+            }
+            const std::pair<uint32_t, uint32_t>& codes = subCodes.at(callp->funcp());
+            if (codes.first == codes.second) {  // Empty sub function
+                if (!activity) continue;
+                exprsp = AstNode::addNext(exprsp, new AstText{flp, "true", true});
+            } else {
+                exprsp = AstNode::addNext(
+                    exprsp, new AstText{flp,
+                                        "bufp->anyEnabled(vlSymsp->__Vm_baseCode + "
+                                            + cvtToStr(codes.first)
+                                            + ", vlSymsp->__Vm_baseCode + "
+                                            + cvtToStr(codes.second) + ")",
+                                        true});
+            }
+            AstCExpr* const condp = new AstCExpr{flp, exprsp};
+            condp->dtypeSetBit();
+            AstIf* const ifp = new AstIf{flp, condp};
+            if (activity) ifp->branchPred(VBranchPred::BP_UNLIKELY);
+            stmtp->replaceWith(ifp);
+            ifp->addThensp(stmtp);
+        }
+    }
+
+    AstCFunc* newInstCFunc(AstScope* scopep, int& funcNump) {
+        // Create change dump sub function shared by the instances of a group. It is placed
+        // in the representative instance, so V3Descope makes its variable references
+        // relative to the instance pointer it is called with.
+        FileLine* const flp = m_topScopep->fileline();
+        AstCFunc* const funcp
+            = new AstCFunc{flp, "trace_chg_inst_" + cvtToStr(funcNump++), scopep};
+        funcp->isTrace(true);
+        funcp->dontCombine(true);
+        funcp->isLoose(true);
+        funcp->slow(false);
+        funcp->isStatic(false);
+        funcp->argTypes(v3Global.opt.traceClassBase()
+                        + "::" + (v3Global.opt.useTraceOffload() ? "OffloadBuffer" : "Buffer")
+                        + "* bufp, uint32_t instCode");
+        scopep->addBlocksp(funcp);
+        if (v3Global.opt.useTraceOffload()) {
+            funcp->addInitsp(new AstCStmt{flp, "const uint32_t base VL_ATTR_UNUSED = "
+                                               "vlSymsp->__Vm_baseCode + instCode;\n"});
+            funcp->addInitsp(new AstCStmt{flp, "if (false && bufp) {}  // Prevent unused\n"});
+        } else {
+            funcp->addInitsp(new AstCStmt{flp, "uint32_t* const oldp VL_ATTR_UNUSED = "
+                                               "bufp->oldp(vlSymsp->__Vm_baseCode + instCode);\n"});
+        }
+        UINFO(5, "  newInstCFunc " << funcp << endl);
+        return funcp;
+    }
+
+    void createSharedChgTraceFunctions(const TraceVec& traces, int& topFuncNum) {
+        // Create the change dump functions shared between the instances of each group, and
+        // a top function calling them for each instance. The activity of an instance is the
+        // union of the activity of its traces, so all traces of an instance in a function
+        // are checked when any of them might have changed.
+        if (m_instGroups.empty()) return;
+        const int splitLimit = v3Global.opt.outputSplitCTrace() ? v3Global.opt.outputSplitCTrace()
+                                                                : std::numeric_limits<int>::max();
+        std::unordered_map<const TraceTraceVertex*, const ActCodeSet*> actSets;
+        for (const auto& pair : traces) actSets.emplace(pair.second, &pair.first);
+        const auto isConstant = [&](const TraceTraceVertex* vtxp) {
+            return actSets.at(vtxp)->count(TraceActivityVertex::ACTIVITY_NEVER) != 0;
+        };
+
+        FileLine* const flp = m_topScopep->fileline();
+        AstCFunc* const topFuncp = newCFunc(/* full: */ false, nullptr, topFuncNum);
+        int subFuncNum = 0;
+        for (const InstanceGroup& group : m_instGroups) {
+            const std::vector<TraceTraceVertex*>& reprVtxps = group.front().m_vtxps;
+            size_t pos = 0;
+            while (pos < reprVtxps.size()) {
+                // Fill the next function, skipping traces constant in all instances
+                AstCFunc* funcp = nullptr;
+                uint32_t baseCode = 0;
+                int stmts = 0;
+                std::vector<size_t> positions;  // Indices of traces dumped by funcp
+                for (; pos < reprVtxps.size() && stmts <= splitLimit; ++pos) {
+                    if (std::all_of(group.begin(), group.end(), [&](const TraceInstance& inst) {
+                            return isConstant(inst.m_vtxps[pos]);
+                        })) {
+                        continue;
+                    }
+                    AstTraceDecl* const declp = reprVtxps[pos]->nodep();
+                    if (!funcp) {
+                        baseCode = declp->code();
+                        funcp = newInstCFunc(group.front().m_scopep, subFuncNum);
+                    }
+                    AstTraceInc* const incp
+                        = new AstTraceInc{declp->fileline(), declp, /* full: */ false, baseCode};
+                    funcp->addStmtsp(incp);
+                    stmts += incp->nodeCount();
+                    positions.push_back(pos);
+                }
+                if (!funcp) continue;
+
+                // Call it for each instance, when its traces might have changed
+                for (const TraceInstance& inst : group) {
+                    ActCodeSet actSet;
+                    for (const size_t i : positions) {
+                        const ActCodeSet& codes = *actSets.at(inst.m_vtxps[i]);
+                        actSet.insert(codes.begin(), codes.end());
+                    }
+                    actSet.erase(TraceActivityVertex::ACTIVITY_NEVER);
+                    if (actSet.empty()) continue;  // All constant in this instance
+                    const AstTraceDecl* const firstp = inst.m_vtxps[positions.front()]->nodep();
+                    const AstTraceDecl* const lastp = inst.m_vtxps[positions.back()]->nodep();
+                    const uint32_t codeBegin = firstp->code();
+                    const uint32_t codeEnd = lastp->code() + lastp->codeInc();
+
+                    // Skip the call when all its codes are disabled at run time
+                    AstNodeExpr* condp = new AstCExpr{
+                        flp, new AstText{flp,
+                                         "bufp->anyEnabled(vlSymsp->__Vm_baseCode + "
+                                             + cvtToStr(codeBegin)
+                                             + ", vlSymsp->__Vm_baseCode + "
+                                             + cvtToStr(codeEnd) + ")",
+                                         true}};
+                    condp->dtypeSetBit();
+                    const bool always = actSet.count(TraceActivityVertex::ACTIVITY_ALWAYS) != 0;
+                    if (!always) {
+                        AstNodeExpr* activep = nullptr;
+                        for (const uint32_t actCode : actSet) {
+                            AstNodeExpr* const selp = selectActivity(flp, actCode, VAccess::READ);
+                            activep = activep ? new AstOr{flp, activep, selp} : selp;
+                        }
+                        condp = new AstLogAnd{flp, activep, condp};
+                    }
+                    AstIf* const ifp = new AstIf{flp, condp};
+                    if (!always) ifp->branchPred(VBranchPred::BP_UNLIKELY);
+                    const string selfPointer
+                        = VIdProtect::protectWordsIf("(&" + inst.m_scopep->nameVlSym() + ")");
+                    AstNode* const textsp = new AstText{flp, "(", true};
+                    textsp->addNext(new AstAddrOfCFunc{flp, funcp});
+                    textsp->addNext(new AstText{
+                        flp, ")(" + selfPointer + ", bufp, " + cvtToStr(codeBegin) + ");\n",
+                        true});
+                    ifp->addThensp(new AstCStmt{flp, textsp});
+                    topFuncp->addStmtsp(ifp);
+                }
             }
         }
     }
@@ -721,8 +1163,8 @@ private:
         cleanupFuncp->addStmtsp(new AstCStmt{m_topScopep->fileline(),
                                              std::string{"vlSymsp->__Vm_activity = false;\n"}});
 
-        // Clear fine grained activity flags
-        for (uint32_t i = 0; i < m_activityNumber; ++i) {
+        // Clear fine grained activity flags, including the padding
+        for (uint32_t i = 0; i < m_activityWords * 8; ++i) {
             AstNode* const clrp = new AstAssign{fl, selectActivity(fl, i, VAccess::WRITE),
                                                 new AstConst{fl, AstConst::BitFalse{}}};
             cleanupFuncp->addStmtsp(clrp);
@@ -767,6 +1209,15 @@ private:
         m_regFuncp->isLoose(true);
         m_topScopep->addBlocksp(m_regFuncp);
 
+        // Find instances that can share change dump functions, and allocate their codes
+        if (v3Global.opt.traceShareInstances()) {
+            findInstanceGroups();
+            allocateInstanceCodes();
+        }
+
+        // Track the elements written of large memories
+        createWrittenFlags(traces);
+
         // Create the full dump functions, also allocates signal numbers
         createFullTraceFunction(traces, nFullCodes, m_parallelism);
 
@@ -854,7 +1305,8 @@ private:
         if (!m_finding) {  // If public, we need a unique activity code to allow for sets
                            // directly in this func
             if (nodep->funcPublic() || nodep->dpiExportImpl() || nodep == v3Global.rootp()->evalp()
-                || nodep->isCoroutine()) {
+                || nodep == v3Global.rootp()->evalClockp() || nodep->isCoroutine()
+                || nodep->isStateMachine()) {
                 // Cannot treat a coroutine as slow, it may be resumed later
                 const bool slow = nodep->slow() && !nodep->isCoroutine();
                 V3GraphVertex* const activityVtxp = getActivityVertexp(nodep, slow);
@@ -915,6 +1367,7 @@ public:
     ~TraceVisitor() override {
         V3Stats::addStat("Tracing, Unique traced signals", m_statUniqSigs);
         V3Stats::addStat("Tracing, Unique trace codes", m_statUniqCodes);
+        V3Stats::addStat("Tracing, Memories tracking written elements", m_statWrittenMems);
     }
 };
 
@@ -356,7 +356,10 @@ private:
     void visit(AstUnpackArrayDType* nodep) override {
         // Note more specific dtypes above
         if (m_traVscp) {
-            if (static_cast<int>(nodep->arrayUnpackedElements()) > v3Global.opt.traceMaxArray()) {
+            if (nodep->isSparse()) {
+                addIgnore("Sparse array, see --sparse-arrays");
+            } else if (static_cast<int>(nodep->arrayUnpackedElements())
+                       > v3Global.opt.traceMaxArray()) {
                 addIgnore("Wide memory > --trace-max-array ents");
             } else if (VN_IS(nodep->subDTypep()->skipRefToEnump(),
                              BasicDType)  // Nothing lower than this array
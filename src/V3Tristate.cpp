@@ -440,6 +440,7 @@ class TristateVisitor final : public TristateBaseVisitor {
 
     // STATS
     VDouble0 m_statTriSigs;  // stat tracking
+    VDouble0 m_statTriMuxes;  // stat tracking
 
     // METHODS
     string dbgState() const {
@@ -653,9 +654,99 @@ class TristateVisitor final : public TristateBaseVisitor {
         }
     }
 
+    static AstNodeExpr* enableCondp(AstNodeExpr* enp) {
+        // If the enable is 'cond ? '1 : '0', as from 'cond ? value : 'z', return cond
+        const AstCond* const condp = VN_CAST(enp, Cond);
+        if (!condp) return nullptr;
+        const AstConst* const thenp = VN_CAST(condp->thenp(), Const);
+        const AstConst* const elsep = VN_CAST(condp->elsep(), Const);
+        if (!thenp || !elsep || !thenp->num().isEqAllOnes() || !elsep->num().isEqZero()) {
+            return nullptr;
+        }
+        return condp->condp();
+    }
+    static bool exclusiveConditions(const std::vector<AstNodeExpr*>& condps) {
+        // True if the conditions compare the same expression against distinct constants, so at
+        // most one can be true
+        const AstNode* firstExprp = nullptr;
+        std::vector<const AstConst*> constps;
+        for (const AstNodeExpr* const condp : condps) {
+            const AstEq* const eqp = VN_CAST(condp, Eq);
+            if (!eqp) return false;
+            const AstConst* constp = VN_CAST(eqp->lhsp(), Const);
+            const AstNode* exprp = eqp->rhsp();
+            if (!constp) {
+                constp = VN_CAST(eqp->rhsp(), Const);
+                exprp = eqp->lhsp();
+            }
+            if (!constp || constp->num().isFourState() || !exprp->isPure()) return false;
+            if (!firstExprp) {
+                firstExprp = exprp;
+            } else if (!exprp->sameTree(firstExprp)) {
+                return false;
+            }
+            for (const AstConst* const otherp : constps) {
+                if (otherp->num().isCaseEq(constp->num())) return false;
+            }
+            constps.push_back(constp);
+        }
+        return true;
+    }
+    bool aggregateTriExclusive(AstNodeModule* nodep, AstVar* const varp, AstVar* const envarp,
+                               RefStrengthVec::iterator beginStrength,
+                               RefStrengthVec::iterator endStrength) {
+        // If at most one driver is enabled at a time, as in a bus with drivers selected by
+        // comparing the same signal with distinct constants, the drivers are combined with a
+        // single mux, with no per driver enable variables. Returns false if not applicable.
+        if (endStrength - beginStrength < 2) return false;
+        std::vector<AstNodeExpr*> condps;
+        for (auto it = beginStrength; it != endStrength; ++it) {
+            // Peek at the enable, getEnp is called once the reference no longer is to a port
+            AstNodeExpr* const enp = VN_CAST(it->m_varrefp->user1p(), NodeExpr);
+            AstNodeExpr* const condp = enp ? enableCondp(enp) : nullptr;
+            if (!condp) return false;
+            condps.push_back(condp);
+        }
+        if (!exclusiveConditions(condps)) return false;
+        ++m_statTriMuxes;
+
+        AstNodeExpr* muxp = newAllZerosOrOnes(varp, false);
+        AstNodeExpr* orEnp = nullptr;
+        size_t i = condps.size();
+        for (auto it = endStrength; it != beginStrength;) {
+            --it;
+            --i;
+            AstVarRef* const refp = it->m_varrefp;
+            FileLine* const flp = refp->fileline();
+            // create the new lhs driver for this var, only read when enabled
+            AstVar* const newLhsp = new AstVar{varp->fileline(), VVarType::MODULETEMP,
+                                               varp->name() + "__out" + cvtToStr(m_unique++),
+                                               VFlagBitPacked{}, varp->width()};
+            UINFO(9, "       newout " << newLhsp << endl);
+            nodep->addStmtsp(newLhsp);
+            refp->varp(newLhsp);  // assign the new var to the varref
+            refp->name(newLhsp->name());
+
+            muxp = new AstCond{flp, condps[i]->cloneTree(false),
+                               new AstVarRef{flp, newLhsp, VAccess::READ}, muxp};
+            AstNodeExpr* const enp = getEnp(refp);
+            orEnp = !orEnp ? enp : new AstOr{flp, enp, orEnp};
+        }
+        AstNode* const assp = new AstAssignW{
+            varp->fileline(), new AstVarRef{varp->fileline(), varp, VAccess::WRITE}, muxp};
+        UINFO(9, "       newassp " << assp << endl);
+        nodep->addStmtsp(assp);
+
+        AstNode* const enAssp = new AstAssignW{
+            envarp->fileline(), new AstVarRef{envarp->fileline(), envarp, VAccess::WRITE}, orEnp};
+        UINFO(9, "       newenassp " << enAssp << endl);
+        nodep->addStmtsp(enAssp);
+        return true;
+    }
     void aggregateTriSameStrength(AstNodeModule* nodep, AstVar* const varp, AstVar* const envarp,
                                   RefStrengthVec::iterator beginStrength,
                                   RefStrengthVec::iterator endStrength) {
+        if (aggregateTriExclusive(nodep, varp, envarp, beginStrength, endStrength)) return;
         // For each driver separate variables (normal and __en) are created and initialized with
         // values. In case of normal variable, the original expression is reused. Their values are
         // aggregated using | to form one expression, which are assigned to varp end envarp.
@@ -1809,6 +1900,7 @@ public:
     }
     ~TristateVisitor() override {
         V3Stats::addStat("Tristate, Tristate resolved nets", m_statTriSigs);
+        V3Stats::addStat("Tristate, Tristate one-hot muxes", m_statTriMuxes);
     }
 };
 
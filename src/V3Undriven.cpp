@@ -16,7 +16,7 @@
 // V3Undriven's Transformations:
 //
 // Netlist:
-//      Make vector for all variables
+//      Make bit ranges for all variables
 //      SEL(VARREF(...))) mark only some bits as used/driven
 //      else VARREF(...) mark all bits as used/driven
 //      Report unused/undriven nets
@@ -34,18 +34,58 @@
 #include "V3String.h"
 
 #include <algorithm>
+#include <array>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
 
+//######################################################################
+// Set of bits, as sorted disjoint ranges, so wide variables need no per-bit storage
+
+class UndrivenBitRanges final {
+    // MEMBERS
+    std::vector<std::pair<int, int>> m_ranges;  // [lsb, msb] of each range, ascending
+
+public:
+    // METHODS
+    void add(int lsb, int msb) {
+        // Merge with all overlapping or adjacent ranges
+        auto it = std::lower_bound(
+            m_ranges.begin(), m_ranges.end(), lsb - 1,
+            [](const std::pair<int, int>& range, int value) { return range.second < value; });
+        auto endIt = it;
+        for (; endIt != m_ranges.end() && endIt->first <= msb + 1; ++endIt) {
+            lsb = std::min(lsb, endIt->first);
+            msb = std::max(msb, endIt->second);
+        }
+        it = m_ranges.erase(it, endIt);
+        m_ranges.emplace(it, lsb, msb);
+    }
+    bool contains(int bit) const {
+        const auto it = std::lower_bound(
+            m_ranges.begin(), m_ranges.end(), bit,
+            [](const std::pair<int, int>& range, int value) { return range.second < value; });
+        return it != m_ranges.end() && it->first <= bit;
+    }
+    // Add the bit after each range end, and each range start, that are within (lsb, msb]
+    void addBoundaries(int lsb, int msb, std::vector<int>& boundaries) const {
+        for (const auto& range : m_ranges) {
+            if (range.first > lsb && range.first <= msb) boundaries.push_back(range.first);
+            if (range.second >= lsb && range.second < msb) boundaries.push_back(range.second + 1);
+        }
+    }
+};
+
 //######################################################################
 // Class for every variable we may process
 
 class UndrivenVarEntry final {
     // MEMBERS
     AstVar* const m_varp;  // Variable this tracks
-    std::vector<bool> m_wholeFlags;  // Used/Driven on whole vector
-    std::vector<bool> m_bitFlags;  // Used/Driven on each subbit
+    const int m_width;  // Number of bits tracked
+    std::array<bool, 3> m_wholeFlags{};  // Used/Driven on whole vector
+    UndrivenBitRanges m_usedBits;  // Bits used
+    UndrivenBitRanges m_drivenBits;  // Bits driven
     const AstAlways* m_alwCombp
         = nullptr;  // always_comb of var if driven within always_comb, else nullptr
     const FileLine* m_alwCombFileLinep = nullptr;  // File line of always_comb of var if driven
@@ -54,62 +94,69 @@ class UndrivenVarEntry final {
     const FileLine* m_nodeFileLinep = nullptr;  // File line of varref if driven, else nullptr
     bool m_underGen = false;  // Under a generate
 
-    enum : uint8_t { FLAG_USED = 0, FLAG_DRIVEN = 1, FLAG_DRIVEN_ALWCOMB = 2, FLAGS_PER_BIT = 3 };
+    enum : uint8_t { FLAG_USED = 0, FLAG_DRIVEN = 1, FLAG_DRIVEN_ALWCOMB = 2 };
 
 public:
     // CONSTRUCTORS
     explicit UndrivenVarEntry(AstVar* varp)
-        : m_varp(varp) {  // Construction for when a var is used
+        : m_varp(varp)
+        , m_width{varp->width()} {  // Construction for when a var is used
         UINFO(9, "create " << varp << endl);
-        m_wholeFlags.resize(FLAGS_PER_BIT);
-        for (int i = 0; i < FLAGS_PER_BIT; i++) m_wholeFlags[i] = false;
-        m_bitFlags.resize(varp->width() * FLAGS_PER_BIT);
-        for (int i = 0; i < varp->width() * FLAGS_PER_BIT; i++) m_bitFlags[i] = false;
     }
     ~UndrivenVarEntry() = default;
 
 private:
     // METHODS
-    bool bitNumOk(int bit) const {
-        return bit >= 0 && (bit * FLAGS_PER_BIT < static_cast<int>(m_bitFlags.size()));
-    }
-    bool usedFlag(int bit) const {
-        return m_wholeFlags[FLAG_USED] || m_bitFlags[bit * FLAGS_PER_BIT + FLAG_USED];
-    }
+    bool usedFlag(int bit) const { return m_wholeFlags[FLAG_USED] || m_usedBits.contains(bit); }
     bool drivenFlag(int bit) const {
-        return m_wholeFlags[FLAG_DRIVEN] || m_bitFlags[bit * FLAGS_PER_BIT + FLAG_DRIVEN];
+        return m_wholeFlags[FLAG_DRIVEN] || m_drivenBits.contains(bit);
+    }
+    // Call 'f(lsb, msb, used, driven)' for each run of bits in [lsb, msb] with the same
+    // state, lowest first
+    template <typename T_Func>
+    void foreachRun(int lsb, int msb, T_Func f) const {
+        lsb = std::max(lsb, 0);
+        msb = std::min(msb, m_width - 1);
+        if (lsb > msb) return;
+        std::vector<int> boundaries{lsb, msb + 1};
+        m_usedBits.addBoundaries(lsb, msb, boundaries);
+        m_drivenBits.addBoundaries(lsb, msb, boundaries);
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+        for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+            const int bit = boundaries[i];
+            f(bit, boundaries[i + 1] - 1, usedFlag(bit), drivenFlag(bit));
+        }
     }
     enum BitNamesWhich : uint8_t { BN_UNUSED, BN_UNDRIVEN, BN_BOTH };
     string bitNames(BitNamesWhich which) {
-        string bits;
-        bool prev = false;
-        int msb = 0;
-        // bit==-1 loops below; we do one extra iteration so end with prev=false
-        for (int bit = (m_bitFlags.size() / FLAGS_PER_BIT) - 1; bit >= -1; --bit) {
-            if (bit >= 0
-                && ((which == BN_UNUSED && !usedFlag(bit) && drivenFlag(bit))
-                    || (which == BN_UNDRIVEN && usedFlag(bit) && !drivenFlag(bit))
-                    || (which == BN_BOTH && !usedFlag(bit) && !drivenFlag(bit)))) {
-                if (!prev) {
-                    prev = true;
-                    msb = bit;
+        // Matching runs, with adjacent runs joined
+        std::vector<std::pair<int, int>> runs;
+        foreachRun(0, m_width - 1, [&](int lsb, int msb, bool used, bool driven) {
+            if ((which == BN_UNUSED && !used && driven)
+                || (which == BN_UNDRIVEN && used && !driven)
+                || (which == BN_BOTH && !used && !driven)) {
+                if (!runs.empty() && runs.back().second + 1 == lsb) {
+                    runs.back().second = msb;
+                } else {
+                    runs.emplace_back(lsb, msb);
                 }
-            } else if (prev) {
-                const AstBasicDType* const bdtypep = m_varp->basicp();
-                const int lsb = bit + 1;
-                if (bits != "") bits += ",";
-                if (lsb == msb) {
-                    bits += cvtToStr(lsb + bdtypep->lo());
+            }
+        });
+        const AstBasicDType* const bdtypep = m_varp->basicp();
+        string bits;
+        for (auto it = runs.rbegin(); it != runs.rend(); ++it) {
+            const int lsb = it->first;
+            const int msb = it->second;
+            if (bits != "") bits += ",";
+            if (lsb == msb) {
+                bits += cvtToStr(lsb + bdtypep->lo());
+            } else {
+                if (bdtypep->ascending()) {
+                    bits += cvtToStr(lsb + bdtypep->lo()) + ":" + cvtToStr(msb + bdtypep->lo());
                 } else {
-                    if (bdtypep->ascending()) {
-                        bits
-                            += cvtToStr(lsb + bdtypep->lo()) + ":" + cvtToStr(msb + bdtypep->lo());
-                    } else {
-                        bits
-                            += cvtToStr(msb + bdtypep->lo()) + ":" + cvtToStr(lsb + bdtypep->lo());
-                    }
+                    bits += cvtToStr(msb + bdtypep->lo()) + ":" + cvtToStr(lsb + bdtypep->lo());
                 }
-                prev = false;
             }
         }
         return "[" + bits + "]";
@@ -144,29 +191,25 @@ public:
     const FileLine* getAlwCombFileLinep() const { return m_alwCombFileLinep; }
     void usedBit(int bit, int width) {
         UINFO(9, "set u[" << (bit + width - 1) << ":" << bit << "] " << m_varp->name() << endl);
-        for (int i = 0; i < width; i++) {
-            if (bitNumOk(bit + i)) m_bitFlags[(bit + i) * FLAGS_PER_BIT + FLAG_USED] = true;
-        }
+        const int lsb = std::max(bit, 0);
+        const int msb = std::min(bit + width - 1, m_width - 1);
+        if (lsb <= msb) m_usedBits.add(lsb, msb);
     }
     void drivenBit(int bit, int width) {
         UINFO(9, "set d[" << (bit + width - 1) << ":" << bit << "] " << m_varp->name() << endl);
-        for (int i = 0; i < width; i++) {
-            if (bitNumOk(bit + i)) m_bitFlags[(bit + i) * FLAGS_PER_BIT + FLAG_DRIVEN] = true;
-        }
+        const int lsb = std::max(bit, 0);
+        const int msb = std::min(bit + width - 1, m_width - 1);
+        if (lsb <= msb) m_drivenBits.add(lsb, msb);
     }
     bool isUsedNotDrivenBit(int bit, int width) const {
-        for (int i = 0; i < width; i++) {
-            if (bitNumOk(bit + i)
-                && (m_wholeFlags[FLAG_USED] || m_bitFlags[(bit + i) * FLAGS_PER_BIT + FLAG_USED])
-                && !(m_wholeFlags[FLAG_DRIVEN]
-                     || m_bitFlags[(bit + i) * FLAGS_PER_BIT + FLAG_DRIVEN]))
-                return true;
-        }
-        return false;
-    }
-    bool isUsedNotDrivenAny() const {
-        return isUsedNotDrivenBit(0, m_bitFlags.size() / FLAGS_PER_BIT);
+        if (m_wholeFlags[FLAG_DRIVEN]) return false;
+        bool found = false;
+        foreachRun(bit, bit + width - 1, [&](int, int, bool used, bool driven) {
+            found |= used && !driven;
+        });
+        return found;
     }
+    bool isUsedNotDrivenAny() const { return isUsedNotDrivenBit(0, m_width); }
     bool unusedMatch(AstVar* nodep) {
         const string regexp = v3Global.opt.unusedRegexp();
         if (regexp == "") return false;
@@ -197,9 +240,7 @@ public:
             bool anyUnotD = false;
             bool anyDnotU = false;
             bool anynotDU = false;
-            for (unsigned bit = 0; bit < m_bitFlags.size() / FLAGS_PER_BIT; bit++) {
-                const bool used = usedFlag(bit);
-                const bool driv = drivenFlag(bit);
+            foreachRun(0, m_width - 1, [&](int, int, bool used, bool driv) {
                 allU &= used;
                 anyU |= used;
                 allD &= driv;
@@ -207,7 +248,7 @@ public:
                 anyUnotD |= used && !driv;
                 anyDnotU |= !used && driv;
                 anynotDU |= !used && !driv;
-            }
+            });
             if (allU) m_wholeFlags[FLAG_USED] = true;
             if (allD) m_wholeFlags[FLAG_DRIVEN] = true;
             // Test results
@@ -63,11 +63,35 @@ private:
     bool m_constXCvt = false;  // Convert X's
     bool m_allowXUnique = true;  // Allow unique assignments
     VDouble0 m_statUnkVars;  // Statistic tracking
+    VDouble0 m_statBoundsInRange;  // Statistic tracking
+    VDouble0 m_statBoundsMasked;  // Statistic tracking
     V3UniqueNames m_lvboundNames;  // For generating unique temporary variable names
     V3UniqueNames m_xrandNames;  // For generating unique temporary variable names
 
     // METHODS
 
+    // Upper bound on the value of an unsigned index expression
+    static uint64_t maxValue(const AstNodeExpr* nodep) {
+        const uint64_t widthMax = nodep->width() >= 64 ? ~0ULL : (1ULL << nodep->width()) - 1;
+        if (const AstConst* const constp = VN_CAST(nodep, Const)) {
+            if (!constp->num().isFourState() && constp->num().mostSetBitP1() <= 64) {
+                return constp->num().toUQuad();
+            }
+        } else if (const AstExtend* const extendp = VN_CAST(nodep, Extend)) {
+            return maxValue(extendp->lhsp());
+        } else if (const AstAnd* const andp = VN_CAST(nodep, And)) {
+            return std::min(maxValue(andp->lhsp()), maxValue(andp->rhsp()));
+        } else if (const AstShiftR* const shiftp = VN_CAST(nodep, ShiftR)) {
+            const AstConst* const amountp = VN_CAST(shiftp->rhsp(), Const);
+            if (amountp && !amountp->num().isFourState() && amountp->num().mostSetBitP1() <= 6) {
+                return maxValue(shiftp->lhsp()) >> amountp->num().toUInt();
+            }
+        } else if (const AstNodeCond* const condp = VN_CAST(nodep, NodeCond)) {
+            return std::max(maxValue(condp->thenp()), maxValue(condp->elsep()));
+        }
+        return widthMax;
+    }
+
     void replaceBoundLvalue(AstNodeExpr* nodep, AstNodeExpr* condp) {
         // Spec says a out-of-range LHS SEL results in a NOP.
         // This is a PITA.  We could:
@@ -392,6 +416,11 @@ private:
             // Similar code in V3Const::warnSelect
             const int maxmsb = nodep->fromp()->dtypep()->width() - 1;
             if (debug() >= 9) nodep->dumpTree("-  sel_old: ");
+            if (maxValue(nodep->lsbp()) <= static_cast<uint64_t>(maxmsb)) {
+                // Range of the index proves it is in bounds
+                ++m_statBoundsInRange;
+                return;
+            }
 
             // If (maxmsb >= selected), we're in bound
             AstNodeExpr* condp
@@ -451,6 +480,29 @@ private:
                 nodep->v3error("Select from non-array " << dtypep->prettyTypeName());
             }
             if (debug() >= 9) nodep->dumpTree("-  arraysel_old: ");
+            if (declElements > 0
+                && maxValue(nodep->bitp()) <= static_cast<uint64_t>(declElements - 1)) {
+                // Range of the index proves it is in bounds
+                ++m_statBoundsInRange;
+                return;
+            }
+            const AstNodeDType* const elemDTypep = nodep->dtypep()->skipRefp();
+            if (!lvalue && declElements > 0 && (declElements & (declElements - 1)) == 0
+                && v3Global.opt.xAssign() == "fast" && !nodep->isString()
+                && (elemDTypep->isIntegralOrPacked() || VN_IS(elemDTypep, NodeArrayDType))) {
+                // An out of bounds read may give any value, so rather than compare and
+                // branch, wrap the index into the power of two sized array
+                // ARRAYSEL(...) -> ARRAYSEL(AND(bit, elements-1))
+                FileLine* const fl = nodep->bitp()->fileline();
+                VNRelinker replaceHandle;
+                AstNodeExpr* const bitp = nodep->bitp()->unlinkFrBack(&replaceHandle);
+                replaceHandle.relink(new AstAnd{
+                    fl, bitp,
+                    new AstConst{fl, AstConst::WidthedValue{}, bitp->width(),
+                                 static_cast<uint32_t>(declElements - 1)}});
+                ++m_statBoundsMasked;
+                return;
+            }
 
             // See if the condition is constant true
             AstNodeExpr* condp
@@ -510,6 +562,8 @@ public:
     }
     ~UnknownVisitor() override {  //
         V3Stats::addStat("Unknowns, variables created", m_statUnkVars);
+        V3Stats::addStat("Optimizations, Bounds checks proven in range", m_statBoundsInRange);
+        V3Stats::addStat("Optimizations, Bounds checks masked", m_statBoundsMasked);
     }
 };
 
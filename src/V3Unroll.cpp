@@ -44,6 +44,14 @@ VL_DEFINE_DEBUG_FUNCTIONS;
 
 class UnrollVisitor final : public VNVisitor {
 private:
+    // CONSTANTS
+    // Loops that cannot be fully unrolled may be partially unrolled, by up to this many copies
+    static constexpr int PARTIAL_MAX_FACTOR = 8;
+    // Maximum size of a partially unrolled loop body, in nodes
+    static constexpr int PARTIAL_MAX_STMTS = 512;
+    // Maximum iterations counted to find a partial unroll factor, if above --unroll-count
+    static constexpr int PARTIAL_MAX_COUNT = 4096;
+
     // STATE
     AstVar* m_forVarp;  // Iterator variable
     const AstVarScope* m_forVscp;  // Iterator variable scope (nullptr for generate pass)
@@ -57,6 +65,7 @@ private:
     string m_beginName;  // What name to give begin iterations
     VDouble0 m_statLoops;  // Statistic tracking
     VDouble0 m_statIters;  // Statistic tracking
+    VDouble0 m_statPartialLoops;  // Statistic tracking
 
     // METHODS
 
@@ -162,7 +171,13 @@ private:
 
             // Check whether to we actually want to try and unroll.
             int loops;
-            if (!countLoops(initAssp, condp, incp, m_unrollLimit, loops)) {
+            const int countLimit
+                = m_unrollLimit > PARTIAL_MAX_COUNT ? m_unrollLimit : PARTIAL_MAX_COUNT;
+            if (!countLoops(initAssp, condp, incp, countLimit, loops)) {
+                return cantUnroll(nodep, "Unable to simulate loop");
+            }
+            if (loops > m_unrollLimit) {
+                if (partialUnroll(nodep, precondsp, incp, bodysp, loops)) return false;
                 return cantUnroll(nodep, "Unable to simulate loop");
             }
 
@@ -173,6 +188,7 @@ private:
             if (bodySizeOverRecurse(precondsp, bodySize /*ref*/, bodyLimit)
                 || bodySizeOverRecurse(bodysp, bodySize /*ref*/, bodyLimit)
                 || bodySizeOverRecurse(incp, bodySize /*ref*/, bodyLimit)) {
+                if (partialUnroll(nodep, precondsp, incp, bodysp, loops)) return false;
                 return cantUnroll(nodep, "too many statements");
             }
         }
@@ -185,6 +201,39 @@ private:
         return true;
     }
 
+    // Replicate the body of a loop with a known iteration count that is too large to fully
+    // unroll, so the condition is evaluated only once every 'factor' iterations. The loop
+    // variable is only assigned by the increment, and the condition depends only on it, so
+    // the condition holds at every intermediate point when 'factor' divides 'loops'.
+    // Returns true if did so; the loop itself is kept.
+    bool partialUnroll(AstNode* nodep, AstNode* precondsp, AstNode* incp, AstNode* bodysp,
+                       int loops) {
+        if (!VN_IS(nodep, While) || !bodysp || bodysp == incp) return false;
+        int bodySize = 0;
+        if (bodySizeOverRecurse(precondsp, bodySize /*ref*/, PARTIAL_MAX_STMTS)
+            || bodySizeOverRecurse(bodysp, bodySize /*ref*/, PARTIAL_MAX_STMTS)
+            || bodySizeOverRecurse(incp, bodySize /*ref*/, PARTIAL_MAX_STMTS)) {
+            return false;
+        }
+        int factor = PARTIAL_MAX_STMTS / bodySize;
+        if (factor > PARTIAL_MAX_FACTOR) factor = PARTIAL_MAX_FACTOR;
+        while (factor > 1 && loops % factor) --factor;
+        if (factor < 2) return false;
+        UINFO(4, "   Partial unroll by " << factor << " of " << loops << ": " << nodep << endl);
+        // Body, then increment, then preconditions for the next iteration, then body again...
+        AstNode* newp = nullptr;
+        for (int i = 1; i < factor; ++i) {
+            for (AstNode* stmtp = bodysp; stmtp && stmtp != incp; stmtp = stmtp->nextp()) {
+                newp = AstNode::addNext(newp, stmtp->cloneTree(false));
+            }
+            newp = AstNode::addNext(newp, incp->cloneTree(false));
+            if (precondsp) newp = AstNode::addNext(newp, precondsp->cloneTree(true));
+        }
+        bodysp->addHereThisAsNext(newp);
+        ++m_statPartialLoops;
+        return true;
+    }
+
     bool canSimulate(AstNode* nodep) {
         SimulateVisitor simvis;
         AstNode* clonep = nodep->cloneTree(true);
@@ -473,6 +522,7 @@ public:
     ~UnrollVisitor() override {
         V3Stats::addStatSum("Optimizations, Unrolled Loops", m_statLoops);
         V3Stats::addStatSum("Optimizations, Unrolled Iterations", m_statIters);
+        V3Stats::addStatSum("Optimizations, Partially unrolled loops", m_statPartialLoops);
     }
     // METHODS
     void init(bool generate, const string& beginName) {
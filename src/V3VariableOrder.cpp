@@ -27,11 +27,14 @@
 
 #include "V3Ast.h"
 #include "V3AstUserAllocator.h"
+#include "V3Config.h"
 #include "V3EmitCBase.h"
 #include "V3Global.h"
+#include "V3PartitionGraph.h"
 #include "V3TSP.h"
 
 #include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 VL_DEFINE_DEBUG_FUNCTIONS;
@@ -78,11 +81,21 @@ public:
 
 unsigned VarTspSorter::s_serialNext = 0;
 
+// MTask id -> cost, used as the heat of variables the MTask uses
+using MTaskCosts = std::unordered_map<uint32_t, uint64_t>;
+// MTask id -> thread the MTask is scheduled on
+using MTaskThreads = std::unordered_map<uint32_t, int>;
+
 class VariableOrder final {
     // NODE STATE
     //  AstVar::user1()    -> attributes, via m_attributes
     const VNUser1InUse m_user1InUse;  // AstVar
 
+    // STATE
+    const MTaskCosts& m_mtaskCosts;  // Profiled MTask costs, empty if no profile data
+    const MTaskThreads& m_mtaskThreads;  // Thread of each MTask
+    int m_padBudget = 0;  // Remaining bytes of padding allowed in this module
+
     struct VarAttributes {
         uint32_t stratum;  // Roughly equivalent to alignment requirement, to avoid padding
         bool anonOk;  // Can be emitted as part of anonymous structure
@@ -124,6 +137,7 @@ class VariableOrder final {
         // Do the TSP sort
         V3TSP::StateVec sortedStates;
         V3TSP::tspSort(states, &sortedStates);
+        if (!m_mtaskCosts.empty()) heatSortStates(sortedStates);
 
         varps.clear();
 
@@ -134,9 +148,19 @@ class VariableOrder final {
         };
 
         // Enumerate by sorted MTaskIdSet, sort within the set separately
+        int prevThread = ExecMTask::THREAD_NONE;
         for (const V3TSP::TspStateBase* const stateBasep : sortedStates) {
             const VarTspSorter* const statep = dynamic_cast<const VarTspSorter*>(stateBasep);
-            sortAndAppend(m2v[statep->mtaskIds()]);
+            std::vector<AstVar*>& subVarps = m2v[statep->mtaskIds()];
+            const size_t firstIdx = varps.size();
+            sortAndAppend(subVarps);
+            // Start variables mostly used by another thread on a new cache line
+            const int thread = ownerThread(statep->mtaskIds());
+            if (thread != ExecMTask::THREAD_NONE && prevThread != ExecMTask::THREAD_NONE
+                && thread != prevThread) {
+                alignVars(varps, firstIdx);
+            }
+            if (thread != ExecMTask::THREAD_NONE) prevThread = thread;
             VL_DO_DANGLING(delete statep, statep);
         }
 
@@ -144,6 +168,67 @@ class VariableOrder final {
         sortAndAppend(m2v[MTaskIdSet()]);
     }
 
+    // The thread running most of the given MTasks, or THREAD_NONE if unknown
+    int ownerThread(const MTaskIdSet& mtaskIds) const {
+        std::map<int, size_t> counts;
+        for (const int id : mtaskIds) {
+            const auto it = m_mtaskThreads.find(id);
+            if (it != m_mtaskThreads.end() && it->second != ExecMTask::THREAD_NONE) {
+                ++counts[it->second];
+            }
+        }
+        int thread = ExecMTask::THREAD_NONE;
+        size_t most = 0;
+        for (const auto& pair : counts) {
+            if (pair.second > most) {
+                thread = pair.first;
+                most = pair.second;
+            }
+        }
+        return thread;
+    }
+
+    // Align the first non-static variable from index 'firstIdx' onwards to a
+    // cache line, if the padding budget allows
+    void alignVars(std::vector<AstVar*>& varps, size_t firstIdx) {
+        // Worst case padding is one byte short of a cache line
+        constexpr int padBytes = VL_CACHE_LINE_BYTES - 1;
+        if (m_padBudget < padBytes) return;
+        for (size_t i = firstIdx; i < varps.size(); ++i) {
+            if (varps[i]->isStatic()) continue;
+            varps[i]->isCacheLineAligned(true);
+            m_padBudget -= padBytes;
+            return;
+        }
+    }
+
+    // With profile data, start the TSP tour at the variables of the hottest
+    // MTasks, so they share the first cache lines, and move the variables
+    // only used by cold MTasks to the end
+    void heatSortStates(V3TSP::StateVec& states) const {
+        if (states.empty()) return;
+        std::unordered_map<const V3TSP::TspStateBase*, uint64_t> heats;
+        for (const V3TSP::TspStateBase* const statep : states) {
+            uint64_t& heat = heats[statep];
+            for (const int id : static_cast<const VarTspSorter*>(statep)->mtaskIds()) {
+                const auto it = m_mtaskCosts.find(id);
+                if (it != m_mtaskCosts.end()) heat += it->second;
+            }
+        }
+        const auto hottestIt
+            = std::max_element(states.begin(), states.end(),
+                               [&](const V3TSP::TspStateBase* ap, const V3TSP::TspStateBase* bp) {
+                                   return heats[ap] < heats[bp];
+                               });
+        const uint64_t hottest = heats[*hottestIt];
+        // Rotating keeps the neighbors the TSP found next to each other
+        std::rotate(states.begin(), hottestIt, states.end());
+        std::stable_partition(states.begin(), states.end(),
+                              [&](const V3TSP::TspStateBase* statep) {
+                                  return heats[statep] * COLD_RATIO >= hottest;
+                              });
+    }
+
     void orderModuleVars(AstNodeModule* modp) {
         std::vector<AstVar*> varps;
 
@@ -174,6 +259,8 @@ class VariableOrder final {
         }
 
         if (!varps.empty()) {
+            // Class objects are not allocated aligned, so only pad modules
+            m_padBudget = VN_IS(modp, Class) ? 0 : v3Global.opt.threadsPadBudget();
             // Sort variables
             if (!v3Global.opt.mtasks()) {
                 simpleSortVars(varps);
@@ -194,8 +281,19 @@ class VariableOrder final {
         }
     }
 
+    // CONSTANTS
+    static constexpr uint64_t COLD_RATIO = 100;  // Cold if less than 1/COLD_RATIO of hottest
+
+    // CONSTRUCTORS
+    VariableOrder(const MTaskCosts& mtaskCosts, const MTaskThreads& mtaskThreads)
+        : m_mtaskCosts(mtaskCosts)  // Cannot be {} or GCC 4.8 false warning
+        , m_mtaskThreads(mtaskThreads) {}
+
 public:
-    static void processModule(AstNodeModule* modp) { VariableOrder{}.orderModuleVars(modp); }
+    static void processModule(AstNodeModule* modp, const MTaskCosts& mtaskCosts,
+                              const MTaskThreads& mtaskThreads) {
+        VariableOrder{mtaskCosts, mtaskThreads}.orderModuleVars(modp);
+    }
 };
 
 //######################################################################
@@ -203,9 +301,23 @@ public:
 
 void V3VariableOrder::orderAll() {
     UINFO(2, __FUNCTION__ << ": " << endl);
+    // With --prof-pgo data the MTask costs are measured, so show which variables are hot
+    const bool pgo = V3Config::getProfileDataFileLine();
+    MTaskCosts mtaskCosts;
+    MTaskThreads mtaskThreads;
+    if (v3Global.opt.mtasks()) {
+        v3Global.rootp()->topModulep()->foreach([&](const AstExecGraph* execGraphp) {
+            for (const V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp(); vxp;
+                 vxp = vxp->verticesNextp()) {
+                const ExecMTask* const mtaskp = static_cast<const ExecMTask*>(vxp);
+                if (pgo) mtaskCosts.emplace(mtaskp->id(), mtaskp->cost());
+                mtaskThreads.emplace(mtaskp->id(), mtaskp->threadId());
+            }
+        });
+    }
     for (AstNodeModule* modp = v3Global.rootp()->modulesp(); modp;
          modp = VN_AS(modp->nextp(), NodeModule)) {
-        VariableOrder::processModule(modp);
+        VariableOrder::processModule(modp, mtaskCosts, mtaskThreads);
     }
     V3Global::dumpCheckGlobalTree("variableorder", 0, dumpTreeLevel() >= 3);
 }
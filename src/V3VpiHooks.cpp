@@ -0,0 +1,111 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: VPI value change hooks
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+// VPIHOOKS TRANSFORMATIONS:
+//      With --vpi-hooks, for each statement in a CFUNC:
+//         If it writes a public variable (other than a top level input,
+//         which the user wrapper writes), add after it a call to
+//         VerilatedVpi::valueHook, so the VPI runtime need only compare
+//         variables with value change callbacks that may have changed.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3VpiHooks.h"
+
+#include "V3Ast.h"
+#include "V3Global.h"
+#include "V3Stats.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+VL_DEFINE_DEBUG_FUNCTIONS;
+
+//######################################################################
+
+class VpiHooksVisitor final : public VNVisitor {
+private:
+    // STATE
+    AstCFunc* m_cfuncp = nullptr;  // Current function
+    AstNodeStmt* m_stmtp = nullptr;  // Innermost statement
+    std::vector<std::pair<AstNodeStmt*, AstVarRef*>> m_hooks;  // Hooks to add, in order
+    std::set<std::pair<AstNodeStmt*, AstVar*>> m_hooked;  // Statement/variables in m_hooks
+    VDouble0 m_statHooks;  // Statistic tracking
+
+    // METHODS
+    void addHooks() {
+        // Backwards, as each is added directly after its statement
+        for (auto it = m_hooks.rbegin(); it != m_hooks.rend(); ++it) {
+            AstNodeStmt* const stmtp = it->first;
+            AstVarRef* const refp = it->second;
+            FileLine* const flp = stmtp->fileline();
+            AstVarRef* const newRefp = new AstVarRef{flp, refp->varp(), VAccess::READ};
+            newRefp->selfPointer(refp->selfPointer());
+            AstCStmt* const newp
+                = new AstCStmt{flp, new AstText{flp, "VerilatedVpi::valueHook(&", true}};
+            newp->addExprsp(newRefp);
+            newp->addExprsp(new AstText{flp, ");\n", true});
+            stmtp->addNextHere(newp);
+            ++m_statHooks;
+        }
+    }
+
+    // VISITORS
+    void visit(AstCFunc* nodep) override {
+        VL_RESTORER(m_cfuncp);
+        m_cfuncp = nodep;
+        iterateChildren(nodep);
+    }
+    void visit(AstNodeStmt* nodep) override {
+        if (!m_cfuncp) return;
+        VL_RESTORER(m_stmtp);
+        m_stmtp = nodep;
+        iterateChildren(nodep);
+    }
+    void visit(AstVarRef* nodep) override {
+        if (m_stmtp && nodep->access().isWriteOrRW() && V3VpiHooks::hooked(nodep->varp())
+            && m_hooked.emplace(m_stmtp, nodep->varp()).second) {
+            UINFO(8, "  Hook " << nodep << endl);
+            m_hooks.emplace_back(m_stmtp, nodep);
+        }
+    }
+    void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit VpiHooksVisitor(AstNetlist* nodep) {
+        iterate(nodep);
+        addHooks();
+    }
+    ~VpiHooksVisitor() override { V3Stats::addStat("VPI, Value change hooks", m_statHooks); }
+};
+
+//######################################################################
+// VpiHooks class functions
+
+bool V3VpiHooks::hooked(const AstVar* varp) {
+    return v3Global.opt.vpiHooks() && varp->isSigUserRdPublic() && !varp->isParam()
+           && !varp->isPrimaryInish();
+}
+
+void V3VpiHooks::vpiHooksAll(AstNetlist* nodep) {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    { VpiHooksVisitor{nodep}; }  // Destruct before checking
+    V3Global::dumpCheckGlobalTree("vpihooks", 0, dumpTreeLevel() >= 3);
+}
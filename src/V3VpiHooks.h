@@ -0,0 +1,36 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: VPI value change hooks
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2023 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#ifndef VERILATOR_V3VPIHOOKS_H_
+#define VERILATOR_V3VPIHOOKS_H_
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+class AstNetlist;
+class AstVar;
+
+//============================================================================
+
+class V3VpiHooks final {
+public:
+    // Return true if writes to the variable notify the VPI runtime
+    static bool hooked(const AstVar* varp);
+    // CONSTRUCTORS
+    static void vpiHooksAll(AstNetlist* nodep);
+};
+
+#endif  // Guard
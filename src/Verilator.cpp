@@ -18,6 +18,7 @@
 #include "V3ActiveTop.h"
 #include "V3Assert.h"
 #include "V3AssertPre.h"
+#include "V3AssocHash.h"
 #include "V3Ast.h"
 #include "V3Begin.h"
 #include "V3Branch.h"
@@ -34,6 +35,7 @@
 #include "V3Const.h"
 #include "V3Coverage.h"
 #include "V3CoverageJoin.h"
+#include "V3Cse.h"
 #include "V3Dead.h"
 #include "V3Delayed.h"
 #include "V3Depth.h"
@@ -98,6 +100,7 @@
 #include "V3Unknown.h"
 #include "V3Unroll.h"
 #include "V3VariableOrder.h"
+#include "V3VpiHooks.h"
 #include "V3Waiver.h"
 #include "V3Width.h"
 
@@ -300,6 +303,11 @@ static void process() {
         V3Const::constifyAll(v3Global.rootp());
         V3Dead::deadifyDTypesScoped(v3Global.rootp());
         v3Global.checkTree();
+
+        if (v3Global.opt.fDfgScoped()) {
+            // Scoped DFG optimization, across module boundaries
+            V3DfgOptimizer::optimizeScoped(v3Global.rootp());
+        }
     }
 
     if (!v3Global.opt.xmlOnly()) {
@@ -403,12 +411,15 @@ static void process() {
         // Cleanup any dly vars or other temps that are simple assignments
         // Life must be done before Subst, as it assumes each CFunc under
         // _eval is called only once.
-        if (v3Global.opt.fLife()) {
+        // Optimizations from here on report no lint, so are skipped with --lint-only.
+        if (!v3Global.opt.lintOnly() && v3Global.opt.fLife()) {
             V3Const::constifyAll(v3Global.rootp());
             V3Life::lifeAll(v3Global.rootp());
         }
 
-        if (v3Global.opt.fLifePost()) V3LifePost::lifepostAll(v3Global.rootp());
+        if (!v3Global.opt.lintOnly() && v3Global.opt.fLifePost()) {
+            V3LifePost::lifepostAll(v3Global.rootp());
+        }
 
         // Remove unused vars
         V3Const::constifyAll(v3Global.rootp());
@@ -418,7 +429,9 @@ static void process() {
         // Note past this point, we presume traced variables won't move between CFuncs
         // (It's OK if untraced temporaries move around, or vars
         // "effectively" activate the same way.)
-        if (v3Global.opt.trace()) V3Trace::traceAll(v3Global.rootp());
+        if (!v3Global.opt.lintOnly() && v3Global.opt.trace()) {
+            V3Trace::traceAll(v3Global.rootp());
+        }
 
         if (v3Global.opt.stats()) V3Stats::statsStageAll(v3Global.rootp(), "Scoped");
     }
@@ -435,13 +448,17 @@ static void process() {
         v3Global.assertScoped(false);
 
         // Move variables from modules to function local variables where possible
-        if (v3Global.opt.fLocalize()) V3Localize::localizeAll(v3Global.rootp());
+        if (!v3Global.opt.lintOnly() && v3Global.opt.fLocalize()) {
+            V3Localize::localizeAll(v3Global.rootp());
+        }
 
         // Remove remaining scopes; make varrefs/funccalls relative to current module
         V3Descope::descopeAll(v3Global.rootp());
 
         // Icache packing; combine common code in each module's functions into subroutines
-        if (v3Global.opt.fCombine()) V3Combine::combineAll(v3Global.rootp());
+        if (!v3Global.opt.lintOnly() && v3Global.opt.fCombine()) {
+            V3Combine::combineAll(v3Global.rootp());
+        }
     }
 
     V3Error::abortIfErrors();
@@ -457,6 +474,9 @@ static void process() {
         // Bits between widthMin() and width() are irrelevant, but may be non zero.
         v3Global.widthMinUsage(VWidthMinUsage::VERILOG_WIDTH);
 
+        // Share repeated pure expressions within each function
+        if (!v3Global.opt.lintOnly() && v3Global.opt.fCse()) V3Cse::cseAll(v3Global.rootp());
+
         // Make all expressions either 8, 16, 32 or 64 bits
         V3Clean::cleanAll(v3Global.rootp());
 
@@ -470,13 +490,13 @@ static void process() {
     }
 
     // Propagate constants across WORDSEL arrayed temporaries
-    if (!v3Global.opt.xmlOnly() && v3Global.opt.fSubst()) {
+    if (!v3Global.opt.lintOnly() && !v3Global.opt.xmlOnly() && v3Global.opt.fSubst()) {
         // Constant folding of expanded stuff
         V3Const::constifyCpp(v3Global.rootp());
         V3Subst::substituteAll(v3Global.rootp());
     }
 
-    if (!v3Global.opt.xmlOnly() && v3Global.opt.fSubstConst()) {
+    if (!v3Global.opt.lintOnly() && !v3Global.opt.xmlOnly() && v3Global.opt.fSubstConst()) {
         // Constant folding of substitutions
         V3Const::constifyCpp(v3Global.rootp());
         V3Dead::deadifyAll(v3Global.rootp());
@@ -494,6 +514,10 @@ static void process() {
             V3Reloop::reloopAll(v3Global.rootp());
         }
 
+        // Notify VPI of writes to public variables
+        // Must be after Reloop, which can't loop over the added hooks
+        if (v3Global.opt.vpiHooks()) V3VpiHooks::vpiHooksAll(v3Global.rootp());
+
         // Fix very deep expressions
         // Mark evaluation functions as member functions, if needed.
         V3Depth::depthAll(v3Global.rootp());
@@ -520,6 +544,10 @@ static void process() {
     }
 
     if (!v3Global.opt.lintOnly() && !v3Global.opt.xmlOnly() && !v3Global.opt.dpiHdrOnly()) {
+        // Use hash tables for associative arrays not needing key order
+        // Must be after all passes that may add ordered uses, e.g. V3Task
+        if (v3Global.opt.fAssocHash()) V3AssocHash::assocHashAll(v3Global.rootp());
+
         // Add common methods/etc to modules
         V3Common::commonAll();
 
@@ -534,10 +562,7 @@ static void process() {
     if (!v3Global.opt.lintOnly() && !v3Global.opt.xmlOnly() && !v3Global.opt.dpiHdrOnly()) {
         // emitcInlines is first, as it may set needHInlines which other emitters read
         V3EmitC::emitcInlines();
-        V3EmitC::emitcSyms();
-        V3EmitC::emitcConstPool();
-        V3EmitC::emitcModel();
-        V3EmitC::emitcHeaders();
+        V3EmitC::emitcSupport();
     } else if (v3Global.opt.dpiHdrOnly()) {
         V3EmitC::emitcSyms(true);
     }
@@ -562,6 +587,7 @@ static void process() {
     }
 
     if (v3Global.opt.stats()) V3Stats::statsStage("emit");
+    if (v3Global.opt.profVerilation()) V3Stats::profVerilationStage("emit");
 
     // Statistics
     reportStatsIfEnabled();
@@ -627,6 +653,8 @@ static void verilate(const string& argString) {
         UINFO(2, "selfTest done\n");
     }
 
+    if (v3Global.opt.profVerilation()) V3Stats::profVerilationStart();
+
     // Read first filename
     v3Global.readFiles();
     v3Global.removeStd();
@@ -638,6 +666,7 @@ static void verilate(const string& argString) {
 
     // Final steps
     V3Global::dumpCheckGlobalTree("final", 990, dumpTreeLevel() >= 3);
+    if (v3Global.opt.profVerilation()) V3Stats::profVerilationReport();
 
     V3Error::abortIfErrors();
 
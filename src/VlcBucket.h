@@ -23,6 +23,9 @@
 #define V3ERROR_NO_GLOBAL_
 #include "V3Error.h"
 
+#include <algorithm>
+#include <vector>
+
 //********************************************************************
 // VlcBuckets - Container of all coverage point hits for a given test
 // This is a bitmap array - we store a single bit to indicate a test
@@ -36,6 +39,25 @@ private:
     uint64_t m_bucketsCovered = 0;  ///< Num buckets with sufficient coverage
 
     static uint64_t covBit(uint64_t point) { return 1ULL << (point & 63); }
+    static uint64_t popCount64(uint64_t v) {
+#ifdef __GNUC__
+        return __builtin_popcountll(v);
+#else
+        v = v - ((v >> 1) & 0x5555555555555555ULL);
+        v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+        v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return (v * 0x0101010101010101ULL) >> 56;
+#endif
+    }
+    static uint64_t ctz64(uint64_t v) {  // v must be non-zero
+#ifdef __GNUC__
+        return __builtin_ctzll(v);
+#else
+        uint64_t n = 0;
+        for (; !(v & 1); v >>= 1) ++n;
+        return n;
+#endif
+    }
     uint64_t allocSize() const { return sizeof(uint64_t) * m_dataSize / 64; }
     void allocate(uint64_t point) {
         const uint64_t oldsize = m_dataSize;
@@ -96,22 +118,33 @@ public:
     }
     uint64_t popCount() const {
         uint64_t pop = 0;
-        for (uint64_t i = 0; i < m_dataSize; ++i) {
-            if (hits(i)) ++pop;
-        }
+        for (uint64_t w = 0; w < m_dataSize / 64; ++w) pop += popCount64(m_datap[w]);
         return pop;
     }
-    uint64_t dataPopCount(const VlcBuckets& remaining) {
+    uint64_t dataPopCount(const VlcBuckets& remaining) const {
+        // Points hit by both, a word at a time
+        const uint64_t words = std::min(m_dataSize, remaining.m_dataSize) / 64;
         uint64_t pop = 0;
-        for (uint64_t i = 0; i < m_dataSize; ++i) {
-            if (hits(i) && remaining.hits(i)) ++pop;
+        for (uint64_t w = 0; w < words; ++w) {
+            pop += popCount64(m_datap[w] & remaining.m_datap[w]);
         }
         return pop;
     }
     void orData(const VlcBuckets& ordata) {
-        for (uint64_t i = 0; i < m_dataSize; ++i) {
-            if (hits(i) && ordata.hits(i)) clearHits(i);
+        // Clear points hit by ordata
+        const uint64_t words = std::min(m_dataSize, ordata.m_dataSize) / 64;
+        for (uint64_t w = 0; w < words; ++w) m_datap[w] &= ~ordata.m_datap[w];
+    }
+    void addRemapped(const VlcBuckets& from, const std::vector<uint64_t>& pointnums) {
+        // Add from's hits, where from's point p is our point pointnums[p]
+        for (uint64_t w = 0; w < from.m_dataSize / 64; ++w) {
+            for (uint64_t bits = from.m_datap[w]; bits; bits &= bits - 1) {
+                const uint64_t point = pointnums[w * 64 + ctz64(bits)];
+                if (point >= m_dataSize) allocate(point);
+                m_datap[point / 64] |= covBit(point);
+            }
         }
+        m_bucketsCovered += from.m_bucketsCovered;
     }
 
     void dump() const {
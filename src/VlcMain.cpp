@@ -41,6 +41,7 @@ static int debug() { return V3Error::debugDefault(); }
 
 #include <algorithm>
 #include <fstream>
+#include <thread>
 
 //######################################################################
 // VlcOptions
@@ -60,10 +61,14 @@ void VlcOptions::parseOptsList(int argc, char** argv) {
 
     DECL_OPTION("-annotate", Set, &m_annotateOut);
     DECL_OPTION("-annotate-all", OnOff, &m_annotateAll);
+    DECL_OPTION("-annotate-cache", OnOff, &m_annotateCache);
     DECL_OPTION("-annotate-min", Set, &m_annotateMin);
     DECL_OPTION("-annotate-points", OnOff, &m_annotatePoints);
     DECL_OPTION("-debug", CbCall, []() { V3Error::debugDefault(3); });
     DECL_OPTION("-debugi", CbVal, [](int v) { V3Error::debugDefault(v); });
+    DECL_OPTION("-j", CbVal, [this](int v) {
+        m_jobs = v ? v : std::max(1U, std::thread::hardware_concurrency());
+    });
     DECL_OPTION("-rank", OnOff, &m_rank);
     DECL_OPTION("-unlink", OnOff, &m_unlink);
     DECL_OPTION("-V", CbCall, []() {
@@ -75,6 +80,7 @@ void VlcOptions::parseOptsList(int argc, char** argv) {
         std::exit(0);
     });
     DECL_OPTION("-write", Set, &m_writeFile);
+    DECL_OPTION("-write-binary", Set, &m_writeBinaryFile);
     DECL_OPTION("-write-info", Set, &m_writeInfoFile);
     parser.finalize();
 
@@ -125,10 +131,7 @@ int main(int argc, char** argv) {
 
     if (top.opt.readFiles().empty()) top.opt.addReadFile("vlt_coverage.dat");
 
-    {
-        const VlStringSet& readFiles = top.opt.readFiles();
-        for (const auto& filename : readFiles) top.readCoverage(filename);
-    }
+    top.readCoverage(top.opt.readFiles());
 
     if (debug() >= 9) {
         top.tests().dump(true);
@@ -143,8 +146,12 @@ int main(int argc, char** argv) {
         top.tests().dump(false);
     }
 
-    if (!top.opt.writeFile().empty() || !top.opt.writeInfoFile().empty()) {
+    if (!top.opt.writeFile().empty() || !top.opt.writeBinaryFile().empty()
+        || !top.opt.writeInfoFile().empty()) {
         if (!top.opt.writeFile().empty()) top.writeCoverage(top.opt.writeFile());
+        if (!top.opt.writeBinaryFile().empty()) {
+            top.writeCoverageBinary(top.opt.writeBinaryFile());
+        }
         if (!top.opt.writeInfoFile().empty()) top.writeInfo(top.opt.writeInfoFile());
         V3Error::abortIfWarnings();
         if (top.opt.unlink()) {
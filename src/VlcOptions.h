@@ -36,12 +36,15 @@ class VlcOptions final {
     // clang-format off
     string m_annotateOut;       // main switch: --annotate I<output_directory>
     bool m_annotateAll = false;  // main switch: --annotate-all
+    bool m_annotateCache = false;  // main switch: --annotate-cache
     int m_annotateMin = 10;     // main switch: --annotate-min I<count>
+    int m_jobs = 1;             // main switch: -j I<jobs>
     bool m_annotatePoints = false;  // main switch: --annotate-points
     VlStringSet m_readFiles;    // main switch: --read
     bool m_rank = false;        // main switch: --rank
     bool m_unlink = false;      // main switch: --unlink
     string m_writeFile;         // main switch: --write
+    string m_writeBinaryFile;   // main switch: --write-binary
     string m_writeInfoFile;     // main switch: --write-info
     // clang-format on
 
@@ -62,11 +65,14 @@ public:
     const VlStringSet& readFiles() const { return m_readFiles; }
     string annotateOut() const { return m_annotateOut; }
     bool annotateAll() const { return m_annotateAll; }
+    bool annotateCache() const { return m_annotateCache; }
     int annotateMin() const { return m_annotateMin; }
     bool annotatePoints() const { return m_annotatePoints; }
+    int jobs() const { return m_jobs; }
     bool rank() const { return m_rank; }
     bool unlink() const { return m_unlink; }
     string writeFile() const { return m_writeFile; }
+    string writeBinaryFile() const { return m_writeBinaryFile; }
     string writeInfoFile() const { return m_writeInfoFile; }
 
     // METHODS (from main)
@@ -53,7 +53,7 @@ public:
     uint64_t testsCovering() const { return m_testsCovering; }
     void countInc(uint64_t inc) { m_count += inc; }
     uint64_t count() const { return m_count; }
-    void testsCoveringInc() { m_testsCovering++; }
+    void testsCoveringInc(uint64_t inc = 1) { m_testsCovering += inc; }
     bool ok(unsigned annotateMin) const {
         const std::string threshStr = thresh();
         unsigned threshi = !threshStr.empty() ? std::atoi(threshStr.c_str()) : annotateMin;
@@ -109,9 +109,21 @@ class VlcPoints final {
 private:
     // MEMBERS
     using NameMap = std::map<const std::string, uint64_t>;  // Sorted by name (ordered)
+    struct FieldIdsHash final {
+        size_t operator()(const std::vector<uint32_t>& ids) const {
+            size_t hash = ids.size();
+            for (const uint32_t id : ids) hash = hash * 0x9e3779b1U + id;
+            return hash;
+        }
+    };
+    using FieldIdsMap = std::unordered_map<std::vector<uint32_t>, uint64_t, FieldIdsHash>;
     NameMap m_nameMap;  //< Name to point-number
     std::vector<VlcPoint> m_points;  //< List of all points
     uint64_t m_numPoints = 0;  //< Total unique points
+    // Binary coverage files name points by fields, each a "\001key\002value"
+    std::unordered_map<std::string, uint32_t> m_fieldIds;  //< Field to field id
+    std::vector<std::string> m_fields;  //< Field id to field
+    FieldIdsMap m_fieldIdsMap;  //< Field ids of a point's name to point-number
 
     static int debug() { return V3Error::debugDefault(); }
 
@@ -136,6 +148,7 @@ public:
         }
     }
     VlcPoint& pointNumber(uint64_t num) { return m_points[num]; }
+    uint64_t numPoints() const { return m_numPoints; }
     uint64_t findAddPoint(const string& name, uint64_t count) {
         uint64_t pointnum;
         const auto iter = m_nameMap.find(name);
@@ -151,6 +164,24 @@ public:
         }
         return pointnum;
     }
+    uint32_t fieldId(const string& field) {
+        const auto it = m_fieldIds.emplace(field, m_fields.size()).first;
+        if (it->second == m_fields.size()) m_fields.push_back(field);
+        return it->second;
+    }
+    uint64_t findAddPoint(const std::vector<uint32_t>& fieldIds, uint64_t count) {
+        // Avoids building and comparing the name, except for a point's first sighting
+        const auto iter = m_fieldIdsMap.find(fieldIds);
+        if (iter != m_fieldIdsMap.end()) {
+            m_points[iter->second].countInc(count);
+            return iter->second;
+        }
+        string name;
+        for (const uint32_t id : fieldIds) name += m_fields[id];
+        const uint64_t pointnum = findAddPoint(name, count);
+        m_fieldIdsMap.emplace(fieldIds, pointnum);
+        return pointnum;
+    }
 };
 
 //######################################################################
@@ -18,20 +18,33 @@
 
 #include "V3Error.h"
 #include "V3Os.h"
+#include "V3String.h"
 
 #include "VlcOptions.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 //######################################################################
 
+// Binary coverage files are written by VerilatedCovContext::writeBinary, which
+// describes the format
+static const char* const VLC_BINARY_MAGIC = "VLCOVBIN";
+static constexpr uint32_t VLC_BINARY_VERSION = 1;
+
 void VlcTop::readCoverage(const string& filename, bool nonfatal) {
     UINFO(2, "readCoverage " << filename << endl);
 
-    std::ifstream is{filename.c_str()};
+    std::ifstream is{filename.c_str(), std::ios::binary};
     if (!is) {
         if (!nonfatal) v3fatal("Can't read " << filename);
         return;
@@ -40,6 +53,15 @@ void VlcTop::readCoverage(const string& filename, bool nonfatal) {
     // Testrun and computrons argument unsupported as yet
     VlcTest* const testp = tests().newTest(filename, 0, 0);
 
+    char magic[8] = {};
+    is.read(magic, sizeof(magic));
+    if (is && !std::memcmp(magic, VLC_BINARY_MAGIC, sizeof(magic))) {
+        readCoverageBinary(filename, is, testp);
+        return;
+    }
+    is.clear();
+    is.seekg(0);
+
     while (!is.eof()) {
         const string line = V3Os::getline(is);
         // UINFO(9," got "<<line<<endl);
@@ -52,14 +74,128 @@ void VlcTop::readCoverage(const string& filename, bool nonfatal) {
             uint64_t hits = std::atoll(line.c_str() + secspace + 1);
             // UINFO(9,"   point '"<<point<<"'"<<" "<<hits<<endl);
 
-            uint64_t pointnum = points().findAddPoint(point, hits);
-            if (pointnum) {}  // Prevent unused
-            if (opt.rank()) {  // Only if ranking - uses a lot of memory
-                if (hits >= VlcBuckets::sufficient()) {
-                    points().pointNumber(pointnum).testsCoveringInc();
-                    testp->buckets().addData(pointnum, hits);
-                }
-            }
+            pointRead(testp, points().findAddPoint(point, hits), hits);
+        }
+    }
+}
+
+void VlcTop::readCoverage(const VlStringSet& filenames) {
+    const size_t jobs = std::min<size_t>(opt.jobs(), filenames.size());
+    if (jobs <= 1) {
+        for (const auto& filename : filenames) readCoverage(filename);
+        return;
+    }
+    UINFO(2, "readCoverage with " << jobs << " jobs" << endl);
+    // Each job reads a consecutive run of the files into its own shard.
+    // Merging the shards in order then numbers the points and tests just as
+    // reading the files one after another would.
+    const std::vector<string> files{filenames.begin(), filenames.end()};
+    std::vector<std::unique_ptr<VlcTop>> shards;
+    std::vector<std::thread> threads;
+    for (size_t job = 0; job < jobs; ++job) {
+        shards.emplace_back(new VlcTop);
+        VlcTop* const shardp = shards.back().get();
+        shardp->opt = opt;
+        const size_t begin = job * files.size() / jobs;
+        const size_t end = (job + 1) * files.size() / jobs;
+        threads.emplace_back([shardp, &files, begin, end]() {
+            for (size_t i = begin; i < end; ++i) shardp->readCoverage(files[i]);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (const auto& shardp : shards) mergeShard(*shardp);
+}
+
+void VlcTop::mergeShard(VlcTop& shard) {
+    // Shard's point numbers to ours, in the shard's order of first use
+    std::vector<uint64_t> pointnums;
+    pointnums.reserve(shard.points().numPoints());
+    for (uint64_t p = 0; p < shard.points().numPoints(); ++p) {
+        const VlcPoint& point = shard.points().pointNumber(p);
+        const uint64_t pointnum = points().findAddPoint(point.name(), point.count());
+        points().pointNumber(pointnum).testsCoveringInc(point.testsCovering());
+        pointnums.push_back(pointnum);
+    }
+    for (VlcTest* const shardTestp : shard.tests()) {
+        VlcTest* const testp
+            = tests().newTest(shardTestp->name(), shardTestp->testrun(), shardTestp->computrons());
+        testp->buckets().addRemapped(shardTestp->buckets(), pointnums);
+    }
+}
+
+void VlcTop::readCoverageBinary(const string& filename, std::istream& is, VlcTest* testp) {
+    // Only the file's index is held in memory, the counts are streamed
+    uint32_t header[2] = {};  // Version, number of fields
+    uint64_t sizes[2] = {};  // Number of points, bytes in index
+    bool ok = is.read(reinterpret_cast<char*>(header), sizeof(header))
+              && is.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    if (ok && header[0] != VLC_BINARY_VERSION) {
+        v3fatal("Unsupported version " << header[0] << " of binary coverage file: " << filename);
+        return;
+    }
+    const std::streampos dataPos = is.tellg();
+    is.seekg(0, std::ios::end);
+    const uint64_t remaining = ok ? static_cast<uint64_t>(is.tellg() - dataPos) : 0;
+    is.seekg(dataPos);
+    ok = ok && sizes[1] <= remaining && sizes[0] <= (remaining - sizes[1]) / sizeof(uint64_t);
+    string index(ok ? sizes[1] : 0, '\0');
+    ok = ok && is.read(&index[0], index.size());
+    // Runs of the same model have the same index, so reuse the last file's point numbers
+    if (ok && (index != m_binaryIndex || sizes[0] != m_binaryPointnums.size())) {
+        m_binaryIndex.clear();
+        m_binaryPointnums.clear();
+        ok = readCoverageIndex(index, header[1], sizes[0]);
+        if (ok) m_binaryIndex = std::move(index);
+    }
+    std::vector<uint64_t> counts;
+    for (uint64_t p = 0; ok && p < sizes[0];) {
+        counts.resize(std::min<uint64_t>(sizes[0] - p, 64 * 1024));
+        ok = static_cast<bool>(
+            is.read(reinterpret_cast<char*>(counts.data()), counts.size() * sizeof(uint64_t)));
+        for (size_t i = 0; ok && i < counts.size(); ++i, ++p) {
+            const uint64_t pointnum = m_binaryPointnums[p];
+            points().pointNumber(pointnum).countInc(counts[i]);
+            pointRead(testp, pointnum, counts[i]);
+        }
+    }
+    if (!ok) v3fatal("Truncated or corrupt binary coverage file: " << filename);
+}
+
+bool VlcTop::readCoverageIndex(const string& index, uint32_t numFields, uint64_t numPoints) {
+    // Find or add the points of a binary coverage file's index to m_binaryPointnums
+    size_t pos = 0;
+    const auto get32 = [&](uint32_t& value) {
+        if (index.size() - pos < sizeof(value)) return false;
+        std::memcpy(&value, index.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    };
+    std::vector<uint32_t> fieldIds;  // File's field numbers to the ids points() knows
+    for (uint32_t i = 0; i < numFields; ++i) {
+        uint32_t len;
+        if (!get32(len) || index.size() - pos < len) return false;
+        fieldIds.push_back(points().fieldId(index.substr(pos, len)));
+        pos += len;
+    }
+    std::vector<uint32_t> ids;
+    for (uint64_t p = 0; p < numPoints; ++p) {
+        uint32_t num;
+        if (!get32(num)) return false;
+        ids.resize(num);
+        for (uint32_t& id : ids) {
+            if (!get32(id) || id >= fieldIds.size()) return false;
+            id = fieldIds[id];
+        }
+        m_binaryPointnums.push_back(points().findAddPoint(ids, 0));
+    }
+    return pos == index.size();
+}
+
+void VlcTop::pointRead(VlcTest* testp, uint64_t pointnum, uint64_t hits) {
+    if (opt.rank()) {  // Only if ranking - uses a lot of memory
+        if (hits >= VlcBuckets::sufficient()) {
+            points().pointNumber(pointnum).testsCoveringInc();
+            testp->buckets().addData(pointnum, hits);
         }
     }
 }
@@ -80,6 +216,61 @@ void VlcTop::writeCoverage(const string& filename) {
     }
 }
 
+void VlcTop::writeCoverageBinary(const string& filename) {
+    UINFO(2, "writeCoverageBinary " << filename << endl);
+
+    std::ofstream os{filename.c_str(), std::ios::binary};
+    if (!os) {
+        v3fatal("Can't write " << filename);
+        return;
+    }
+
+    // Fields are numbered in order of use, as by VerilatedCovContext::writeBinary
+    std::unordered_map<string, uint32_t> fieldIndexes;
+    std::vector<const string*> fields;
+    std::vector<uint32_t> pointFields;  // Per point: number of fields, then indexes
+    uint64_t numPoints = 0;
+    uint64_t indexBytes = 0;
+    for (const auto& i : m_points) {
+        const string& name = i.first;
+        ++numPoints;
+        const size_t numPos = pointFields.size();
+        pointFields.push_back(0);
+        for (size_t pos = 0; pos < name.size();) {
+            const size_t endPos = std::min(name.find('\001', pos + 1), name.size());
+            const auto it
+                = fieldIndexes.emplace(name.substr(pos, endPos - pos), fields.size()).first;
+            if (it->second == fields.size()) {
+                fields.push_back(&it->first);
+                indexBytes += sizeof(uint32_t) + it->first.size();
+            }
+            pointFields.push_back(it->second);
+            ++pointFields[numPos];
+            pos = endPos;
+        }
+    }
+    indexBytes += pointFields.size() * sizeof(uint32_t);
+
+    const auto put = [&os](const void* datap, size_t size) {
+        os.write(static_cast<const char*>(datap), size);
+    };
+    const uint32_t header[2] = {VLC_BINARY_VERSION, static_cast<uint32_t>(fields.size())};
+    const uint64_t sizes[2] = {numPoints, indexBytes};
+    put(VLC_BINARY_MAGIC, std::strlen(VLC_BINARY_MAGIC));
+    put(header, sizeof(header));
+    put(sizes, sizeof(sizes));
+    for (const string* fieldp : fields) {
+        const uint32_t len = fieldp->size();
+        put(&len, sizeof(len));
+        put(fieldp->data(), len);
+    }
+    put(pointFields.data(), pointFields.size() * sizeof(uint32_t));
+    for (const auto& i : m_points) {
+        const uint64_t hits = m_points.pointNumber(i.second).count();
+        put(&hits, sizeof(hits));
+    }
+}
+
 void VlcTop::writeInfo(const string& filename) {
     UINFO(2, "writeInfo " << filename << endl);
 
@@ -154,33 +345,37 @@ void VlcTop::rank() {
         if (pointp->testsCovering()) remaining.addData(pointp->pointNum(), 1);
     }
 
-    // Additional Greedy algorithm
-    // O(n^2) Ouch.  Probably the thing to do is randomize the order of data
-    // then hierarchically solve a small subset of tests, and take resulting
-    // solution and move up to larger subset of tests.  (Aka quick sort.)
-    while (true) {
+    // Additional Greedy algorithm, made lazy: a test's remaining points only
+    // shrink as others are ranked, so its last count bounds its next. Keep
+    // tests ordered by that bound, and recount only the best; if it still
+    // beats every other bound it is the best test. Ties keep the computron
+    // order, giving the same ranking as recounting every test each round.
+    using Bound = std::pair<uint64_t, size_t>;  // Remaining points, index in bytime
+    const auto cmpBound = [](const Bound& lhs, const Bound& rhs) {
+        if (lhs.first != rhs.first) return lhs.first < rhs.first;
+        return lhs.second > rhs.second;
+    };
+    std::priority_queue<Bound, std::vector<Bound>, decltype(cmpBound)> bounds{cmpBound};
+    for (size_t i = 0; i < bytime.size(); ++i) {
+        bounds.emplace(bytime[i]->buckets().dataPopCount(remaining), i);
+    }
+    while (!bounds.empty()) {
+        Bound best = bounds.top();
+        bounds.pop();
+        best.first = bytime[best.second]->buckets().dataPopCount(remaining);
+        if (!best.first) continue;  // Covers nothing more, nor will it later
+        if (!bounds.empty() && cmpBound(best, bounds.top())) {
+            bounds.push(best);  // Another test may be better, try it
+            continue;
+        }
         if (debug()) {
             UINFO(9, "Left on iter" << nextrank << ": ");  // LCOV_EXCL_LINE
             remaining.dump();  // LCOV_EXCL_LINE
         }
-        VlcTest* bestTestp = nullptr;
-        uint64_t bestRemain = 0;
-        for (const auto& testp : bytime) {
-            if (!testp->rank()) {
-                uint64_t remain = testp->buckets().dataPopCount(remaining);
-                if (remain > bestRemain) {
-                    bestTestp = testp;
-                    bestRemain = remain;
-                }
-            }
-        }
-        if (VlcTest* const testp = bestTestp) {
-            testp->rank(nextrank++);
-            testp->rankPoints(bestRemain);
-            remaining.orData(bestTestp->buckets());
-        } else {
-            break;  // No test covering more stuff found
-        }
+        VlcTest* const testp = bytime[best.second];
+        testp->rank(nextrank++);
+        testp->rankPoints(best.first);
+        remaining.orData(testp->buckets());
     }
 }
 
@@ -254,23 +449,92 @@ void VlcTop::annotateCalcNeeded() {
     if (totOk != totCases) cout << "See lines with '%00' in " << opt.annotateOut() << '\n';
 }
 
+// Annotation cache written into the annotation directory by --annotate-cache,
+// each line is "<source hash> <coverage hash> <source filename>"
+static const char* const VLC_ANNOTATE_CACHE_FILENAME = ".verilator_coverage_cache";
+static const char* const VLC_ANNOTATE_CACHE_HEADER = "# verilator_coverage annotate cache 1";
+
+string VlcTop::annotateDigest(VlcSource& source) {
+    // Hash everything besides the source text that annotateOutputFiles writes
+    VHashSha256 hash;
+    hash.insert(opt.annotatePoints() ? "points " : "nopoints ");
+    for (auto& li : source.lines()) {
+        VlcSourceCount& sc = li.second;
+        hash.insert(cvtToStr(sc.lineno()) + (sc.ok() ? " " : "% ") + cvtToStr(sc.count())
+                    + "\n");
+        if (opt.annotatePoints()) {
+            std::ostringstream os;
+            for (auto& pit : sc.points()) pit->dumpAnnotate(os, opt.annotateMin());
+            hash.insert(os.str());
+        }
+    }
+    return hash.digestHex();
+}
+
+void VlcTop::annotateCacheRead(const string& filename, AnnotateCache& cache) {
+    std::ifstream is{filename.c_str()};
+    if (!is) return;  // First run
+    if (V3Os::getline(is) != VLC_ANNOTATE_CACHE_HEADER) return;  // Other version, rebuild all
+    while (!is.eof()) {
+        const string line = V3Os::getline(is);
+        const size_t sep1 = line.find(' ');
+        const size_t sep2 = line.find(' ', sep1 + 1);
+        if (sep1 == string::npos || sep2 == string::npos) continue;
+        cache[line.substr(sep2 + 1)]
+            = std::make_pair(line.substr(0, sep1), line.substr(sep1 + 1, sep2 - sep1 - 1));
+    }
+}
+
+void VlcTop::annotateCacheWrite(const string& filename, const AnnotateCache& cache) {
+    std::ofstream os{filename.c_str()};
+    if (!os) {
+        v3fatal("Can't write " << filename);
+        return;
+    }
+    os << VLC_ANNOTATE_CACHE_HEADER << '\n';
+    for (const auto& it : cache) {
+        os << it.second.first << ' ' << it.second.second << ' ' << it.first << '\n';
+    }
+}
+
 void VlcTop::annotateOutputFiles(const string& dirname) {
     // Create if uncreated, ignore errors
     V3Os::createDir(dirname);
+    // With --annotate-cache, skip sources whose text and coverage match the
+    // last run, as their annotated file would be rewritten unchanged
+    const string cacheFilename = dirname + "/" + VLC_ANNOTATE_CACHE_FILENAME;
+    AnnotateCache oldCache;
+    AnnotateCache newCache;
+    if (opt.annotateCache()) annotateCacheRead(cacheFilename, oldCache);
     for (auto& si : m_sources) {
         VlcSource& source = si.second;
         if (!source.needed()) continue;
         const string filename = source.name();
         const string outfilename = dirname + "/" + V3Os::filenameNonDir(filename);
 
-        UINFO(1, "annotateOutputFile " << filename << " -> " << outfilename << endl);
-
-        std::ifstream is{filename.c_str()};
-        if (!is) {
+        std::ifstream ifs{filename.c_str(), std::ios::binary};
+        if (!ifs) {
             v3error("Can't read " << filename);
             return;
         }
+        const string contents{std::istreambuf_iterator<char>{ifs},
+                              std::istreambuf_iterator<char>{}};
+
+        if (opt.annotateCache()) {
+            const auto digests = std::make_pair(VHashSha256{contents}.digestHex(),
+                                                annotateDigest(source));
+            newCache[filename] = digests;
+            const auto it = oldCache.find(filename);
+            if (it != oldCache.end() && it->second == digests
+                && std::ifstream{outfilename.c_str()}) {
+                UINFO(1, "annotateOutputFile " << filename << " unchanged" << endl);
+                continue;
+            }
+        }
+
+        UINFO(1, "annotateOutputFile " << filename << " -> " << outfilename << endl);
 
+        std::istringstream is{contents};
         std::ofstream os{outfilename.c_str()};
         if (!os) {
             v3fatal("Can't write " << outfilename);
@@ -301,6 +565,7 @@ void VlcTop::annotateOutputFiles(const string& dirname) {
             }
         }
     }
+    if (opt.annotateCache()) annotateCacheWrite(cacheFilename, newCache);
 }
 
 void VlcTop::annotate(const string& dirname) {
@@ -37,11 +37,24 @@ private:
     VlcTests m_tests;  //< List of all tests (all coverage files)
     VlcPoints m_points;  //< List of all points
     VlcSources m_sources;  //< List of all source files to annotate
+    string m_binaryIndex;  //< Index of last binary coverage file read
+    std::vector<uint64_t> m_binaryPointnums;  //< Point numbers of m_binaryIndex's points
+
+    // TYPES
+    // Map of source filename to {source hash, coverage hash}
+    using AnnotateCache = std::map<const std::string, std::pair<string, string>>;
 
     // METHODS
     void annotateCalc();
     void annotateCalcNeeded();
     void annotateOutputFiles(const string& dirname);
+    string annotateDigest(VlcSource& source);
+    static void annotateCacheRead(const string& filename, AnnotateCache& cache);
+    static void annotateCacheWrite(const string& filename, const AnnotateCache& cache);
+    void readCoverageBinary(const string& filename, std::istream& is, VlcTest* testp);
+    bool readCoverageIndex(const string& index, uint32_t numFields, uint64_t numPoints);
+    void mergeShard(VlcTop& shard);
+    void pointRead(VlcTest* testp, uint64_t pointnum, uint64_t hits);
 
 public:
     // CONSTRUCTORS
@@ -56,7 +69,9 @@ public:
     // METHODS
     void annotate(const string& dirname);
     void readCoverage(const string& filename, bool nonfatal = false);
+    void readCoverage(const VlStringSet& filenames);
     void writeCoverage(const string& filename);
+    void writeCoverageBinary(const string& filename);
     void writeInfo(const string& filename);
 
     void rank();
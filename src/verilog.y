@@ -456,6 +456,7 @@ BISONPRE_VERSION(3.7,%define api.header.include {"V3ParseBison.h"})
 %token<fl>              yVLT_COVERAGE_BLOCK_OFF     "coverage_block_off"
 %token<fl>              yVLT_COVERAGE_OFF           "coverage_off"
 %token<fl>              yVLT_COVERAGE_ON            "coverage_on"
+%token<fl>              yVLT_DPI_GROUP              "dpi_group"
 %token<fl>              yVLT_FORCEABLE              "forceable"
 %token<fl>              yVLT_FULL_CASE              "full_case"
 %token<fl>              yVLT_HIER_BLOCK             "hier_block"
@@ -481,9 +482,12 @@ BISONPRE_VERSION(3.7,%define api.header.include {"V3ParseBison.h"})
 %token<fl>              yVLT_TRACING_ON             "tracing_on"
 
 %token<fl>              yVLT_D_BLOCK    "--block"
+%token<fl>              yVLT_D_CALLS    "--calls"
+%token<fl>              yVLT_D_CFUNC    "--cfunc"
 %token<fl>              yVLT_D_COST     "--cost"
 %token<fl>              yVLT_D_FILE     "--file"
 %token<fl>              yVLT_D_FUNCTION "--function"
+%token<fl>              yVLT_D_GROUP    "--group"
 %token<fl>              yVLT_D_LEVELS   "--levels"
 %token<fl>              yVLT_D_LINES    "--lines"
 %token<fl>              yVLT_D_MATCH    "--match"
@@ -7204,6 +7208,8 @@ vltItem:
                         { V3Config::addCoverageBlockOff(*$3, $5->toUInt()); }
         |       yVLT_COVERAGE_BLOCK_OFF yVLT_D_MODULE yaSTRING yVLT_D_BLOCK yaSTRING
                         { V3Config::addCoverageBlockOff(*$3, *$5); }
+        |       yVLT_DPI_GROUP vltDModuleE vltDFTaskE yVLT_D_GROUP str
+                        { V3Config::addDpiGroup($<fl>1, *$2, *$3, *$5); }
         |       yVLT_FULL_CASE yVLT_D_FILE yaSTRING
                         { V3Config::addCaseFull(*$3, 0); }
         |       yVLT_FULL_CASE yVLT_D_FILE yaSTRING yVLT_D_LINES yaINTNUM
@@ -7216,6 +7222,10 @@ vltItem:
                         { V3Config::addCaseParallel(*$3, $5->toUInt()); }
         |       yVLT_PROFILE_DATA yVLT_D_MODEL yaSTRING yVLT_D_MTASK yaSTRING yVLT_D_COST yaINTNUM
                         { V3Config::addProfileData($<fl>1, *$3, *$5, $7->toUQuad()); }
+        |       yVLT_PROFILE_DATA yVLT_D_MODEL yaSTRING yVLT_D_CFUNC yaSTRING yVLT_D_COST yaINTNUM
+        /*cont*/    yVLT_D_CALLS yaINTNUM
+                        { V3Config::addProfileCFunc($<fl>1, *$3, *$5, $7->toUQuad(),
+                                                    $9->toUQuad()); }
         ;
 
 vltOffFront<errcodeen>:
@@ -0,0 +1,119 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   function automatic [31:0] mix(input [31:0] x, input [31:0] k);
+      integer i;
+      mix = x;
+      for (i = 0; i < 8; i = i + 1) mix = (mix ^ (mix << 5)) + (mix >> 3) + k;
+   endfunction
+
+   logic [31:0] a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, a17, a18, a19, a20, a21, a22, a23, a24, a25, a26, a27, a28, a29, a30, a31, a32;
+   logic [31:0] b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12, b13, b14, b15, b16, b17, b18, b19, b20, b21, b22, b23, b24, b25, b26, b27, b28, b29, b30, b31, b32;
+
+   // One huge combinational block, with two independent chains
+   always_comb begin
+      a0 = crc[31:0];
+      b0 = crc[63:32];
+      a1 = mix(a0, 32'd0);
+      b1 = mix(b0, 32'd100);
+      a2 = mix(a1, 32'd1);
+      b2 = mix(b1, 32'd101);
+      a3 = mix(a2, 32'd2);
+      b3 = mix(b2, 32'd102);
+      a4 = mix(a3, 32'd3);
+      b4 = mix(b3, 32'd103);
+      a5 = mix(a4, 32'd4);
+      b5 = mix(b4, 32'd104);
+      a6 = mix(a5, 32'd5);
+      b6 = mix(b5, 32'd105);
+      a7 = mix(a6, 32'd6);
+      b7 = mix(b6, 32'd106);
+      a8 = mix(a7, 32'd7);
+      b8 = mix(b7, 32'd107);
+      a9 = mix(a8, 32'd8);
+      b9 = mix(b8, 32'd108);
+      a10 = mix(a9, 32'd9);
+      b10 = mix(b9, 32'd109);
+      a11 = mix(a10, 32'd10);
+      b11 = mix(b10, 32'd110);
+      a12 = mix(a11, 32'd11);
+      b12 = mix(b11, 32'd111);
+      a13 = mix(a12, 32'd12);
+      b13 = mix(b12, 32'd112);
+      a14 = mix(a13, 32'd13);
+      b14 = mix(b13, 32'd113);
+      a15 = mix(a14, 32'd14);
+      b15 = mix(b14, 32'd114);
+      a16 = mix(a15, 32'd15);
+      b16 = mix(b15, 32'd115);
+      a17 = mix(a16, 32'd16);
+      b17 = mix(b16, 32'd116);
+      a18 = mix(a17, 32'd17);
+      b18 = mix(b17, 32'd117);
+      a19 = mix(a18, 32'd18);
+      b19 = mix(b18, 32'd118);
+      a20 = mix(a19, 32'd19);
+      b20 = mix(b19, 32'd119);
+      a21 = mix(a20, 32'd20);
+      b21 = mix(b20, 32'd120);
+      a22 = mix(a21, 32'd21);
+      b22 = mix(b21, 32'd121);
+      a23 = mix(a22, 32'd22);
+      b23 = mix(b22, 32'd122);
+      a24 = mix(a23, 32'd23);
+      b24 = mix(b23, 32'd123);
+      a25 = mix(a24, 32'd24);
+      b25 = mix(b24, 32'd124);
+      a26 = mix(a25, 32'd25);
+      b26 = mix(b25, 32'd125);
+      a27 = mix(a26, 32'd26);
+      b27 = mix(b26, 32'd126);
+      a28 = mix(a27, 32'd27);
+      b28 = mix(b27, 32'd127);
+      a29 = mix(a28, 32'd28);
+      b29 = mix(b28, 32'd128);
+      a30 = mix(a29, 32'd29);
+      b30 = mix(b29, 32'd129);
+      a31 = mix(a30, 32'd30);
+      b31 = mix(b30, 32'd130);
+      a32 = mix(a31, 32'd31);
+      b32 = mix(b31, 32'd131);
+   end
+
+   // Reference computed in a single clocked block
+   logic [31:0] refa;
+   logic [31:0] refb;
+   always @(posedge clk) begin
+      refa = crc[31:0];
+      refb = crc[63:32];
+      for (int j = 0; j < 32; ++j) begin
+         refa = mix(refa, j);
+         refb = mix(refb, j + 100);
+      end
+`ifdef TEST_VERBOSE
+      $write("[%0t] cyc==%0d crc=%x a=%x b=%x\n", $time, cyc, crc, a32, b32);
+`endif
+      if (a32 !== refa) $stop;
+      if (b32 !== refb) $stop;
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,70 @@
+// DESCRIPTION: Verilator: Associative arrays never iterated in key order
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+`define stop $stop
+`define checkd(gotv,expv) do if ((gotv) !== (expv)) begin $write("%%Error: %s:%0d:  got=%0d exp=%0d\n", `__FILE__,`__LINE__, (gotv), (expv)); `stop; end while(0);
+`define checks(gotv,expv) do if ((gotv) != (expv)) begin $write("%%Error: %s:%0d:  got='%s' exp='%s'\n", `__FILE__,`__LINE__, (gotv), (expv)); `stop; end while(0);
+
+module t;
+
+   // Only indexed, hashed
+   int sparse[longint];
+   // Iterated in order, not hashed
+   int names[string];
+   // Outer only indexed, hashed; inner type is iterated
+   int nested[int][string];
+
+   function automatic int count(input int a[longint]);
+      return a.num();
+   endfunction
+
+   initial begin
+      string s;
+      int sum;
+      int copy[longint];
+
+      for (longint i = 0; i < 1000; ++i) sparse[i * 64'h1_0000_0001] = int'(i);
+      `checkd(sparse.num(), 1000);
+      `checkd(sparse[999 * 64'h1_0000_0001], 999);
+      `checkd(sparse.exists(64'h1_0000_0001), 1);
+      `checkd(sparse.exists(64'h1_0000_0002), 0);
+      `checkd(sparse[64'h1_0000_0002], 0);
+      sparse.delete(0);
+      `checkd(sparse.size(), 999);
+      copy = sparse;
+      `checkd(count(copy), 999);
+      `checkd(copy == sparse, 1);
+      copy[5] = 5;
+      `checkd(copy != sparse, 1);
+      sparse.delete();
+      `checkd(count(sparse), 0);
+
+      names["b"] = 2;
+      names["c"] = 3;
+      names["a"] = 1;
+      s = "";
+      foreach (names[k]) s = {s, k};
+      `checks(s, "abc");
+      `checkd(names.first(s), 1);
+      `checks(s, "a");
+      `checkd(names.next(s), 1);
+      `checks(s, "b");
+
+      nested[2]["y"] = 2;
+      nested[2]["x"] = 1;
+      nested[1]["z"] = 3;
+      `checkd(nested[2].first(s), 1);
+      `checks(s, "x");
+      `checkd(nested.exists(1), 1);
+      `checkd(nested[1]["z"], 3);
+      sum = 0;
+      foreach (nested[2][k]) sum += nested[2][k];
+      `checkd(sum, 3);
+
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
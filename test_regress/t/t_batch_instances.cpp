@@ -0,0 +1,53 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include <string>
+
+// These require the above. Comment prevents clang-format moving them
+#include "TestCheck.h"
+
+#include VM_PREFIX_INCLUDE
+
+double sc_time_stamp() { return 0; }
+
+int errors = 0;
+
+int main(int argc, char** argv) {
+    using Batch = Vt_batch_instances__Batch;
+    Batch batch;
+    TEST_CHECK_EQ(Batch::INSTANCES, 4);
+
+    batch.commandArgs(argc, const_cast<const char**>(argv));
+    // Each instance runs for a different number of cycles
+    for (int i = 0; i < Batch::INSTANCES; ++i) {
+        const std::string arg = "+limit=" + std::to_string(3 + i);
+        const char* argp = arg.c_str();
+        batch.context(i).commandArgsAdd(1, &argp);
+    }
+
+    for (int cycle = 0; batch.running() && cycle < 100; ++cycle) {
+        for (int i = 0; i < Batch::INSTANCES; ++i) batch.model(i).clk = 0;
+        batch.eval();
+        batch.timeInc(1);
+        for (int i = 0; i < Batch::INSTANCES; ++i) batch.model(i).clk = 1;
+        batch.eval();
+        batch.timeInc(1);
+    }
+
+    TEST_CHECK_EQ(batch.running(), 0);
+    for (int i = 0; i < Batch::INSTANCES; ++i) {
+        TEST_CHECK_EQ(batch.model(i).count, static_cast<uint32_t>(3 + i));
+        TEST_CHECK_EQ(batch.context(i).time(), static_cast<uint64_t>(2 * (3 + i) - 1));
+    }
+    batch.final();
+
+    if (!errors) VL_PRINTF("*-* All Finished *-*\n");
+    return errors ? 10 : 0;
+}
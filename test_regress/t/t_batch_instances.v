@@ -0,0 +1,23 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t
+  (
+   input             clk,
+   output bit [31:0] count
+   );
+
+   int limit;
+
+   initial begin
+      if (!$value$plusargs("limit=%d", limit)) $stop;
+   end
+
+   always @(posedge clk) begin
+      count <= count + 1;
+      if (count + 1 == limit) $finish;
+   end
+endmodule
@@ -0,0 +1,27 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_case_huge.v");
+
+compile(
+    verilator_flags2 => ["--stats -fno-inline"],
+    );
+
+# The eight instances of t_case_huge_sub convert the same logic
+file_grep($Self->{stats}, qr/Optimizations, Tables shared\s+[1-9]/i);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
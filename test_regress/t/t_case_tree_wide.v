@@ -0,0 +1,102 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   wire [31:0] in = crc[31:0];
+
+   // Wide decoder with wildcards, decided with a tree over the instruction bits
+   function automatic [7:0] decode(input [31:0] i);
+      casez (i)
+        32'b0000000_?????_?????_000_?????_0110011: decode = 8'd1;
+        32'b0100000_?????_?????_000_?????_0110011: decode = 8'd2;
+        32'b0000000_?????_?????_001_?????_0110011: decode = 8'd3;
+        32'b0000000_?????_?????_010_?????_0110011: decode = 8'd4;
+        32'b0000000_?????_?????_011_?????_0110011: decode = 8'd5;
+        32'b0000000_?????_?????_100_?????_0110011: decode = 8'd6;
+        32'b0000000_?????_?????_101_?????_0110011: decode = 8'd7;
+        32'b0100000_?????_?????_101_?????_0110011: decode = 8'd8;
+        32'b0000000_?????_?????_110_?????_0110011: decode = 8'd9;
+        32'b0000000_?????_?????_111_?????_0110011: decode = 8'd10;
+        32'b????????????_?????_000_?????_0010011: decode = 8'd11;
+        32'b????????????_?????_010_?????_0010011: decode = 8'd12;
+        32'b????????????_?????_100_?????_0010011: decode = 8'd13;
+        32'b????????????_?????_110_?????_0010011: decode = 8'd14;
+        32'b????????????_?????_111_?????_0010011: decode = 8'd15;
+        32'b????????????_?????_000_?????_0000011: decode = 8'd16;
+        32'b????????????_?????_010_?????_0000011: decode = 8'd17;
+        32'b???????_?????_?????_000_?????_0100011: decode = 8'd18;
+        32'b???????_?????_?????_010_?????_0100011: decode = 8'd19;
+        32'b????????????????????_?????_0110111: decode = 8'd20;
+        32'b????????????????????_?????_1101111: decode = 8'd21;
+        32'h00000073: decode = 8'd22;
+        32'h00100073: decode = 8'd23;
+        32'b????????????????????????????????: decode = 8'd24;
+      endcase
+   endfunction
+
+   // Reference priority encoder, written without a case statement
+   function automatic [7:0] decode_ref(input [31:0] i);
+      logic [6:0] op;
+      logic [2:0] f3;
+      logic [6:0] f7;
+      op = i[6:0];
+      f3 = i[14:12];
+      f7 = i[31:25];
+      if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b000) decode_ref = 8'd1;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b001) decode_ref = 8'd3;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b010) decode_ref = 8'd4;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b011) decode_ref = 8'd5;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b100) decode_ref = 8'd6;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b101) decode_ref = 8'd7;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b110) decode_ref = 8'd9;
+      else if (op == 7'b0110011 && f7 == 7'b0000000 && f3 == 3'b111) decode_ref = 8'd10;
+      else if (op == 7'b0110011 && f7 == 7'b0100000 && f3 == 3'b000) decode_ref = 8'd2;
+      else if (op == 7'b0110011 && f7 == 7'b0100000 && f3 == 3'b101) decode_ref = 8'd8;
+      else if (op == 7'b0010011 && f3 == 3'b000) decode_ref = 8'd11;
+      else if (op == 7'b0010011 && f3 == 3'b010) decode_ref = 8'd12;
+      else if (op == 7'b0010011 && f3 == 3'b100) decode_ref = 8'd13;
+      else if (op == 7'b0010011 && f3 == 3'b110) decode_ref = 8'd14;
+      else if (op == 7'b0010011 && f3 == 3'b111) decode_ref = 8'd15;
+      else if (op == 7'b0000011 && f3 == 3'b000) decode_ref = 8'd16;
+      else if (op == 7'b0000011 && f3 == 3'b010) decode_ref = 8'd17;
+      else if (op == 7'b0100011 && f3 == 3'b000) decode_ref = 8'd18;
+      else if (op == 7'b0100011 && f3 == 3'b010) decode_ref = 8'd19;
+      else if (op == 7'b0110111) decode_ref = 8'd20;
+      else if (op == 7'b1101111) decode_ref = 8'd21;
+      else if (i == 32'h00000073) decode_ref = 8'd22;
+      else if (i == 32'h00100073) decode_ref = 8'd23;
+      else decode_ref = 8'd24;
+   endfunction
+
+   // Mix in encodings that hit the decoder arms, not only random values
+   wire [31:0] hit = {crc[40] ? 7'b0100000 : 7'b0000000, crc[24:7],
+                      crc[41] ? 7'b0110011 : crc[42] ? 7'b0010011 : 7'b0000011};
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (decode(in) != decode_ref(in)) begin
+         $write("%%Error: in=%x decode=%d exp=%d\n", in, decode(in), decode_ref(in));
+         $stop;
+      end
+      if (decode(hit) != decode_ref(hit)) begin
+         $write("%%Error: hit=%x decode=%d exp=%d\n", hit, decode(hit), decode_ref(hit));
+         $stop;
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
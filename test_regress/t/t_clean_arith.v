@@ -0,0 +1,51 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   logic [3:0] a;
+   logic [2:0] b;
+   logic [4:0] sum;  // Can't overflow
+   logic [3:0] wrap;  // Can overflow
+   logic [6:0] prod;  // Can't overflow
+   logic [5:0] prod_wrap;  // Can overflow
+   logic [6:0] shl;  // Can't overflow
+   logic [5:0] shl_wrap;  // Can overflow
+   logic [40:0] wide_sum;
+
+   always_comb begin
+      a = cyc[3:0];
+      b = cyc[6:4];
+      sum = {1'b0, a} + {2'b0, b};
+      wrap = a + {1'b0, b};
+      prod = {3'b0, a} * {4'b0, b};
+      prod_wrap = {2'b0, a} * {3'b0, b};
+      shl = {3'b0, a} << 3;
+      shl_wrap = {2'b0, a} << 3;
+      wide_sum = {1'b0, cyc[31:0], 8'h0} + {9'h0, cyc[31:0]};
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      if (sum != 5'(32'(a) + 32'(b))) $stop;
+      if (wrap != 4'(32'(a) + 32'(b))) $stop;
+      if (prod != 7'(32'(a) * 32'(b))) $stop;
+      if (prod_wrap != 6'(32'(a) * 32'(b))) $stop;
+      if (shl != 7'(32'(a) << 3)) $stop;
+      if (shl_wrap != 6'(32'(a) << 3)) $stop;
+      if (wide_sum != 41'(64'(cyc) * 257)) $stop;
+      if (cyc == 200) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
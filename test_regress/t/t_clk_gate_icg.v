@@ -0,0 +1,43 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   reg     en = 0;
+
+   // Clock gated by a latch, transparent while clk is low
+   reg     en_l;
+   always_latch if (!clk) en_l = en;
+   wire    gclk_l = clk & en_l;
+
+   // Clock gated by a negedge flop
+   reg     en_n = 0;
+   always @(negedge clk) en_n <= en;
+   wire    gclk_n = en_n & clk;
+
+   integer cnt_l = 0;
+   integer cnt_n = 0;
+   always @(posedge gclk_l) cnt_l <= cnt_l + 1;
+   always @(posedge gclk_n) cnt_n <= cnt_n + 1;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      en <= (cyc % 3) == 0;
+      if (cyc == 20) begin
+         $write("[%0t] cnt_l=%0d cnt_n=%0d\n", $time, cnt_l, cnt_n);
+         if (cnt_l != 7) $stop;
+         if (cnt_n != 7) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,40 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+// Many clock domains, so the checks of their triggers get grouped
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [7:0] gclk = 8'h0;
+   integer cnt[0:7];
+
+   initial for (int i = 0; i < 8; ++i) cnt[i] = 0;
+
+   for (genvar g = 0; g < 8; ++g) begin : gen_dom
+      always @(posedge gclk[g]) cnt[g] <= cnt[g] + 1;
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      gclk <= gclk + 8'd1;
+      if (cyc == 200) begin
+         // Bit g of the counter rose once per 2**(g+1) increments
+         for (int i = 0; i < 8; ++i) begin
+`ifdef TEST_VERBOSE
+            $write("cnt[%0d] = %0d\n", i, cnt[i]);
+`endif
+            if (cnt[i] != ((200 + (1 << i)) >> (i + 1))) $stop;
+         end
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
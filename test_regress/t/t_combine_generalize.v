@@ -0,0 +1,57 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   wire [31:0] out1;
+   wire [31:0] out2;
+   reg [31:0]  acc = 0;
+   reg [31:0]  expected = 0;
+
+   // Parameter values differ, but do not reach the logic, so the modules
+   // are different, but their evaluation functions are identical
+   sub #(.ID(1)) u1 (.clk, .in(crc[31:0]), .out(out1));
+   sub #(.ID(2)) u2 (.clk, .in(crc[31:0]), .out(out2));
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      acc <= (acc ^ crc[31:0]) + {acc[15:0], acc[31:16]} - (acc >> 3);
+      expected <= acc * 32'd3 + crc[31:0];
+      if (out1 !== expected || out2 !== expected) begin
+         $display("%%Error: cyc=%0d out1=%x out2=%x exp=%x", cyc, out1, out2, expected);
+         $stop;
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub #(parameter ID = 0) (
+   input clk,
+   input [31:0] in,
+   output reg [31:0] out = 0
+   );
+   /*verilator no_inline_module*/
+
+   reg [31:0] acc = 0;
+
+   always @(posedge clk) begin
+      acc <= (acc ^ in) + {acc[15:0], acc[31:16]} - (acc >> 3);
+      out <= acc * 32'd3 + in;
+   end
+
+   final if (ID == 0) $stop;
+endmodule
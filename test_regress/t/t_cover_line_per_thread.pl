@@ -0,0 +1,42 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vltmt => 1);
+
+top_filename("t/t_cover_line.v");
+golden_filename("t/t_cover_line.out");
+
+compile(
+    verilator_flags2 => ['--cc --coverage-line --coverage-per-thread +define+ATTRIBUTE'],
+    threads => 4,
+    );
+
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}__Syms.h",
+          qr/alignas\(VL_CACHE_LINE_BYTES\) uint32_t __Vcoverage\[4\]\[/);
+
+execute(
+    check_finished => 1,
+    );
+
+# Read the input .v file and do any CHECK_COVER requests
+inline_checks();
+
+# Counts summed over the threads must match the single counter results
+run(cmd => ["../bin/verilator_coverage",
+            "--annotate-points",
+            "--annotate", "$Self->{obj_dir}/annotated",
+            "$Self->{obj_dir}/coverage.dat"],
+    verilator_run => 1,
+    );
+
+files_identical("$Self->{obj_dir}/annotated/t_cover_line.v", $Self->{golden_filename});
+
+ok(1);
+1;
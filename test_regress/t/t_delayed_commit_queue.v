@@ -0,0 +1,63 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   localparam SIZE = 1024;
+
+   integer cyc = 0;
+   int array [SIZE];
+   logic [95:0] wide [SIZE];
+
+   // Delayed assignments in loops, too large to unroll
+   always @(posedge clk) begin
+      if (cyc == 0) begin
+         for (int i = 0; i < SIZE; i++) begin
+            array[i] <= i;
+            wide[i] <= {i, ~i, i};
+         end
+         // Old values until the end of the time step
+         if (array[5] != 0) $stop;
+      end
+      else if (cyc == 2) begin
+         for (int i = 0; i < SIZE; i++) array[i] <= array[SIZE - 1 - i];
+      end
+   end
+
+   // Other delayed assignments to the same memory, last one wins
+   always @(posedge clk) begin
+      if (cyc == 4) begin
+         array[7] <= 1;
+         array[7] <= 2;
+         wide[9] <= '1;
+      end
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 1) begin
+         if (array[5] != 5) $stop;
+         if (array[SIZE - 1] != SIZE - 1) $stop;
+         if (wide[3] != {32'd3, ~32'd3, 32'd3}) $stop;
+      end
+      else if (cyc == 3) begin
+         if (array[0] != SIZE - 1) $stop;
+         if (array[SIZE - 1] != 0) $stop;
+      end
+      else if (cyc == 5) begin
+         if (array[7] != 2) $stop;
+         if (array[8] != SIZE - 9) $stop;
+         if (wide[9] != '1) $stop;
+         if (wide[10] != {32'd10, ~32'd10, 32'd10}) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -153,6 +153,8 @@ module t (
    `signal(REPLACE_NESTED_CONCAT_OF_ADJOINING_SELS_ON_RHS_CAT, {rand_b, rand_a[10:3]});
    `signal(REPLACE_NESTED_CONCAT_OF_ADJOINING_SELS_ON_LHS, {rand_a[10:3], {rand_a[2:1], rand_b}});
    `signal(REPLACE_NESTED_CONCAT_OF_ADJOINING_SELS_ON_RHS, {{rand_b, rand_a[10:3]}, rand_a[2:1]});
+   `signal(REPLACE_CONCAT_OF_REVERSED_BYTES_WITH_STREAML, {rand_a[7:0], rand_a[15:8], rand_a[23:16], rand_a[31:24]});
+   `signal(REPLACE_CONCAT_OF_REVERSED_BYTES_WITH_STREAML_64, {rand_b[7:0], rand_b[15:8], rand_b[23:16], rand_b[31:24], rand_b[39:32], rand_b[47:40], rand_b[55:48], rand_b[63:56]});
    `signal(REMOVE_COND_WITH_FALSE_CONDITION, 1'd0 ? rand_a : rand_b);
    `signal(REMOVE_COND_WITH_TRUE_CONDITION, 1'd1 ? rand_a : rand_b);
    `signal(SWAP_COND_WITH_NOT_CONDITION, (~rand_a[0] & 1'd1) ? rand_a : rand_b);
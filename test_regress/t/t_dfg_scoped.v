@@ -0,0 +1,51 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   wire [15:0] a = crc[15:0];
+   wire [15:0] b = crc[31:16];
+
+   wire [15:0] and_out;
+   wire [15:0] or_out;
+   wire [15:0] xor_out;
+
+   // The select inputs are constant per instance, so can only be folded across the hierarchy
+   sub sub_and (.a(a), .b(b), .sel(2'd0), .out(and_out));
+   sub sub_or (.a(a), .b(b), .sel(2'd1), .out(or_out));
+   sub sub_xor (.a(a), .b(b), .sel(2'd2), .out(xor_out));
+
+   always @ (posedge clk) begin
+`ifdef TEST_VERBOSE
+      $write("[%0t] cyc=%0d a=%x b=%x\n", $time, cyc, a, b);
+`endif
+      if (and_out !== (a & b)) $stop;
+      if (or_out !== (a | b)) $stop;
+      if (xor_out !== (a ^ b)) $stop;
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub (
+   input [15:0] a,
+   input [15:0] b,
+   input [1:0] sel,
+   output [15:0] out
+   );
+   assign out = sel == 2'd0 ? a & b : sel == 2'd1 ? a | b : a ^ b;
+endmodule
@@ -0,0 +1,32 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(simulator => 1);
+
+compile(
+    );
+
+execute(
+    check_finished => 1,
+    expect => qr/Constant text/,
+    );
+
+if ($Self->{vlt_all}) {
+    # Text without format codes should not go through VL_WRITEF
+    my $has_writes = 0;
+    for my $file (glob_all("$Self->{obj_dir}/$Self->{vm_prefix}___024root__DepSet_*.cpp")) {
+        my $text = file_contents($file);
+        $has_writes = 1 if ($text =~ m/VL_WRITES\("Constant text\\n"\)/);
+    }
+    error("No file has 'VL_WRITES'") if !$has_writes;
+}
+
+ok(1);
+1;
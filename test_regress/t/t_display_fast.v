@@ -0,0 +1,57 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+`define checks(gotv,expv) do if ((gotv) != (expv)) begin $write("%%Error: %s:%0d:  got='%s' exp='%s'\n", `__FILE__,`__LINE__, (gotv), (expv)); $stop; end while(0);
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   logic [7:0] b8;
+   logic [39:0] b40;
+   logic [63:0] b64;
+   logic [79:0] b80;
+   string s;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      b8 <= 8'hf3 + cyc[7:0];
+      b40 <= 40'h41_4243_4400 + {8'h0, cyc};
+      b64 <= 64'h8000_0000_0000_0000 + {32'h0, cyc};
+      b80 <= 80'hfff5_0123_4567_89ab_cdef + {48'h0, cyc};
+      if (cyc == 1) begin
+         s = $sformatf("[%d][%0d][%5d][%05d][%-5d]", $signed(b8), $signed(b8),
+                       $signed(b8), $signed(b8), $signed(b8));
+         `checks(s, "[ -13][-13][  -13][00-13][-13  ]");
+         s = $sformatf("[%d][%0d][%6d][%06d][%-6d]", b8, b8, b8, b8, b8);
+         `checks(s, "[243][243][   243][000243][243   ]");
+         s = $sformatf("[%0d][%0d]", $signed(b64), b64);
+         `checks(s, "[-9223372036854775808][9223372036854775808]");
+         s = $sformatf("[%0d][%0d]", $signed(b80), b80);
+         `checks(s, "[-202832199281588580881][1208722987415347586125295]");
+         s = $sformatf("[%x][%0x][%10x][%-10x]", b40, b8, b8, b8);
+         `checks(s, "[4142434400][f3][00000000f3][f3        ]");
+         s = $sformatf("[%0x][%x]", b80, b64);
+         `checks(s, "[fff50123456789abcdef][8000000000000000]");
+         s = $sformatf("[%b][%0b][%12b][%-12b]", b8, b8, b8, b8);
+         `checks(s, "[11110011][11110011][000011110011][11110011    ]");
+         s = $sformatf("[%o][%0o]", b8, b40);
+         `checks(s, "[363][4050220642000]");
+         s = $sformatf("[%s][%8s][%-8s]", b40[39:8], b40[39:8], b40[39:8]);
+         `checks(s, "[ABCD][    ABCD][ABCD    ]");
+      end
+      else if (cyc == 2) begin
+         $write("Constant text\n");
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,39 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+module t;
+   int values[16];
+   int total;
+
+   export "DPI-C" function dpix_set;
+   function void dpix_set(input int idx, input int value);
+      values[idx] = value;
+   endfunction
+
+   export "DPI-C" function dpix_add;
+   function int dpix_add(input bit [63:0] value);
+      total += int'(value[31:0]) + int'(value[63:32]);
+      return total;
+   endfunction
+
+   import "DPI-C" context function void dpii_batch();
+
+   initial begin
+      total = 0;
+      dpii_batch();
+      for (int i = 0; i < 16; ++i) begin
+         if (values[i] !== i * 3) begin
+            $write("%%Error: values[%0d] = %0d\n", i, values[i]);
+            $stop;
+         end
+      end
+      if (total !== 10) $stop;
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
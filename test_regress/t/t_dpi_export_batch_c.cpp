@@ -0,0 +1,46 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#include "svdpi.h"
+#include "verilated_dpi_batch.h"
+
+#include <cstdio>
+
+#include "Vt_dpi_export_batch__Dpi.h"
+
+//======================================================================
+
+#define CHECK_RESULT(got, exp) \
+    if ((got) != (exp)) { \
+        printf("%%Error: %s:%d: GOT = %d   EXP = %d\n", __FILE__, __LINE__, \
+               static_cast<int>(got), static_cast<int>(exp)); \
+        return; \
+    }
+
+void dpii_batch() {
+    const svScope scope = svGetScope();
+    VerilatedDpiBatch batch{scope};
+    CHECK_RESULT(batch.empty(), true);
+    batch.reserve(20, 20 * 16);
+    for (int i = 15; i >= 0; --i) batch.add(dpix_set, i, i + 100);
+    for (int i = 0; i < 16; ++i) batch.add(dpix_set, i, i * 3);  // Must run after above
+    // Arguments must stay valid until run
+    const svBitVecVal values[2][2] = {{1, 2}, {3, 4}};
+    batch.add(dpix_add, values[0]);
+    batch.add(dpix_add, values[1]);
+    CHECK_RESULT(batch.size(), 34);
+
+    // Run from a different scope, the batch's scope must be used
+    svSetScope(nullptr);
+    batch.run();
+    CHECK_RESULT(batch.empty(), true);
+    CHECK_RESULT(svSetScope(scope) == nullptr, true);  // Previous scope was restored
+}
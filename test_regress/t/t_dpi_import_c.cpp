@@ -17,7 +17,9 @@
 //======================================================================
 
 // clang-format off
-#if defined(VERILATOR)
+#if defined(VERILATOR) && defined(T_DPI_IMPORT_NODIRECT)
+# include "Vt_dpi_import_nodirect__Dpi.h"
+#elif defined(VERILATOR)
 # include "Vt_dpi_import__Dpi.h"
 #elif defined(VCS)
 # include "../vc_hdrs.h"
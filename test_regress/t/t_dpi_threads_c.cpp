@@ -22,6 +22,8 @@
 #if defined(VERILATOR)
 # ifdef T_DPI_THREADS_COLLIDE
 #  include "Vt_dpi_threads_collide__Dpi.h"
+# elif defined(T_DPI_THREADS_GROUP)
+#  include "Vt_dpi_threads_group__Dpi.h"
 # else
 #  include "Vt_dpi_threads__Dpi.h"
 # endif
@@ -0,0 +1,25 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vltmt => 1);
+
+top_filename("t/t_dpi_threads.v");
+
+# Calls to imports in the same dpi_group are still serialized
+compile(
+    v_flags2 => ["t/t_dpi_threads_c.cpp t/$Self->{name}.vlt --no-threads-coarsen"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
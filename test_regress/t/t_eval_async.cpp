@@ -0,0 +1,49 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include VM_PREFIX_INCLUDE
+
+double sc_time_stamp() { return 0; }
+
+int main(int argc, char* argv[]) {
+    Verilated::debug(0);
+    Verilated::commandArgs(argc, argv);
+
+    VM_PREFIX* const topp = new VM_PREFIX;
+    topp->clk = 0;
+    topp->inc = 1;
+    topp->eval();
+
+    uint32_t expected = 0;
+    uint8_t nextInc = 1;
+    while (!Verilated::gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->evalAsync();
+        // Work overlapping the evaluation, not touching the model
+        const uint8_t inc = nextInc;
+        nextInc = (nextInc % 7) + 1;
+        topp->evalWait();
+        if (topp->clk) {
+            expected += inc;
+            if (topp->count != expected) {
+                fprintf(stderr, "%%Error: count: got=%u exp=%u\n", topp->count, expected);
+                exit(1);
+            }
+        }
+        topp->inc = nextInc;
+    }
+
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
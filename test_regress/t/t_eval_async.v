@@ -0,0 +1,24 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   count,
+   // Inputs
+   clk, inc
+   );
+   input clk;
+   input [7:0] inc;
+   output reg [31:0] count = 0;
+
+   always @(posedge clk) begin
+      count <= count + {24'b0, inc};
+      if (count >= 1000) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,68 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include VM_PREFIX_INCLUDE
+
+double sc_time_stamp() { return 0; }
+
+static void check(const char* what, uint32_t got, uint32_t exp) {
+    if (got != exp) {
+        fprintf(stderr, "%%Error: %s: got=%u exp=%u\n", what, got, exp);
+        exit(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Verilated::debug(0);
+    Verilated::commandArgs(argc, argv);
+
+    VM_PREFIX* const topp = new VM_PREFIX;
+    topp->clk = 0;
+    topp->rst_n = 0;
+    topp->inc = 0;
+    topp->eval();
+    topp->rst_n = 1;
+    topp->inc = 1;
+
+    // Input changes are evaluated before the first cycle
+    topp->evalCycles(10);
+    check("count after 10 cycles", topp->count, 20);
+    check("count_next after 10 cycles", topp->count_next, 22);
+    check("clk after 10 cycles", topp->clk, 0);
+
+    // Same as toggling the clock by hand
+    for (int i = 0; i < 5; ++i) {
+        topp->clk = 1;
+        topp->eval();
+        topp->clk = 0;
+        topp->eval();
+    }
+    check("count after 5 toggled cycles", topp->count, 30);
+
+    topp->inc = 5;
+    topp->evalCycles(10);
+    check("count after 10 more cycles", topp->count, 130);
+    check("count_next after 10 more cycles", topp->count_next, 140);
+
+    // Stops at the $finish
+    topp->evalCycles(1000);
+    check("count at $finish", topp->count, 1010);
+    if (!Verilated::gotFinish()) {
+        fprintf(stderr, "%%Error: evalCycles did not stop at $finish\n");
+        exit(1);
+    }
+
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe", "$Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+# The clock evaluation skips the input combinational logic not reading the clock
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.h", qr/void evalCycles\(uint64_t cycles\);/);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.cpp", qr/___eval_clock\(/);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,34 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   count, count_next,
+   // Inputs
+   clk, rst_n, inc
+   );
+   input clk /*verilator clocker*/;
+   input rst_n;
+   input [7:0] inc;
+   output reg [31:0] count;
+   output [31:0] count_next;
+
+   // Input combinational logic not reading the clock
+   wire [31:0] step = {24'b0, inc} * 2;
+   assign count_next = count + step;
+
+   always @(posedge clk or negedge rst_n) begin
+      if (!rst_n) count <= 0;
+      else count <= count_next;
+   end
+
+   always @(posedge clk) begin
+      if (count >= 1000) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
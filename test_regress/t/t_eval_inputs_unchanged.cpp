@@ -0,0 +1,58 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include VM_PREFIX_INCLUDE
+
+double sc_time_stamp() { return 0; }
+
+static void check(const char* what, uint32_t got, uint32_t exp) {
+    if (got != exp) {
+        fprintf(stderr, "%%Error: %s: got=%u exp=%u\n", what, got, exp);
+        exit(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Verilated::debug(0);
+    Verilated::commandArgs(argc, argv);
+
+    VM_PREFIX* const topp = new VM_PREFIX;
+    topp->in = 1;
+    topp->eval();
+    check("out", topp->out, 3);
+
+    topp->in = 2;
+    topp->eval();
+    check("out after change", topp->out, 6);
+    const uint32_t changedIterations = topp->evalIterations();
+
+    // Skips the input combinational logic
+    topp->inputsUnchanged();
+    topp->eval();
+    check("out unchanged", topp->out, 6);
+    if (topp->evalIterations() >= changedIterations) {
+        fprintf(stderr, "%%Error: input combinational logic not skipped\n");
+        exit(1);
+    }
+
+    // Only applies to the next evaluation
+    topp->in = 5;
+    topp->eval();
+    check("out after next change", topp->out, 15);
+    check("iterations after next change", topp->evalIterations(), changedIterations);
+
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    printf("*-* All Finished *-*\n");
+    return 0;
+}
@@ -0,0 +1,33 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+top_filename("t/t_flag_csplit.v");
+
+compile(
+    verilator_flags2 => ["--output-split 1 --output-split-cfuncs 1 --output-groups 2"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+my $classes = "$Self->{obj_dir}/$Self->{vm_prefix}_classes.mk";
+file_grep($classes, qr/VM_PARALLEL_BUILDS\s*=\s*1/);
+# Split files are compiled through the group files only
+file_grep($classes, qr/$Self->{vm_prefix}__FastGroup__0/);
+file_grep($classes, qr/$Self->{vm_prefix}__FastGroup__1/);
+file_grep_not($classes, qr/$Self->{vm_prefix}__FastGroup__2/);
+file_grep_not($classes, qr/DepSet_/);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}__FastGroup__0.cpp", qr/#include ".*DepSet_/);
+
+ok(1);
+1;
@@ -0,0 +1,33 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+top_filename("t/t_flag_csplit.v");
+
+compile(
+    verilator_flags2 => ["--output-split 1 --output-split-cfuncs 1 --output-split-stable"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Split files are named by hash of their first function, not numbered
+my $got = 0;
+foreach my $file (glob("$Self->{obj_dir}/*DepSet_*.cpp")) {
+    $file =~ /__DepSet_h[0-9a-f]+__h[0-9a-f]+__\d+(__Slow)?\.cpp$/
+        or error("Split file not named by first function: $file");
+    ++$got;
+}
+$got or error("No split files found");
+
+ok(1);
+1;
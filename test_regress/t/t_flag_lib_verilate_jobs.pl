@@ -0,0 +1,25 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+top_filename("t/t_flag_lib.v");
+
+# Source and library files are read ahead in parallel with --verilate-jobs
+compile(
+    v_flags2 => ['-v', 't/t_flag_libinc.v', '--verilate-jobs 4'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -20,6 +20,8 @@ execute(
 
 my @files = glob_all("$Self->{obj_dir}/$Self->{vm_prefix}___024root__DepSet_*__Slow.cpp");
 file_grep_any(\@files, qr/VL_RAND_RESET/);
+file_grep_any(\@files, qr/VL_RAND_RESET_ARRAY_C/);
+file_grep_any(\@files, qr/VL_RAND_RESET_ARRAY_W/);
 
 ok(1);
 1;
@@ -6,7 +6,7 @@
 
 module t (/*AUTOARG*/
    // Outputs
-   value, value2
+   value, value2, value3, value4
    );
 
    output reg [63:0] value;
@@ -14,6 +14,14 @@ module t (/*AUTOARG*/
 
    assign value2 = {8'bx, 57'h12};
 
+   // Memories are reset with a single call
+   reg [7:0] mem8 [0:1023];
+   reg [69:0] memw [0:15];
+   output wire [7:0] value3;
+   output wire [69:0] value4;
+   assign value3 = mem8[value[9:0]];
+   assign value4 = memw[value[3:0]];
+
    initial begin
       $write("*-* All Finished *-*\n");
       $finish;
@@ -0,0 +1,88 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+// Forced signals are only checked for overrides once anything has been
+// forced, so check values both before and after the first force
+
+`define stop $stop
+`define checkh(gotv,expv) do if ((gotv) !== (expv)) begin $write("%%Error: %s:%0d:  got='h%x exp='h%x\n", `__FILE__,`__LINE__, (gotv), (expv)); `stop; end while(0)
+
+module t(/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+
+   // Forceable from C++, so always takes the override path
+   wire [7:0] fwire /*verilator forceable*/;
+   // Only forced by statements, so uses the fast path until the first force
+   wire [7:0] nwire;
+   wire [7:0] mwire;
+   reg [7:0]  nreg;
+   wire       nbit;
+
+   assign fwire = cyc[7:0] + 8'd1;
+   assign nwire = cyc[7:0] + 8'd2;
+   assign mwire = cyc[7:0] + 8'd3;
+   assign nbit = cyc[0];
+
+   always @(posedge clk) nreg <= cyc[7:0] + 8'd4;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc > 1 && cyc < 99) begin
+         `checkh(fwire, cyc[7:0] + 8'd1);
+         `checkh(mwire, cyc[7:0] + 8'd3);
+      end
+      if (cyc > 1 && cyc < 10) begin
+         // Nothing forced yet
+         `checkh(nwire, cyc[7:0] + 8'd2);
+         `checkh(nreg, cyc[7:0] + 8'd3);
+         `checkh(nbit, cyc[0]);
+      end
+      if (cyc == 10) begin
+         force nwire = 8'h5a;
+         force nreg = 8'ha5;
+         force nbit = 1'b1;
+      end
+      else if (cyc > 10 && cyc < 20) begin
+         `checkh(nwire, 8'h5a);
+         `checkh(nreg, 8'ha5);
+         `checkh(nbit, 1'b1);
+      end
+      else if (cyc == 20) begin
+         release nwire;
+         release nreg;
+         release nbit;
+      end
+      else if (cyc > 21 && cyc < 30) begin
+         // Released, but the override is still evaluated
+         `checkh(nwire, cyc[7:0] + 8'd2);
+         `checkh(nreg, cyc[7:0] + 8'd3);
+         `checkh(nbit, cyc[0]);
+      end
+      else if (cyc == 30) begin
+         force nwire[3:0] = 4'hf;
+      end
+      else if (cyc > 30 && cyc < 40) begin
+         `checkh(nwire, (cyc[7:0] + 8'd2) | 8'h0f);
+      end
+      else if (cyc == 40) begin
+         release nwire;
+      end
+      else if (cyc > 40 && cyc < 99) begin
+         `checkh(nwire, cyc[7:0] + 8'd2);
+      end
+      else if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,87 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_cov.h>
+#include <verilated_vcd_c.h>
+
+#include <memory>
+#include <string>
+#include <sys/wait.h>
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+static void cycles(VM_PREFIX* topp, VerilatedVcdC* tfp, unsigned long long until) {
+    while (main_time < until) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        tfp->dump((unsigned int)(main_time));
+        ++main_time;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->debug(0);
+    contextp->traceEverOn(true);
+    contextp->commandArgs(argc, argv);
+
+    std::unique_ptr<VM_PREFIX> top{new VM_PREFIX{contextp.get(), "top"}};
+    std::unique_ptr<VerilatedVcdC> tfp{new VerilatedVcdC};
+    top->trace(tfp.get(), 99);
+    tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vcd");
+
+    // "Boot"
+    top->clk = 0;
+    cycles(top.get(), tfp.get(), 20);
+
+    for (int test = 0; test < 3; ++test) {
+        const int pid = contextp->forkChild();
+        if (pid < 0) {
+            printf("%%Error: fork failed\n");
+            return 1;
+        }
+        if (pid == 0) {
+            // Child: the parent's trace is detached, trace into our own file
+            std::unique_ptr<VerilatedVcdC> ownp{new VerilatedVcdC};
+            top->trace(ownp.get(), 99);
+            const std::string prefix
+                = std::string{VL_STRINGIFY(TEST_OBJ_DIR) "/child"} + std::to_string(test);
+            ownp->open((prefix + ".vcd").c_str());
+            const unsigned long long end = main_time + 10 * (test + 1);
+            while (main_time < end) {
+                top->clk = !top->clk;
+                top->eval();
+                tfp->dump((unsigned int)(main_time));  // Ignored
+                ownp->dump((unsigned int)(main_time));
+                ++main_time;
+            }
+            ownp->close();
+            contextp->coveragep()->write((prefix + ".dat").c_str());
+            top->final();
+            return 0;
+        }
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status)) {
+            printf("%%Error: test %d failed, status %d\n", test, status);
+            return 1;
+        }
+    }
+
+    // The parent continues from where it forked
+    cycles(top.get(), tfp.get(), 40);
+    tfp->close();
+    top->final();
+    tfp.reset();
+    top.reset();
+    printf("*-* All Finished *-*\n");
+    return 0;
+}
@@ -0,0 +1,39 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_cat.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace --coverage-toggle --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# The parent trace is uninterrupted, and nothing a child dumped got into it
+file_grep("$Self->{obj_dir}/simx.vcd", qr/^#19$/m);
+file_grep("$Self->{obj_dir}/simx.vcd", qr/^#39$/m);
+file_grep_not("$Self->{obj_dir}/simx.vcd", qr/^#[4-9]\d$/m);
+# Each child continues from the boot state into its own trace
+foreach my $test (0 .. 2) {
+    my $end = 20 + 10 * ($test + 1) - 1;
+    file_grep("$Self->{obj_dir}/child${test}.vcd", qr/^#20$/m);
+    file_grep("$Self->{obj_dir}/child${test}.vcd", qr/^#${end}$/m);
+    file_grep_not("$Self->{obj_dir}/child${test}.vcd", qr/^#1?\d$/m);
+    file_grep("$Self->{obj_dir}/child${test}.dat", qr/cyc/);
+}
+
+ok(1);
+1;
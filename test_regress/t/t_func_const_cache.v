@@ -0,0 +1,41 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+package pkg;
+   function automatic integer log2up(input integer value);
+      integer result = 0;
+      for (integer v = value - 1; v > 0; v = v >> 1) result = result + 1;
+      return result;
+   endfunction
+endpackage
+
+module t(/*AUTOARG*/);
+
+   // Same arguments, so only the first call needs simulation
+   localparam integer A = pkg::log2up(1000);
+   localparam integer B = pkg::log2up(1000);
+   localparam integer C = pkg::log2up(1000);
+   // Different argument
+   localparam integer D = pkg::log2up(16);
+
+   sub #(.W(pkg::log2up(1000))) sub1 ();
+   sub #(.W(pkg::log2up(17))) sub2 ();
+
+   initial begin
+      if (A != 10) $stop;
+      if (B != 10) $stop;
+      if (C != 10) $stop;
+      if (D != 4) $stop;
+      if (sub1.X != 11) $stop;
+      if (sub2.X != 6) $stop;
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
+
+module sub #(parameter integer W = 0) ();
+   localparam integer X = W + pkg::log2up(2);
+endmodule
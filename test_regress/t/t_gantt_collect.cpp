@@ -0,0 +1,41 @@
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+//
+
+#include "verilated.h"
+
+#include "Vt_gantt_collect.h"
+
+#include <memory>
+
+int main(int argc, char** argv) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->threads(TEST_USE_THREADS);
+    contextp->debug(0);
+    contextp->commandArgs(argc, argv);
+
+    const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get(), "top"}};
+
+    topp->clk = false;
+    topp->eval();
+
+    contextp->timeInc(10);
+    int evals = 0;
+    while ((contextp->time() < 1100) && !contextp->gotFinish()) {
+        // Collect the profile of 20 evals, of which every second is recorded
+        if (evals == 10) contextp->profExecCollect(true);
+        if (evals == 30) contextp->profExecCollect(false);
+        topp->clk = !topp->clk;
+        topp->eval();
+        ++evals;
+        contextp->timeInc(5);
+    }
+    if (!contextp->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+# Test for VerilatedContext::profExecCollect and +verilator+prof+exec+sample
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_gen_alw.v");
+
+my $threads_num = $Self->{vltmt} ? 2 : 1;
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--prof-exec --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    threads => $threads_num,
+    make_flags => "CPPFLAGS_ADD=\"-DVL_NO_LEGACY -DTEST_USE_THREADS=$threads_num\"",
+    );
+
+execute(
+    # The +verilator+prof+exec+start window is never reached
+    all_run_flags => ["+verilator+prof+exec+start+1000000",
+                      " +verilator+prof+exec+sample+2",
+                      " +verilator+prof+exec+file+$Self->{obj_dir}/profile_exec.dat",
+                      ],
+    check_finished => 1,
+    );
+
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_gantt",
+            "$Self->{obj_dir}/profile_exec.dat",
+            "| tee $Self->{obj_dir}/gantt.log"],
+    );
+
+file_grep("$Self->{obj_dir}/gantt.log", qr/Total threads += $threads_num/i);
+file_grep("$Self->{obj_dir}/gantt.log", qr/Total evals += 10/i);
+
+ok(1);
+1;
@@ -0,0 +1,25 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(dist => 1);
+
+# Uses the profile from t_gantt_io, with a hand-written cost model
+run(cmd => ["cd $Self->{obj_dir} && $ENV{VERILATOR_ROOT}/bin/verilator_gantt --no-vcd"
+            . " --cost-model $Self->{t_dir}/$Self->{name}__cost_model.dat"
+            . " --write-cost-scales cost_scales.txt"
+            . " $Self->{t_dir}/t_gantt_io.dat > gantt.log"],
+    check_finished => 0);
+
+files_identical("$Self->{obj_dir}/gantt.log", $Self->{golden_filename});
+
+files_identical("$Self->{obj_dir}/cost_scales.txt", "$Self->{t_dir}/$Self->{name}.scales.out");
+
+ok(1);
+1;
@@ -0,0 +1,58 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+# Test streaming of --prof-exec records through many small trace buffers
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_gen_alw.v");
+
+my $threads_num = $Self->{vltmt} ? 2 : 1;
+
+compile(
+    v_flags2 => ["--prof-exec"],
+    threads => $threads_num,
+    # Tiny buffers, so the window is written through many buffer handoffs,
+    # and recording threads have to wait for the writer thread
+    make_flags => "CPPFLAGS_ADD=\"-DVL_PROF_EXEC_BUFFER_RECORDS=16"
+                  . " -DVL_PROF_EXEC_MAX_PENDING=2\"",
+    );
+
+execute(
+    all_run_flags => ["+verilator+prof+exec+start+2",
+                      " +verilator+prof+exec+window+60",
+                      " +verilator+prof+exec+file+$Self->{obj_dir}/profile_exec.dat",
+                      ],
+    check_finished => 1,
+    );
+
+# Each buffer written starts with the id of the thread that recorded it
+my $buffers = 0;
+my $fh = IO::File->new("<$Self->{obj_dir}/profile_exec.dat")
+    or error("$! $Self->{obj_dir}/profile_exec.dat");
+while (defined(my $line = $fh->getline)) {
+    ++$buffers if $line =~ /^VLPROFTHREAD /;
+}
+$fh->close;
+($buffers > 10) or error("Expected many trace buffers, got $buffers");
+
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_gantt",
+            "$Self->{obj_dir}/profile_exec.dat",
+            "| tee $Self->{obj_dir}/gantt.log"],
+    );
+
+file_grep("$Self->{obj_dir}/gantt.log", qr/Total threads += $threads_num/i);
+file_grep("$Self->{obj_dir}/gantt.log", qr/Total evals += 60/i);
+if ($Self->{vltmt}) {
+    file_grep("$Self->{obj_dir}/gantt.log", qr/Total mtasks += 7/i);
+}
+
+ok(1);
+1;
@@ -0,0 +1,30 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+# stats will be deleted but generation will be skipped if libs of hierarchical blocks exist.
+clean_objs();
+
+scenarios(vlt => 1);
+
+compile(
+    verilator_flags2 => ['--stats', '--hierarchical-auto', '--build-jobs 2'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Only 'sub' is large enough, the top module is never a block
+file_grep($Self->{stats}, qr/HierBlock,\s+Automatic hierarchical blocks\s+(\d+)/i, 1);
+file_grep($Self->{stats}, qr/HierBlock,\s+Hierarchical blocks\s+(\d+)/i, 1);
+file_grep($Self->{obj_dir} . "/Vsub/sub.sv", /^module\s+(\S+)\s+/, "sub");
+
+ok(1);
+1;
@@ -0,0 +1,57 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+function automatic [255:0] hash(input [31:0] in);
+   for (int i = 0; i < 256; ++i) hash[i] = ^(in & (32'h9e3779b9 * (i + 1)));
+endfunction
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [31:0] crc = 32'h5aef0c8d;
+   reg [255:0] expected[4];
+   wire [255:0] out[4];
+
+   // Large enough, and instantiated often enough, to become a hierarchical block
+   for (genvar i = 0; i < 4; ++i) begin : g
+      sub u_sub(.clk, .in(crc ^ i), .out(out[i]));
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[30:0], crc[31] ^ crc[2] ^ crc[0]};
+      for (int i = 0; i < 4; ++i) begin
+         expected[i] <= hash(crc ^ i);
+         if (cyc > 1 && out[i] !== expected[i]) $stop;
+      end
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub (/*AUTOARG*/
+   // Outputs
+   out,
+   // Inputs
+   clk, in
+   );
+   input clk;
+   input [31:0] in;
+   output reg [255:0] out;
+
+   wire [255:0] next;
+   for (genvar i = 0; i < 256; ++i) begin : g
+      assign next[i] = ^(in & (32'h9e3779b9 * (i + 1)));
+   end
+
+   always @(posedge clk) out <= next;
+endmodule
@@ -0,0 +1,29 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+# It doesn't really matter what test
+top_filename("t/t_gen_alw.v");
+
+compile(
+    v_flags2 => ["--hot-sections --hugepage-text --stats"],
+    );
+
+file_grep($Self->{stats}, qr/Optimizations, Hot sections assigned\s+([1-9]\d*)/i);
+file_grep_any([glob_all("$Self->{obj_dir}/$Self->{vm_prefix}*.cpp")],
+              qr/VL_ATTR_SECTION\("\.text\.hot\.vl_nba"\)/);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,28 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_sys_file_basic.v");
+
+unlink("$Self->{obj_dir}/t_sys_file_basic_test.log");
+
+compile(
+    );
+
+execute(
+    all_run_flags => ["+verilator+io+thread+1"],
+    check_finished => 1,
+    );
+
+files_identical("$Self->{obj_dir}/t_sys_file_basic_test.log", "t/t_sys_file_basic.out");
+
+ok(1);
+1;
@@ -0,0 +1,52 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   reg [15:0] tmp;
+   reg [15:0] result;
+   reg [15:0] other;
+
+   always @(posedge clk) begin
+      // Dead, as overwritten below on all paths before being read
+      if (crc[0]) begin
+         tmp = crc[15:0];
+         if (crc[1]) tmp = ~crc[15:0];
+      end
+      tmp = crc[31:16];
+      result <= tmp;
+      // Not dead, read before overwritten
+      if (crc[2]) tmp = crc[47:32];
+      other <= tmp;
+      tmp = crc[63:48];
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (cyc > 1) begin
+         if (result !== crc[32:17]) begin
+            $write("%%Error: cyc=%0d result=%x exp=%x\n", cyc, result, crc[32:17]);
+            $stop;
+         end
+         if (other !== (crc[3] ? crc[48:33] : crc[32:17])) begin
+            $write("%%Error: cyc=%0d other=%x\n", cyc, other);
+            $stop;
+         end
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,65 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   // Temporary assigned at the top of the block, and read in deeply nested
+   // blocks split into separate functions by --comp-limit-blocks
+   reg [31:0] tmp;
+   reg [31:0] result;
+
+   always @(posedge clk) begin
+      tmp = crc[31:0] ^ 32'h1234_5678;
+      if (crc[0]) begin
+         if (crc[1]) begin
+            if (crc[2]) begin
+               if (crc[3]) result <= tmp + 32'd1;
+               else result <= tmp - 32'd2;
+            end
+            else begin
+               if (crc[4]) result <= tmp ^ crc[63:32];
+               else result <= ~tmp;
+            end
+         end
+         else result <= tmp;
+      end
+      else result <= crc[63:32];
+   end
+
+   function automatic [31:0] expected(input [63:0] c);
+      reg [31:0] t;
+      t = c[31:0] ^ 32'h1234_5678;
+      return !c[0] ? c[63:32]
+           : !c[1] ? t
+           : !c[2] ? (c[4] ? t ^ c[63:32] : ~t)
+           : c[3] ? t + 32'd1 : t - 32'd2;
+   endfunction
+
+   reg [31:0] exp_result;
+
+   always @(posedge clk) begin
+      exp_result <= expected(crc);
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (cyc > 1) begin
+         if (result !== exp_result) begin
+            $write("%%Error: cyc=%0d result=%x exp=%x\n", cyc, result, exp_result);
+            $stop;
+         end
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,67 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   sub #(.W(1024)) u_1024 (.*);
+   sub #(.W(2049)) u_2049 (.*);
+   sub #(.W(4096)) u_4096 (.*);
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (cyc == 500) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub
+  #(parameter W = 1)
+   (input clk,
+    input integer cyc,
+    input [63:0] crc);
+
+   logic [W-1:0] a;
+   logic [W-1:0] b;
+   logic [W-1:0] prod;
+   logic [W-1:0] quot;
+   logic [W-1:0] rem;
+   logic [W-1:0] back;
+   always_comb begin
+      a = W'({(W / 64 + 1){crc}});
+      // Divisor of varying width, including a single word
+      b = (cyc % 5 == 0) ? W'(crc[31:0] | 1) : a >> (crc[7:0] + 1);
+      if (b == '0) b = W'(1);
+      prod = a * b;
+      quot = a / b;
+      rem = a % b;
+      back = quot * b + rem;
+   end
+
+   always @ (posedge clk) begin
+`ifdef TEST_VERBOSE
+      $write("[%0t] W=%0d cyc=%0d prod[63:0]=%x rem[63:0]=%x\n", $time, W, cyc, prod[63:0],
+             rem[63:0]);
+`endif
+      if (back !== a) $stop;
+      if (rem >= b) $stop;
+      // Low word of product depends only on low words of operands
+      if (prod[63:0] !== a[63:0] * b[63:0]) $stop;
+      // Multiply distributes over addition
+      if ((a * (b + W'(1))) !== (prod + a)) $stop;
+   end
+endmodule
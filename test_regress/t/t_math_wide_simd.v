@@ -0,0 +1,87 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Copyright 2023 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   // Wider than --expand-limit, and not a multiple of any vector width
+   localparam W = 4133;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   logic [W-1:0] a;
+   logic [W-1:0] b;
+   int           s;
+   always_comb begin
+      a = W'({65{crc}});
+      // Equal every fourth cycle, else differ in one word
+      b = a ^ ((cyc % 4 == 0) ? '0 : {{(W-64){1'b0}}, crc} << (cyc * 67 % W));
+      s = (cyc % 8 == 1) ? 32 * (cyc % 100) : cyc % W;
+   end
+
+   // Bit at a time references
+   function automatic int ref_countones(logic [W-1:0] v);
+      ref_countones = 0;
+      for (int i = 0; i < W; ++i) ref_countones += int'(v[i]);
+   endfunction
+   function automatic logic ref_redxor(logic [W-1:0] v);
+      ref_redxor = 1'b0;
+      for (int i = 0; i < W; ++i) ref_redxor ^= v[i];
+   endfunction
+   function automatic logic ref_eq(logic [W-1:0] l, logic [W-1:0] r);
+      ref_eq = 1'b1;
+      for (int i = 0; i < W; ++i) if (l[i] != r[i]) ref_eq = 1'b0;
+   endfunction
+   function automatic logic [W-1:0] ref_shiftl(logic [W-1:0] v, int sh);
+      for (int i = 0; i < W; ++i) ref_shiftl[i] = (i >= sh) ? v[i - sh] : 1'b0;
+   endfunction
+   function automatic logic [W-1:0] ref_shiftr(logic [W-1:0] v, int sh);
+      for (int i = 0; i < W; ++i) ref_shiftr[i] = (i + sh < W) ? v[i + sh] : 1'b0;
+   endfunction
+
+   logic [W-1:0] anded;
+   logic [W-1:0] ored;
+   logic [W-1:0] xored;
+   logic [W-1:0] shl;
+   logic [W-1:0] shr;
+   always_comb begin
+      anded = a & b;
+      ored = a | b;
+      xored = a ^ b;
+      shl = a << s;
+      shr = a >> s;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+`ifdef TEST_VERBOSE
+      $write("[%0t] cyc=%0d s=%0d eq=%0d ones=%0d\n", $time, cyc, s, a == b, $countones(a));
+`endif
+      if ((a == b) !== ref_eq(a, b)) $stop;
+      if ((a != b) !== !ref_eq(a, b)) $stop;
+      if ((a == b) !== (cyc % 4 == 0)) $stop;
+      if (^a !== ref_redxor(a)) $stop;
+      if (^xored !== (ref_redxor(a) ^ ref_redxor(b))) $stop;
+      if ($countones(a) !== ref_countones(a)) $stop;
+      if ($countones(ored) !== $countones(anded) + $countones(xored)) $stop;
+      if ((anded | xored) !== ored) $stop;
+      if ((anded ^ xored) !== ored) $stop;
+      if ((xored ^ b) !== a) $stop;
+      if (!ref_eq(shl, ref_shiftl(a, s))) $stop;
+      if (!ref_eq(shr, ref_shiftr(a, s))) $stop;
+      if (cyc == 1000) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -11,7 +11,7 @@ if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); di
 scenarios(vlt_all => 1);
 
 compile(
-    verilator_flags2 => ["-unroll-count 64", "--stats"],
+    verilator_flags2 => ["-unroll-count 64", "--stats", "-fno-merge-cond-branchless"],
     );
 
 execute(
@@ -13,7 +13,8 @@ scenarios(vlt => 1);
 # TODO: This takes excessively long on vltmt, this should be fixed
 
 compile(
-    verilator_flags2 => ["--unroll-count 1000000000", "--output-split 0", "--stats"],
+    verilator_flags2 => ["--unroll-count 1000000000", "--output-split 0", "--stats",
+                         "-fno-merge-cond-branchless"],
     );
 
 execute(
@@ -0,0 +1,50 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   reg       sel;
+   reg [7:0] a, b, c, d;
+   reg [7:0] x, y;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      sel <= crc[0];
+      {a, b, c, d} <= crc[39:8];
+   end
+
+   // Data dependent mux, better as conditional moves than as a branch
+   always @ (posedge clk) begin
+      x <= sel ? a : b;
+      y <= sel ? c : d;
+   end
+
+   reg       sel_q;
+   reg [7:0] a_q, b_q, c_q, d_q;
+   always @ (posedge clk) begin
+      sel_q <= sel;
+      {a_q, b_q, c_q, d_q} <= {a, b, c, d};
+   end
+
+   always @ (posedge clk) begin
+      if (cyc > 2) begin
+         if (x != (sel_q ? a_q : b_q)) $stop;
+         if (y != (sel_q ? c_q : d_q)) $stop;
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -13,7 +13,8 @@ scenarios(vlt_all => 1);
 top_filename("t/t_merge_cond.v");
 
 compile(
-    verilator_flags2 => ["-unroll-count 64", "--stats", "-fno-merge-cond-motion"],
+    verilator_flags2 => ["-unroll-count 64", "--stats", "-fno-merge-cond-motion",
+                         "-fno-merge-cond-branchless"],
     );
 
 execute(
@@ -0,0 +1,57 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   wire [31:0] sum1, sum2;
+
+   mid m1 (.clk, .cyc, .sum(sum1));
+   mid m2 (.clk, .cyc(cyc + 1), .sum(sum2));
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc > 3) begin
+         if (sum1 != (cyc - 2) * 3) $stop;
+         if (sum2 != (cyc - 1) * 3) $stop;
+      end
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module mid (
+   input clk,
+   input integer cyc,
+   output logic [31:0] sum
+   );
+   /*verilator no_inline_module*/
+
+   leaf l (.clk, .cyc);
+
+   // Several reads through the same sub-instance
+   always @(posedge clk) sum <= l.a + l.b + l.c;
+endmodule
+
+module leaf (
+   input clk,
+   input integer cyc
+   );
+   /*verilator no_inline_module*/
+
+   integer a, b, c;
+   always @(posedge clk) begin
+      a <= cyc;
+      b <= cyc;
+      c <= cyc;
+   end
+endmodule
@@ -0,0 +1,63 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [31:0] instr = 32'h0;
+   reg [31:0] acc_a = 32'h0;
+   reg [31:0] acc_b = 32'h0;
+   reg [31:0] acc_c = 32'h0;
+
+   // Reference model, decoding the same fields in one place
+   function automatic [95:0] model(input integer n);
+      reg [31:0] i;
+      reg [31:0] a;
+      reg [31:0] b;
+      reg [31:0] c;
+      i = 32'h0;
+      a = 32'h0;
+      b = 32'h0;
+      c = 32'h0;
+      for (integer k = 0; k < n; k = k + 1) begin
+         if (i[6:0] == 7'h33) begin
+            if (i[14:12] == 3'd0) a = a + i;
+            if (i[14:12] == 3'd1) b = b ^ i;
+         end
+         if (i[6:0] == 7'h13) c = c + {20'd0, i[31:20]};
+         i = i * 32'd1103515245 + 32'd12345;
+      end
+      model = {a, b, c};
+   endfunction
+
+   // Independent blocks repeating the same decode
+   always @(posedge clk) begin
+      if (instr[6:0] == 7'h33 && instr[14:12] == 3'd0) acc_a <= acc_a + instr;
+   end
+   always @(posedge clk) begin
+      if (instr[6:0] == 7'h33 && instr[14:12] == 3'd1) acc_b <= acc_b ^ instr;
+   end
+   always @(posedge clk) begin
+      if (instr[6:0] == 7'h13) acc_c <= acc_c + {20'd0, instr[31:20]};
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      instr <= instr * 32'd1103515245 + 32'd12345;
+      if (cyc == 300) begin
+`ifdef TEST_VERBOSE
+         $write("acc %x %x %x\n", acc_a, acc_b, acc_c);
+`endif
+         if ({acc_a, acc_b, acc_c} !== model(300)) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,50 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [31:0] arr [0:7];
+   reg [15:0] idx = 16'h0;
+   reg [31:0] a = 32'h0;
+   reg [31:0] b = 32'h0;
+
+   initial begin
+      for (integer i = 0; i < 8; i = i + 1) arr[i] = 32'h100 + i;
+   end
+
+   // Each read is guarded by its own bounds check, which with --x-assign
+   // unique uses a different random value when out of range, so only the
+   // unguarded array reads are identical. Those must not be hoisted out of
+   // the bounds checks, as most indices are far out of range.
+   always @(posedge clk) begin
+      a <= arr[idx[15:0] * 16'd4099];
+   end
+   always @(posedge clk) begin
+      b <= arr[idx[15:0] * 16'd4099];
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      idx <= idx + 16'd1;
+      if (cyc > 0) begin
+         // Value read for the previous index
+         if ((idx - 16'd1) * 16'd4099 < 16'd8) begin
+            if (a != 32'h100 + {16'h0, (idx - 16'd1) * 16'd4099}) $stop;
+            if (b != a) $stop;
+         end
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
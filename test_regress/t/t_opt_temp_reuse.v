@@ -0,0 +1,42 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   logic [95:0] a, b, c;
+   logic [95:0] x1, x2, x3, x4;
+
+   always_comb begin
+      a = {3{cyc}};
+      b = {cyc + 32'd1, cyc + 32'd2, cyc + 32'd3};
+      c = {cyc ^ 32'h5a5a, 64'h0};
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      // Each product is held in a wide temporary; one can be shared
+      x1 = (a * b) ^ c;
+      x2 = (b * c) ^ a;
+      x3 = (c * a) ^ b;
+      x4 = (a * a) ^ b;
+      if (cyc > 2) begin
+         if (x1 != ((a * b) ^ c)) $stop;
+         if (x2 != ((b * c) ^ a)) $stop;
+         if (x3 != ((c * a) ^ b)) $stop;
+         if (x4 != ((a * a) ^ b)) $stop;
+      end
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
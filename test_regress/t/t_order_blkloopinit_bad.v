@@ -18,7 +18,7 @@ module t (/*AUTOARG*/
 
    always @ (posedge clk) begin
       for (int i=0; i<SIZE; i++) begin
-         array[i] <= 0;  // BLKLOOPINIT
+         array[i][0] <= 0;  // BLKLOOPINIT
       end
       o <= array[1];
    end
@@ -0,0 +1,39 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   int cyc = 0;
+   wire [7:0] out1;
+   wire [7:0] out2;
+
+   // Different parameters, so different modules, but with the same ROM
+   sub #(.ADD(1)) sub1 (.idx(cyc[2:0]), .out(out1));
+   sub #(.ADD(2)) sub2 (.idx(cyc[2:0]), .out(out2));
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      if (out1 !== 8'(((cyc[2:0] * 8'h13) ^ 8'h5a) + 1)) $stop;
+      if (out2 !== 8'(((cyc[2:0] * 8'h13) ^ 8'h5a) + 2)) $stop;
+      if (cyc == 9) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub #(parameter ADD = 0) (
+   input [2:0] idx,
+   output [7:0] out
+   );
+   localparam logic [7:0] ROM [8] = '{8'h5a, 8'h49, 8'h7c, 8'h63,
+                                      8'h16, 8'h05, 8'h28, 8'hdf};
+   assign out = ROM[idx] + ADD;
+endmodule
@@ -0,0 +1,27 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+compile(
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Overrides of the unreferenced parameter must not create more flavors
+my @headers = glob("$Self->{obj_dir}/$Self->{VM_PREFIX}_sub*.h");
+if (scalar(@headers) != 2) {
+    error("Expected 2 flavors of 'sub', got: @headers");
+}
+
+ok(1);
+1;
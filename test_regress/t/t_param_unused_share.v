@@ -0,0 +1,39 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t(/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   wire [7:0] o1, o2, o3;
+
+   // UNUSED only differs, so these share one module
+   sub #(.USED(1), .UNUSED(1)) s1 (.o(o1));
+   sub #(.USED(1), .UNUSED(2)) s2 (.o(o2));
+   // USED differs, so a second module
+   sub #(.USED(2), .UNUSED(3)) s3 (.o(o3));
+
+   always @(posedge clk) begin
+      if (o1 != 8'd1) $stop;
+      if (o2 != 8'd1) $stop;
+      if (o3 != 8'd2) $stop;
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
+
+module sub #(
+   parameter USED = 0,
+   parameter UNUSED = 0
+   ) (
+   output [7:0] o
+   );
+   /*verilator no_inline_module*/
+   assign o = USED;
+endmodule
@@ -0,0 +1,47 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+   integer cyc = 0;
+
+   reg        a = 0;
+   reg [7:0]  b = 0;
+   // Reference history
+   reg        a1 = 0;
+   reg        a2 = 0;
+   reg [7:0]  b1 = 0;
+   reg [7:0]  b2 = 0;
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      a <= cyc[1];
+      b <= b + {7'b0, cyc[0]};
+      a1 <= a;
+      a2 <= a1;
+      b1 <= b;
+      b2 <= b1;
+      if (cyc > 3) begin
+         // All of these share the history registers of 'a' and 'b'
+         if ($past(a) != a1) $stop;
+         if ($past(a, 2) != a2) $stop;
+         if ($rose(a) != (a && !a1)) $stop;
+         if ($fell(a) != (!a && a1)) $stop;
+         if ($stable(b) != (b == b1)) $stop;
+         if ($past(b) != b1) $stop;
+         if ($past(b, 2) != b2) $stop;
+      end
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,40 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+# It doesn't really matter what test
+top_filename("t/t_gen_alw.v");
+
+compile(
+    v_flags2 => ["--prof-pgo --stats"],
+    );
+
+file_grep($Self->{stats}, qr/PGO, CFuncs profiled\s+([1-9]\d*)/i);
+
+execute(
+    all_run_flags => [" +verilator+prof+vlt+file+$Self->{obj_dir}/profile.vlt"],
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/profile.vlt", qr/profile_data -model "\w+" -cfunc "[^"]+" -cost \S+ -calls/i);
+
+compile(
+    v_flags2 => ["--prof-pgo --stats $Self->{obj_dir}/profile.vlt"],
+    );
+
+file_grep($Self->{stats}, qr/PGO, CFuncs made hot\s+([1-9]\d*)/i);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
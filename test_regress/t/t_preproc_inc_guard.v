@@ -0,0 +1,27 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+// Guarded header included repeatedly is skipped once its guard is defined
+`include "t_preproc_inc_guard.vh"
+`include "t_preproc_inc_guard.vh"
+`undef T_PREPROC_INC_GUARD_VH
+`undef T_PREPROC_INC_GUARD_SECOND
+// Guard no longer defined, so must be read again
+`include "t_preproc_inc_guard.vh"
+`include "t_preproc_inc_guard.vh"
+
+module t (/*AUTOARG*/);
+   initial begin
+`ifndef T_PREPROC_INC_GUARD_VH
+      $stop;
+`endif
+`ifdef T_PREPROC_INC_GUARD_BAD
+      $stop;
+`endif
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
@@ -0,0 +1,13 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+`ifndef T_PREPROC_INC_GUARD_VH
+`define T_PREPROC_INC_GUARD_VH
+`ifdef T_PREPROC_INC_GUARD_SECOND
+  `define T_PREPROC_INC_GUARD_BAD
+`endif
+`define T_PREPROC_INC_GUARD_SECOND
+`endif  // T_PREPROC_INC_GUARD_VH
@@ -0,0 +1,29 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_prof.v");
+
+compile(
+    verilator_flags2 => ["--prof-sample"],
+    );
+
+execute(
+    all_run_flags => ["+verilator+prof+sample+file+$Self->{obj_dir}/profile_sample.txt"],
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/profile_sample.txt", qr/Verilated model sampling profile/);
+file_grep("$Self->{obj_dir}/profile_sample.txt", qr/By Verilog module/);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}__Syms.cpp", qr/_vm_sampleProfiler.addFunc\(/);
+
+ok(1);
+1;
@@ -38,6 +38,12 @@ typedef struct packed {
    longint     z;
 } StructOuter;
 
+typedef struct packed {
+   bit [39:0]   p;
+   logic [47:0] q;
+   bit [7:0]    r;
+} StructPlain;
+
 class BaseCls;
 endclass
 
@@ -80,6 +86,7 @@ class OtherCls;
    rand logic[31:0] y;
    rand logic[23:0] z;
    rand StructOuter str;
+   rand StructPlain pln;
 
    function new;
       v = 0;
@@ -88,6 +95,7 @@ class OtherCls;
       y = 0;
       z = 0;
       str = '{x: 1'b0, y: ONE, z: 64'd0, s: '{a: 32'd0, b: 1'b0, c: ONE}};
+      pln = '0;
    endfunction
 
 endclass
@@ -163,6 +171,9 @@ module t (/*AUTOARG*/);
       `check_rand(other, other.str.s.a);
       `check_rand(other, other.str.s.b);
       `check_rand(other, other.str.s.c);
+      `check_rand(other, other.pln.p);
+      `check_rand(other, other.pln.q);
+      `check_rand(other, other.pln.r);
       `check_rand(der_int, der_int.a);
       `check_rand(der_contain, der_contain.cls1.a);
       `check_rand(der_contain, der_contain.a);
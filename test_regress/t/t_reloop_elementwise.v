@@ -0,0 +1,45 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   logic [15:0] a [64];
+   logic [15:0] b [64];
+   logic [15:0] sum [64];
+   logic [15:0] mac [63];
+
+   always_comb begin
+      for (int i = 0; i < 64; ++i) sum[i] = a[i] + b[i];
+   end
+
+   always_comb begin
+      for (int i = 0; i < 63; ++i) mac[i] = (a[i + 1] ^ b[i]) + 16'h11;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      a[cyc % 64] <= crc[15:0];
+      b[cyc % 64] <= crc[31:16];
+      if (cyc > 64) begin
+         for (int i = 0; i < 64; ++i) begin
+            if (sum[i] != a[i] + b[i]) $stop;
+            if (i < 63 && mac[i] != (a[i + 1] ^ b[i]) + 16'h11) $stop;
+         end
+      end
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,32 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_prof.v");
+
+compile(
+    verilator_flags2 => ["--runtime-stats"],
+    );
+
+my $stats = "$Self->{obj_dir}/runtime_stats.jsonl";
+unlink($stats);
+
+execute(
+    all_run_flags => ["+verilator+stats+file+$stats"],
+    check_finished => 1,
+    );
+
+file_grep($stats, qr/^\{"time": \d+, "wall_ns": \d+, "evals": [1-9]\d*, /);
+file_grep($stats, qr/"iterations_act": [1-9]\d*, "iterations_nba": [1-9]\d*/);
+file_grep($stats, qr/"thread_wait_ns": \d+\}$/m);
+
+ok(1);
+1;
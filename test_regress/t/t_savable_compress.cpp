@@ -0,0 +1,84 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include VM_PREFIX_INCLUDE
+
+// These require the above. Comment prevents clang-format moving them
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+static std::string filename(const char* kind) {
+    return std::string{VL_STRINGIFY(TEST_OBJ_DIR) "/"} + kind + ".vltsv";
+}
+
+static std::string contents(const std::string& fn) {
+    std::ifstream ifs{fn, std::ios::binary};
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+int main(int argc, char* argv[]) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+
+    {
+        const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get()}};
+        topp->clk = 0;
+        for (int i = 0; i < 20; ++i) {
+            topp->clk = !topp->clk;
+            topp->eval();
+            contextp->timeInc(1);
+        }
+        VerilatedSave comp;
+        comp.compress(true);
+        comp.open(filename("comp"));
+        comp << *topp;
+        comp.close();
+        VerilatedSave full;
+        full.open(filename("full"));
+        full << *topp;
+        full.close();
+        VerilatedSave async;
+        async.async(true);
+        async.open(filename("async"));
+        async << *topp;
+        async.close();
+    }
+    TEST_CHECK_EQ(contents(filename("comp")).substr(0, 16), std::string{"verilatorsavelz4"});
+    // Background writing must not change the file
+    TEST_CHECK_EQ(contents(filename("async")) == contents(filename("full")), true);
+
+    // Restoring the compressed save must give the uncompressed save's state
+    {
+        const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get()}};
+        {
+            VerilatedRestore os;
+            os.open(filename("comp"));
+            os >> *topp;
+        }
+        {
+            VerilatedSave os;
+            os.open(filename("check"));
+            os << *topp;
+        }
+        TEST_CHECK_EQ(contents(filename("check")) == contents(filename("full")), true);
+    }
+
+    return errors ? 10 : 0;
+}
@@ -0,0 +1,80 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include VM_PREFIX_INCLUDE
+
+// These require the above. Comment prevents clang-format moving them
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+static std::string filename(const char* kind, int n) {
+    return std::string{VL_STRINGIFY(TEST_OBJ_DIR) "/"} + kind + "_" + std::to_string(n)
+           + ".vltsv";
+}
+
+static std::string contents(const std::string& fn) {
+    std::ifstream ifs{fn, std::ios::binary};
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+int main(int argc, char* argv[]) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+
+    constexpr int SAVES = 8;
+    {
+        const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get()}};
+        VerilatedSave incr;
+        incr.incremental(3);  // So both full and delta saves are made
+        topp->clk = 0;
+        for (int n = 0; n < SAVES; ++n) {
+            for (int i = 0; i < 10; ++i) {
+                topp->clk = !topp->clk;
+                topp->eval();
+                contextp->timeInc(1);
+            }
+            incr.open(filename("incr", n));
+            incr << *topp;
+            incr.close();
+            VerilatedSave full;
+            full.open(filename("full", n));
+            full << *topp;
+            full.close();
+        }
+    }
+
+    // Restoring each save, including deltas, must give the full save's state
+    for (int n = 0; n < SAVES; ++n) {
+        const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get()}};
+        {
+            VerilatedRestore os;
+            os.open(filename("incr", n));
+            os >> *topp;
+        }
+        {
+            VerilatedSave os;
+            os.open(filename("check", n));
+            os << *topp;
+        }
+        TEST_CHECK_EQ(contents(filename("check", n)) == contents(filename("full", n)), true);
+    }
+
+    return errors ? 10 : 0;
+}
@@ -0,0 +1,81 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include VM_PREFIX_INCLUDE
+
+// These require the above. Comment prevents clang-format moving them
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+static std::string filename(const char* kind) {
+    return std::string{VL_STRINGIFY(TEST_OBJ_DIR) "/"} + kind + ".vltsv";
+}
+
+static std::string contents(const std::string& fn) {
+    std::ifstream ifs{fn, std::ios::binary};
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+static void run(VM_PREFIX* topp, VerilatedContext* contextp, int cycles) {
+    for (int i = 0; i < cycles * 2; ++i) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        contextp->timeInc(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+
+    {
+        const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get()}};
+        topp->clk = 0;
+        run(topp.get(), contextp.get(), 100);
+        VerilatedSave os;
+        os.open(filename("saved"));
+        os << *topp;
+        os.close();
+        // Reference for the state after running further
+        run(topp.get(), contextp.get(), 100);
+        os.open(filename("ref"));
+        os << *topp;
+    }
+
+    for (int mmap = 0; mmap < 2; ++mmap) {
+        const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get()}};
+        {
+            VerilatedRestore os;
+            os.mmapArrays(mmap);
+            os.open(filename("saved"));
+            os >> *topp;
+        }
+        // Writes to mapped memory must not change the save file
+        run(topp.get(), contextp.get(), 100);
+        {
+            VerilatedSave os;
+            os.open(filename("check"));
+            os << *topp;
+        }
+        TEST_CHECK_EQ(contents(filename("check")) == contents(filename("ref")), true);
+    }
+
+    return errors ? 10 : 0;
+}
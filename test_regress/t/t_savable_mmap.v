@@ -0,0 +1,26 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   // Large enough to be page aligned in the save file
+   reg [31:0] mem[0:65535];
+   reg [95:0] wmem[0:32767];
+   reg [7:0]  small[0:15];
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      mem[cyc[15:0] * 7] <= cyc;
+      wmem[cyc[14:0] * 3] <= {3{cyc}};
+      small[cyc[3:0]] <= cyc[7:0];
+   end
+endmodule
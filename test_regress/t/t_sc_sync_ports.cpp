@@ -0,0 +1,60 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include VM_PREFIX_INCLUDE
+
+#ifdef SYSTEMC_VERSION
+int sc_main(int, char**) {
+    Verilated::debug(0);
+    VM_PREFIX* const tb = new VM_PREFIX{"tb"};
+
+    sc_clock clk{"clk", 10, SC_NS};
+    sc_signal<uint32_t> in8{"in8"};
+    sc_signal<uint32_t> out8{"out8"};
+    sc_signal<uint32_t> count{"count"};
+    sc_signal<sc_bv<100>> in100{"in100"};
+    sc_signal<sc_bv<100>> out100{"out100"};
+    tb->clk(clk);
+    tb->in8(in8);
+    tb->out8(out8);
+    tb->count(count);
+    tb->in100(in100);
+    tb->out100(out100);
+
+    bool pass = true;
+    for (uint32_t i = 0; i < 10; ++i) {
+        sc_bv<100> value;
+        value = i * 0x01010101U;
+        value.range(99, 96) = i;
+        in8 = i;
+        in100 = value;
+        sc_start(10, SC_NS);
+        if (out8.read() != ((i + 1) & 0xff)) {
+            VL_PRINTF("%%Error: out8 = %u, expected %u\n", out8.read(), (i + 1) & 0xff);
+            pass = false;
+        }
+        const sc_bv<100> expected = ~value;
+        if (out100.read() != expected) {
+            VL_PRINTF("%%Error: out100 mismatch at %u\n", i);
+            pass = false;
+        }
+    }
+    if (count.read() < 10) {
+        VL_PRINTF("%%Error: count = %u, expected at least 10\n", count.read());
+        pass = false;
+    }
+
+    if (pass) VL_PRINTF("*-* All Finished *-*\n");
+    tb->final();
+    VL_DO_DANGLING(delete tb, tb);
+    return 0;
+}
+#else
+int main() {
+    VL_PRINTF("*-* All Finished *-*\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,31 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --sc --sc-sync-ports"],
+    );
+
+# Ports are owned by the model, not references to the root's variables
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.h", qr/sc_in<bool> \s+ clk;/x);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.h", qr/sc_in<uint32_t> \s+ in8;/x);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.h", qr/sc_out<sc_bv<100>\s> \s+ out100;/x);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.cpp", qr/VL_SC_BV_READ\(100, /);
+file_grep("$Self->{obj_dir}/$Self->{vm_prefix}.cpp", qr/VL_SC_BV_WRITE\(100, /);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
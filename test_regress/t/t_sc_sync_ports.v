@@ -0,0 +1,27 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   out8, out100, count,
+   // Inputs
+   clk, in8, in100
+   );
+
+   input clk;
+   input [7:0] in8;
+   input [99:0] in100;
+   output logic [7:0] out8;
+   output logic [99:0] out100;
+   output logic [31:0] count = 0;
+
+   always @ (posedge clk) begin
+      out8 <= in8 + 8'd1;
+      out100 <= ~in100;
+      count <= count + 1;
+   end
+
+endmodule
@@ -0,0 +1,50 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include VM_PREFIX_INCLUDE
+
+double sc_time_stamp() { return 0; }
+
+int main(int argc, char* argv[]) {
+    Verilated::debug(0);
+    Verilated::commandArgs(argc, argv);
+
+    VM_PREFIX* const topp = new VM_PREFIX;
+    topp->clk = 0;
+    topp->eval();
+
+    uint32_t derivedEdgeIters = 0;  // Iterations on rising edge of 'clk_div'
+    uint32_t plainEdgeIters = 0;  // Iterations on other rising edges of 'clk'
+    while (!Verilated::gotFinish()) {
+        topp->clk = 1;
+        const bool derivedEdge = !topp->clk_div;
+        topp->eval();
+        if (derivedEdge) {
+            derivedEdgeIters = topp->evalIterations();
+        } else {
+            plainEdgeIters = topp->evalIterations();
+        }
+        topp->clk = 0;
+        topp->eval();
+    }
+
+    if (!plainEdgeIters || derivedEdgeIters <= plainEdgeIters) {
+        fprintf(stderr, "%%Error: unexpected evalIterations() %u vs %u\n", derivedEdgeIters,
+                plainEdgeIters);
+        exit(1);
+    }
+
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
@@ -0,0 +1,28 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   clk_div,
+   // Inputs
+   clk
+   );
+   input clk;
+   output reg clk_div = 1'b0;
+
+   integer cyc = 0;
+
+   // Derived clock, takes an extra NBA iteration on its rising edge
+   always @(posedge clk) clk_div <= ~clk_div;
+
+   always @(posedge clk_div) begin
+      cyc <= cyc + 1;
+      if (cyc == 10) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,31 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   logic   en = 0;
+   integer gcount = 0;
+
+   // Gated clock, computed in 'act', but reading a flop updated in 'nba'
+   wire    gclk = clk & en;
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      en <= cyc[0];
+      if (cyc == 20) begin
+         if (gcount == 0) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+   always @(posedge gclk) gcount <= gcount + 1;
+endmodule
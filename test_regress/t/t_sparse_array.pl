@@ -0,0 +1,29 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(simulator => 1);
+
+compile(
+    verilator_flags2 => ["--sparse-arrays 1024"],
+    );
+
+if ($Self->{vlt_all}) {
+    my $root_h = "$Self->{obj_dir}/$Self->{vm_prefix}___024root.h";
+    file_grep_not($root_h, qr/VlUnpacked<QData[^,]*, 268435456>/);
+    file_grep($root_h, qr/VlSparseArray<QData[^,]*, 268435456>/);
+    file_grep($root_h, qr/VlUnpacked<QData[^,]*, 16>/);
+}
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,59 @@
+// DESCRIPTION: Verilator: Sparse storage of large unpacked arrays
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+`define stop $stop
+`define checkh(gotv,expv) do if ((gotv) !== (expv)) begin $write("%%Error: %s:%0d:  got='h%x exp='h%x\n", `__FILE__,`__LINE__, (gotv), (expv)); `stop; end while(0);
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   // Dense these would need 2GB and 16MB
+   logic [63:0] mem [0:(1<<28)-1];
+   logic [127:0] wide [0:(1<<20)-1];
+   logic [63:0] small [0:15];
+
+   integer cyc = 0;
+   logic [27:0] addr;
+   logic [63:0] rd;
+
+   assign addr = 28'(cyc) * 28'h123457;
+   assign rd = mem[addr];
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc < 10) begin
+         mem[addr] <= {32'(cyc), 32'hcafe_0000};
+         wide[addr[19:0]] <= {4{32'(cyc)}};
+      end
+      else if (cyc == 10) begin
+         `checkh(mem[28'h123457 * 3], {32'd3, 32'hcafe_0000});
+         `checkh(mem[28'h123457 * 9], {32'd9, 32'hcafe_0000});
+         `checkh(mem[28'h0fffffff], 64'h0);
+         `checkh(wide[20'(28'h123457 * 5)], {4{32'd5}});
+         `checkh(wide[20'h1], 128'h0);
+         $readmemh("t/t_sparse_array.mem", mem, 28'h0fffff00);
+         `checkh(mem[28'h0fffff00], 64'h1234_5678_9abc_def0);
+         `checkh(mem[28'h0fffff01], 64'h1);
+         `checkh(mem[28'h0fffff02], 64'h0);
+         $writememh({`STRINGIFY(`TEST_OBJ_DIR),"/sparse.mem"}, mem, 28'h0fffff00, 28'h0fffff0f);
+         $readmemh({`STRINGIFY(`TEST_OBJ_DIR),"/sparse.mem"}, small);
+         `checkh(small[0], 64'h1234_5678_9abc_def0);
+         `checkh(small[1], 64'h1);
+         `checkh(small[15], 64'h0);
+      end
+      else if (cyc == 11) begin
+         // Combinational read of the array
+         `checkh(rd, 64'h0);
+      end
+      else if (cyc == 12) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,47 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   typedef struct packed {
+      logic [3:0] hi;
+      logic [3:0] lo;
+   } pair_t;
+
+   integer cyc = 0;
+
+   // Without splitting, each of these is UNOPTFLAT, as later bits
+   // combinationally depend on earlier bits of the same variable
+   logic [3:0] x;
+   always_comb begin
+      x[0] = cyc[0];
+      x[1] = ~x[0];
+   end
+   assign x[3:2] = x[1:0];
+
+   pair_t p;
+   assign p.lo = cyc[3:0];
+   assign p.hi = p.lo + 4'd1;
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+`ifdef TEST_VERBOSE
+      $write("cyc=%0d x=%b p=%x\n", cyc, x, p);
+`endif
+      if (x !== {~cyc[0], cyc[0], ~cyc[0], cyc[0]}) $stop;
+      if (p.hi !== cyc[3:0] + 4'd1) $stop;
+      if (cyc == 9) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
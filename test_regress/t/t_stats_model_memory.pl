@@ -0,0 +1,26 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+compile(
+    verilator_flags2 => ['--stats --trace --coverage-line'],
+    );
+
+file_grep($Self->{stats}, qr/Model memory, TOTAL, bytes +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Model memory, memories, bytes +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Model memory, signals, bytes +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Model memory, trace, bytes +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Model memory, coverage, bytes +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Model memory, module sub, x2, bytes +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Model memory, largest 01 sub\.mem, bytes +8192/);
+
+ok(1);
+1;
@@ -0,0 +1,38 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   out0, out1,
+   // Inputs
+   clk
+   );
+   input clk;
+   output [31:0] out0;
+   output [31:0] out1;
+
+   sub sub0 (.clk(clk), .out(out0));
+   sub sub1 (.clk(clk), .out(out1));
+endmodule
+
+module sub (/*AUTOARG*/
+   // Outputs
+   out,
+   // Inputs
+   clk
+   );
+   input clk;
+   output reg [31:0] out;
+
+   reg [31:0] mem [0:1023] /*verilator public*/;
+   reg [9:0] addr;
+
+   always @(posedge clk) begin
+      addr <= addr + 1;
+      mem[addr] <= mem[addr] + 1;
+      out <= mem[addr];
+   end
+endmodule
@@ -0,0 +1,23 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+top_filename("t/t_optm_if_cond.v");
+
+compile(
+    verilator_flags2 => ['--stats'],
+    );
+
+file_grep($Self->{stats}, qr/Node memory, bytes, IF +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Node memory, bytes, TOTAL +[1-9]\d*/);
+file_grep($Self->{stats}, qr/Node memory, bytes per node +[1-9]\d*/);
+
+ok(1);
+1;
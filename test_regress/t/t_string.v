@@ -125,6 +125,20 @@ module t (/*AUTOARG*/
          s2[3] = "3";
          `checks(s2, "0st3ing");
       end
+      else if (cyc==12) begin
+         // Append in place
+         s2 = "ab";
+         s2 = {s2, "cd"};
+         `checks(s2, "abcd");
+         s2 = {s2, s3, "e"};
+         `checks(s2, "abcdbe");
+         s2 = {s2, s2};
+         `checks(s2, "abcdbeabcdbe");
+         s2 = {s2, "-", s2};
+         `checks(s2, "abcdbeabcdbe-abcdbeabcdbe");
+         `checkh(s2 == "abcdbeabcdbe-abcdbeabcdbe", 1'b1);
+         `checkh("ab" != s2, 1'b1);
+      end
       //
       else if (cyc==99) begin
          $write("*-* All Finished *-*\n");
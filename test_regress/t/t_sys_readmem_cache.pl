@@ -0,0 +1,56 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+my $narrow = "$Self->{obj_dir}/narrow.mem";
+my $wide = "$Self->{obj_dir}/wide.mem";
+
+sub write_mems {
+    my $gen = shift;
+    if ($gen == 1) {
+        write_wholefile($narrow, "01 02 03 04\n");
+        write_wholefile($wide, "1_23456789_abcdef01 2_0000_0000_0000_0002\n");
+    } else {
+        write_wholefile($narrow, "0a 0b 0c 0d\n");
+        write_wholefile($wide, "f_edcba987_6543210f 3_0000_0000_0000_0003\n");
+    }
+}
+
+sub run_gen {
+    my $gen = shift;
+    execute(
+        all_run_flags => ["+verilator+readmem+cache+1", "+gen=${gen}"],
+        check_finished => 1,
+        );
+}
+
+compile(
+    );
+
+unlink(glob("$Self->{obj_dir}/*.vlcache"));
+write_mems(1);
+utime(1000000000, 1000000000, $narrow, $wide);
+run_gen(1);
+file_grep("$narrow.vlcache", qr/^vlrdmem1/);
+file_grep("$wide.vlcache", qr/^vlrdmem1/);
+
+# Same size and time, so values come from the cache, not the file
+write_mems(2);
+utime(1000000000, 1000000000, $narrow, $wide);
+run_gen(1);
+
+# Newer file, so the file is read again
+utime(1000000010, 1000000010, $narrow, $wide);
+run_gen(2);
+run_gen(2);
+
+ok(1);
+1;
@@ -0,0 +1,34 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+`define STRINGIFY(x) `"x`"
+`define checkh(gotv,expv) do if ((gotv) !== (expv)) begin $write("%%Error: %s:%0d:  got='h%x exp='h%x\n", `__FILE__,`__LINE__, (gotv), (expv)); $stop; end while(0);
+
+module t;
+   reg [7:0] narrow [0:3];
+   reg [71:0] wide [0:1];
+   integer gen;
+
+   initial begin
+      if (!$value$plusargs("gen=%d", gen)) $stop;
+      $readmemh({`STRINGIFY(`TEST_OBJ_DIR),"/narrow.mem"}, narrow);
+      $readmemh({`STRINGIFY(`TEST_OBJ_DIR),"/wide.mem"}, wide);
+      if (gen == 1) begin
+         `checkh(narrow[0], 8'h01);
+         `checkh(narrow[3], 8'h04);
+         `checkh(wide[0], 72'h1_23456789_abcdef01);
+         `checkh(wide[1], 72'h2_0000_0000_0000_0002);
+      end
+      else begin
+         `checkh(narrow[0], 8'h0a);
+         `checkh(narrow[3], 8'h0d);
+         `checkh(wide[0], 72'hf_edcba987_6543210f);
+         `checkh(wide[1], 72'h3_0000_0000_0000_0003);
+      end
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
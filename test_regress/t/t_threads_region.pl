@@ -0,0 +1,33 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vltmt => 1);
+
+compile(
+    verilator_flags2 => ['--cc', '--threads-region-cost 1'],
+    threads => 2
+    );
+
+# The 'act' region must have been partitioned into mtasks
+my $got = 0;
+foreach my $file (glob("$Self->{obj_dir}/*.cpp")) {
+    my $fh = IO::File->new("<$file");
+    local $/; undef $/;
+    my $wholefile = <$fh>;
+    ++$got if $wholefile =~ /__Vm_even_cycle__act = !/;
+}
+$got or error("No multi-threaded 'act' region found");
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
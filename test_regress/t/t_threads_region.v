@@ -0,0 +1,55 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   reg [31:0] a = 32'd1;
+
+   function automatic [31:0] mix(input [31:0] x, input [31:0] k);
+      integer i;
+      mix = x;
+      for (i = 0; i < 8; i = i + 1) mix = (mix ^ (mix << 5)) + (mix >> 3) + k;
+   endfunction
+
+   // Independent combinational logic computing derived clocks, evaluated in the 'act' region
+   wire [31:0] h0 = mix(a, 32'h9e3779b9);
+   wire [31:0] h1 = mix(a, 32'h7f4a7c15);
+   wire [31:0] h2 = mix(a, 32'h85ebca6b);
+   wire [31:0] h3 = mix(a, 32'hc2b2ae35);
+
+   integer cnt0 = 0;
+   integer cnt1 = 0;
+   integer cnt2 = 0;
+   integer cnt3 = 0;
+
+   always @(posedge h0[7]) if (cyc >= 2) cnt0 <= cnt0 + 1;
+   always @(posedge h1[7]) if (cyc >= 2) cnt1 <= cnt1 + 1;
+   always @(posedge h2[7]) if (cyc >= 2) cnt2 <= cnt2 + 1;
+   always @(posedge h3[7]) if (cyc >= 2) cnt3 <= cnt3 + 1;
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      a <= a * 32'd1103515245 + 32'd12345;
+      if (cyc == 40) begin
+`ifdef TEST_VERBOSE
+         $write("[%0t] cnt %0d %0d %0d %0d\n", $time, cnt0, cnt1, cnt2, cnt3);
+`endif
+         if (cnt0 !== 10) $stop;
+         if (cnt1 !== 8) $stop;
+         if (cnt2 !== 8) $stop;
+         if (cnt3 !== 9) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
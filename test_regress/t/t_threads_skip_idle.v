@@ -0,0 +1,60 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   wire [63:0] acc0;
+   wire [63:0] acc1;
+   wire [63:0] acc2;
+   wire [63:0] acc3;
+   wire [63:0] result = acc0 ^ acc1 ^ acc2 ^ acc3;
+
+   // Each block is idle most of the time
+   sub sub0 (.clk, .en(cyc[4:0] == 5'd0), .in(crc), .acc(acc0));
+   sub sub1 (.clk, .en(cyc[4:0] == 5'd3), .in(crc), .acc(acc1));
+   sub sub2 (.clk, .en(cyc[4:0] == 5'd6), .in(crc), .acc(acc2));
+   sub sub3 (.clk, .en(cyc[4:0] == 5'd9), .in(crc), .acc(acc3));
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (cyc == 99) begin
+         $write("[%0t] result=%x\n", $time, result);
+         if (acc0 !== 64'h2ca8cc6c_d365ad3b) $stop;
+         if (acc1 !== 64'h4af6f949_a0b92a3f) $stop;
+         if (acc2 !== 64'h57b7ca57_05c951ec) $stop;
+         if (acc3 !== 64'hbdbe52ad_2e4a8f05) $stop;
+         if (result !== 64'h8c57addf_585f59ed) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub (/*AUTOARG*/
+   // Outputs
+   acc,
+   // Inputs
+   clk, en, in
+   );
+
+   input clk;
+   input en;
+   input [63:0] in;
+   output reg [63:0] acc = 0;
+
+   always @ (posedge clk) begin
+      if (en) acc <= acc ^ (in + {acc[31:0], acc[63:32]});
+   end
+endmodule
@@ -0,0 +1,56 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module pulsegen(output logic pulse);
+   // Two delays, lowered with a state index
+   always begin
+      pulse = 1;
+      #3;
+      pulse = 0;
+      #7;
+   end
+endmodule
+
+module t(/*AUTOARG*/);
+   logic clk = 0;
+   logic pulse_a, pulse_b;
+   int   cyc;
+   int   highs;
+
+   // Single constant delay, resumed periodically by the delay scheduler
+   always #5 clk = ~clk;
+
+   pulsegen a(.pulse(pulse_a));
+   pulsegen b(.pulse(pulse_b));
+
+   // Not simple, stays a coroutine
+   always begin
+      @(posedge clk);
+      if (pulse_a) highs = highs + 1;
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+`ifdef TEST_VERBOSE
+      $display("[%0t] cyc=%0d pulse=%b%b", $time, cyc, pulse_a, pulse_b);
+`endif
+      if ($time != 10 * cyc + 5) $stop;
+      // Rising clock edges at 5, 15, ... see the pulse low, it is high from 0 to 3
+      if (pulse_a !== 0 || pulse_b !== 0) $stop;
+      if (cyc == 9) begin
+         if (highs != 0) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+   always @(posedge pulse_a) begin
+      if ($time % 10 != 0) $stop;
+   end
+   always @(negedge pulse_b) begin
+      if ($time % 10 != 3) $stop;
+   end
+endmodule
@@ -0,0 +1,50 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_vcd_c.h>
+
+#include <memory>
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv) {
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+    Verilated::commandArgs(argc, argv);
+
+    std::unique_ptr<VM_PREFIX> top{new VM_PREFIX{"top"}};
+
+    // Same as t_trace_rollover, but written from a background thread
+    std::unique_ptr<VerilatedVcdAsyncFile> filep{new VerilatedVcdAsyncFile};
+    std::unique_ptr<VerilatedVcdC> tfp{new VerilatedVcdC{filep.get()}};
+    top->trace(tfp.get(), 99);
+
+    tfp->rolloverSize(1000);  // But will be increased to 8kb chunk size
+    tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simasync.vcd");
+
+    top->clk = 0;
+
+    while (main_time < 1900) {  // Creates 2 files
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        if (main_time == 500) tfp->flush();
+        ++main_time;
+    }
+    tfp->close();
+    top->final();
+    tfp.reset();
+    filep.reset();
+    top.reset();
+    printf("*-* All Finished *-*\n");
+    return 0;
+}
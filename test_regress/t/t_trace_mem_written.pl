@@ -0,0 +1,74 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    verilator_flags2 => ['--cc --trace --trace-max-array 1024 --stats'],
+    );
+
+if ($Self->{vlt_all}) {
+    file_grep($Self->{stats}, qr/Tracing, Memories tracking written elements\s+(\d+)/i, 2);
+}
+
+execute(
+    check_finished => 1,
+    );
+
+my $trace = glob_one("$Self->{obj_dir}/$Self->{vm_prefix}__Trace__0.cpp");
+file_grep($trace, qr/__Vm_traceWritten__mem\[/);
+
+# Memory contents after the given number of clock cycles
+sub expected {
+    my $cycles = shift;
+    my @mem = (0 .. 1023);
+    my @shadow = (0) x 1024;
+    for my $k (0 .. $cycles - 1) {
+        @shadow = @mem if $k == 5;
+        $mem[($k * 37) % 1024] = $k + 0x1000;
+        $mem[$k % 1024] = ($mem[$k % 1024] & 0xfff) | 0x8000;
+    }
+    return (\@mem, \@shadow);
+}
+
+# Replay the VCD, checking the memories at every time step
+my %names;  # Trace code -> names
+my %values;  # Name -> current value
+my @scope;
+my $checks = 0;
+sub check {
+    return if !defined $values{"t.cyc"};
+    my ($memr, $shadowr) = expected($values{"t.cyc"});
+    for my $i (0 .. 1023) {
+        error("t.mem[$i] = $values{\"t.mem[$i]\"} at cyc $values{'t.cyc'}")
+            if $values{"t.mem[$i]"} != $memr->[$i];
+        error("t.shadow[$i] = $values{\"t.shadow[$i]\"} at cyc $values{'t.cyc'}")
+            if $values{"t.shadow[$i]"} != $shadowr->[$i];
+    }
+    ++$checks;
+}
+foreach my $line (split(/\n/, file_contents("$Self->{obj_dir}/simx.vcd"))) {
+    if ($line =~ /^\s*\$scope \S+ (\S+) \$end/) {
+        push @scope, $1;
+    } elsif ($line =~ /^\s*\$upscope/) {
+        pop @scope;
+    } elsif ($line =~ /^\s*\$var \S+ \d+ (\S+) (\S+)/) {
+        push @{$names{$1}}, join(".", @scope[1 .. $#scope], $2);
+    } elsif ($line =~ /^#/) {
+        check();
+    } elsif ($line =~ /^b([01]+) (\S+)/) {
+        $values{$_} = oct("0b$1") foreach @{$names{$2}};
+    }
+}
+check();
+error("Too few time steps checked") if $checks < 20;
+
+ok(1);
+1;
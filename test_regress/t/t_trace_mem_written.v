@@ -0,0 +1,38 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+   int   cyc;
+
+   logic [15:0] mem [0:1023];
+   logic [15:0] shadow [0:1023];
+
+   initial begin
+      for (int i = 0; i < 1024; ++i) begin
+         mem[i] = 16'(i);
+         shadow[i] = 16'd0;
+      end
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      // Element writes
+      mem[(cyc * 37) % 1024] <= 16'(cyc + 'h1000);
+      mem[cyc % 1024][15:12] <= 4'h8;
+      // Whole memory write
+      if (cyc == 5) shadow <= mem;
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,33 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_cat.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Only the dumps held when triggered at time 100 are written
+file_grep("$Self->{obj_dir}/simx.vcd", qr/enddefinitions/);
+file_grep("$Self->{obj_dir}/simx.vcd", qr/^#100$/m);
+file_grep("$Self->{obj_dir}/simx.vcd", qr/^#90$/m);
+file_grep_not("$Self->{obj_dir}/simx.vcd", qr/^#(\d|[1-7]\d)$/m);
+file_grep_not("$Self->{obj_dir}/simx.vcd", qr/^#1[1-9]\d$/m);
+
+ok(1);
+1;
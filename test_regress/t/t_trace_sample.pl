@@ -0,0 +1,49 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_main => 0,
+    verilator_flags2 => ["--trace --exe $Self->{t_dir}/t_trace_sample.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+my $vcd = file_contents("$Self->{obj_dir}/simx.vcd");
+my ($cyc) = ($vcd =~ / (\S+) cyc /) or error("No cyc in VCD");
+my ($param) = ($vcd =~ / (\S+) PARAM /) or error("No PARAM in VCD");
+my (undef, @parts) = split(/^#(\d+)\n/m, $vcd);
+my %dumped = @parts;
+my @times = sort { $a <=> $b } keys %dumped;
+
+# Every 4th dump before time 30, then windows of 3 every 10 starting at 30
+my @expected = (0, 4, 8, 12, 16, 20, 24, 28, 30, 31, 32, 40, 41, 42, 50, 51, 52, 60);
+error("Dumped at times '@times', expected '@expected'") if "@times" ne "@expected";
+
+# Skipped dumps are merged into the next one, so values are exact at every sample
+my $value = -1;
+foreach my $time (@times) {
+    $value = oct("0b$1") if $dumped{$time} =~ /^b([01]+) \Q$cyc\E$/m;
+    error("cyc = $value at time $time") if $value != int(($time + 1) / 2);
+}
+
+# Each window starts with a full dump, including the constant parameter
+foreach my $time (0, 30, 40, 50, 60) {
+    error("No full dump at time $time") if $dumped{$time} !~ /^b\d+ \Q$param\E$/m;
+}
+foreach my $time (4, 31, 41) {
+    error("Full dump at time $time") if $dumped{$time} =~ /^b\d+ \Q$param\E$/m;
+}
+
+ok(1);
+1;
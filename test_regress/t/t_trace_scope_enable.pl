@@ -0,0 +1,47 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t_trace_dumpvars_dyn.v");
+
+compile(
+    make_main => 0,
+    verilator_flags2 => ["--trace --exe $Self->{t_dir}/t_trace_scope_enable.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+my $vcd = file_contents("$Self->{obj_dir}/simx.vcd");
+my ($sub1b) = ($vcd =~ /module sub1b \$end.*? (\S+) value /s)
+    or error("No sub1b.value in VCD");
+my ($sub2a) = ($vcd =~ /module sub1a \$end.*?module sub2a \$end.*? (\S+) value /s)
+    or error("No sub1a.sub2a.value in VCD");
+my ($cyc) = ($vcd =~ / (\S+) cyc /s) or error("No cyc in VCD");
+my ($early, $mid, $late) = split(/^#6\n|^#10\n/m, $vcd);
+my %dumped = ('early' => $early, 'mid' => $mid, 'late' => $late);
+sub dumped {
+    my $when = shift;
+    my $code = shift;
+    return $dumped{$when} =~ /^b\d+ \Q$code\E$/m;
+}
+# sub1b is disabled from the start, sub1a.sub2a from time 6, all enabled at 10
+error("sub1b.value dumped while disabled") if dumped('early', $sub1b);
+error("sub1a.sub2a.value dumped while disabled") if dumped('mid', $sub2a);
+error("sub1a.sub2a.value not dumped before disabled") if !dumped('early', $sub2a);
+error("sub1b.value not dumped after enabled") if !dumped('late', $sub1b);
+error("sub1a.sub2a.value not dumped after enabled") if !dumped('late', $sub2a);
+# cyc is aliased into sub1b, but still dumped for the enabled scopes
+error("cyc not dumped") if !dumped('mid', $cyc);
+
+ok(1);
+1;
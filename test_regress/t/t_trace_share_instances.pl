@@ -0,0 +1,74 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    verilator_flags2 => ['--cc --trace --trace-structs --trace-share-instances'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# One change dump function, shared by all instances of core
+my $trace = glob_one("$Self->{obj_dir}/$Self->{vm_prefix}_core__Trace__0.cpp");
+file_grep($trace, qr/__trace_chg_inst_0\(/);
+file_grep_not($trace, qr/__trace_chg_inst_1\(/);
+
+# Replay the VCD, checking the values of each instance are consistent at every time step
+my %names;  # Trace code -> hierarchical names
+my %values;  # Hierarchical name -> current value
+my %changes;  # Hierarchical name -> number of value changes
+my @scope;
+sub check {
+    return if !defined $values{"t.cyc"};
+    for my $i (0 .. 3) {
+        my $in = $values{"t.c$i.in"};
+        error("t.c$i.in = $in at cyc $values{'t.cyc'}")
+            if $in != (($values{"t.cyc"} + $i) & 0xff);
+        error("t.c$i.sum = $values{\"t.c$i.sum\"} with in = $in")
+            if $values{"t.c$i.sum"} != $in + 300;
+        error("t.c$i.pair.hi = $values{\"t.c$i.pair.hi\"} with in = $in")
+            if $values{"t.c$i.pair.hi"} != ($in >> 4);
+        error("t.c$i.pair.lo = $values{\"t.c$i.pair.lo\"} with in = $in")
+            if $values{"t.c$i.pair.lo"} != ($in & 0xf);
+    }
+}
+sub set {
+    my $code = shift;
+    my $value = shift;
+    foreach my $name (@{$names{$code}}) {
+        ++$changes{$name} if defined $values{$name};
+        $values{$name} = $value;
+    }
+}
+foreach my $line (split(/\n/, file_contents("$Self->{obj_dir}/simx.vcd"))) {
+    if ($line =~ /^\s*\$scope \S+ (\S+) \$end/) {
+        push @scope, $1;
+    } elsif ($line =~ /^\s*\$upscope/) {
+        pop @scope;
+    } elsif ($line =~ /^\s*\$var \S+ \d+ (\S+) (\S+)/) {
+        push @{$names{$1}}, join(".", @scope[1 .. $#scope], $2);
+    } elsif ($line =~ /^#/) {
+        check();
+    } elsif ($line =~ /^b([01]+) (\S+)/) {
+        set($2, oct("0b$1"));
+    } elsif ($line =~ /^([01])(\S+)$/) {
+        set($2, $1);
+    }
+}
+check();
+for my $i (0 .. 3) {
+    error("t.c$i.in not dumped on every change") if ($changes{"t.c$i.in"} || 0) < 10;
+}
+
+ok(1);
+1;
@@ -0,0 +1,44 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+   int   cyc;
+
+   core c0 (.in(cyc[7:0]));
+   core c1 (.in(cyc[7:0] + 8'd1));
+   core c2 (.in(cyc[7:0] + 8'd2));
+   core c3 (.in(cyc[7:0] + 8'd3));
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 10) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
+
+module core
+  (input logic [7:0] in);
+   /*verilator no_inline_module*/
+
+   typedef struct packed {
+      logic [3:0] hi;
+      logic [3:0] lo;
+   } pair_t;
+
+   pair_t pair;
+   logic [15:0] sum;
+
+   assign pair = in;
+   assign sum = {8'd0, in} + 16'd300;
+endmodule
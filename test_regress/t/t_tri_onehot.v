@@ -0,0 +1,59 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   int cyc = 0;
+   wire [1:0] sel = cyc[1:0];
+   wire [7:0] a = 8'h11 + cyc[7:0];
+   wire [7:0] b = 8'h22 ^ cyc[7:0];
+   wire [7:0] c = 8'h33;
+   wire [7:0] d = ~cyc[7:0];
+
+   // Drivers enabled by distinct values of the same select
+   tri [7:0] bus;
+   assign bus = (sel == 2'd0) ? a : 8'bz;
+   assign bus = (sel == 2'd1) ? b : 8'bz;
+   assign bus = (sel == 2'd2) ? c : 8'bz;
+   assign bus = (sel == 2'd3) ? d : 8'bz;
+
+   // Same through a port
+   tri [7:0] pbus;
+   sub sub (.sel, .a, .b, .pbus);
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      case (sel)
+        2'd0: if (bus !== a) $stop;
+        2'd1: if (bus !== b) $stop;
+        2'd2: if (bus !== c) $stop;
+        2'd3: if (bus !== d) $stop;
+      endcase
+      case (sel)
+        2'd1: if (pbus !== a) $stop;
+        2'd2: if (pbus !== b) $stop;
+        default: ;
+      endcase
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub (
+   input [1:0] sel,
+   input [7:0] a,
+   input [7:0] b,
+   inout [7:0] pbus
+   );
+   assign pbus = (sel == 2'd1) ? a : 8'bz;
+   assign pbus = (2'd2 == sel) ? b : 8'bz;
+endmodule
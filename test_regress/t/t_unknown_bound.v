@@ -0,0 +1,38 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   integer idx;
+
+   logic [7:0] mem [0:15];
+   logic [7:0] odd [0:9];
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      idx = cyc % 16;
+      if (cyc < 16) begin
+         // Writes with a wide index stay guarded
+         mem[idx] <= 8'(cyc) + 8'h10;
+         // Index range is proven from the shift
+         odd[cyc[3:0] >> 1] <= 8'(cyc);
+      end
+      else if (cyc < 32) begin
+         // Power of two sized, read index is masked
+         if (mem[idx] !== 8'(idx) + 8'h10) $stop;
+         if (odd[cyc[3:0] >> 1] !== 8'((cyc[3:0] >> 1) * 2 + 1)) $stop;
+      end
+      else begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,68 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2023 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+
+   logic [31:0] mem [0:199];
+   logic [31:0] sum200;
+   logic [31:0] sum130;
+   logic [31:0] sum131;
+   integer      first;
+
+   always @(posedge clk) begin
+      // 200 iterations, partially unrolled by 8
+      for (int i = 0; i < 200; i++) mem[i] <= i * cyc;
+   end
+
+   always_comb begin
+      sum200 = 0;
+      // 200 iterations, partially unrolled by 8
+      for (int i = 0; i < 200; i++) sum200 = sum200 + mem[i];
+      sum130 = 0;
+      // 130 iterations, partially unrolled by 5
+      for (int i = 0; i < 130; i += 1) begin
+         if (i[0]) sum130 = sum130 + mem[i];
+      end
+      sum131 = 0;
+      // 131 iterations, a prime so cannot be partially unrolled
+      for (int i = 0; i < 131; ++i) sum131 = sum131 ^ mem[i];
+      first = -1;
+      // 100 iterations with early exit, partially unrolled by 5
+      for (int i = 0; i < 100; i++) begin
+         if (mem[i] > 100) begin
+            first = i;
+            break;
+         end
+      end
+   end
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+`ifdef TEST_VERBOSE
+      $write("cyc=%0d sums %0d %0d %0d first %0d\n", cyc, sum200, sum130, sum131, first);
+`endif
+      if (cyc > 1) begin
+         // mem[i] == i * (cyc - 1)
+         if (sum200 !== 19900 * (cyc - 1)) $stop;
+         if (sum130 !== 4225 * (cyc - 1)) $stop;
+         if (cyc == 2 && first !== 101) $stop;
+         if (cyc == 3 && first !== 51) $stop;
+      end
+      if (cyc == 2 && sum131 !== 32'h83) $stop;
+      if (cyc == 9) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,60 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2023 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(dist => 1);
+
+my $src = "$Self->{obj_dir}/t_vlcov_annotate_cache.v";
+my $dat = "$Self->{obj_dir}/coverage.dat";
+my $out = "$Self->{obj_dir}/annotated/t_vlcov_annotate_cache.v";
+
+sub write_coverage {
+    my $count = shift;
+    write_wholefile($dat,
+                    "# SystemC::Coverage-3\n"
+                    . "C '\001f\002$src\001l\0023\001page\002v_line/t\001o\002block' $count\n");
+}
+
+sub annotate {
+    my $dir = shift;
+    run(cmd => ["../bin/verilator_coverage",
+                "--annotate-points",
+                ($dir eq "annotated" ? "--annotate-cache" : ()),
+                "--annotate", "$Self->{obj_dir}/$dir",
+                $dat],
+        verilator_run => 1,
+        );
+}
+
+write_wholefile($src, "module t;\n   initial begin\n      \$finish;\n   end\nendmodule\n");
+write_coverage(1);
+annotate("annotated");
+annotate("uncached");
+files_identical($out, "$Self->{obj_dir}/uncached/t_vlcov_annotate_cache.v");
+
+# Unchanged source and coverage, so the annotated file isn't rewritten
+write_wholefile($out, "marker\n");
+annotate("annotated");
+file_grep($out, qr/^marker$/);
+
+# Changed coverage rewrites
+write_coverage(2);
+annotate("annotated");
+annotate("uncached");
+files_identical($out, "$Self->{obj_dir}/uncached/t_vlcov_annotate_cache.v");
+
+# Changed source rewrites
+write_wholefile($out, "marker\n");
+write_wholefile($src, "module t;\n   initial begin\n      \$stop;\n   end\nendmodule\n");
+annotate("annotated");
+annotate("uncached");
+files_identical($out, "$Self->{obj_dir}/uncached/t_vlcov_annotate_cache.v");
+
+ok(1);
+1;
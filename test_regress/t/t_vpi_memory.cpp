@@ -213,9 +213,64 @@ void _mon_check_memory() {
     }
 }
 
+void _mon_check_value_array() {
+    // Expects mem0[i] == i, as set by _mon_check_memory
+    if (!TestSimulator::is_verilator()) return;
+    TestVpiHandle mem_h = vpi_handle_by_name((PLI_BYTE8*)TestSimulator::rooted("mem0"), NULL);
+    TEST_CHECK_NZ(mem_h);
+    s_vpi_error_info e;
+    s_vpi_arrayvalue arrayvalue;
+    PLI_INT32 index[1];
+    // Read wraps from last element to first
+    arrayvalue.format = vpiIntVal;
+    arrayvalue.flags = 0;
+    index[0] = 15;
+    vpi_get_value_array(mem_h, &arrayvalue, index, 3);
+    TEST_CHECK_Z(vpi_chk_error(&e));
+    TEST_CHECK_EQ(arrayvalue.value.integers[0], 15);
+    TEST_CHECK_EQ(arrayvalue.value.integers[1], 16);
+    TEST_CHECK_EQ(arrayvalue.value.integers[2], 1);
+    // Write into user allocated vectors, then read back raw
+    s_vpi_vecval vectors[16];
+    for (int i = 0; i < 16; ++i) {
+        vectors[i].aval = 0x01010100 * (i + 1);
+        vectors[i].bval = 0;
+    }
+    arrayvalue.format = vpiVectorVal;
+    arrayvalue.value.vectors = vectors;
+    index[0] = 1;
+    vpi_put_value_array(mem_h, &arrayvalue, index, 16);
+    TEST_CHECK_Z(vpi_chk_error(&e));
+    PLI_BYTE8 raw[16 * 4];
+    arrayvalue.format = vpiRawTwoStateVal;
+    arrayvalue.flags = vpiUserAllocFlag;
+    arrayvalue.value.rawvals = raw;
+    vpi_get_value_array(mem_h, &arrayvalue, index, 16);
+    TEST_CHECK_Z(vpi_chk_error(&e));
+    for (int i = 0; i < 16; ++i) {
+        TEST_CHECK_EQ(raw[i * 4], 0);
+        TEST_CHECK_EQ(raw[i * 4 + 3], i + 1);
+    }
+    // Restore mem0[i] == i, writing one value then a shortint per element
+    arrayvalue.format = vpiShortIntVal;
+    arrayvalue.flags = vpiOneValue;
+    PLI_INT16 shortints[16] = {0};
+    arrayvalue.value.shortints = shortints;
+    vpi_put_value_array(mem_h, &arrayvalue, index, 16);
+    TEST_CHECK_Z(vpi_chk_error(&e));
+    arrayvalue.flags = 0;
+    for (int i = 0; i < 16; ++i) shortints[i] = i + 1;
+    vpi_put_value_array(mem_h, &arrayvalue, index, 16);
+    TEST_CHECK_Z(vpi_chk_error(&e));
+    arrayvalue.format = vpiIntVal;
+    vpi_get_value_array(mem_h, &arrayvalue, index, 16);
+    for (int i = 0; i < 16; ++i) TEST_CHECK_EQ(arrayvalue.value.integers[i], i + 1);
+}
+
 extern "C" int mon_check() {
     // Callback from initial block in monitor
     _mon_check_memory();
+    _mon_check_value_array();
     return errors;
 }
 
@@ -22,6 +22,9 @@
 #ifdef T_VPI_VAR2
 #include "Vt_vpi_var2.h"
 #include "Vt_vpi_var2__Dpi.h"
+#elif defined(T_VPI_VAR_HOOKS)
+#include "Vt_vpi_var_hooks.h"
+#include "Vt_vpi_var_hooks__Dpi.h"
 #else
 #include "Vt_vpi_var.h"
 #include "Vt_vpi_var__Dpi.h"